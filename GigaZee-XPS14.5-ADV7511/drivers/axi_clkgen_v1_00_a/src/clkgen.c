@@ -0,0 +1,338 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file clkgen.c
+*
+* Pixel clock driver for the axi_clkgen core. See clkgen.h for the
+* description.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "clkgen.h"
+#include "xil_assert.h"
+
+/************************** Constant Definitions ****************************/
+
+#define CLKGEN_START_TIMEOUT	1000	/* Polls for the DRP sequence */
+#define CLKGEN_LOCK_TIMEOUT	1000000	/* Polls for the MMCM lock */
+
+/*
+ * Pixel clocks of the standard modes in Hz, indexed by CLKGEN_MODE_*
+ */
+static const u32 ModeRate[CLKGEN_NUM_MODES] = {
+	25175000,	/* 640x480p60 */
+	27000000,	/* 720x480p60 */
+	27000000,	/* 720x576p50 */
+	40000000,	/* 800x600p60 */
+	65000000,	/* 1024x768p60 */
+	74250000,	/* 1280x720p60 */
+	74175824,	/* 1280x720p59.94 */
+	74250000,	/* 1280x720p50 */
+	108000000,	/* 1280x1024p60 */
+	85500000,	/* 1360x768p60 */
+	106500000,	/* 1440x900p60 */
+	162000000,	/* 1600x1200p60 */
+	146250000,	/* 1680x1050p60 */
+	74250000,	/* 1920x1080p30 */
+	148500000,	/* 1920x1080p50 */
+	148500000,	/* 1920x1080p60 */
+	148351648,	/* 1920x1080p59.94 */
+	154000000,	/* 1920x1200p60 reduced blanking */
+};
+
+/************************** Function Prototypes *****************************/
+
+static int WaitLocked(u32 BaseAddress);
+
+/*****************************************************************************/
+/**
+*
+* Initialize a driver instance. The MMCM is not touched.
+*
+* @param	InstancePtr is the instance to initialize.
+* @param	BaseAddress is the register base of the core.
+* @param	RefHz is the frequency of ref_clk.
+*
+* @return
+*		- XST_SUCCESS if successful.
+*		- XST_INVALID_PARAM if RefHz is below the phase detector
+*		  minimum.
+*
+******************************************************************************/
+int Clkgen_CfgInitialize(Clkgen *InstancePtr, u32 BaseAddress, u32 RefHz)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+
+	if (RefHz < CLKGEN_MMCM_PFD_MIN) {
+		return XST_INVALID_PARAM;
+	}
+
+	memset(InstancePtr, 0, sizeof(Clkgen));
+	InstancePtr->BaseAddress = BaseAddress;
+	InstancePtr->RefHz = RefHz;
+	InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* Solve all standard modes up front, so that no later Clkgen_SetMode has to
+* run the solver.
+*
+* @param	InstancePtr is the instance.
+*
+* @return
+*		- XST_SUCCESS if all modes were solved.
+*		- XST_INVALID_PARAM if a mode cannot be made from RefHz.
+*
+******************************************************************************/
+int Clkgen_SolveModes(Clkgen *InstancePtr)
+{
+	u32 Mode;
+	int Status;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	for (Mode = 0; Mode < CLKGEN_NUM_MODES; Mode++) {
+		if ((InstancePtr->ModeValid & (1 << Mode)) != 0) {
+			continue;
+		}
+		Status = Clkgen_MmcmSolve(InstancePtr->RefHz, ModeRate[Mode],
+					  &InstancePtr->Mode[Mode]);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+		InstancePtr->ModeValid |= 1 << Mode;
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* Program the pixel clock of a standard mode.
+*
+* @param	InstancePtr is the instance.
+* @param	Mode is one of CLKGEN_MODE_*.
+*
+* @return
+*		- XST_SUCCESS if the MMCM locked to the new clock.
+*		- XST_INVALID_PARAM if the mode is unknown or cannot be made.
+*		- XST_FAILURE if the MMCM did not lock.
+*
+* @note		The first call for a mode runs the solver, later calls
+*		reuse the memoized setting.
+*
+******************************************************************************/
+int Clkgen_SetMode(Clkgen *InstancePtr, u32 Mode)
+{
+	int Status;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	if (Mode >= CLKGEN_NUM_MODES) {
+		return XST_INVALID_PARAM;
+	}
+
+	if ((InstancePtr->ModeValid & (1 << Mode)) == 0) {
+		Status = Clkgen_MmcmSolve(InstancePtr->RefHz, ModeRate[Mode],
+					  &InstancePtr->Mode[Mode]);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+		InstancePtr->ModeValid |= 1 << Mode;
+	}
+
+	return Clkgen_Program(InstancePtr, &InstancePtr->Mode[Mode]);
+}
+
+/*****************************************************************************/
+/**
+*
+* Program the closest clock to RateHz the MMCM can make.
+*
+* @param	InstancePtr is the instance.
+* @param	RateHz is the requested clock.
+*
+* @return
+*		- XST_SUCCESS if the MMCM locked to the new clock, see
+*		  Clkgen_GetRate for the exact value.
+*		- XST_INVALID_PARAM if the rate is out of range.
+*		- XST_FAILURE if the MMCM did not lock.
+*
+******************************************************************************/
+int Clkgen_SetRate(Clkgen *InstancePtr, u32 RateHz)
+{
+	Clkgen_Setting Setting;
+	u32 Mode;
+	int Status;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	for (Mode = 0; Mode < CLKGEN_NUM_MODES; Mode++) {
+		if (ModeRate[Mode] == RateHz) {
+			return Clkgen_SetMode(InstancePtr, Mode);
+		}
+	}
+
+	Status = Clkgen_MmcmSolve(InstancePtr->RefHz, RateHz, &Setting);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	return Clkgen_Program(InstancePtr, &Setting);
+}
+
+/*****************************************************************************/
+/**
+*
+* Write a setting to the core and let it reprogram the MMCM.
+*
+* @param	InstancePtr is the instance.
+* @param	SettingPtr is the setting, from Clkgen_MmcmSolve.
+*
+* @return
+*		- XST_SUCCESS if the MMCM locked to the new clock.
+*		- XST_FAILURE if the MMCM was not locked before, the core
+*		  ignores the start then, or did not lock afterwards.
+*
+* @note		The output clock stops while the MMCM is reprogrammed.
+*
+******************************************************************************/
+int Clkgen_Program(Clkgen *InstancePtr, const Clkgen_Setting *SettingPtr)
+{
+	u32 Base;
+	u32 Index;
+	u32 Timeout;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(SettingPtr != NULL);
+
+	Base = InstancePtr->BaseAddress;
+	InstancePtr->RateHz = 0;
+
+	if (WaitLocked(Base) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Clkgen_WriteReg(Base, CLKGEN_CTRL_OFFSET, 0);
+	for (Index = 0; Index < CLKGEN_NUM_DRP_REGS; Index++) {
+		Clkgen_WriteReg(Base, CLKGEN_CLK_OUT_1_OFFSET + 4 * Index,
+				SettingPtr->Reg[Index]);
+	}
+	Clkgen_WriteReg(Base, CLKGEN_CTRL_OFFSET, CLKGEN_CTRL_START_MASK);
+
+	/* The DRP sequence holds the MMCM in reset, wait for it to begin */
+	Timeout = CLKGEN_START_TIMEOUT;
+	while ((Clkgen_ReadReg(Base, CLKGEN_STATUS_OFFSET) &
+		CLKGEN_STATUS_RST_MASK) == 0) {
+		if (--Timeout == 0) {
+			break;
+		}
+	}
+
+	if (WaitLocked(Base) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	Clkgen_WriteReg(Base, CLKGEN_CTRL_OFFSET, 0);
+
+	InstancePtr->RateHz = SettingPtr->RateHz;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* Get the programmed clock.
+*
+* @param	InstancePtr is the instance.
+*
+* @return	The clock in Hz, rounded, 0 if not programmed by the driver.
+*
+******************************************************************************/
+u32 Clkgen_GetRate(Clkgen *InstancePtr)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+
+	return InstancePtr->RateHz;
+}
+
+/*****************************************************************************/
+/**
+*
+* Get the nominal pixel clock of a standard mode.
+*
+* @param	Mode is one of CLKGEN_MODE_*.
+*
+* @return	The clock in Hz, 0 for an unknown mode.
+*
+******************************************************************************/
+u32 Clkgen_ModeRate(u32 Mode)
+{
+	if (Mode >= CLKGEN_NUM_MODES) {
+		return 0;
+	}
+
+	return ModeRate[Mode];
+}
+
+/*****************************************************************************/
+/*
+* Wait until the MMCM is out of reset and locked.
+*
+******************************************************************************/
+static int WaitLocked(u32 BaseAddress)
+{
+	u32 Timeout = CLKGEN_LOCK_TIMEOUT;
+
+	while ((Clkgen_ReadReg(BaseAddress, CLKGEN_STATUS_OFFSET) &
+		(CLKGEN_STATUS_RST_MASK | CLKGEN_STATUS_LOCKED_MASK)) !=
+	       CLKGEN_STATUS_LOCKED_MASK) {
+		if (--Timeout == 0) {
+			return XST_FAILURE;
+		}
+	}
+
+	return XST_SUCCESS;
+}
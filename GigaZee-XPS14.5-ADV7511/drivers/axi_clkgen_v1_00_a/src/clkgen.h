@@ -0,0 +1,124 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file clkgen.h
+*
+* Pixel clock driver for the axi_clkgen core.
+*
+* Clkgen_SetRate programs any clock the MMCM can make, solving the MMCM
+* parameters with Clkgen_MmcmSolve on every call. Clkgen_SetMode programs
+* the pixel clock of one of the standard CEA-861 / VESA DMT modes below.
+* Their solutions are memoized in the instance on first use, or all at once
+* with Clkgen_SolveModes, so a mode switch is a table lookup plus the burst
+* of the ten DRP registers. Clkgen_SetRate takes the mode path for rates
+* found in the mode table.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef CLKGEN_H /* prevent circular inclusions */
+#define CLKGEN_H /* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xstatus.h"
+#include "clkgen_l.h"
+#include "clkgen_mmcm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************** Constant Definitions ****************************/
+
+/*
+ * Default configuration of the GigaZee-XPS14.5-ADV7511 design, ref_clk is
+ * FCLK_CLK2.
+ */
+#define CLKGEN_BASEADDR		0x66000000
+#define CLKGEN_REF_HZ		200000000
+
+/** @name Standard modes, see Clkgen_ModeRate
+ * @{
+ */
+#define CLKGEN_MODE_640X480P60		0	/**< 25.175 MHz */
+#define CLKGEN_MODE_720X480P60		1	/**< 27 MHz */
+#define CLKGEN_MODE_720X576P50		2	/**< 27 MHz */
+#define CLKGEN_MODE_800X600P60		3	/**< 40 MHz */
+#define CLKGEN_MODE_1024X768P60		4	/**< 65 MHz */
+#define CLKGEN_MODE_1280X720P60		5	/**< 74.25 MHz */
+#define CLKGEN_MODE_1280X720P59_94	6	/**< 74.25 / 1.001 MHz */
+#define CLKGEN_MODE_1280X720P50		7	/**< 74.25 MHz */
+#define CLKGEN_MODE_1280X1024P60	8	/**< 108 MHz */
+#define CLKGEN_MODE_1360X768P60		9	/**< 85.5 MHz */
+#define CLKGEN_MODE_1440X900P60		10	/**< 106.5 MHz */
+#define CLKGEN_MODE_1600X1200P60	11	/**< 162 MHz */
+#define CLKGEN_MODE_1680X1050P60	12	/**< 146.25 MHz */
+#define CLKGEN_MODE_1920X1080P30	13	/**< 74.25 MHz */
+#define CLKGEN_MODE_1920X1080P50	14	/**< 148.5 MHz */
+#define CLKGEN_MODE_1920X1080P60	15	/**< 148.5 MHz */
+#define CLKGEN_MODE_1920X1080P59_94	16	/**< 148.5 / 1.001 MHz */
+#define CLKGEN_MODE_1920X1200P60_RB	17	/**< 154 MHz */
+#define CLKGEN_NUM_MODES		18
+/* @} */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Driver instance
+ */
+typedef struct {
+	u32 BaseAddress;	/**< Register base */
+	u32 RefHz;		/**< ref_clk of the core */
+	u32 IsReady;
+	u32 RateHz;		/**< Programmed clock, 0 if unknown */
+	u32 ModeValid;		/**< Bit per solved entry of Mode */
+	Clkgen_Setting Mode[CLKGEN_NUM_MODES];	/**< Memoized modes */
+} Clkgen;
+
+/************************** Function Prototypes *****************************/
+
+int Clkgen_CfgInitialize(Clkgen *InstancePtr, u32 BaseAddress, u32 RefHz);
+int Clkgen_SolveModes(Clkgen *InstancePtr);
+int Clkgen_SetMode(Clkgen *InstancePtr, u32 Mode);
+int Clkgen_SetRate(Clkgen *InstancePtr, u32 RateHz);
+int Clkgen_Program(Clkgen *InstancePtr, const Clkgen_Setting *SettingPtr);
+u32 Clkgen_GetRate(Clkgen *InstancePtr);
+u32 Clkgen_ModeRate(u32 Mode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLKGEN_H */
@@ -0,0 +1,108 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file clkgen_l.h
+*
+* This header file contains the register offsets and bit definitions of the
+* axi_clkgen core (pcores/axi_clkgen_v1_00_a, see regmap.txt) and the low
+* level access macros.
+*
+* The clk_out, clk_div, clk_fb, lock and filter registers hold the MMCM DRP
+* values, cf_clkgen.v writes them to the MMCM on a rising edge of the start
+* bit, holding the MMCM in reset meanwhile. The start edge is ignored while
+* the MMCM is not locked.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef CLKGEN_L_H /* prevent circular inclusions */
+#define CLKGEN_L_H /* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xil_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************** Constant Definitions ****************************/
+
+/** @name Register offsets
+ * @{
+ */
+#define CLKGEN_VERSION_OFFSET		0x00	/**< Core version */
+#define CLKGEN_CTRL_OFFSET		0x04	/**< Start, software reset */
+#define CLKGEN_CLK_OUT_1_OFFSET		0x08	/**< MMCM DRP 0x08 */
+#define CLKGEN_CLK_OUT_2_OFFSET		0x0C	/**< MMCM DRP 0x09 */
+#define CLKGEN_CLK_DIV_OFFSET		0x10	/**< MMCM DRP 0x16 */
+#define CLKGEN_CLK_FB_1_OFFSET		0x14	/**< MMCM DRP 0x14 */
+#define CLKGEN_CLK_FB_2_OFFSET		0x18	/**< MMCM DRP 0x15 */
+#define CLKGEN_LOCK_1_OFFSET		0x1C	/**< MMCM DRP 0x18 */
+#define CLKGEN_LOCK_2_OFFSET		0x20	/**< MMCM DRP 0x19 */
+#define CLKGEN_LOCK_3_OFFSET		0x24	/**< MMCM DRP 0x1A */
+#define CLKGEN_FILTER_1_OFFSET		0x28	/**< MMCM DRP 0x4E */
+#define CLKGEN_FILTER_2_OFFSET		0x2C	/**< MMCM DRP 0x4F */
+#define CLKGEN_STATUS_OFFSET		0x7C	/**< MMCM state (RO) */
+/* @} */
+
+#define CLKGEN_NUM_DRP_REGS		10	/**< clk_out_1 to filter_2 */
+
+/** @name Control register bits
+ * @{
+ */
+#define CLKGEN_CTRL_SWRST_MASK		0x02	/**< Hold the MMCM in reset */
+#define CLKGEN_CTRL_START_MASK		0x01	/**< Rising edge writes DRP */
+/* @} */
+
+/** @name Status register bits
+ * @{
+ */
+#define CLKGEN_STATUS_RST_MASK		0x02	/**< MMCM in reset */
+#define CLKGEN_STATUS_LOCKED_MASK	0x01	/**< MMCM locked */
+/* @} */
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define Clkgen_ReadReg(BaseAddress, RegOffset) \
+	Xil_In32((BaseAddress) + (RegOffset))
+
+#define Clkgen_WriteReg(BaseAddress, RegOffset, Data) \
+	Xil_Out32((BaseAddress) + (RegOffset), (Data))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLKGEN_L_H */
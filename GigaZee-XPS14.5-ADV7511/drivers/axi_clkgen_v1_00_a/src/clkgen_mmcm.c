@@ -0,0 +1,270 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file clkgen_mmcm.c
+*
+* MMCM parameter solver for the axi_clkgen core. See clkgen_mmcm.h for the
+* description.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "clkgen_mmcm.h"
+
+/************************** Constant Definitions ****************************/
+
+/*
+ * Lock settings per M, index M - 1, as
+ * LockRefDly[28:24] LockFbDly[20:16] LockCnt[9:0]. M above the table uses
+ * CLKGEN_LOCK_DEFAULT. LockSatHigh and UnlockCnt are the same for all M.
+ */
+static const u32 LockTable[] = {
+	0x060603E8, 0x060603E8, 0x080803E8, 0x0B0B03E8,
+	0x0E0E03E8, 0x111103E8, 0x131303E8, 0x161603E8,
+	0x191903E8, 0x1C1C03E8, 0x1F1F0384, 0x1F1F0339,
+	0x1F1F02EE, 0x1F1F02BC, 0x1F1F028A, 0x1F1F0271,
+	0x1F1F023F, 0x1F1F0226, 0x1F1F020D, 0x1F1F01F4,
+	0x1F1F01DB, 0x1F1F01C2, 0x1F1F01A9, 0x1F1F0190,
+	0x1F1F0190, 0x1F1F0177, 0x1F1F015E, 0x1F1F015E,
+	0x1F1F0145, 0x1F1F0145, 0x1F1F012C, 0x1F1F012C,
+	0x1F1F012C, 0x1F1F0113, 0x1F1F0113, 0x1F1F0113,
+};
+
+#define CLKGEN_LOCK_DEFAULT	0x1F1F00FA
+#define CLKGEN_LOCK_SAT_HIGH	0x3E9
+#define CLKGEN_UNLOCK_CNT	0x001
+
+/*
+ * Loop filter settings per M, index M - 1, as filter_1 in [31:16] and
+ * filter_2 in [15:0], already placed on the DRP bit positions. M above the
+ * table uses CLKGEN_FILTER_DEFAULT.
+ */
+static const u32 FilterTable[] = {
+	0x01001990, 0x01001190, 0x01009890, 0x01001890,
+	0x01008890, 0x01009090, 0x01009090, 0x01009090,
+	0x01009090, 0x01000890, 0x01000890, 0x01000890,
+	0x08009090, 0x01001090, 0x01001090, 0x01001090,
+	0x01001090, 0x01001090, 0x01001090, 0x01001090,
+	0x01001090, 0x01001090, 0x01001090, 0x01008090,
+	0x01008090, 0x02001090, 0x02001090, 0x02001090,
+	0x02001090, 0x02001090, 0x02001090, 0x08001090,
+};
+
+#define CLKGEN_FILTER_DEFAULT	0x08001090
+
+#define ARRAY_SIZE(a)		(sizeof(a) / sizeof((a)[0]))
+
+/**************************** Type Definitions ******************************/
+
+/*
+ * DRP counter fields of one divider
+ */
+typedef struct {
+	u32 High;
+	u32 Low;
+	u32 Edge;
+	u32 NoCount;
+} Counter;
+
+/************************** Function Prototypes *****************************/
+
+static void CalcCounter(u32 Divide, Counter *CounterPtr);
+
+/*****************************************************************************/
+/**
+*
+* Find the MMCM setting closest to a requested output clock and encode it.
+*
+* @param	RefHz is the reference clock, ref_clk of the core.
+* @param	RateHz is the requested output clock.
+* @param	SettingPtr receives the setting.
+*
+* @return
+*		- XST_SUCCESS if a setting was found. RateHz of the setting
+*		  tells how close it is.
+*		- XST_INVALID_PARAM if no D keeps the phase detector in range
+*		  or the request is out of the output range.
+*
+* @note		D is walked upwards and for each D only the M that keep
+*		the VCO in range are tried, with the two O around the ideal
+*		one. That is a few hundred candidates for a 200 MHz reference.
+*
+******************************************************************************/
+int Clkgen_MmcmSolve(u32 RefHz, u32 RateHz, Clkgen_Setting *SettingPtr)
+{
+	u32 D, DMin, DMax;
+	u32 M, MMin, MMax;
+	u32 O, OIdeal;
+	u64 Vco;		/* RefHz * M, the VCO times D */
+	u64 Want;		/* RateHz * D */
+	u64 Err, Den;
+	u64 BestErr = 0;
+	u64 BestDen = 0;
+	u32 BestD = 0, BestM = 0, BestO = 0;
+
+	if ((RateHz == 0) || (RateHz > CLKGEN_MMCM_OUT_MAX) ||
+	    (RefHz < CLKGEN_MMCM_PFD_MIN)) {
+		return XST_INVALID_PARAM;
+	}
+
+	DMin = (RefHz + CLKGEN_MMCM_PFD_MAX - 1) / CLKGEN_MMCM_PFD_MAX;
+	DMax = RefHz / CLKGEN_MMCM_PFD_MIN;
+	if (DMax > CLKGEN_MMCM_DIV_MAX) {
+		DMax = CLKGEN_MMCM_DIV_MAX;
+	}
+
+	for (D = DMin; D <= DMax; D++) {
+		MMin = (u32)(((u64)CLKGEN_MMCM_VCO_MIN * D + RefHz - 1) / RefHz);
+		MMax = (u32)(((u64)CLKGEN_MMCM_VCO_MAX * D) / RefHz);
+		if (MMin < CLKGEN_MMCM_MULT_MIN) {
+			MMin = CLKGEN_MMCM_MULT_MIN;
+		}
+		if (MMax > CLKGEN_MMCM_MULT_MAX) {
+			MMax = CLKGEN_MMCM_MULT_MAX;
+		}
+
+		Want = (u64)RateHz * D;
+
+		for (M = MMin; M <= MMax; M++) {
+			Vco = (u64)RefHz * M;
+			OIdeal = (u32)(Vco / Want);
+
+			/* The ideal O lies between OIdeal and OIdeal + 1 */
+			for (O = OIdeal; O <= OIdeal + 1; O++) {
+				if ((O == 0) || (O > CLKGEN_MMCM_OUT_DIV_MAX)) {
+					continue;
+				}
+				Err = Vco > Want * O ? Vco - Want * O :
+						       Want * O - Vco;
+				Den = (u64)D * O;
+
+				/*
+				 * Error in Hz is Err / Den, compare the
+				 * fractions. On a tie take the higher VCO,
+				 * Vco / D.
+				 */
+				if ((BestDen == 0) ||
+				    (Err * BestDen < BestErr * Den) ||
+				    ((Err * BestDen == BestErr * Den) &&
+				     ((u64)M * BestD > (u64)BestM * D))) {
+					BestErr = Err;
+					BestDen = Den;
+					BestD = D;
+					BestM = M;
+					BestO = O;
+				}
+			}
+		}
+	}
+
+	if (BestDen == 0) {
+		return XST_INVALID_PARAM;
+	}
+
+	SettingPtr->Div = BestD;
+	SettingPtr->Mult = BestM;
+	SettingPtr->OutDiv = BestO;
+	SettingPtr->RateHz = (u32)(((u64)RefHz * BestM + BestDen / 2) /
+				   BestDen);
+	Clkgen_MmcmEncode(SettingPtr);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* Encode D, M and O of a setting into the DRP values of the core.
+*
+* @param	SettingPtr is the setting, Div, Mult and OutDiv must be
+*		valid, Reg is written.
+*
+* @return	None.
+*
+* @note		The layout follows the DRP masks of cf_clkgen.v: phase and
+*		delay are zero, the duty cycle is 50%.
+*
+******************************************************************************/
+void Clkgen_MmcmEncode(Clkgen_Setting *SettingPtr)
+{
+	Counter Cnt;
+	u32 Lock;
+	u32 Filter;
+	u16 *Reg = SettingPtr->Reg;
+
+	CalcCounter(SettingPtr->OutDiv, &Cnt);
+	Reg[0] = (u16)((Cnt.High << 6) | Cnt.Low);
+	Reg[1] = (u16)((Cnt.Edge << 7) | (Cnt.NoCount << 6));
+
+	CalcCounter(SettingPtr->Div, &Cnt);
+	Reg[2] = (u16)((Cnt.Edge << 13) | (Cnt.NoCount << 12) |
+		       (Cnt.High << 6) | Cnt.Low);
+
+	CalcCounter(SettingPtr->Mult, &Cnt);
+	Reg[3] = (u16)((Cnt.High << 6) | Cnt.Low);
+	Reg[4] = (u16)((Cnt.Edge << 7) | (Cnt.NoCount << 6));
+
+	if (SettingPtr->Mult - 1 < ARRAY_SIZE(LockTable)) {
+		Lock = LockTable[SettingPtr->Mult - 1];
+	} else {
+		Lock = CLKGEN_LOCK_DEFAULT;
+	}
+	Reg[5] = (u16)(Lock & 0x3FF);
+	Reg[6] = (u16)((((Lock >> 16) & 0x1F) << 10) | CLKGEN_UNLOCK_CNT);
+	Reg[7] = (u16)((((Lock >> 24) & 0x1F) << 10) | CLKGEN_LOCK_SAT_HIGH);
+
+	if (SettingPtr->Mult - 1 < ARRAY_SIZE(FilterTable)) {
+		Filter = FilterTable[SettingPtr->Mult - 1];
+	} else {
+		Filter = CLKGEN_FILTER_DEFAULT;
+	}
+	Reg[8] = (u16)(Filter >> 16);
+	Reg[9] = (u16)(Filter & 0xFFFF);
+}
+
+/*****************************************************************************/
+/*
+* Split a divider into the high and low time of the DRP counter, 50% duty
+* cycle. Odd dividers set the edge bit, 1 bypasses the counter. High and
+* low times of 64 are encoded as 0.
+*
+******************************************************************************/
+static void CalcCounter(u32 Divide, Counter *CounterPtr)
+{
+	CounterPtr->NoCount = (Divide == 1) ? 1 : 0;
+	CounterPtr->High = (Divide / 2) & 0x3F;
+	CounterPtr->Low = (Divide - Divide / 2) & 0x3F;
+	CounterPtr->Edge = Divide % 2;
+}
@@ -0,0 +1,111 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file clkgen_mmcm.h
+*
+* MMCM parameter solver for the axi_clkgen core. For a reference clock and a
+* requested output clock it searches the divider D (DIVCLK_DIVIDE), the
+* multiplier M (CLKFBOUT_MULT) and the output divider O (CLKOUT0_DIVIDE) for
+*
+*	Fout = Fref * M / (D * O)
+*
+* closest to the request, keeping the phase detector and the VCO within the
+* limits of the 7 series MMCM, -1 speed grade (DS187). Of equally close
+* solutions the one with the higher VCO frequency is taken, it has the lower
+* output jitter. The search is exact integer arithmetic, no floating point.
+*
+* The solution is encoded into the ten DRP values of the core, clk_out_1 to
+* filter_2, including the lock and loop filter settings for M taken from the
+* MMCM reference tables (XAPP888, BANDWIDTH = OPTIMIZED).
+*
+* Only integer dividers are used: cf_clkgen.v preserves the fractional
+* divide fields of the DRP registers, which are zero in the bitstream.
+*
+* The solver does not access the hardware and builds on a host, see
+* tools/clkgen_bench.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef CLKGEN_MMCM_H /* prevent circular inclusions */
+#define CLKGEN_MMCM_H /* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xstatus.h"
+#include "clkgen_l.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************** Constant Definitions ****************************/
+
+/** @name MMCME2 limits, -1 speed grade
+ * @{
+ */
+#define CLKGEN_MMCM_PFD_MIN	10000000	/**< Phase detector, Hz */
+#define CLKGEN_MMCM_PFD_MAX	450000000
+#define CLKGEN_MMCM_VCO_MIN	600000000	/**< VCO, Hz */
+#define CLKGEN_MMCM_VCO_MAX	1200000000
+#define CLKGEN_MMCM_OUT_MAX	464000000	/**< BUFG, Hz */
+#define CLKGEN_MMCM_DIV_MAX	106		/**< DIVCLK_DIVIDE */
+#define CLKGEN_MMCM_MULT_MIN	2		/**< CLKFBOUT_MULT */
+#define CLKGEN_MMCM_MULT_MAX	64
+#define CLKGEN_MMCM_OUT_DIV_MAX	128		/**< CLKOUT0_DIVIDE */
+/* @} */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * A solved MMCM setting
+ */
+typedef struct {
+	u32 Div;			/**< D, DIVCLK_DIVIDE */
+	u32 Mult;			/**< M, CLKFBOUT_MULT */
+	u32 OutDiv;			/**< O, CLKOUT0_DIVIDE */
+	u32 RateHz;			/**< Output clock, rounded */
+	u16 Reg[CLKGEN_NUM_DRP_REGS];	/**< clk_out_1 to filter_2 */
+} Clkgen_Setting;
+
+/************************** Function Prototypes *****************************/
+
+int Clkgen_MmcmSolve(u32 RefHz, u32 RateHz, Clkgen_Setting *SettingPtr);
+void Clkgen_MmcmEncode(Clkgen_Setting *SettingPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLKGEN_MMCM_H */
@@ -0,0 +1,559 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file hdmi_edid.c
+*
+* EDID parser and video timing database. See hdmi_edid.h for the
+* description.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* 1.00a te   10/16/26 CEA blocks with a DTD offset past the block are ignored
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "hdmi_edid.h"
+#include "xil_assert.h"
+
+/************************** Constant Definitions ****************************/
+
+#define HP	HDMI_TIMING_HSYNC_POS
+#define VP	HDMI_TIMING_VSYNC_POS
+#define W	HDMI_TIMING_ASPECT_16_9
+
+/*
+ * CEA-861 progressive formats, the interlaced ones cannot be sent
+ */
+static const HdmiTx_Timing CeaTable[] = {
+	{  25175000,  640,  16,  96,  48,  480, 10, 2, 33, 0,          1 },
+	{  27000000,  720,  16,  62,  60,  480,  9, 6, 30, 0,          2 },
+	{  27000000,  720,  16,  62,  60,  480,  9, 6, 30, W,          3 },
+	{  74250000, 1280, 110,  40, 220,  720,  5, 5, 20, HP | VP | W, 4 },
+	{ 148500000, 1920,  88,  44, 148, 1080,  4, 5, 36, HP | VP | W, 16 },
+	{  27000000,  720,  12,  64,  68,  576,  5, 5, 39, 0,          17 },
+	{  27000000,  720,  12,  64,  68,  576,  5, 5, 39, W,          18 },
+	{  74250000, 1280, 440,  40, 220,  720,  5, 5, 20, HP | VP | W, 19 },
+	{ 148500000, 1920, 528,  44, 148, 1080,  4, 5, 36, HP | VP | W, 31 },
+	{  74250000, 1920, 638,  44, 148, 1080,  4, 5, 36, HP | VP | W, 32 },
+	{  74250000, 1920, 528,  44, 148, 1080,  4, 5, 36, HP | VP | W, 33 },
+	{  74250000, 1920,  88,  44, 148, 1080,  4, 5, 36, HP | VP | W, 34 },
+};
+
+/*
+ * VESA DMT formats reachable through established and standard timings
+ */
+static const HdmiTx_Timing DmtTable[] = {
+	{  25175000,  640,  16,  96,  48,  480, 10, 2, 33, 0,       0 },
+	{  40000000,  800,  40, 128,  88,  600,  1, 4, 23, HP | VP, 0 },
+	{  65000000, 1024,  24, 136, 160,  768,  3, 6, 29, 0,       0 },
+	{ 108000000, 1152,  64, 128, 256,  864,  1, 3, 32, HP | VP, 0 },
+	{  74250000, 1280, 110,  40, 220,  720,  5, 5, 20, HP | VP | W, 0 },
+	{  83500000, 1280,  72, 128, 200,  800,  3, 6, 22, VP,      0 },
+	{ 108000000, 1280,  96, 112, 312,  960,  1, 3, 36, HP | VP, 0 },
+	{ 108000000, 1280,  48, 112, 248, 1024,  1, 3, 38, HP | VP, 0 },
+	{  85500000, 1360,  64, 112, 256,  768,  3, 6, 18, HP | VP | W, 0 },
+	{ 106500000, 1440,  80, 152, 232,  900,  3, 6, 25, VP,      0 },
+	{ 162000000, 1600,  64, 192, 304, 1200,  1, 3, 46, HP | VP, 0 },
+	{ 146250000, 1680, 104, 176, 280, 1050,  3, 6, 30, VP,      0 },
+	{ 148500000, 1920,  88,  44, 148, 1080,  4, 5, 36, HP | VP | W, 0 },
+};
+
+#undef HP
+#undef VP
+#undef W
+
+#define ARRAY_SIZE(a)		(sizeof(a) / sizeof((a)[0]))
+
+/*
+ * Base block layout
+ */
+#define EDID_EXTENSIONS		0x7E
+#define EDID_ESTABLISHED	0x23
+#define EDID_STANDARD		0x26
+#define EDID_DESCRIPTORS	0x36
+#define EDID_NUM_STANDARD	8
+#define EDID_NUM_DESCRIPTORS	4
+#define EDID_DESCRIPTOR_SIZE	18
+
+#define CEA_TAG			0x02
+#define CEA_DB_VIDEO		2
+#define CEA_DB_VENDOR		3
+#define CEA_YCBCR444_MASK	0x20
+
+/************************** Function Prototypes *****************************/
+
+static int BlockValid(const u8 *BlockPtr);
+static int DecodeDtd(const u8 *DtdPtr, HdmiTx_Timing *TimingPtr);
+static u32 AddTiming(HdmiTx_Edid *EdidPtr, const HdmiTx_Timing *TimingPtr);
+static void AddDmt(HdmiTx_Edid *EdidPtr, u32 HActive, u32 VActive,
+		   u32 Refresh);
+static void ParseCea(HdmiTx_Edid *EdidPtr, const u8 *BlockPtr);
+static int SameTiming(const HdmiTx_Timing *APtr, const HdmiTx_Timing *BPtr);
+
+/*****************************************************************************/
+/**
+*
+* Parse an EDID into the timings and capabilities of the sink.
+*
+* @param	DataPtr is the EDID, base block first.
+* @param	Len is the number of bytes at DataPtr, extension blocks
+*		beyond it are not parsed.
+* @param	EdidPtr receives the result.
+*
+* @return
+*		- XST_SUCCESS if the base block is valid.
+*		- XST_FAILURE if the header or the checksum of the base
+*		  block is wrong, EdidPtr is empty then.
+*
+******************************************************************************/
+int HdmiTx_EdidParse(const u8 *DataPtr, u32 Len, HdmiTx_Edid *EdidPtr)
+{
+	static const u8 Header[8] = {
+		0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00
+	};
+	HdmiTx_Timing Timing;
+	const u8 *BlockPtr;
+	u32 Index;
+	u32 Block;
+	u32 Byte;
+	u32 HActive;
+	u32 Aspect;
+
+	Xil_AssertNonvoid(DataPtr != NULL);
+	Xil_AssertNonvoid(EdidPtr != NULL);
+
+	memset(EdidPtr, 0, sizeof(HdmiTx_Edid));
+	EdidPtr->Preferred = HDMI_EDID_NONE;
+
+	if ((Len < HDMI_EDID_BLOCK_SIZE) ||
+	    (memcmp(DataPtr, Header, sizeof(Header)) != 0) ||
+	    !BlockValid(DataPtr)) {
+		return XST_FAILURE;
+	}
+
+	/* Detailed timings, the first one is the preferred timing */
+	for (Index = 0; Index < EDID_NUM_DESCRIPTORS; Index++) {
+		if (DecodeDtd(DataPtr + EDID_DESCRIPTORS +
+			      Index * EDID_DESCRIPTOR_SIZE,
+			      &Timing) != XST_SUCCESS) {
+			continue;
+		}
+		if (Index == 0) {
+			Timing.Flags |= HDMI_TIMING_PREFERRED;
+			EdidPtr->Preferred = AddTiming(EdidPtr, &Timing);
+		} else {
+			AddTiming(EdidPtr, &Timing);
+		}
+	}
+
+	/* Established timings */
+	if ((DataPtr[EDID_ESTABLISHED] & 0x20) != 0) {
+		AddDmt(EdidPtr, 640, 480, 60);
+	}
+	if ((DataPtr[EDID_ESTABLISHED] & 0x01) != 0) {
+		AddDmt(EdidPtr, 800, 600, 60);
+	}
+	if ((DataPtr[EDID_ESTABLISHED + 1] & 0x08) != 0) {
+		AddDmt(EdidPtr, 1024, 768, 60);
+	}
+
+	/* Standard timings, 0x01 0x01 marks an unused entry */
+	for (Index = 0; Index < EDID_NUM_STANDARD; Index++) {
+		Byte = EDID_STANDARD + 2 * Index;
+		if ((DataPtr[Byte] == 0x01) && (DataPtr[Byte + 1] == 0x01)) {
+			continue;
+		}
+		HActive = (DataPtr[Byte] + 31) * 8;
+		Aspect = DataPtr[Byte + 1] >> 6;
+		AddDmt(EdidPtr, HActive,
+		       Aspect == 0 ? HActive * 10 / 16 :
+		       Aspect == 1 ? HActive * 3 / 4 :
+		       Aspect == 2 ? HActive * 4 / 5 : HActive * 9 / 16,
+		       (DataPtr[Byte + 1] & 0x3F) + 60);
+	}
+
+	EdidPtr->NumExtensions = DataPtr[EDID_EXTENSIONS];
+	for (Block = 1; (Block <= EdidPtr->NumExtensions) &&
+	     ((Block + 1) * HDMI_EDID_BLOCK_SIZE <= Len); Block++) {
+		BlockPtr = DataPtr + Block * HDMI_EDID_BLOCK_SIZE;
+		if ((BlockPtr[0] == CEA_TAG) && BlockValid(BlockPtr)) {
+			ParseCea(EdidPtr, BlockPtr);
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* Select the mode to send to a sink.
+*
+* @param	EdidPtr is the parsed EDID.
+* @param	MaxPixelClkHz is the fastest pixel clock of the output path.
+*
+* @return	Index of the timing in EdidPtr, HDMI_EDID_NONE if no timing
+*		can be sent.
+*
+* @note		The preferred timing wins if it can be sent. Otherwise the
+*		most active pixels win, then the refresh rate closest to
+*		60 Hz, then a CEA format.
+*
+******************************************************************************/
+u32 HdmiTx_EdidSelect(const HdmiTx_Edid *EdidPtr, u32 MaxPixelClkHz)
+{
+	const HdmiTx_Timing *TimingPtr;
+	u32 Index;
+	u32 Best = HDMI_EDID_NONE;
+	u32 Area, BestArea = 0;
+	u32 Dist, BestDist = 0;
+	u32 Refresh;
+
+	Xil_AssertNonvoid(EdidPtr != NULL);
+
+	for (Index = 0; Index < EdidPtr->NumTimings; Index++) {
+		TimingPtr = &EdidPtr->Timing[Index];
+		if (((TimingPtr->Flags & HDMI_TIMING_INTERLACED) != 0) ||
+		    (TimingPtr->PixelClkHz > MaxPixelClkHz)) {
+			continue;
+		}
+		if (Index == EdidPtr->Preferred) {
+			return Index;
+		}
+
+		Area = (u32)TimingPtr->HActive * TimingPtr->VActive;
+		Refresh = HdmiTx_TimingRefresh(TimingPtr);
+		Dist = Refresh > 60 ? Refresh - 60 : 60 - Refresh;
+
+		if ((Best == HDMI_EDID_NONE) || (Area > BestArea) ||
+		    ((Area == BestArea) && (Dist < BestDist)) ||
+		    ((Area == BestArea) && (Dist == BestDist) &&
+		     (TimingPtr->Vic != 0) &&
+		     (EdidPtr->Timing[Best].Vic == 0))) {
+			Best = Index;
+			BestArea = Area;
+			BestDist = Dist;
+		}
+	}
+
+	return Best;
+}
+
+/*****************************************************************************/
+/**
+*
+* Get the timing of a CEA-861 video code.
+*
+* @param	Vic is the video code.
+* @param	TimingPtr receives the timing.
+*
+* @return
+*		- XST_SUCCESS if the code is in the table.
+*		- XST_INVALID_PARAM for unknown and interlaced formats.
+*
+******************************************************************************/
+int HdmiTx_TimingFromVic(u32 Vic, HdmiTx_Timing *TimingPtr)
+{
+	u32 Index;
+
+	Xil_AssertNonvoid(TimingPtr != NULL);
+
+	for (Index = 0; Index < ARRAY_SIZE(CeaTable); Index++) {
+		if (CeaTable[Index].Vic == Vic) {
+			*TimingPtr = CeaTable[Index];
+			return XST_SUCCESS;
+		}
+	}
+
+	return XST_INVALID_PARAM;
+}
+
+/*****************************************************************************/
+/**
+*
+* Get the refresh rate of a timing.
+*
+* @param	TimingPtr is the timing.
+*
+* @return	Frames per second, rounded.
+*
+******************************************************************************/
+u32 HdmiTx_TimingRefresh(const HdmiTx_Timing *TimingPtr)
+{
+	u32 Total;
+
+	Total = (u32)(TimingPtr->HActive + TimingPtr->HFront +
+		      TimingPtr->HSync + TimingPtr->HBack) *
+		(TimingPtr->VActive + TimingPtr->VFront +
+		 TimingPtr->VSync + TimingPtr->VBack);
+	if (Total == 0) {
+		return 0;
+	}
+
+	return (TimingPtr->PixelClkHz + Total / 2) / Total;
+}
+
+/*****************************************************************************/
+/*
+* Check the checksum of a 128 byte block.
+*
+******************************************************************************/
+static int BlockValid(const u8 *BlockPtr)
+{
+	u32 Index;
+	u8 Sum = 0;
+
+	for (Index = 0; Index < HDMI_EDID_BLOCK_SIZE; Index++) {
+		Sum += BlockPtr[Index];
+	}
+
+	return Sum == 0;
+}
+
+/*****************************************************************************/
+/*
+* Decode an 18 byte detailed timing descriptor. Returns XST_FAILURE for
+* display descriptors, which have a zero pixel clock.
+*
+******************************************************************************/
+static int DecodeDtd(const u8 *DtdPtr, HdmiTx_Timing *TimingPtr)
+{
+	u32 Clock;
+	u32 HBlank, VBlank;
+	u32 X, Y;
+	u32 Index;
+
+	Clock = DtdPtr[0] | (DtdPtr[1] << 8);
+	if (Clock == 0) {
+		return XST_FAILURE;
+	}
+
+	memset(TimingPtr, 0, sizeof(HdmiTx_Timing));
+	TimingPtr->PixelClkHz = Clock * 10000;
+
+	TimingPtr->HActive = DtdPtr[2] | ((DtdPtr[4] & 0xF0) << 4);
+	HBlank = DtdPtr[3] | ((DtdPtr[4] & 0x0F) << 8);
+	TimingPtr->VActive = DtdPtr[5] | ((DtdPtr[7] & 0xF0) << 4);
+	VBlank = DtdPtr[6] | ((DtdPtr[7] & 0x0F) << 8);
+
+	TimingPtr->HFront = DtdPtr[8] | ((DtdPtr[11] & 0xC0) << 2);
+	TimingPtr->HSync = DtdPtr[9] | ((DtdPtr[11] & 0x30) << 4);
+	TimingPtr->VFront = (DtdPtr[10] >> 4) | ((DtdPtr[11] & 0x0C) << 2);
+	TimingPtr->VSync = (DtdPtr[10] & 0x0F) | ((DtdPtr[11] & 0x03) << 4);
+
+	if (HBlank < (u32)TimingPtr->HFront + TimingPtr->HSync) {
+		return XST_FAILURE;
+	}
+	if (VBlank < (u32)TimingPtr->VFront + TimingPtr->VSync) {
+		return XST_FAILURE;
+	}
+	TimingPtr->HBack = HBlank - TimingPtr->HFront - TimingPtr->HSync;
+	TimingPtr->VBack = VBlank - TimingPtr->VFront - TimingPtr->VSync;
+
+	if ((DtdPtr[17] & 0x80) != 0) {
+		TimingPtr->Flags |= HDMI_TIMING_INTERLACED;
+	}
+	if ((DtdPtr[17] & 0x18) == 0x18) {
+		if ((DtdPtr[17] & 0x04) != 0) {
+			TimingPtr->Flags |= HDMI_TIMING_VSYNC_POS;
+		}
+		if ((DtdPtr[17] & 0x02) != 0) {
+			TimingPtr->Flags |= HDMI_TIMING_HSYNC_POS;
+		}
+	}
+
+	/* Aspect from the image size if given, 16:9 if wider than 5:3 */
+	X = DtdPtr[12] | ((DtdPtr[14] & 0xF0) << 4);
+	Y = DtdPtr[13] | ((DtdPtr[14] & 0x0F) << 8);
+	if ((X == 0) || (Y == 0)) {
+		X = TimingPtr->HActive;
+		Y = TimingPtr->VActive;
+	}
+	if (X * 3 >= Y * 5) {
+		TimingPtr->Flags |= HDMI_TIMING_ASPECT_16_9;
+	}
+
+	/* A CEA format sent as detailed timing keeps its video code */
+	for (Index = 0; Index < ARRAY_SIZE(CeaTable); Index++) {
+		if (SameTiming(&CeaTable[Index], TimingPtr) &&
+		    (((CeaTable[Index].Flags ^ TimingPtr->Flags) &
+		      HDMI_TIMING_ASPECT_16_9) == 0)) {
+			TimingPtr->Vic = CeaTable[Index].Vic;
+			break;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/*
+* Add a timing unless it is known already, in which case the flags and the
+* video code are merged. Returns the index, HDMI_EDID_NONE if the table is
+* full.
+*
+******************************************************************************/
+static u32 AddTiming(HdmiTx_Edid *EdidPtr, const HdmiTx_Timing *TimingPtr)
+{
+	HdmiTx_Timing *EntryPtr;
+	u32 Index;
+
+	for (Index = 0; Index < EdidPtr->NumTimings; Index++) {
+		EntryPtr = &EdidPtr->Timing[Index];
+		if (SameTiming(EntryPtr, TimingPtr)) {
+			EntryPtr->Flags |= TimingPtr->Flags &
+				(HDMI_TIMING_PREFERRED | HDMI_TIMING_NATIVE);
+			if (EntryPtr->Vic == 0) {
+				EntryPtr->Vic = TimingPtr->Vic;
+			}
+			return Index;
+		}
+	}
+
+	if (EdidPtr->NumTimings == HDMI_EDID_MAX_TIMINGS) {
+		return HDMI_EDID_NONE;
+	}
+
+	EdidPtr->Timing[EdidPtr->NumTimings] = *TimingPtr;
+	return EdidPtr->NumTimings++;
+}
+
+/*****************************************************************************/
+/*
+* Add the DMT format of the given size and refresh rate, if known.
+*
+******************************************************************************/
+static void AddDmt(HdmiTx_Edid *EdidPtr, u32 HActive, u32 VActive,
+		   u32 Refresh)
+{
+	u32 Index;
+
+	for (Index = 0; Index < ARRAY_SIZE(DmtTable); Index++) {
+		if ((DmtTable[Index].HActive == HActive) &&
+		    (DmtTable[Index].VActive == VActive) &&
+		    (HdmiTx_TimingRefresh(&DmtTable[Index]) == Refresh)) {
+			AddTiming(EdidPtr, &DmtTable[Index]);
+			return;
+		}
+	}
+}
+
+/*****************************************************************************/
+/*
+* Parse a CEA-861 extension block: capabilities, short video descriptors,
+* HDMI vendor specific data block and detailed timings.
+*
+******************************************************************************/
+static void ParseCea(HdmiTx_Edid *EdidPtr, const u8 *BlockPtr)
+{
+	HdmiTx_Timing Timing;
+	u32 DtdOffset = BlockPtr[2];
+	u32 Offset;
+	u32 Tag, Len;
+	u32 Index;
+
+	if (BlockPtr[1] >= 2) {
+		EdidPtr->YCbCr444 |= (BlockPtr[3] & CEA_YCBCR444_MASK) != 0;
+	}
+
+	/* An offset outside of the block leaves nothing to parse */
+	if (DtdOffset >= HDMI_EDID_BLOCK_SIZE) {
+		return;
+	}
+
+	/* Data block collection, revision 3 and later */
+	if ((BlockPtr[1] >= 3) && (DtdOffset >= 4)) {
+		for (Offset = 4; Offset < DtdOffset; Offset += Len + 1) {
+			Tag = BlockPtr[Offset] >> 5;
+			Len = BlockPtr[Offset] & 0x1F;
+			if (Offset + Len >= DtdOffset) {
+				break;
+			}
+
+			if (Tag == CEA_DB_VIDEO) {
+				for (Index = 1; Index <= Len; Index++) {
+					if (HdmiTx_TimingFromVic(
+						BlockPtr[Offset + Index] & 0x7F,
+						&Timing) != XST_SUCCESS) {
+						continue;
+					}
+					if ((BlockPtr[Offset + Index] &
+					     0x80) != 0) {
+						Timing.Flags |=
+							HDMI_TIMING_NATIVE;
+					}
+					AddTiming(EdidPtr, &Timing);
+				}
+			} else if ((Tag == CEA_DB_VENDOR) && (Len >= 3) &&
+				   (BlockPtr[Offset + 1] == 0x03) &&
+				   (BlockPtr[Offset + 2] == 0x0C) &&
+				   (BlockPtr[Offset + 3] == 0x00)) {
+				EdidPtr->IsHdmi = 1;
+			}
+		}
+	}
+
+	/* Detailed timings up to the checksum byte */
+	if (DtdOffset < 4) {
+		return;
+	}
+	for (Offset = DtdOffset;
+	     Offset + EDID_DESCRIPTOR_SIZE < HDMI_EDID_BLOCK_SIZE;
+	     Offset += EDID_DESCRIPTOR_SIZE) {
+		if (DecodeDtd(BlockPtr + Offset, &Timing) != XST_SUCCESS) {
+			break;
+		}
+		AddTiming(EdidPtr, &Timing);
+	}
+}
+
+/*****************************************************************************/
+/*
+* Compare the clock and the geometry of two timings, ignoring the flags
+* other than interlace.
+*
+******************************************************************************/
+static int SameTiming(const HdmiTx_Timing *APtr, const HdmiTx_Timing *BPtr)
+{
+	return (APtr->PixelClkHz == BPtr->PixelClkHz) &&
+	       (APtr->HActive == BPtr->HActive) &&
+	       (APtr->HFront == BPtr->HFront) &&
+	       (APtr->HSync == BPtr->HSync) &&
+	       (APtr->HBack == BPtr->HBack) &&
+	       (APtr->VActive == BPtr->VActive) &&
+	       (APtr->VFront == BPtr->VFront) &&
+	       (APtr->VSync == BPtr->VSync) &&
+	       (APtr->VBack == BPtr->VBack) &&
+	       (((APtr->Flags ^ BPtr->Flags) & HDMI_TIMING_INTERLACED) == 0);
+}
@@ -0,0 +1,125 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file hdmi_edid.h
+*
+* EDID parser and video timing database for the HDMI output.
+*
+* HdmiTx_EdidParse collects the timings a sink supports from the EDID base
+* block (detailed timings, established and standard timings) and from a
+* CEA-861 extension block (short video descriptors, detailed timings), and
+* records whether the sink is HDMI (HDMI vendor specific data block) and
+* accepts YCbCr 4:4:4. Established, standard and CEA timings are resolved
+* through the built in VESA DMT and CEA-861 tables; unknown ones are
+* skipped. Blocks with a bad checksum are ignored.
+*
+* HdmiTx_EdidSelect picks the mode to use: the preferred timing of the sink
+* if the output path can make it, otherwise the largest mode, closest to
+* 60 Hz. The axi_hdmi_tx_12b core is progressive only, interlaced timings
+* are never selected.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef HDMI_EDID_H /* prevent circular inclusions */
+#define HDMI_EDID_H /* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************** Constant Definitions ****************************/
+
+#define HDMI_EDID_BLOCK_SIZE	128
+#define HDMI_EDID_MAX_TIMINGS	32	/**< Timings kept per sink */
+#define HDMI_EDID_NONE		0xFFFFFFFF
+
+/** @name Timing flags
+ * @{
+ */
+#define HDMI_TIMING_HSYNC_POS		0x01	/**< Positive HSYNC */
+#define HDMI_TIMING_VSYNC_POS		0x02	/**< Positive VSYNC */
+#define HDMI_TIMING_INTERLACED		0x04
+#define HDMI_TIMING_ASPECT_16_9		0x08	/**< 16:9, else 4:3 */
+#define HDMI_TIMING_PREFERRED		0x10	/**< Preferred by the sink */
+#define HDMI_TIMING_NATIVE		0x20	/**< Native CEA format */
+/* @} */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Video timing, horizontal values in pixels, vertical values in lines
+ */
+typedef struct {
+	u32 PixelClkHz;
+	u16 HActive;
+	u16 HFront;
+	u16 HSync;
+	u16 HBack;
+	u16 VActive;
+	u16 VFront;
+	u16 VSync;
+	u16 VBack;
+	u8 Flags;		/**< HDMI_TIMING_* */
+	u8 Vic;			/**< CEA-861 video code, 0 if none */
+} HdmiTx_Timing;
+
+/**
+ * Capabilities of a sink
+ */
+typedef struct {
+	HdmiTx_Timing Timing[HDMI_EDID_MAX_TIMINGS];
+	u32 NumTimings;
+	u32 Preferred;		/**< Index in Timing, HDMI_EDID_NONE if none */
+	u32 IsHdmi;		/**< HDMI VSDB present, else DVI */
+	u32 YCbCr444;		/**< Accepts YCbCr 4:4:4 */
+	u32 NumExtensions;	/**< Extension blocks announced */
+} HdmiTx_Edid;
+
+/************************** Function Prototypes *****************************/
+
+int HdmiTx_EdidParse(const u8 *DataPtr, u32 Len, HdmiTx_Edid *EdidPtr);
+u32 HdmiTx_EdidSelect(const HdmiTx_Edid *EdidPtr, u32 MaxPixelClkHz);
+int HdmiTx_TimingFromVic(u32 Vic, HdmiTx_Timing *TimingPtr);
+u32 HdmiTx_TimingRefresh(const HdmiTx_Timing *TimingPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HDMI_EDID_H */
@@ -0,0 +1,491 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file hdmi_fb.c
+*
+* Frame buffer manager for the axi_vdma -> axi_hdmi_tx_12b video path. See
+* hdmi_fb.h for the description.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* 1.01a te   10/16/26 A flip retires the queued buffer the VDMA already
+*                     reads instead of dropping it, Repeated counts frames
+*                     of the same frame store
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "hdmi_fb.h"
+#include "hdmi_tx_l.h"
+#include "hdmi_vdma_l.h"
+#include "xil_assert.h"
+#include "xil_exception.h"
+
+/************************** Constant Definitions ****************************/
+
+#define HDMI_FB_RESET_TIMEOUT	1000000	/* Polls of the reset bit */
+#define HDMI_FB_ALIGN		8	/* 64 bit MM2S data width */
+#define HDMI_FB_BYTES_PER_PIXEL	4
+
+/*
+ * Critical section against HdmiFb_IntrHandler
+ */
+#define HdmiFb_Lock()		Xil_ExceptionDisableMask(XIL_EXCEPTION_IRQ)
+#define HdmiFb_Unlock()		Xil_ExceptionEnableMask(XIL_EXCEPTION_IRQ)
+
+/************************** Function Prototypes *****************************/
+
+static void Retire(HdmiFb *InstancePtr, u32 Frames);
+static void StubHandler(void *CallBackRef, u32 Index);
+
+/*****************************************************************************/
+/**
+*
+* Initialize a frame buffer manager instance.
+*
+* @param	InstancePtr is the instance to initialize.
+* @param	ConfigPtr is the hardware configuration.
+* @param	AddrList holds the DDR addresses of the frame buffers.
+* @param	NumBuffers is the number of frame buffers, 2 up to the
+*		number of VDMA frame stores and HDMI_FB_MAX_BUFFERS.
+* @param	Width is the number of pixels per line.
+* @param	Height is the number of lines.
+* @param	Stride is the line stride in bytes.
+*
+* @return
+*		- XST_SUCCESS if successful.
+*		- XST_INVALID_PARAM if the buffer count, geometry or the
+*		  alignment is not supported.
+*
+* @note		Buffer 0 is scanned out first.
+*
+******************************************************************************/
+int HdmiFb_CfgInitialize(HdmiFb *InstancePtr, const HdmiFb_Config *ConfigPtr,
+			 const u32 *AddrList, u32 NumBuffers, u32 Width,
+			 u32 Height, u32 Stride)
+{
+	u32 Index;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(ConfigPtr != NULL);
+	Xil_AssertNonvoid(AddrList != NULL);
+
+	if ((NumBuffers < 2) || (NumBuffers > HDMI_FB_MAX_BUFFERS) ||
+	    (NumBuffers > ConfigPtr->NumFrameStores)) {
+		return XST_INVALID_PARAM;
+	}
+	if ((Width == 0) || (Height == 0) || (Height > 0x1FFF) ||
+	    (Stride < Width * HDMI_FB_BYTES_PER_PIXEL) || (Stride > 0xFFFF) ||
+	    ((Stride % HDMI_FB_ALIGN) != 0)) {
+		return XST_INVALID_PARAM;
+	}
+
+	memset(InstancePtr, 0, sizeof(HdmiFb));
+	InstancePtr->Config = *ConfigPtr;
+
+	for (Index = 0; Index < NumBuffers; Index++) {
+		if ((AddrList[Index] % HDMI_FB_ALIGN) != 0) {
+			return XST_INVALID_PARAM;
+		}
+		InstancePtr->Addr[Index] = AddrList[Index];
+	}
+
+	InstancePtr->NumBuffers = NumBuffers;
+	InstancePtr->Width = Width;
+	InstancePtr->Height = Height;
+	InstancePtr->Stride = Stride;
+
+	InstancePtr->Scanout = 0;
+	InstancePtr->LastStore = 0;
+	InstancePtr->Queued = HDMI_FB_NONE;
+	InstancePtr->Drawing = HDMI_FB_NONE;
+
+	InstancePtr->Handler = StubHandler;
+	InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* Reset the VDMA read channel and start scanning out buffer 0 in park mode
+* with one interrupt per frame.
+*
+* @param	InstancePtr is the instance.
+*
+* @return
+*		- XST_SUCCESS if the channel runs.
+*		- XST_FAILURE if the VDMA did not leave reset.
+*
+* @note		The HDMI core timing and enable are programmed separately.
+*
+******************************************************************************/
+int HdmiFb_Start(HdmiFb *InstancePtr)
+{
+	u32 Base;
+	u32 Index;
+	u32 Timeout = HDMI_FB_RESET_TIMEOUT;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	Base = InstancePtr->Config.VdmaBaseAddr;
+
+	HdmiVdma_WriteReg(Base, HDMI_VDMA_CR_OFFSET, HDMI_VDMA_CR_RESET_MASK);
+	while ((HdmiVdma_ReadReg(Base, HDMI_VDMA_CR_OFFSET) &
+		HDMI_VDMA_CR_RESET_MASK) != 0) {
+		if (--Timeout == 0) {
+			return XST_FAILURE;
+		}
+	}
+
+	HdmiVdma_WriteReg(Base, HDMI_VDMA_CR_OFFSET,
+			  (1 << HDMI_VDMA_CR_IRQ_FRMCNT_SHIFT) |
+			  HDMI_VDMA_CR_FRMCNT_IRQ_MASK |
+			  HDMI_VDMA_CR_ERR_IRQ_MASK |
+			  HDMI_VDMA_CR_RUNSTOP_MASK);
+	HdmiVdma_WriteReg(Base, HDMI_VDMA_PARK_OFFSET, InstancePtr->Scanout);
+
+	for (Index = 0; Index < InstancePtr->NumBuffers; Index++) {
+		HdmiVdma_WriteReg(Base, HDMI_VDMA_ADDR_OFFSET(Index),
+				  InstancePtr->Addr[Index]);
+	}
+	HdmiVdma_WriteReg(Base, HDMI_VDMA_HSIZE_OFFSET,
+			  InstancePtr->Width * HDMI_FB_BYTES_PER_PIXEL);
+	HdmiVdma_WriteReg(Base, HDMI_VDMA_STRIDE_OFFSET, InstancePtr->Stride);
+
+	/* Writing VSIZE starts the channel */
+	HdmiVdma_WriteReg(Base, HDMI_VDMA_VSIZE_OFFSET, InstancePtr->Height);
+
+	InstancePtr->IsStarted = XIL_COMPONENT_IS_STARTED;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* Stop the VDMA read channel.
+*
+* @param	InstancePtr is the instance.
+*
+* @return	None.
+*
+******************************************************************************/
+void HdmiFb_Stop(HdmiFb *InstancePtr)
+{
+	Xil_AssertVoid(InstancePtr != NULL);
+
+	HdmiVdma_WriteReg(InstancePtr->Config.VdmaBaseAddr,
+			  HDMI_VDMA_CR_OFFSET, 0);
+	InstancePtr->IsStarted = 0;
+}
+
+/*****************************************************************************/
+/**
+*
+* Get the buffer the application draws the next frame into. The same buffer
+* is returned until it is flipped.
+*
+* @param	InstancePtr is the instance.
+* @param	IndexPtr returns the buffer index.
+* @param	AddrPtr returns the buffer address, may be NULL.
+*
+* @return
+*		- XST_SUCCESS if a buffer is available.
+*		- XST_DEVICE_BUSY if all buffers are scanned out or queued,
+*		  only possible with two buffers.
+*
+* @note		Do not call from the frame callback.
+*
+******************************************************************************/
+int HdmiFb_GetDrawBuffer(HdmiFb *InstancePtr, u32 *IndexPtr, u32 *AddrPtr)
+{
+	u32 Index;
+	int Status = XST_DEVICE_BUSY;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(IndexPtr != NULL);
+
+	HdmiFb_Lock();
+	if (InstancePtr->Drawing == HDMI_FB_NONE) {
+		for (Index = 0; Index < InstancePtr->NumBuffers; Index++) {
+			if ((Index != InstancePtr->Scanout) &&
+			    (Index != InstancePtr->Queued)) {
+				InstancePtr->Drawing = Index;
+				break;
+			}
+		}
+	}
+	if (InstancePtr->Drawing != HDMI_FB_NONE) {
+		*IndexPtr = InstancePtr->Drawing;
+		if (AddrPtr != NULL) {
+			*AddrPtr = InstancePtr->Addr[InstancePtr->Drawing];
+		}
+		Status = XST_SUCCESS;
+	}
+	HdmiFb_Unlock();
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+*
+* Hand the drawn buffer over for display. It is shown from the next frame
+* sync on. A buffer flipped before and not shown yet is dropped and can be
+* drawn again. If the VDMA has already taken it at a frame sync whose
+* interrupt is still to come, it is on screen and becomes the scan out
+* buffer instead.
+*
+* @param	InstancePtr is the instance.
+* @param	Index is the buffer returned by HdmiFb_GetDrawBuffer.
+*
+* @return
+*		- XST_SUCCESS if the buffer is queued.
+*		- XST_INVALID_PARAM if Index is not the drawing buffer.
+*
+* @note		The data must be in DDR, flush the D-cache over the buffer
+*		before the flip. Do not call from the frame callback.
+*
+******************************************************************************/
+int HdmiFb_Flip(HdmiFb *InstancePtr, u32 Index)
+{
+	u32 Current;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+
+	HdmiFb_Lock();
+	if (Index != InstancePtr->Drawing) {
+		HdmiFb_Unlock();
+		return XST_INVALID_PARAM;
+	}
+
+	HdmiVdma_WriteReg(InstancePtr->Config.VdmaBaseAddr,
+			  HDMI_VDMA_PARK_OFFSET, Index);
+
+	if (InstancePtr->Queued != HDMI_FB_NONE) {
+		/*
+		 * Read after the park write, no later frame sync can take
+		 * the queued buffer. Its frame is counted at its interrupt.
+		 */
+		Current = (HdmiVdma_ReadReg(InstancePtr->Config.VdmaBaseAddr,
+					    HDMI_VDMA_PARK_OFFSET) &
+			   HDMI_VDMA_PARK_STORE_MASK) >>
+			  HDMI_VDMA_PARK_STORE_SHIFT;
+		if (Current == InstancePtr->Queued) {
+			Retire(InstancePtr, InstancePtr->Stats.Frames + 1);
+		} else {
+			InstancePtr->Stats.Dropped++;
+		}
+	}
+	InstancePtr->Queued = Index;
+	InstancePtr->QueuedAt[Index] = InstancePtr->Stats.Frames;
+	InstancePtr->Drawing = HDMI_FB_NONE;
+	InstancePtr->Stats.Flips++;
+	HdmiFb_Unlock();
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* Set the callback called at the end of every frame interrupt.
+*
+* @param	InstancePtr is the instance.
+* @param	FuncPtr is the callback.
+* @param	CallBackRef is passed to the callback.
+*
+* @return	None.
+*
+******************************************************************************/
+void HdmiFb_SetHandler(HdmiFb *InstancePtr, HdmiFb_Handler FuncPtr,
+		       void *CallBackRef)
+{
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(FuncPtr != NULL);
+
+	InstancePtr->Handler = FuncPtr;
+	InstancePtr->CallBackRef = CallBackRef;
+}
+
+/*****************************************************************************/
+/**
+*
+* VDMA read channel interrupt handler, connect it to the mm2s_introut
+* interrupt. Once per frame it retires the previous scan out buffer when the
+* queued one has been shown and collects the HDMI core status.
+*
+* @param	InstancePtr is the instance.
+*
+* @return	None.
+*
+******************************************************************************/
+void HdmiFb_IntrHandler(void *InstancePtr)
+{
+	HdmiFb *FbPtr = (HdmiFb *)InstancePtr;
+	HdmiFb_Stats *StatsPtr;
+	u32 Status;
+	u32 Current;
+
+	Xil_AssertVoid(FbPtr != NULL);
+
+	StatsPtr = &FbPtr->Stats;
+
+	Status = HdmiVdma_ReadReg(FbPtr->Config.VdmaBaseAddr,
+				  HDMI_VDMA_SR_OFFSET);
+	HdmiVdma_WriteReg(FbPtr->Config.VdmaBaseAddr, HDMI_VDMA_SR_OFFSET,
+			  Status & HDMI_VDMA_SR_IRQ_ALL_MASK);
+
+	if ((Status & HDMI_VDMA_SR_ERR_IRQ_MASK) != 0) {
+		StatsPtr->VdmaErrors++;
+	}
+	if ((Status & HDMI_VDMA_SR_FRMCNT_IRQ_MASK) == 0) {
+		return;
+	}
+
+	StatsPtr->Frames++;
+
+	/* The frame store the VDMA has just read */
+	Current = (HdmiVdma_ReadReg(FbPtr->Config.VdmaBaseAddr,
+				    HDMI_VDMA_PARK_OFFSET) &
+		   HDMI_VDMA_PARK_STORE_MASK) >> HDMI_VDMA_PARK_STORE_SHIFT;
+
+	if ((FbPtr->Queued != HDMI_FB_NONE) && (Current == FbPtr->Queued)) {
+		Retire(FbPtr, StatsPtr->Frames);
+	}
+	if (Current == FbPtr->LastStore) {
+		StatsPtr->Repeated++;
+	}
+	FbPtr->LastStore = Current;
+
+	Status = HdmiTx_ReadReg(FbPtr->Config.HdmiBaseAddr,
+				HDMI_TX_STATUS_OFFSET);
+	if (Status != 0) {
+		HdmiTx_WriteReg(FbPtr->Config.HdmiBaseAddr,
+				HDMI_TX_STATUS_OFFSET,
+				Status & HDMI_TX_STATUS_ALL_MASK);
+		if ((Status & HDMI_TX_STATUS_VDMA_UNF_MASK) != 0) {
+			StatsPtr->Underflows++;
+		}
+		if ((Status & HDMI_TX_STATUS_VDMA_OVF_MASK) != 0) {
+			StatsPtr->Overflows++;
+		}
+		if ((Status & HDMI_TX_STATUS_VDMA_BE_ERROR_MASK) != 0) {
+			StatsPtr->BeErrors++;
+		}
+		if ((Status & (HDMI_TX_STATUS_HDMI_TPM_OOS_MASK |
+			       HDMI_TX_STATUS_VDMA_TPM_OOS_MASK)) != 0) {
+			StatsPtr->TpmOos++;
+		}
+	}
+
+	FbPtr->Handler(FbPtr->CallBackRef, FbPtr->Scanout);
+}
+
+/*****************************************************************************/
+/**
+*
+* Copy the statistics.
+*
+* @param	InstancePtr is the instance.
+* @param	StatsPtr receives the statistics.
+*
+* @return	None.
+*
+******************************************************************************/
+void HdmiFb_GetStats(HdmiFb *InstancePtr, HdmiFb_Stats *StatsPtr)
+{
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(StatsPtr != NULL);
+
+	HdmiFb_Lock();
+	*StatsPtr = InstancePtr->Stats;
+	HdmiFb_Unlock();
+}
+
+/*****************************************************************************/
+/**
+*
+* Clear the statistics.
+*
+* @param	InstancePtr is the instance.
+*
+* @return	None.
+*
+******************************************************************************/
+void HdmiFb_ResetStats(HdmiFb *InstancePtr)
+{
+	Xil_AssertVoid(InstancePtr != NULL);
+
+	HdmiFb_Lock();
+	memset(&InstancePtr->Stats, 0, sizeof(HdmiFb_Stats));
+	HdmiFb_Unlock();
+}
+
+/*****************************************************************************/
+/*
+* The queued buffer is on screen: make it the scan out buffer, which frees
+* the previous one, and record the flip to display latency. Frames is the
+* frame count at the end of its first frame. Called with the IRQ masked.
+*
+******************************************************************************/
+static void Retire(HdmiFb *InstancePtr, u32 Frames)
+{
+	HdmiFb_Stats *StatsPtr = &InstancePtr->Stats;
+	u32 Latency;
+
+	Latency = Frames - InstancePtr->QueuedAt[InstancePtr->Queued];
+	InstancePtr->Scanout = InstancePtr->Queued;
+	InstancePtr->Queued = HDMI_FB_NONE;
+
+	StatsPtr->Displayed++;
+	StatsPtr->LastLatency = Latency;
+	StatsPtr->TotalLatency += Latency;
+	if (Latency > StatsPtr->MaxLatency) {
+		StatsPtr->MaxLatency = Latency;
+	}
+}
+
+/*****************************************************************************/
+/*
+* Default callback, does nothing.
+*
+******************************************************************************/
+static void StubHandler(void *CallBackRef, u32 Index)
+{
+	(void)CallBackRef;
+	(void)Index;
+}
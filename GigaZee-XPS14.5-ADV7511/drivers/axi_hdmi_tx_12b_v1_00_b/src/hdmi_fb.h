@@ -0,0 +1,172 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file hdmi_fb.h
+*
+* Frame buffer manager for the axi_vdma -> axi_hdmi_tx_12b video path.
+*
+* The manager owns 2 to HDMI_FB_MAX_BUFFERS frame buffers in DDR and runs
+* the VDMA read channel in park mode. The application draws into the buffer
+* returned by HdmiFb_GetDrawBuffer and hands it over with HdmiFb_Flip, which
+* moves the VDMA park pointer. The VDMA samples the park pointer at the
+* frame sync from the HDMI core, so a flip always takes effect on a frame
+* boundary and never tears.
+*
+* HdmiFb_IntrHandler runs on the VDMA frame count interrupt (mm2s_introut,
+* one interrupt per frame). It reads back the frame the VDMA has finished,
+* retires the previous scan out buffer once the flipped buffer has been
+* shown, and collects the statistics:
+*
+*   - frames, flips, displayed, dropped (flipped buffer replaced by a newer
+*     one before it was shown) and repeated frames (same frame store as the
+*     frame before),
+*   - flip to display latency in frames, last, maximum and total,
+*   - underflow, overflow, byte enable and TPM out of sync events from the
+*     HDMI core status register, and VDMA errors.
+*
+* With three buffers the application never waits: one is scanned out, one
+* may be queued and the third is drawn. With two buffers
+* HdmiFb_GetDrawBuffer returns XST_DEVICE_BUSY while a flip is pending.
+*
+* All register access goes through Xil_In32/Xil_Out32, so the manager can
+* be linked on a host against a register level model of the two cores.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* 1.01a te   10/16/26 Added LastStore
+* </pre>
+*
+******************************************************************************/
+
+#ifndef HDMI_FB_H /* prevent circular inclusions */
+#define HDMI_FB_H /* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************** Constant Definitions ****************************/
+
+#define HDMI_FB_MAX_BUFFERS	4	/**< Buffers managed at most */
+#define HDMI_FB_NONE		0xFF	/**< No buffer */
+
+/*
+ * Default configuration of the GigaZee-XPS14.5-ADV7511 design, the VDMA
+ * is built with the default C_NUM_FSTORES of 3.
+ */
+#define HDMI_FB_VDMA_BASEADDR	0x43000000
+#define HDMI_FB_HDMI_BASEADDR	0x6C000000
+#define HDMI_FB_NUM_FSTORES	3
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Hardware configuration
+ */
+typedef struct {
+	u32 VdmaBaseAddr;	/**< axi_vdma register base */
+	u32 HdmiBaseAddr;	/**< axi_hdmi_tx_12b register base */
+	u32 NumFrameStores;	/**< VDMA C_NUM_FSTORES */
+} HdmiFb_Config;
+
+/**
+ * Statistics, see HdmiFb_GetStats
+ */
+typedef struct {
+	u32 Frames;		/**< Frame interrupts */
+	u32 Flips;		/**< Buffers handed over */
+	u32 Displayed;		/**< Flipped buffers shown */
+	u32 Dropped;		/**< Flipped buffers never shown */
+	u32 Repeated;		/**< Frames without a new buffer */
+	u32 LastLatency;	/**< Flip to display, frames */
+	u32 MaxLatency;		/**< Maximum flip to display */
+	u32 TotalLatency;	/**< Sum over Displayed */
+	u32 Underflows;		/**< HDMI status vdma_unf */
+	u32 Overflows;		/**< HDMI status vdma_ovf */
+	u32 BeErrors;		/**< HDMI status vdma_be_error */
+	u32 TpmOos;		/**< HDMI status hdmi/vdma_tpm_oos */
+	u32 VdmaErrors;		/**< VDMA error interrupts */
+} HdmiFb_Stats;
+
+/**
+ * Callback on every frame interrupt, Index is the buffer scanned out.
+ */
+typedef void (*HdmiFb_Handler)(void *CallBackRef, u32 Index);
+
+/**
+ * Frame buffer manager instance
+ */
+typedef struct {
+	HdmiFb_Config Config;
+	u32 IsReady;
+	u32 IsStarted;
+
+	u32 NumBuffers;
+	u32 Addr[HDMI_FB_MAX_BUFFERS];
+	u32 QueuedAt[HDMI_FB_MAX_BUFFERS];	/**< Stats.Frames at flip */
+	u32 Width;				/**< Pixels per line */
+	u32 Height;				/**< Lines */
+	u32 Stride;				/**< Line stride in bytes */
+
+	volatile u32 Scanout;		/**< Buffer being displayed */
+	u32 LastStore;			/**< Frame store of the last frame */
+	volatile u32 Queued;		/**< Buffer flipped, not shown yet */
+	volatile u32 Drawing;		/**< Buffer owned by the application */
+
+	HdmiFb_Stats Stats;
+	HdmiFb_Handler Handler;
+	void *CallBackRef;
+} HdmiFb;
+
+/************************** Function Prototypes *****************************/
+
+int HdmiFb_CfgInitialize(HdmiFb *InstancePtr, const HdmiFb_Config *ConfigPtr,
+			 const u32 *AddrList, u32 NumBuffers, u32 Width,
+			 u32 Height, u32 Stride);
+int HdmiFb_Start(HdmiFb *InstancePtr);
+void HdmiFb_Stop(HdmiFb *InstancePtr);
+int HdmiFb_GetDrawBuffer(HdmiFb *InstancePtr, u32 *IndexPtr, u32 *AddrPtr);
+int HdmiFb_Flip(HdmiFb *InstancePtr, u32 Index);
+void HdmiFb_SetHandler(HdmiFb *InstancePtr, HdmiFb_Handler FuncPtr,
+		       void *CallBackRef);
+void HdmiFb_IntrHandler(void *InstancePtr);
+void HdmiFb_GetStats(HdmiFb *InstancePtr, HdmiFb_Stats *StatsPtr);
+void HdmiFb_ResetStats(HdmiFb *InstancePtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HDMI_FB_H */
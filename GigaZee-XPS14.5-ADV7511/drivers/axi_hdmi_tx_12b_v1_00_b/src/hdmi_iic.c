@@ -0,0 +1,379 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file hdmi_iic.c
+*
+* Polled I2C master on the AXI IIC dynamic controller. See hdmi_iic.h for
+* the description.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "hdmi_iic.h"
+#include "hdmi_iic_l.h"
+#include "xil_assert.h"
+
+/************************** Constant Definitions ****************************/
+
+/*
+ * Polls without progress before a transfer is given up, one byte takes
+ * 90 us at 100 kHz
+ */
+#define HDMI_IIC_TIMEOUT	100000
+
+#define HDMI_IIC_ERROR_MASK	(HDMI_IIC_INTR_TX_ERROR_MASK | \
+				 HDMI_IIC_INTR_ARB_LOST_MASK)
+
+/************************** Function Prototypes *****************************/
+
+static void ClearErrors(HdmiIic *InstancePtr);
+static int PushTx(HdmiIic *InstancePtr, u32 Entry);
+static int QueueWrite(HdmiIic *InstancePtr, u8 Addr, u8 Reg,
+		      const u8 *BufPtr, u32 Len);
+static int WaitIdle(HdmiIic *InstancePtr);
+static int Abort(HdmiIic *InstancePtr);
+
+/*****************************************************************************/
+/**
+*
+* Reset the AXI IIC and enable the dynamic controller.
+*
+* @param	InstancePtr is the instance to initialize.
+* @param	BaseAddress is the register base of the AXI IIC.
+*
+* @return	XST_SUCCESS.
+*
+* @note		Interrupts of the core stay disabled, the driver polls.
+*
+******************************************************************************/
+int HdmiIic_Initialize(HdmiIic *InstancePtr, u32 BaseAddress)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+
+	InstancePtr->BaseAddress = BaseAddress;
+	InstancePtr->Transfers = 0;
+	InstancePtr->Bytes = 0;
+
+	HdmiIic_WriteReg(BaseAddress, HDMI_IIC_SOFTR_OFFSET,
+			 HDMI_IIC_SOFTR_KEY);
+	HdmiIic_WriteReg(BaseAddress, HDMI_IIC_GIE_OFFSET, 0);
+	HdmiIic_WriteReg(BaseAddress, HDMI_IIC_RX_PIRQ_OFFSET,
+			 HDMI_IIC_FIFO_DEPTH - 1);
+	HdmiIic_WriteReg(BaseAddress, HDMI_IIC_CR_OFFSET,
+			 HDMI_IIC_CR_TX_FIFO_RESET_MASK |
+			 HDMI_IIC_CR_ENABLE_MASK);
+	HdmiIic_WriteReg(BaseAddress, HDMI_IIC_CR_OFFSET,
+			 HDMI_IIC_CR_ENABLE_MASK);
+
+	InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* Write registers of a device with one auto incrementing transfer.
+*
+* @param	InstancePtr is the instance.
+* @param	Addr is the 7 bit device address.
+* @param	Reg is the first register.
+* @param	BufPtr holds the register values.
+* @param	Len is the number of registers, 0 writes the register
+*		address only.
+*
+* @return
+*		- XST_SUCCESS if the device acknowledged all bytes.
+*		- XST_FAILURE on no acknowledge, lost arbitration or timeout.
+*
+******************************************************************************/
+int HdmiIic_Write(HdmiIic *InstancePtr, u8 Addr, u8 Reg, const u8 *BufPtr,
+		  u32 Len)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+	Xil_AssertNonvoid((BufPtr != NULL) || (Len == 0));
+
+	ClearErrors(InstancePtr);
+
+	if (QueueWrite(InstancePtr, Addr, Reg, BufPtr, Len) != XST_SUCCESS) {
+		return Abort(InstancePtr);
+	}
+
+	return WaitIdle(InstancePtr);
+}
+
+/*****************************************************************************/
+/**
+*
+* Read registers of a device: the register address is written, a repeated
+* START follows and the data is read with auto increment.
+*
+* @param	InstancePtr is the instance.
+* @param	Addr is the 7 bit device address.
+* @param	Reg is the first register.
+* @param	BufPtr receives the register values.
+* @param	Len is the number of registers, 1 to HDMI_IIC_MAX_READ.
+*
+* @return
+*		- XST_SUCCESS if all bytes were received.
+*		- XST_INVALID_PARAM if Len is out of range.
+*		- XST_FAILURE on no acknowledge, lost arbitration or timeout.
+*
+******************************************************************************/
+int HdmiIic_Read(HdmiIic *InstancePtr, u8 Addr, u8 Reg, u8 *BufPtr,
+		 u32 Len)
+{
+	u32 Base;
+	u32 Count = 0;
+	u32 Timeout = HDMI_IIC_TIMEOUT;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+	Xil_AssertNonvoid(BufPtr != NULL);
+
+	if ((Len == 0) || (Len > HDMI_IIC_MAX_READ)) {
+		return XST_INVALID_PARAM;
+	}
+
+	Base = InstancePtr->BaseAddress;
+	ClearErrors(InstancePtr);
+
+	if ((PushTx(InstancePtr, HDMI_IIC_TX_START_MASK | (Addr << 1)) !=
+	     XST_SUCCESS) ||
+	    (PushTx(InstancePtr, Reg) != XST_SUCCESS) ||
+	    (PushTx(InstancePtr, HDMI_IIC_TX_START_MASK | (Addr << 1) |
+		    HDMI_IIC_TX_READ_MASK) != XST_SUCCESS) ||
+	    (PushTx(InstancePtr, HDMI_IIC_TX_STOP_MASK | Len) !=
+	     XST_SUCCESS)) {
+		return Abort(InstancePtr);
+	}
+	InstancePtr->Transfers++;
+	InstancePtr->Bytes += 3 + Len;
+
+	while (Count < Len) {
+		if ((HdmiIic_ReadReg(Base, HDMI_IIC_SR_OFFSET) &
+		     HDMI_IIC_SR_RX_EMPTY_MASK) == 0) {
+			BufPtr[Count++] = (u8)HdmiIic_ReadReg(Base,
+						HDMI_IIC_RX_FIFO_OFFSET);
+			Timeout = HDMI_IIC_TIMEOUT;
+			continue;
+		}
+		if (((HdmiIic_ReadReg(Base, HDMI_IIC_ISR_OFFSET) &
+		      HDMI_IIC_ERROR_MASK) != 0) || (--Timeout == 0)) {
+			return Abort(InstancePtr);
+		}
+	}
+
+	return WaitIdle(InstancePtr);
+}
+
+/*****************************************************************************/
+/**
+*
+* Write a register table to a device. Entries with consecutive register
+* addresses are merged into one transfer, and all transfers are queued
+* without waiting for the bus in between.
+*
+* @param	InstancePtr is the instance.
+* @param	Addr is the 7 bit device address.
+* @param	TablePtr is the table, written in order.
+* @param	Num is the number of entries.
+*
+* @return
+*		- XST_SUCCESS if the device acknowledged all bytes.
+*		- XST_FAILURE on no acknowledge, lost arbitration or timeout.
+*
+* @note		Sort tables by register where the order does not matter,
+*		so that more entries merge.
+*
+******************************************************************************/
+int HdmiIic_WriteTable(HdmiIic *InstancePtr, u8 Addr,
+		       const HdmiIic_RegVal *TablePtr, u32 Num)
+{
+	u8 Buf[HDMI_IIC_FIFO_DEPTH * 4];
+	u32 Index = 0;
+	u32 Run;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+	Xil_AssertNonvoid((TablePtr != NULL) || (Num == 0));
+
+	ClearErrors(InstancePtr);
+
+	while (Index < Num) {
+		Buf[0] = TablePtr[Index].Value;
+		for (Run = 1; (Index + Run < Num) && (Run < sizeof(Buf));
+		     Run++) {
+			if (TablePtr[Index + Run].Reg !=
+			    (u8)(TablePtr[Index].Reg + Run)) {
+				break;
+			}
+			Buf[Run] = TablePtr[Index + Run].Value;
+		}
+
+		if (QueueWrite(InstancePtr, Addr, TablePtr[Index].Reg, Buf,
+			       Run) != XST_SUCCESS) {
+			return Abort(InstancePtr);
+		}
+		if ((HdmiIic_ReadReg(InstancePtr->BaseAddress,
+				     HDMI_IIC_ISR_OFFSET) &
+		     HDMI_IIC_ERROR_MASK) != 0) {
+			return Abort(InstancePtr);
+		}
+		Index += Run;
+	}
+
+	return WaitIdle(InstancePtr);
+}
+
+/*****************************************************************************/
+/*
+* Clear pending error interrupts, the interrupt status toggles on write.
+*
+******************************************************************************/
+static void ClearErrors(HdmiIic *InstancePtr)
+{
+	u32 Status;
+
+	Status = HdmiIic_ReadReg(InstancePtr->BaseAddress,
+				 HDMI_IIC_ISR_OFFSET) & HDMI_IIC_ERROR_MASK;
+	if (Status != 0) {
+		HdmiIic_WriteReg(InstancePtr->BaseAddress,
+				 HDMI_IIC_ISR_OFFSET, Status);
+	}
+}
+
+/*****************************************************************************/
+/*
+* Write one entry to the TX FIFO, waiting while it is full.
+*
+******************************************************************************/
+static int PushTx(HdmiIic *InstancePtr, u32 Entry)
+{
+	u32 Timeout = HDMI_IIC_TIMEOUT;
+
+	while ((HdmiIic_ReadReg(InstancePtr->BaseAddress,
+				HDMI_IIC_SR_OFFSET) &
+		HDMI_IIC_SR_TX_FULL_MASK) != 0) {
+		if (--Timeout == 0) {
+			return XST_FAILURE;
+		}
+	}
+
+	HdmiIic_WriteReg(InstancePtr->BaseAddress, HDMI_IIC_TX_FIFO_OFFSET,
+			 Entry);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/*
+* Queue a write transfer without waiting for its end.
+*
+******************************************************************************/
+static int QueueWrite(HdmiIic *InstancePtr, u8 Addr, u8 Reg,
+		      const u8 *BufPtr, u32 Len)
+{
+	u32 Index;
+	u32 Entry;
+
+	if (PushTx(InstancePtr, HDMI_IIC_TX_START_MASK | (Addr << 1)) !=
+	    XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Entry = Reg;
+	for (Index = 0; Index < Len; Index++) {
+		if (PushTx(InstancePtr, Entry) != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		Entry = BufPtr[Index];
+	}
+	if (PushTx(InstancePtr, Entry | HDMI_IIC_TX_STOP_MASK) !=
+	    XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	InstancePtr->Transfers++;
+	InstancePtr->Bytes += 2 + Len;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/*
+* Wait until the TX FIFO is drained and the STOP is on the bus, then check
+* for errors.
+*
+******************************************************************************/
+static int WaitIdle(HdmiIic *InstancePtr)
+{
+	u32 Base = InstancePtr->BaseAddress;
+	u32 Timeout = HDMI_IIC_TIMEOUT * HDMI_IIC_FIFO_DEPTH;
+
+	while ((HdmiIic_ReadReg(Base, HDMI_IIC_SR_OFFSET) &
+		(HDMI_IIC_SR_TX_EMPTY_MASK | HDMI_IIC_SR_BB_MASK)) !=
+	       HDMI_IIC_SR_TX_EMPTY_MASK) {
+		if (((HdmiIic_ReadReg(Base, HDMI_IIC_ISR_OFFSET) &
+		      HDMI_IIC_ERROR_MASK) != 0) || (--Timeout == 0)) {
+			return Abort(InstancePtr);
+		}
+	}
+
+	if ((HdmiIic_ReadReg(Base, HDMI_IIC_ISR_OFFSET) &
+	     HDMI_IIC_ERROR_MASK) != 0) {
+		return Abort(InstancePtr);
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/*
+* Drop what is left of a failed transfer.
+*
+******************************************************************************/
+static int Abort(HdmiIic *InstancePtr)
+{
+	HdmiIic_WriteReg(InstancePtr->BaseAddress, HDMI_IIC_CR_OFFSET,
+			 HDMI_IIC_CR_TX_FIFO_RESET_MASK |
+			 HDMI_IIC_CR_ENABLE_MASK);
+	HdmiIic_WriteReg(InstancePtr->BaseAddress, HDMI_IIC_CR_OFFSET,
+			 HDMI_IIC_CR_ENABLE_MASK);
+	ClearErrors(InstancePtr);
+
+	return XST_FAILURE;
+}
@@ -0,0 +1,98 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file hdmi_iic.h
+*
+* Polled I2C master on the AXI IIC dynamic controller for the ADV7511.
+*
+* HdmiIic_WriteTable sends a register table as few transfers as possible:
+* runs of consecutive registers become one auto incrementing transfer, and
+* all transfers are queued back to back into the TX FIFO, waiting only when
+* the FIFO is full. The bus never idles between transfers and the CPU does
+* not wait for every byte, which is what makes the ADV7511 set up fast.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef HDMI_IIC_H /* prevent circular inclusions */
+#define HDMI_IIC_H /* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************** Constant Definitions ****************************/
+
+#define HDMI_IIC_BASEADDR	0x41600000	/**< axi_iic_0 */
+#define HDMI_IIC_MAX_READ	255		/**< Bytes per read transfer */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * One entry of a register table
+ */
+typedef struct {
+	u8 Reg;
+	u8 Value;
+} HdmiIic_RegVal;
+
+/**
+ * Driver instance
+ */
+typedef struct {
+	u32 BaseAddress;
+	u32 IsReady;
+	u32 Transfers;		/**< Transfers started */
+	u32 Bytes;		/**< Bytes on the bus, addresses included */
+} HdmiIic;
+
+/************************** Function Prototypes *****************************/
+
+int HdmiIic_Initialize(HdmiIic *InstancePtr, u32 BaseAddress);
+int HdmiIic_Write(HdmiIic *InstancePtr, u8 Addr, u8 Reg, const u8 *BufPtr,
+		  u32 Len);
+int HdmiIic_Read(HdmiIic *InstancePtr, u8 Addr, u8 Reg, u8 *BufPtr,
+		 u32 Len);
+int HdmiIic_WriteTable(HdmiIic *InstancePtr, u8 Addr,
+		       const HdmiIic_RegVal *TablePtr, u32 Num);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HDMI_IIC_H */
@@ -0,0 +1,121 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file hdmi_iic_l.h
+*
+* This header file contains the register offsets and bit definitions of the
+* AXI IIC v1.02a used as I2C master for the ADV7511, and the low level
+* access macros. Only the dynamic controller logic is used: transfers are
+* described by START and STOP flags written to the TX FIFO together with
+* the address and data bytes.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef HDMI_IIC_L_H /* prevent circular inclusions */
+#define HDMI_IIC_L_H /* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xil_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************** Constant Definitions ****************************/
+
+/** @name Register offsets
+ * @{
+ */
+#define HDMI_IIC_GIE_OFFSET		0x01C	/**< Global interrupt enable */
+#define HDMI_IIC_ISR_OFFSET		0x020	/**< Interrupt status, toggle on write */
+#define HDMI_IIC_IER_OFFSET		0x028	/**< Interrupt enable */
+#define HDMI_IIC_SOFTR_OFFSET		0x040	/**< Soft reset */
+#define HDMI_IIC_CR_OFFSET		0x100	/**< Control */
+#define HDMI_IIC_SR_OFFSET		0x104	/**< Status */
+#define HDMI_IIC_TX_FIFO_OFFSET		0x108	/**< TX FIFO */
+#define HDMI_IIC_RX_FIFO_OFFSET		0x10C	/**< RX FIFO */
+#define HDMI_IIC_TX_OCY_OFFSET		0x114	/**< TX FIFO occupancy - 1 */
+#define HDMI_IIC_RX_OCY_OFFSET		0x118	/**< RX FIFO occupancy - 1 */
+#define HDMI_IIC_RX_PIRQ_OFFSET		0x120	/**< RX FIFO interrupt depth */
+/* @} */
+
+#define HDMI_IIC_SOFTR_KEY		0x0A	/**< Soft reset key */
+#define HDMI_IIC_FIFO_DEPTH		16
+
+/** @name Control register bits
+ * @{
+ */
+#define HDMI_IIC_CR_TX_FIFO_RESET_MASK	0x02	/**< Flush the TX FIFO */
+#define HDMI_IIC_CR_ENABLE_MASK		0x01	/**< Controller enable */
+/* @} */
+
+/** @name Status register bits
+ * @{
+ */
+#define HDMI_IIC_SR_TX_EMPTY_MASK	0x80	/**< TX FIFO empty */
+#define HDMI_IIC_SR_RX_EMPTY_MASK	0x40	/**< RX FIFO empty */
+#define HDMI_IIC_SR_TX_FULL_MASK	0x10	/**< TX FIFO full */
+#define HDMI_IIC_SR_BB_MASK		0x04	/**< Bus busy */
+/* @} */
+
+/** @name Interrupt status bits
+ * @{
+ */
+#define HDMI_IIC_INTR_TX_ERROR_MASK	0x02	/**< No acknowledge */
+#define HDMI_IIC_INTR_ARB_LOST_MASK	0x01	/**< Arbitration lost */
+/* @} */
+
+/** @name Dynamic controller TX FIFO flags
+ * @{
+ */
+#define HDMI_IIC_TX_START_MASK		0x100	/**< START before the byte */
+#define HDMI_IIC_TX_STOP_MASK		0x200	/**< STOP after the byte */
+#define HDMI_IIC_TX_READ_MASK		0x01	/**< R/W bit of the address */
+/* @} */
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define HdmiIic_ReadReg(BaseAddress, RegOffset) \
+	Xil_In32((BaseAddress) + (RegOffset))
+
+#define HdmiIic_WriteReg(BaseAddress, RegOffset, Data) \
+	Xil_Out32((BaseAddress) + (RegOffset), (Data))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HDMI_IIC_L_H */
@@ -0,0 +1,446 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file hdmi_modeset.c
+*
+* EDID driven mode set engine for the ADV7511 HDMI output. See
+* hdmi_modeset.h for the description.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "hdmi_modeset.h"
+#include "hdmi_tx_l.h"
+#include "xil_assert.h"
+
+/************************** Constant Definitions ****************************/
+
+/** @name ADV7511 main map registers
+ * @{
+ */
+#define ADV7511_INPUT_ID	0x15	/**< [3:0] input ID */
+#define ADV7511_INPUT_STYLE	0x16	/**< Depth, style, DDR edge */
+#define ADV7511_SYNC_ASPECT	0x17	/**< Sync invert, aspect */
+#define ADV7511_CSC		0x18	/**< 0x18 to 0x2F coefficients */
+#define ADV7511_POWER		0x41	/**< [6] power down */
+#define ADV7511_STATUS		0x42	/**< [6] HPD */
+#define ADV7511_EDID_ADDR	0x43	/**< EDID memory address */
+#define ADV7511_AVI_1		0x55	/**< [6:5] Y1Y0 */
+#define ADV7511_AVI_2		0x56	/**< [5:4] aspect, [3:0] AFD */
+#define ADV7511_INTR_ENABLE	0x94
+#define ADV7511_INTR_STATUS	0x96	/**< Write 1 to clear */
+#define ADV7511_HDMI_MODE	0xAF	/**< [1] HDMI */
+#define ADV7511_CLOCK_DELAY	0xBA
+/* @} */
+
+#define ADV7511_POWER_UP		0x10
+#define ADV7511_POWER_DOWN		0x50
+#define ADV7511_STATUS_HPD_MASK		0x40
+#define ADV7511_INTR_HPD_MASK		0x80
+#define ADV7511_INTR_MSEN_MASK		0x40
+#define ADV7511_INTR_EDID_MASK		0x04
+
+#define ADV7511_ID_DDR_444		0x05	/* 12 bit DDR, separate syncs */
+#define ADV7511_STYLE_8BIT		0x30
+#define ADV7511_STYLE_1			0x08
+#define ADV7511_STYLE_DDR_RISING	0x02
+#define ADV7511_STYLE_YCBCR		0x01
+#define ADV7511_VSYNC_INVERT		0x40
+#define ADV7511_HSYNC_INVERT		0x20
+#define ADV7511_ASPECT_16_9		0x02
+#define ADV7511_CSC_ENABLE		0x80
+#define ADV7511_CSC_SCALE_4		0x40
+#define ADV7511_AVI_YCBCR444		0x40
+#define ADV7511_AVI_4_3			0x18
+#define ADV7511_AVI_16_9		0x28
+#define ADV7511_MODE_HDMI		0x16
+#define ADV7511_MODE_DVI		0x14
+#define ADV7511_NO_CLOCK_DELAY		0x60
+
+#define ADV7511_CSC_COEFFS		12
+
+/*
+ * EDID ready polls, one poll is a 4 byte I2C read of about 0.4 ms at
+ * 100 kHz. The ADV7511 needs about 25 ms for a two block EDID.
+ */
+#define HDMI_MODESET_EDID_POLLS		500
+
+/*
+ * Power up sequence of the ADV7511, the fixed values are the ones the
+ * programming guide requires after every power up. Sorted by register so
+ * that the I2C batch merges runs.
+ */
+static const HdmiIic_RegVal PowerUpTable[] = {
+	{ ADV7511_POWER, ADV7511_POWER_UP },
+	{ ADV7511_EDID_ADDR, HDMI_ADV7511_EDID_ADDR << 1 },
+	{ ADV7511_INTR_ENABLE, ADV7511_INTR_HPD_MASK |
+			       ADV7511_INTR_MSEN_MASK |
+			       ADV7511_INTR_EDID_MASK },
+	{ 0x95, 0x00 },
+	{ ADV7511_INTR_STATUS, 0xFF },
+	{ 0x97, 0xFF },
+	{ 0x98, 0x03 },
+	{ 0x9A, 0xE0 },
+	{ 0x9C, 0x30 },
+	{ 0x9D, 0x61 },
+	{ 0xA2, 0xA4 },
+	{ 0xA3, 0xA4 },
+	{ 0xE0, 0xD0 },
+	{ 0xF9, 0x00 },
+};
+
+/*
+ * YCbCr (BT.601 limited range, as made by the core CSC) to RGB, 13 bit
+ * coefficients A1..A4, B1..B4, C1..C4 with the scale factor 4
+ */
+static const u16 CscYCbCrToRgb[ADV7511_CSC_COEFFS] = {
+	0x0734, 0x04AD, 0x0000, 0x1C1B,
+	0x1DDC, 0x04AD, 0x1F24, 0x0135,
+	0x0000, 0x04AD, 0x087C, 0x1B77,
+};
+
+#define ARRAY_SIZE(a)		(sizeof(a) / sizeof((a)[0]))
+
+/************************** Function Prototypes *****************************/
+
+static int ReadEdid(HdmiTx_ModeSet *InstancePtr);
+static u32 BuildModeTable(HdmiTx_ModeSet *InstancePtr,
+			  const HdmiTx_Timing *TimingPtr,
+			  HdmiIic_RegVal *TablePtr);
+
+/*****************************************************************************/
+/**
+*
+* Initialize the mode set engine and its I2C master.
+*
+* @param	InstancePtr is the instance to initialize.
+* @param	IicBaseAddr is the register base of the AXI IIC.
+* @param	HdmiBaseAddr is the register base of the axi_hdmi_tx_12b.
+* @param	ClkgenPtr is the initialized axi_clkgen instance.
+*
+* @return	XST_SUCCESS.
+*
+******************************************************************************/
+int HdmiTx_ModeSetInitialize(HdmiTx_ModeSet *InstancePtr, u32 IicBaseAddr,
+			     u32 HdmiBaseAddr, Clkgen *ClkgenPtr)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(ClkgenPtr != NULL);
+
+	memset(InstancePtr, 0, sizeof(HdmiTx_ModeSet));
+	InstancePtr->ClkgenPtr = ClkgenPtr;
+	InstancePtr->HdmiBaseAddr = HdmiBaseAddr;
+	InstancePtr->Edid.Preferred = HDMI_EDID_NONE;
+
+	HdmiIic_Initialize(&InstancePtr->Iic, IicBaseAddr);
+
+	InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* Handle a hot plug event of the ADV7511: bring the output up in the best
+* mode of the connected sink, or power it down if the sink is gone.
+*
+* @param	InstancePtr is the instance.
+*
+* @return
+*		- XST_SUCCESS if a mode is set, see InstancePtr->Timing.
+*		- XST_NO_DATA if no sink is connected.
+*		- XST_FAILURE if the ADV7511 does not respond or the mode
+*		  could not be set.
+*
+* @note		Call it from the task level on the hdmi_int interrupt and
+*		once at start up.
+*
+******************************************************************************/
+int HdmiTx_ModeSetHotplug(HdmiTx_ModeSet *InstancePtr)
+{
+	HdmiIic *IicPtr;
+	HdmiTx_Timing Timing;
+	u32 Index;
+	u8 Value;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	IicPtr = &InstancePtr->Iic;
+
+	if (HdmiIic_Read(IicPtr, HDMI_ADV7511_ADDR, ADV7511_STATUS, &Value,
+			 1) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	if ((Value & ADV7511_STATUS_HPD_MASK) == 0) {
+		HdmiTx_WriteReg(InstancePtr->HdmiBaseAddr,
+				HDMI_TX_CTRL_OFFSET, 0);
+		Value = ADV7511_POWER_DOWN;
+		HdmiIic_Write(IicPtr, HDMI_ADV7511_ADDR, ADV7511_POWER,
+			      &Value, 1);
+		return XST_NO_DATA;
+	}
+
+	if (HdmiIic_WriteTable(IicPtr, HDMI_ADV7511_ADDR, PowerUpTable,
+			       ARRAY_SIZE(PowerUpTable)) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Index = HDMI_EDID_NONE;
+	if ((ReadEdid(InstancePtr) == XST_SUCCESS) &&
+	    (HdmiTx_EdidParse(InstancePtr->EdidData,
+			      sizeof(InstancePtr->EdidData),
+			      &InstancePtr->Edid) == XST_SUCCESS)) {
+		Index = HdmiTx_EdidSelect(&InstancePtr->Edid,
+					  HDMI_MODESET_MAX_PCLK);
+	} else {
+		memset(&InstancePtr->Edid, 0, sizeof(HdmiTx_Edid));
+		InstancePtr->Edid.Preferred = HDMI_EDID_NONE;
+	}
+
+	if (Index != HDMI_EDID_NONE) {
+		Timing = InstancePtr->Edid.Timing[Index];
+	} else {
+		HdmiTx_TimingFromVic(1, &Timing);
+	}
+
+	return HdmiTx_ModeSetApply(InstancePtr, &Timing);
+}
+
+/*****************************************************************************/
+/**
+*
+* Send a timing: pixel clock, HDMI core timing and the ADV7511 registers.
+* The output format follows the last parsed EDID.
+*
+* @param	InstancePtr is the instance.
+* @param	TimingPtr is the timing, progressive.
+*
+* @return
+*		- XST_SUCCESS if the mode is set.
+*		- XST_INVALID_PARAM if the timing is interlaced or the pixel
+*		  clock cannot be made within 0.5%.
+*		- XST_FAILURE if the clock does not lock or the ADV7511
+*		  does not respond.
+*
+******************************************************************************/
+int HdmiTx_ModeSetApply(HdmiTx_ModeSet *InstancePtr,
+			const HdmiTx_Timing *TimingPtr)
+{
+	HdmiIic_RegVal Table[32];
+	u32 Base;
+	u32 Rate;
+	u32 Num;
+	int Status;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+	Xil_AssertNonvoid(TimingPtr != NULL);
+
+	if ((TimingPtr->Flags & HDMI_TIMING_INTERLACED) != 0) {
+		return XST_INVALID_PARAM;
+	}
+
+	Base = InstancePtr->HdmiBaseAddr;
+	HdmiTx_WriteReg(Base, HDMI_TX_CTRL_OFFSET, 0);
+
+	Status = Clkgen_SetRate(InstancePtr->ClkgenPtr,
+				TimingPtr->PixelClkHz);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+	Rate = Clkgen_GetRate(InstancePtr->ClkgenPtr);
+	if ((Rate > TimingPtr->PixelClkHz + TimingPtr->PixelClkHz / 200) ||
+	    (Rate < TimingPtr->PixelClkHz - TimingPtr->PixelClkHz / 200)) {
+		return XST_INVALID_PARAM;
+	}
+
+	HdmiTx_WriteReg(Base, HDMI_TX_HSYNC_1_OFFSET,
+			HdmiTx_SyncReg(TimingPtr->HSync,
+				       TimingPtr->HActive + TimingPtr->HFront +
+				       TimingPtr->HSync + TimingPtr->HBack));
+	HdmiTx_WriteReg(Base, HDMI_TX_HSYNC_2_OFFSET,
+			HdmiTx_SyncReg(TimingPtr->HSync + TimingPtr->HBack,
+				       TimingPtr->HSync + TimingPtr->HBack +
+				       TimingPtr->HActive));
+	HdmiTx_WriteReg(Base, HDMI_TX_VSYNC_1_OFFSET,
+			HdmiTx_SyncReg(TimingPtr->VSync,
+				       TimingPtr->VActive + TimingPtr->VFront +
+				       TimingPtr->VSync + TimingPtr->VBack));
+	HdmiTx_WriteReg(Base, HDMI_TX_VSYNC_2_OFFSET,
+			HdmiTx_SyncReg(TimingPtr->VSync + TimingPtr->VBack,
+				       TimingPtr->VSync + TimingPtr->VBack +
+				       TimingPtr->VActive));
+
+	InstancePtr->IsHdmi = InstancePtr->Edid.IsHdmi;
+	InstancePtr->OutputYCbCr = InstancePtr->Edid.IsHdmi &&
+				   InstancePtr->Edid.YCbCr444;
+
+	Num = BuildModeTable(InstancePtr, TimingPtr, Table);
+	if (HdmiIic_WriteTable(&InstancePtr->Iic, HDMI_ADV7511_ADDR, Table,
+			       Num) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	/* Video output starts on the 0 to 1 edge of enable */
+	HdmiTx_WriteReg(Base, HDMI_TX_CTRL_OFFSET, HDMI_TX_CTRL_ENABLE_MASK);
+
+	InstancePtr->Timing = *TimingPtr;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/*
+* Wait for the ADV7511 to fetch the EDID and read the base block and the
+* first extension block from its EDID memory.
+*
+******************************************************************************/
+static int ReadEdid(HdmiTx_ModeSet *InstancePtr)
+{
+	HdmiIic *IicPtr = &InstancePtr->Iic;
+	u32 Poll;
+	u8 Value = 0;
+
+	memset(InstancePtr->EdidData, 0, sizeof(InstancePtr->EdidData));
+
+	for (Poll = 0; Poll < HDMI_MODESET_EDID_POLLS; Poll++) {
+		if (HdmiIic_Read(IicPtr, HDMI_ADV7511_ADDR,
+				 ADV7511_INTR_STATUS, &Value, 1) !=
+		    XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		if ((Value & ADV7511_INTR_EDID_MASK) != 0) {
+			break;
+		}
+	}
+	if ((Value & ADV7511_INTR_EDID_MASK) == 0) {
+		return XST_FAILURE;
+	}
+
+	Value = ADV7511_INTR_EDID_MASK;
+	HdmiIic_Write(IicPtr, HDMI_ADV7511_ADDR, ADV7511_INTR_STATUS, &Value,
+		      1);
+
+	if (HdmiIic_Read(IicPtr, HDMI_ADV7511_EDID_ADDR, 0,
+			 InstancePtr->EdidData, HDMI_EDID_BLOCK_SIZE) !=
+	    XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	/* Only the first extension, a CEA-861 block in practice */
+	if (InstancePtr->EdidData[HDMI_EDID_BLOCK_SIZE - 2] != 0) {
+		return HdmiIic_Read(IicPtr, HDMI_ADV7511_EDID_ADDR,
+				    HDMI_EDID_BLOCK_SIZE,
+				    InstancePtr->EdidData +
+				    HDMI_EDID_BLOCK_SIZE,
+				    HDMI_EDID_BLOCK_SIZE);
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/*
+* Build the ADV7511 register table of a mode, sorted by register. Returns
+* the number of entries.
+*
+******************************************************************************/
+static u32 BuildModeTable(HdmiTx_ModeSet *InstancePtr,
+			  const HdmiTx_Timing *TimingPtr,
+			  HdmiIic_RegVal *TablePtr)
+{
+	u32 Num = 0;
+	u32 Index;
+	u8 Value;
+
+	TablePtr[Num].Reg = ADV7511_INPUT_ID;
+	TablePtr[Num++].Value = ADV7511_ID_DDR_444;
+
+	TablePtr[Num].Reg = ADV7511_INPUT_STYLE;
+	TablePtr[Num++].Value = ADV7511_STYLE_8BIT | ADV7511_STYLE_1 |
+				ADV7511_STYLE_DDR_RISING |
+				ADV7511_STYLE_YCBCR;
+
+	/* The core drives positive syncs */
+	Value = 0;
+	if ((TimingPtr->Flags & HDMI_TIMING_VSYNC_POS) == 0) {
+		Value |= ADV7511_VSYNC_INVERT;
+	}
+	if ((TimingPtr->Flags & HDMI_TIMING_HSYNC_POS) == 0) {
+		Value |= ADV7511_HSYNC_INVERT;
+	}
+	if ((TimingPtr->Flags & HDMI_TIMING_ASPECT_16_9) != 0) {
+		Value |= ADV7511_ASPECT_16_9;
+	}
+	TablePtr[Num].Reg = ADV7511_SYNC_ASPECT;
+	TablePtr[Num++].Value = Value;
+
+	if (InstancePtr->OutputYCbCr) {
+		TablePtr[Num].Reg = ADV7511_CSC;
+		TablePtr[Num++].Value = 0;
+	} else {
+		for (Index = 0; Index < ADV7511_CSC_COEFFS; Index++) {
+			TablePtr[Num].Reg = ADV7511_CSC + 2 * Index;
+			TablePtr[Num++].Value =
+				(CscYCbCrToRgb[Index] >> 8) & 0x1F;
+			TablePtr[Num].Reg = ADV7511_CSC + 2 * Index + 1;
+			TablePtr[Num++].Value = CscYCbCrToRgb[Index] & 0xFF;
+		}
+		TablePtr[Num - 2 * ADV7511_CSC_COEFFS].Value |=
+			ADV7511_CSC_ENABLE | ADV7511_CSC_SCALE_4;
+	}
+
+	TablePtr[Num].Reg = ADV7511_AVI_1;
+	TablePtr[Num++].Value = InstancePtr->OutputYCbCr ?
+				ADV7511_AVI_YCBCR444 : 0;
+
+	TablePtr[Num].Reg = ADV7511_AVI_2;
+	TablePtr[Num++].Value =
+		(TimingPtr->Flags & HDMI_TIMING_ASPECT_16_9) != 0 ?
+		ADV7511_AVI_16_9 : ADV7511_AVI_4_3;
+
+	TablePtr[Num].Reg = ADV7511_HDMI_MODE;
+	TablePtr[Num++].Value = InstancePtr->IsHdmi ? ADV7511_MODE_HDMI :
+						      ADV7511_MODE_DVI;
+
+	TablePtr[Num].Reg = ADV7511_CLOCK_DELAY;
+	TablePtr[Num++].Value = ADV7511_NO_CLOCK_DELAY;
+
+	return Num;
+}
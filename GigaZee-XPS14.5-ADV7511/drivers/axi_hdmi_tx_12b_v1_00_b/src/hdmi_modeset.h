@@ -0,0 +1,116 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file hdmi_modeset.h
+*
+* EDID driven mode set engine for the ADV7511 HDMI output.
+*
+* On a hot plug HdmiTx_ModeSetHotplug powers the ADV7511 up, waits for the
+* EDID the ADV7511 fetches over DDC, reads it in two block reads, parses it
+* (hdmi_edid.h) and selects the mode. HdmiTx_ModeSetApply then programs
+* the mode in one pass: the pixel clock through axi_clkgen (a memoized
+* table lookup for standard modes, clkgen.h), the sync and DE registers of
+* the axi_hdmi_tx_12b core, and the ADV7511 input format, color space
+* converter, infoframe and HDMI/DVI registers as one batched I2C sequence
+* (hdmi_iic.h). No fixed delays are used, every wait polls a status.
+*
+* The core sends its CSC output, CrYCb 4:4:4, as 12 bit DDR (ADV7511 input
+* ID 5). Sinks that accept YCbCr 4:4:4 get it as it is, DVI sinks and sinks
+* without YCbCr get RGB from the ADV7511 color space converter.
+*
+* Without a valid EDID the output falls back to 640x480p60 DVI, which every
+* sink has to support.
+*
+* The frame buffer geometry follows the selected mode, restart HdmiFb with
+* the new HActive and VActive after a mode set.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef HDMI_MODESET_H /* prevent circular inclusions */
+#define HDMI_MODESET_H /* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xstatus.h"
+#include "hdmi_iic.h"
+#include "hdmi_edid.h"
+#include "clkgen.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************** Constant Definitions ****************************/
+
+#define HDMI_ADV7511_ADDR	0x39	/**< Main map, 7 bit */
+#define HDMI_ADV7511_EDID_ADDR	0x3F	/**< EDID memory, 7 bit */
+
+/*
+ * Fastest pixel clock of the axi_hdmi_tx_12b path
+ */
+#define HDMI_MODESET_MAX_PCLK	148500000
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Mode set engine instance
+ */
+typedef struct {
+	HdmiIic Iic;			/**< I2C master of the ADV7511 */
+	Clkgen *ClkgenPtr;		/**< Pixel clock generator */
+	u32 HdmiBaseAddr;		/**< axi_hdmi_tx_12b registers */
+	u32 IsReady;
+
+	HdmiTx_Edid Edid;		/**< Last parsed EDID */
+	HdmiTx_Timing Timing;		/**< Mode sent */
+	u32 IsHdmi;			/**< HDMI, else DVI */
+	u32 OutputYCbCr;		/**< YCbCr 4:4:4, else RGB */
+
+	u8 EdidData[2 * HDMI_EDID_BLOCK_SIZE];
+} HdmiTx_ModeSet;
+
+/************************** Function Prototypes *****************************/
+
+int HdmiTx_ModeSetInitialize(HdmiTx_ModeSet *InstancePtr, u32 IicBaseAddr,
+			     u32 HdmiBaseAddr, Clkgen *ClkgenPtr);
+int HdmiTx_ModeSetHotplug(HdmiTx_ModeSet *InstancePtr);
+int HdmiTx_ModeSetApply(HdmiTx_ModeSet *InstancePtr,
+			const HdmiTx_Timing *TimingPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HDMI_MODESET_H */
@@ -0,0 +1,435 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file hdmi_pattern.c
+*
+* Test pattern and frame CRC generators for the axi_hdmi_tx_12b video path.
+* See hdmi_pattern.h for the patterns.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "hdmi_pattern.h"
+#include "hdmi_tx_csc.h"
+#include "xil_assert.h"
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define HDMI_PATTERN_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define HDMI_PATTERN_SSE2
+#endif
+
+/************************** Constant Definitions ****************************/
+
+#define CRC32_POLY		0xEDB88320	/* IEEE 802.3, reflected */
+#define NUM_BARS		8
+
+/**************************** Type Definitions ******************************/
+
+/*
+ * Line kernels, a run of one value and a run of the ramp
+ */
+typedef void (*FillFunc)(u32 *DstPtr, u32 Value, u32 Count);
+typedef void (*RampFunc)(u32 *DstPtr, u32 Start, u32 Count);
+
+/************************** Function Prototypes *****************************/
+
+static void FillScalar(u32 *DstPtr, u32 Value, u32 Count);
+static void RampScalar(u32 *DstPtr, u32 Start, u32 Count);
+static void FillVector(u32 *DstPtr, u32 Value, u32 Count);
+static void RampVector(u32 *DstPtr, u32 Start, u32 Count);
+static void PatternLine(u32 Type, u32 Rgb, u32 Width, u32 Line, u32 *DstPtr,
+			FillFunc Fill, RampFunc Ramp);
+static void CrcInit(void);
+
+/************************** Variable Definitions ****************************/
+
+/*
+ * 75% bars: white, yellow, cyan, green, magenta, red, blue, black
+ */
+static const u32 Bars[NUM_BARS] = {
+	0xBFBFBF, 0xBFBF00, 0x00BFBF, 0x00BF00,
+	0xBF00BF, 0xBF0000, 0x0000BF, 0x000000
+};
+
+/* Slice by 4 tables, built on first use */
+static u32 CrcTable[4][256];
+static u32 CrcReady;
+
+/* Line buffers of HdmiTx_PatternOutputCrc */
+static u32 LineBuf[HDMI_PATTERN_MAX_WIDTH];
+static u16 WordBuf[HDMI_PATTERN_MAX_WIDTH];
+
+/*****************************************************************************/
+/**
+*
+* Generate one line of a pattern with the fastest kernel available.
+*
+* @param	Type is HDMI_PATTERN_RAMP, HDMI_PATTERN_SOLID or
+*		HDMI_PATTERN_BARS.
+* @param	Rgb is the color of HDMI_PATTERN_SOLID.
+* @param	Width is the number of active pixels per line.
+* @param	Line is the active line number, the ramp depends on it.
+* @param	DstPtr points to Width pixels.
+*
+* @return	None.
+*
+******************************************************************************/
+void HdmiTx_PatternLine(u32 Type, u32 Rgb, u32 Width, u32 Line, u32 *DstPtr)
+{
+	PatternLine(Type, Rgb, Width, Line, DstPtr, FillVector, RampVector);
+}
+
+/*****************************************************************************/
+/**
+*
+* Portable C version of HdmiTx_PatternLine, the reference of the vector
+* kernels.
+*
+* @param	Type is the pattern.
+* @param	Rgb is the color of HDMI_PATTERN_SOLID.
+* @param	Width is the number of active pixels per line.
+* @param	Line is the active line number.
+* @param	DstPtr points to Width pixels.
+*
+* @return	None.
+*
+******************************************************************************/
+void HdmiTx_PatternLineScalar(u32 Type, u32 Rgb, u32 Width, u32 Line,
+			      u32 *DstPtr)
+{
+	PatternLine(Type, Rgb, Width, Line, DstPtr, FillScalar, RampScalar);
+}
+
+/*****************************************************************************/
+/**
+*
+* Write a pattern into the active area of a frame buffer.
+*
+* @param	Type is the pattern.
+* @param	Rgb is the color of HDMI_PATTERN_SOLID.
+* @param	FramePtr points to the first pixel of the frame buffer.
+* @param	Stride is the line stride in pixels.
+* @param	Width is the number of active pixels per line.
+* @param	Height is the number of active lines.
+*
+* @return	None.
+*
+* @note		The frame buffer is written through the D-cache, flush it
+*		before the VDMA reads it.
+*
+******************************************************************************/
+void HdmiTx_PatternFrame(u32 Type, u32 Rgb, u32 *FramePtr, u32 Stride,
+			 u32 Width, u32 Height)
+{
+	u32 Line;
+
+	Xil_AssertVoid(FramePtr != NULL);
+
+	for (Line = 0; Line < Height; Line++) {
+		HdmiTx_PatternLine(Type, Rgb, Width, Line, FramePtr);
+		FramePtr += Stride;
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* Update a CRC-32 (IEEE 802.3) with a buffer.
+*
+* @param	Crc is 0 for the first buffer, the previous result otherwise.
+* @param	BufPtr points to the data.
+* @param	Len is the number of bytes.
+*
+* @return	The CRC of all data so far.
+*
+******************************************************************************/
+u32 HdmiTx_Crc32(u32 Crc, const u8 *BufPtr, u32 Len)
+{
+	if (!CrcReady) {
+		CrcInit();
+	}
+
+	Crc = ~Crc & 0xFFFFFFFF;
+
+	/* Byte loads, the buffer may have any alignment */
+	for (; Len >= 4; Len -= 4) {
+		Crc ^= (u32)BufPtr[0] | ((u32)BufPtr[1] << 8) |
+		       ((u32)BufPtr[2] << 16) | ((u32)BufPtr[3] << 24);
+		Crc = CrcTable[3][Crc & 0xFF] ^
+		      CrcTable[2][(Crc >> 8) & 0xFF] ^
+		      CrcTable[1][(Crc >> 16) & 0xFF] ^
+		      CrcTable[0][(Crc >> 24) & 0xFF];
+		BufPtr += 4;
+	}
+	for (; Len != 0; Len--) {
+		Crc = CrcTable[0][(Crc ^ *BufPtr++) & 0xFF] ^ (Crc >> 8);
+	}
+
+	return ~Crc & 0xFFFFFFFF;
+}
+
+/*****************************************************************************/
+/**
+*
+* Compute the CRC of the active pixels of a frame buffer, line by line
+* without the stride padding.
+*
+* @param	FramePtr points to the first pixel of the frame buffer.
+* @param	Stride is the line stride in pixels.
+* @param	Width is the number of active pixels per line.
+* @param	Height is the number of active lines.
+*
+* @return	The CRC over Width * Height 32 bit pixels.
+*
+******************************************************************************/
+u32 HdmiTx_PatternFrameCrc(const u32 *FramePtr, u32 Stride, u32 Width,
+			   u32 Height)
+{
+	u32 Crc = 0;
+	u32 Line;
+
+	Xil_AssertNonvoid(FramePtr != NULL);
+
+	for (Line = 0; Line < Height; Line++) {
+		Crc = HdmiTx_Crc32(Crc, (const u8 *)FramePtr, Width * 4);
+		FramePtr += Stride;
+	}
+
+	return Crc;
+}
+
+/*****************************************************************************/
+/**
+*
+* Compute the CRC of the hdmi_data words the core outputs over the active
+* area of a frame showing a pattern, in the steady state of a pattern shown
+* frame after frame.
+*
+* @param	Type is the pattern.
+* @param	Rgb is the color of HDMI_PATTERN_SOLID.
+* @param	Width is the number of active pixels per line, at most
+*		HDMI_PATTERN_MAX_WIDTH.
+* @param	Height is the number of active lines.
+* @param	CscBypass is the csc_bypass control bit.
+* @param	CrCbInit is the crcb_init control bit.
+*
+* @return	The CRC over Width * Height 16 bit words.
+*
+* @note		The tpg_enable output is HDMI_PATTERN_RAMP, the cp_enable
+*		output is HDMI_PATTERN_SOLID with cp_value.
+*
+******************************************************************************/
+u32 HdmiTx_PatternOutputCrc(u32 Type, u32 Rgb, u32 Width, u32 Height,
+			    u32 CscBypass, u32 CrCbInit)
+{
+	HdmiTx_Model Model;
+	u32 Crc = 0;
+	u32 Line;
+
+	Xil_AssertNonvoid(Width <= HDMI_PATTERN_MAX_WIDTH);
+
+	if ((Width == 0) || (Height == 0)) {
+		return 0;
+	}
+
+	/* The sub sampler holds the last pixel of the previous frame */
+	HdmiTx_ModelInit(&Model, CscBypass, CrCbInit);
+	HdmiTx_PatternLine(Type, Rgb, Width, Height - 1, LineBuf);
+	Model.LastPixel = HdmiTx_CscPixel(LineBuf[Width - 1]);
+
+	for (Line = 0; Line < Height; Line++) {
+		HdmiTx_PatternLine(Type, Rgb, Width, Line, LineBuf);
+		HdmiTx_ModelLine(&Model, LineBuf, WordBuf, Width);
+		Crc = HdmiTx_Crc32(Crc, (const u8 *)WordBuf, Width * 2);
+	}
+
+	return Crc;
+}
+
+/*****************************************************************************/
+/*
+* Build a line from fill and ramp runs.
+*
+******************************************************************************/
+static void PatternLine(u32 Type, u32 Rgb, u32 Width, u32 Line, u32 *DstPtr,
+			FillFunc Fill, RampFunc Ramp)
+{
+	u32 Bar;
+	u32 Start, End;
+
+	switch (Type) {
+	case HDMI_PATTERN_RAMP:
+		Ramp(DstPtr, Line * Width, Width);
+		break;
+	case HDMI_PATTERN_BARS:
+		for (Bar = 0, Start = 0; Bar < NUM_BARS; Bar++, Start = End) {
+			End = (Bar + 1) * Width / NUM_BARS;
+			Fill(DstPtr + Start, Bars[Bar], End - Start);
+		}
+		break;
+	default:
+		Fill(DstPtr, Rgb & HDMI_PATTERN_RAMP_MASK, Width);
+		break;
+	}
+}
+
+static void FillScalar(u32 *DstPtr, u32 Value, u32 Count)
+{
+	while (Count-- != 0) {
+		*DstPtr++ = Value;
+	}
+}
+
+static void RampScalar(u32 *DstPtr, u32 Start, u32 Count)
+{
+	while (Count-- != 0) {
+		*DstPtr++ = Start++ & HDMI_PATTERN_RAMP_MASK;
+	}
+}
+
+#ifdef HDMI_PATTERN_NEON
+/*****************************************************************************/
+/*
+* NEON kernels, 8 pixels per step with two quad word stores.
+*
+******************************************************************************/
+static void FillVector(u32 *DstPtr, u32 Value, u32 Count)
+{
+	uint32x4_t V = vdupq_n_u32(Value);
+
+	for (; Count >= 8; Count -= 8) {
+		vst1q_u32((uint32_t *)DstPtr, V);
+		vst1q_u32((uint32_t *)DstPtr + 4, V);
+		DstPtr += 8;
+	}
+	FillScalar(DstPtr, Value, Count);
+}
+
+static void RampVector(u32 *DstPtr, u32 Start, u32 Count)
+{
+	static const uint32_t Lanes[4] = { 0, 1, 2, 3 };
+	const uint32x4_t Mask = vdupq_n_u32(HDMI_PATTERN_RAMP_MASK);
+	const uint32x4_t Four = vdupq_n_u32(4);
+	uint32x4_t V = vaddq_u32(vdupq_n_u32(Start), vld1q_u32(Lanes));
+
+	for (; Count >= 8; Count -= 8) {
+		vst1q_u32((uint32_t *)DstPtr, vandq_u32(V, Mask));
+		V = vaddq_u32(V, Four);
+		vst1q_u32((uint32_t *)DstPtr + 4, vandq_u32(V, Mask));
+		V = vaddq_u32(V, Four);
+		DstPtr += 8;
+		Start += 8;
+	}
+	RampScalar(DstPtr, Start, Count);
+}
+#elif defined(HDMI_PATTERN_SSE2)
+/*****************************************************************************/
+/*
+* SSE2 kernels, 8 pixels per step with two unaligned stores.
+*
+******************************************************************************/
+static void FillVector(u32 *DstPtr, u32 Value, u32 Count)
+{
+	const __m128i V = _mm_set1_epi32((int)Value);
+
+	for (; Count >= 8; Count -= 8) {
+		_mm_storeu_si128((__m128i *)DstPtr, V);
+		_mm_storeu_si128((__m128i *)(DstPtr + 4), V);
+		DstPtr += 8;
+	}
+	FillScalar(DstPtr, Value, Count);
+}
+
+static void RampVector(u32 *DstPtr, u32 Start, u32 Count)
+{
+	const __m128i Mask = _mm_set1_epi32(HDMI_PATTERN_RAMP_MASK);
+	const __m128i Four = _mm_set1_epi32(4);
+	__m128i V = _mm_add_epi32(_mm_set1_epi32((int)Start),
+				  _mm_setr_epi32(0, 1, 2, 3));
+
+	for (; Count >= 8; Count -= 8) {
+		_mm_storeu_si128((__m128i *)DstPtr, _mm_and_si128(V, Mask));
+		V = _mm_add_epi32(V, Four);
+		_mm_storeu_si128((__m128i *)(DstPtr + 4),
+				 _mm_and_si128(V, Mask));
+		V = _mm_add_epi32(V, Four);
+		DstPtr += 8;
+		Start += 8;
+	}
+	RampScalar(DstPtr, Start, Count);
+}
+#else
+static void FillVector(u32 *DstPtr, u32 Value, u32 Count)
+{
+	FillScalar(DstPtr, Value, Count);
+}
+
+static void RampVector(u32 *DstPtr, u32 Start, u32 Count)
+{
+	RampScalar(DstPtr, Start, Count);
+}
+#endif
+
+/*****************************************************************************/
+/*
+* Build the slice by 4 tables: table k advances a byte through k more zero
+* bytes.
+*
+******************************************************************************/
+static void CrcInit(void)
+{
+	u32 Index;
+	u32 Bit;
+	u32 Crc;
+
+	for (Index = 0; Index < 256; Index++) {
+		Crc = Index;
+		for (Bit = 0; Bit < 8; Bit++) {
+			Crc = (Crc & 1) ? (Crc >> 1) ^ CRC32_POLY : Crc >> 1;
+		}
+		CrcTable[0][Index] = Crc;
+	}
+	for (Index = 0; Index < 256; Index++) {
+		for (Bit = 1; Bit < 4; Bit++) {
+			Crc = CrcTable[Bit - 1][Index];
+			CrcTable[Bit][Index] = (Crc >> 8) ^
+					       CrcTable[0][Crc & 0xFF];
+		}
+	}
+	CrcReady = 1;
+}
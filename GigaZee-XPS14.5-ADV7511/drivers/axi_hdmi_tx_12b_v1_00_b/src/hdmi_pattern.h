@@ -0,0 +1,105 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file hdmi_pattern.h
+*
+* Test pattern and frame CRC generators for the axi_hdmi_tx_12b video path.
+*
+* The patterns are lines of 32 bit frame buffer pixels, {R, G, B} in bits
+* [23:0]:
+*
+*   - HDMI_PATTERN_RAMP: pixel n of the active frame, counted row by row,
+*     is n modulo 2^24. This is the sequence the test pattern monitors of
+*     the core (TPM, cf_vdma.v and cf_hdmi.v) expect from the VDMA, and the
+*     sequence the test pattern generator (tpg_enable) outputs.
+*   - HDMI_PATTERN_SOLID: one RGB value, as the color pattern (cp_enable)
+*     outputs it.
+*   - HDMI_PATTERN_BARS: eight 75% color bars.
+*
+* HdmiTx_PatternFrame writes a pattern into a frame buffer,
+* HdmiTx_PatternFrameCrc computes the CRC of the active pixels of a frame
+* buffer and HdmiTx_PatternOutputCrc the CRC of the hdmi_data words the core
+* outputs for a pattern, through the bit exact model in hdmi_tx_csc.h. The
+* CRC is the CRC-32 of IEEE 802.3 over the little endian bytes of the
+* pixels or words.
+*
+* HdmiTx_PatternLine uses NEON or SSE2 when the compiler targets them and
+* the portable C kernel otherwise, all kernels give identical results.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef HDMI_PATTERN_H /* prevent circular inclusions */
+#define HDMI_PATTERN_H /* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************** Constant Definitions ****************************/
+
+/** @name Patterns
+ * @{
+ */
+#define HDMI_PATTERN_RAMP	0	/**< TPM / TPG pixel sequence */
+#define HDMI_PATTERN_SOLID	1	/**< One RGB value */
+#define HDMI_PATTERN_BARS	2	/**< 75% color bars */
+/* @} */
+
+#define HDMI_PATTERN_MAX_WIDTH	2048	/**< Longest line of the CRC model */
+#define HDMI_PATTERN_RAMP_MASK	0x00FFFFFF /**< TPM counter width */
+
+/************************** Function Prototypes *****************************/
+
+void HdmiTx_PatternLine(u32 Type, u32 Rgb, u32 Width, u32 Line,
+			u32 *DstPtr);
+void HdmiTx_PatternLineScalar(u32 Type, u32 Rgb, u32 Width, u32 Line,
+			      u32 *DstPtr);
+void HdmiTx_PatternFrame(u32 Type, u32 Rgb, u32 *FramePtr, u32 Stride,
+			 u32 Width, u32 Height);
+
+u32 HdmiTx_Crc32(u32 Crc, const u8 *BufPtr, u32 Len);
+u32 HdmiTx_PatternFrameCrc(const u32 *FramePtr, u32 Stride, u32 Width,
+			   u32 Height);
+u32 HdmiTx_PatternOutputCrc(u32 Type, u32 Rgb, u32 Width, u32 Height,
+			    u32 CscBypass, u32 CrCbInit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HDMI_PATTERN_H */
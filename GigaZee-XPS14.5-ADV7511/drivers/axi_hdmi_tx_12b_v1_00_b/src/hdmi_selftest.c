@@ -0,0 +1,408 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file hdmi_selftest.c
+*
+* Go/no-go self test of the axi_vdma -> axi_hdmi_tx_12b video path. See
+* hdmi_selftest.h for the stages.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "hdmi_selftest.h"
+#include "hdmi_pattern.h"
+#include "hdmi_tx_l.h"
+#include "hdmi_vdma_l.h"
+#include "xil_assert.h"
+#include "xil_cache.h"
+
+/************************** Constant Definitions ****************************/
+
+#define HDMI_SELFTEST_RESET_TIMEOUT	1000000	/* Polls of the reset bit */
+#define HDMI_SELFTEST_FRAME_TIMEOUT	10000000 /* Polls for one frame */
+#define HDMI_SELFTEST_SETTLE		2	/* Frames skipped per stage */
+#define HDMI_SELFTEST_ALIGN		8	/* 64 bit MM2S data width */
+
+/*
+ * Video source of a stage
+ */
+#define SRC_DDR		0
+#define SRC_TPG		1
+#define SRC_CP		2
+
+/*
+ * Expected state of the test pattern monitors
+ */
+#define TPM_IN_SYNC	0	/* Never out of sync */
+#define TPM_FAULT	1	/* Out of sync on every frame */
+#define TPM_IGNORE	2	/* Not checked */
+
+#define HDMI_SELFTEST_DMA_ERR_MASK	(HDMI_TX_STATUS_VDMA_BE_ERROR_MASK | \
+					 HDMI_TX_STATUS_VDMA_OVF_MASK | \
+					 HDMI_TX_STATUS_VDMA_UNF_MASK)
+
+/**************************** Type Definitions ******************************/
+
+typedef struct {
+	const char *Name;
+	u8 Source;
+	u8 Pattern;	/* DDR frame, HDMI_PATTERN_* */
+	u8 Tpm;
+	u32 Rgb;	/* Color pattern */
+} StageDef;
+
+/************************** Function Prototypes *****************************/
+
+static int StartVdma(const HdmiSelfTest_Config *ConfigPtr, u32 Width,
+		     u32 Height);
+static int WaitFrame(const HdmiSelfTest_Config *ConfigPtr, u32 *StatusPtr);
+static u32 WriteFrame(const HdmiSelfTest_Config *ConfigPtr, u32 Pattern,
+		      u32 Width, u32 Height);
+static u32 ReadFrameCrc(const HdmiSelfTest_Config *ConfigPtr, u32 Width,
+			u32 Height);
+
+/************************** Variable Definitions ****************************/
+
+static const StageDef Stages[HDMI_SELFTEST_NUM_STAGES] = {
+	{ "tpm ramp",  SRC_DDR, HDMI_PATTERN_RAMP, TPM_IN_SYNC, 0 },
+	{ "tpm fault", SRC_DDR, HDMI_PATTERN_RAMP, TPM_FAULT,   0 },
+	{ "tpg",       SRC_TPG, HDMI_PATTERN_RAMP, TPM_IN_SYNC, 0 },
+	{ "cp black",  SRC_CP,  HDMI_PATTERN_RAMP, TPM_IN_SYNC, 0x000000 },
+	{ "cp white",  SRC_CP,  HDMI_PATTERN_RAMP, TPM_IN_SYNC, 0xFFFFFF },
+	{ "cp red",    SRC_CP,  HDMI_PATTERN_RAMP, TPM_IN_SYNC, 0xFF0000 },
+	{ "cp green",  SRC_CP,  HDMI_PATTERN_RAMP, TPM_IN_SYNC, 0x00FF00 },
+	{ "cp blue",   SRC_CP,  HDMI_PATTERN_RAMP, TPM_IN_SYNC, 0x0000FF },
+	{ "cp gray",   SRC_CP,  HDMI_PATTERN_RAMP, TPM_IN_SYNC, 0x808080 },
+	{ "bars",      SRC_DDR, HDMI_PATTERN_BARS, TPM_IGNORE,  0 },
+};
+
+/*****************************************************************************/
+/**
+*
+* Run the self test.
+*
+* @param	ConfigPtr is the test configuration.
+* @param	CaptureFunc is the capture callback, NULL if there is none.
+* @param	CallBackRef is passed to the capture callback.
+* @param	ResultPtr receives the results of all stages.
+*
+* @return
+*		- XST_SUCCESS if all stages passed.
+*		- XST_FAILURE if a stage failed, see ResultPtr.
+*		- XST_INVALID_PARAM if the HDMI core is not enabled, the
+*		  active area is not supported or the frame buffer does not
+*		  fit it.
+*		- XST_DEVICE_NOT_FOUND if the VDMA did not leave reset.
+*
+******************************************************************************/
+int HdmiSelfTest_Run(const HdmiSelfTest_Config *ConfigPtr,
+		     HdmiSelfTest_Capture CaptureFunc, void *CallBackRef,
+		     HdmiSelfTest_Result *ResultPtr)
+{
+	const StageDef *DefPtr;
+	HdmiSelfTest_Stage *StagePtr;
+	u32 Ctrl, Cp, Hs, Vs;
+	u32 TestCtrl;
+	u32 Width, Height;
+	u32 CscBypass, CrCbInit;
+	u32 Ddr;			/* Pattern in DDR */
+	u32 DdrCrc;
+	u32 RampCrc;
+	u32 FaultAddr = 0;
+	u32 Status;
+	u32 Index, Frame;
+	u32 Frames;
+
+	Xil_AssertNonvoid(ConfigPtr != NULL);
+	Xil_AssertNonvoid(ResultPtr != NULL);
+
+	memset(ResultPtr, 0, sizeof(HdmiSelfTest_Result));
+
+	Ctrl = HdmiTx_ReadReg(ConfigPtr->HdmiBaseAddr, HDMI_TX_CTRL_OFFSET);
+	Cp = HdmiTx_ReadReg(ConfigPtr->HdmiBaseAddr, HDMI_TX_CP_OFFSET);
+	Hs = HdmiTx_ReadReg(ConfigPtr->HdmiBaseAddr, HDMI_TX_HSYNC_2_OFFSET);
+	Vs = HdmiTx_ReadReg(ConfigPtr->HdmiBaseAddr, HDMI_TX_VSYNC_2_OFFSET);
+
+	/* Active area from the DE window of the running timing */
+	Width = (Hs & HDMI_TX_SYNC_LO_MASK) - (Hs >> HDMI_TX_SYNC_HI_SHIFT);
+	Height = (Vs & HDMI_TX_SYNC_LO_MASK) - (Vs >> HDMI_TX_SYNC_HI_SHIFT);
+	if (((Ctrl & HDMI_TX_CTRL_ENABLE_MASK) == 0) || (Width == 0) ||
+	    (Width > HDMI_PATTERN_MAX_WIDTH) || ((Width % 2) != 0) ||
+	    (Height == 0) || (Height > (Vs & HDMI_TX_SYNC_LO_MASK)) ||
+	    (ConfigPtr->Stride < Width * 4) ||
+	    ((ConfigPtr->Stride % HDMI_SELFTEST_ALIGN) != 0) ||
+	    ((ConfigPtr->FrameAddr % HDMI_SELFTEST_ALIGN) != 0)) {
+		return XST_INVALID_PARAM;
+	}
+	ResultPtr->Width = Width;
+	ResultPtr->Height = Height;
+
+	Frames = ConfigPtr->FramesPerStage ? ConfigPtr->FramesPerStage :
+					     HDMI_SELFTEST_FRAMES;
+	CscBypass = Ctrl & HDMI_TX_CTRL_CSC_BYPASS_MASK;
+	CrCbInit = Ctrl & HDMI_TX_CTRL_CRCB_INIT_MASK;
+	TestCtrl = Ctrl & ~HDMI_TX_CTRL_TPG_ENABLE_MASK;
+
+	RampCrc = HdmiTx_PatternOutputCrc(HDMI_PATTERN_RAMP, 0, Width, Height,
+					  CscBypass, CrCbInit);
+
+	HdmiTx_WriteReg(ConfigPtr->HdmiBaseAddr, HDMI_TX_CP_OFFSET, 0);
+	DdrCrc = WriteFrame(ConfigPtr, HDMI_PATTERN_RAMP, Width, Height);
+	Ddr = HDMI_PATTERN_RAMP;
+	if (StartVdma(ConfigPtr, Width, Height) != XST_SUCCESS) {
+		HdmiTx_WriteReg(ConfigPtr->HdmiBaseAddr, HDMI_TX_CP_OFFSET, Cp);
+		return XST_DEVICE_NOT_FOUND;
+	}
+
+	ResultPtr->Pass = 1;
+
+	for (Index = 0; Index < HDMI_SELFTEST_NUM_STAGES; Index++) {
+		DefPtr = &Stages[Index];
+		StagePtr = &ResultPtr->Stage[Index];
+		StagePtr->Name = DefPtr->Name;
+
+		/* Frame buffer */
+		if (DefPtr->Pattern != Ddr) {
+			DdrCrc = WriteFrame(ConfigPtr, DefPtr->Pattern, Width,
+					    Height);
+			Ddr = DefPtr->Pattern;
+		}
+		if (DefPtr->Tpm == TPM_FAULT) {
+			/* Corrupt the middle pixel of the ramp */
+			FaultAddr = ConfigPtr->FrameAddr +
+				    (Height / 2) * ConfigPtr->Stride +
+				    (Width / 2) * 4;
+			Xil_Out32(FaultAddr, Xil_In32(FaultAddr) ^ 1);
+			Xil_DCacheFlushRange(FaultAddr, 4);
+			DdrCrc = ReadFrameCrc(ConfigPtr, Width, Height);
+		}
+
+		/* Source */
+		HdmiTx_WriteReg(ConfigPtr->HdmiBaseAddr, HDMI_TX_CTRL_OFFSET,
+				(DefPtr->Source == SRC_TPG) ?
+				TestCtrl | HDMI_TX_CTRL_TPG_ENABLE_MASK :
+				TestCtrl);
+		HdmiTx_WriteReg(ConfigPtr->HdmiBaseAddr, HDMI_TX_CP_OFFSET, 0);
+		if (DefPtr->Source == SRC_CP) {
+			/* The core latches the value on the enable edge */
+			HdmiTx_WriteReg(ConfigPtr->HdmiBaseAddr,
+					HDMI_TX_CP_OFFSET,
+					HDMI_TX_CP_ENABLE_MASK |
+					(DefPtr->Rgb & HDMI_TX_CP_VALUE_MASK));
+		}
+
+		/* Expected output while the frames run */
+		if (DefPtr->Tpm == TPM_FAULT) {
+			StagePtr->ExpectedCrc = 0;
+		} else if (DefPtr->Source == SRC_CP) {
+			StagePtr->ExpectedCrc =
+				HdmiTx_PatternOutputCrc(HDMI_PATTERN_SOLID,
+							DefPtr->Rgb, Width,
+							Height, CscBypass,
+							CrCbInit);
+		} else if ((DefPtr->Source == SRC_TPG) ||
+			   (DefPtr->Pattern == HDMI_PATTERN_RAMP)) {
+			StagePtr->ExpectedCrc = RampCrc;
+		} else {
+			StagePtr->ExpectedCrc =
+				HdmiTx_PatternOutputCrc(DefPtr->Pattern, 0,
+							Width, Height,
+							CscBypass, CrCbInit);
+		}
+
+		/* Frames */
+		for (Frame = 0; Frame < HDMI_SELFTEST_SETTLE + Frames;
+		     Frame++) {
+			if (WaitFrame(ConfigPtr, &Status) != XST_SUCCESS) {
+				break;
+			}
+			if (Frame < HDMI_SELFTEST_SETTLE) {
+				continue;
+			}
+			StagePtr->Frames++;
+			if ((Status & HDMI_TX_STATUS_VDMA_TPM_OOS_MASK) != 0) {
+				StagePtr->VdmaTpmFrames++;
+			}
+			if ((Status & HDMI_TX_STATUS_HDMI_TPM_OOS_MASK) != 0) {
+				StagePtr->HdmiTpmFrames++;
+			}
+			if ((Status & HDMI_SELFTEST_DMA_ERR_MASK) != 0) {
+				StagePtr->DmaErrorFrames++;
+			}
+		}
+
+		if ((CaptureFunc != NULL) && (StagePtr->ExpectedCrc != 0) &&
+		    (CaptureFunc(CallBackRef, &StagePtr->MeasuredCrc) ==
+		     XST_SUCCESS)) {
+			StagePtr->Measured = 1;
+		}
+
+		StagePtr->FrameCrcOk = 1;
+		if (DefPtr->Source == SRC_DDR) {
+			StagePtr->FrameCrcOk =
+				(ReadFrameCrc(ConfigPtr, Width, Height) ==
+				 DdrCrc);
+		}
+		if (DefPtr->Tpm == TPM_FAULT) {
+			Xil_Out32(FaultAddr, Xil_In32(FaultAddr) ^ 1);
+			Xil_DCacheFlushRange(FaultAddr, 4);
+			DdrCrc = ReadFrameCrc(ConfigPtr, Width, Height);
+		}
+
+		StagePtr->Pass = (StagePtr->Frames == Frames) &&
+				 (StagePtr->DmaErrorFrames == 0) &&
+				 StagePtr->FrameCrcOk;
+		if (DefPtr->Tpm == TPM_IN_SYNC) {
+			StagePtr->Pass &= (StagePtr->VdmaTpmFrames == 0) &&
+					  (StagePtr->HdmiTpmFrames == 0);
+		} else if (DefPtr->Tpm == TPM_FAULT) {
+			StagePtr->Pass &= (StagePtr->VdmaTpmFrames == Frames) &&
+					  (StagePtr->HdmiTpmFrames == Frames);
+		}
+		if (StagePtr->Measured) {
+			StagePtr->Pass &= (StagePtr->MeasuredCrc ==
+					   StagePtr->ExpectedCrc);
+		}
+
+		ResultPtr->NumStages++;
+		ResultPtr->Pass &= StagePtr->Pass;
+	}
+
+	HdmiVdma_WriteReg(ConfigPtr->VdmaBaseAddr, HDMI_VDMA_CR_OFFSET, 0);
+	HdmiTx_WriteReg(ConfigPtr->HdmiBaseAddr, HDMI_TX_CTRL_OFFSET, Ctrl);
+	HdmiTx_WriteReg(ConfigPtr->HdmiBaseAddr, HDMI_TX_CP_OFFSET, 0);
+	HdmiTx_WriteReg(ConfigPtr->HdmiBaseAddr, HDMI_TX_CP_OFFSET, Cp);
+
+	return ResultPtr->Pass ? XST_SUCCESS : XST_FAILURE;
+}
+
+/*****************************************************************************/
+/*
+* Reset the VDMA read channel and scan out the test frame from every frame
+* store in park mode, with the frame count status set once per frame.
+*
+******************************************************************************/
+static int StartVdma(const HdmiSelfTest_Config *ConfigPtr, u32 Width,
+		     u32 Height)
+{
+	u32 Base = ConfigPtr->VdmaBaseAddr;
+	u32 Timeout = HDMI_SELFTEST_RESET_TIMEOUT;
+	u32 Index;
+
+	HdmiVdma_WriteReg(Base, HDMI_VDMA_CR_OFFSET, HDMI_VDMA_CR_RESET_MASK);
+	while ((HdmiVdma_ReadReg(Base, HDMI_VDMA_CR_OFFSET) &
+		HDMI_VDMA_CR_RESET_MASK) != 0) {
+		if (--Timeout == 0) {
+			return XST_FAILURE;
+		}
+	}
+
+	HdmiVdma_WriteReg(Base, HDMI_VDMA_CR_OFFSET,
+			  (1 << HDMI_VDMA_CR_IRQ_FRMCNT_SHIFT) |
+			  HDMI_VDMA_CR_RUNSTOP_MASK);
+	HdmiVdma_WriteReg(Base, HDMI_VDMA_PARK_OFFSET, 0);
+	for (Index = 0; Index < ConfigPtr->NumFrameStores; Index++) {
+		HdmiVdma_WriteReg(Base, HDMI_VDMA_ADDR_OFFSET(Index),
+				  ConfigPtr->FrameAddr);
+	}
+	HdmiVdma_WriteReg(Base, HDMI_VDMA_HSIZE_OFFSET, Width * 4);
+	HdmiVdma_WriteReg(Base, HDMI_VDMA_STRIDE_OFFSET, ConfigPtr->Stride);
+	HdmiVdma_WriteReg(Base, HDMI_VDMA_VSIZE_OFFSET, Height);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/*
+* Wait for the end of the next frame, then read and clear the HDMI core
+* status collected during it.
+*
+******************************************************************************/
+static int WaitFrame(const HdmiSelfTest_Config *ConfigPtr, u32 *StatusPtr)
+{
+	u32 Timeout = HDMI_SELFTEST_FRAME_TIMEOUT;
+
+	while ((HdmiVdma_ReadReg(ConfigPtr->VdmaBaseAddr,
+				 HDMI_VDMA_SR_OFFSET) &
+		HDMI_VDMA_SR_FRMCNT_IRQ_MASK) == 0) {
+		if (--Timeout == 0) {
+			return XST_FAILURE;
+		}
+	}
+	HdmiVdma_WriteReg(ConfigPtr->VdmaBaseAddr, HDMI_VDMA_SR_OFFSET,
+			  HDMI_VDMA_SR_IRQ_ALL_MASK);
+
+	*StatusPtr = HdmiTx_ReadReg(ConfigPtr->HdmiBaseAddr,
+				    HDMI_TX_STATUS_OFFSET);
+	HdmiTx_WriteReg(ConfigPtr->HdmiBaseAddr, HDMI_TX_STATUS_OFFSET,
+			HDMI_TX_STATUS_ALL_MASK);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/*
+* Write a pattern into the test frame and flush it, returns its CRC.
+*
+******************************************************************************/
+static u32 WriteFrame(const HdmiSelfTest_Config *ConfigPtr, u32 Pattern,
+		      u32 Width, u32 Height)
+{
+	u32 *FramePtr = (u32 *)ConfigPtr->FrameAddr;
+
+	HdmiTx_PatternFrame(Pattern, 0, FramePtr, ConfigPtr->Stride / 4,
+			    Width, Height);
+	Xil_DCacheFlushRange(ConfigPtr->FrameAddr,
+			     ConfigPtr->Stride * Height);
+
+	return HdmiTx_PatternFrameCrc(FramePtr, ConfigPtr->Stride / 4, Width,
+				      Height);
+}
+
+/*****************************************************************************/
+/*
+* Read the test frame back from DDR, returns its CRC.
+*
+******************************************************************************/
+static u32 ReadFrameCrc(const HdmiSelfTest_Config *ConfigPtr, u32 Width,
+			u32 Height)
+{
+	Xil_DCacheInvalidateRange(ConfigPtr->FrameAddr,
+				  ConfigPtr->Stride * Height);
+
+	return HdmiTx_PatternFrameCrc((const u32 *)ConfigPtr->FrameAddr,
+				      ConfigPtr->Stride / 4, Width, Height);
+}
@@ -0,0 +1,149 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file hdmi_selftest.h
+*
+* Go/no-go self test of the axi_vdma -> axi_hdmi_tx_12b video path for the
+* production line.
+*
+* The test takes over the VDMA read channel and scans out a test frame
+* from DDR at the timing the HDMI core is running with. It cycles through
+* HDMI_SELFTEST_NUM_STAGES stages, each checked over FramesPerStage frames
+* after two frames to settle:
+*
+*   - "tpm ramp": the TPM ramp (hdmi_pattern.h) from DDR. Both test
+*     pattern monitors of the core must stay in sync on every frame.
+*   - "tpm fault": one pixel of the ramp is corrupted. Both monitors must
+*     report out of sync on every frame, which proves they work.
+*   - "tpg": the core outputs its test pattern generator, the ramp stays
+*     in DDR and the monitors must stay in sync.
+*   - "cp ...": the color pattern with black, white, red, green, blue and
+*     gray, monitors as for "tpg".
+*   - "bars": color bars from DDR, the monitors are not checked.
+*
+* On every frame the HDMI core status is read and cleared, so the monitors
+* and the VDMA underflow, overflow and byte enable errors are counted per
+* frame. The DDR frame is read back and its CRC compared after the DDR
+* stages.
+*
+* The core has no CRC of its output. For every stage but "tpm fault" the
+* expected CRC of the hdmi_data words of a frame is computed with the bit
+* exact model of the color pipeline. If a capture callback is given, e.g.
+* an HDMI analyzer of the test station or a logic analyzer core on
+* hdmi_data, it is called once per stage for the CRC of the frame it saw
+* and the two are compared. Without one the expected CRCs are reported.
+*
+* The HDMI core must be enabled with the timing of the mode under test,
+* e.g. by HdmiTx_ModeSetApply. The test leaves the VDMA stopped and the
+* core control and color pattern registers as they were, restart the frame
+* buffer manager afterwards.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef HDMI_SELFTEST_H /* prevent circular inclusions */
+#define HDMI_SELFTEST_H /* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************** Constant Definitions ****************************/
+
+#define HDMI_SELFTEST_NUM_STAGES	10	/**< Stages of a run */
+#define HDMI_SELFTEST_FRAMES		8	/**< Default frames per stage */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Test configuration
+ */
+typedef struct {
+	u32 VdmaBaseAddr;	/**< axi_vdma register base */
+	u32 HdmiBaseAddr;	/**< axi_hdmi_tx_12b register base */
+	u32 NumFrameStores;	/**< VDMA C_NUM_FSTORES */
+	u32 FrameAddr;		/**< Test frame, Stride * lines bytes */
+	u32 Stride;		/**< Line stride in bytes */
+	u32 FramesPerStage;	/**< Frames checked per stage */
+} HdmiSelfTest_Config;
+
+/**
+ * Result of one stage
+ */
+typedef struct {
+	const char *Name;
+	u32 Frames;		/**< Frames checked */
+	u32 VdmaTpmFrames;	/**< Frames with vdma_tpm_oos */
+	u32 HdmiTpmFrames;	/**< Frames with hdmi_tpm_oos */
+	u32 DmaErrorFrames;	/**< Frames with vdma_unf, ovf or be_error */
+	u32 FrameCrcOk;		/**< DDR frame read back unchanged */
+	u32 ExpectedCrc;	/**< Output CRC of the model, 0 if none */
+	u32 MeasuredCrc;	/**< Output CRC of the capture callback */
+	u32 Measured;		/**< MeasuredCrc is valid */
+	u32 Pass;
+} HdmiSelfTest_Stage;
+
+/**
+ * Result of a run
+ */
+typedef struct {
+	u32 Width;		/**< Active pixels per line */
+	u32 Height;		/**< Active lines */
+	u32 NumStages;		/**< Stages run */
+	HdmiSelfTest_Stage Stage[HDMI_SELFTEST_NUM_STAGES];
+	u32 Pass;		/**< All stages passed */
+} HdmiSelfTest_Result;
+
+/**
+ * Capture callback, returns the CRC of the hdmi_data words of the active
+ * area of the next complete frame in CrcPtr and XST_SUCCESS, or an error
+ * if nothing was captured.
+ */
+typedef int (*HdmiSelfTest_Capture)(void *CallBackRef, u32 *CrcPtr);
+
+/************************** Function Prototypes *****************************/
+
+int HdmiSelfTest_Run(const HdmiSelfTest_Config *ConfigPtr,
+		     HdmiSelfTest_Capture CaptureFunc, void *CallBackRef,
+		     HdmiSelfTest_Result *ResultPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HDMI_SELFTEST_H */
@@ -0,0 +1,465 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file hdmi_tx_csc.c
+*
+* Bit exact software model of the axi_hdmi_tx_12b color pipeline. See
+* hdmi_tx_csc.h for the arithmetic.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "hdmi_tx_csc.h"
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define HDMI_TX_CSC_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define HDMI_TX_CSC_SSE2
+#endif
+
+/************************** Constant Definitions ****************************/
+
+/*
+ * Coefficients of cf_csc_RGB2CrYCb.v. C1..C3 are sign and magnitude in the
+ * RTL (bit 16 is the sign), C4 is the offset in 1.4.20 format.
+ */
+#define CSC_CR_C1	0x0707
+#define CSC_CR_C2	(-0x05E2)
+#define CSC_CR_C3	(-0x0124)
+#define CSC_CR_C4	0x80000
+
+#define CSC_Y_C1	0x041B
+#define CSC_Y_C2	0x0810
+#define CSC_Y_C3	0x0191
+#define CSC_Y_C4	0x10000
+
+#define CSC_CB_C1	(-0x025F)
+#define CSC_CB_C2	(-0x04A7)
+#define CSC_CB_C3	0x0707
+#define CSC_CB_C4	0x80000
+
+#define CSC_FRAC_BITS	12
+#define CSC_SAT_LIMIT	(1 << 20)
+
+/* Pixels converted per model step, bounds the stack buffer */
+#define MODEL_CHUNK	64
+
+/**************************** Type Definitions ******************************/
+
+/*
+ * Sub sampler state within a line
+ */
+typedef struct {
+	u32 Prev;	/* S[n-1] */
+	u32 Cur;	/* S[n] */
+	u32 Count;	/* pixels received in this line */
+	u32 Sel;	/* 1 if the next output carries Cr */
+} SsState;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define COMP(Pixel, Shift)	(((Pixel) >> (Shift)) & 0xFF)
+
+/************************** Function Prototypes *****************************/
+
+static void SsStart(SsState *StatePtr, u32 LastPixel, u32 CrCbInit);
+static u16 *SsPush(SsState *StatePtr, u32 Pixel, u16 *DstPtr);
+static u16 *SsFlush(SsState *StatePtr, u16 *DstPtr, u32 *LastPixelPtr);
+
+/*****************************************************************************/
+/**
+*
+* Evaluate one CSC channel the way cf_add.v saturates it.
+*
+* @param	Sum is C1 * R + C2 * G + C3 * B + C4.
+*
+* @return	The 8 bit component.
+*
+******************************************************************************/
+static inline u32 CscSat(s32 Sum)
+{
+	if (Sum < 0) {
+		return 0;
+	}
+	if (Sum >= CSC_SAT_LIMIT) {
+		return 0xFF;
+	}
+	return (u32)Sum >> CSC_FRAC_BITS;
+}
+
+/*****************************************************************************/
+/**
+*
+* Convert one RGB pixel to CrYCb.
+*
+* @param	Rgb is the pixel, {R, G, B} in bits [23:0].
+*
+* @return	{Cr, Y, Cb} in bits [23:0].
+*
+******************************************************************************/
+u32 HdmiTx_CscPixel(u32 Rgb)
+{
+	s32 R = COMP(Rgb, 16);
+	s32 G = COMP(Rgb, 8);
+	s32 B = COMP(Rgb, 0);
+	u32 Cr, Y, Cb;
+
+	Cr = CscSat(CSC_CR_C1 * R + CSC_CR_C2 * G + CSC_CR_C3 * B + CSC_CR_C4);
+	Y = CscSat(CSC_Y_C1 * R + CSC_Y_C2 * G + CSC_Y_C3 * B + CSC_Y_C4);
+	Cb = CscSat(CSC_CB_C1 * R + CSC_CB_C2 * G + CSC_CB_C3 * B + CSC_CB_C4);
+
+	return (Cr << 16) | (Y << 8) | Cb;
+}
+
+/*****************************************************************************/
+/**
+*
+* Convert a line of RGB pixels to CrYCb with the portable C kernel.
+*
+* @param	SrcPtr points to the RGB pixels.
+* @param	DstPtr points to the CrYCb output, may equal SrcPtr.
+* @param	Width is the number of pixels.
+*
+* @return	None.
+*
+******************************************************************************/
+void HdmiTx_CscLineScalar(const u32 *SrcPtr, u32 *DstPtr, u32 Width)
+{
+	u32 Index;
+
+	for (Index = 0; Index < Width; Index++) {
+		DstPtr[Index] = HdmiTx_CscPixel(SrcPtr[Index]);
+	}
+}
+
+#ifdef HDMI_TX_CSC_NEON
+/*****************************************************************************/
+/**
+*
+* NEON kernel, 8 pixels per step. The sums are formed in 32 bit lanes, the
+* saturating narrowing shift clamps negative sums to 0 and the saturating
+* narrow clamps sums of 2^20 and above to 255, as cf_add.v does.
+*
+******************************************************************************/
+static inline uint8x8_t CscNeon(int16x8_t R, int16x8_t G, int16x8_t B,
+				s16 C1, s16 C2, s16 C3, s32 C4)
+{
+	int32x4_t Lo = vdupq_n_s32(C4);
+	int32x4_t Hi = vdupq_n_s32(C4);
+
+	Lo = vmlal_n_s16(Lo, vget_low_s16(R), C1);
+	Hi = vmlal_n_s16(Hi, vget_high_s16(R), C1);
+	Lo = vmlal_n_s16(Lo, vget_low_s16(G), C2);
+	Hi = vmlal_n_s16(Hi, vget_high_s16(G), C2);
+	Lo = vmlal_n_s16(Lo, vget_low_s16(B), C3);
+	Hi = vmlal_n_s16(Hi, vget_high_s16(B), C3);
+
+	return vqmovn_u16(vcombine_u16(vqshrun_n_s32(Lo, CSC_FRAC_BITS),
+				       vqshrun_n_s32(Hi, CSC_FRAC_BITS)));
+}
+
+static u32 CscLineVector(const u32 *SrcPtr, u32 *DstPtr, u32 Width)
+{
+	u32 Index;
+
+	for (Index = 0; Index + 8 <= Width; Index += 8) {
+		uint8x8x4_t In = vld4_u8((const u8 *)(SrcPtr + Index));
+		uint8x8x4_t Out;
+		int16x8_t R = vreinterpretq_s16_u16(vmovl_u8(In.val[2]));
+		int16x8_t G = vreinterpretq_s16_u16(vmovl_u8(In.val[1]));
+		int16x8_t B = vreinterpretq_s16_u16(vmovl_u8(In.val[0]));
+
+		Out.val[2] = CscNeon(R, G, B, CSC_CR_C1, CSC_CR_C2, CSC_CR_C3,
+				     CSC_CR_C4);
+		Out.val[1] = CscNeon(R, G, B, CSC_Y_C1, CSC_Y_C2, CSC_Y_C3,
+				     CSC_Y_C4);
+		Out.val[0] = CscNeon(R, G, B, CSC_CB_C1, CSC_CB_C2, CSC_CB_C3,
+				     CSC_CB_C4);
+		Out.val[3] = vdup_n_u8(0);
+		vst4_u8((u8 *)(DstPtr + Index), Out);
+	}
+
+	return Index;
+}
+#endif /* HDMI_TX_CSC_NEON */
+
+#ifdef HDMI_TX_CSC_SSE2
+/*****************************************************************************/
+/**
+*
+* SSE2 kernel, 4 pixels per step. The pixels are widened to 16 bit lanes
+* {B, G, R, X} and _mm_madd_epi16 forms B * C3 + G * C2 and R * C1 per
+* pixel, the two halves are added after an even/odd shuffle. After the
+* arithmetic shift, the saturating packs clamp to 0..255 exactly like
+* cf_add.v.
+*
+******************************************************************************/
+static inline __m128i CscSse2(__m128i Lo, __m128i Hi, s16 C1, s16 C2,
+			      s16 C3, s32 C4)
+{
+	const __m128i Coef = _mm_set_epi16(0, C1, C2, C3, 0, C1, C2, C3);
+	__m128 SumLo = _mm_castsi128_ps(_mm_madd_epi16(Lo, Coef));
+	__m128 SumHi = _mm_castsi128_ps(_mm_madd_epi16(Hi, Coef));
+	__m128i Sum;
+
+	Sum = _mm_add_epi32(
+		_mm_castps_si128(_mm_shuffle_ps(SumLo, SumHi,
+						_MM_SHUFFLE(2, 0, 2, 0))),
+		_mm_castps_si128(_mm_shuffle_ps(SumLo, SumHi,
+						_MM_SHUFFLE(3, 1, 3, 1))));
+	Sum = _mm_add_epi32(Sum, _mm_set1_epi32(C4));
+
+	return _mm_srai_epi32(Sum, CSC_FRAC_BITS);
+}
+
+static u32 CscLineVector(const u32 *SrcPtr, u32 *DstPtr, u32 Width)
+{
+	const __m128i Zero = _mm_setzero_si128();
+	u32 Index;
+
+	for (Index = 0; Index + 4 <= Width; Index += 4) {
+		__m128i In = _mm_loadu_si128((const __m128i *)(SrcPtr + Index));
+		__m128i Lo = _mm_unpacklo_epi8(In, Zero);
+		__m128i Hi = _mm_unpackhi_epi8(In, Zero);
+		__m128i Cr, Y, Cb, Bytes, CbY;
+
+		Cr = CscSse2(Lo, Hi, CSC_CR_C1, CSC_CR_C2, CSC_CR_C3, CSC_CR_C4);
+		Y = CscSse2(Lo, Hi, CSC_Y_C1, CSC_Y_C2, CSC_Y_C3, CSC_Y_C4);
+		Cb = CscSse2(Lo, Hi, CSC_CB_C1, CSC_CB_C2, CSC_CB_C3, CSC_CB_C4);
+
+		/* Bytes 0-3 Cb, 4-7 Cr, 8-11 Y, 12-15 zero, clamped 0..255 */
+		Bytes = _mm_packus_epi16(_mm_packs_epi32(Cb, Cr),
+					 _mm_packs_epi32(Y, Zero));
+
+		/* Interleave to {Cb, Y, Cr, 0} per pixel */
+		CbY = _mm_unpacklo_epi8(Bytes, _mm_srli_si128(Bytes, 8));
+		_mm_storeu_si128((__m128i *)(DstPtr + Index),
+				 _mm_unpacklo_epi16(CbY, _mm_srli_si128(CbY, 8)));
+	}
+
+	return Index;
+}
+#endif /* HDMI_TX_CSC_SSE2 */
+
+/*****************************************************************************/
+/**
+*
+* Convert a line of RGB pixels to CrYCb with the fastest kernel available.
+*
+* @param	SrcPtr points to the RGB pixels.
+* @param	DstPtr points to the CrYCb output, may equal SrcPtr.
+* @param	Width is the number of pixels.
+*
+* @return	None.
+*
+******************************************************************************/
+void HdmiTx_CscLine(const u32 *SrcPtr, u32 *DstPtr, u32 Width)
+{
+	u32 Done = 0;
+
+#if defined(HDMI_TX_CSC_NEON) || defined(HDMI_TX_CSC_SSE2)
+	Done = CscLineVector(SrcPtr, DstPtr, Width);
+#endif
+	HdmiTx_CscLineScalar(SrcPtr + Done, DstPtr + Done, Width - Done);
+}
+
+/*****************************************************************************/
+/**
+*
+* Sub sample a line of CrYCb pixels to 4:2:2.
+*
+* @param	SrcPtr points to the CrYCb pixels.
+* @param	DstPtr points to the 16 bit output words, {C, Y}.
+* @param	Width is the number of pixels.
+* @param	LastPixelPtr holds the last pixel of the previous line on
+*		entry and the last pixel of this line on return.
+* @param	CrCbInit is the crcb_init control bit.
+*
+* @return	None.
+*
+******************************************************************************/
+void HdmiTx_SubsampleLine(const u32 *SrcPtr, u16 *DstPtr, u32 Width,
+			  u32 *LastPixelPtr, u32 CrCbInit)
+{
+	SsState State;
+	u32 Index;
+
+	if (Width == 0) {
+		return;
+	}
+
+	SsStart(&State, *LastPixelPtr, CrCbInit);
+	for (Index = 0; Index < Width; Index++) {
+		DstPtr = SsPush(&State, SrcPtr[Index], DstPtr);
+	}
+	SsFlush(&State, DstPtr, LastPixelPtr);
+}
+
+/*****************************************************************************/
+/**
+*
+* Initialize the model to the reset state of the core.
+*
+* @param	ModelPtr is the model.
+* @param	CscBypass is the csc_bypass control bit.
+* @param	CrCbInit is the crcb_init control bit.
+*
+* @return	None.
+*
+******************************************************************************/
+void HdmiTx_ModelInit(HdmiTx_Model *ModelPtr, u32 CscBypass, u32 CrCbInit)
+{
+	ModelPtr->CscBypass = CscBypass ? 1 : 0;
+	ModelPtr->CrCbInit = CrCbInit ? 1 : 0;
+	ModelPtr->LastPixel = 0;
+}
+
+/*****************************************************************************/
+/**
+*
+* Run one active line through the model.
+*
+* @param	ModelPtr is the model.
+* @param	SrcPtr points to the RGB pixels of the line.
+* @param	DstPtr points to Width 16 bit hdmi_data words.
+* @param	Width is the number of pixels.
+*
+* @return	None.
+*
+******************************************************************************/
+void HdmiTx_ModelLine(HdmiTx_Model *ModelPtr, const u32 *SrcPtr,
+		      u16 *DstPtr, u32 Width)
+{
+	u32 Csc[MODEL_CHUNK];
+	SsState State;
+	u32 Index, Count;
+
+	if (ModelPtr->CscBypass) {
+		for (Index = 0; Index < Width; Index++) {
+			DstPtr[Index] = (u16)SrcPtr[Index];
+		}
+		return;
+	}
+	if (Width == 0) {
+		return;
+	}
+
+	SsStart(&State, ModelPtr->LastPixel, ModelPtr->CrCbInit);
+	while (Width != 0) {
+		Count = (Width < MODEL_CHUNK) ? Width : MODEL_CHUNK;
+		HdmiTx_CscLine(SrcPtr, Csc, Count);
+		for (Index = 0; Index < Count; Index++) {
+			DstPtr = SsPush(&State, Csc[Index], DstPtr);
+		}
+		SrcPtr += Count;
+		Width -= Count;
+	}
+	SsFlush(&State, DstPtr, &ModelPtr->LastPixel);
+}
+
+/*****************************************************************************/
+/**
+*
+* Run the active area of a frame through the model.
+*
+* @param	ModelPtr is the model.
+* @param	SrcPtr points to the first RGB pixel of the frame buffer.
+* @param	SrcStride is the frame buffer line stride in pixels.
+* @param	Width is the number of active pixels per line.
+* @param	Height is the number of active lines.
+* @param	DstPtr points to Width * Height 16 bit hdmi_data words.
+*
+* @return	None.
+*
+******************************************************************************/
+void HdmiTx_ModelFrame(HdmiTx_Model *ModelPtr, const u32 *SrcPtr,
+		       u32 SrcStride, u32 Width, u32 Height, u16 *DstPtr)
+{
+	u32 Line;
+
+	for (Line = 0; Line < Height; Line++) {
+		HdmiTx_ModelLine(ModelPtr, SrcPtr, DstPtr, Width);
+		SrcPtr += SrcStride;
+		DstPtr += Width;
+	}
+}
+
+/*****************************************************************************/
+/*
+* Streaming form of cf_ss_444to422.v. Output n needs S[n+1], so each pixel
+* pushed emits the output of the pixel before it and the flush at the end of
+* the line emits the last output with the held pixel as S[W].
+*
+******************************************************************************/
+static void SsStart(SsState *StatePtr, u32 LastPixel, u32 CrCbInit)
+{
+	StatePtr->Prev = LastPixel;
+	StatePtr->Cur = LastPixel;
+	StatePtr->Count = 0;
+	StatePtr->Sel = CrCbInit;
+}
+
+static inline u16 SsOutput(SsState *StatePtr, u32 Next)
+{
+	u32 Shift = StatePtr->Sel ? 16 : 0;
+	u32 Chroma;
+
+	Chroma = (COMP(StatePtr->Prev, Shift) + 2 * COMP(StatePtr->Cur, Shift) +
+		  COMP(Next, Shift)) >> 2;
+	StatePtr->Sel ^= 1;
+
+	return (u16)((Chroma << 8) | COMP(StatePtr->Cur, 8));
+}
+
+static u16 *SsPush(SsState *StatePtr, u32 Pixel, u16 *DstPtr)
+{
+	if (StatePtr->Count++ != 0) {
+		*DstPtr++ = SsOutput(StatePtr, Pixel);
+		StatePtr->Prev = StatePtr->Cur;
+	}
+	StatePtr->Cur = Pixel;
+
+	return DstPtr;
+}
+
+static u16 *SsFlush(SsState *StatePtr, u16 *DstPtr, u32 *LastPixelPtr)
+{
+	*DstPtr++ = SsOutput(StatePtr, StatePtr->Cur);
+	*LastPixelPtr = StatePtr->Cur;
+
+	return DstPtr;
+}
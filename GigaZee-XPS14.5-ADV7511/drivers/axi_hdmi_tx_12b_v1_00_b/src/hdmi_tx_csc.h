@@ -0,0 +1,107 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file hdmi_tx_csc.h
+*
+* Bit exact software model of the axi_hdmi_tx_12b color pipeline: the RGB to
+* CrYCb conversion (cf_csc_RGB2CrYCb.v, cf_csc_1.v, cf_mul.v, cf_add.v) and
+* the 4:4:4 to 4:2:2 sub sampling (cf_ss_444to422.v). It produces the same
+* 16 bit hdmi_data words as the core and serves as golden model for frame
+* checks and as CPU fallback.
+*
+* Pixels are the 32 bit frame buffer words the VDMA reads, the core uses
+* bits [23:0] as {R, G, B}. The CSC output is {Cr, Y, Cb} in bits [23:0].
+* Each component is
+*
+*	sat((C1 * R + C2 * G + C3 * B + C4) >> 12)
+*
+* with the coefficients of cf_csc_RGB2CrYCb.v, negative sums give 0 and sums
+* of 2^20 or more give 255. The multipliers and adders of the core are
+* exact, so integer arithmetic reproduces them bit by bit.
+*
+* The sub sampler filters Cr and Cb as (S[n-1] + 2 * S[n] + S[n+1]) >> 2 and
+* outputs {Cr, Y} and {Cb, Y} on alternate pixels. Outside of DE the core
+* holds the last pixel, so S[W] of a line is S[W-1] and S[-1] is the last
+* pixel of the previous line. HdmiTx_Model carries that pixel from line to
+* line. The first pixel of a line carries Cr if crcb_init is set, Cb
+* otherwise, as the RTL does (the regmap.txt wording is reversed).
+*
+* With csc_bypass set, the core outputs bits [15:0] of the input pixel.
+*
+* HdmiTx_CscLine uses NEON or SSE2 when the compiler targets them and the
+* portable C kernel otherwise, all kernels give identical results.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef HDMI_TX_CSC_H /* prevent circular inclusions */
+#define HDMI_TX_CSC_H /* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * State of the color pipeline model
+ */
+typedef struct {
+	u32 CscBypass;		/**< Control register csc_bypass */
+	u32 CrCbInit;		/**< Control register crcb_init */
+	u32 LastPixel;		/**< CrYCb pixel held by the sub sampler */
+} HdmiTx_Model;
+
+/************************** Function Prototypes *****************************/
+
+void HdmiTx_ModelInit(HdmiTx_Model *ModelPtr, u32 CscBypass, u32 CrCbInit);
+void HdmiTx_ModelLine(HdmiTx_Model *ModelPtr, const u32 *SrcPtr,
+		      u16 *DstPtr, u32 Width);
+void HdmiTx_ModelFrame(HdmiTx_Model *ModelPtr, const u32 *SrcPtr,
+		       u32 SrcStride, u32 Width, u32 Height, u16 *DstPtr);
+
+u32 HdmiTx_CscPixel(u32 Rgb);
+void HdmiTx_CscLine(const u32 *SrcPtr, u32 *DstPtr, u32 Width);
+void HdmiTx_CscLineScalar(const u32 *SrcPtr, u32 *DstPtr, u32 Width);
+void HdmiTx_SubsampleLine(const u32 *SrcPtr, u16 *DstPtr, u32 Width,
+			  u32 *LastPixelPtr, u32 CrCbInit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HDMI_TX_CSC_H */
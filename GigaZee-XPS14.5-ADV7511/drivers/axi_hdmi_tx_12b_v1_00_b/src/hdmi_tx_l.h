@@ -0,0 +1,118 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file hdmi_tx_l.h
+*
+* This header file contains the register offsets and bit definitions of the
+* axi_hdmi_tx_12b core (pcores/axi_hdmi_tx_12b_v1_00_b, see regmap.txt) and
+* the low level access macros.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef HDMI_TX_L_H /* prevent circular inclusions */
+#define HDMI_TX_L_H /* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xil_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************** Constant Definitions ****************************/
+
+/** @name Register offsets
+ * @{
+ */
+#define HDMI_TX_VERSION_OFFSET		0x00	/**< Core version */
+#define HDMI_TX_CTRL_OFFSET		0x04	/**< Control */
+#define HDMI_TX_HSYNC_1_OFFSET		0x08	/**< HSYNC width, count */
+#define HDMI_TX_HSYNC_2_OFFSET		0x0C	/**< HSYNC DE min, max */
+#define HDMI_TX_VSYNC_1_OFFSET		0x10	/**< VSYNC width, count */
+#define HDMI_TX_VSYNC_2_OFFSET		0x14	/**< VSYNC DE min, max */
+#define HDMI_TX_STATUS_OFFSET		0x18	/**< Status, write 1 to clear */
+#define HDMI_TX_CP_OFFSET		0x1C	/**< Color pattern */
+/* @} */
+
+/** @name Control register bits
+ * @{
+ */
+#define HDMI_TX_CTRL_CRCB_INIT_MASK	0x08	/**< Cr on the first pixel */
+#define HDMI_TX_CTRL_TPG_ENABLE_MASK	0x04	/**< Test pattern video */
+#define HDMI_TX_CTRL_CSC_BYPASS_MASK	0x02	/**< Bypass CSC and 4:2:2 */
+#define HDMI_TX_CTRL_ENABLE_MASK	0x01	/**< Video output enable */
+/* @} */
+
+/** @name Status register bits
+ * @{
+ */
+#define HDMI_TX_STATUS_HDMI_TPM_OOS_MASK	0x10 /**< TPM OOS, HDMI side */
+#define HDMI_TX_STATUS_VDMA_TPM_OOS_MASK	0x08 /**< TPM OOS, VDMA side */
+#define HDMI_TX_STATUS_VDMA_BE_ERROR_MASK	0x04 /**< VDMA byte enables */
+#define HDMI_TX_STATUS_VDMA_OVF_MASK		0x02 /**< VDMA overflow */
+#define HDMI_TX_STATUS_VDMA_UNF_MASK		0x01 /**< VDMA underflow */
+#define HDMI_TX_STATUS_ALL_MASK			0x1F
+/* @} */
+
+/** @name Color pattern register bits
+ * @{
+ */
+#define HDMI_TX_CP_ENABLE_MASK		0x01000000 /**< Color pattern enable */
+#define HDMI_TX_CP_VALUE_MASK		0x00FFFFFF /**< Pattern RGB value */
+/* @} */
+
+#define HDMI_TX_SYNC_HI_SHIFT		16	/**< width / de_min field */
+#define HDMI_TX_SYNC_LO_MASK		0xFFFF	/**< count / de_max field */
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define HdmiTx_ReadReg(BaseAddress, RegOffset) \
+	Xil_In32((BaseAddress) + (RegOffset))
+
+#define HdmiTx_WriteReg(BaseAddress, RegOffset, Data) \
+	Xil_Out32((BaseAddress) + (RegOffset), (Data))
+
+/*
+ * Pack the two 16 bit fields of the sync registers.
+ */
+#define HdmiTx_SyncReg(Hi, Lo) \
+	((((u32)(Hi)) << HDMI_TX_SYNC_HI_SHIFT) | ((Lo) & HDMI_TX_SYNC_LO_MASK))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HDMI_TX_L_H */
@@ -0,0 +1,120 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file hdmi_vdma_l.h
+*
+* This header file contains the MM2S register offsets and bit definitions of
+* the AXI VDMA v5.04a that feeds the axi_hdmi_tx_12b core. Only the read
+* channel is used in this design (C_INCLUDE_S2MM = 0).
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef HDMI_VDMA_L_H /* prevent circular inclusions */
+#define HDMI_VDMA_L_H /* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xil_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************** Constant Definitions ****************************/
+
+/** @name Register offsets
+ * @{
+ */
+#define HDMI_VDMA_CR_OFFSET		0x00	/**< MM2S control */
+#define HDMI_VDMA_SR_OFFSET		0x04	/**< MM2S status */
+#define HDMI_VDMA_PARK_OFFSET		0x28	/**< Park pointer */
+#define HDMI_VDMA_VERSION_OFFSET	0x2C	/**< Core version */
+#define HDMI_VDMA_VSIZE_OFFSET		0x50	/**< Lines, starts the channel */
+#define HDMI_VDMA_HSIZE_OFFSET		0x54	/**< Line size in bytes */
+#define HDMI_VDMA_STRIDE_OFFSET		0x58	/**< Stride and frame delay */
+#define HDMI_VDMA_ADDR_OFFSET(n)	(0x5C + ((n) * 4)) /**< Frame n */
+/* @} */
+
+/** @name Control register bits
+ * @{
+ */
+#define HDMI_VDMA_CR_RUNSTOP_MASK	0x00000001 /**< Run */
+#define HDMI_VDMA_CR_CIRCULAR_MASK	0x00000002 /**< Circular, 0 parks */
+#define HDMI_VDMA_CR_RESET_MASK		0x00000004 /**< Soft reset */
+#define HDMI_VDMA_CR_GENLOCK_MASK	0x00000008 /**< Genlock enable */
+#define HDMI_VDMA_CR_FRMCNT_EN_MASK	0x00000010 /**< Frame count enable */
+#define HDMI_VDMA_CR_FRMCNT_IRQ_MASK	0x00001000 /**< Frame count IRQ */
+#define HDMI_VDMA_CR_DLYCNT_IRQ_MASK	0x00002000 /**< Delay count IRQ */
+#define HDMI_VDMA_CR_ERR_IRQ_MASK	0x00004000 /**< Error IRQ */
+#define HDMI_VDMA_CR_IRQ_FRMCNT_SHIFT	16	   /**< IRQ frame count */
+/* @} */
+
+/** @name Status register bits
+ * @{
+ */
+#define HDMI_VDMA_SR_HALTED_MASK	0x00000001 /**< Channel halted */
+#define HDMI_VDMA_SR_INTERR_MASK	0x00000010 /**< Internal error */
+#define HDMI_VDMA_SR_SLVERR_MASK	0x00000020 /**< Slave error */
+#define HDMI_VDMA_SR_DECERR_MASK	0x00000040 /**< Decode error */
+#define HDMI_VDMA_SR_ERR_ALL_MASK	0x00000070
+#define HDMI_VDMA_SR_FRMCNT_IRQ_MASK	0x00001000 /**< Frame count IRQ */
+#define HDMI_VDMA_SR_DLYCNT_IRQ_MASK	0x00002000 /**< Delay count IRQ */
+#define HDMI_VDMA_SR_ERR_IRQ_MASK	0x00004000 /**< Error IRQ */
+#define HDMI_VDMA_SR_IRQ_ALL_MASK	0x00007000
+/* @} */
+
+/** @name Park pointer register fields
+ * @{
+ */
+#define HDMI_VDMA_PARK_REF_MASK		0x0000001F /**< Frame to park on */
+#define HDMI_VDMA_PARK_STORE_MASK	0x001F0000 /**< Frame being read */
+#define HDMI_VDMA_PARK_STORE_SHIFT	16
+/* @} */
+
+#define HDMI_VDMA_MAX_FRAMES		16	/**< Frame store registers */
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define HdmiVdma_ReadReg(BaseAddress, RegOffset) \
+	Xil_In32((BaseAddress) + (RegOffset))
+
+#define HdmiVdma_WriteReg(BaseAddress, RegOffset, Data) \
+	Xil_Out32((BaseAddress) + (RegOffset), (Data))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HDMI_VDMA_L_H */
@@ -0,0 +1,523 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file spdif_dma.c
+*
+* Audio streaming ring on the axi_dma_spdif scatter gather engine. See
+* spdif_dma.h for the description.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "spdif_dma.h"
+#include "spdif_dma_l.h"
+#include "xil_assert.h"
+#include "xil_cache.h"
+#include "xil_exception.h"
+
+/************************** Constant Definitions ****************************/
+
+#define SPDIF_DMA_RESET_TIMEOUT	1000000	/* Polls of the reset/halted bits */
+#define SPDIF_DMA_ALIGN		4	/* 32 bit MM2S data width, no DRE */
+
+/*
+ * Critical section against SpdifDma_IntrHandler. The CPSR is saved and
+ * restored, Submit is called from the period callback with the IRQ already
+ * masked. The host build is single threaded.
+ */
+#ifdef __arm__
+#include "xpseudo_asm.h"
+#define SpdifDma_Lock(Cpsr) \
+	do { \
+		(Cpsr) = mfcpsr(); \
+		mtcpsr((Cpsr) | XIL_EXCEPTION_IRQ); \
+	} while (0)
+#define SpdifDma_Unlock(Cpsr)	mtcpsr(Cpsr)
+#else
+#define SpdifDma_Lock(Cpsr)	((Cpsr) = 0)
+#define SpdifDma_Unlock(Cpsr)	((void)(Cpsr))
+#endif
+
+/**************************** Macros Definitions ****************************/
+
+#define SpdifDma_BdAddr(InstancePtr, Index) \
+	((InstancePtr)->Config.BdRingAddr + ((Index) * SPDIF_DMA_BD_SIZE))
+
+#define SpdifDma_Next(InstancePtr, Index) \
+	(((Index) + 1 == (InstancePtr)->Config.NumBds) ? 0 : (Index) + 1)
+
+/************************** Function Prototypes *****************************/
+
+static int ResetDma(u32 BaseAddress);
+static void RunRing(SpdifDma *InstancePtr);
+static void ArmBd(SpdifDma *InstancePtr, u32 BufAddr);
+static void Restart(SpdifDma *InstancePtr);
+static void StubHandler(void *CallBackRef, u32 BufAddr);
+
+/*****************************************************************************/
+/**
+*
+* Initialize a streaming ring instance and link the descriptor ring.
+*
+* @param	InstancePtr is the instance to initialize.
+* @param	ConfigPtr is the ring configuration.
+*
+* @return
+*		- XST_SUCCESS if successful.
+*		- XST_INVALID_PARAM if the descriptor count, the period size
+*		  or an alignment is not supported.
+*
+* @note		The DMA is not touched until SpdifDma_Start.
+*
+******************************************************************************/
+int SpdifDma_CfgInitialize(SpdifDma *InstancePtr,
+			   const SpdifDma_Config *ConfigPtr)
+{
+	u32 Index;
+	u32 BdAddr;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(ConfigPtr != NULL);
+
+	if ((ConfigPtr->NumBds < 2) ||
+	    (ConfigPtr->NumBds > SPDIF_DMA_MAX_BDS) ||
+	    ((ConfigPtr->BdRingAddr % SPDIF_DMA_BD_SIZE) != 0)) {
+		return XST_INVALID_PARAM;
+	}
+	if ((ConfigPtr->PeriodBytes == 0) ||
+	    (ConfigPtr->PeriodBytes > SPDIF_DMA_BD_LENGTH_MASK) ||
+	    ((ConfigPtr->PeriodBytes % SPDIF_DMA_ALIGN) != 0) ||
+	    ((ConfigPtr->SilenceAddr % SPDIF_DMA_ALIGN) != 0)) {
+		return XST_INVALID_PARAM;
+	}
+
+	memset(InstancePtr, 0, sizeof(SpdifDma));
+	InstancePtr->Config = *ConfigPtr;
+
+	/* Links and lengths never change, Submit only sets the buffer */
+	for (Index = 0; Index < ConfigPtr->NumBds; Index++) {
+		BdAddr = SpdifDma_BdAddr(InstancePtr, Index);
+		SpdifDma_BdWrite(BdAddr, SPDIF_DMA_BD_NXTDESC_OFFSET,
+				 SpdifDma_BdAddr(InstancePtr,
+					SpdifDma_Next(InstancePtr, Index)));
+		SpdifDma_BdWrite(BdAddr, SPDIF_DMA_BD_BUFA_OFFSET,
+				 ConfigPtr->SilenceAddr);
+		SpdifDma_BdWrite(BdAddr, SPDIF_DMA_BD_CTRL_OFFSET,
+				 ConfigPtr->PeriodBytes |
+				 SPDIF_DMA_BD_CTRL_SOF_MASK |
+				 SPDIF_DMA_BD_CTRL_EOF_MASK);
+		SpdifDma_BdWrite(BdAddr, SPDIF_DMA_BD_STS_OFFSET, 0);
+	}
+	Xil_DCacheFlushRange(ConfigPtr->BdRingAddr,
+			     ConfigPtr->NumBds * SPDIF_DMA_BD_SIZE);
+
+	InstancePtr->Handler = StubHandler;
+	InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* Reset the DMA and start streaming the submitted periods. Without any the
+* stream starts with silence.
+*
+* @param	InstancePtr is the instance.
+*
+* @return
+*		- XST_SUCCESS if the ring runs.
+*		- XST_FAILURE if the DMA did not leave reset.
+*
+* @note		The silence buffer is flushed here, fill it before.
+*
+******************************************************************************/
+int SpdifDma_Start(SpdifDma *InstancePtr)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+	Xil_AssertNonvoid(InstancePtr->IsStarted == 0);
+
+	if (ResetDma(InstancePtr->Config.DmaBaseAddr) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Xil_DCacheFlushRange(InstancePtr->Config.SilenceAddr,
+			     InstancePtr->Config.PeriodBytes);
+
+	if (InstancePtr->Pending == 0) {
+		ArmBd(InstancePtr, InstancePtr->Config.SilenceAddr);
+		InstancePtr->Starved = 1;
+	}
+	RunRing(InstancePtr);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* Stop the DMA and empty the ring. All submitted buffers belong to the
+* application again, no callbacks are made for them.
+*
+* @param	InstancePtr is the instance.
+*
+* @return	None.
+*
+******************************************************************************/
+void SpdifDma_Stop(SpdifDma *InstancePtr)
+{
+	u32 Base;
+	u32 Timeout = SPDIF_DMA_RESET_TIMEOUT;
+	u32 Cpsr;
+
+	Xil_AssertVoid(InstancePtr != NULL);
+
+	Base = InstancePtr->Config.DmaBaseAddr;
+
+	SpdifDma_Lock(Cpsr);
+	SpdifDma_WriteReg(Base, SPDIF_DMA_CR_OFFSET, 0);
+	while (((SpdifDma_ReadReg(Base, SPDIF_DMA_SR_OFFSET) &
+		 SPDIF_DMA_SR_HALTED_MASK) == 0) && (--Timeout != 0)) {
+	}
+	/* Drop the descriptors the engine has prefetched */
+	(void)ResetDma(Base);
+
+	InstancePtr->IsStarted = 0;
+	InstancePtr->Head = 0;
+	InstancePtr->Tail = 0;
+	InstancePtr->Pending = 0;
+	InstancePtr->Starved = 0;
+	SpdifDma_Unlock(Cpsr);
+}
+
+/*****************************************************************************/
+/**
+*
+* Hand a period buffer over for playback. It is played after the periods
+* submitted before and given back through the period callback.
+*
+* @param	InstancePtr is the instance.
+* @param	BufAddr is the DDR address of PeriodBytes of PCM data.
+*
+* @return
+*		- XST_SUCCESS if the period is queued.
+*		- XST_DEVICE_BUSY if all descriptors are in flight.
+*		- XST_INVALID_PARAM if BufAddr is not word aligned.
+*
+* @note		Only the buffer and its descriptor are flushed from the
+*		D-cache. May be called from the period callback.
+*
+******************************************************************************/
+int SpdifDma_Submit(SpdifDma *InstancePtr, u32 BufAddr)
+{
+	u32 Cpsr;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	if ((BufAddr % SPDIF_DMA_ALIGN) != 0) {
+		return XST_INVALID_PARAM;
+	}
+
+	/* Outside the critical section, the flush is the long part */
+	Xil_DCacheFlushRange(BufAddr, InstancePtr->Config.PeriodBytes);
+
+	SpdifDma_Lock(Cpsr);
+	if (InstancePtr->Pending == InstancePtr->Config.NumBds) {
+		SpdifDma_Unlock(Cpsr);
+		return XST_DEVICE_BUSY;
+	}
+	ArmBd(InstancePtr, BufAddr);
+	InstancePtr->Starved = 0;
+	InstancePtr->Stats.Submitted++;
+	SpdifDma_Unlock(Cpsr);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* Set the callback called for every period played.
+*
+* @param	InstancePtr is the instance.
+* @param	FuncPtr is the callback.
+* @param	CallBackRef is passed to the callback.
+*
+* @return	None.
+*
+******************************************************************************/
+void SpdifDma_SetHandler(SpdifDma *InstancePtr, SpdifDma_Handler FuncPtr,
+			 void *CallBackRef)
+{
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(FuncPtr != NULL);
+
+	InstancePtr->Handler = FuncPtr;
+	InstancePtr->CallBackRef = CallBackRef;
+}
+
+/*****************************************************************************/
+/**
+*
+* DMA interrupt handler, connect it to the mm2s_introut interrupt. Reaps the
+* completed descriptors in order, calls the period callback for every
+* application buffer, queues silence when the ring has run dry and restarts
+* the ring after a DMA error.
+*
+* @param	InstancePtr is the instance.
+*
+* @return	None.
+*
+******************************************************************************/
+void SpdifDma_IntrHandler(void *InstancePtr)
+{
+	SpdifDma *DmaPtr = (SpdifDma *)InstancePtr;
+	u32 Status;
+	u32 BdAddr;
+	u32 BufAddr;
+	u32 Running;
+
+	Xil_AssertVoid(DmaPtr != NULL);
+
+	Status = SpdifDma_ReadReg(DmaPtr->Config.DmaBaseAddr,
+				  SPDIF_DMA_SR_OFFSET);
+	SpdifDma_WriteReg(DmaPtr->Config.DmaBaseAddr, SPDIF_DMA_SR_OFFSET,
+			  Status & SPDIF_DMA_SR_IRQ_ALL_MASK);
+
+	DmaPtr->Stats.Interrupts++;
+
+	/* On an error the channel has halted, no tail writes until Restart */
+	Running = DmaPtr->IsStarted;
+	if ((Status & SPDIF_DMA_SR_ERR_ALL_MASK) != 0) {
+		DmaPtr->IsStarted = 0;
+	}
+
+	while (DmaPtr->Pending != 0) {
+		BdAddr = SpdifDma_BdAddr(DmaPtr, DmaPtr->Head);
+		Xil_DCacheInvalidateRange(BdAddr, SPDIF_DMA_BD_SIZE);
+		if ((SpdifDma_BdRead(BdAddr, SPDIF_DMA_BD_STS_OFFSET) &
+		     SPDIF_DMA_BD_STS_CMPLT_MASK) == 0) {
+			break;
+		}
+
+		BufAddr = DmaPtr->Buf[DmaPtr->Head];
+		DmaPtr->Head = SpdifDma_Next(DmaPtr, DmaPtr->Head);
+		DmaPtr->Pending--;
+
+		if (BufAddr == DmaPtr->Config.SilenceAddr) {
+			DmaPtr->Stats.Silence++;
+		} else {
+			DmaPtr->Stats.Periods++;
+			DmaPtr->Handler(DmaPtr->CallBackRef, BufAddr);
+		}
+	}
+
+	if (Running == 0) {
+		return;
+	}
+
+	if ((Status & SPDIF_DMA_SR_ERR_ALL_MASK) != 0) {
+		DmaPtr->Stats.Errors++;
+		Restart(DmaPtr);
+	} else if (DmaPtr->Pending == 0) {
+		if (DmaPtr->Starved == 0) {
+			DmaPtr->Stats.Underruns++;
+			DmaPtr->Starved = 1;
+		}
+		ArmBd(DmaPtr, DmaPtr->Config.SilenceAddr);
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* Copy the statistics.
+*
+* @param	InstancePtr is the instance.
+* @param	StatsPtr receives the statistics.
+*
+* @return	None.
+*
+******************************************************************************/
+void SpdifDma_GetStats(SpdifDma *InstancePtr, SpdifDma_Stats *StatsPtr)
+{
+	u32 Cpsr;
+
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(StatsPtr != NULL);
+
+	SpdifDma_Lock(Cpsr);
+	*StatsPtr = InstancePtr->Stats;
+	SpdifDma_Unlock(Cpsr);
+}
+
+/*****************************************************************************/
+/**
+*
+* Clear the statistics.
+*
+* @param	InstancePtr is the instance.
+*
+* @return	None.
+*
+******************************************************************************/
+void SpdifDma_ResetStats(SpdifDma *InstancePtr)
+{
+	u32 Cpsr;
+
+	Xil_AssertVoid(InstancePtr != NULL);
+
+	SpdifDma_Lock(Cpsr);
+	memset(&InstancePtr->Stats, 0, sizeof(SpdifDma_Stats));
+	SpdifDma_Unlock(Cpsr);
+}
+
+/*****************************************************************************/
+/*
+* Soft reset the MM2S channel, returns XST_FAILURE on a timeout.
+*
+******************************************************************************/
+static int ResetDma(u32 BaseAddress)
+{
+	u32 Timeout = SPDIF_DMA_RESET_TIMEOUT;
+
+	SpdifDma_WriteReg(BaseAddress, SPDIF_DMA_CR_OFFSET,
+			  SPDIF_DMA_CR_RESET_MASK);
+	while ((SpdifDma_ReadReg(BaseAddress, SPDIF_DMA_CR_OFFSET) &
+		SPDIF_DMA_CR_RESET_MASK) != 0) {
+		if (--Timeout == 0) {
+			return XST_FAILURE;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/*
+* Start the halted channel on the descriptors in flight, Head to Tail. The
+* current descriptor is only writable while halted, the tail only while
+* running.
+*
+******************************************************************************/
+static void RunRing(SpdifDma *InstancePtr)
+{
+	u32 Base = InstancePtr->Config.DmaBaseAddr;
+	u32 Last;
+
+	Last = (InstancePtr->Tail == 0) ? InstancePtr->Config.NumBds - 1 :
+					   InstancePtr->Tail - 1;
+
+	SpdifDma_WriteReg(Base, SPDIF_DMA_CURDESC_OFFSET,
+			  SpdifDma_BdAddr(InstancePtr, InstancePtr->Head));
+	SpdifDma_WriteReg(Base, SPDIF_DMA_CR_OFFSET,
+			  (1 << SPDIF_DMA_CR_THRESHOLD_SHIFT) |
+			  SPDIF_DMA_CR_IOC_IRQ_MASK |
+			  SPDIF_DMA_CR_ERR_IRQ_MASK |
+			  SPDIF_DMA_CR_RUNSTOP_MASK);
+	SpdifDma_WriteReg(Base, SPDIF_DMA_TAILDESC_OFFSET,
+			  SpdifDma_BdAddr(InstancePtr, Last));
+
+	InstancePtr->IsStarted = XIL_COMPONENT_IS_STARTED;
+}
+
+/*****************************************************************************/
+/*
+* Point the free descriptor at Tail to BufAddr and, while running, move the
+* tail to it. Interrupts must be masked.
+*
+******************************************************************************/
+static void ArmBd(SpdifDma *InstancePtr, u32 BufAddr)
+{
+	u32 BdAddr = SpdifDma_BdAddr(InstancePtr, InstancePtr->Tail);
+
+	SpdifDma_BdWrite(BdAddr, SPDIF_DMA_BD_BUFA_OFFSET, BufAddr);
+	SpdifDma_BdWrite(BdAddr, SPDIF_DMA_BD_STS_OFFSET, 0);
+	Xil_DCacheFlushRange(BdAddr, SPDIF_DMA_BD_SIZE);
+
+	InstancePtr->Buf[InstancePtr->Tail] = BufAddr;
+	InstancePtr->Tail = SpdifDma_Next(InstancePtr, InstancePtr->Tail);
+	InstancePtr->Pending++;
+
+	if (InstancePtr->IsStarted != 0) {
+		SpdifDma_WriteReg(InstancePtr->Config.DmaBaseAddr,
+				  SPDIF_DMA_TAILDESC_OFFSET, BdAddr);
+	}
+}
+
+/*****************************************************************************/
+/*
+* Recover from a DMA error: the channel halts, so reset it, clear the status
+* of the descriptors in flight and run them again from Head. The period the
+* error hit is played again from its start.
+*
+******************************************************************************/
+static void Restart(SpdifDma *InstancePtr)
+{
+	u32 Index;
+	u32 Count;
+	u32 BdAddr;
+
+	if (ResetDma(InstancePtr->Config.DmaBaseAddr) != XST_SUCCESS) {
+		return;
+	}
+
+	Index = InstancePtr->Head;
+	for (Count = 0; Count < InstancePtr->Pending; Count++) {
+		BdAddr = SpdifDma_BdAddr(InstancePtr, Index);
+		SpdifDma_BdWrite(BdAddr, SPDIF_DMA_BD_STS_OFFSET, 0);
+		Xil_DCacheFlushRange(BdAddr, SPDIF_DMA_BD_SIZE);
+		Index = SpdifDma_Next(InstancePtr, Index);
+	}
+	if (InstancePtr->Pending == 0) {
+		ArmBd(InstancePtr, InstancePtr->Config.SilenceAddr);
+	}
+
+	RunRing(InstancePtr);
+}
+
+/*****************************************************************************/
+/*
+* Default callback, does nothing.
+*
+******************************************************************************/
+static void StubHandler(void *CallBackRef, u32 BufAddr)
+{
+	(void)CallBackRef;
+	(void)BufAddr;
+}
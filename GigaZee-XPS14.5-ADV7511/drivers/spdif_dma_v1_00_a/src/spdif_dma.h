@@ -0,0 +1,163 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file spdif_dma.h
+*
+* Audio streaming ring on the axi_dma_spdif scatter gather engine.
+*
+* The ring is a circle of NumBds descriptors, one per period, in memory
+* given by the application. The PCM data stays in buffers owned by the
+* application: SpdifDma_Submit points the next free descriptor at a period
+* buffer and moves TAILDESC, nothing is copied. Every descriptor raises a
+* completion interrupt, SpdifDma_IntrHandler reaps the completed descriptors
+* in order and hands each buffer back through the period callback, from
+* where it may be refilled and submitted again.
+*
+* Cache maintenance is limited to the period being handed over: Submit
+* flushes the period buffer and its descriptor, the interrupt handler
+* invalidates the descriptors it polls. Nothing else of the ring or of the
+* application buffers is touched.
+*
+* Underrun: when the last submitted period completes and the application
+* has not submitted the next one, the handler queues the silence buffer
+* from the configuration instead. The engine restarts from the tail write
+* and the S/PDIF stream keeps its framing, so the receiver stays locked.
+* Silence is repeated period by period until the application submits
+* again, its periods then follow the silence in order. Every such run
+* counts as one underrun, every silence period is counted as well.
+*
+* Sizing: at 192 kHz stereo with 32 bit sub frame words a period of 1024
+* frames is 8 KiB and 5.3 ms, one interrupt per period. Keep at least two
+* periods submitted, the application then has a full period to answer a
+* callback. A period holds at most SPDIF_DMA_BD_LENGTH_MASK bytes.
+*
+* The MM2S stream of axi_dma_spdif is not connected to an S/PDIF
+* transmitter in this system.mhs, the stream sink (e.g. an axi_spdif_tx
+* core) has to be added to the design for audio to come out. The ring
+* only depends on the DMA.
+*
+* All register and descriptor access goes through Xil_In32/Xil_Out32, so
+* the ring can be linked on a host against a model of the engine, see
+* tools/spdif_dma_sim.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef SPDIF_DMA_H /* prevent circular inclusions */
+#define SPDIF_DMA_H /* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************** Constant Definitions ****************************/
+
+#define SPDIF_DMA_MAX_BDS	32	/**< Descriptors in the ring at most */
+
+/*
+ * Default configuration of the GigaZee-XPS14.5-ADV7511 design
+ */
+#define SPDIF_DMA_BASEADDR	0x40400000
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Ring configuration
+ */
+typedef struct {
+	u32 DmaBaseAddr;	/**< axi_dma_spdif register base */
+	u32 BdRingAddr;		/**< NumBds * 64 bytes, 64 byte aligned */
+	u32 NumBds;		/**< 2 to SPDIF_DMA_MAX_BDS */
+	u32 PeriodBytes;	/**< Bytes per period, multiple of 4 */
+	u32 SilenceAddr;	/**< PeriodBytes of zeros, played on underrun */
+} SpdifDma_Config;
+
+/**
+ * Statistics, see SpdifDma_GetStats
+ */
+typedef struct {
+	u32 Interrupts;		/**< Handler calls */
+	u32 Submitted;		/**< Periods submitted */
+	u32 Periods;		/**< Periods played and handed back */
+	u32 Underruns;		/**< Runs of silence */
+	u32 Silence;		/**< Silence periods played */
+	u32 Errors;		/**< DMA errors, the ring was restarted */
+} SpdifDma_Stats;
+
+/**
+ * Callback for every period played, BufAddr is the buffer handed back.
+ */
+typedef void (*SpdifDma_Handler)(void *CallBackRef, u32 BufAddr);
+
+/**
+ * Streaming ring instance
+ */
+typedef struct {
+	SpdifDma_Config Config;
+	u32 IsReady;
+	u32 IsStarted;
+
+	u32 Head;			/**< Oldest descriptor in flight */
+	u32 Tail;			/**< Next free descriptor */
+	u32 Pending;			/**< Descriptors in flight */
+	u32 Buf[SPDIF_DMA_MAX_BDS];	/**< Buffer of every descriptor */
+	u32 Starved;			/**< Silence queued, no new data */
+
+	SpdifDma_Stats Stats;
+	SpdifDma_Handler Handler;
+	void *CallBackRef;
+} SpdifDma;
+
+/************************** Function Prototypes *****************************/
+
+int SpdifDma_CfgInitialize(SpdifDma *InstancePtr,
+			   const SpdifDma_Config *ConfigPtr);
+int SpdifDma_Start(SpdifDma *InstancePtr);
+void SpdifDma_Stop(SpdifDma *InstancePtr);
+int SpdifDma_Submit(SpdifDma *InstancePtr, u32 BufAddr);
+void SpdifDma_SetHandler(SpdifDma *InstancePtr, SpdifDma_Handler FuncPtr,
+			 void *CallBackRef);
+void SpdifDma_IntrHandler(void *InstancePtr);
+void SpdifDma_GetStats(SpdifDma *InstancePtr, SpdifDma_Stats *StatsPtr);
+void SpdifDma_ResetStats(SpdifDma *InstancePtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPDIF_DMA_H */
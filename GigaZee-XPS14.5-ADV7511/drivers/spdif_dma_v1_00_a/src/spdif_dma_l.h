@@ -0,0 +1,146 @@
+/******************************************************************************
+*
+* Copyright (C) 2013 Trenz Electronic GmbH
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+* IN THE SOFTWARE.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file spdif_dma_l.h
+*
+* This header file contains the MM2S register offsets and bit definitions of
+* the axi_dma_spdif instance (axi_dma 5.00.a, C_INCLUDE_SG = 1,
+* C_INCLUDE_S2MM = 0, C_SG_LENGTH_WIDTH = 20), the layout of its scatter
+* gather descriptors and the low level access macros.
+*
+* A descriptor is 16 words and must be 64 byte aligned. The engine fetches
+* descriptors from CURDESC on through NXTDESC until it has completed the one
+* at TAILDESC, then it goes idle. Writing TAILDESC while idle resumes with
+* the descriptor after the last completed one. A fetched descriptor with the
+* complete bit still set is an SG internal error.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef SPDIF_DMA_L_H /* prevent circular inclusions */
+#define SPDIF_DMA_L_H /* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xil_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************** Constant Definitions ****************************/
+
+/** @name Register offsets
+ * @{
+ */
+#define SPDIF_DMA_CR_OFFSET		0x00	/**< MM2S control */
+#define SPDIF_DMA_SR_OFFSET		0x04	/**< MM2S status */
+#define SPDIF_DMA_CURDESC_OFFSET	0x08	/**< Current descriptor */
+#define SPDIF_DMA_TAILDESC_OFFSET	0x10	/**< Tail, resumes when idle */
+/* @} */
+
+/** @name Control register bits
+ * @{
+ */
+#define SPDIF_DMA_CR_RUNSTOP_MASK	0x00000001 /**< Run */
+#define SPDIF_DMA_CR_RESET_MASK		0x00000004 /**< Soft reset */
+#define SPDIF_DMA_CR_IOC_IRQ_MASK	0x00001000 /**< Completion IRQ */
+#define SPDIF_DMA_CR_DLY_IRQ_MASK	0x00002000 /**< Delay timer IRQ */
+#define SPDIF_DMA_CR_ERR_IRQ_MASK	0x00004000 /**< Error IRQ */
+#define SPDIF_DMA_CR_THRESHOLD_SHIFT	16	   /**< Completions per IRQ */
+/* @} */
+
+/** @name Status register bits
+ * @{
+ */
+#define SPDIF_DMA_SR_HALTED_MASK	0x00000001 /**< Channel halted */
+#define SPDIF_DMA_SR_IDLE_MASK		0x00000002 /**< Tail completed */
+#define SPDIF_DMA_SR_SGINCLD_MASK	0x00000008 /**< SG engine present */
+#define SPDIF_DMA_SR_DMAINTERR_MASK	0x00000010 /**< Length error */
+#define SPDIF_DMA_SR_DMASLVERR_MASK	0x00000020 /**< Data slave error */
+#define SPDIF_DMA_SR_DMADECERR_MASK	0x00000040 /**< Data decode error */
+#define SPDIF_DMA_SR_SGINTERR_MASK	0x00000100 /**< Stale descriptor */
+#define SPDIF_DMA_SR_SGSLVERR_MASK	0x00000200 /**< SG slave error */
+#define SPDIF_DMA_SR_SGDECERR_MASK	0x00000400 /**< SG decode error */
+#define SPDIF_DMA_SR_ERR_ALL_MASK	0x00000770
+#define SPDIF_DMA_SR_IOC_IRQ_MASK	0x00001000 /**< Completion IRQ */
+#define SPDIF_DMA_SR_DLY_IRQ_MASK	0x00002000 /**< Delay timer IRQ */
+#define SPDIF_DMA_SR_ERR_IRQ_MASK	0x00004000 /**< Error IRQ */
+#define SPDIF_DMA_SR_IRQ_ALL_MASK	0x00007000
+/* @} */
+
+/** @name Descriptor word offsets
+ * @{
+ */
+#define SPDIF_DMA_BD_NXTDESC_OFFSET	0x00	/**< Next descriptor */
+#define SPDIF_DMA_BD_BUFA_OFFSET	0x08	/**< Buffer address */
+#define SPDIF_DMA_BD_CTRL_OFFSET	0x18	/**< Length, SOF, EOF */
+#define SPDIF_DMA_BD_STS_OFFSET		0x1C	/**< Written back by the DMA */
+/* @} */
+
+#define SPDIF_DMA_BD_SIZE		64	/**< Size and alignment */
+
+/** @name Descriptor control and status bits
+ * @{
+ */
+#define SPDIF_DMA_BD_LENGTH_MASK	0x000FFFFF /**< C_SG_LENGTH_WIDTH */
+#define SPDIF_DMA_BD_CTRL_SOF_MASK	0x08000000 /**< Start of frame */
+#define SPDIF_DMA_BD_CTRL_EOF_MASK	0x04000000 /**< End of frame */
+#define SPDIF_DMA_BD_STS_CMPLT_MASK	0x80000000 /**< Completed */
+#define SPDIF_DMA_BD_STS_ERR_MASK	0x70000000 /**< Dec, slave, int */
+/* @} */
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define SpdifDma_ReadReg(BaseAddress, RegOffset) \
+	Xil_In32((BaseAddress) + (RegOffset))
+
+#define SpdifDma_WriteReg(BaseAddress, RegOffset, Data) \
+	Xil_Out32((BaseAddress) + (RegOffset), (Data))
+
+/*
+ * Descriptors live in DDR, they are accessed through Xil_In32/Xil_Out32 as
+ * well so the ring can be linked against a host model of the engine
+ */
+#define SpdifDma_BdRead(BdAddr, Offset) \
+	Xil_In32((BdAddr) + (Offset))
+
+#define SpdifDma_BdWrite(BdAddr, Offset, Data) \
+	Xil_Out32((BdAddr) + (Offset), (Data))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPDIF_DMA_L_H */
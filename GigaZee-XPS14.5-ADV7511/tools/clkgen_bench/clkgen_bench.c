@@ -0,0 +1,227 @@
+/******************************************************************************
+*
+* clkgen_bench.c
+*
+* Host benchmark of the axi_clkgen MMCM solver. For every standard mode it
+* prints the solved D, M and O, the error, and the time of Clkgen_MmcmSolve,
+* checks the solution against an exhaustive search over all D, M and O, and
+* compares the cold Clkgen_SetMode (solve and program) with the memoized one
+* (lookup and program) against a register model of the core. A sweep over
+* the output range gives the worst case solver time.
+*
+* Build: gcc -O2 -I../../drivers/axi_clkgen_v1_00_a/src -I<bsp include>
+*	 clkgen_bench.c ../../drivers/axi_clkgen_v1_00_a/src/clkgen.c
+*	 ../../drivers/axi_clkgen_v1_00_a/src/clkgen_mmcm.c -o clkgen_bench
+*
+* Usage: clkgen_bench [<ref_clk Hz>]
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "clkgen.h"
+
+#define SOLVE_LOOPS		1000
+#define PROGRAM_LOOPS		100000
+#define SWEEP_MIN		10000000
+#define SWEEP_STEP		100000
+
+/*
+ * Register model of the core: the status reports the MMCM in reset once
+ * after a start, locked otherwise.
+ */
+static u32 Regs[32];
+static int Started;
+
+unsigned int Xil_AssertStatus;
+
+void Xil_Assert(const char *File, int Line)
+{
+	fprintf(stderr, "assert %s:%d\n", File, Line);
+	exit(1);
+}
+
+u32 Xil_In32(u32 Addr)
+{
+	if ((Addr & 0x7F) == CLKGEN_STATUS_OFFSET) {
+		if (Started) {
+			Started = 0;
+			return CLKGEN_STATUS_RST_MASK;
+		}
+		return CLKGEN_STATUS_LOCKED_MASK;
+	}
+	return Regs[(Addr & 0x7F) / 4];
+}
+
+void Xil_Out32(u32 Addr, u32 Value)
+{
+	if (((Addr & 0x7F) == CLKGEN_CTRL_OFFSET) &&
+	    ((Value & CLKGEN_CTRL_START_MASK) != 0)) {
+		Started = 1;
+	}
+	Regs[(Addr & 0x7F) / 4] = Value;
+}
+
+static double Now(void)
+{
+	struct timespec Ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+	return Ts.tv_sec * 1e9 + Ts.tv_nsec;
+}
+
+/*
+ * Smallest error in Hz over all D, M and O within the MMCM limits
+ */
+static double Exhaustive(u32 RefHz, u32 RateHz)
+{
+	double Best = 1e18;
+	double Pfd, Vco, Err;
+	u32 D, M, O;
+
+	for (D = 1; D <= CLKGEN_MMCM_DIV_MAX; D++) {
+		Pfd = (double)RefHz / D;
+		if ((Pfd < CLKGEN_MMCM_PFD_MIN) ||
+		    (Pfd > CLKGEN_MMCM_PFD_MAX)) {
+			continue;
+		}
+		for (M = CLKGEN_MMCM_MULT_MIN; M <= CLKGEN_MMCM_MULT_MAX;
+		     M++) {
+			Vco = Pfd * M;
+			if ((Vco < CLKGEN_MMCM_VCO_MIN) ||
+			    (Vco > CLKGEN_MMCM_VCO_MAX)) {
+				continue;
+			}
+			for (O = 1; O <= CLKGEN_MMCM_OUT_DIV_MAX; O++) {
+				Err = Vco / O - RateHz;
+				if (Err < 0) {
+					Err = -Err;
+				}
+				if (Err < Best) {
+					Best = Err;
+				}
+			}
+		}
+	}
+
+	return Best;
+}
+
+int main(int argc, char **argv)
+{
+	Clkgen Inst;
+	Clkgen_Setting Setting;
+	u32 RefHz = CLKGEN_REF_HZ;
+	u32 Mode, Rate, Loop;
+	double T0, Ns, Err, Ref, Total = 0, Worst = 0, Cold, Warm;
+	double WorstPpm = 0;
+	u32 WorstRate = 0, Fails = 0, Count = 0;
+
+	if (argc > 1) {
+		RefHz = strtoul(argv[1], NULL, 0);
+	}
+	if (Clkgen_CfgInitialize(&Inst, CLKGEN_BASEADDR, RefHz) !=
+	    XST_SUCCESS) {
+		fprintf(stderr, "ref_clk %u Hz out of range\n",
+			(unsigned)RefHz);
+		return 1;
+	}
+
+	printf("ref_clk %u Hz\n\n", (unsigned)RefHz);
+	printf("mode  request Hz    D  M   O   VCO MHz  rate Hz       "
+	       "error ppm  solve ns\n");
+
+	for (Mode = 0; Mode < CLKGEN_NUM_MODES; Mode++) {
+		Rate = Clkgen_ModeRate(Mode);
+
+		T0 = Now();
+		for (Loop = 0; Loop < SOLVE_LOOPS; Loop++) {
+			if (Clkgen_MmcmSolve(RefHz, Rate, &Setting) !=
+			    XST_SUCCESS) {
+				break;
+			}
+		}
+		Ns = (Now() - T0) / SOLVE_LOOPS;
+		Total += Ns;
+
+		if (Loop != SOLVE_LOOPS) {
+			printf("%4u  %10u  no solution\n", (unsigned)Mode,
+			       (unsigned)Rate);
+			Fails++;
+			continue;
+		}
+
+		Err = (double)RefHz * Setting.Mult /
+		      ((double)Setting.Div * Setting.OutDiv) - Rate;
+		Ref = Exhaustive(RefHz, Rate);
+		if ((Err < 0 ? -Err : Err) > Ref + 1e-6) {
+			Fails++;
+		}
+
+		printf("%4u  %10u  %3u %2u %3u  %8.3f  %10u  %+9.3f  %8.0f%s\n",
+		       (unsigned)Mode, (unsigned)Rate, (unsigned)Setting.Div,
+		       (unsigned)Setting.Mult, (unsigned)Setting.OutDiv,
+		       (double)RefHz * Setting.Mult / Setting.Div / 1e6,
+		       (unsigned)Setting.RateHz, Err * 1e6 / Rate, Ns,
+		       (Err < 0 ? -Err : Err) > Ref + 1e-6 ?
+		       "  NOT OPTIMAL" : "");
+	}
+
+	printf("\nsolve, all %u modes: %.1f us\n", CLKGEN_NUM_MODES,
+	       Total / 1e3);
+
+	/* Cold: solve and program, warm: memoized lookup and program */
+	T0 = Now();
+	for (Mode = 0; Mode < CLKGEN_NUM_MODES; Mode++) {
+		Clkgen_SetMode(&Inst, Mode);
+	}
+	Cold = (Now() - T0) / CLKGEN_NUM_MODES;
+
+	T0 = Now();
+	for (Loop = 0; Loop < PROGRAM_LOOPS; Loop++) {
+		Clkgen_SetMode(&Inst, Loop % CLKGEN_NUM_MODES);
+	}
+	Warm = (Now() - T0) / PROGRAM_LOOPS;
+
+	printf("mode switch, cold: %.0f ns, memoized: %.0f ns\n", Cold, Warm);
+
+	for (Rate = SWEEP_MIN; Rate <= CLKGEN_MMCM_OUT_MAX;
+	     Rate += SWEEP_STEP) {
+		T0 = Now();
+		if (Clkgen_MmcmSolve(RefHz, Rate, &Setting) != XST_SUCCESS) {
+			Fails++;
+			continue;
+		}
+		Ns = Now() - T0;
+		if (Ns > Worst) {
+			Worst = Ns;
+		}
+		Err = (double)RefHz * Setting.Mult /
+		      ((double)Setting.Div * Setting.OutDiv) - Rate;
+		Err = (Err < 0 ? -Err : Err) * 1e6 / Rate;
+		if (Err > WorstPpm) {
+			WorstPpm = Err;
+			WorstRate = Rate;
+		}
+		Count++;
+	}
+
+	printf("sweep %u to %u Hz, %u rates: worst solve %.0f ns, "
+	       "worst error %.1f ppm at %u Hz\n", SWEEP_MIN,
+	       CLKGEN_MMCM_OUT_MAX, (unsigned)Count, Worst, WorstPpm,
+	       (unsigned)WorstRate);
+
+	if (Fails != 0) {
+		printf("%u failures\n", (unsigned)Fails);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,168 @@
+/******************************************************************************
+*
+* arm_neon.h
+*
+* Host versions of the NEON intrinsics hdmi_tx_csc.c uses, so that its NEON
+* kernel builds and runs on a host without NEON. Each one follows the
+* operation of the ARM reference: lanes wrap like the integer instruction,
+* the saturating forms clamp to the range of the result lane.
+*
+* csc_neon.c defines HDMI_CSC_NEON_HOST before it includes the kernel, any
+* other user and any ARM build get the compiler's arm_neon.h.
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+*
+******************************************************************************/
+
+#ifndef HDMI_CSC_NEON_HOST
+#include_next <arm_neon.h>
+#else
+
+#ifndef HDMI_CSC_ARM_NEON_H
+#define HDMI_CSC_ARM_NEON_H
+
+#include <stdint.h>
+
+typedef struct { uint8_t v[8]; } uint8x8_t;
+typedef struct { uint8x8_t val[4]; } uint8x8x4_t;
+typedef struct { uint16_t v[4]; } uint16x4_t;
+typedef struct { uint16_t v[8]; } uint16x8_t;
+typedef struct { int16_t v[4]; } int16x4_t;
+typedef struct { int16_t v[8]; } int16x8_t;
+typedef struct { int32_t v[4]; } int32x4_t;
+
+static inline uint8x8x4_t vld4_u8(const uint8_t *Ptr)
+{
+	uint8x8x4_t R;
+	int I, J;
+
+	for (I = 0; I < 8; I++)
+		for (J = 0; J < 4; J++)
+			R.val[J].v[I] = Ptr[I * 4 + J];
+	return R;
+}
+
+static inline void vst4_u8(uint8_t *Ptr, uint8x8x4_t A)
+{
+	int I, J;
+
+	for (I = 0; I < 8; I++)
+		for (J = 0; J < 4; J++)
+			Ptr[I * 4 + J] = A.val[J].v[I];
+}
+
+static inline uint16x8_t vmovl_u8(uint8x8_t A)
+{
+	uint16x8_t R;
+	int I;
+
+	for (I = 0; I < 8; I++)
+		R.v[I] = A.v[I];
+	return R;
+}
+
+static inline int16x8_t vreinterpretq_s16_u16(uint16x8_t A)
+{
+	int16x8_t R;
+	int I;
+
+	for (I = 0; I < 8; I++)
+		R.v[I] = (int16_t)A.v[I];
+	return R;
+}
+
+static inline int16x4_t vget_low_s16(int16x8_t A)
+{
+	int16x4_t R;
+	int I;
+
+	for (I = 0; I < 4; I++)
+		R.v[I] = A.v[I];
+	return R;
+}
+
+static inline int16x4_t vget_high_s16(int16x8_t A)
+{
+	int16x4_t R;
+	int I;
+
+	for (I = 0; I < 4; I++)
+		R.v[I] = A.v[I + 4];
+	return R;
+}
+
+static inline int32x4_t vdupq_n_s32(int32_t A)
+{
+	int32x4_t R;
+	int I;
+
+	for (I = 0; I < 4; I++)
+		R.v[I] = A;
+	return R;
+}
+
+static inline uint8x8_t vdup_n_u8(uint8_t A)
+{
+	uint8x8_t R;
+	int I;
+
+	for (I = 0; I < 8; I++)
+		R.v[I] = A;
+	return R;
+}
+
+/* VMLAL.S16, wraps in the 32 bit lane */
+static inline int32x4_t vmlal_n_s16(int32x4_t A, int16x4_t B, int16_t C)
+{
+	int32x4_t R;
+	int I;
+
+	for (I = 0; I < 4; I++)
+		R.v[I] = (int32_t)((uint32_t)A.v[I] +
+				   (uint32_t)((int32_t)B.v[I] * C));
+	return R;
+}
+
+/* VQSHRUN.S32, arithmetic shift, clamped to 0..65535 */
+static inline uint16x4_t vqshrun_n_s32(int32x4_t A, int N)
+{
+	uint16x4_t R;
+	int32_t S;
+	int I;
+
+	for (I = 0; I < 4; I++) {
+		S = A.v[I] >> N;
+		R.v[I] = (S < 0) ? 0 : (S > 0xFFFF) ? 0xFFFF : S;
+	}
+	return R;
+}
+
+static inline uint16x8_t vcombine_u16(uint16x4_t Lo, uint16x4_t Hi)
+{
+	uint16x8_t R;
+	int I;
+
+	for (I = 0; I < 4; I++) {
+		R.v[I] = Lo.v[I];
+		R.v[I + 4] = Hi.v[I];
+	}
+	return R;
+}
+
+/* VQMOVN.U16, clamped to 255 */
+static inline uint8x8_t vqmovn_u16(uint16x8_t A)
+{
+	uint8x8_t R;
+	int I;
+
+	for (I = 0; I < 8; I++)
+		R.v[I] = (A.v[I] > 0xFF) ? 0xFF : A.v[I];
+	return R;
+}
+
+#endif /* HDMI_CSC_ARM_NEON_H */
+#endif /* HDMI_CSC_NEON_HOST */
@@ -0,0 +1,39 @@
+/******************************************************************************
+*
+* csc_neon.c
+*
+* NEON build of hdmi_tx_csc.c for hdmi_csc_sim, its functions are renamed
+* to HdmiTxNeon_*. On a host without NEON the intrinsics come from the
+* arm_neon.h of this directory.
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+*
+******************************************************************************/
+
+/*
+ * 32 bit types of the target, xil_types.h leaves them out when
+ * XBASIC_TYPES_H is defined
+ */
+#define XBASIC_TYPES_H
+typedef unsigned char u8;
+typedef unsigned short u16;
+typedef unsigned int u32;
+
+#if !defined(__ARM_NEON__) && !defined(__ARM_NEON)
+#define __ARM_NEON 1
+#define HDMI_CSC_NEON_HOST
+#endif
+
+#define HdmiTx_ModelInit	HdmiTxNeon_ModelInit
+#define HdmiTx_ModelLine	HdmiTxNeon_ModelLine
+#define HdmiTx_ModelFrame	HdmiTxNeon_ModelFrame
+#define HdmiTx_CscPixel		HdmiTxNeon_CscPixel
+#define HdmiTx_CscLine		HdmiTxNeon_CscLine
+#define HdmiTx_CscLineScalar	HdmiTxNeon_CscLineScalar
+#define HdmiTx_SubsampleLine	HdmiTxNeon_SubsampleLine
+
+#include "hdmi_tx_csc.c"
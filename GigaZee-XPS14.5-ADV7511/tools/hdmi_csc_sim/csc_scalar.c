@@ -0,0 +1,38 @@
+/******************************************************************************
+*
+* csc_scalar.c
+*
+* Build of hdmi_tx_csc.c without vector kernels for hdmi_csc_sim, its
+* functions are renamed to HdmiTxScalar_*. It is the model a target
+* without NEON runs.
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+*
+******************************************************************************/
+
+/*
+ * 32 bit types of the target, xil_types.h leaves them out when
+ * XBASIC_TYPES_H is defined
+ */
+#define XBASIC_TYPES_H
+typedef unsigned char u8;
+typedef unsigned short u16;
+typedef unsigned int u32;
+
+#undef __ARM_NEON__
+#undef __ARM_NEON
+#undef __SSE2__
+
+#define HdmiTx_ModelInit	HdmiTxScalar_ModelInit
+#define HdmiTx_ModelLine	HdmiTxScalar_ModelLine
+#define HdmiTx_ModelFrame	HdmiTxScalar_ModelFrame
+#define HdmiTx_CscPixel		HdmiTxScalar_CscPixel
+#define HdmiTx_CscLine		HdmiTxScalar_CscLine
+#define HdmiTx_CscLineScalar	HdmiTxScalar_CscLineScalar
+#define HdmiTx_SubsampleLine	HdmiTxScalar_SubsampleLine
+
+#include "hdmi_tx_csc.c"
@@ -0,0 +1,326 @@
+/******************************************************************************
+*
+* hdmi_csc_sim.c
+*
+* Host check and benchmark of the color pipeline model hdmi_tx_csc.c. The
+* model is built three times: for the host with its vector kernel (SSE2 on
+* x86, NEON on ARM), with the NEON kernel (csc_neon.c, on a host without
+* NEON through the intrinsics of arm_neon.h in this directory) and without
+* vector kernels (csc_scalar.c).
+*
+* The check compares with HdmiTx_CscLineScalar, the reference:
+*   - HdmiTx_CscLine of every build for all 2^24 RGB values, with random
+*     bits [31:24] the core ignores,
+*   - every build for all line lengths up to 64, unaligned and in place,
+*   - HdmiTx_ModelFrame of every build for a random 1080p frame with a
+*     padded stride, for both crcb_init values and with csc_bypass, against
+*     the reference CSC and HdmiTx_SubsampleLine line by line.
+* Reported are the 1080p times of the CSC and of the whole model, with the
+* host vector kernel and without vector kernels. The emulated NEON kernel
+* is checked, not timed.
+*
+* Build: gcc -O2 -I. -I../../drivers/axi_hdmi_tx_12b_v1_00_b/src
+*	 -I<bsp include> hdmi_csc_sim.c csc_neon.c csc_scalar.c
+*	 -o hdmi_csc_sim
+*
+* Usage: hdmi_csc_sim [<loops>]
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * 32 bit types of the target, xil_types.h leaves them out when
+ * XBASIC_TYPES_H is defined
+ */
+#define XBASIC_TYPES_H
+typedef unsigned char u8;
+typedef unsigned short u16;
+typedef unsigned int u32;
+
+#include "hdmi_tx_csc.c"
+
+#if defined(HDMI_TX_CSC_NEON)
+#define NATIVE_KERNEL	"NEON"
+#elif defined(HDMI_TX_CSC_SSE2)
+#define NATIVE_KERNEL	"SSE2"
+#else
+#define NATIVE_KERNEL	"C"
+#endif
+
+#define FRAME_WIDTH	1920
+#define FRAME_HEIGHT	1080
+#define FRAME_STRIDE	2048
+#define CHUNK		4096
+#define MAX_LEN		64
+#define BENCH_LOOPS	20
+
+typedef void CscLineFunc(const u32 *SrcPtr, u32 *DstPtr, u32 Width);
+typedef void ModelFrameFunc(HdmiTx_Model *ModelPtr, const u32 *SrcPtr,
+			    u32 SrcStride, u32 Width, u32 Height,
+			    u16 *DstPtr);
+
+/*
+ * Functions of csc_neon.c and csc_scalar.c
+ */
+void HdmiTxNeon_ModelInit(HdmiTx_Model *ModelPtr, u32 CscBypass,
+			  u32 CrCbInit);
+void HdmiTxNeon_ModelFrame(HdmiTx_Model *ModelPtr, const u32 *SrcPtr,
+			   u32 SrcStride, u32 Width, u32 Height, u16 *DstPtr);
+void HdmiTxNeon_CscLine(const u32 *SrcPtr, u32 *DstPtr, u32 Width);
+void HdmiTxScalar_ModelInit(HdmiTx_Model *ModelPtr, u32 CscBypass,
+			    u32 CrCbInit);
+void HdmiTxScalar_ModelFrame(HdmiTx_Model *ModelPtr, const u32 *SrcPtr,
+			     u32 SrcStride, u32 Width, u32 Height,
+			     u16 *DstPtr);
+void HdmiTxScalar_CscLine(const u32 *SrcPtr, u32 *DstPtr, u32 Width);
+
+static const struct {
+	const char *Name;
+	CscLineFunc *CscLine;
+	ModelFrameFunc *ModelFrame;
+} Builds[] = {
+	{ NATIVE_KERNEL, HdmiTx_CscLine, HdmiTx_ModelFrame },
+	{ "NEON", HdmiTxNeon_CscLine, HdmiTxNeon_ModelFrame },
+	{ "C", HdmiTxScalar_CscLine, HdmiTxScalar_ModelFrame },
+};
+
+#define NUM_BUILDS	(sizeof(Builds) / sizeof(Builds[0]))
+
+static double Seconds(void)
+{
+	struct timespec Ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+	return Ts.tv_sec + Ts.tv_nsec / 1e9;
+}
+
+static void *Alloc(u32 Bytes)
+{
+	void *Ptr = malloc(Bytes);
+
+	if (Ptr == NULL) {
+		fprintf(stderr, "no memory\n");
+		exit(1);
+	}
+	return Ptr;
+}
+
+/*
+ * All RGB values in lines of CHUNK pixels
+ */
+static int CheckAllValues(void)
+{
+	static u32 Src[CHUNK], Ref[CHUNK], Out[CHUNK];
+	u32 Build, Base, Index;
+	int Fail = 0;
+
+	for (Build = 0; Build < NUM_BUILDS; Build++) {
+		srand(1);
+		for (Base = 0; Base < (1 << 24); Base += CHUNK) {
+			for (Index = 0; Index < CHUNK; Index++) {
+				Src[Index] = (Base + Index) |
+					     ((u32)rand() << 24);
+			}
+			HdmiTx_CscLineScalar(Src, Ref, CHUNK);
+			memset(Out, 0xAA, sizeof(Out));
+			Builds[Build].CscLine(Src, Out, CHUNK);
+			if (memcmp(Out, Ref, sizeof(Ref)) != 0) {
+				printf("  %s CSC differs at RGB %06x\n",
+				       Builds[Build].Name, Base);
+				Fail = 1;
+				break;
+			}
+		}
+	}
+	return Fail;
+}
+
+/*
+ * Line lengths, alignments and in place conversion
+ */
+static int CheckLines(void)
+{
+	u32 Src[MAX_LEN + 8], Ref[MAX_LEN + 8], Out[MAX_LEN + 8];
+	u32 Build, Len, Offset, Index;
+	int Fail = 0;
+
+	srand(2);
+	for (Index = 0; Index < MAX_LEN + 8; Index++) {
+		Src[Index] = ((u32)rand() << 16) ^ rand();
+	}
+	for (Build = 0; Build < NUM_BUILDS; Build++) {
+		for (Len = 0; Len <= MAX_LEN; Len++) {
+			for (Offset = 0; Offset < 4; Offset++) {
+				memset(Ref, 0xAA, sizeof(Ref));
+				memset(Out, 0xAA, sizeof(Out));
+				HdmiTx_CscLineScalar(Src + Offset,
+						     Ref + 3 - Offset, Len);
+				Builds[Build].CscLine(Src + Offset,
+						      Out + 3 - Offset, Len);
+				if (memcmp(Out, Ref, sizeof(Ref)) != 0) {
+					Fail = 1;
+				}
+
+				memcpy(Out, Src, sizeof(Out));
+				Builds[Build].CscLine(Out + Offset,
+						      Out + Offset, Len);
+				if ((memcmp(Out + Offset, Ref + 3 - Offset,
+					    Len * 4) != 0) ||
+				    (memcmp(Out, Src, Offset * 4) != 0) ||
+				    (memcmp(Out + Offset + Len, Src + Offset + Len,
+					    (MAX_LEN + 8 - Offset - Len) * 4) != 0)) {
+					Fail = 1;
+				}
+			}
+		}
+		if (Fail) {
+			printf("  %s CSC differs for short lines\n",
+			       Builds[Build].Name);
+			break;
+		}
+	}
+	return Fail;
+}
+
+/*
+ * Reference output of a frame, CSC and sub sampler line by line
+ */
+static void RefFrame(const u32 *Frame, u32 CscBypass, u32 CrCbInit,
+		     u16 *Out)
+{
+	u32 Line[FRAME_WIDTH];
+	u32 Last = 0;
+	u32 Y, X;
+
+	for (Y = 0; Y < FRAME_HEIGHT; Y++) {
+		if (CscBypass) {
+			for (X = 0; X < FRAME_WIDTH; X++) {
+				Out[X] = (u16)Frame[X];
+			}
+		} else {
+			HdmiTx_CscLineScalar(Frame, Line, FRAME_WIDTH);
+			HdmiTx_SubsampleLine(Line, Out, FRAME_WIDTH, &Last,
+					     CrCbInit);
+		}
+		Frame += FRAME_STRIDE;
+		Out += FRAME_WIDTH;
+	}
+}
+
+static int CheckFrames(const u32 *Frame)
+{
+	static const u32 Modes[][2] = { { 0, 0 }, { 0, 1 }, { 1, 0 } };
+	u32 Pixels = FRAME_WIDTH * FRAME_HEIGHT;
+	u16 *Ref = Alloc(Pixels * 2);
+	u16 *Out = Alloc(Pixels * 2);
+	HdmiTx_Model Model;
+	u32 Build, Mode;
+	int Fail = 0;
+
+	for (Mode = 0; Mode < 3; Mode++) {
+		RefFrame(Frame, Modes[Mode][0], Modes[Mode][1], Ref);
+		for (Build = 0; Build < NUM_BUILDS; Build++) {
+			HdmiTx_ModelInit(&Model, Modes[Mode][0],
+					 Modes[Mode][1]);
+			memset(Out, 0xAA, Pixels * 2);
+			Builds[Build].ModelFrame(&Model, Frame, FRAME_STRIDE,
+						 FRAME_WIDTH, FRAME_HEIGHT,
+						 Out);
+			if (memcmp(Out, Ref, Pixels * 2) != 0) {
+				printf("  %s model differs, csc_bypass %u "
+				       "crcb_init %u\n", Builds[Build].Name,
+				       Modes[Mode][0], Modes[Mode][1]);
+				Fail = 1;
+			}
+		}
+	}
+
+	free(Ref);
+	free(Out);
+	return Fail;
+}
+
+/*
+ * 1080p times of the host kernel and of the C build
+ */
+static void Bench(const u32 *Frame, u32 Loops)
+{
+	static const u32 Timed[] = { 0, 2 };
+	u32 *Csc = Alloc(FRAME_WIDTH * 4);
+	u16 *Out = Alloc(FRAME_WIDTH * FRAME_HEIGHT * 2);
+	HdmiTx_Model Model;
+	double T0, T1, T2;
+	u32 Build, Loop, Y;
+
+	printf("%ux%u, %u loops\n", FRAME_WIDTH, FRAME_HEIGHT, Loops);
+	for (Build = 0; Build < 2; Build++) {
+		T0 = Seconds();
+		for (Loop = 0; Loop < Loops; Loop++) {
+			for (Y = 0; Y < FRAME_HEIGHT; Y++) {
+				Builds[Timed[Build]].CscLine(
+					Frame + Y * FRAME_STRIDE, Csc,
+					FRAME_WIDTH);
+			}
+		}
+		T1 = Seconds();
+		for (Loop = 0; Loop < Loops; Loop++) {
+			HdmiTx_ModelInit(&Model, 0, 0);
+			Builds[Timed[Build]].ModelFrame(&Model, Frame,
+							FRAME_STRIDE,
+							FRAME_WIDTH,
+							FRAME_HEIGHT, Out);
+		}
+		T2 = Seconds();
+		printf("  %-4s CSC %6.2f ms/frame %6.0f Mpixel/s, model "
+		       "%6.2f ms/frame %5.0f fps\n", Builds[Timed[Build]].Name,
+		       (T1 - T0) * 1e3 / Loops, (double)FRAME_WIDTH *
+		       FRAME_HEIGHT * Loops / (T1 - T0) / 1e6,
+		       (T2 - T1) * 1e3 / Loops, Loops / (T2 - T1));
+	}
+
+	free(Csc);
+	free(Out);
+}
+
+int main(int argc, char **argv)
+{
+	u32 *Frame;
+	u32 Loops = BENCH_LOOPS;
+	u32 Index;
+	int Fail = 0;
+
+	if (argc > 1) {
+		Loops = strtoul(argv[1], NULL, 0);
+	}
+	if (Loops == 0) {
+		fprintf(stderr, "usage: %s [<loops>]\n", argv[0]);
+		return 1;
+	}
+
+	Frame = Alloc(FRAME_STRIDE * FRAME_HEIGHT * 4);
+	srand(3);
+	for (Index = 0; Index < FRAME_STRIDE * FRAME_HEIGHT; Index++) {
+		Frame[Index] = ((u32)rand() << 16) ^ rand();
+	}
+
+	printf("host kernel %s\n", NATIVE_KERNEL);
+	Fail |= CheckAllValues();
+	Fail |= CheckLines();
+	Fail |= CheckFrames(Frame);
+	Bench(Frame, Loops);
+
+	printf("%s\n", Fail ? "FAILED" : "all kernels match the reference");
+
+	free(Frame);
+	return Fail;
+}
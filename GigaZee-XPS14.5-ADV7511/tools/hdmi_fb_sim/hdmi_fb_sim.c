@@ -0,0 +1,692 @@
+/******************************************************************************
+*
+* hdmi_fb_sim.c
+*
+* Host simulation of the frame buffer manager hdmi_fb.c. It runs the
+* manager against a register model of the axi_vdma read channel in park
+* mode and the status register of axi_hdmi_tx_12b on a virtual 1080p60
+* clock, with an application that draws and flips as fast as it can, for
+* two and three buffers and draw times below, around and above a frame.
+*
+* The model checks the register sequences: reset before any other access,
+* run in park mode with one frame count interrupt per frame before VSIZE,
+* all frame stores, HSIZE and STRIDE programmed before VSIZE starts the
+* channel and never while it runs, the park pointer only on a programmed
+* frame store, and every interrupt acknowledged before the next frame.
+* The frame interrupt is taken on any register access and at the end of
+* HdmiFb_Lock, so it preempts the manager wherever the IRQ is unmasked.
+*
+* The page flips must never tear (the VDMA never reads the buffer the
+* application draws), never show an older frame after a newer one, and
+* the statistics must match the frames the model displayed, dropped and
+* repeated, the flip to display latency and the injected HDMI and VDMA
+* errors. The buffer count and geometry checks of HdmiFb_CfgInitialize and
+* the reset timeout of HdmiFb_Start are checked as well.
+*
+* Build: gcc -O2 -I../../drivers/axi_hdmi_tx_12b_v1_00_b/src
+*	 -I<bsp include> hdmi_fb_sim.c -o hdmi_fb_sim
+*
+* Usage: hdmi_fb_sim [<frames>]
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+/*
+ * 32 bit types of the target, xil_types.h leaves them out when
+ * XBASIC_TYPES_H is defined
+ */
+#define XBASIC_TYPES_H
+typedef unsigned char u8;
+typedef unsigned short u16;
+typedef unsigned int u32;
+
+/*
+ * IRQ mask of the CPU, in place of xil_exception.h
+ */
+#define XIL_EXCEPTION_H
+#define XIL_EXCEPTION_IRQ		0x80
+#define Xil_ExceptionDisableMask(Mask)	IrqDisable(Mask)
+#define Xil_ExceptionEnableMask(Mask)	IrqEnable(Mask)
+
+static void IrqDisable(u32 Mask);
+static void IrqEnable(u32 Mask);
+
+#include "hdmi_fb.c"
+
+#define VDMA_BASE		HDMI_FB_VDMA_BASEADDR
+#define HDMI_BASE		HDMI_FB_HDMI_BASEADDR
+#define REGION_SIZE		0x10000
+#define NUM_FSTORES		HDMI_FB_NUM_FSTORES
+
+#define AXI_ACCESS_NS		100
+#define FRAME_NS		16666667.0	/* 1080p60, 1125 lines */
+#define ACTIVE_NS		(FRAME_NS * 1080 / 1125)
+#define FSYNC_DELAY_NS		1000		/* Run to first frame */
+#define POLL_NS			100000		/* Busy application */
+#define RESET_POLLS		3
+#define NUM_FRAMES		600
+#define SETTLE_FRAMES		3
+#define MAX_MESSAGES		8
+
+#define FB_WIDTH		1920
+#define FB_HEIGHT		1080
+#define FB_STRIDE		8192
+#define FB_ADDR(n)		(0x01000000 + (n) * 0x00800000)
+
+/*
+ * Register model of the VDMA read channel and the HDMI status
+ */
+static u32 Vdma[REGION_SIZE / 4];
+static u32 HdmiStatus;
+static u32 ResetPolls;
+static int ResetStuck;
+static int Running;
+static int Reading;		/* Transfer of Store in progress */
+static u32 Store;		/* Frame store read last or now */
+static u32 PrevStore;		/* Store of the frame before */
+
+/*
+ * Virtual clock in ns and CPU interrupt state
+ */
+static double Now;
+static double NextFsync, NextEnd;
+static int Masked;
+static int InIrq;
+static int Raised;
+static int Connected;
+
+/*
+ * Application and what the model saw of its buffers
+ */
+static HdmiFb Fb;
+static u32 NumBuffers;
+static int InjectErrors;
+static u32 Drawing;
+static u32 Content[HDMI_FB_MAX_BUFFERS];
+static int Pending[HDMI_FB_MAX_BUFFERS];
+static u32 FlipFrame[HDMI_FB_MAX_BUFFERS];
+static u32 LastShown;
+static u32 Sequence;
+
+/*
+ * Expected statistics and errors found
+ */
+static HdmiFb_Stats Expect;
+static u32 FramesRaised;
+static u32 Delivered;
+static u32 Tears;
+static u32 Errors;
+
+unsigned int Xil_AssertStatus;
+
+void Xil_Assert(const char *File, int Line)
+{
+	fprintf(stderr, "assert %s:%d\n", File, Line);
+	exit(1);
+}
+
+static void Error(const char *Format, ...)
+{
+	va_list Args;
+
+	if (Errors++ < MAX_MESSAGES) {
+		printf("  %8.3f ms: ", Now / 1e6);
+		va_start(Args, Format);
+		vprintf(Format, Args);
+		va_end(Args);
+		printf("\n");
+	}
+}
+
+/*
+ * Frame sync: the VDMA starts reading the frame store the park pointer
+ * names
+ */
+static void FrameSync(void)
+{
+	Store = Vdma[HDMI_VDMA_PARK_OFFSET / 4] & HDMI_VDMA_PARK_REF_MASK;
+	Reading = 1;
+	NextEnd = Now + ACTIVE_NS;
+	NextFsync = Now + FRAME_NS;
+
+	if (Store == Drawing) {
+		Tears++;
+		Error("VDMA reads buffer %u while it is drawn", Store);
+	}
+	if (Content[Store] < LastShown) {
+		Error("frame %u shown after frame %u", Content[Store],
+		      LastShown);
+	}
+	LastShown = Content[Store];
+}
+
+/*
+ * End of the frame transfer: frame count interrupt, injected errors
+ */
+static void FrameEnd(void)
+{
+	u32 Latency;
+
+	Reading = 0;
+	NextEnd = 1e300;
+	FramesRaised++;
+
+	if ((Vdma[HDMI_VDMA_SR_OFFSET / 4] & HDMI_VDMA_SR_IRQ_ALL_MASK) != 0) {
+		Error("VDMA interrupt of the last frame not acknowledged");
+	}
+	if (HdmiStatus != 0) {
+		Error("HDMI status 0x%02x not cleared", HdmiStatus);
+	}
+	Vdma[HDMI_VDMA_SR_OFFSET / 4] |= HDMI_VDMA_SR_FRMCNT_IRQ_MASK;
+
+	if (Pending[Store]) {
+		Pending[Store] = 0;
+		Latency = Delivered + 1 - FlipFrame[Store];
+		Expect.Displayed++;
+		Expect.LastLatency = Latency;
+		Expect.TotalLatency += Latency;
+		if (Latency > Expect.MaxLatency) {
+			Expect.MaxLatency = Latency;
+		}
+	}
+	if (Store == PrevStore) {
+		Expect.Repeated++;
+	}
+	PrevStore = Store;
+
+	if (InjectErrors) {
+		if ((FramesRaised % 5) == 0) {
+			HdmiStatus |= HDMI_TX_STATUS_VDMA_UNF_MASK;
+			Expect.Underflows++;
+		}
+		if ((FramesRaised % 11) == 0) {
+			HdmiStatus |= HDMI_TX_STATUS_VDMA_OVF_MASK;
+			Expect.Overflows++;
+		}
+		if ((FramesRaised % 13) == 0) {
+			HdmiStatus |= HDMI_TX_STATUS_HDMI_TPM_OOS_MASK;
+			Expect.TpmOos++;
+		}
+		if ((FramesRaised % 17) == 0) {
+			HdmiStatus |= HDMI_TX_STATUS_VDMA_BE_ERROR_MASK;
+			Expect.BeErrors++;
+		}
+		if ((FramesRaised % 19) == 0) {
+			Vdma[HDMI_VDMA_SR_OFFSET / 4] |=
+				HDMI_VDMA_SR_ERR_IRQ_MASK;
+			Expect.VdmaErrors++;
+		}
+	}
+	Raised = 1;
+}
+
+/*
+ * Take a raised interrupt unless the IRQ is masked
+ */
+static void Deliver(void)
+{
+	if (Raised && Connected && !Masked && !InIrq) {
+		Raised = 0;
+		InIrq = 1;
+		HdmiFb_IntrHandler(&Fb);
+		InIrq = 0;
+	}
+}
+
+static void Advance(double Ns)
+{
+	double End = Now + Ns;
+
+	while ((NextFsync <= End) || (NextEnd <= End)) {
+		if (NextEnd <= NextFsync) {
+			Now = NextEnd;
+			FrameEnd();
+		} else {
+			Now = NextFsync;
+			FrameSync();
+		}
+		Deliver();
+	}
+	Now = End;
+	Deliver();
+}
+
+static void IrqDisable(u32 Mask)
+{
+	if ((Mask != XIL_EXCEPTION_IRQ) || Masked) {
+		Error("IRQ mask 0x%x, masked %d", Mask, Masked);
+	}
+	Masked = 1;
+}
+
+static void IrqEnable(u32 Mask)
+{
+	if ((Mask != XIL_EXCEPTION_IRQ) || !Masked) {
+		Error("IRQ unmask 0x%x, masked %d", Mask, Masked);
+	}
+	Masked = 0;
+	Deliver();
+}
+
+static void Stop(void)
+{
+	Running = 0;
+	Reading = 0;
+	NextFsync = 1e300;
+	NextEnd = 1e300;
+}
+
+u32 Xil_In32(u32 Addr)
+{
+	u32 Off;
+
+	Advance(AXI_ACCESS_NS);
+
+	if ((Addr & ~(REGION_SIZE - 1)) == VDMA_BASE) {
+		Off = Addr - VDMA_BASE;
+		if (Off == HDMI_VDMA_CR_OFFSET) {
+			if (ResetStuck) {
+				return HDMI_VDMA_CR_RESET_MASK;
+			}
+			if ((ResetPolls != 0) && (--ResetPolls != 0)) {
+				return HDMI_VDMA_CR_RESET_MASK;
+			}
+			return Vdma[Off / 4];
+		}
+		if ((ResetPolls != 0) || ResetStuck) {
+			Error("VDMA register 0x%02x read in reset", Off);
+		}
+		if (Off == HDMI_VDMA_SR_OFFSET) {
+			return Vdma[Off / 4] |
+			       (Running ? 0 : HDMI_VDMA_SR_HALTED_MASK);
+		}
+		if (Off == HDMI_VDMA_PARK_OFFSET) {
+			return (Vdma[Off / 4] & HDMI_VDMA_PARK_REF_MASK) |
+			       (Store << HDMI_VDMA_PARK_STORE_SHIFT);
+		}
+		return Vdma[Off / 4];
+	}
+	if (Addr == HDMI_BASE + HDMI_TX_STATUS_OFFSET) {
+		return HdmiStatus;
+	}
+
+	Error("read of 0x%08x", Addr);
+	return 0;
+}
+
+static void VdmaWrite(u32 Off, u32 Value)
+{
+	u32 Index;
+
+	if (Off == HDMI_VDMA_CR_OFFSET) {
+		if ((Value & HDMI_VDMA_CR_RESET_MASK) != 0) {
+			memset(Vdma, 0, sizeof(Vdma));
+			Stop();
+			ResetPolls = RESET_POLLS;
+			return;
+		}
+		if ((Value & HDMI_VDMA_CR_RUNSTOP_MASK) == 0) {
+			Stop();
+		} else {
+			if ((Value & HDMI_VDMA_CR_CIRCULAR_MASK) != 0) {
+				Error("VDMA not in park mode");
+			}
+			if ((Value & HDMI_VDMA_CR_FRMCNT_EN_MASK) != 0) {
+				Error("VDMA frame count enable halts it");
+			}
+			if (((Value & HDMI_VDMA_CR_FRMCNT_IRQ_MASK) == 0) ||
+			    ((Value >> HDMI_VDMA_CR_IRQ_FRMCNT_SHIFT &
+			      0xFF) != 1)) {
+				Error("no interrupt per frame, CR 0x%08x",
+				      Value);
+			}
+		}
+		Vdma[Off / 4] = Value;
+		return;
+	}
+
+	if ((ResetPolls != 0) || ResetStuck) {
+		Error("VDMA register 0x%02x written in reset", Off);
+	}
+
+	if (Off == HDMI_VDMA_SR_OFFSET) {
+		if ((Value & ~HDMI_VDMA_SR_IRQ_ALL_MASK) != 0) {
+			Error("VDMA status written with 0x%08x", Value);
+		}
+		Vdma[Off / 4] &= ~(Value & HDMI_VDMA_SR_IRQ_ALL_MASK);
+	} else if (Off == HDMI_VDMA_PARK_OFFSET) {
+		Index = Value & HDMI_VDMA_PARK_REF_MASK;
+		if ((Value != Index) || (Index >= NUM_FSTORES) ||
+		    (Vdma[HDMI_VDMA_ADDR_OFFSET(Index) / 4] == 0 &&
+		     Running)) {
+			Error("park pointer 0x%08x", Value);
+		}
+		Vdma[Off / 4] = Value;
+	} else if ((Off == HDMI_VDMA_HSIZE_OFFSET) ||
+		   (Off == HDMI_VDMA_STRIDE_OFFSET) ||
+		   ((Off >= HDMI_VDMA_ADDR_OFFSET(0)) &&
+		    (Off < HDMI_VDMA_ADDR_OFFSET(HDMI_VDMA_MAX_FRAMES)))) {
+		if (Running) {
+			Error("VDMA register 0x%02x written while running",
+			      Off);
+		}
+		Vdma[Off / 4] = Value;
+	} else if (Off == HDMI_VDMA_VSIZE_OFFSET) {
+		if ((Vdma[HDMI_VDMA_CR_OFFSET / 4] &
+		     HDMI_VDMA_CR_RUNSTOP_MASK) == 0) {
+			Error("VSIZE written before run");
+		}
+		for (Index = 0; Index < NumBuffers; Index++) {
+			if (Vdma[HDMI_VDMA_ADDR_OFFSET(Index) / 4] !=
+			    FB_ADDR(Index)) {
+				Error("frame store %u at 0x%08x", Index,
+				      Vdma[HDMI_VDMA_ADDR_OFFSET(Index) / 4]);
+			}
+		}
+		if ((Vdma[HDMI_VDMA_HSIZE_OFFSET / 4] != FB_WIDTH * 4) ||
+		    (Vdma[HDMI_VDMA_STRIDE_OFFSET / 4] != FB_STRIDE) ||
+		    (Value != FB_HEIGHT)) {
+			Error("geometry %u x %u, stride 0x%08x",
+			      Vdma[HDMI_VDMA_HSIZE_OFFSET / 4], Value,
+			      Vdma[HDMI_VDMA_STRIDE_OFFSET / 4]);
+		}
+		if (Vdma[HDMI_VDMA_PARK_OFFSET / 4] != 0) {
+			Error("VDMA starts on frame store %u",
+			      Vdma[HDMI_VDMA_PARK_OFFSET / 4]);
+		}
+		Vdma[Off / 4] = Value;
+		if (!Running) {
+			Running = 1;
+			NextFsync = Now + FSYNC_DELAY_NS;
+		}
+	} else {
+		Error("write of VDMA register 0x%02x", Off);
+	}
+}
+
+void Xil_Out32(u32 Addr, u32 Value)
+{
+	Advance(AXI_ACCESS_NS);
+
+	if ((Addr & ~(REGION_SIZE - 1)) == VDMA_BASE) {
+		VdmaWrite(Addr - VDMA_BASE, Value);
+	} else if (Addr == HDMI_BASE + HDMI_TX_STATUS_OFFSET) {
+		if ((Value & ~HDMI_TX_STATUS_ALL_MASK) != 0) {
+			Error("HDMI status written with 0x%08x", Value);
+		}
+		HdmiStatus &= ~Value;
+	} else {
+		Error("write of 0x%08x", Addr);
+	}
+}
+
+/*
+ * Frame callback, Index must be the buffer of the frame just read
+ */
+static void FrameDone(void *CallBackRef, u32 Index)
+{
+	(void)CallBackRef;
+
+	Delivered++;
+	if (Index != Store) {
+		Error("callback for buffer %u, VDMA read %u", Index, Store);
+	}
+}
+
+static void ResetModel(void)
+{
+	memset(Vdma, 0, sizeof(Vdma));
+	memset(Content, 0, sizeof(Content));
+	memset(Pending, 0, sizeof(Pending));
+	memset(&Expect, 0, sizeof(Expect));
+	HdmiStatus = 0;
+	ResetPolls = 0;
+	ResetStuck = 0;
+	Store = 0;
+	PrevStore = 0;
+	Masked = 0;
+	Raised = 0;
+	Connected = 0;
+	Drawing = HDMI_FB_NONE;
+	LastShown = 0;
+	Sequence = 0;
+	FramesRaised = 0;
+	Delivered = 0;
+	Tears = 0;
+	Errors = 0;
+	Now = 0;
+	Stop();
+}
+
+static int Init(u32 Buffers, u32 Width, u32 Stride, u32 Align)
+{
+	static const HdmiFb_Config Config = {
+		VDMA_BASE, HDMI_BASE, NUM_FSTORES
+	};
+	u32 Addr[HDMI_FB_MAX_BUFFERS];
+	u32 Index;
+
+	for (Index = 0; Index < HDMI_FB_MAX_BUFFERS; Index++) {
+		Addr[Index] = FB_ADDR(Index) + Align;
+	}
+	return HdmiFb_CfgInitialize(&Fb, &Config, Addr, Buffers, Width,
+				    FB_HEIGHT, Stride);
+}
+
+/*
+ * Parameter checks and the reset timeout
+ */
+static int CheckConfig(void)
+{
+	static const struct {
+		u32 Buffers, Width, Stride, Align;
+		int Status;
+	} Cases[] = {
+		{ 1, FB_WIDTH, FB_STRIDE, 0, XST_INVALID_PARAM },
+		{ 2, FB_WIDTH, FB_STRIDE, 0, XST_SUCCESS },
+		{ 3, FB_WIDTH, FB_STRIDE, 0, XST_SUCCESS },
+		{ 4, FB_WIDTH, FB_STRIDE, 0, XST_INVALID_PARAM },
+		{ 3, FB_WIDTH, FB_WIDTH * 4 - 8, 0, XST_INVALID_PARAM },
+		{ 3, FB_WIDTH, FB_STRIDE + 4, 0, XST_INVALID_PARAM },
+		{ 3, FB_WIDTH, FB_STRIDE, 4, XST_INVALID_PARAM },
+		{ 3, 0, FB_STRIDE, 0, XST_INVALID_PARAM },
+	};
+	u32 Index;
+	int Status;
+	int Fail = 0;
+
+	ResetModel();
+	for (Index = 0; Index < sizeof(Cases) / sizeof(Cases[0]); Index++) {
+		Status = Init(Cases[Index].Buffers, Cases[Index].Width,
+			      Cases[Index].Stride, Cases[Index].Align);
+		if (Status != Cases[Index].Status) {
+			printf("  %u buffers, width %u, stride %u, align %u: "
+			       "status %d\n", Cases[Index].Buffers,
+			       Cases[Index].Width, Cases[Index].Stride,
+			       Cases[Index].Align, Status);
+			Fail = 1;
+		}
+	}
+
+	NumBuffers = 3;
+	Init(NumBuffers, FB_WIDTH, FB_STRIDE, 0);
+	ResetStuck = 1;
+	Status = HdmiFb_Start(&Fb);
+	if ((Status != XST_FAILURE) || Running) {
+		printf("  start with the VDMA in reset: status %d\n", Status);
+		Fail = 1;
+	}
+
+	printf("configuration checks %s\n", Fail ? "FAILED" : "OK");
+	return Fail;
+}
+
+/*
+ * Draw and flip as fast as possible for NumFrames frames
+ */
+static int RunCase(const char *Name, u32 Buffers, u32 DrawMinUs,
+		   u32 DrawMaxUs, int Inject, u32 NumFrames)
+{
+	HdmiFb_Stats Stats;
+	u32 Index, Addr, Busy = 0;
+	u32 Delivering;
+	int Status;
+	int Fail = 0;
+
+	ResetModel();
+	NumBuffers = Buffers;
+	InjectErrors = Inject;
+	srand(Buffers * 1000 + DrawMinUs);
+
+	if (Init(Buffers, FB_WIDTH, FB_STRIDE, 0) != XST_SUCCESS) {
+		printf("%-28s init failed\n", Name);
+		return 1;
+	}
+	HdmiFb_SetHandler(&Fb, FrameDone, NULL);
+	Connected = 1;
+	if (HdmiFb_Start(&Fb) != XST_SUCCESS) {
+		printf("%-28s start failed\n", Name);
+		return 1;
+	}
+
+	/* Only the drawing buffer can be flipped */
+	if (HdmiFb_Flip(&Fb, 0) != XST_INVALID_PARAM) {
+		Error("flip of the scan out buffer accepted");
+	}
+
+	while (Now < NumFrames * FRAME_NS) {
+		Status = HdmiFb_GetDrawBuffer(&Fb, &Index, &Addr);
+		if (Status == XST_DEVICE_BUSY) {
+			if (Buffers > 2) {
+				Error("busy with %u buffers", Buffers);
+			}
+			Busy++;
+			Advance(POLL_NS);
+			continue;
+		}
+		if ((Status != XST_SUCCESS) || (Index >= Buffers) ||
+		    (Addr != FB_ADDR(Index))) {
+			Error("draw buffer %u at 0x%08x, status %d", Index,
+			      Addr, Status);
+			break;
+		}
+		if (Pending[Index]) {
+			/* Flipped, never shown and given back */
+			Pending[Index] = 0;
+			Expect.Dropped++;
+		}
+		if (Reading && (Store == Index)) {
+			Tears++;
+			Error("buffer %u given for drawing while the VDMA "
+			      "reads it", Index);
+		}
+
+		Drawing = Index;
+		Advance((DrawMinUs + rand() % (DrawMaxUs - DrawMinUs + 1)) *
+			1000.0);
+		Drawing = HDMI_FB_NONE;
+
+		Content[Index] = ++Sequence;
+		Pending[Index] = 1;
+		FlipFrame[Index] = Delivered;
+		if (HdmiFb_Flip(&Fb, Index) != XST_SUCCESS) {
+			Error("flip of buffer %u failed", Index);
+		}
+		Expect.Flips++;
+	}
+
+	/* Let the last flip reach the screen, then stop */
+	Advance(SETTLE_FRAMES * FRAME_NS);
+	HdmiFb_Stop(&Fb);
+	Delivering = Delivered;
+	Advance(2 * FRAME_NS);
+	if (Running || (Delivered != Delivering)) {
+		Error("frames after stop");
+	}
+	for (Index = 0; Index < Buffers; Index++) {
+		if (Pending[Index]) {
+			Expect.Dropped++;
+		}
+	}
+	Expect.Frames = FramesRaised;
+
+	HdmiFb_GetStats(&Fb, &Stats);
+	if (Delivered != FramesRaised) {
+		Error("%u frame interrupts, %u callbacks", FramesRaised,
+		      Delivered);
+	}
+	if (memcmp(&Stats, &Expect, sizeof(Stats)) != 0) {
+		Error("statistics: frames %u/%u flips %u/%u displayed %u/%u "
+		      "dropped %u/%u repeated %u/%u latency %u/%u %u/%u "
+		      "%u/%u errors %u/%u %u/%u %u/%u %u/%u %u/%u",
+		      Stats.Frames, Expect.Frames, Stats.Flips, Expect.Flips,
+		      Stats.Displayed, Expect.Displayed, Stats.Dropped,
+		      Expect.Dropped, Stats.Repeated, Expect.Repeated,
+		      Stats.LastLatency, Expect.LastLatency,
+		      Stats.MaxLatency, Expect.MaxLatency,
+		      Stats.TotalLatency, Expect.TotalLatency,
+		      Stats.Underflows, Expect.Underflows,
+		      Stats.Overflows, Expect.Overflows,
+		      Stats.BeErrors, Expect.BeErrors,
+		      Stats.TpmOos, Expect.TpmOos,
+		      Stats.VdmaErrors, Expect.VdmaErrors);
+	}
+	if (Masked) {
+		Error("IRQ left masked");
+	}
+
+	printf("%-28s %5u %5u %5u %5u %5u %4u %5.2f %5u %5u\n", Name,
+	       Stats.Frames, Stats.Flips, Stats.Displayed, Stats.Dropped,
+	       Stats.Repeated, Stats.MaxLatency,
+	       Stats.Displayed ? (double)Stats.TotalLatency /
+				 Stats.Displayed : 0.0, Busy, Tears);
+
+	if (Errors != 0) {
+		printf("  %u errors\n", Errors);
+		Fail = 1;
+	}
+	return Fail;
+}
+
+int main(int argc, char **argv)
+{
+	u32 Frames = NUM_FRAMES;
+	int Fail = 0;
+
+	if (argc > 1) {
+		Frames = strtoul(argv[1], NULL, 0);
+	}
+	if (Frames == 0) {
+		fprintf(stderr, "usage: %s [<frames>]\n", argv[0]);
+		return 1;
+	}
+
+	Fail |= CheckConfig();
+
+	printf("%-28s %5s %5s %5s %5s %5s %4s %5s %5s %5s\n", "case",
+	       "frame", "flip", "shown", "drop", "rept", "lmax", "lavg",
+	       "busy", "tear");
+	Fail |= RunCase("3 buffers, draw 2-6 ms", 3, 2000, 6000, 0, Frames);
+	Fail |= RunCase("3 buffers, draw 12-20 ms", 3, 12000, 20000, 0,
+			Frames);
+	Fail |= RunCase("3 buffers, draw 25-40 ms", 3, 25000, 40000, 0,
+			Frames);
+	Fail |= RunCase("2 buffers, draw 2-6 ms", 2, 2000, 6000, 0, Frames);
+	Fail |= RunCase("2 buffers, draw 12-20 ms", 2, 12000, 20000, 0,
+			Frames);
+	Fail |= RunCase("3 buffers, core errors", 3, 8000, 18000, 1, Frames);
+
+	printf("%s\n", Fail ? "FAILED" : "all flips OK");
+
+	return Fail;
+}
@@ -0,0 +1,508 @@
+/******************************************************************************
+*
+* hdmi_modeset_sim.c
+*
+* Host simulation of the HDMI hot plug path. Runs HdmiTx_ModeSetHotplug
+* against models of the AXI IIC (dynamic controller, 100 kHz), the ADV7511
+* (register map, HPD, EDID fetch over DDC), axi_clkgen and axi_hdmi_tx_12b
+* on a virtual clock, for a set of canned EDIDs. For every sink it prints
+* the selected mode, the I2C traffic and the time from hot plug to the end
+* of the first frame, and checks the programmed registers.
+*
+* Timing model: every register access of the CPU takes AXI_ACCESS_NS, every
+* I2C bit 10 us, the ADV7511 starts the DDC read EDID_START_US after power
+* up and reads the EDID at 100 kHz, the MMCM locks in MMCM_LOCK_US.
+*
+* Build: gcc -O2 -I../../drivers/axi_hdmi_tx_12b_v1_00_b/src
+*	 -I../../drivers/axi_clkgen_v1_00_a/src -I<bsp include>
+*	 hdmi_modeset_sim.c
+*	 ../../drivers/axi_hdmi_tx_12b_v1_00_b/src/hdmi_modeset.c
+*	 ../../drivers/axi_hdmi_tx_12b_v1_00_b/src/hdmi_edid.c
+*	 ../../drivers/axi_hdmi_tx_12b_v1_00_b/src/hdmi_iic.c
+*	 ../../drivers/axi_clkgen_v1_00_a/src/clkgen.c
+*	 ../../drivers/axi_clkgen_v1_00_a/src/clkgen_mmcm.c -o hdmi_modeset_sim
+*
+* Usage: hdmi_modeset_sim
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hdmi_modeset.h"
+#include "hdmi_iic_l.h"
+#include "hdmi_tx_l.h"
+
+#define AXI_ACCESS_NS		100
+#define I2C_BIT_NS		10000
+#define EDID_START_US		2000
+#define MMCM_LOCK_US		100
+#define LIMIT_MS		100
+
+#define IIC_BASE		HDMI_IIC_BASEADDR
+#define HDMI_BASE		0x6C000000
+#define REGION_SIZE		0x10000
+
+/*
+ * Virtual clock in ns
+ */
+static double Now;
+
+/*
+ * AXI IIC: TX FIFO entries of the transfer being queued, the bus is busy
+ * until BusFreeAt, received bytes become readable at RxAt[]
+ */
+static u32 TxEntry[1024];
+static u32 TxCount;
+static double BusFreeAt;
+static u8 RxData[256];
+static double RxAt[256];
+static u32 RxHead, RxTail;
+static u32 Isr;
+
+/*
+ * ADV7511
+ */
+static u8 AdvReg[256];
+static u8 EdidMem[256];
+static u32 EdidLen;
+static int Hpd;
+static double EdidReadyAt;
+
+/*
+ * axi_clkgen and axi_hdmi_tx_12b
+ */
+static u32 ClkReg[32];
+static double LockAt;
+static u32 HdmiReg[8];
+static double EnableAt;
+
+unsigned int Xil_AssertStatus;
+
+void Xil_Assert(const char *File, int Line)
+{
+	fprintf(stderr, "assert %s:%d\n", File, Line);
+	exit(1);
+}
+
+static u8 AdvRead(u8 Reg)
+{
+	if ((EdidReadyAt != 0) && (Now >= EdidReadyAt)) {
+		AdvReg[0x96] |= 0x04;
+		EdidReadyAt = 0;
+	}
+	if (Reg == 0x42) {
+		return Hpd ? 0x60 : 0x00;
+	}
+	return AdvReg[Reg];
+}
+
+static void AdvWrite(u8 Reg, u8 Value)
+{
+	if ((Reg == 0x96) || (Reg == 0x97)) {
+		AdvReg[Reg] &= ~Value;
+		return;
+	}
+	if ((Reg == 0x41) && ((AdvReg[0x41] & 0x40) != 0) &&
+	    ((Value & 0x40) == 0) && Hpd) {
+		/* Power up: the ADV7511 fetches the EDID over DDC */
+		EdidReadyAt = Now + EDID_START_US * 1000.0 +
+			      (EdidLen + 4) * 9 * (double)I2C_BIT_NS;
+	}
+	AdvReg[Reg] = Value;
+}
+
+/*
+ * Run the queued transfer, it ends with a STOP entry. Returns the number of
+ * bits on the bus.
+ */
+static u32 RunTransfer(void)
+{
+	u32 Index = 0;
+	u32 Bits = 0;
+	u32 Addr, Count, Offset = 0, First;
+	u32 Ptr = 0;
+	double T;
+
+	while (Index < TxCount) {
+		/* START and address */
+		Addr = (TxEntry[Index] & 0xFF) >> 1;
+		Bits += 1 + 9;
+		if ((Addr != HDMI_ADV7511_ADDR) &&
+		    (Addr != HDMI_ADV7511_EDID_ADDR)) {
+			Isr |= HDMI_IIC_INTR_TX_ERROR_MASK;
+			break;
+		}
+		if ((TxEntry[Index] & HDMI_IIC_TX_READ_MASK) != 0) {
+			Count = TxEntry[Index + 1] & 0xFF;
+			T = (BusFreeAt > Now ? BusFreeAt : Now) + Bits *
+			    (double)I2C_BIT_NS;
+			for (; Count > 0; Count--) {
+				T += 9 * (double)I2C_BIT_NS;
+				RxAt[RxTail & 255] = T;
+				if (Addr == HDMI_ADV7511_ADDR) {
+					RxData[RxTail++ & 255] =
+						AdvRead((u8)Ptr++);
+				} else {
+					RxData[RxTail++ & 255] =
+						EdidMem[Ptr++ & 255];
+				}
+				Bits += 9;
+			}
+			Index += 2;
+			continue;
+		}
+		/* Write: register pointer, then data */
+		Index++;
+		First = 1;
+		while ((Index < TxCount) &&
+		       ((TxEntry[Index] & HDMI_IIC_TX_START_MASK) == 0)) {
+			Bits += 9;
+			if (First) {
+				Ptr = TxEntry[Index] & 0xFF;
+				First = 0;
+			} else if (Addr == HDMI_ADV7511_ADDR) {
+				AdvWrite((u8)Ptr++, TxEntry[Index] & 0xFF);
+			}
+			Offset = TxEntry[Index];
+			Index++;
+			if ((Offset & HDMI_IIC_TX_STOP_MASK) != 0) {
+				break;
+			}
+		}
+	}
+
+	return Bits + 1;
+}
+
+u32 Xil_In32(u32 Addr)
+{
+	u32 Value = 0;
+	u32 Off;
+
+	Now += AXI_ACCESS_NS;
+
+	if ((Addr & ~(REGION_SIZE - 1)) == IIC_BASE) {
+		Off = Addr - IIC_BASE;
+		if (Off == HDMI_IIC_SR_OFFSET) {
+			if ((Now < BusFreeAt) || (TxCount != 0)) {
+				Value |= HDMI_IIC_SR_BB_MASK;
+			} else {
+				Value |= HDMI_IIC_SR_TX_EMPTY_MASK;
+			}
+			if ((RxHead == RxTail) || (RxAt[RxHead & 255] > Now)) {
+				Value |= HDMI_IIC_SR_RX_EMPTY_MASK;
+			}
+		} else if (Off == HDMI_IIC_RX_FIFO_OFFSET) {
+			Value = RxData[RxHead++ & 255];
+		} else if (Off == HDMI_IIC_ISR_OFFSET) {
+			Value = Isr;
+		}
+	} else if ((Addr & ~(REGION_SIZE - 1)) == CLKGEN_BASEADDR) {
+		Off = Addr - CLKGEN_BASEADDR;
+		if (Off == CLKGEN_STATUS_OFFSET) {
+			Value = Now < LockAt ? CLKGEN_STATUS_RST_MASK :
+					       CLKGEN_STATUS_LOCKED_MASK;
+		} else {
+			Value = ClkReg[(Off / 4) & 31];
+		}
+	} else if ((Addr & ~(REGION_SIZE - 1)) == HDMI_BASE) {
+		Value = HdmiReg[((Addr - HDMI_BASE) / 4) & 7];
+	}
+
+	return Value;
+}
+
+void Xil_Out32(u32 Addr, u32 Value)
+{
+	u32 Off;
+	u32 Bits;
+
+	Now += AXI_ACCESS_NS;
+
+	if ((Addr & ~(REGION_SIZE - 1)) == IIC_BASE) {
+		Off = Addr - IIC_BASE;
+		if (Off == HDMI_IIC_TX_FIFO_OFFSET) {
+			TxEntry[TxCount++ & 1023] = Value;
+			if ((Value & HDMI_IIC_TX_STOP_MASK) != 0) {
+				Bits = RunTransfer();
+				BusFreeAt = (BusFreeAt > Now ? BusFreeAt : Now) +
+					    Bits * (double)I2C_BIT_NS;
+				TxCount = 0;
+			}
+		} else if (Off == HDMI_IIC_ISR_OFFSET) {
+			Isr ^= Value;
+		} else if ((Off == HDMI_IIC_CR_OFFSET) &&
+			   ((Value & HDMI_IIC_CR_TX_FIFO_RESET_MASK) != 0)) {
+			TxCount = 0;
+		}
+	} else if ((Addr & ~(REGION_SIZE - 1)) == CLKGEN_BASEADDR) {
+		Off = Addr - CLKGEN_BASEADDR;
+		if ((Off == CLKGEN_CTRL_OFFSET) &&
+		    ((Value & CLKGEN_CTRL_START_MASK) != 0)) {
+			LockAt = Now + MMCM_LOCK_US * 1000.0;
+		}
+		ClkReg[(Off / 4) & 31] = Value;
+	} else if ((Addr & ~(REGION_SIZE - 1)) == HDMI_BASE) {
+		Off = ((Addr - HDMI_BASE) / 4) & 7;
+		if ((Off == HDMI_TX_CTRL_OFFSET / 4) &&
+		    ((HdmiReg[Off] & HDMI_TX_CTRL_ENABLE_MASK) == 0) &&
+		    ((Value & HDMI_TX_CTRL_ENABLE_MASK) != 0)) {
+			EnableAt = Now;
+		}
+		HdmiReg[Off] = Value;
+	}
+}
+
+/*
+ * Canned EDIDs
+ */
+static void PutDtd(u8 *p, const HdmiTx_Timing *T, u32 XMm, u32 YMm)
+{
+	u32 HBlank = T->HFront + T->HSync + T->HBack;
+	u32 VBlank = T->VFront + T->VSync + T->VBack;
+	u32 Clock = T->PixelClkHz / 10000;
+
+	p[0] = Clock & 0xFF;
+	p[1] = Clock >> 8;
+	p[2] = T->HActive & 0xFF;
+	p[3] = HBlank & 0xFF;
+	p[4] = ((T->HActive >> 8) << 4) | (HBlank >> 8);
+	p[5] = T->VActive & 0xFF;
+	p[6] = VBlank & 0xFF;
+	p[7] = ((T->VActive >> 8) << 4) | (VBlank >> 8);
+	p[8] = T->HFront & 0xFF;
+	p[9] = T->HSync & 0xFF;
+	p[10] = ((T->VFront & 0xF) << 4) | (T->VSync & 0xF);
+	p[11] = ((T->HFront >> 8) << 6) | ((T->HSync >> 8) << 4) |
+		((T->VFront >> 4) << 2) | (T->VSync >> 4);
+	p[12] = XMm & 0xFF;
+	p[13] = YMm & 0xFF;
+	p[14] = ((XMm >> 8) << 4) | (YMm >> 8);
+	p[17] = 0x18 | ((T->Flags & HDMI_TIMING_VSYNC_POS) ? 0x04 : 0) |
+		((T->Flags & HDMI_TIMING_HSYNC_POS) ? 0x02 : 0);
+}
+
+static void Checksum(u8 *Block)
+{
+	u8 Sum = 0;
+	int i;
+
+	for (i = 0; i < 127; i++) {
+		Sum += Block[i];
+	}
+	Block[127] = (u8)(0x100 - Sum);
+}
+
+static void BaseBlock(u8 *b, const HdmiTx_Timing *Pref, u32 XMm, u32 YMm,
+		      u8 Est0, u8 Est1, const u8 *Std, u32 NumStd, u32 Ext)
+{
+	static const u8 Header[8] = { 0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+				      0xFF, 0 };
+	u32 i;
+
+	memset(b, 0, 128);
+	memcpy(b, Header, 8);
+	b[8] = 0x51;		/* Manufacturer "TEG" */
+	b[9] = 0xA7;
+	b[0x12] = 1;
+	b[0x13] = 3;
+	b[0x14] = 0x80;		/* Digital input */
+	b[0x18] = 0x0A;		/* RGB, preferred timing in DTD 1 */
+	b[0x23] = Est0;
+	b[0x24] = Est1;
+	for (i = 0; i < 8; i++) {
+		b[0x26 + 2 * i] = i < NumStd ? Std[2 * i] : 0x01;
+		b[0x27 + 2 * i] = i < NumStd ? Std[2 * i + 1] : 0x01;
+	}
+	PutDtd(b + 0x36, Pref, XMm, YMm);
+	/* Monitor name descriptor */
+	b[0x48 + 3] = 0xFC;
+	memcpy(b + 0x48 + 5, "SIM SINK\n   ", 13);
+	b[0x7E] = (u8)Ext;
+	Checksum(b);
+}
+
+static void CeaBlock(u8 *b, u8 Flags, const u8 *Vics, u32 NumVics,
+		     int Hdmi, const HdmiTx_Timing *Dtd)
+{
+	u32 Off = 4;
+	u32 i;
+
+	memset(b, 0, 128);
+	b[0] = 0x02;
+	b[1] = 0x03;
+	b[3] = Flags;
+	b[Off++] = (2 << 5) | NumVics;
+	for (i = 0; i < NumVics; i++) {
+		b[Off++] = Vics[i];
+	}
+	if (Hdmi) {
+		b[Off++] = (3 << 5) | 5;
+		b[Off++] = 0x03;
+		b[Off++] = 0x0C;
+		b[Off++] = 0x00;
+		b[Off++] = 0x10;
+		b[Off++] = 0x00;
+	}
+	b[2] = (u8)Off;
+	if (Dtd != NULL) {
+		PutDtd(b + Off, Dtd, 0, 0);
+	}
+	Checksum(b);
+}
+
+typedef struct {
+	const char *Name;
+	u32 Hsync1, Hsync2, Vsync1, Vsync2;	/* Expected core registers */
+	u32 IsHdmi;
+} Expect;
+
+static int RunCase(const char *Name, const u8 *Edid, u32 Len,
+		   const Expect *ExpPtr)
+{
+	static Clkgen Clk;
+	static HdmiTx_ModeSet Engine;
+	HdmiTx_Timing *T;
+	double Frame;
+	int Status;
+	int Fail = 0;
+
+	memset(AdvReg, 0, sizeof(AdvReg));
+	AdvReg[0x41] = 0x50;
+	memcpy(EdidMem, Edid, Len);
+	EdidLen = Len;
+	Hpd = 1;
+	EdidReadyAt = 0;
+	memset(HdmiReg, 0, sizeof(HdmiReg));
+	TxCount = 0;
+	RxHead = RxTail = 0;
+	Isr = 0;
+	Now = 0;
+	BusFreeAt = 0;
+	LockAt = 0;
+	EnableAt = 0;
+
+	Clkgen_CfgInitialize(&Clk, CLKGEN_BASEADDR, CLKGEN_REF_HZ);
+	HdmiTx_ModeSetInitialize(&Engine, IIC_BASE, HDMI_BASE, &Clk);
+
+	Status = HdmiTx_ModeSetHotplug(&Engine);
+	T = &Engine.Timing;
+	Frame = 1e9 / (HdmiTx_TimingRefresh(T) ? HdmiTx_TimingRefresh(T) : 60);
+
+	printf("%-28s %4ux%-4u %2u Hz %5.1f MHz %-4s %-5s %3u xfers %4u bytes "
+	       "%6.1f ms\n", Name, T->HActive, T->VActive,
+	       (unsigned)HdmiTx_TimingRefresh(T), T->PixelClkHz / 1e6,
+	       Engine.IsHdmi ? "HDMI" : "DVI",
+	       Engine.OutputYCbCr ? "YCbCr" : "RGB",
+	       (unsigned)Engine.Iic.Transfers, (unsigned)Engine.Iic.Bytes,
+	       (EnableAt + Frame) / 1e6);
+
+	if ((Status != XST_SUCCESS) || (EnableAt == 0)) {
+		printf("  mode set failed, status %d\n", Status);
+		return 1;
+	}
+	if ((HdmiReg[2] != ExpPtr->Hsync1) || (HdmiReg[3] != ExpPtr->Hsync2) ||
+	    (HdmiReg[4] != ExpPtr->Vsync1) || (HdmiReg[5] != ExpPtr->Vsync2)) {
+		printf("  timing %08x %08x %08x %08x, expected %08x %08x "
+		       "%08x %08x\n", (unsigned)HdmiReg[2],
+		       (unsigned)HdmiReg[3], (unsigned)HdmiReg[4],
+		       (unsigned)HdmiReg[5], (unsigned)ExpPtr->Hsync1,
+		       (unsigned)ExpPtr->Hsync2, (unsigned)ExpPtr->Vsync1,
+		       (unsigned)ExpPtr->Vsync2);
+		Fail = 1;
+	}
+	if ((AdvReg[0xAF] == 0x16) != (ExpPtr->IsHdmi != 0)) {
+		printf("  HDMI mode register 0x%02x\n", AdvReg[0xAF]);
+		Fail = 1;
+	}
+	if ((AdvReg[0x41] & 0x40) != 0) {
+		printf("  ADV7511 still powered down\n");
+		Fail = 1;
+	}
+	if ((EnableAt + Frame) / 1e6 > LIMIT_MS) {
+		printf("  hot plug to picture above %u ms\n", LIMIT_MS);
+		Fail = 1;
+	}
+
+	return Fail;
+}
+
+int main(void)
+{
+	static const HdmiTx_Timing Wuxga = {
+		154000000, 1920, 48, 32, 80, 1200, 3, 6, 26,
+		HDMI_TIMING_HSYNC_POS, 0
+	};
+	static const HdmiTx_Timing Sxga = {
+		108000000, 1280, 48, 112, 248, 1024, 1, 3, 38,
+		HDMI_TIMING_HSYNC_POS | HDMI_TIMING_VSYNC_POS, 0
+	};
+	static const u8 TvVics[] = { 0x80 | 16, 4, 31, 19, 3, 2, 1 };
+	static const u8 TvStd[] = { 0x81, 0x80, 0x81, 0xC0 };
+	static const u8 WuxgaStd[] = { 0xD1, 0xC0, 0xB3, 0x00, 0xA9, 0x40 };
+	static const u8 Tv720Vics[] = { 0x80 | 4, 19, 2, 1 };
+	static const Expect Exp1080 = {
+		"1080p", (44 << 16) | 2200, (192 << 16) | 2112,
+		(5 << 16) | 1125, (41 << 16) | 1121, 1
+	};
+	static const Expect ExpSxga = {
+		"sxga", (112 << 16) | 1688, (360 << 16) | 1640,
+		(3 << 16) | 1066, (41 << 16) | 1065, 0
+	};
+	static const Expect Exp1080Dvi = {
+		"1080p dvi", (44 << 16) | 2200, (192 << 16) | 2112,
+		(5 << 16) | 1125, (41 << 16) | 1121, 0
+	};
+	static const Expect Exp720 = {
+		"720p", (40 << 16) | 1650, (260 << 16) | 1540,
+		(5 << 16) | 750, (25 << 16) | 745, 1
+	};
+	static const Expect ExpVga = {
+		"vga", (96 << 16) | 800, (144 << 16) | 784,
+		(2 << 16) | 525, (35 << 16) | 515, 0
+	};
+	HdmiTx_Timing T1080, T720;
+	u8 Edid[256];
+	int Fail = 0;
+
+	HdmiTx_TimingFromVic(16, &T1080);
+	HdmiTx_TimingFromVic(4, &T720);
+
+	printf("%-28s %-9s %5s %9s %-4s %-5s %9s %10s %9s\n", "sink", "mode",
+	       "", "pclk", "link", "color", "i2c", "", "hot plug to picture");
+
+	BaseBlock(Edid, &T1080, 1600, 900, 0x21, 0x08, TvStd, 2, 1);
+	CeaBlock(Edid + 128, 0x70, TvVics, sizeof(TvVics), 1, &T720);
+	Fail |= RunCase("HDMI TV 1080p60", Edid, 256, &Exp1080);
+
+	BaseBlock(Edid, &Sxga, 376, 301, 0x21, 0x08, NULL, 0, 0);
+	Fail |= RunCase("DVI monitor 1280x1024", Edid, 128, &ExpSxga);
+
+	BaseBlock(Edid, &Wuxga, 518, 324, 0x21, 0x08, WuxgaStd, 3, 0);
+	Fail |= RunCase("DVI monitor 1920x1200 RB", Edid, 128, &Exp1080Dvi);
+
+	BaseBlock(Edid, &T720, 1020, 570, 0x21, 0x00, NULL, 0, 1);
+	CeaBlock(Edid + 128, 0x40, Tv720Vics, sizeof(Tv720Vics), 1, NULL);
+	Fail |= RunCase("HDMI TV 720p60, RGB only", Edid, 256, &Exp720);
+
+	BaseBlock(Edid, &T1080, 1600, 900, 0x21, 0x08, TvStd, 2, 1);
+	CeaBlock(Edid + 128, 0x70, TvVics, sizeof(TvVics), 1, &T720);
+	Edid[128 + 2] = 0xF0;
+	Checksum(Edid + 128);
+	Fail |= RunCase("CEA DTD offset out of block", Edid, 256, &Exp1080Dvi);
+
+	BaseBlock(Edid, &T1080, 1600, 900, 0x21, 0x08, TvStd, 2, 0);
+	Edid[127] ^= 0x55;
+	Fail |= RunCase("Corrupt EDID", Edid, 128, &ExpVga);
+
+	printf("%s\n", Fail ? "FAILED" : "all sinks OK");
+
+	return Fail;
+}
@@ -0,0 +1,491 @@
+/******************************************************************************
+*
+* hdmi_selftest_sim.c
+*
+* Host build of the video self test generators and a simulation of the
+* self test.
+*
+* First it checks the vector pattern kernels against the portable ones for
+* all patterns and line lengths up to 64 + 8, times the frame generator and
+* the frame CRC, and prints the expected output CRCs of every stage for the
+* common active areas, the table a test station compares its captures
+* with.
+*
+* Then it runs HdmiSelfTest_Run against a model of axi_vdma and
+* axi_hdmi_tx_12b, for a good board and for boards with a fault: a stuck
+* data bit on the VDMA path, dead test pattern monitors, a broken color
+* space converter, VDMA underflows and a DDR bit flip. The model checks
+* every frame the VDMA reads against the TPM sequence as cf_vdma.v and
+* cf_hdmi.v do, latches cp_value on the cp_enable edge and the capture
+* callback computes the CRC of the output from the frame in memory. Every
+* faulty board must fail and the good one must pass.
+*
+* The vector kernels and the BSP types assume a 32 bit target, build it
+* for one.
+*
+* Build: gcc -m32 -msse2 -O2 -I../../drivers/axi_hdmi_tx_12b_v1_00_b/src
+*	 -I<bsp include> hdmi_selftest_sim.c
+*	 ../../drivers/axi_hdmi_tx_12b_v1_00_b/src/hdmi_selftest.c
+*	 ../../drivers/axi_hdmi_tx_12b_v1_00_b/src/hdmi_pattern.c
+*	 ../../drivers/axi_hdmi_tx_12b_v1_00_b/src/hdmi_tx_csc.c
+*	 -o hdmi_selftest_sim
+*
+* Usage: hdmi_selftest_sim [<width> <height>]
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+#include "hdmi_selftest.h"
+#include "hdmi_pattern.h"
+#include "hdmi_tx_csc.h"
+#include "hdmi_tx_l.h"
+#include "hdmi_vdma_l.h"
+
+#define VDMA_BASE		0x43000000
+#define HDMI_BASE		0x6C000000
+#define REGION_SIZE		0x10000
+#define NUM_FSTORES		3
+#define POLLS_PER_FRAME		4
+#define REFRESH_HZ		60
+#define BENCH_LOOPS		20
+
+/*
+ * Board faults
+ */
+#define FAULT_NONE		0
+#define FAULT_STUCK_BIT		1	/* VDMA data bit 5 stuck at 0 */
+#define FAULT_DEAD_TPM		2	/* Monitors never report */
+#define FAULT_CSC		3	/* hdmi_data bit 3 inverted */
+#define FAULT_UNDERFLOW		4	/* vdma_unf every 7th frame */
+#define FAULT_DDR_FLIP		5	/* Bit flips in the bars stage */
+
+static u32 Fault;
+
+/*
+ * Register model
+ */
+static u32 Vdma[REGION_SIZE / 4];
+static u32 Hdmi[REGION_SIZE / 4];
+static u32 CpValue;
+static u32 Polls;
+static u32 FrameCount;
+static u32 Width, Height, Stride;
+
+unsigned int Xil_AssertStatus;
+
+void Xil_Assert(const char *File, int Line)
+{
+	fprintf(stderr, "assert %s:%d\n", File, Line);
+	exit(1);
+}
+
+void Xil_DCacheFlushRange(unsigned int Addr, unsigned Len)
+{
+	(void)Addr;
+	(void)Len;
+}
+
+void Xil_DCacheInvalidateRange(unsigned int Addr, unsigned Len)
+{
+	(void)Addr;
+	(void)Len;
+}
+
+/*
+ * Pixel as the core receives it from the VDMA
+ */
+static u32 VdmaPixel(u32 Addr)
+{
+	u32 Pixel = *(volatile u32 *)(unsigned long)Addr;
+
+	if (Fault == FAULT_STUCK_BIT) {
+		Pixel &= ~0x20;
+	}
+	return Pixel;
+}
+
+/*
+ * One frame of the VDMA read channel and the core: run the monitors over
+ * the frame in the parked frame store
+ */
+static void RunFrame(void)
+{
+	u32 Addr = Vdma[HDMI_VDMA_ADDR_OFFSET(0) / 4];
+	u32 Line, Index, Count = 0;
+	u32 Oos = 0;
+
+	FrameCount++;
+	Vdma[HDMI_VDMA_SR_OFFSET / 4] |= HDMI_VDMA_SR_FRMCNT_IRQ_MASK;
+
+	if ((Fault == FAULT_DDR_FLIP) && (FrameCount == 95)) {
+		*(volatile u32 *)(unsigned long)(Addr + 4 * Stride) ^= 0x100;
+	}
+
+	for (Line = 0; Line < Height; Line++) {
+		for (Index = 0; Index < Width; Index++, Count++) {
+			if ((VdmaPixel(Addr + Line * Stride + Index * 4) &
+			     HDMI_PATTERN_RAMP_MASK) !=
+			    (Count & HDMI_PATTERN_RAMP_MASK)) {
+				Oos = 1;
+			}
+		}
+	}
+	if (Oos && (Fault != FAULT_DEAD_TPM)) {
+		Hdmi[HDMI_TX_STATUS_OFFSET / 4] |=
+			HDMI_TX_STATUS_VDMA_TPM_OOS_MASK |
+			HDMI_TX_STATUS_HDMI_TPM_OOS_MASK;
+	}
+	if ((Fault == FAULT_UNDERFLOW) && ((FrameCount % 7) == 0)) {
+		Hdmi[HDMI_TX_STATUS_OFFSET / 4] |=
+			HDMI_TX_STATUS_VDMA_UNF_MASK;
+	}
+}
+
+u32 Xil_In32(u32 Addr)
+{
+	if ((Addr & ~(REGION_SIZE - 1)) == VDMA_BASE) {
+		if ((Addr - VDMA_BASE == HDMI_VDMA_SR_OFFSET) &&
+		    ((Vdma[HDMI_VDMA_CR_OFFSET / 4] &
+		      HDMI_VDMA_CR_RUNSTOP_MASK) != 0) &&
+		    (++Polls % POLLS_PER_FRAME == 0)) {
+			RunFrame();
+		}
+		return Vdma[(Addr - VDMA_BASE) / 4];
+	}
+	if ((Addr & ~(REGION_SIZE - 1)) == HDMI_BASE) {
+		return Hdmi[(Addr - HDMI_BASE) / 4];
+	}
+	return *(volatile u32 *)(unsigned long)Addr;
+}
+
+void Xil_Out32(u32 Addr, u32 Value)
+{
+	u32 Off;
+
+	if ((Addr & ~(REGION_SIZE - 1)) == VDMA_BASE) {
+		Off = Addr - VDMA_BASE;
+		if (Off == HDMI_VDMA_SR_OFFSET) {
+			Vdma[Off / 4] &= ~(Value & HDMI_VDMA_SR_IRQ_ALL_MASK);
+		} else if (Off == HDMI_VDMA_CR_OFFSET) {
+			/* Reset completes at once */
+			Vdma[Off / 4] = Value & ~HDMI_VDMA_CR_RESET_MASK;
+		} else {
+			Vdma[Off / 4] = Value;
+		}
+		return;
+	}
+	if ((Addr & ~(REGION_SIZE - 1)) == HDMI_BASE) {
+		Off = Addr - HDMI_BASE;
+		if (Off == HDMI_TX_STATUS_OFFSET) {
+			Hdmi[Off / 4] &= ~(Value & HDMI_TX_STATUS_ALL_MASK);
+			return;
+		}
+		if ((Off == HDMI_TX_CP_OFFSET) &&
+		    ((Value & HDMI_TX_CP_ENABLE_MASK) != 0) &&
+		    ((Hdmi[Off / 4] & HDMI_TX_CP_ENABLE_MASK) == 0)) {
+			CpValue = Value & HDMI_TX_CP_VALUE_MASK;
+		}
+		Hdmi[Off / 4] = Value;
+		return;
+	}
+	*(volatile u32 *)(unsigned long)Addr = Value;
+}
+
+/*
+ * Capture: CRC of the hdmi_data words of a frame, from the frame in memory
+ * or the test sources of the core
+ */
+static int Capture(void *CallBackRef, u32 *CrcPtr)
+{
+	static u32 Src[HDMI_PATTERN_MAX_WIDTH];
+	static u16 Out[HDMI_PATTERN_MAX_WIDTH];
+	u32 Ctrl = Hdmi[HDMI_TX_CTRL_OFFSET / 4];
+	u32 Addr = Vdma[HDMI_VDMA_ADDR_OFFSET(0) / 4];
+	u32 Count = 0;
+	u32 Crc = 0;
+	u32 Line, Index, Pass;
+	HdmiTx_Model Model;
+
+	(void)CallBackRef;
+
+	HdmiTx_ModelInit(&Model, Ctrl & HDMI_TX_CTRL_CSC_BYPASS_MASK,
+			 Ctrl & HDMI_TX_CTRL_CRCB_INIT_MASK);
+
+	/* Pass 0 primes the sub sampler with the last pixel of a frame */
+	for (Pass = 0; Pass < 2; Pass++) {
+		Count = 0;
+		for (Line = 0; Line < Height; Line++) {
+			for (Index = 0; Index < Width; Index++, Count++) {
+				if ((Hdmi[HDMI_TX_CP_OFFSET / 4] &
+				     HDMI_TX_CP_ENABLE_MASK) != 0) {
+					Src[Index] = CpValue;
+				} else if ((Ctrl &
+					    HDMI_TX_CTRL_TPG_ENABLE_MASK) != 0) {
+					Src[Index] = Count &
+						     HDMI_PATTERN_RAMP_MASK;
+				} else {
+					Src[Index] = VdmaPixel(Addr +
+							       Line * Stride +
+							       Index * 4);
+				}
+			}
+			HdmiTx_ModelLine(&Model, Src, Out, Width);
+			if (Pass == 0) {
+				continue;
+			}
+			if (Fault == FAULT_CSC) {
+				for (Index = 0; Index < Width; Index++) {
+					Out[Index] ^= 0x08;
+				}
+			}
+			Crc = HdmiTx_Crc32(Crc, (const u8 *)Out, Width * 2);
+		}
+	}
+
+	*CrcPtr = Crc;
+	return XST_SUCCESS;
+}
+
+static double Seconds(void)
+{
+	struct timespec Ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+	return Ts.tv_sec + Ts.tv_nsec / 1e9;
+}
+
+static u32 *AllocFrame(u32 Bytes)
+{
+	void *Ptr;
+
+#ifdef MAP_32BIT
+	/* The frame address is a u32, keep it below 4 GiB */
+	Ptr = mmap(NULL, Bytes, PROT_READ | PROT_WRITE,
+		   MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+	if (Ptr == MAP_FAILED) {
+		Ptr = NULL;
+	}
+#else
+	Ptr = malloc(Bytes);
+#endif
+	if (Ptr == NULL) {
+		fprintf(stderr, "no memory for the frame\n");
+		exit(1);
+	}
+	return Ptr;
+}
+
+/*
+ * Vector kernels against the portable ones
+ */
+static int CheckKernels(void)
+{
+	static const u32 Types[] = {
+		HDMI_PATTERN_RAMP, HDMI_PATTERN_SOLID, HDMI_PATTERN_BARS
+	};
+	u32 A[80], B[80];
+	u32 Type, Len, Line;
+	int Fail = 0;
+
+	for (Type = 0; Type < 3; Type++) {
+		for (Len = 0; Len <= 72; Len++) {
+			for (Line = 0; Line < 3; Line++) {
+				memset(A, 0xAA, sizeof(A));
+				memset(B, 0xAA, sizeof(B));
+				HdmiTx_PatternLine(Types[Type], 0x123456,
+						   Len, Line + 0x3FFF0, A);
+				HdmiTx_PatternLineScalar(Types[Type],
+							 0x123456, Len,
+							 Line + 0x3FFF0, B);
+				if (memcmp(A, B, sizeof(A)) != 0) {
+					Fail = 1;
+				}
+			}
+		}
+	}
+	/* Check value of the CRC-32 */
+	if (HdmiTx_Crc32(0, (const u8 *)"123456789", 9) != 0xCBF43926) {
+		printf("CRC-32 check value wrong\n");
+		Fail = 1;
+	}
+	printf("vector kernels %s, CRC-32 check value %08x\n",
+	       Fail ? "DIFFER" : "match", HdmiTx_Crc32(0,
+			(const u8 *)"123456789", 9));
+
+	return Fail;
+}
+
+static void Bench(u32 W, u32 H)
+{
+	u32 *Frame = AllocFrame(W * H * 4);
+	double T0, T1, T2, T3;
+	u32 Loop;
+	u32 Crc = 0;
+
+	T0 = Seconds();
+	for (Loop = 0; Loop < BENCH_LOOPS; Loop++) {
+		HdmiTx_PatternFrame(HDMI_PATTERN_RAMP, 0, Frame, W, W, H);
+	}
+	T1 = Seconds();
+	for (Loop = 0; Loop < BENCH_LOOPS; Loop++) {
+		u32 Line;
+
+		for (Line = 0; Line < H; Line++) {
+			HdmiTx_PatternLineScalar(HDMI_PATTERN_RAMP, 0, W, Line,
+						 Frame + Line * W);
+		}
+	}
+	T2 = Seconds();
+	for (Loop = 0; Loop < BENCH_LOOPS; Loop++) {
+		Crc ^= HdmiTx_PatternFrameCrc(Frame, W, W, H);
+	}
+	T3 = Seconds();
+
+	printf("%ux%u: ramp %.0f Mpixel/s (portable %.0f), frame CRC "
+	       "%.0f MB/s\n", W, H,
+	       W * H * (double)BENCH_LOOPS / (T1 - T0) / 1e6,
+	       W * H * (double)BENCH_LOOPS / (T2 - T1) / 1e6,
+	       W * H * 4.0 * BENCH_LOOPS / (T3 - T2) / 1e6);
+	(void)Crc;
+}
+
+static void CrcTable(u32 W, u32 H)
+{
+	static const u32 Colors[] = {
+		0x000000, 0xFFFFFF, 0xFF0000, 0x00FF00, 0x0000FF, 0x808080
+	};
+	u32 Index;
+
+	printf("%4ux%-4u %08x %08x", W, H,
+	       HdmiTx_PatternOutputCrc(HDMI_PATTERN_RAMP, 0, W, H, 0, 0),
+	       HdmiTx_PatternOutputCrc(HDMI_PATTERN_BARS, 0, W, H, 0, 0));
+	for (Index = 0; Index < sizeof(Colors) / sizeof(Colors[0]); Index++) {
+		printf(" %08x", HdmiTx_PatternOutputCrc(HDMI_PATTERN_SOLID,
+							Colors[Index], W, H,
+							0, 0));
+	}
+	printf("\n");
+}
+
+static int RunBoard(const char *Name, u32 BoardFault, int ExpectPass)
+{
+	HdmiSelfTest_Config Config;
+	HdmiSelfTest_Result Result;
+	u32 *Frame;
+	u32 Index;
+	int Status;
+	int Fail = 0;
+	double T0, T1;
+
+	Fault = BoardFault;
+	memset(Vdma, 0, sizeof(Vdma));
+	memset(Hdmi, 0, sizeof(Hdmi));
+	FrameCount = 0;
+	Polls = 0;
+
+	/* Timing as HdmiTx_ModeSetApply leaves it, active area only */
+	Hdmi[HDMI_TX_CTRL_OFFSET / 4] = HDMI_TX_CTRL_ENABLE_MASK;
+	Hdmi[HDMI_TX_HSYNC_2_OFFSET / 4] = HdmiTx_SyncReg(100, 100 + Width);
+	Hdmi[HDMI_TX_VSYNC_2_OFFSET / 4] = HdmiTx_SyncReg(20, 20 + Height);
+
+	Frame = AllocFrame(Stride * Height);
+
+	Config.VdmaBaseAddr = VDMA_BASE;
+	Config.HdmiBaseAddr = HDMI_BASE;
+	Config.NumFrameStores = NUM_FSTORES;
+	Config.FrameAddr = (u32)(unsigned long)Frame;
+	Config.Stride = Stride;
+	Config.FramesPerStage = HDMI_SELFTEST_FRAMES;
+
+	T0 = Seconds();
+	Status = HdmiSelfTest_Run(&Config, Capture, NULL, &Result);
+	T1 = Seconds();
+
+	printf("%-22s %-7s %3u frames, %.2f s at %u Hz, host %.2f s\n", Name,
+	       (Status == XST_SUCCESS) ? "pass" : "FAIL", FrameCount,
+	       (double)FrameCount / REFRESH_HZ, REFRESH_HZ, T1 - T0);
+	for (Index = 0; Index < Result.NumStages; Index++) {
+		HdmiSelfTest_Stage *StagePtr = &Result.Stage[Index];
+
+		if (StagePtr->Pass) {
+			continue;
+		}
+		printf("  %-10s frames %u tpm %u/%u dma %u ddr %s crc %08x/%08x\n",
+		       StagePtr->Name, StagePtr->Frames,
+		       StagePtr->VdmaTpmFrames, StagePtr->HdmiTpmFrames,
+		       StagePtr->DmaErrorFrames,
+		       StagePtr->FrameCrcOk ? "ok" : "BAD",
+		       StagePtr->ExpectedCrc, StagePtr->MeasuredCrc);
+	}
+
+	if ((Status == XST_SUCCESS) != ExpectPass) {
+		printf("  expected to %s\n", ExpectPass ? "pass" : "fail");
+		Fail = 1;
+	}
+	if ((Hdmi[HDMI_TX_CTRL_OFFSET / 4] != HDMI_TX_CTRL_ENABLE_MASK) ||
+	    (Hdmi[HDMI_TX_CP_OFFSET / 4] != 0) ||
+	    ((Vdma[HDMI_VDMA_CR_OFFSET / 4] & HDMI_VDMA_CR_RUNSTOP_MASK) !=
+	     0)) {
+		printf("  core or VDMA not restored\n");
+		Fail = 1;
+	}
+
+	return Fail;
+}
+
+int main(int argc, char *argv[])
+{
+	static const u32 Areas[][2] = {
+		{ 640, 480 }, { 720, 480 }, { 1280, 720 }, { 1280, 1024 },
+		{ 1920, 1080 }
+	};
+	u32 Index;
+	int Fail = 0;
+
+	Width = 640;
+	Height = 480;
+	if (argc > 2) {
+		Width = strtoul(argv[1], NULL, 0);
+		Height = strtoul(argv[2], NULL, 0);
+	}
+	if ((Width == 0) || (Width > HDMI_PATTERN_MAX_WIDTH) ||
+	    ((Width % 2) != 0) || (Height == 0)) {
+		fprintf(stderr, "active area %ux%u not supported\n", Width,
+			Height);
+		return 1;
+	}
+	Stride = (Width * 4 + 63) & ~63;
+
+	Fail |= CheckKernels();
+	Bench(1920, 1080);
+
+	printf("\nexpected output CRCs, csc on, crcb_init 0\n");
+	printf("%-9s %-8s %-8s %-8s %-8s %-8s %-8s %-8s %-8s\n", "area",
+	       "ramp/tpg", "bars", "black", "white", "red", "green", "blue",
+	       "gray");
+	for (Index = 0; Index < sizeof(Areas) / sizeof(Areas[0]); Index++) {
+		CrcTable(Areas[Index][0], Areas[Index][1]);
+	}
+
+	printf("\nself test at %ux%u\n", Width, Height);
+	Fail |= RunBoard("good board", FAULT_NONE, 1);
+	Fail |= RunBoard("VDMA data bit stuck", FAULT_STUCK_BIT, 0);
+	Fail |= RunBoard("dead monitors", FAULT_DEAD_TPM, 0);
+	Fail |= RunBoard("CSC fault", FAULT_CSC, 0);
+	Fail |= RunBoard("VDMA underflows", FAULT_UNDERFLOW, 0);
+	Fail |= RunBoard("DDR bit flip", FAULT_DDR_FLIP, 0);
+
+	printf("%s\n", Fail ? "FAILED" : "all boards classified correctly");
+
+	return Fail;
+}
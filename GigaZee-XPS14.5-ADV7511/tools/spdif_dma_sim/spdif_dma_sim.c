@@ -0,0 +1,662 @@
+/******************************************************************************
+*
+* spdif_dma_sim.c
+*
+* Host simulation of the S/PDIF streaming ring. Runs spdif_dma.c against a
+* model of the axi_dma_spdif scatter gather engine, the D-cache and an
+* S/PDIF sink on a virtual clock, streaming 192 kHz stereo for a number of
+* scenarios: refill from the period callback, refill from a task with
+* jitter, a stalled task, interrupts masked for a while and a DMA error.
+* Jitter, stall and masked times are given in periods, so the scenarios
+* hold for every period size.
+*
+* The engine fetches descriptors from DDR, rejects stale ones (complete bit
+* still set), writes the status back and goes idle after the tail, as the
+* axi_dma 5.00a does. CPU accesses go through a write back cache model, the
+* engine only sees what the driver flushed and the driver only sees the
+* status the engine wrote after an invalidate. The sink plays the stream at
+* the audio rate out of a FIFO of SINK_FIFO_FRAMES, it checks every word:
+* application data must arrive in submission order, without repeats or
+* holes, everything else must be silence.
+*
+* For every scenario it prints the periods played, the silence inserted,
+* the sink gaps, the interrupts, the bytes flushed per second and the CPU
+* time spent in the driver, from AXI_ACCESS_NS per register access,
+* MEM_ACCESS_NS per descriptor word, LINE_NS per cache line maintained and
+* IRQ_ENTRY_NS per interrupt.
+*
+* Build: gcc -O2 -I../../drivers/spdif_dma_v1_00_a/src -I<bsp include>
+*	 spdif_dma_sim.c ../../drivers/spdif_dma_v1_00_a/src/spdif_dma.c
+*	 -o spdif_dma_sim
+*
+* Usage: spdif_dma_sim [<period frames>]
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "spdif_dma.h"
+#include "spdif_dma_l.h"
+#include "xil_cache.h"
+
+#define RATE_HZ			192000
+#define WORDS_PER_FRAME		2	/* Stereo, one 32 bit word per sub frame */
+#define RUN_NS			10e9
+#define SINK_FIFO_FRAMES	64
+#define FETCH_NS		500.0
+#define IRQ_LATENCY_NS		2000.0
+#define IRQ_ENTRY_NS		1000.0
+#define AXI_ACCESS_NS		100.0
+#define MEM_ACCESS_NS		10.0
+#define LINE_NS			20.0
+#define CACHE_LINE		32
+
+#define DMA_BASE		SPDIF_DMA_BASEADDR
+#define MEM_BASE		0x01000000
+#define MEM_SIZE		0x60000
+#define RING_ADDR		MEM_BASE
+#define SILENCE_ADDR		(MEM_BASE + 0x1000)
+#define BUF_ADDR		(MEM_BASE + 0x20000)
+#define MAX_BUFS		8
+#define NUM_BDS			4
+
+#define STALE			0x5A5A5A5A	/* DDR never written */
+#define DATA_FLAG		0x80000000
+
+#define NEVER			1e30
+
+/*
+ * Scenario
+ */
+typedef struct {
+	const char *Name;
+	int Task;		/* Refill from a task, else from the callback */
+	u32 NumBufs;		/* Application period buffers */
+	double Jitter;		/* Task wake up after a callback, periods */
+	double StallAt, Stall;		/* Task does not run, s and periods */
+	double IrqOffAt, IrqOff;	/* Interrupts masked, s and periods */
+	u32 ErrorFetch;		/* Fetch answered with a decode error, 0 none */
+	int ExpectGaps;		/* Sink gaps expected */
+	int ExpectUnderruns;	/* Silence runs expected */
+} Scenario;
+
+static const Scenario *Sc;
+static u32 PeriodBytes;
+static double PeriodNs;
+static double NsPerByte;
+
+/*
+ * Virtual clock, CPU time spent in the driver
+ */
+static double Now;
+static double CpuNs;
+
+/*
+ * Memory: what the CPU sees through the D-cache and what is in DDR
+ */
+static u32 Cpu[MEM_SIZE / 4];
+static u32 Ddr[MEM_SIZE / 4];
+static double FlushBytes;
+static u32 Foreign;		/* Cache maintenance outside period and BD */
+
+/*
+ * Engine
+ */
+static u32 Cr, Sr, CurDesc, TailDesc, NextDesc;
+static int Busy;
+static double FetchAt = NEVER, DoneAt = NEVER;
+static u32 Fetches;
+static int IrqLine;
+static double IrqRaisedAt;
+static u32 Misuse;		/* Register writes the engine ignores */
+
+/*
+ * Sink
+ */
+static double PlayEnd;
+static int Playing;
+static u32 Gaps;
+static double GapNs;
+static u32 LastSeq;
+static u32 DataWords, SilenceWords, BadWords;
+
+/*
+ * Application
+ */
+static SpdifDma Ring;
+static u32 Seq;
+static u32 FreeQueue[MAX_BUFS];
+static double FreeAt[MAX_BUFS];
+static u32 FreeHead, FreeCount;
+static u32 Rand = 12345;
+
+unsigned int Xil_AssertStatus;
+
+void Xil_Assert(const char *File, int Line)
+{
+	fprintf(stderr, "assert %s:%d\n", File, Line);
+	exit(1);
+}
+
+static u32 *MemWord(u32 *Mem, u32 Addr)
+{
+	if ((Addr < MEM_BASE) || (Addr >= MEM_BASE + MEM_SIZE) ||
+	    ((Addr & 3) != 0)) {
+		fprintf(stderr, "bad memory address 0x%08lx\n", Addr);
+		exit(1);
+	}
+	return &Mem[(Addr - MEM_BASE) / 4];
+}
+
+static void UpdateIrq(double T)
+{
+	int Line;
+
+	Line = (((Sr & SPDIF_DMA_SR_IOC_IRQ_MASK) != 0) &&
+		((Cr & SPDIF_DMA_CR_IOC_IRQ_MASK) != 0)) ||
+	       (((Sr & SPDIF_DMA_SR_ERR_IRQ_MASK) != 0) &&
+		((Cr & SPDIF_DMA_CR_ERR_IRQ_MASK) != 0));
+	if (Line && !IrqLine) {
+		IrqRaisedAt = T;
+	}
+	IrqLine = Line;
+}
+
+/*
+ * The sink plays Words from time T on. It starts over after a gap.
+ */
+static double SinkPlay(double T, u32 BufAddr, u32 Bytes)
+{
+	u32 Index;
+	u32 Word;
+	double Dur = Bytes * NsPerByte;
+	double Done;
+
+	if (!Playing || (T > PlayEnd)) {
+		if (Playing) {
+			Gaps++;
+			GapNs += T - PlayEnd;
+		}
+		PlayEnd = T;
+		Playing = 1;
+	}
+
+	for (Index = 0; Index < Bytes / 4; Index++) {
+		Word = *MemWord(Ddr, BufAddr + Index * 4);
+		if (Word == 0) {
+			SilenceWords++;
+		} else if (((Word & DATA_FLAG) != 0) &&
+			   ((Word & ~DATA_FLAG) == LastSeq + 1)) {
+			LastSeq++;
+			DataWords++;
+		} else {
+			if (BadWords++ < 4) {
+				printf("  bad word 0x%08lx, expected 0x%08lx\n",
+				       Word, (LastSeq + 1) | DATA_FLAG);
+			}
+			if ((Word & DATA_FLAG) != 0) {
+				LastSeq = Word & ~DATA_FLAG;
+			}
+		}
+	}
+
+	/* The last byte enters the FIFO SINK_FIFO_FRAMES before it plays */
+	Done = PlayEnd + Dur -
+	       SINK_FIFO_FRAMES * WORDS_PER_FRAME * 4 * NsPerByte;
+	PlayEnd += Dur;
+
+	return (Done > T) ? Done : T;
+}
+
+static void Fetch(double T)
+{
+	u32 Status;
+	u32 Length;
+
+	FetchAt = NEVER;
+	CurDesc = NextDesc;
+	Fetches++;
+
+	Status = *MemWord(Ddr, CurDesc + SPDIF_DMA_BD_STS_OFFSET);
+	if ((Status & SPDIF_DMA_BD_STS_CMPLT_MASK) != 0) {
+		Sr |= SPDIF_DMA_SR_SGINTERR_MASK | SPDIF_DMA_SR_ERR_IRQ_MASK |
+		      SPDIF_DMA_SR_HALTED_MASK;
+		Cr &= ~SPDIF_DMA_CR_RUNSTOP_MASK;
+		UpdateIrq(T);
+		return;
+	}
+	if (Fetches == Sc->ErrorFetch) {
+		*MemWord(Ddr, CurDesc + SPDIF_DMA_BD_STS_OFFSET) = 0x40000000;
+		Sr |= SPDIF_DMA_SR_DMADECERR_MASK | SPDIF_DMA_SR_ERR_IRQ_MASK |
+		      SPDIF_DMA_SR_HALTED_MASK;
+		Cr &= ~SPDIF_DMA_CR_RUNSTOP_MASK;
+		UpdateIrq(T);
+		return;
+	}
+
+	Length = *MemWord(Ddr, CurDesc + SPDIF_DMA_BD_CTRL_OFFSET) &
+		 SPDIF_DMA_BD_LENGTH_MASK;
+	Busy = 1;
+	DoneAt = SinkPlay(T, *MemWord(Ddr, CurDesc + SPDIF_DMA_BD_BUFA_OFFSET),
+			  Length);
+}
+
+static void Complete(double T)
+{
+	u32 Length;
+
+	DoneAt = NEVER;
+	Busy = 0;
+
+	Length = *MemWord(Ddr, CurDesc + SPDIF_DMA_BD_CTRL_OFFSET) &
+		 SPDIF_DMA_BD_LENGTH_MASK;
+	*MemWord(Ddr, CurDesc + SPDIF_DMA_BD_STS_OFFSET) =
+		SPDIF_DMA_BD_STS_CMPLT_MASK | Length;
+	Sr |= SPDIF_DMA_SR_IOC_IRQ_MASK;
+
+	if (CurDesc == TailDesc) {
+		Sr |= SPDIF_DMA_SR_IDLE_MASK;
+	} else {
+		NextDesc = *MemWord(Ddr, CurDesc + SPDIF_DMA_BD_NXTDESC_OFFSET);
+		FetchAt = T + FETCH_NS;
+	}
+	UpdateIrq(T);
+}
+
+/*
+ * Run the engine up to Now
+ */
+static void DmaAdvance(void)
+{
+	while ((FetchAt <= Now) || (DoneAt <= Now)) {
+		if (FetchAt <= DoneAt) {
+			Fetch(FetchAt);
+		} else {
+			Complete(DoneAt);
+		}
+	}
+}
+
+static void DmaReset(void)
+{
+	Cr = 0;
+	Sr = SPDIF_DMA_SR_HALTED_MASK | SPDIF_DMA_SR_SGINCLD_MASK;
+	Busy = 0;
+	FetchAt = NEVER;
+	DoneAt = NEVER;
+	UpdateIrq(Now);
+}
+
+u32 Xil_In32(u32 Addr)
+{
+	if ((Addr & ~0xFFFFUL) == DMA_BASE) {
+		Now += AXI_ACCESS_NS;
+		DmaAdvance();
+		switch (Addr - DMA_BASE) {
+		case SPDIF_DMA_CR_OFFSET:
+			return Cr;
+		case SPDIF_DMA_SR_OFFSET:
+			return Sr;
+		case SPDIF_DMA_CURDESC_OFFSET:
+			return CurDesc;
+		case SPDIF_DMA_TAILDESC_OFFSET:
+			return TailDesc;
+		}
+		return 0;
+	}
+
+	Now += MEM_ACCESS_NS;
+	return *MemWord(Cpu, Addr);
+}
+
+void Xil_Out32(u32 Addr, u32 Value)
+{
+	if ((Addr & ~0xFFFFUL) != DMA_BASE) {
+		Now += MEM_ACCESS_NS;
+		*MemWord(Cpu, Addr) = Value;
+		return;
+	}
+
+	Now += AXI_ACCESS_NS;
+	DmaAdvance();
+
+	switch (Addr - DMA_BASE) {
+	case SPDIF_DMA_CR_OFFSET:
+		if ((Value & SPDIF_DMA_CR_RESET_MASK) != 0) {
+			DmaReset();
+			break;
+		}
+		if (((Value & SPDIF_DMA_CR_RUNSTOP_MASK) != 0) &&
+		    ((Cr & SPDIF_DMA_CR_RUNSTOP_MASK) == 0)) {
+			Sr &= ~(SPDIF_DMA_SR_HALTED_MASK |
+				SPDIF_DMA_SR_IDLE_MASK);
+			NextDesc = CurDesc;
+			FetchAt = Now + FETCH_NS;
+		}
+		if ((Value & SPDIF_DMA_CR_RUNSTOP_MASK) == 0) {
+			Sr |= SPDIF_DMA_SR_HALTED_MASK;
+			Busy = 0;
+			FetchAt = NEVER;
+			DoneAt = NEVER;
+		}
+		Cr = Value;
+		break;
+	case SPDIF_DMA_SR_OFFSET:
+		Sr &= ~(Value & SPDIF_DMA_SR_IRQ_ALL_MASK);
+		break;
+	case SPDIF_DMA_CURDESC_OFFSET:
+		if ((Sr & SPDIF_DMA_SR_HALTED_MASK) == 0) {
+			Misuse++;
+			break;
+		}
+		CurDesc = Value;
+		break;
+	case SPDIF_DMA_TAILDESC_OFFSET:
+		if ((Sr & SPDIF_DMA_SR_HALTED_MASK) != 0) {
+			Misuse++;
+			break;
+		}
+		TailDesc = Value;
+		if ((Sr & SPDIF_DMA_SR_IDLE_MASK) != 0) {
+			Sr &= ~SPDIF_DMA_SR_IDLE_MASK;
+			NextDesc = *MemWord(Ddr, CurDesc +
+					    SPDIF_DMA_BD_NXTDESC_OFFSET);
+			FetchAt = Now + FETCH_NS;
+		}
+		break;
+	}
+	UpdateIrq(Now);
+}
+
+/*
+ * Cache maintenance must cover a period buffer or descriptors only
+ */
+static void CheckRange(unsigned int Addr, unsigned Len)
+{
+	if ((Addr >= RING_ADDR) &&
+	    (Addr + Len <= RING_ADDR + NUM_BDS * SPDIF_DMA_BD_SIZE) &&
+	    ((Addr % SPDIF_DMA_BD_SIZE) == 0) &&
+	    ((Len % SPDIF_DMA_BD_SIZE) == 0)) {
+		return;
+	}
+	if ((Len == PeriodBytes) &&
+	    ((Addr == SILENCE_ADDR) || ((Addr >= BUF_ADDR) &&
+	     (((Addr - BUF_ADDR) % PeriodBytes) == 0)))) {
+		return;
+	}
+	Foreign++;
+}
+
+void Xil_DCacheFlushRange(unsigned int Addr, unsigned Len)
+{
+	u32 Line;
+	u32 End = (Addr + Len + CACHE_LINE - 1) & ~(CACHE_LINE - 1);
+
+	CheckRange(Addr, Len);
+	for (Line = Addr & ~(CACHE_LINE - 1); Line < End; Line += CACHE_LINE) {
+		memcpy(MemWord(Ddr, Line), MemWord(Cpu, Line),
+		       CACHE_LINE / 4 * sizeof(u32));
+		Now += LINE_NS;
+	}
+	FlushBytes += Len;
+}
+
+void Xil_DCacheInvalidateRange(unsigned int Addr, unsigned Len)
+{
+	u32 Line;
+	u32 End = (Addr + Len + CACHE_LINE - 1) & ~(CACHE_LINE - 1);
+
+	if ((Addr < RING_ADDR) ||
+	    (Addr + Len > RING_ADDR + NUM_BDS * SPDIF_DMA_BD_SIZE)) {
+		Foreign++;
+	}
+	for (Line = Addr & ~(CACHE_LINE - 1); Line < End; Line += CACHE_LINE) {
+		memcpy(MemWord(Cpu, Line), MemWord(Ddr, Line),
+		       CACHE_LINE / 4 * sizeof(u32));
+		Now += LINE_NS;
+	}
+}
+
+/*
+ * Application: write the next samples into a buffer, through the cache
+ */
+static void Fill(u32 BufAddr)
+{
+	u32 Index;
+
+	for (Index = 0; Index < PeriodBytes / 4; Index++) {
+		*MemWord(Cpu, BufAddr + Index * 4) = DATA_FLAG | ++Seq;
+	}
+}
+
+static int SubmitBuffer(u32 BufAddr)
+{
+	int Status;
+
+	Fill(BufAddr);
+	Status = SpdifDma_Submit(&Ring, BufAddr);
+	if (Status != XST_SUCCESS) {
+		printf("  submit failed, status %d\n", Status);
+	}
+	return Status;
+}
+
+static void PeriodDone(void *CallBackRef, u32 BufAddr)
+{
+	u32 Slot;
+
+	(void)CallBackRef;
+
+	if (!Sc->Task) {
+		(void)SubmitBuffer(BufAddr);
+		return;
+	}
+
+	Rand = Rand * 1103515245 + 12345;
+	Slot = (FreeHead + FreeCount++) % MAX_BUFS;
+	FreeQueue[Slot] = BufAddr;
+	FreeAt[Slot] = Now + Sc->Jitter * PeriodNs *
+		       ((Rand >> 8) & 0xFFFF) / 65536.0;
+}
+
+static double Delay(double T, double At, double Periods)
+{
+	double From = At * 1e9;
+	double To = From + Periods * PeriodNs;
+
+	return ((T >= From) && (T < To)) ? To : T;
+}
+
+static int RunScenario(const Scenario *ScPtr)
+{
+	SpdifDma_Config Config;
+	SpdifDma_Stats Stats;
+	double TIrq, TApp, T, Start;
+	u32 Index;
+	int Fail = 0;
+
+	Sc = ScPtr;
+	Now = 0;
+	CpuNs = 0;
+	FlushBytes = 0;
+	Foreign = 0;
+	Fetches = 0;
+	Misuse = 0;
+	Playing = 0;
+	Gaps = 0;
+	GapNs = 0;
+	LastSeq = 0;
+	DataWords = SilenceWords = BadWords = 0;
+	Seq = 0;
+	FreeHead = FreeCount = 0;
+	IrqLine = 0;
+	CurDesc = TailDesc = 0;
+	for (Index = 0; Index < MEM_SIZE / 4; Index++) {
+		Cpu[Index] = STALE;
+		Ddr[Index] = STALE;
+	}
+	DmaReset();
+
+	Config.DmaBaseAddr = DMA_BASE;
+	Config.BdRingAddr = RING_ADDR;
+	Config.NumBds = NUM_BDS;
+	Config.PeriodBytes = PeriodBytes;
+	Config.SilenceAddr = SILENCE_ADDR;
+	if (SpdifDma_CfgInitialize(&Ring, &Config) != XST_SUCCESS) {
+		printf("  initialize failed\n");
+		return 1;
+	}
+	SpdifDma_SetHandler(&Ring, PeriodDone, NULL);
+
+	for (Index = 0; Index < PeriodBytes / 4; Index++) {
+		*MemWord(Cpu, SILENCE_ADDR + Index * 4) = 0;
+	}
+	for (Index = 0; Index < Sc->NumBufs; Index++) {
+		Fail |= SubmitBuffer(BUF_ADDR + Index * PeriodBytes) != 0;
+	}
+	if (SpdifDma_Start(&Ring) != XST_SUCCESS) {
+		printf("  start failed\n");
+		return 1;
+	}
+	Start = Now;
+	CpuNs = 0;
+	FlushBytes = 0;
+
+	while (Now < RUN_NS) {
+		TIrq = NEVER;
+		if (IrqLine) {
+			TIrq = Delay(IrqRaisedAt + IRQ_LATENCY_NS,
+				     Sc->IrqOffAt, Sc->IrqOff);
+		}
+		TApp = NEVER;
+		if (FreeCount != 0) {
+			TApp = Delay(FreeAt[FreeHead], Sc->StallAt,
+				     Sc->Stall);
+		}
+
+		T = (FetchAt < DoneAt) ? FetchAt : DoneAt;
+		T = (TIrq < T) ? TIrq : T;
+		T = (TApp < T) ? TApp : T;
+		if (T >= NEVER) {
+			printf("  nothing left to do\n");
+			Fail = 1;
+			break;
+		}
+		if (T > Now) {
+			Now = T;
+		}
+		DmaAdvance();
+
+		if (IrqLine && (TIrq <= Now)) {
+			T = Now;
+			Now += IRQ_ENTRY_NS;
+			SpdifDma_IntrHandler(&Ring);
+			CpuNs += Now - T;
+		} else if ((FreeCount != 0) && (TApp <= Now)) {
+			T = Now;
+			Fail |= SubmitBuffer(FreeQueue[FreeHead]) != 0;
+			FreeHead = (FreeHead + 1) % MAX_BUFS;
+			FreeCount--;
+			CpuNs += Now - T;
+		}
+	}
+
+	SpdifDma_GetStats(&Ring, &Stats);
+	SpdifDma_Stop(&Ring);
+
+	printf("%-38s %6lu %5lu %4lu %7.1f %6lu %6lu %4lu %8.0f %6.3f%%\n",
+	       Sc->Name, Stats.Periods, Stats.Silence, Gaps, GapNs / 1000.0,
+	       Stats.Underruns, Stats.Interrupts, Stats.Errors,
+	       FlushBytes / ((Now - Start) / 1e9),
+	       CpuNs * 100.0 / (Now - Start));
+
+	if (BadWords != 0) {
+		printf("  %lu words out of order or stale\n", BadWords);
+		Fail = 1;
+	}
+	if ((Foreign != 0) || (Misuse != 0)) {
+		printf("  %lu cache operations outside the ring or periods, "
+		       "%lu ignored register writes\n", Foreign, Misuse);
+		Fail = 1;
+	}
+	if ((Gaps != 0) != Sc->ExpectGaps) {
+		printf("  sink gaps %lu, %s expected\n", Gaps,
+		       Sc->ExpectGaps ? "some" : "none");
+		Fail = 1;
+	}
+	if ((Stats.Underruns != 0) != Sc->ExpectUnderruns) {
+		printf("  underruns %lu, %s expected\n", Stats.Underruns,
+		       Sc->ExpectUnderruns ? "some" : "none");
+		Fail = 1;
+	}
+	if ((Stats.Errors != 0) != (Sc->ErrorFetch != 0)) {
+		printf("  DMA errors %lu\n", Stats.Errors);
+		Fail = 1;
+	}
+	/* Everything played must be data or silence, and the stream stays on */
+	if ((double)(DataWords + SilenceWords) * 4 * NsPerByte + GapNs <
+	    (Now - Start) - 2 * PeriodNs) {
+		printf("  stream fell behind the %u Hz rate\n", RATE_HZ);
+		Fail = 1;
+	}
+
+	return Fail;
+}
+
+int main(int argc, char *argv[])
+{
+	static const Scenario Scenarios[] = {
+		{ "callback refill, 2 buffers", 0, 2, 0,
+		  0, 0, 0, 0, 0, 0, 0 },
+		{ "task refill, 3 buffers, 0-0.75 period", 1, 3, 0.75,
+		  0, 0, 0, 0, 0, 0, 0 },
+		{ "task stalls for 10 periods", 1, 3, 0.2,
+		  2, 10, 0, 0, 0, 0, 1 },
+		{ "interrupts masked for 1.5 periods", 1, 3, 0.2,
+		  0, 0, 3, 1.5, 0, 0, 0 },
+		{ "interrupts masked for 6 periods", 1, 3, 0.2,
+		  0, 0, 3, 6, 0, 1, 1 },
+		{ "DMA decode error", 0, 2, 0,
+		  0, 0, 0, 0, 200, 0, 0 },
+	};
+	u32 Frames = 1024;
+	u32 Index;
+	int Fail = 0;
+
+	if (argc > 1) {
+		Frames = strtoul(argv[1], NULL, 0);
+	}
+	PeriodBytes = Frames * WORDS_PER_FRAME * 4;
+	if ((PeriodBytes == 0) || (BUF_ADDR + MAX_BUFS * PeriodBytes >
+				   MEM_BASE + MEM_SIZE) ||
+	    (PeriodBytes > 0x1F000)) {
+		fprintf(stderr, "period of %lu frames not supported\n",
+			Frames);
+		return 1;
+	}
+	NsPerByte = 1e9 / ((double)RATE_HZ * WORDS_PER_FRAME * 4);
+	PeriodNs = PeriodBytes * NsPerByte;
+
+	printf("%u Hz stereo, period %lu frames, %lu bytes, %.2f ms, "
+	       "%u descriptors, %.0f s\n", RATE_HZ, Frames, PeriodBytes,
+	       PeriodNs / 1e6, NUM_BDS, RUN_NS / 1e9);
+	printf("%-38s %6s %5s %4s %7s %6s %6s %4s %8s %7s\n", "scenario",
+	       "played", "silnc", "gaps", "gap us", "undrn", "irqs", "err",
+	       "flush/s", "cpu");
+
+	for (Index = 0; Index < sizeof(Scenarios) / sizeof(Scenarios[0]);
+	     Index++) {
+		Fail |= RunScenario(&Scenarios[Index]);
+	}
+
+	printf("%s\n", Fail ? "FAILED" : "all scenarios OK");
+
+	return Fail;
+}
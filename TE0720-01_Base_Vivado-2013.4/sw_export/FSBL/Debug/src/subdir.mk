@@ -4,10 +4,12 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../src/crc32c.c \
 ../src/ddr_init.c \
 ../src/ff.c \
 ../src/fsbl_hooks.c \
 ../src/image_mover.c \
+../src/lz4.c \
 ../src/main.c \
 ../src/md5.c \
 ../src/mmc.c \
@@ -16,8 +18,13 @@ C_SRCS += \
 ../src/pcap.c \
 ../src/ps7_init.c \
 ../src/qspi.c \
+../src/qspical.c \
+../src/readback.c \
 ../src/rsa.c \
-../src/sd.c 
+../src/sd.c \
+../src/sdmanifest.c \
+../src/usb.c \
+../src/warmboot.c 
 
 LD_SRCS += \
 ../src/lscript.ld 
@@ -26,11 +33,13 @@ S_UPPER_SRCS += \
 ../src/fsbl_handoff.S 
 
 OBJS += \
+./src/crc32c.o \
 ./src/ddr_init.o \
 ./src/ff.o \
 ./src/fsbl_handoff.o \
 ./src/fsbl_hooks.o \
 ./src/image_mover.o \
+./src/lz4.o \
 ./src/main.o \
 ./src/md5.o \
 ./src/mmc.o \
@@ -39,14 +48,21 @@ OBJS += \
 ./src/pcap.o \
 ./src/ps7_init.o \
 ./src/qspi.o \
+./src/qspical.o \
+./src/readback.o \
 ./src/rsa.o \
-./src/sd.o 
+./src/sd.o \
+./src/sdmanifest.o \
+./src/usb.o \
+./src/warmboot.o 
 
 C_DEPS += \
+./src/crc32c.d \
 ./src/ddr_init.d \
 ./src/ff.d \
 ./src/fsbl_hooks.d \
 ./src/image_mover.d \
+./src/lz4.d \
 ./src/main.d \
 ./src/md5.d \
 ./src/mmc.d \
@@ -55,8 +71,13 @@ C_DEPS += \
 ./src/pcap.d \
 ./src/ps7_init.d \
 ./src/qspi.d \
+./src/qspical.d \
+./src/readback.d \
 ./src/rsa.d \
-./src/sd.d 
+./src/sd.d \
+./src/sdmanifest.d \
+./src/usb.d \
+./src/warmboot.d 
 
 S_UPPER_DEPS += \
 ./src/fsbl_handoff.d 
@@ -0,0 +1,229 @@
+/******************************************************************************
+*
+* (c) Copyright 2012-2013 Xilinx, Inc. All rights reserved.
+*
+* This file contains confidential and proprietary information of Xilinx, Inc.
+* and is protected under U.S. and international copyright and other
+* intellectual property laws.
+*
+* DISCLAIMER
+* This disclaimer is not a license and does not grant any rights to the
+* materials distributed herewith. Except as otherwise provided in a valid
+* license issued to you by Xilinx, and to the maximum extent permitted by
+* applicable law: (1) THESE MATERIALS ARE MADE AVAILABLE "AS IS" AND WITH ALL
+* FAULTS, AND XILINX HEREBY DISCLAIMS ALL WARRANTIES AND CONDITIONS, EXPRESS,
+* IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF
+* MERCHANTABILITY, NON-INFRINGEMENT, OR FITNESS FOR ANY PARTICULAR PURPOSE;
+* and (2) Xilinx shall not be liable (whether in contract or tort, including
+* negligence, or under any other theory of liability) for any loss or damage
+* of any kind or nature related to, arising under or in connection with these
+* materials, including for any direct, or any indirect, special, incidental,
+* or consequential loss or damage (including loss of data, profits, goodwill,
+* or any type of loss or damage suffered as a result of any action brought by
+* a third party) even if such damage or loss was reasonably foreseeable or
+* Xilinx had been advised of the possibility of the same.
+*
+* CRITICAL APPLICATIONS
+* Xilinx products are not designed or intended to be fail-safe, or for use in
+* any application requiring fail-safe performance, such as life-support or
+* safety devices or systems, Class III medical devices, nuclear facilities,
+* applications related to the deployment of airbags, or any other applications
+* that could lead to death, personal injury, or severe property or
+* environmental damage (individually and collectively, "Critical
+* Applications"). Customer assumes the sole risk and liability of any use of
+* Xilinx products in Critical Applications, subject only to applicable laws
+* and regulations governing limitations on product liability.
+*
+* THIS COPYRIGHT NOTICE AND DISCLAIMER MUST BE RETAINED AS PART OF THIS FILE
+* AT ALL TIMES.
+*
+*******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file crc32c.c
+*
+* Contains the CRC-32C kernel of the configuration readback.
+*
+* A word is folded in with four table lookups that do not depend on each
+* other (slice by 4), four words are loaded per step. With the data cache
+* off the four loads go out as one burst. Crc32cCompare() checks the words
+* against the expected data in the same pass, the data is read only once.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te	10/16/26 Initial release
+*
+* </pre>
+*
+* @note
+*	The Cortex-A9 has no CRC instructions and NEON only multiplies
+*	8-bit polynomials, the tables are the faster choice. They take 4KB
+*	and are built by Crc32cInit().
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#ifdef PCAP_READBACK_VERIFY
+#include "crc32c.h"
+
+/************************** Constant Definitions *****************************/
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+/*
+ * One word into the CRC
+ */
+#define CRC32C_WORD(Crc, Word)	do {						\
+		(Crc) ^= (Word);						\
+		(Crc) = Crc32cTable[3][(Crc) & 0xFF] ^			\
+				Crc32cTable[2][((Crc) >> 8) & 0xFF] ^		\
+				Crc32cTable[1][((Crc) >> 16) & 0xFF] ^		\
+				Crc32cTable[0][(Crc) >> 24];				\
+	} while (0)
+
+/************************** Function Prototypes ******************************/
+
+/************************** Variable Definitions *****************************/
+static u32 Crc32cTable[4][256];
+
+/******************************************************************************/
+/**
+*
+* This function builds the tables, Crc32cTable[n] advances a byte over n
+* more zero bytes.
+*
+* @param	None
+*
+* @return	None
+*
+* @note		None.
+*
+****************************************************************************/
+void Crc32cInit(void)
+{
+	u32 Index;
+	u32 Bit;
+	u32 Crc;
+
+	if (Crc32cTable[0][1] != 0) {
+		return;
+	}
+
+	for (Index = 0; Index < 256; Index++) {
+		Crc = Index;
+		for (Bit = 0; Bit < 8; Bit++) {
+			Crc = (Crc & 1) ? (Crc >> 1) ^ CRC32C_POLY : (Crc >> 1);
+		}
+		Crc32cTable[0][Index] = Crc;
+	}
+
+	for (Index = 0; Index < 256; Index++) {
+		Crc = Crc32cTable[0][Index];
+		for (Bit = 1; Bit < 4; Bit++) {
+			Crc = (Crc >> 8) ^ Crc32cTable[0][Crc & 0xFF];
+			Crc32cTable[Bit][Index] = Crc;
+		}
+	}
+}
+
+/******************************************************************************/
+/**
+*
+* This function adds words to a CRC.
+*
+* @param	Crc is the CRC so far, CRC32C_INIT for the first words
+* @param	Data is the first word
+* @param	Words is the number of words
+*
+* @return	The CRC, not inverted
+*
+* @note		None.
+*
+****************************************************************************/
+u32 Crc32cWords(u32 Crc, const u32 *Data, u32 Words)
+{
+	u32 Data0;
+	u32 Data1;
+	u32 Data2;
+	u32 Data3;
+
+	while (Words >= 4) {
+		Data0 = Data[0];
+		Data1 = Data[1];
+		Data2 = Data[2];
+		Data3 = Data[3];
+		CRC32C_WORD(Crc, Data0);
+		CRC32C_WORD(Crc, Data1);
+		CRC32C_WORD(Crc, Data2);
+		CRC32C_WORD(Crc, Data3);
+		Data += 4;
+		Words -= 4;
+	}
+
+	while (Words-- > 0) {
+		CRC32C_WORD(Crc, *Data);
+		Data++;
+	}
+
+	return Crc;
+}
+
+/******************************************************************************/
+/**
+*
+* This function adds words to a CRC and compares them to the expected
+* words.
+*
+* @param	Crc is the CRC so far, CRC32C_INIT for the first words
+* @param	Data is the first word
+* @param	Expected is the first expected word
+* @param	Words is the number of words
+* @param	Diff is ORed with the bits that differ
+*
+* @return	The CRC, not inverted
+*
+* @note		None.
+*
+****************************************************************************/
+u32 Crc32cCompare(u32 Crc, const u32 *Data, const u32 *Expected, u32 Words,
+		u32 *Diff)
+{
+	u32 Data0;
+	u32 Data1;
+	u32 Data2;
+	u32 Data3;
+	u32 Bits = 0;
+
+	while (Words >= 4) {
+		Data0 = Data[0];
+		Data1 = Data[1];
+		Data2 = Data[2];
+		Data3 = Data[3];
+		Bits |= (Data0 ^ Expected[0]) | (Data1 ^ Expected[1]) |
+				(Data2 ^ Expected[2]) | (Data3 ^ Expected[3]);
+		CRC32C_WORD(Crc, Data0);
+		CRC32C_WORD(Crc, Data1);
+		CRC32C_WORD(Crc, Data2);
+		CRC32C_WORD(Crc, Data3);
+		Data += 4;
+		Expected += 4;
+		Words -= 4;
+	}
+
+	while (Words-- > 0) {
+		Bits |= *Data ^ *Expected;
+		CRC32C_WORD(Crc, *Data);
+		Data++;
+		Expected++;
+	}
+
+	*Diff |= Bits;
+	return Crc;
+}
+#endif
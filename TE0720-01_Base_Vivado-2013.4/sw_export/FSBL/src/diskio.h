@@ -32,6 +32,23 @@ DRESULT disk_write (BYTE, const BYTE*, DWORD, BYTE);
 DRESULT disk_ioctl (BYTE, BYTE, void*);
 
 
+/* Asynchronous read request (mmc.c) */
+
+typedef struct _DISK_REQ {
+	BYTE *buff;		/* Data buffer, word aligned */
+	DWORD sector;		/* Start sector number (LBA) */
+	BYTE count;		/* Sector count (1..128) */
+	volatile BYTE busy;	/* Nonzero until completed */
+	DRESULT res;		/* Result once completed */
+	void (*done)(struct _DISK_REQ*);	/* Completion callback or 0 */
+	struct _DISK_REQ *next;	/* Used by the driver */
+} DISK_REQ;
+
+DRESULT disk_read_submit (BYTE, DISK_REQ*);
+int disk_read_poll (BYTE);
+DRESULT disk_read_wait (BYTE, DISK_REQ*);
+void disk_read_post (BYTE, BYTE*, DWORD, void (*)(DISK_REQ*));
+
 
 /* Disk Status Bits (DSTATUS) */
 
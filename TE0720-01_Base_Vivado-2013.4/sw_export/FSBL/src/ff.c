@@ -2147,6 +2147,136 @@ FRESULT f_open (
 
 
 
+#if _FS_READAHEAD
+/*-----------------------------------------------------------------------*/
+/* Read Cluster Runs with Queued Requests                                */
+/*-----------------------------------------------------------------------*/
+
+#define RA_MAX_CC	128		/* Sectors per request */
+
+static
+DISK_REQ RaReq[_FS_READAHEAD];	/* Read requests, used in turn */
+static
+UINT RaNext;				/* Request to be used next */
+
+
+static
+FRESULT ra_queue (	/* FR_OK:Queued, FR_DISK_ERR:An earlier read failed */
+	FATFS *fs,		/* Pointer to the file system object */
+	BYTE *buff,		/* Pointer to the data buffer */
+	DWORD sect,		/* Start sector */
+	UINT cc			/* Number of sectors (1..RA_MAX_CC) */
+)
+{
+	DISK_REQ *rq = &RaReq[RaNext];
+
+
+	if (disk_read_wait(fs->drv, rq) != RES_OK)	/* Wait for the oldest request */
+		return FR_DISK_ERR;
+	rq->buff = buff;
+	rq->sector = sect;
+	rq->count = (BYTE)cc;
+	rq->done = 0;
+	if (disk_read_submit(fs->drv, rq) != RES_OK)
+		return FR_DISK_ERR;
+	RaNext = (RaNext + 1) % _FS_READAHEAD;
+
+	return FR_OK;
+}
+
+
+static
+FRESULT ra_flush (	/* FR_OK:Succeeded, FR_DISK_ERR:Disk error */
+	FATFS *fs,		/* Pointer to the file system object */
+	BYTE **buff,	/* Pointer to the data buffer of the run */
+	DWORD *sect,	/* Start sector of the run */
+	UINT *run,		/* Number of sectors in the run */
+	BYTE all		/* 0:Queue full requests only, 1:Queue all of the run */
+)
+{
+	FRESULT res;
+	UINT n;
+
+
+	while (*run >= RA_MAX_CC || (all && *run)) {
+		n = (*run < RA_MAX_CC) ? *run : RA_MAX_CC;
+		res = ra_queue(fs, *buff, *sect, n);
+		if (res != FR_OK) return res;
+		*buff += SS(fs) * n;
+		*sect += n;
+		*run -= n;
+	}
+
+	return FR_OK;
+}
+
+
+static
+FRESULT ra_wait (	/* FR_OK:All queued reads succeeded */
+	FATFS *fs		/* Pointer to the file system object */
+)
+{
+	FRESULT res = FR_OK;
+	UINT i;
+
+
+	for (i = 0; i < _FS_READAHEAD; i++) {
+		if (disk_read_wait(fs->drv, &RaReq[i]) != RES_OK)
+			res = FR_DISK_ERR;
+		RaReq[i].res = RES_OK;	/* Reported */
+	}
+
+	return res;
+}
+
+
+static
+FRESULT read_runs (	/* FR_OK:Succeeded, FR_DISK_ERR:Disk error, FR_INT_ERR:Broken chain */
+	FIL *fp,		/* Pointer to the file object */
+	BYTE *rbuff,	/* Pointer to the data buffer, word aligned */
+	DWORD sect,		/* Current sector */
+	UINT csect,		/* Sector offset of sect in the current cluster */
+	UINT cc			/* Number of sectors to read */
+)
+{
+	FATFS *fs = fp->fs;
+	FRESULT res;
+	DWORD clst = fp->curr_clust, nclst;
+	UINT run, n;
+
+
+	run = fs->csize - csect;				/* The run starts with the rest of the current cluster */
+	if (run > cc) run = cc;
+	cc -= run;
+
+	for (;;) {
+		res = ra_flush(fs, &rbuff, &sect, &run, (BYTE)!cc);	/* Queue what is known to be contiguous */
+		if (res != FR_OK || !cc) break;
+		nclst = get_fat(fs, clst);			/* Follow the chain while the card reads */
+		if (nclst <= 1) { res = FR_INT_ERR; break; }
+		if (nclst == 0xFFFFFFFF) { res = FR_DISK_ERR; break; }
+		if (nclst != clst + 1) {			/* Not adjacent, the run ends */
+			res = ra_flush(fs, &rbuff, &sect, &run, 1);
+			if (res != FR_OK) break;
+			sect = clust2sect(fs, nclst);
+			if (!sect) { res = FR_INT_ERR; break; }
+		}
+		clst = nclst;
+		n = (cc < fs->csize) ? cc : fs->csize;
+		run += n;
+		cc -= n;
+	}
+	fp->curr_clust = clst;
+
+	if (ra_wait(fs) != FR_OK && res == FR_OK)	/* Data is in the buffer on return */
+		res = FR_DISK_ERR;
+
+	return res;
+}
+#endif
+
+
+
 /*-----------------------------------------------------------------------*/
 /* Read File                                                             */
 /*-----------------------------------------------------------------------*/
@@ -2189,6 +2319,15 @@ FRESULT f_read (
 			if (!sect) ABORT(fp->fs, FR_INT_ERR);
 			sect += csect;
 			cc = btr / SS(fp->fs);					/* When remaining bytes >= sector size, */
+#if _FS_READAHEAD
+			if (cc && !((DWORD)rbuff & 3)) {		/* Read the cluster runs directly into a word aligned buffer */
+				res = read_runs(fp, rbuff, sect, csect, cc);
+				if (res != FR_OK) ABORT(fp->fs, res);
+				rcnt = SS(fp->fs) * cc;				/* Number of bytes transferred */
+				continue;
+			}
+			cc = 0;									/* DMA needs word alignment, use the sector buffer */
+#endif
 			if (cc) {								/* Read maximum contiguous sectors directly */
 				if (csect + cc > fp->fs->csize)		/* Clip at cluster boundary */
 					cc = fp->fs->csize - csect;
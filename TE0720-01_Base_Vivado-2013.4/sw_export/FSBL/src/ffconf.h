@@ -52,6 +52,15 @@
 /* To enable fast seek feature, set _USE_FASTSEEK to 1. */
 
 
+#ifndef _FS_READAHEAD
+#define	_FS_READAHEAD	4	/* 0:Disable or number of queued reads */
+#endif
+/* When _FS_READAHEAD is not 0, f_read reads adjacent clusters with the
+/  largest possible requests straight into a word aligned buffer, the reads
+/  are queued ahead while the cluster chain is followed. The disk I/O layer
+/  must provide disk_read_submit() and disk_read_wait(). */
+
+
 
 /*---------------------------------------------------------------------------/
 / Locale and Namespace Configurations
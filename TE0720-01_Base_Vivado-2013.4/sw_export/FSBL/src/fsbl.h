@@ -167,6 +167,19 @@
 *						Resolution: Modified the address calculation
 *						algorithm in dual parallel mode for QSPI
 *
+* 7.00a	te	10/16/26	Added USB_BOOT_SUPPORT and USB_INIT_FAIL
+*						Added PS7_INIT_SILICON and
+*						PS7_SILICON_MISMATCH_FAIL
+*						Added LZ4_SUPPORT and
+*						LZ4_SUPPORT_NOT_ENABLED_FAIL
+*						Added WARM_BOOT_SUPPORT and the reset reasons
+*						that keep DDR
+*						Added QSPI_LINEAR_WINDOW
+*						Added QSPI_CALIBRATION
+*						Added SD_MANIFEST_BOOT and SD_MANIFEST_FAIL
+*						Added PCAP_READBACK_VERIFY
+*						Added PCAP_ASYNC_LOAD
+*
 * </pre>
 *
 * </pre>
@@ -225,6 +238,70 @@
 * MMC_SUPPORT
 * This flag is used to enable MMC support feature
 *
+* USB_BOOT_SUPPORT
+* This flag is used to enable USB device boot. In JTAG boot mode FSBL then
+* enumerates as a vendor bulk device and loads the image sent by the host.
+* Without a host starting a download within USB_HOST_TIMEOUT_MS FSBL exits
+* to JTAG as usual
+*
+* PS7_INIT_SILICON
+* This flag can be set to 1, 2 or 3 at compilation time to build ps7_init
+* for silicon 1.0, 2.0 or 3.0 only. The init data of the other versions is
+* left out of the image. On other silicon ps7_init fails and FSBL reports
+* PS7_SILICON_MISMATCH_FAIL
+*
+* LZ4_SUPPORT
+* This flag is used to enable loading of LZ4 compressed PS partitions,
+* packed with the lz4pack tool. The stored blocks are read to
+* LZ4_BOUNCE_ADDR in DDR on non-linear boot devices
+*
+* WARM_BOOT_SUPPORT
+* This flag is used to enable the warm boot cache. After a watchdog, soft
+* or SRST reset, PS partitions with an MD5 checksum that are still intact
+* in DDR are not loaded again. The cache is kept at WARM_BOOT_CACHE_ADDR
+* which the application must not use
+*
+* QSPI_LINEAR_WINDOW
+* This flag is used to read QSPI flashes larger than 16MB in linear mode.
+* The flash bank register is switched only when a read crosses into
+* another 16MB window (32MB in dual parallel), instead of using I/O mode.
+* Only Micron and Spansion flashes have the bank register. Short reads take
+* a fraction of the I/O mode time, long reads in single and dual stack run
+* at about the I/O mode rate (tools/qspilinsim)
+*
+* QSPI_CALIBRATION
+* This flag is used to raise the QSPI clock above the default prescaler 8.
+* Prescalers 4 and 2 are tried with the loopback clock. The faster of them
+* that reads the FSBL partition bit identical, with the next faster one
+* passing too, is used and kept in the .qspical_cache section in OCM for
+* the next boot
+*
+* SD_MANIFEST_BOOT
+* This flag is used to enable SD boot from a manifest. When the file
+* SD_MANIFEST_FILE is on the card, the bitstream, ELF and raw files it lists
+* are loaded instead of the partitions of BOOT.BIN. Their FAT cluster chains
+* are indexed once and read with multi-sector reads. Each file must match
+* the MD5 digest of its manifest line. The manifest is not used when the
+* eFuse enforces RSA authentication
+*
+* PCAP_READBACK_VERIFY
+* This flag is used to read the configuration back through the PCAP after
+* a non secure bitstream download and compare it to the bitstream. Frames
+* that change while the design runs, LUTRAM and block RAM contents, are
+* skipped when FsblHookBeforeBitstreamDload() points ReadbackMask at a mask
+* with a bit per frame. With a mask a mismatch fails the download, without
+* one it is only reported. The region CRCs of the verified configuration
+* are kept at READBACK_TABLE_ADDR for ReadbackScrub()
+*
+* PCAP_ASYNC_LOAD
+* This flag is used to start the bitstream download and read and check the
+* following plain PS partitions while the fabric is programmed. A partition
+* that needs the PCAP or overlaps the bitstream in DDR waits for the
+* download first, FsblHookAfterBitstreamDload() is called once it is done.
+* With PCAP_READBACK_VERIFY the readback runs at the end of the download,
+* partitions overlapping READBACK_BUFFER_ADDR or READBACK_TABLE_ADDR wait
+* for it as well
+*
 *******************************************************************************/
 #ifndef XIL_FSBL_H
 #define XIL_FSBL_H
@@ -300,6 +377,11 @@ extern "C" {
 #define PARTITION_CHECKSUM_FAIL		0xA010 /**< Partition checksum fail */
 #define RSA_SUPPORT_NOT_ENABLED_FAIL	0xA011 /**< RSA not enabled fail */
 #define PS7_INIT_FAIL			0xA012 /**< ps7 Init Fail */
+#define USB_INIT_FAIL			0xA013 /**< USB Init Fail */
+#define PS7_SILICON_MISMATCH_FAIL	0xA014 /**< ps7 Init built for
+						other silicon */
+#define LZ4_SUPPORT_NOT_ENABLED_FAIL	0xA015 /**< LZ4 not enabled fail */
+#define SD_MANIFEST_FAIL		0xA016 /**< SD manifest boot fail */
 /*
  * FSBL Exception error codes
  */
@@ -364,6 +446,11 @@ extern "C" {
 
 #define RESET_REASON_SRST		0x00000020 /**< Reason for reset is SRST */
 #define RESET_REASON_SWDT		0x00000001 /**< Reason for reset is SWDT */
+#define RESET_REASON_AWDT0		0x00000002 /**< Reason for reset is AWDT0 */
+#define RESET_REASON_AWDT1		0x00000004 /**< Reason for reset is AWDT1 */
+#define RESET_REASON_SLC		0x00000008 /**< Reason for reset is SLCR
+												soft reset */
+#define RESET_REASON_POR		0x00000040 /**< Reason for reset is POR */
 
 /*
  * Golden image offset
@@ -65,6 +65,14 @@
 * 5.00a kc	07/30/13	Fix for CR#724165
 * 						Fix for CR#724166
 * 						Fix for CR#732062
+* 6.00a te	10/16/26	Reuse the checksum computed while streaming from USB
+*						LZ4 compressed PS partitions, LZ4_SUPPORT
+*						Warm boot cache, WARM_BOOT_SUPPORT
+* 7.00a te	10/16/26	Reuse the checksum computed during SD reads
+*						Program the fabric while the next partitions
+*						are loaded, PCAP_ASYNC_LOAD
+*						Partitions do not land on the readback buffer
+*						before the readback of PCAP_READBACK_VERIFY
 *
 * </pre>
 *
@@ -89,6 +97,27 @@
 #ifdef RSA_SUPPORT
 #include "rsa.h"
 #endif
+
+#ifdef USB_BOOT_SUPPORT
+#include "usb.h"
+#endif
+
+#ifdef XPAR_PS7_SD_0_S_AXI_BASEADDR
+#include "sd.h"
+#endif
+
+#ifdef LZ4_SUPPORT
+#include <string.h>
+#include "lz4.h"
+#endif
+
+#ifdef WARM_BOOT_SUPPORT
+#include "warmboot.h"
+#endif
+
+#if defined(PCAP_ASYNC_LOAD) && defined(PCAP_READBACK_VERIFY)
+#include "readback.h"
+#endif
 /************************** Constant Definitions *****************************/
 
 /* We are 32-bit machine */
@@ -103,6 +132,12 @@
 u32 ValidateParition(u32 StartAddr, u32 Length, u32 ChecksumOffset);
 u32 GetPartitionChecksum(u32 ChecksumOffset, u8 *Checksum);
 u32 CalcPartitionChecksum(u32 SourceAddr, u32 DataLength, u8 *Checksum);
+u32 ReadCompressedData(u32 SourceAddr, u32 Length, u8 **Data);
+static u32 LoadBitstream(u32 *SourceDataPtr, u32 *DestinationDataPtr,
+		u32 SourceLength, u32 DestinationLength, u32 SecureTransfer);
+#ifdef PCAP_ASYNC_LOAD
+static void WaitBitstream(void);
+#endif
 
 /************************** Variable Definitions *****************************/
 /*
@@ -113,12 +148,18 @@ u8 PLPartitionFlag;
 u8 PSPartitionFlag;
 u8 SignedPartitionFlag;
 u8 PartitionChecksumFlag;
+u8 CompressedPartitionFlag;
 u8 BitstreamFlag;
 u8 ApplicationFlag;
 
 u32 ExecutionAddress;
 ImageMoverType MoveImage;
 
+/*
+ * Bytes the last PartitionMove placed at the load address
+ */
+u32 PartitionLoadLength;
+
 /*
  * Header array
  */
@@ -126,6 +167,30 @@ PartHeader PartitionHeader[MAX_PARTITION_NUMBER];
 u32 PartitionCount;
 u32 FsblLength;
 
+#ifdef LZ4_SUPPORT
+/*
+ * Checksum of the stored bytes of the last compressed partition
+ */
+static u8 CompressedChecksum[MD5_CHECKSUM_SIZE];
+#endif
+
+#ifdef PCAP_ASYNC_LOAD
+/*
+ * Bitstream being programmed and the source range it is read from, which
+ * must not be overwritten until the load is done
+ */
+static PcapAsyncToken BitstreamToken;
+static u32 BitstreamStart;
+static u32 BitstreamEnd;
+
+#ifdef PCAP_READBACK_VERIFY
+/*
+ * End of the readback buffer, PcapAsyncWait reads the frames back into it
+ */
+static u32 ReadbackEnd;
+#endif
+#endif
+
 #ifdef XPAR_XWDTPS_0_BASEADDR
 extern XWdtPs Watchdog;	/* Instance of WatchDog Timer	*/
 #endif
@@ -163,12 +228,20 @@ u32 LoadBootImage(void)
 	u32 PartitionLoadAddr;
 	u32 PartitionStartAddr;
 	u32 PartitionChecksumOffset;
+#ifdef PCAP_ASYNC_LOAD
+	u32 PartitionLoadEnd;
+#endif
 	u8 ExecAddrFlag = 0 ;
 	u32 Status;
 	PartHeader *HeaderPtr;
 	u32 EfuseStatusRegValue;
 #ifdef RSA_SUPPORT
 	u32 HeaderSize;
+#endif
+#ifdef WARM_BOOT_SUPPORT
+	u32 WarmBootFlag;
+	u8 CachePartitionFlag;
+	u8 FlashChecksum[MD5_CHECKSUM_SIZE];
 #endif
 	/*
 	 * Resetting the Flags
@@ -274,6 +347,13 @@ u32 LoadBootImage(void)
 		}
 	}
 
+#ifdef WARM_BOOT_SUPPORT
+	/*
+	 * Partitions loaded before a warm reset may still be in DDR
+	 */
+	WarmBootFlag = WarmBootOpen(ImageStartAddress);
+#endif
+
 #ifdef MMC_SUPPORT
 	/*
 	 * In case of MMC support
@@ -374,6 +454,25 @@ u32 LoadBootImage(void)
 			SignedPartitionFlag = 0;
 		}
 
+		/*
+		 * LZ4 compressed partition check
+		 */
+		if (PartitionAttr & ATTRIBUTE_COMPRESSED_MASK) {
+			fsbl_printf(DEBUG_INFO, "Compressed\r\n");
+#ifdef LZ4_SUPPORT
+			CompressedPartitionFlag = 1;
+#else
+			/*
+			 * In case user not enabled LZ4 decompression feature
+			 */
+			fsbl_printf(DEBUG_GENERAL,"LZ4_SUPPORT_NOT_ENABLED_FAIL\r\n");
+			OutputStatus(LZ4_SUPPORT_NOT_ENABLED_FAIL);
+			FsblFallback();
+#endif
+		} else {
+			CompressedPartitionFlag = 0;
+		}
+
 		/*
 		 * Load address check
 		 * Loop will break when PS load address zero and partition is
@@ -407,6 +506,66 @@ u32 LoadBootImage(void)
         	ExecAddress = PartitionExecAddr;
         }
 
+#ifdef WARM_BOOT_SUPPORT
+		/*
+		 * Plain PS partitions with a checksum can be taken from the
+		 * warm boot cache, the stored checksum identifies the image
+		 */
+		CachePartitionFlag = 0;
+		if (PSPartitionFlag && PartitionChecksumFlag &&
+				(!(SignedPartitionFlag || EncryptedPartitionFlag))) {
+			CachePartitionFlag = 1;
+
+			if (WarmBootFlag &&
+					(GetPartitionChecksum(
+						(PartitionChecksumOffset << WORD_LENGTH_SHIFT),
+						&FlashChecksum[0]) == XST_SUCCESS) &&
+					(WarmBootLookup(PartitionNum, HeaderPtr,
+						&FlashChecksum[0]) == XST_SUCCESS)) {
+				fsbl_printf(DEBUG_INFO, "Partition intact in DDR\r\n");
+				PartitionNum++;
+				continue;
+			}
+		}
+
+		/*
+		 * Partition is loaded, the old cache entry is stale
+		 */
+		WarmBootDrop(PartitionNum);
+#endif
+
+#ifdef PCAP_ASYNC_LOAD
+		/*
+		 * Plain PS partitions are read and checked while the fabric is
+		 * programmed. Wait when the partition is a bitstream, needs the
+		 * PCAP or lands on the bitstream still being read from DDR, or
+		 * on the readback buffer and table written after the load
+		 */
+		PartitionLoadEnd = PartitionLoadAddr +
+				(PartitionTotalSize << WORD_LENGTH_SHIFT);
+		if (CompressedPartitionFlag) {
+			PartitionLoadEnd = DDR_END_ADDR;
+		}
+
+		if (PLPartitionFlag || LinearBootDeviceFlag ||
+				EncryptedPartitionFlag ||
+				((PartitionLoadAddr < BitstreamEnd) &&
+						(PartitionLoadEnd > BitstreamStart))) {
+			WaitBitstream();
+		}
+
+#ifdef PCAP_READBACK_VERIFY
+		if ((BitstreamEnd != 0) &&
+				(((PartitionLoadAddr < ReadbackEnd) &&
+					(PartitionLoadEnd > READBACK_BUFFER_ADDR)) ||
+				((PartitionLoadAddr <
+					(READBACK_TABLE_ADDR + sizeof(ReadbackTable))) &&
+					(PartitionLoadEnd > READBACK_TABLE_ADDR)))) {
+			WaitBitstream();
+		}
+#endif
+#endif
+
 		/*
 		 * FSBL user hook call before bitstream download
 		 */
@@ -497,7 +656,7 @@ u32 LoadBootImage(void)
 			 * Load Signed PL partition in Fabric
 			 */
 			if (PLPartitionFlag) {
-				Status = PcapLoadPartition((u32*)PartitionStartAddr,
+				Status = LoadBitstream((u32*)PartitionStartAddr,
 						(u32*)PartitionLoadAddr,
 						PartitionImageLength,
 						PartitionDataLength,
@@ -511,6 +670,7 @@ u32 LoadBootImage(void)
 		}
 
 
+#ifndef PCAP_ASYNC_LOAD
 		/*
 		 * FSBL user hook call after bitstream download
 		 */
@@ -522,12 +682,38 @@ u32 LoadBootImage(void)
 				FsblFallback();
 			}
 		}
+#endif
+
+#ifdef WARM_BOOT_SUPPORT
+		/*
+		 * Partition is validated, record it for the next warm reset
+		 */
+		if (CachePartitionFlag &&
+				(GetPartitionChecksum(
+					(PartitionChecksumOffset << WORD_LENGTH_SHIFT),
+					&FlashChecksum[0]) == XST_SUCCESS)) {
+			WarmBootRecord(PartitionNum, HeaderPtr, &FlashChecksum[0],
+					PartitionLoadLength);
+		}
+#endif
+
 		/*
 		 * Increment partition number
 		 */
 		PartitionNum++;
 	}
 
+#ifdef PCAP_ASYNC_LOAD
+	/*
+	 * The fabric must be programmed before the handoff
+	 */
+	WaitBitstream();
+#endif
+
+#ifdef WARM_BOOT_SUPPORT
+	WarmBootClose();
+#endif
+
 	return ExecAddress;
 }
 
@@ -1022,6 +1208,7 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
 	LoadAddr = Header->LoadAddr;
 	ImageWordLen = Header->ImageWordLen;
 	DataWordLen = Header->DataWordLen;
+	PartitionLoadLength = ImageWordLen << WORD_LENGTH_SHIFT;
 
 	/*
 	 * Add flash base address for linear boot devices
@@ -1030,6 +1217,24 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
 		SourceAddr += FlashReadBaseAddress;
 	}
 
+#ifdef LZ4_SUPPORT
+	/*
+	 * Compressed partition is decoded into the load address while
+	 * it is read, only plain PS partitions can be compressed
+	 */
+	if (CompressedPartitionFlag) {
+		if ((!PSPartitionFlag) || EncryptedPartitionFlag ||
+				SignedPartitionFlag) {
+			fsbl_printf(DEBUG_GENERAL,
+					"Compressed partition is not a plain PS partition\r\n");
+			return XST_FAILURE;
+		}
+
+		return MoveCompressedPartition(SourceAddr, LoadAddr,
+				(ImageWordLen << WORD_LENGTH_SHIFT));
+	}
+#endif
+
 	/*
 	 * Partition encrypted
 	 */
@@ -1118,7 +1323,7 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
 	 * if checksum and authentication bits are not set
 	 */
 	if (PLPartitionFlag && (!(SignedPartitionFlag || PartitionChecksumFlag))) {
-		Status = PcapLoadPartition((u32*)SourceAddr,
+		Status = LoadBitstream((u32*)SourceAddr,
 					(u32*)Header->LoadAddr,
 					Header->ImageWordLen,
 					Header->DataWordLen,
@@ -1133,6 +1338,102 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
 }
 
 
+/******************************************************************************/
+/**
+*
+* This function loads a bitstream into the fabric using PCAP. With
+* PCAP_ASYNC_LOAD the load is only started, WaitBitstream finishes it
+*
+* @param 	SourceDataPtr is a pointer to where the data is read from
+* @param 	DestinationDataPtr is a pointer to where the data is written to
+* @param 	SourceLength is the length of the data to be moved in words
+* @param 	DestinationLength is the length of the data to be moved in words
+* @param 	SecureTransfer indicated the encryption key location, 0 for
+* 			non-encrypted
+*
+* @return
+*		- XST_SUCCESS if the bitstream is loaded or the load is started
+*		- XST_FAILURE if the load fails
+*
+* @note		None
+*
+****************************************************************************/
+static u32 LoadBitstream(u32 *SourceDataPtr, u32 *DestinationDataPtr,
+		u32 SourceLength, u32 DestinationLength, u32 SecureTransfer)
+{
+#ifdef PCAP_ASYNC_LOAD
+	u32 Status;
+
+	Status = PcapLoadPartitionStart(&BitstreamToken, SourceDataPtr,
+			SourceLength, DestinationLength, SecureTransfer, NULL, NULL);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	BitstreamStart = (u32)SourceDataPtr;
+	BitstreamEnd = BitstreamStart + (SourceLength << WORD_LENGTH_SHIFT);
+
+#ifdef PCAP_READBACK_VERIFY
+	/*
+	 * The frames read back are at most the bitstream and a pad frame
+	 */
+	ReadbackEnd = READBACK_BUFFER_ADDR + ((SourceLength +
+			(READBACK_PAD_FRAMES * READBACK_FRAME_WORDS)) <<
+			WORD_LENGTH_SHIFT);
+#endif
+
+	return XST_SUCCESS;
+#else
+	return PcapLoadPartition(SourceDataPtr, DestinationDataPtr,
+			SourceLength, DestinationLength, SecureTransfer);
+#endif
+}
+
+#ifdef PCAP_ASYNC_LOAD
+/******************************************************************************/
+/**
+*
+* This function waits for the bitstream started by LoadBitstream and calls
+* the user hook after bitstream download. It returns at once when no
+* bitstream is being programmed
+*
+* @param	None
+*
+* @return	None, a failed load falls back
+*
+* @note		None
+*
+****************************************************************************/
+static void WaitBitstream(void)
+{
+	u32 Status;
+
+	if (BitstreamToken.State == PCAP_ASYNC_IDLE) {
+		return;
+	}
+
+	Status = PcapAsyncWait(&BitstreamToken);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL,"BITSTREAM_DOWNLOAD_FAIL\r\n");
+		OutputStatus(BITSTREAM_DOWNLOAD_FAIL);
+		FsblFallback();
+	}
+
+	BitstreamStart = 0;
+	BitstreamEnd = 0;
+
+	/*
+	 * FSBL user hook call after bitstream download
+	 */
+	Status = FsblHookAfterBitstreamDload();
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL,"FSBL_AFTER_BSTREAM_HOOK_FAIL\r\n");
+		OutputStatus(FSBL_AFTER_BSTREAM_HOOK_FAIL);
+		FsblFallback();
+	}
+}
+#endif
+
 /******************************************************************************/
 /**
 *
@@ -1291,6 +1592,38 @@ u32 GetPartitionChecksum(u32 ChecksumOffset, u8 *Checksum)
 *******************************************************************************/
 u32 CalcPartitionChecksum(u32 SourceAddr, u32 DataLength, u8 *Checksum)
 {
+#ifdef LZ4_SUPPORT
+	/*
+	 * Compressed partition was checksummed over its stored bytes
+	 * while it was decoded
+	 */
+	if (CompressedPartitionFlag) {
+		memcpy(Checksum, CompressedChecksum, MD5_CHECKSUM_SIZE);
+		return XST_SUCCESS;
+	}
+#endif
+
+#if defined(USB_BOOT_SUPPORT) && defined(XPAR_PS7_USB_0_BASEADDR)
+	/*
+	 * Partition read from USB was checksummed while it was copied out of
+	 * the receive buffers
+	 */
+	if (UsbGetStreamChecksum(SourceAddr, DataLength, Checksum) ==
+			XST_SUCCESS) {
+		return XST_SUCCESS;
+	}
+#endif
+
+#ifdef XPAR_PS7_SD_0_S_AXI_BASEADDR
+	/*
+	 * Partition read from SD was checksummed during the read
+	 */
+	if (SdGetStreamChecksum(SourceAddr, DataLength, Checksum) ==
+			XST_SUCCESS) {
+		return XST_SUCCESS;
+	}
+#endif
+
 	/*
 	 * Calculate checksum using MD5 algorithm
 	 */
@@ -1299,3 +1632,206 @@ u32 CalcPartitionChecksum(u32 SourceAddr, u32 DataLength, u8 *Checksum)
     return XST_SUCCESS;
 }
 
+
+#ifdef LZ4_SUPPORT
+/******************************************************************************/
+/**
+*
+* This function reads stored bytes of a compressed partition
+*
+* @param	SourceAddr is the address of the data on the boot device
+* @param	Length is the number of bytes to read
+* @param	Data is filled with a pointer to the data
+*
+* @return
+*		- XST_SUCCESS if the data was read
+*		- XST_FAILURE if the read failed
+*
+* @note		Linear boot devices are read in place, other devices are
+*		read to LZ4_BOUNCE_ADDR which is overwritten by the next read.
+*
+*******************************************************************************/
+u32 ReadCompressedData(u32 SourceAddr, u32 Length, u8 **Data)
+{
+	u32 Status;
+
+	if (LinearBootDeviceFlag) {
+		*Data = (u8 *)SourceAddr;
+		return XST_SUCCESS;
+	}
+
+	Status = MoveImage(SourceAddr, LZ4_BOUNCE_ADDR, Length);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	*Data = (u8 *)LZ4_BOUNCE_ADDR;
+
+	return XST_SUCCESS;
+}
+
+
+/******************************************************************************/
+/**
+*
+* This function loads a LZ4 compressed partition.
+* The stored blocks are read one by one, each read also fetches the length
+* word of the next block. Every block is decoded into the load address
+* right after it was read, the MD5 checksum of the stored bytes is
+* computed on the way when the partition has a checksum.
+*
+* @param	SourceAddr is the address of the partition on the boot device
+* @param	LoadAddr is the address the partition is decoded to
+* @param	StoredLength is the stored length of the partition in bytes
+*
+* @return
+*		- XST_SUCCESS if the partition was decoded
+*		- XST_FAILURE if the read failed or the stream is corrupted
+*
+* @note		None
+*
+*******************************************************************************/
+u32 MoveCompressedPartition(u32 SourceAddr, u32 LoadAddr, u32 StoredLength)
+{
+	MD5Context Context;
+	u8 *Data;
+	u32 Status;
+	u32 Length;
+	u32 BlockSize;
+	u32 BlockLen;
+	u32 ReadLen;
+	u32 Consumed;
+	u32 Decoded;
+	u32 DictLen;
+	u32 OutLen;
+
+	if (StoredLength < (LZ4_STREAM_HDR_LEN + LZ4_BLOCK_HDR_LEN)) {
+		fsbl_printf(DEBUG_GENERAL, "Compressed partition too short\r\n");
+		return XST_FAILURE;
+	}
+
+	MD5Init(&Context);
+
+	/*
+	 * Stream header and length of the first block
+	 */
+	ReadLen = LZ4_STREAM_HDR_LEN + LZ4_BLOCK_HDR_LEN;
+	Status = ReadCompressedData(SourceAddr, ReadLen, &Data);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL, "Move Image Failed\r\n");
+		return XST_FAILURE;
+	}
+
+	Status = Lz4GetStreamInfo(Data, &Length, &BlockSize);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL, "Invalid compressed partition header\r\n");
+		return XST_FAILURE;
+	}
+
+	/*
+	 * Decoded partition has to fit into DDR and must not overlap
+	 * the bounce buffer
+	 */
+	if ((Length > (DDR_END_ADDR - LoadAddr + 1)) ||
+			((!LinearBootDeviceFlag) &&
+			(LoadAddr < (LZ4_BOUNCE_ADDR + LZ4_BOUNCE_SIZE)) &&
+			((LoadAddr + Length) > LZ4_BOUNCE_ADDR))) {
+		fsbl_printf(DEBUG_GENERAL, "INVALID_LOAD_ADDRESS_FAIL\r\n");
+		return XST_FAILURE;
+	}
+
+	fsbl_printf(DEBUG_INFO, "Compressed 0x%08x to 0x%08x bytes\r\n",
+			StoredLength, Length);
+
+	if (PartitionChecksumFlag) {
+		MD5Update(&Context, Data, ReadLen, 0);
+	}
+
+	BlockLen = LZ4_GET_WORD(Data + LZ4_STREAM_HDR_LEN);
+	Consumed = ReadLen;
+	Decoded = 0;
+
+	while (BlockLen != 0) {
+		/*
+		 * Stored block and the length word of the next one
+		 */
+		ReadLen = (BlockLen & LZ4_BLOCK_LEN_MASK) + LZ4_BLOCK_HDR_LEN;
+		if (((BlockLen & LZ4_BLOCK_LEN_MASK) > BlockSize) ||
+				(ReadLen > (StoredLength - Consumed))) {
+			fsbl_printf(DEBUG_GENERAL, "Invalid compressed block length\r\n");
+			return XST_FAILURE;
+		}
+
+		Status = ReadCompressedData(SourceAddr + Consumed, ReadLen, &Data);
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL, "Move Image Failed\r\n");
+			return XST_FAILURE;
+		}
+
+		if (PartitionChecksumFlag) {
+			MD5Update(&Context, Data, ReadLen, 0);
+		}
+
+		if (BlockLen & LZ4_BLOCK_RAW_MASK) {
+			OutLen = BlockLen & LZ4_BLOCK_LEN_MASK;
+			if (OutLen > (Length - Decoded)) {
+				fsbl_printf(DEBUG_GENERAL, "Compressed partition overrun\r\n");
+				return XST_FAILURE;
+			}
+			memcpy((u8 *)(LoadAddr + Decoded), Data, OutLen);
+		} else {
+			DictLen = Decoded;
+			if (DictLen > LZ4_WINDOW_SIZE) {
+				DictLen = LZ4_WINDOW_SIZE;
+			}
+
+			Status = Lz4DecompressBlock(Data, ReadLen - LZ4_BLOCK_HDR_LEN,
+					(u8 *)(LoadAddr + Decoded), Length - Decoded,
+					DictLen, &OutLen);
+			if (Status != XST_SUCCESS) {
+				fsbl_printf(DEBUG_GENERAL,
+						"Compressed block at 0x%08x corrupted\r\n", Consumed);
+				return XST_FAILURE;
+			}
+		}
+
+		Decoded += OutLen;
+		Consumed += ReadLen;
+		BlockLen = LZ4_GET_WORD(Data + ReadLen - LZ4_BLOCK_HDR_LEN);
+
+#ifdef	XPAR_XWDTPS_0_BASEADDR
+		/*
+		 * Prevent WDT reset
+		 */
+		XWdtPs_RestartWdt(&Watchdog);
+#endif
+	}
+
+	if ((Decoded != Length) ||
+			((StoredLength - Consumed) >= LZ4_BLOCK_HDR_LEN)) {
+		fsbl_printf(DEBUG_GENERAL, "Compressed partition length mismatch\r\n");
+		return XST_FAILURE;
+	}
+
+	if (PartitionChecksumFlag) {
+		/*
+		 * Padding behind the end of the stream is covered by the checksum
+		 */
+		if (Consumed < StoredLength) {
+			Status = ReadCompressedData(SourceAddr + Consumed,
+					StoredLength - Consumed, &Data);
+			if (Status != XST_SUCCESS) {
+				fsbl_printf(DEBUG_GENERAL, "Move Image Failed\r\n");
+				return XST_FAILURE;
+			}
+			MD5Update(&Context, Data, StoredLength - Consumed, 0);
+		}
+
+		MD5Final(&Context, CompressedChecksum, 0);
+	}
+
+	PartitionLoadLength = Decoded;
+
+	return XST_SUCCESS;
+}
+#endif
@@ -104,6 +104,7 @@ extern "C" {
 #define ATTRIBUTE_PL_IMAGE_MASK			0x20	/* Bit stream partition */
 #define ATTRIBUTE_CHECKSUM_TYPE_MASK	0x7000	/* Checksum Type */
 #define ATTRIBUTE_RSA_PRESENT_MASK		0x8000	/* RSA Signature Present */
+#define ATTRIBUTE_COMPRESSED_MASK		0x100000	/* LZ4 compressed */
 
 
 /**************************** Type Definitions *******************************/
@@ -151,6 +152,7 @@ void HeaderDump(PartHeader *Header);
 u32 GetPartitionCount(PartHeader *Header);
 u32 ValidateHeader(PartHeader *Header);
 u32 DecryptPartition(u32 StartAddr, u32 DataLength, u32 ImageLength);
+u32 MoveCompressedPartition(u32 SourceAddr, u32 LoadAddr, u32 StoredLength);
 
 /************************** Variable Definitions *****************************/
 
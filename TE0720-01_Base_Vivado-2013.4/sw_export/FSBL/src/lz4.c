@@ -0,0 +1,232 @@
+/******************************************************************************
+*
+* (c) Copyright 2012-2013 Xilinx, Inc. All rights reserved.
+*
+* This file contains confidential and proprietary information of Xilinx, Inc.
+* and is protected under U.S. and international copyright and other
+* intellectual property laws.
+*
+* DISCLAIMER
+* This disclaimer is not a license and does not grant any rights to the
+* materials distributed herewith. Except as otherwise provided in a valid
+* license issued to you by Xilinx, and to the maximum extent permitted by
+* applicable law: (1) THESE MATERIALS ARE MADE AVAILABLE "AS IS" AND WITH ALL
+* FAULTS, AND XILINX HEREBY DISCLAIMS ALL WARRANTIES AND CONDITIONS, EXPRESS,
+* IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF
+* MERCHANTABILITY, NON-INFRINGEMENT, OR FITNESS FOR ANY PARTICULAR PURPOSE;
+* and (2) Xilinx shall not be liable (whether in contract or tort, including
+* negligence, or under any other theory of liability) for any loss or damage
+* of any kind or nature related to, arising under or in connection with these
+* materials, including for any direct, or any indirect, special, incidental,
+* or consequential loss or damage (including loss of data, profits, goodwill,
+* or any type of loss or damage suffered as a result of any action brought by
+* a third party) even if such damage or loss was reasonably foreseeable or
+* Xilinx had been advised of the possibility of the same.
+*
+* CRITICAL APPLICATIONS
+* Xilinx products are not designed or intended to be fail-safe, or for use in
+* any application requiring fail-safe performance, such as life-support or
+* safety devices or systems, Class III medical devices, nuclear facilities,
+* applications related to the deployment of airbags, or any other applications
+* that could lead to death, personal injury, or severe property or
+* environmental damage (individually and collectively, "Critical
+* Applications"). Customer assumes the sole risk and liability of any use of
+* Xilinx products in Critical Applications, subject only to applicable laws
+* and regulations governing limitations on product liability.
+*
+* THIS COPYRIGHT NOTICE AND DISCLAIMER MUST BE RETAINED AS PART OF THIS FILE
+* AT ALL TIMES.
+*
+*******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file lz4.c
+*
+* Contains the LZ4 block decoder used to load compressed partitions.
+*
+* The decoder checks every literal run, match offset and match length
+* against the input and output bounds, a corrupted block makes it fail
+* instead of writing outside the load region.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te	10/16/26 Initial release
+*
+* </pre>
+*
+* @note
+*	The stream format is described in lz4.h, images are packed by the
+*	lz4pack host tool.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "xparameters.h"
+#include "fsbl.h"
+#ifdef LZ4_SUPPORT
+#include <string.h>
+#include "xstatus.h"
+#include "lz4.h"
+
+/************************** Constant Definitions *****************************/
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+
+/************************** Variable Definitions *****************************/
+
+/******************************************************************************/
+/**
+*
+* This function checks the stream header of a compressed partition
+*
+* @param	Header is a pointer to the LZ4_STREAM_HDR_LEN bytes of the header
+* @param	Length is filled with the uncompressed length in bytes
+* @param	BlockSize is filled with the largest uncompressed block length
+*
+* @return
+*		- XST_SUCCESS if the header is valid
+*		- XST_FAILURE if the magic or the block size is wrong
+*
+* @note		None.
+*
+****************************************************************************/
+u32 Lz4GetStreamInfo(const u8 *Header, u32 *Length, u32 *BlockSize)
+{
+	u32 Magic;
+
+	Magic = LZ4_GET_WORD(Header);
+	if (Magic != LZ4_STREAM_MAGIC) {
+		return XST_FAILURE;
+	}
+
+	*Length = LZ4_GET_WORD(Header + 4);
+	*BlockSize = LZ4_GET_WORD(Header + 8);
+
+	if ((*BlockSize == 0) || (*BlockSize > LZ4_MAX_BLOCK_SIZE)) {
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function decodes one LZ4 block
+*
+* @param	Src is the start of the compressed block
+* @param	SrcLen is the length of the compressed block in bytes
+* @param	Dst is where the block is decoded to
+* @param	DstLen is the space left at Dst in bytes
+* @param	DictLen is the number of bytes already decoded in front of
+*		Dst, matches may refer back into them
+* @param	OutLen is filled with the number of bytes decoded
+*
+* @return
+*		- XST_SUCCESS if the block was decoded
+*		- XST_FAILURE if the block is corrupted or does not fit
+*
+* @note		Overlapping matches are copied in growing chunks, a run of
+*		one byte takes log2(length) copies instead of one per byte.
+*
+****************************************************************************/
+u32 Lz4DecompressBlock(const u8 *Src, u32 SrcLen, u8 *Dst, u32 DstLen,
+		u32 DictLen, u32 *OutLen)
+{
+	const u8 *Ip = Src;
+	const u8 *IpEnd = Src + SrcLen;
+	u8 *Op = Dst;
+	u8 *OpEnd = Dst + DstLen;
+	const u8 *Match;
+	u32 Token;
+	u32 Length;
+	u32 Offset;
+	u32 Chunk;
+	u8 Byte;
+
+	while (Ip < IpEnd) {
+		Token = *Ip++;
+
+		/*
+		 * Literal run
+		 */
+		Length = Token >> LZ4_ML_BITS;
+		if (Length == LZ4_RUN_MASK) {
+			do {
+				if (Ip >= IpEnd) {
+					return XST_FAILURE;
+				}
+				Byte = *Ip++;
+				Length += Byte;
+			} while (Byte == 0xFF);
+		}
+
+		if ((Length > (u32)(IpEnd - Ip)) || (Length > (u32)(OpEnd - Op))) {
+			return XST_FAILURE;
+		}
+
+		memcpy(Op, Ip, Length);
+		Op += Length;
+		Ip += Length;
+
+		/*
+		 * Last sequence of the block has no match
+		 */
+		if (Ip == IpEnd) {
+			break;
+		}
+
+		if ((IpEnd - Ip) < 2) {
+			return XST_FAILURE;
+		}
+		Offset = Ip[0] | (Ip[1] << 8);
+		Ip += 2;
+
+		if ((Offset == 0) || (Offset > ((u32)(Op - Dst) + DictLen))) {
+			return XST_FAILURE;
+		}
+
+		/*
+		 * Match
+		 */
+		Length = Token & LZ4_ML_MASK;
+		if (Length == LZ4_ML_MASK) {
+			do {
+				if (Ip >= IpEnd) {
+					return XST_FAILURE;
+				}
+				Byte = *Ip++;
+				Length += Byte;
+			} while (Byte == 0xFF);
+		}
+		Length += LZ4_MIN_MATCH;
+
+		if (Length > (u32)(OpEnd - Op)) {
+			return XST_FAILURE;
+		}
+
+		Match = Op - Offset;
+		while (Length > 0) {
+			Chunk = (u32)(Op - Match);
+			if (Chunk > Length) {
+				Chunk = Length;
+			}
+			memcpy(Op, Match, Chunk);
+			Op += Chunk;
+			Length -= Chunk;
+		}
+	}
+
+	*OutLen = (u32)(Op - Dst);
+
+	return XST_SUCCESS;
+}
+#endif
@@ -0,0 +1,131 @@
+/******************************************************************************
+*
+* (c) Copyright 2012-2013 Xilinx, Inc. All rights reserved.
+*
+* This file contains confidential and proprietary information of Xilinx, Inc.
+* and is protected under U.S. and international copyright and other
+* intellectual property laws.
+*
+* DISCLAIMER
+* This disclaimer is not a license and does not grant any rights to the
+* materials distributed herewith. Except as otherwise provided in a valid
+* license issued to you by Xilinx, and to the maximum extent permitted by
+* applicable law: (1) THESE MATERIALS ARE MADE AVAILABLE "AS IS" AND WITH ALL
+* FAULTS, AND XILINX HEREBY DISCLAIMS ALL WARRANTIES AND CONDITIONS, EXPRESS,
+* IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF
+* MERCHANTABILITY, NON-INFRINGEMENT, OR FITNESS FOR ANY PARTICULAR PURPOSE;
+* and (2) Xilinx shall not be liable (whether in contract or tort, including
+* negligence, or under any other theory of liability) for any loss or damage
+* of any kind or nature related to, arising under or in connection with these
+* materials, including for any direct, or any indirect, special, incidental,
+* or consequential loss or damage (including loss of data, profits, goodwill,
+* or any type of loss or damage suffered as a result of any action brought by
+* a third party) even if such damage or loss was reasonably foreseeable or
+* Xilinx had been advised of the possibility of the same.
+*
+* CRITICAL APPLICATIONS
+* Xilinx products are not designed or intended to be fail-safe, or for use in
+* any application requiring fail-safe performance, such as life-support or
+* safety devices or systems, Class III medical devices, nuclear facilities,
+* applications related to the deployment of airbags, or any other applications
+* that could lead to death, personal injury, or severe property or
+* environmental damage (individually and collectively, "Critical
+* Applications"). Customer assumes the sole risk and liability of any use of
+* Xilinx products in Critical Applications, subject only to applicable laws
+* and regulations governing limitations on product liability.
+*
+* THIS COPYRIGHT NOTICE AND DISCLAIMER MUST BE RETAINED AS PART OF THIS FILE
+* AT ALL TIMES.
+*
+*******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file lz4.h
+*
+* This file contains the interface for the LZ4 compressed partition support
+*
+* A compressed partition is stored as a stream header followed by blocks.
+* Every block starts with a word holding its stored length, bit 31 set
+* marks a block stored uncompressed. A zero length word ends the stream.
+*
+*	Offset	Contents
+*	0x00	LZ4_STREAM_MAGIC
+*	0x04	Uncompressed length in bytes
+*	0x08	Largest uncompressed block length in bytes
+*	0x0C	Reserved, zero
+*	0x10	First block length word
+*
+* Blocks are linked, a match may refer back into the output of the
+* previous blocks up to LZ4_WINDOW_SIZE bytes.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te	10/16/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___LZ4_H___
+#define ___LZ4_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+#define LZ4_STREAM_MAGIC		0x50345A4C	/* "LZ4P" */
+#define LZ4_STREAM_HDR_LEN		0x10
+#define LZ4_BLOCK_HDR_LEN		4
+#define LZ4_BLOCK_RAW_MASK		0x80000000
+#define LZ4_BLOCK_LEN_MASK		0x7FFFFFFF
+
+#define LZ4_MAX_BLOCK_SIZE		0x10000
+#define LZ4_WINDOW_SIZE			0xFFFF
+
+/*
+ * Sequence encoding
+ */
+#define LZ4_MIN_MATCH			4
+#define LZ4_ML_BITS				4
+#define LZ4_ML_MASK				0x0F
+#define LZ4_RUN_MASK			0x0F
+
+/*
+ * DDR buffer the stored blocks are read to on non-linear boot devices,
+ * it must not overlap any load address of the image
+ */
+#ifndef LZ4_BOUNCE_ADDR
+#define LZ4_BOUNCE_ADDR			0x3FE00000
+#endif
+#define LZ4_BOUNCE_SIZE			(LZ4_MAX_BLOCK_SIZE + 0x10)
+
+/***************** Macros (Inline Functions) Definitions *********************/
+/*
+ * Little endian word at a byte pointer of any alignment
+ */
+#define LZ4_GET_WORD(p)	((u32)(p)[0] | ((u32)(p)[1] << 8) | \
+						((u32)(p)[2] << 16) | ((u32)(p)[3] << 24))
+
+/************************** Function Prototypes ******************************/
+u32 Lz4GetStreamInfo(const u8 *Header, u32 *Length, u32 *BlockSize);
+
+u32 Lz4DecompressBlock(const u8 *Src, u32 SrcLen, u8 *Dst, u32 DstLen,
+		u32 DictLen, u32 *OutLen);
+
+/************************** Variable Definitions *****************************/
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___LZ4_H___ */
@@ -96,6 +96,12 @@
 *                                           changelogs in FSBL
 *                       Fix for CR#732865 - Backward compatibility for ps7_init
 *                       					function
+* 7.00a te  10/16/26    Added USB device boot in JTAG boot mode, JTAG
+*                       handoff when no host shows up
+*                       Return the QSPI bank to 0 before handoff and
+*                       fallback reset, QSPI_LINEAR_WINDOW
+*                       SD boot from a manifest of partition files,
+*                       SD_MANIFEST_BOOT
 * </pre>
 *
 * @note
@@ -119,6 +125,10 @@
 #include "nand.h"
 #include "nor.h"
 #include "sd.h"
+#ifdef SD_MANIFEST_BOOT
+#include "sdmanifest.h"
+#endif
+#include "usb.h"
 #include "pcap.h"
 #include "image_mover.h"
 #include "xparameters.h"
@@ -241,7 +251,11 @@ int main(void)
 	if (Status != FSBL_PS7_INIT_SUCCESS) {
 		fsbl_printf(DEBUG_GENERAL,"PS7_INIT_FAIL : %s\r\n",
 						getPS7MessageInfo(Status));
-		OutputStatus(PS7_INIT_FAIL);
+		if (Status == PS7_INIT_SILICON_MISMATCH) {
+			OutputStatus(PS7_SILICON_MISMATCH_FAIL);
+		} else {
+			OutputStatus(PS7_INIT_FAIL);
+		}
 		/*
 		 * Calling FsblHookFallback instead of Fallback
 		 * since, devcfg driver is not yet initialized
@@ -379,6 +393,26 @@ int main(void)
 	BootModeRegister = Xil_In32(BOOT_MODE_REG);
 	BootModeRegister &= BOOT_MODES_MASK;
 
+#if defined(USB_BOOT_SUPPORT) && defined(XPAR_PS7_USB_0_BASEADDR)
+	/*
+	 * In JTAG boot mode the image is received from a USB host, without a
+	 * host the JTAG handoff follows
+	 */
+	if (BootModeRegister == JTAG_MODE) {
+		fsbl_printf(DEBUG_GENERAL,"Boot mode is JTAG, waiting for USB\r\n");
+
+		Status = InitUsb();
+		if (Status == XST_SUCCESS) {
+			MoveImage = UsbAccess;
+			fsbl_printf(DEBUG_INFO,"USB Init Done \r\n");
+		} else if (Status != XST_NO_DATA) {
+			fsbl_printf(DEBUG_GENERAL,"USB_INIT_FAIL\r\n");
+			OutputStatus(USB_INIT_FAIL);
+			FsblFallback();
+		}
+	}
+#endif
+
 	/*
 	 * QSPI BOOT MODE
 	 */
@@ -482,6 +516,15 @@ int main(void)
 
 #endif
 
+#if defined(USB_BOOT_SUPPORT) && defined(XPAR_PS7_USB_0_BASEADDR)
+	/*
+	 * USB BOOT MODE
+	 */
+	if (MoveImage == UsbAccess) {
+		fsbl_printf(DEBUG_GENERAL,"Boot mode is JTAG, loading from USB\r\n");
+	} else
+#endif
+
 	/*
 	 * JTAG  BOOT MODE
 	 */
@@ -521,7 +564,8 @@ int main(void)
 	if ((FlashReadBaseAddress != XPS_QSPI_LINEAR_BASEADDR) &&
 			(FlashReadBaseAddress != XPS_NAND_BASEADDR) &&
 			(FlashReadBaseAddress != XPS_NOR_BASEADDR) &&
-			(FlashReadBaseAddress != XPS_SDIO0_BASEADDR)) {
+			(FlashReadBaseAddress != XPS_SDIO0_BASEADDR) &&
+			(FlashReadBaseAddress != XPS_USB0_BASEADDR)) {
 		fsbl_printf(DEBUG_GENERAL,"INVALID_FLASH_ADDRESS \r\n");
 		OutputStatus(INVALID_FLASH_ADDRESS);
 		FsblFallback();
@@ -548,6 +592,25 @@ int main(void)
 	 */
 	SystemInitFlag = 1;
 
+#if defined(SD_MANIFEST_BOOT) && defined(XPAR_PS7_SD_0_S_AXI_BASEADDR)
+	/*
+	 * The files of a manifest on the SD card replace the partitions
+	 * of the boot image, unless the eFuse enforces RSA
+	 */
+	if (FlashReadBaseAddress == XPS_SDIO0_BASEADDR) {
+		Status = SdManifestOpen(SD_MANIFEST_FILE);
+		if (Status == XST_FAILURE) {
+			fsbl_printf(DEBUG_GENERAL,"SD_MANIFEST_FAIL\r\n");
+			OutputStatus(SD_MANIFEST_FAIL);
+			FsblFallback();
+		}
+	}
+
+	if ((FlashReadBaseAddress == XPS_SDIO0_BASEADDR) &&
+			(Status == XST_SUCCESS)) {
+		HandoffAddress = SdManifestLoad();
+	} else
+#endif
 	/*
 	 * Load boot image
 	 */
@@ -679,6 +742,15 @@ void FsblFallback(void)
 		}
 	}
 
+#if defined(QSPI_LINEAR_WINDOW) && defined(XPAR_PS7_QSPI_LINEAR_0_S_AXI_BASEADDR)
+	/*
+	 * Boot ROM reads the flash with 24 bit addresses from bank 0
+	 */
+	if (FlashReadBaseAddress == XPS_QSPI_LINEAR_BASEADDR) {
+		ReleaseQspi();
+	}
+#endif
+
 	/*
 	 * Reset PS, so Boot ROM will restart
 	 */
@@ -751,6 +823,24 @@ void FsblHandoff(u32 FsblStartAddr)
 		FsblFallback();
 	}
 
+#if defined(USB_BOOT_SUPPORT) && defined(XPAR_PS7_USB_0_BASEADDR)
+	/*
+	 * Leave the bus before the application takes over the controller
+	 */
+	if (FlashReadBaseAddress == XPS_USB0_BASEADDR) {
+		ReleaseUsb();
+	}
+#endif
+
+#if defined(QSPI_LINEAR_WINDOW) && defined(XPAR_PS7_QSPI_LINEAR_0_S_AXI_BASEADDR)
+	/*
+	 * Application and Boot ROM expect the first 16MB in the linear window
+	 */
+	if (FlashReadBaseAddress == XPS_QSPI_LINEAR_BASEADDR) {
+		ReleaseQspi();
+	}
+#endif
+
 #ifdef XPAR_XWDTPS_0_BASEADDR
 	XWdtPs_Stop(&Watchdog);
 #endif
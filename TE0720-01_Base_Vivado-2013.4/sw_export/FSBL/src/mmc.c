@@ -61,6 +61,15 @@
 * 						To support MMC, added two separate functions
 * 						sd_init for SD initialization
 * 						mmc_init for MMC initialization
+* 7.00a te	10/16/26	Bus negotiation, the fastest bus width, timing
+* 						and clock the card and the controller support
+* 						is verified with a read back of a block, slower
+* 						modes are tried on errors
+* 7.00a te	10/16/26	Asynchronous reads, disk_read_submit() queues
+* 						requests that disk_read_poll() advances, reads
+* 						of disk_read() into a posted range return at once
+* 7.00a te	10/16/26	Queued reads into the posted range are reported
+* 						to its callback as well, for the FatFs read ahead
 *
 * </pre>
 *
@@ -91,6 +100,7 @@ const PARTITION VolToPart[] = {
 
 static DSTATUS Stat;	/* Disk status */
 static BYTE CardType;	/* b0:MMC, b1:SDv1, b2:SDv2, b3:Block addressing */
+static unsigned CardRca;	/* Relative card address */
 
 /* Block Count variable */
 static u16 blkcnt;
@@ -100,6 +110,26 @@ static u16 blksize;
 /* ADMA2 descriptor table */
 static u32 desc_table[4];
 
+/*
+ * Asynchronous reads, the request at the head of the queue is on the card.
+ * Completed requests with a callback wait in the done list until the
+ * callbacks of the requests before them returned.
+ */
+static DISK_REQ *req_head;
+static DISK_REQ *req_tail;
+static DISK_REQ *done_head;
+static DISK_REQ *done_tail;
+static BYTE in_callback;
+
+/* Requests for the reads of disk_read() into the posted range */
+#ifndef SD_READ_DEPTH
+#define SD_READ_DEPTH	2
+#endif
+static DISK_REQ post_req[SD_READ_DEPTH];
+static BYTE *post_start;
+static BYTE *post_end;
+static void (*post_done)(DISK_REQ *);
+
 #define sd_out32(OutAddress, Value)	Xil_Out32((XPAR_PS7_SD_0_S_AXI_BASEADDR) + (OutAddress), (Value))
 #define sd_out16(OutAddress, Value)	Xil_Out16((XPAR_PS7_SD_0_S_AXI_BASEADDR) + (OutAddress), (Value))
 #define sd_out8(OutAddress, Value)	Xil_Out8((XPAR_PS7_SD_0_S_AXI_BASEADDR) + (OutAddress), (Value))
@@ -112,10 +142,18 @@ static u32 desc_table[4];
 
 #define MMC_CLK_52M				52000000
 #define MMC_CLK_26M				26000000
-#define MMC_HS_SUPPORT			0x1
-#define MMC_4BIT_SUPPORT		0x1
 #define EXT_CSD_BUS_WIDTH		183
 #define EXT_CSD_HS_TIMING		185
+#define EXT_CSD_CARD_TYPE		196
+#define EXT_CSD_BUS_WIDTH_1		0
+#define EXT_CSD_BUS_WIDTH_4		1
+#define EXT_CSD_BUS_WIDTH_8		2
+#define EXT_CSD_BUS_WIDTH_DDR		4	/* Added to the 4/8 bit width */
+#define EXT_CSD_CARD_TYPE_52		0x02
+#define EXT_CSD_CARD_TYPE_DDR_52	0x04
+#define MMC_STATUS_SWITCH_ERROR		(0x1 << 7)
+#define MMC_STATUS_READY		(0x1 << 8)
+#define MMC_SWITCH_RETRY		10
 #define MMC_SWITCH_MODE_WRITE_BYTE	0x03
 #define MMC_OCR_REG_VALUE	((0x1 << 30) | (0x1FF << 15))
 
@@ -220,6 +258,7 @@ static void init_port(void)
 #define CMD9	(9)		/* SEND_CSD */
 #define CMD10	(10)		/* SEND_CID */
 #define CMD12	(12)		/* STOP_TRANSMISSION */
+#define CMD13	(13)		/* SEND_STATUS */
 #define ACMD13	(0x80+13)	/* SD_STATUS (SDC) */
 #define CMD16	(16)		/* SET_BLOCKLEN */
 #define CMD17	(17)		/* READ_SINGLE_BLOCK */
@@ -319,6 +358,7 @@ static int make_command (unsigned cmd)
 		break;
 		case CMD10:
 		case CMD12:
+		case CMD13:
 		case ACMD13:
 		case CMD16:
 			retval |= RSP_R1;
@@ -480,6 +520,45 @@ void setup_adma2_trans(BYTE *buff_ptr)
 }
 
 
+#define TRANS_PENDING	0
+#define TRANS_DONE	1
+#define TRANS_ERROR	2
+
+/******************************************************************************/
+/**
+*
+* This function checks once for the end of a DMA transfer
+*
+* @param	None
+*
+* @return	TRANS_PENDING while the transfer runs
+*			TRANS_DONE for success
+*			TRANS_ERROR for failure
+* @note		None
+*
+****************************************************************************/
+static BYTE dma_trans_state(void)
+{
+	u32 status;
+
+	status = sd_in32(SD_INT_STAT_R);
+	if (status & SD_INT_ERROR) {
+		fsbl_printf(DEBUG_GENERAL,"dma_trans_cmpl: Error: (0x%08x)\r\n",
+							status);
+		return TRANS_ERROR;
+	}
+
+	/*
+	 * Check for Transfer complete
+	 */
+	if (status & SD_INT_TRNS_CMPL) {
+		sd_out32(SD_INT_STAT_R, SD_INT_TRNS_CMPL);
+		return TRANS_DONE;
+	}
+
+	return TRANS_PENDING;
+}
+
 /******************************************************************************/
 /**
 *
@@ -494,223 +573,1016 @@ void setup_adma2_trans(BYTE *buff_ptr)
 ****************************************************************************/
 static BYTE dma_trans_cmpl(void)
 {
-	u32 status;
+	BYTE state;
 
 	/*
 	 * Poll until operation complete
 	 */
-	while (1) {
-		status = sd_in32(SD_INT_STAT_R);
-		if (status & SD_INT_ERROR) {
-			fsbl_printf(DEBUG_GENERAL,"dma_trans_cmpl: Error: (0x%08x)\r\n",
-								status);
-			return 0;
-		}
+	do {
+		state = dma_trans_state();
+	} while (state == TRANS_PENDING);
 
-		/*
-		 * Check for Transfer complete
-		 */
-        if (status & SD_INT_TRNS_CMPL) {
-        	sd_out32(SD_INT_STAT_R, SD_INT_TRNS_CMPL);
-        	break;
-        }
-	}
-	return 1;
+	return (state == TRANS_DONE);
 }
 
-/*--------------------------------------------------------------------------
-
-	Public Functions
+/*
+ * Bus negotiation
+ *
+ * The card (SCR and switch function status of a SD card, EXT_CSD of a MMC)
+ * and the controller capabilities give the bus modes both sides support.
+ * They are tried fastest first. A mode is taken when a block reads back the
+ * same as in the 1-bit default speed mode the card starts in, a switch or
+ * read error falls back to the next mode.
+ */
+#define BUS_TIMING_DS		0	/* Default speed */
+#define BUS_TIMING_HS		1	/* High speed */
+#define BUS_TIMING_DDR		2	/* Dual data rate, MMC DDR52 */
+#define BUS_TIMING_UNKNOWN	0xFF	/* After a failed switch */
 
----------------------------------------------------------------------------*/
+#define BUS_CAP_4BIT		0x01
+#define BUS_CAP_8BIT		0x02
+#define BUS_CAP_HS		0x04
+#define BUS_CAP_DDR		0x08
 
+/*
+ * Data lines wired to the card, the Zynq SD controllers have four
+ */
+#ifndef SD_BUS_WIDTH_MAX
+#define SD_BUS_WIDTH_MAX	4
+#endif
 
-/*-----------------------------------------------------------------------*/
-/* Get Disk Status							*/
-/*-----------------------------------------------------------------------*/
+typedef struct {
+	u8 width;	/* Data lines */
+	u8 timing;	/* BUS_TIMING_* */
+	u32 clock;	/* Highest SD clock in Hz */
+} bus_mode;
 
-DSTATUS disk_status (
-		BYTE drv	/* Drive number (0) */
-)
-{
-	DSTATUS s = Stat;
-	unsigned statusreg;
+static const bus_mode bus_modes[] = {
+#ifdef MMC_SUPPORT
+	{8, BUS_TIMING_DDR, MMC_CLK_52M},
+	{4, BUS_TIMING_DDR, MMC_CLK_52M},
+	{8, BUS_TIMING_HS, MMC_CLK_52M},
+	{4, BUS_TIMING_HS, MMC_CLK_52M},
+	{8, BUS_TIMING_DS, MMC_CLK_26M},
+	{4, BUS_TIMING_DS, MMC_CLK_26M},
+	{1, BUS_TIMING_HS, MMC_CLK_52M},
+	{1, BUS_TIMING_DS, MMC_CLK_26M}
+#else
+	{4, BUS_TIMING_HS, SD_CLK_50M},
+	{4, BUS_TIMING_DS, SD_CLK_25M},
+	{1, BUS_TIMING_HS, SD_CLK_50M},
+	{1, BUS_TIMING_DS, SD_CLK_25M}
+#endif
+};
 
-	statusreg = sd_in32(SD_PRES_STATE_R);
-	if (!(statusreg & SD_CARD_INS)) {
-			s = STA_NODISK | STA_NOINIT;
-	} else {
-		s &= ~STA_NODISK;
-		if (statusreg & SD_CARD_WP)
-			s |= STA_PROTECT;
-		else
-			s &= ~STA_PROTECT;
-	}
-		Stat = s;
+#define BUS_MODES	(sizeof(bus_modes) / sizeof(bus_modes[0]))
+#define BUS_MODE_BASE	(&bus_modes[BUS_MODES - 1])
 
-		return s;
-}
+/* Bus mode of the card */
+static u8 card_width;
+static u8 card_timing;
 
-/*-----------------------------------------------------------------------*/
-/* Initialize Disk Drive						 */
-/*-----------------------------------------------------------------------*/
+/* Block 0 read in the base mode and read back in a new mode */
+static u32 ref_block[SD_BLOCK_SZ / 4];
+static u32 probe_block[SD_BLOCK_SZ / 4];
 
-DSTATUS disk_initialize (
-		BYTE drv	/* Physical drive number (0) */
-)
+/******************************************************************************/
+/**
+*
+* This function sets the SD clock. The base clock is divided by a power of
+* two, the only divisors of a 2.00 host controller.
+*
+* @param	freq Highest SD clock in Hz
+*
+* @return	SD clock in Hz
+*
+* @note		None
+*
+****************************************************************************/
+static u32 set_clock(u32 freq)
 {
-	DSTATUS s;
+	u16 regval;
+	u16 clk_div = 0;
 
 	/*
-	 * Check if card is in the socket
+	 * Disable SD clock and internal clock
 	 */
-	s = disk_status(drv);
-	if (s & STA_NODISK) {
-		fsbl_printf(DEBUG_GENERAL,"No SD card present.\n");
-		return s;
-	}
+	regval = sd_in16(SD_CLK_CTL_R);
+	regval &= ~(SD_CLK_SD_EN|SD_CLK_INT_EN);
+	sd_out16(SD_CLK_CTL_R, regval);
 
 	/*
-	 * Initialize the host controller
+	 * Calculating clock divisor, the SD clock is SDIO_FREQ / (2 * clk_div)
 	 */
-	init_port();
-
-#ifdef MMC_SUPPORT
-	s = mmc_init();
-	if(s != RES_OK) {
-		fsbl_printf(DEBUG_GENERAL,"MMC Initialization Failed.\n");
-		return s;
-	}
-#else
-	s = sd_init();
-	if(s != RES_OK) {
-		fsbl_printf(DEBUG_GENERAL,"SD Initialization Failed.\n");
-		return s;
+	if (SDIO_FREQ > freq) {
+		clk_div = 1;
+		while ((SDIO_FREQ / (2 * clk_div) > freq) && (clk_div < 0x80)) {
+			clk_div <<= 1;
+		}
 	}
-#endif
-
-	if (CardType)		 /* Initialization succeeded */
-			s &= ~STA_NOINIT;
-	else			/* Initialization failed */
-			s |= STA_NOINIT;
-	Stat = s;
-
-	return s;
-}
 
+	/*
+	 * Enable Internal clock and wait for it to stabilize
+	 */
+	regval = (clk_div << SD_DIV_SHIFT) | SD_CLK_INT_EN;
+	sd_out16(SD_CLK_CTL_R, regval);
+	do {
+		regval = sd_in16(SD_CLK_CTL_R);
+	} while (!(regval & SD_CLK_INT_STABLE));
 
+	/*
+	 * Enable SD clock
+	 */
+	regval |= SD_CLK_SD_EN;
+	sd_out16(SD_CLK_CTL_R, regval);
 
-/*-----------------------------------------------------------------------*/
-/* Read Sector(s)							 */
-/*-----------------------------------------------------------------------*/
+	return clk_div ? (SDIO_FREQ / (2 * clk_div)) : SDIO_FREQ;
+}
 
-DRESULT disk_read (
-		BYTE drv,	/* Physical drive number (0) */
-		BYTE *buff,	/* Pointer to the data buffer to store read data */
-		DWORD sector,	/* Start sector number (LBA) */
-		BYTE count	/* Sector count (1..128) */
-)
+/******************************************************************************/
+/**
+*
+* This function reads the bus modes of the controller
+*
+* @param	None
+*
+* @return	BUS_CAP_* flags
+*
+* @note		8-bit needs SD_BUS_WIDTH_MAX 8 as well
+*
+****************************************************************************/
+static u32 host_caps(void)
 {
-	DSTATUS s;
-
-	s = disk_status(drv);
-	if (s & STA_NOINIT) return RES_NOTRDY;
-	if (!count) return RES_PARERR;
-	/* Convert LBA to byte address if needed */
-    if (!(CardType & CT_BLOCK)) sector *= SD_BLOCK_SZ;
+	u32 caps = 0;
+	u32 regval;
 
-    blkcnt = count;
-    blksize= SD_BLOCK_SZ;
-
-    /* set adma2 for transfer */
-    setup_adma2_trans(buff);
-
-    /* Multiple block read */
-    send_cmd(CMD18, sector, NULL);
+	regval = sd_in32(SD_CAPABILITIES_R);
+	if (SD_BUS_WIDTH_MAX >= 4) {
+		caps |= BUS_CAP_4BIT;
+	}
+	if ((SD_BUS_WIDTH_MAX >= 8) && (regval & SD_CAP_8BIT)) {
+		caps |= BUS_CAP_8BIT;
+	}
+	if (regval & SD_CAP_HS) {
+		caps |= BUS_CAP_HS;
+	}
 
-    /* check for dma transfer complete */
-    if (!dma_trans_cmpl()) {
-    	return RES_ERROR;
-    }
+	/*
+	 * DDR50 came with the 3.00 specification, the register is
+	 * reserved before
+	 */
+	if (((sd_in16(SD_HOST_VER_R) & SD_SPEC_VER_MASK) >= SD_SPEC_VER_300) &&
+			(sd_in32(SD_CAPABILITIES2_R) & SD_CAP2_DDR50)) {
+		caps |= BUS_CAP_DDR;
+	}
 
-    return RES_OK;
+	return caps;
 }
 
+/******************************************************************************/
+/**
+*
+* This function sets the data bus width of the controller
+*
+* @param	width Data lines
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+static void host_set_width(u8 width)
+{
+	u16 regval;
 
-/*-----------------------------------------------------------------------*/
-/* Miscellaneous Functions						*/
-/*-----------------------------------------------------------------------*/
+	regval = sd_in16(SD_HOST_CTRL_R);
+	regval &= ~(SD_HOST_4BIT|SD_HOST_8BIT);
+	if (width == 4) {
+		regval |= SD_HOST_4BIT;
+	} else if (width == 8) {
+		regval |= SD_HOST_8BIT;
+	}
+	sd_out16(SD_HOST_CTRL_R, regval);
+}
 
-DRESULT disk_ioctl (
-	BYTE drv,				/* Physical drive number (0) */
-	BYTE ctrl,				/* Control code */
-	void *buff				/* Buffer to send/receive control data */
-)
+/******************************************************************************/
+/**
+*
+* This function sets the controller to a bus mode
+*
+* @param	mode Bus mode
+*
+* @param	caps BUS_CAP_* flags of the negotiation
+*
+* @return	SD clock in Hz
+*
+* @note		None
+*
+****************************************************************************/
+static u32 host_set_bus(const bus_mode *mode, u32 caps)
 {
-	DRESULT res;
+	u16 regval;
 
-	if (disk_status(drv) & STA_NOINIT)	/* Check if card is in the socket */
-			return RES_NOTRDY;
+	host_set_width(mode->width);
 
-	res = RES_ERROR;
-	switch (ctrl) {
-		case CTRL_SYNC :	/* Make sure that no pending write process */
-			break;
+	regval = sd_in16(SD_HOST_CTRL_R);
+	regval &= ~SD_HOST_HS;
+	if (mode->timing != BUS_TIMING_DS) {
+		regval |= SD_HOST_HS;
+	}
+	sd_out16(SD_HOST_CTRL_R, regval);
 
-		case GET_SECTOR_COUNT : /* Get number of sectors on the disk (DWORD) */
-			break;
+	if (caps & BUS_CAP_DDR) {
+		regval = sd_in16(SD_HOST_CTRL2_R);
+		regval &= ~SD_CTRL2_UHS_MASK;
+		if (mode->timing == BUS_TIMING_DDR) {
+			regval |= SD_CTRL2_DDR50;
+		}
+		sd_out16(SD_HOST_CTRL2_R, regval);
+	}
 
-		case GET_BLOCK_SIZE :	/* Get erase block size in unit of sector (DWORD) */
-			*(DWORD*)buff = 128;
-			res = RES_OK;
-			break;
+	return set_clock(mode->clock);
+}
 
-		default:
-			res = RES_PARERR;
-			break;
+/******************************************************************************/
+/**
+*
+* This function checks a bus mode against the capabilities
+*
+* @param	mode Bus mode
+*
+* @param	caps BUS_CAP_* flags of the card and the controller
+*
+* @return	0 if not supported
+*			1 if supported
+*
+* @note		None
+*
+****************************************************************************/
+static BYTE bus_supported(const bus_mode *mode, u32 caps)
+{
+	if ((mode->width == 4) && !(caps & BUS_CAP_4BIT)) {
+		return 0;
+	}
+	if ((mode->width == 8) && !(caps & BUS_CAP_8BIT)) {
+		return 0;
+	}
+	if ((mode->timing != BUS_TIMING_DS) && !(caps & BUS_CAP_HS)) {
+		return 0;
+	}
+	if ((mode->timing == BUS_TIMING_DDR) && !(caps & BUS_CAP_DDR)) {
+		return 0;
 	}
 
-		return res;
+	return 1;
 }
 
 /******************************************************************************/
 /**
 *
-* This function is User Provided Timer Function for FatFs module
+* This function resets the command and data lines after an error
 *
 * @param	None
 *
-* @return	DWORD
+* @return	None
 *
 * @note		None
 *
 ****************************************************************************/
-DWORD get_fattime (void)
+static void reset_lines(void)
 {
-	return	((DWORD)(2010 - 1980) << 25)	/* Fixed to Jan. 1, 2010 */
-		| ((DWORD)1 << 21)
-		| ((DWORD)1 << 16)
-		| ((DWORD)0 << 11)
-		| ((DWORD)0 << 5)
-		| ((DWORD)0 >> 1);
+	sd_out8(SD_SOFT_RST_R, SD_RST_CMD|SD_RST_DATA);
+	while (sd_in8(SD_SOFT_RST_R)) {
+		;
+	}
 }
 
-
-
-#ifdef MMC_SUPPORT
-/*
- * MMC initialization
- */
-static DRESULT mmc_init(void)
-{
-	BYTE ty;
-	DSTATUS s;
+/******************************************************************************/
+/**
+*
+* This function reads block 0 of the card
+*
+* @param	buff Word aligned buffer of SD_BLOCK_SZ bytes
+*
+* @return	0 for failure
+*			1 for success
+*
+* @note		None
+*
+****************************************************************************/
+static BYTE read_block(u32 *buff)
+{
+	blkcnt = 1;
+	blksize = SD_BLOCK_SZ;
+
+	setup_adma2_trans((BYTE *)buff);
+
+	if (!send_cmd(CMD17, 0, NULL) || !dma_trans_cmpl()) {
+		reset_lines();
+		return 0;
+	}
+
+	return 1;
+}
+
+#ifdef MMC_SUPPORT
+/******************************************************************************/
+/**
+*
+* This function writes a byte of the MMC EXT_CSD and waits for the switch
+*
+* @param	index EXT_CSD byte
+*
+* @param	value Value to write
+*
+* @return	0 for failure
+*			1 for success
+*
+* @note		None
+*
+****************************************************************************/
+static BYTE mmc_switch(u8 index, u8 value)
+{
+	DWORD response;
+	int retry;
+
+	if (!send_cmd(CMD6, (MMC_SWITCH_MODE_WRITE_BYTE << 24) |
+			(index << 16) | (value << 8), &response)) {
+		return 0;
+	}
+
+	/*
+	 * Delay for device to setup, the status tells if the switch took
+	 */
+	for (retry = 0; retry < MMC_SWITCH_RETRY; retry++) {
+		usleep(1000);
+		if (!send_cmd(CMD13, CardRca << 16, &response) ||
+				(response & MMC_STATUS_SWITCH_ERROR)) {
+			return 0;
+		}
+		if (response & MMC_STATUS_READY) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/******************************************************************************/
+/**
+*
+* This function switches the MMC to a bus mode
+*
+* @param	mode Bus mode
+*
+* @return	0 for failure
+*			1 for success
+*
+* @note		None
+*
+****************************************************************************/
+static BYTE card_set_bus(const bus_mode *mode)
+{
+	u8 width;
+
+	width = (mode->width == 8) ? EXT_CSD_BUS_WIDTH_8 :
+			(mode->width == 4) ? EXT_CSD_BUS_WIDTH_4 : EXT_CSD_BUS_WIDTH_1;
+
+	/*
+	 * Single data rate first, HS_TIMING does not change in DDR
+	 */
+	if (!mmc_switch(EXT_CSD_BUS_WIDTH, width)) {
+		return 0;
+	}
+	card_width = mode->width;
+	if (card_timing == BUS_TIMING_DDR) {
+		card_timing = BUS_TIMING_HS;
+	}
+
+	if (!mmc_switch(EXT_CSD_HS_TIMING, mode->timing != BUS_TIMING_DS)) {
+		return 0;
+	}
+	card_timing = (mode->timing == BUS_TIMING_DS) ? BUS_TIMING_DS :
+			BUS_TIMING_HS;
+
+	if (mode->timing == BUS_TIMING_DDR) {
+		if (!mmc_switch(EXT_CSD_BUS_WIDTH, width + EXT_CSD_BUS_WIDTH_DDR)) {
+			return 0;
+		}
+		card_timing = BUS_TIMING_DDR;
+	}
+
+	return 1;
+}
+#else
+/******************************************************************************/
+/**
+*
+* This function switches the SD card to a bus mode
+*
+* @param	mode Bus mode
+*
+* @return	0 for failure
+*			1 for success
+*
+* @note		SD 1.0 cards do not know CMD6, it is only sent for a change
+*
+****************************************************************************/
+static BYTE card_set_bus(const bus_mode *mode)
+{
+	DWORD response;
+	u8 *status_data = (u8 *)probe_block;
+	u8 function;
+
+	/*
+	 * Width first, the switch status of a narrower bus still reads
+	 * when lines of the wide one fail
+	 */
+	if (mode->width != card_width) {
+		/*
+		 * Application specific command
+		 */
+		send_cmd(CMD55, CardRca << 16, &response);
+
+		/*
+		 * Set data bus width
+		 */
+		if (!send_cmd(ACMD6, (mode->width == 4) ? 2 : 0, &response)) {
+			return 0;
+		}
+		card_width = mode->width;
+		host_set_width(card_width);
+	}
+
+	if (mode->timing != card_timing) {
+		function = (mode->timing == BUS_TIMING_HS) ? 1 : 0;
+
+		/*
+		 * Switch function group 1, the card may have switched when
+		 * the status does not read
+		 */
+		card_timing = BUS_TIMING_UNKNOWN;
+		blkcnt = 1;
+		blksize = 64;
+		setup_adma2_trans(status_data);
+
+		if (!send_cmd(CMD6, 0x80FFFFF0 | function, &response) ||
+				!dma_trans_cmpl()) {
+			return 0;
+		}
+
+		/*
+		 * Function selected in group 1, 0xF if the switch failed
+		 */
+		if ((status_data[16] & 0xF) != function) {
+			return 0;
+		}
+		card_timing = mode->timing;
+	}
+
+	return 1;
+}
+#endif
+
+/******************************************************************************/
+/**
+*
+* This function switches the card and the controller to a bus mode and
+* reads block 0 back
+*
+* @param	mode Bus mode
+*
+* @param	caps BUS_CAP_* flags of the negotiation
+*
+* @param	clock SD clock in Hz set for the mode
+*
+* @return	0 for failure
+*			1 for success
+*
+* @note		None
+*
+****************************************************************************/
+static BYTE bus_try(const bus_mode *mode, u32 caps, u32 *clock)
+{
+	bus_mode current;
+	u32 index;
+
+	/*
+	 * Switch in default speed and the width the card is in
+	 */
+	current.width = card_width;
+	current.timing = BUS_TIMING_DS;
+	current.clock = BUS_MODE_BASE->clock;
+	host_set_bus(&current, caps);
+
+	if (!card_set_bus(mode)) {
+		reset_lines();
+		return 0;
+	}
+
+	*clock = host_set_bus(mode, caps);
+
+	if (!read_block(probe_block)) {
+		return 0;
+	}
+	for (index = 0; index < SD_BLOCK_SZ / 4; index++) {
+		if (probe_block[index] != ref_block[index]) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/******************************************************************************/
+/**
+*
+* This function selects the fastest bus mode that reads block 0 back
+*
+* @param	card_caps BUS_CAP_* flags of the card
+*
+* @return	0 for failure
+*			1 for success
+*
+* @note		The card has to be in the transfer state, 1-bit default speed
+*
+****************************************************************************/
+static BYTE bus_negotiate(u32 card_caps)
+{
+	const bus_mode *mode = BUS_MODE_BASE;
+	u32 caps;
+	u32 clock;
+	u32 index;
+	BYTE tried = 0;
+
+	caps = host_caps() & card_caps;
+	card_width = 1;
+	card_timing = BUS_TIMING_DS;
+
+	/*
+	 * Reference block in the mode the card starts in
+	 */
+	clock = host_set_bus(BUS_MODE_BASE, caps);
+	if (!read_block(ref_block)) {
+		return 0;
+	}
+
+	for (index = 0; index < BUS_MODES; index++) {
+		mode = &bus_modes[index];
+		if (!bus_supported(mode, caps)) {
+			continue;
+		}
+		/*
+		 * Nothing else supported, still in the reference mode
+		 */
+		if ((mode == BUS_MODE_BASE) && !tried) {
+			break;
+		}
+		tried = 1;
+		if (bus_try(mode, caps, &clock)) {
+			break;
+		}
+		fsbl_printf(DEBUG_GENERAL,"Bus %d bit %s failed\r\n", mode->width,
+				(mode->timing == BUS_TIMING_DDR) ? "DDR" :
+				(mode->timing == BUS_TIMING_HS) ? "high speed" :
+				"default speed");
+	}
+
+	if (index == BUS_MODES) {
+		return 0;
+	}
+
+	fsbl_printf(DEBUG_INFO,"Bus %d bit %s %d kHz\r\n", mode->width,
+			(mode->timing == BUS_TIMING_DDR) ? "DDR" :
+			(mode->timing == BUS_TIMING_HS) ? "high speed" :
+			"default speed", clock / 1000);
+
+	return 1;
+}
+
+/*--------------------------------------------------------------------------
+
+	Public Functions
+
+---------------------------------------------------------------------------*/
+
+
+/*-----------------------------------------------------------------------*/
+/* Get Disk Status							*/
+/*-----------------------------------------------------------------------*/
+
+DSTATUS disk_status (
+		BYTE drv	/* Drive number (0) */
+)
+{
+	DSTATUS s = Stat;
+	unsigned statusreg;
+
+	statusreg = sd_in32(SD_PRES_STATE_R);
+	if (!(statusreg & SD_CARD_INS)) {
+			s = STA_NODISK | STA_NOINIT;
+	} else {
+		s &= ~STA_NODISK;
+		if (statusreg & SD_CARD_WP)
+			s |= STA_PROTECT;
+		else
+			s &= ~STA_PROTECT;
+	}
+		Stat = s;
+
+		return s;
+}
+
+/*-----------------------------------------------------------------------*/
+/* Initialize Disk Drive						 */
+/*-----------------------------------------------------------------------*/
+
+DSTATUS disk_initialize (
+		BYTE drv	/* Physical drive number (0) */
+)
+{
+	DSTATUS s;
+
+	/*
+	 * Check if card is in the socket
+	 */
+	s = disk_status(drv);
+	if (s & STA_NODISK) {
+		fsbl_printf(DEBUG_GENERAL,"No SD card present.\n");
+		return s;
+	}
+
+	/*
+	 * Initialize the host controller
+	 */
+	init_port();
+
+#ifdef MMC_SUPPORT
+	s = mmc_init();
+	if(s != RES_OK) {
+		fsbl_printf(DEBUG_GENERAL,"MMC Initialization Failed.\n");
+		return s;
+	}
+#else
+	s = sd_init();
+	if(s != RES_OK) {
+		fsbl_printf(DEBUG_GENERAL,"SD Initialization Failed.\n");
+		return s;
+	}
+#endif
+
+	if (CardType)		 /* Initialization succeeded */
+			s &= ~STA_NOINIT;
+	else			/* Initialization failed */
+			s |= STA_NOINIT;
+	Stat = s;
+
+	return s;
+}
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Read Sector(s)							 */
+/*-----------------------------------------------------------------------*/
+
+DRESULT disk_read (
+		BYTE drv,	/* Physical drive number (0) */
+		BYTE *buff,	/* Pointer to the data buffer to store read data */
+		DWORD sector,	/* Start sector number (LBA) */
+		BYTE count	/* Sector count (1..128) */
+)
+{
+	DISK_REQ req;
+	DISK_REQ *post;
+	DRESULT res;
+	int i;
+
+	/*
+	 * Reads into the posted range return before the data is there
+	 */
+	if (post_done && (buff >= post_start) && (buff < post_end)) {
+		for (;;) {
+			for (i = 0; i < SD_READ_DEPTH; i++) {
+				if (!post_req[i].busy) break;
+			}
+			if (i < SD_READ_DEPTH) break;
+			disk_read_poll(drv);
+		}
+		post = &post_req[i];
+		post->buff = buff;
+		post->sector = sector;
+		post->count = count;
+		post->done = post_done;
+		return disk_read_submit(drv, post);
+	}
+
+	req.buff = buff;
+	req.sector = sector;
+	req.count = count;
+	req.done = 0;
+
+	res = disk_read_submit(drv, &req);
+	if (res != RES_OK) return res;
+
+	return disk_read_wait(drv, &req);
+}
+
+
+/*-----------------------------------------------------------------------*/
+/* Asynchronous Read							 */
+/*-----------------------------------------------------------------------*/
+
+/******************************************************************************/
+/**
+*
+* This function ends the request on the card
+*
+* @param	res Result of the request
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+static void req_finish(DRESULT res)
+{
+	DISK_REQ *req = req_head;
+
+	req_head = req->next;
+	req->next = 0;
+	req->res = res;
+
+	if (req->done || (post_done && (req->buff >= post_start) &&
+			(req->buff < post_end))) {
+		if (done_head) done_tail->next = req;
+		else done_head = req;
+		done_tail = req;
+	} else {
+		req->busy = 0;
+	}
+}
+
+/******************************************************************************/
+/**
+*
+* This function starts the request at the head of the queue
+*
+* @param	None
+*
+* @return	None
+*
+* @note		A request the card does not accept is ended with RES_ERROR
+*			and the next one is started.
+*
+****************************************************************************/
+static void req_start(void)
+{
+	DWORD sector;
+
+	while (req_head) {
+		/* Convert LBA to byte address if needed */
+		sector = req_head->sector;
+		if (!(CardType & CT_BLOCK)) sector *= SD_BLOCK_SZ;
+
+		blkcnt = req_head->count;
+		blksize = SD_BLOCK_SZ;
+
+		/* set adma2 for transfer */
+		setup_adma2_trans(req_head->buff);
+
+		/* Multiple block read */
+		if (send_cmd(CMD18, sector, NULL)) return;
+
+		req_finish(RES_ERROR);
+	}
+}
+
+/******************************************************************************/
+/**
+*
+* This function queues a read. It returns at once, the request is owned by
+* the driver while busy is set.
+*
+* @param	drv Physical drive number (0)
+* @param	req Request, buff, sector, count and done filled in
+*
+* @return	RES_OK when queued
+*
+* @note		The callback is called from disk_read_poll() once the data
+*			is in the buffer and the callbacks of the requests queued
+*			before returned. It may queue further reads.
+*
+****************************************************************************/
+DRESULT disk_read_submit (
+		BYTE drv,
+		DISK_REQ *req
+)
+{
+	if (disk_status(drv) & STA_NOINIT) return RES_NOTRDY;
+	if (!req->count) return RES_PARERR;
+
+	req->busy = 1;
+	req->res = RES_OK;
+	req->next = 0;
+
+	if (req_head) {
+		req_tail->next = req;
+		req_tail = req;
+	} else {
+		req_head = req;
+		req_tail = req;
+		req_start();
+	}
+
+	return RES_OK;
+}
+
+/******************************************************************************/
+/**
+*
+* This function advances the queued reads. A finished transfer starts the
+* next request before any callback runs, so the card keeps reading while
+* the callback works on the data.
+*
+* @param	drv Physical drive number (0)
+*
+* @return	Nonzero while requests are pending
+*
+* @note		Called from a callback it only advances the card, the
+*			callbacks of later requests run after it returned.
+*
+****************************************************************************/
+int disk_read_poll (
+		BYTE drv
+)
+{
+	DISK_REQ *req;
+	BYTE state;
+
+	if (req_head) {
+		state = dma_trans_state();
+		if (state != TRANS_PENDING) {
+			if (state == TRANS_ERROR) reset_lines();
+			req_finish((state == TRANS_DONE) ? RES_OK : RES_ERROR);
+			req_start();
+		}
+	}
+
+	/*
+	 * One callback per call, the caller may queue the next read
+	 * before the card runs dry
+	 */
+	if (!in_callback && done_head) {
+		req = done_head;
+		done_head = req->next;
+		req->next = 0;
+		req->busy = 0;
+
+		in_callback = 1;
+		if (req->done) req->done(req);
+		else post_done(req);
+		in_callback = 0;
+	}
+
+	return (req_head || done_head);
+}
+
+/******************************************************************************/
+/**
+*
+* This function waits for a queued read
+*
+* @param	drv Physical drive number (0)
+* @param	req Request
+*
+* @return	Result of the request
+*
+* @note		From a callback only requests without a callback can be
+*			waited for.
+*
+****************************************************************************/
+DRESULT disk_read_wait (
+		BYTE drv,
+		DISK_REQ *req
+)
+{
+	while (req->busy) {
+		disk_read_poll(drv);
+	}
+
+	return req->res;
+}
+
+/******************************************************************************/
+/**
+*
+* This function posts the reads of disk_read() into a buffer range. They are
+* queued and disk_read() returns, FatFs goes on with the next cluster while
+* the card transfers. The callback gets each completed read into the range
+* in order, also those queued with disk_read_submit() without a callback.
+*
+* @param	drv Physical drive number (0)
+* @param	buff Start of the range
+* @param	len Length of the range in bytes, 0 to end posting
+* @param	done Callback
+*
+* @return	None
+*
+* @note		All queued reads are completed first, a callback still
+*			gets the reads posted before the range changed.
+*
+****************************************************************************/
+void disk_read_post (
+		BYTE drv,
+		BYTE *buff,
+		DWORD len,
+		void (*done)(DISK_REQ *)
+)
+{
+	while (disk_read_poll(drv)) {
+		;
+	}
+
+	post_start = buff;
+	post_end = buff + len;
+	post_done = len ? done : 0;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/* Miscellaneous Functions						*/
+/*-----------------------------------------------------------------------*/
+
+DRESULT disk_ioctl (
+	BYTE drv,				/* Physical drive number (0) */
+	BYTE ctrl,				/* Control code */
+	void *buff				/* Buffer to send/receive control data */
+)
+{
+	DRESULT res;
+
+	if (disk_status(drv) & STA_NOINIT)	/* Check if card is in the socket */
+			return RES_NOTRDY;
+
+	res = RES_ERROR;
+	switch (ctrl) {
+		case CTRL_SYNC :	/* Make sure that no pending write process */
+			break;
+
+		case GET_SECTOR_COUNT : /* Get number of sectors on the disk (DWORD) */
+			break;
+
+		case GET_BLOCK_SIZE :	/* Get erase block size in unit of sector (DWORD) */
+			*(DWORD*)buff = 128;
+			res = RES_OK;
+			break;
+
+		default:
+			res = RES_PARERR;
+			break;
+	}
+
+		return res;
+}
+
+/******************************************************************************/
+/**
+*
+* This function is User Provided Timer Function for FatFs module
+*
+* @param	None
+*
+* @return	DWORD
+*
+* @note		None
+*
+****************************************************************************/
+DWORD get_fattime (void)
+{
+	return	((DWORD)(2010 - 1980) << 25)	/* Fixed to Jan. 1, 2010 */
+		| ((DWORD)1 << 21)
+		| ((DWORD)1 << 16)
+		| ((DWORD)0 << 11)
+		| ((DWORD)0 << 5)
+		| ((DWORD)0 >> 1);
+}
+
+
+
+#ifdef MMC_SUPPORT
+/*
+ * MMC initialization
+ */
+static DRESULT mmc_init(void)
+{
+	BYTE ty;
+	DSTATUS s;
 	DWORD response;
 	unsigned rca;
-	u16 regval;
-	u16 clk_div;
 	u32 argument;
-	u8 status_data[512];
+	u32 card_caps;
+	u8 *ext_csd;
 
 	ty= CT_MMC;
 
@@ -756,6 +1628,7 @@ static DRESULT mmc_init(void)
 	 */
 	rca = 0x1234;
 	send_cmd(CMD3, rca << 16, &response);
+	CardRca = rca;
 
 	/*
 	 * Send CSD
@@ -768,40 +1641,17 @@ static DRESULT mmc_init(void)
 	send_cmd(CMD7, rca << 16, &response);
 
 	/*
-	 * Switch the bus width to 4bit
-	 */
-	argument = (MMC_SWITCH_MODE_WRITE_BYTE << 24) |
-			(EXT_CSD_BUS_WIDTH << 16) |
-			(1 << 8);
-	send_cmd(CMD6, argument, &response);
-
-	/*
-	 * Delay for device to setup
-	 */
-	usleep(1000);
-
-	/*
-	 * Enable 4bit mode in controller
-	 */
-	regval = sd_in16(SD_HOST_CTRL_R);
-	regval |= SD_HOST_4BIT;
-	sd_out16(SD_HOST_CTRL_R, regval);
-
-	/*
-	 * Switch device to high speed
+	 * Default speed clock for the transfer state
 	 */
-	argument = (MMC_SWITCH_MODE_WRITE_BYTE << 24) |
-				(EXT_CSD_HS_TIMING << 16) |
-				(1 << 8);
-	send_cmd(CMD6, argument, &response);
+	set_clock(BUS_MODE_BASE->clock);
 
 	/*
-	 * Delay for device to setup
+	 * Set R/W block length to 512
 	 */
-	usleep(1000);
+	send_cmd(CMD16, SD_BLOCK_SZ, &response);
 
 	/*
-	 * Verify Bus width switch to high speed support
+	 * Read EXT_CSD for the bus modes of the device
 	 */
 	blkcnt = 1;
 	blksize= 512;
@@ -809,11 +1659,8 @@ static DRESULT mmc_init(void)
 	/*
 	 * Set adma2 for transfer
 	 */
-	setup_adma2_trans(&status_data[0]);
+	setup_adma2_trans((BYTE *)probe_block);
 
-	/*
-	 * Check for high speed support switch
-	 */
 	send_cmd(CMD8, 0x0, &response);
 
 	/*
@@ -824,84 +1671,21 @@ static DRESULT mmc_init(void)
 	}
 
 	/*
-	 * Check for 4bit support
+	 * MMC 4.x devices have 4 and 8 bit buses, the card type gives the
+	 * high speed and DDR support
 	 */
-	if (status_data[EXT_CSD_BUS_WIDTH] ==  MMC_4BIT_SUPPORT) {
-		fsbl_printf(DEBUG_INFO, "Bus Width 4Bit\r\n");
+	ext_csd = (u8 *)probe_block;
+	card_caps = BUS_CAP_4BIT|BUS_CAP_8BIT;
+	if (ext_csd[EXT_CSD_CARD_TYPE] & EXT_CSD_CARD_TYPE_52) {
+		card_caps |= BUS_CAP_HS;
 	}
-
-
-	if (status_data[EXT_CSD_HS_TIMING] == MMC_HS_SUPPORT) {
-		fsbl_printf(DEBUG_INFO, "High Speed Mode\r\n");
-		/*
-		 * Disable SD clock and internal clock
-		 */
-		regval = sd_in16(SD_CLK_CTL_R);
-		regval &= ~(SD_CLK_SD_EN|SD_CLK_INT_EN);
-		sd_out16(SD_CLK_CTL_R, regval);
-
-		clk_div = (SDIO_FREQ / MMC_CLK_52M);
-		if (!(SDIO_FREQ % MMC_CLK_52M)) {
-			clk_div -=1;
-		}
-
-		/*
-		 * Enable Internal clock and wait for it to stabilize
-		 */
-		regval = (clk_div << SD_DIV_SHIFT) | SD_CLK_INT_EN;
-		sd_out16(SD_CLK_CTL_R, regval);
-		do {
-			regval = sd_in16(SD_CLK_CTL_R);
-		} while (!(regval & SD_CLK_INT_STABLE));
-
-		/*
-		 * Enable SD clock
-		 */
-		regval |= SD_CLK_SD_EN;
-		sd_out16(SD_CLK_CTL_R, regval);
-
-		/*
-		 * Enable high speed mode in controller
-		 */
-		regval = sd_in16(SD_HOST_CTRL_R);
-		regval |= SD_HOST_HS;
-		sd_out16(SD_HOST_CTRL_R, regval);
-	} else {
-		/*
-		 * Disable SD clock and internal clock
-		 */
-		regval = sd_in16(SD_CLK_CTL_R);
-		regval &= ~(SD_CLK_SD_EN|SD_CLK_INT_EN);
-		sd_out16(SD_CLK_CTL_R, regval);
-
-		/*
-		 * Calculating clock divisor
-		 */
-		clk_div = (SDIO_FREQ / MMC_CLK_26M);
-		if (!(SDIO_FREQ % MMC_CLK_26M)) {
-			clk_div -=1;
-		}
-
-		/*
-		 * Enable Internal clock and wait for it to stabilize
-		 */
-		regval = (clk_div << SD_DIV_SHIFT) | SD_CLK_INT_EN;
-		sd_out16(SD_CLK_CTL_R, regval);
-		do {
-			regval = sd_in16(SD_CLK_CTL_R);
-		} while (!(regval & SD_CLK_INT_STABLE));
-
-		/*
-		 * Enable SD clock
-		 */
-		regval |= SD_CLK_SD_EN;
-		sd_out16(SD_CLK_CTL_R, regval);
+	if (ext_csd[EXT_CSD_CARD_TYPE] & EXT_CSD_CARD_TYPE_DDR_52) {
+		card_caps |= BUS_CAP_DDR;
 	}
 
-	/*
-	 * Set R/W block length to 512
-	 */
-	send_cmd(CMD16, SD_BLOCK_SZ, &response);
+	if (!bus_negotiate(card_caps)) {
+		return RES_ERROR;
+	}
 
 fail:
 	CardType = ty;
@@ -919,11 +1703,8 @@ DRESULT sd_init(void)
 	DSTATUS s;
 	DWORD response;
 	unsigned rca;
-	u16 regval;
-	u8 status_data[64];
-	u8 sd_4bit_flag=0;
-	u8 sd_hs_flag=0;
-	u16 clk_div;
+	u8 *status_data = (u8 *)probe_block;
+	u32 card_caps = 0;
 
 	/*
 	 * Enter Idle state
@@ -983,6 +1764,7 @@ DRESULT sd_init(void)
 	rca = 0x1234;
 	send_cmd(CMD3, rca << 16, &response);
 	rca = response >> 16;
+	CardRca = rca;
 
 	/*
 	 * select card
@@ -1021,7 +1803,7 @@ DRESULT sd_init(void)
      * SD 4-bit support check
      */
     if (status_data[1]&SD_4BIT_SUPPORT) {
-    	sd_4bit_flag=1;
+    	card_caps |= BUS_CAP_4BIT;
     }
 
 	/*
@@ -1051,7 +1833,7 @@ DRESULT sd_init(void)
      * SD high speed support check
      */
 	if (status_data[13]&SD_HS_SUPPORT) {
-		sd_hs_flag=1;
+		card_caps |= BUS_CAP_HS;
 	}
 
 	/*
@@ -1064,113 +1846,15 @@ DRESULT sd_init(void)
 	 */
 	send_cmd(ACMD42, 0, &response);
 
-	if (sd_4bit_flag) {
-		/*
-		 * Application specific command
-		 */
-		send_cmd(CMD55, rca << 16, &response);
-
-		/*
-		 * Set data bus width to 4-bit
-		 */
-		send_cmd(ACMD6, 2, &response);
-
-		/*
-		 * Enable 4bit mode in controller
-		 */
-		regval = sd_in16(SD_HOST_CTRL_R);
-		regval |= SD_HOST_4BIT;
-		sd_out16(SD_HOST_CTRL_R, regval);
-	}
-
-	if (sd_hs_flag) {
-		/*
-		 * Set adma2 for transfer
-		 */
-	    setup_adma2_trans(&status_data[0]);
-
-	    /*
-	     * Switch device to high speed
-	     */
-		send_cmd(CMD6, 0x80FFFFF1, &response);
-
-		/*
-		 * Check for DMA transfer complete
-		 */
-		if (!dma_trans_cmpl()) {
-			return RES_ERROR;
-		}
-
-		/*
-		 * Disable SD clock and internal clock
-		 */
-		regval = sd_in16(SD_CLK_CTL_R);
-		regval &= ~(SD_CLK_SD_EN|SD_CLK_INT_EN);
-		sd_out16(SD_CLK_CTL_R, regval);
-
-		clk_div = (SDIO_FREQ/SD_CLK_50M);
-		if (!(SDIO_FREQ%SD_CLK_50M)) {
-			clk_div -=1;
-		}
-
-		/*
-		 * Enable Internal clock and wait for it to stabilize
-		 */
-		regval = (clk_div << SD_DIV_SHIFT) | SD_CLK_INT_EN;
-		sd_out16(SD_CLK_CTL_R, regval);
-		do {
-			regval = sd_in16(SD_CLK_CTL_R);
-		} while (!(regval & SD_CLK_INT_STABLE));
-
-		/*
-		 * Enable SD clock
-		 */
-		regval |= SD_CLK_SD_EN;
-		sd_out16(SD_CLK_CTL_R, regval);
-
-		/*
-		 * Enable high speed mode in controller
-		 */
-		regval = sd_in16(SD_HOST_CTRL_R);
-		regval |= SD_HOST_HS;
-		sd_out16(SD_HOST_CTRL_R, regval);
-	} else {
-		/*
-		 * Disable SD clock and internal clock
-		 */
-		regval = sd_in16(SD_CLK_CTL_R);
-		regval &= ~(SD_CLK_SD_EN|SD_CLK_INT_EN);
-		sd_out16(SD_CLK_CTL_R, regval);
-
-		/*
-		 * Calculating clock divisor
-		 */
-		clk_div = (SDIO_FREQ/SD_CLK_25M);
-		if (!(SDIO_FREQ%SD_CLK_25M)) {
-			clk_div -=1;
-		}
-
-		/*
-		 * Enable Internal clock and wait for it to stabilize
-		 */
-		regval = (clk_div << SD_DIV_SHIFT) | SD_CLK_INT_EN;
-		sd_out16(SD_CLK_CTL_R, regval);
-		do {
-			regval = sd_in16(SD_CLK_CTL_R);
-		} while (!(regval & SD_CLK_INT_STABLE));
-
-		/*
-		 * Enable SD clock
-		 */
-		regval |= SD_CLK_SD_EN;
-		sd_out16(SD_CLK_CTL_R, regval);
-	}
-
 	/*
 	 * Set R/W block length to 512
 	 */
 	send_cmd(CMD16, SD_BLOCK_SZ, &response);
 
+	if (!bus_negotiate(card_caps)) {
+		return RES_ERROR;
+	}
+
 fail:
 	CardType = ty;
 
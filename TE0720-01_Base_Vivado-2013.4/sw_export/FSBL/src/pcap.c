@@ -69,6 +69,9 @@
 *						                    encrypted using non-zero key value
 * 6.00a kc  08/30/13    Fix for CR#722979 - Provide customer-friendly
 *                                           changelogs in FSBL
+* 7.00a te	10/16/26	Configuration readback after the bitstream download,
+*						PCAP_READBACK_VERIFY
+*						Asynchronous bitstream load, PCAP_ASYNC_LOAD
 *
 * </pre>
 *
@@ -90,6 +93,10 @@
 #ifdef XPAR_XWDTPS_0_BASEADDR
 #include "xwdtps.h"
 #endif
+
+#ifdef PCAP_READBACK_VERIFY
+#include "readback.h"
+#endif
 /************************** Constant Definitions *****************************/
 /*
  * The following constants map to the XPAR parameters created in the
@@ -105,12 +112,22 @@
 
 /************************** Function Prototypes ******************************/
 extern int XDcfgPollDone(u32 MaskValue, u32 MaxCount);
+#ifdef PCAP_ASYNC_LOAD
+static void PcapAsyncEvent(void *CallBackRef, u32 IntrStatus);
+#endif
 
 /************************** Variable Definitions *****************************/
 /* Devcfg driver instance */
 static XDcfg DcfgInstance;
 XDcfg *DcfgInstPtr;
 
+#ifdef PCAP_ASYNC_LOAD
+/*
+ * Asynchronous load that owns the PCAP until it completes
+ */
+static PcapAsyncToken *PcapAsyncActive;
+#endif
+
 #ifdef XPAR_XWDTPS_0_BASEADDR
 extern XWdtPs Watchdog;	/* Instance of WatchDog Timer	*/
 #endif
@@ -239,6 +256,9 @@ u32 PcapLoadPartition(u32 *SourceDataPtr, u32 *DestinationDataPtr,
 {
 	u32 Status;
 	u32 PcapTransferType = XDCFG_NON_SECURE_PCAP_WRITE;
+#ifdef PCAP_READBACK_VERIFY
+	u32 *BitstreamPtr = SourceDataPtr;
+#endif
 
 	/*
 	 * Check for secure transfer
@@ -335,8 +355,267 @@ u32 PcapLoadPartition(u32 *SourceDataPtr, u32 *DestinationDataPtr,
 	FsblMeasurePerfTime(tXferCur,tXferEnd);
 #endif
 
+#ifdef PCAP_READBACK_VERIFY
+	/*
+	 * Read the frames back and compare them to the bitstream, an
+	 * encrypted one cannot be compared
+	 */
+	if (!SecureTransfer) {
+		Status = ReadbackCheckBitstream(BitstreamPtr, SourceLength);
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL,"PCAP_READBACK_VERIFY_FAIL\r\n");
+			return XST_FAILURE;
+		}
+	}
+#endif
+
+	return XST_SUCCESS;
+}
+
+#ifdef PCAP_ASYNC_LOAD
+/******************************************************************************/
+/**
+*
+* This function starts a PL partition load using PCAP and returns without
+* waiting for the fabric to be programmed. The load reports to the token
+* through the devcfg status handler, see PcapAsyncPoll
+*
+* @param 	Token is the token of the load, it must stay valid until the
+* 			load completes
+* @param 	SourceDataPtr is a pointer to where the data is read from
+* @param 	SourceLength is the length of the data to be moved in words
+* @param 	DestinationLength is the length of the data to be moved in words
+* @param 	SecureTransfer indicated the encryption key location, 0 for
+* 			non-encrypted
+* @param 	Handler is called once the load completes or fails, may be NULL
+* @param 	CallBackRef is passed to Handler
+*
+* @return
+*		- XST_SUCCESS if the transfer is started
+*		- XST_FAILURE if the transfer cannot be started
+*
+* @note		The devcfg interrupt is left masked, the FSBL does not route
+*		it. A system that does connects XDcfg_InterruptHandler to it and
+*		unmasks PCAP_ASYNC_EVENT_MASK
+*
+****************************************************************************/
+u32 PcapLoadPartitionStart(PcapAsyncToken *Token, u32 *SourceDataPtr,
+		u32 SourceLength, u32 DestinationLength, u32 SecureTransfer,
+		PcapAsyncHandler Handler, void *CallBackRef)
+{
+	u32 Status;
+	u32 PcapTransferType = XDCFG_NON_SECURE_PCAP_WRITE;
+
+	/*
+	 * Check for secure transfer
+	 */
+	if (SecureTransfer) {
+		PcapTransferType = XDCFG_SECURE_PCAP_WRITE;
+	}
+
+	/*
+	 * Clear the PCAP status registers
+	 */
+	Status = ClearPcapStatus();
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"PCAP_CLEAR_STATUS_FAIL \r\n");
+		return XST_FAILURE;
+	}
+
+	Token->State = PCAP_ASYNC_BUSY;
+	Token->IntrStatus = 0;
+	Token->SourceData = SourceDataPtr;
+	Token->SourceLength = SourceLength;
+	Token->SecureTransfer = SecureTransfer;
+	Token->Handler = Handler;
+	Token->CallBackRef = CallBackRef;
+
+	/*
+	 * New Bitstream download initialization sequence
+	 */
+	FabricInit();
+
+#ifdef	XPAR_XWDTPS_0_BASEADDR
+	/*
+	 * Prevent WDT reset
+	 */
+	XWdtPs_RestartWdt(&Watchdog);
+#endif
+
+	/*
+	 * Devcfg events are handed to the token
+	 */
+	XDcfg_SetHandler(DcfgInstPtr, (void *)PcapAsyncEvent, Token);
+	PcapAsyncActive = Token;
+
+	/*
+	 * PCAP single DMA transfer, for Bitstream case destination address
+	 * will be 0xFFFFFFFF
+	 */
+	Status = XDcfg_Transfer(DcfgInstPtr,
+			(u8 *)((u32)SourceDataPtr | PCAP_LAST_TRANSFER),
+			SourceLength,
+			(u8 *)(XDCFG_DMA_INVALID_ADDRESS | PCAP_LAST_TRANSFER),
+			DestinationLength, PcapTransferType);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"Status of XDcfg_Transfer = %d \r \n",Status);
+		PcapAsyncActive = NULL;
+		Token->State = PCAP_ASYNC_FAILED;
+		return XST_FAILURE;
+	}
+
+	/*
+	 * Dump the PCAP registers
+	 */
+	PcapDumpRegisters();
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function is the devcfg status handler of an asynchronous load. It
+* runs from XDcfg_InterruptHandler, which has cleared the events
+*
+* @param	CallBackRef is the token of the load
+* @param	IntrStatus is the interrupt status register value
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+static void PcapAsyncEvent(void *CallBackRef, u32 IntrStatus)
+{
+	PcapAsyncToken *Token = (PcapAsyncToken *)CallBackRef;
+	u32 Status;
+
+	if (Token->State != PCAP_ASYNC_BUSY) {
+		return;
+	}
+
+	Token->IntrStatus |= IntrStatus;
+
+	if (Token->IntrStatus & FSBL_XDCFG_IXR_ERROR_FLAGS_MASK) {
+		Token->State = PCAP_ASYNC_FAILED;
+		Status = XST_FAILURE;
+	} else if ((Token->IntrStatus & PCAP_ASYNC_DONE_MASK) ==
+			PCAP_ASYNC_DONE_MASK) {
+		Token->State = PCAP_ASYNC_DONE;
+		Status = XST_SUCCESS;
+	} else {
+		return;
+	}
+
+	PcapAsyncActive = NULL;
+
+	if (Token->Handler != NULL) {
+		Token->Handler(Token->CallBackRef, Status);
+	}
+}
+
+/******************************************************************************/
+/**
+*
+* This function checks an asynchronous load without blocking. Pending
+* devcfg events are handed to XDcfg_InterruptHandler, so the token and the
+* completion handler are updated the same way with or without the devcfg
+* interrupt
+*
+* @param	Token is the token of the load
+*
+* @return
+*		- XST_DEVICE_BUSY while the fabric is being programmed
+*		- XST_SUCCESS if the load is done or no load was started
+*		- XST_FAILURE if the load failed
+*
+* @note		None
+*
+****************************************************************************/
+u32 PcapAsyncPoll(PcapAsyncToken *Token)
+{
+	if ((Token->State == PCAP_ASYNC_BUSY) &&
+			(XDcfg_IntrGetStatus(DcfgInstPtr) & PCAP_ASYNC_EVENT_MASK)) {
+		XDcfg_InterruptHandler(DcfgInstPtr);
+	}
+
+	switch (Token->State) {
+	case PCAP_ASYNC_BUSY:
+		return XST_DEVICE_BUSY;
+	case PCAP_ASYNC_FAILED:
+		return XST_FAILURE;
+	default:
+		return XST_SUCCESS;
+	}
+}
+
+/******************************************************************************/
+/**
+*
+* This function waits for an asynchronous load and finishes it. It must be
+* called before the programmed fabric is used
+*
+* @param	Token is the token of the load
+*
+* @return
+*		- XST_SUCCESS if the load is done or no load was started
+*		- XST_FAILURE if the load failed or timed out
+*
+* @note		With PCAP_READBACK_VERIFY the readback check runs here
+*
+****************************************************************************/
+u32 PcapAsyncWait(PcapAsyncToken *Token)
+{
+	u32 Count = MAX_COUNT;
+	u32 Status;
+
+	Status = PcapAsyncPoll(Token);
+	while (Status == XST_DEVICE_BUSY) {
+		Count -= 1;
+		if (!Count) {
+			fsbl_printf(DEBUG_GENERAL,"PCAP transfer timed out \r\n");
+			PcapAsyncActive = NULL;
+			Token->State = PCAP_ASYNC_FAILED;
+			return XST_FAILURE;
+		}
+		Status = PcapAsyncPoll(Token);
+	}
+
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"FATAL errors in PCAP %x\r\n",
+				Token->IntrStatus);
+		PcapDumpRegisters();
+		return XST_FAILURE;
+	}
+
+	if (Token->State != PCAP_ASYNC_DONE) {
+		return XST_SUCCESS;
+	}
+
+	fsbl_printf(DEBUG_INFO,"FPGA Done ! \n\r");
+
+#ifdef PCAP_READBACK_VERIFY
+	/*
+	 * Read the frames back and compare them to the bitstream, an
+	 * encrypted one cannot be compared
+	 */
+	if (!Token->SecureTransfer) {
+		Status = ReadbackCheckBitstream(Token->SourceData,
+				Token->SourceLength);
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL,"PCAP_READBACK_VERIFY_FAIL\r\n");
+			Token->State = PCAP_ASYNC_FAILED;
+			return XST_FAILURE;
+		}
+	}
+#endif
+
+	Token->State = PCAP_ASYNC_IDLE;
+
 	return XST_SUCCESS;
 }
+#endif
 
 /******************************************************************************/
 /**
@@ -471,6 +750,16 @@ u32 ClearPcapStatus(void)
 	u32 StatusReg;
 	u32 IntStatusReg;
 
+#ifdef PCAP_ASYNC_LOAD
+	/*
+	 * Clearing the status would lose the events of a load in flight
+	 */
+	if (PcapAsyncActive != NULL) {
+		fsbl_printf(DEBUG_INFO,"PCAP_DEVICE_BUSY\r\n");
+		return XST_DEVICE_BUSY;
+	}
+#endif
+
 	/*
 	 * Clear it all, so if Boot ROM comes back, it can proceed
 	 */
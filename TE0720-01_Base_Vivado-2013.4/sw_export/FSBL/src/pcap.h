@@ -53,6 +53,7 @@
 * ----- ---- -------- -------------------------------------------------------
 * 1.00a ecm	02/10/10 Initial release
 * 2.00a mb  16/08/12 Added the macros and function prototypes
+* 7.00a te  10/16/26 Added the asynchronous bitstream load, PCAP_ASYNC_LOAD
 * </pre>
 *
 * @note
@@ -100,6 +101,51 @@ u32 PcapLoadPartition(u32 *SourceData, u32 *DestinationData, u32 SourceLength,
 		 	u32 DestinationLength, u32 Flags);
 u32 PcapDataTransfer(u32 *SourceData, u32 *DestinationData, u32 SourceLength,
  			u32 DestinationLength, u32 Flags);
+
+#ifdef PCAP_ASYNC_LOAD
+/*
+ * Asynchronous bitstream load states
+ */
+#define PCAP_ASYNC_IDLE		0
+#define PCAP_ASYNC_BUSY		1
+#define PCAP_ASYNC_DONE		2
+#define PCAP_ASYNC_FAILED	3
+
+/*
+ * Events that complete an asynchronous bitstream load
+ */
+#define PCAP_ASYNC_DONE_MASK	(XDCFG_IXR_DMA_DONE_MASK | \
+				XDCFG_IXR_PCFG_DONE_MASK)
+#define PCAP_ASYNC_EVENT_MASK	(PCAP_ASYNC_DONE_MASK | \
+				FSBL_XDCFG_IXR_ERROR_FLAGS_MASK)
+
+/*
+ * Called once from the devcfg status handler when the load completes or
+ * fails, Status is XST_SUCCESS or XST_FAILURE
+ */
+typedef void (*PcapAsyncHandler)(void *CallBackRef, u32 Status);
+
+/*
+ * Token of a bitstream load in flight. The devcfg status handler fills
+ * it in, from the devcfg interrupt when XDcfg_InterruptHandler is
+ * connected to it or from PcapAsyncPoll otherwise
+ */
+typedef struct {
+	volatile u32 State;		/* PCAP_ASYNC_* */
+	volatile u32 IntrStatus;	/* INT_STS bits seen so far */
+	u32 *SourceData;		/* Bitstream, for the readback check */
+	u32 SourceLength;		/* Bitstream length in words */
+	u32 SecureTransfer;
+	PcapAsyncHandler Handler;
+	void *CallBackRef;
+} PcapAsyncToken;
+
+u32 PcapLoadPartitionStart(PcapAsyncToken *Token, u32 *SourceData,
+		u32 SourceLength, u32 DestinationLength, u32 Flags,
+		PcapAsyncHandler Handler, void *CallBackRef);
+u32 PcapAsyncPoll(PcapAsyncToken *Token);
+u32 PcapAsyncWait(PcapAsyncToken *Token);
+#endif
 /************************** Variable Definitions *****************************/
 #ifdef __cplusplus
 }
@@ -49,6 +49,8 @@
 
 #include "ps7_init.h"
 
+#if PS7_INIT_HAS_SILICON(3)
+
 unsigned long ps7_pll_init_data_3_0[] = {
     // START: top
     // .. START: SLCR SETTINGS
@@ -4020,6 +4022,9 @@ unsigned long ps7_post_config_3_0[] = {
     //
 };
 
+#endif
+#if PS7_INIT_HAS_SILICON(2)
+
 unsigned long ps7_pll_init_data_2_0[] = {
     // START: top
     // .. START: SLCR SETTINGS
@@ -8152,6 +8157,9 @@ unsigned long ps7_post_config_2_0[] = {
     //
 };
 
+#endif
+#if PS7_INIT_HAS_SILICON(1)
+
 unsigned long ps7_pll_init_data_1_0[] = {
     // START: top
     // .. START: SLCR SETTINGS
@@ -12216,6 +12224,7 @@ unsigned long ps7_post_config_1_0[] = {
 
     //
 };
+#endif
 
 
 #include "xil_io.h"
@@ -12232,6 +12241,7 @@ getPS7MessageInfo(unsigned key) {
     case PS7_POLL_FAILED_DDR_INIT:          err_msg = "Mask Poll failed for DDR Init"; break;
     case PS7_POLL_FAILED_DMA:               err_msg = "Mask Poll failed for PLL Init"; break;
     case PS7_POLL_FAILED_PLL:               err_msg = "Mask Poll failed for DMA done bit"; break;
+    case PS7_INIT_SILICON_MISMATCH:         err_msg = "PS7 init built for another silicon version"; break;
     default:                                err_msg = "Undefined error status"; break;
   }
   
@@ -12353,15 +12363,60 @@ ps7_config(unsigned long * ps7_config_init)
     return finish;
 }
 
+#if defined(PS7_INIT_SILICON) && (PS7_INIT_SILICON == 1)
+unsigned long *ps7_mio_init_data = ps7_mio_init_data_1_0;
+unsigned long *ps7_pll_init_data = ps7_pll_init_data_1_0;
+unsigned long *ps7_clock_init_data = ps7_clock_init_data_1_0;
+unsigned long *ps7_ddr_init_data = ps7_ddr_init_data_1_0;
+unsigned long *ps7_peripherals_init_data = ps7_peripherals_init_data_1_0;
+#elif defined(PS7_INIT_SILICON) && (PS7_INIT_SILICON == 2)
+unsigned long *ps7_mio_init_data = ps7_mio_init_data_2_0;
+unsigned long *ps7_pll_init_data = ps7_pll_init_data_2_0;
+unsigned long *ps7_clock_init_data = ps7_clock_init_data_2_0;
+unsigned long *ps7_ddr_init_data = ps7_ddr_init_data_2_0;
+unsigned long *ps7_peripherals_init_data = ps7_peripherals_init_data_2_0;
+#else
 unsigned long *ps7_mio_init_data = ps7_mio_init_data_3_0;
 unsigned long *ps7_pll_init_data = ps7_pll_init_data_3_0;
 unsigned long *ps7_clock_init_data = ps7_clock_init_data_3_0;
 unsigned long *ps7_ddr_init_data = ps7_ddr_init_data_3_0;
 unsigned long *ps7_peripherals_init_data = ps7_peripherals_init_data_3_0;
+#endif
+
+#ifdef PS7_INIT_SILICON
+#if PS7_INIT_SILICON == 1
+unsigned long *ps7_post_config_data = ps7_post_config_1_0;
+#elif PS7_INIT_SILICON == 2
+unsigned long *ps7_post_config_data = ps7_post_config_2_0;
+#else
+unsigned long *ps7_post_config_data = ps7_post_config_3_0;
+#endif
+
+// Run time guard of a build for one silicon version. 3.0 tables are also
+// used for any later version, as the run time selection below does.
+int
+ps7_silicon_check()
+{
+  unsigned long si_ver = ps7GetSiliconVersion ();
+
+#if PS7_INIT_SILICON == 3
+  if (si_ver < PCW_SILICON_VERSION_3) return PS7_INIT_SILICON_MISMATCH;
+#else
+  if (si_ver != PS7_INIT_SILICON - 1) return PS7_INIT_SILICON_MISMATCH;
+#endif
+  return PS7_INIT_SUCCESS;
+}
+#endif
 
 int
 ps7_post_config() 
 {
+#ifdef PS7_INIT_SILICON
+  int ret = ps7_silicon_check ();
+  if (ret != PS7_INIT_SUCCESS) return ret;
+  ret = ps7_config (ps7_post_config_data);
+  if (ret != PS7_INIT_SUCCESS) return ret;
+#else
   // Get the PS_VERSION on run time
   unsigned long si_ver = ps7GetSiliconVersion ();
   int ret = -1;
@@ -12375,15 +12430,21 @@ ps7_post_config()
       ret = ps7_config (ps7_post_config_3_0);
       if (ret != PS7_INIT_SUCCESS) return ret;
   }
+#endif
   return PS7_INIT_SUCCESS;
 }
 
 int
 ps7_init() 
 {
+  int ret;
+#ifdef PS7_INIT_SILICON
+  // Tables of one silicon version only, refuse any other
+  ret = ps7_silicon_check ();
+  if (ret != PS7_INIT_SUCCESS) return ret;
+#else
   // Get the PS_VERSION on run time
   unsigned long si_ver = ps7GetSiliconVersion ();
-  int ret;
   //int pcw_ver = 0;
 
   if (si_ver == PCW_SILICON_VERSION_1) {
@@ -12410,6 +12471,7 @@ ps7_init()
     ps7_peripherals_init_data = ps7_peripherals_init_data_3_0;
     //pcw_ver = 3;
   }
+#endif
 
   // MIO init
   ret = ps7_config (ps7_mio_init_data);  
@@ -91,6 +91,7 @@ extern unsigned long  * ps7_peripherals_init_data;
 #define PS7_POLL_FAILED_DDR_INIT (3)    // 3 when a poll operation timed out for ddr init
 #define PS7_POLL_FAILED_DMA      (4)    // 4 when a poll operation timed out for dma done bit
 #define PS7_POLL_FAILED_PLL      (5)    // 5 when a poll operation timed out for pll sequence init
+#define PS7_INIT_SILICON_MISMATCH (6)   // 6 built for PS7_INIT_SILICON, running on another silicon
 
 
 /* Silicon Versions */
@@ -98,6 +99,21 @@ extern unsigned long  * ps7_peripherals_init_data;
 #define PCW_SILICON_VERSION_2 1
 #define PCW_SILICON_VERSION_3 2
 
+/*
+ * PS7_INIT_SILICON can be set at compilation time to 1, 2 or 3 to build the
+ * init data of silicon 1.0, 2.0 or 3.0 only. ps7_init() and ps7_post_config()
+ * then return PS7_INIT_SILICON_MISMATCH on any other silicon. Without it the
+ * data of all versions is built and selected at run time.
+ */
+#ifdef PS7_INIT_SILICON
+#if (PS7_INIT_SILICON < 1) || (PS7_INIT_SILICON > 3)
+#error "PS7_INIT_SILICON must be 1, 2 or 3"
+#endif
+#define PS7_INIT_HAS_SILICON(ver) (PS7_INIT_SILICON == (ver))
+#else
+#define PS7_INIT_HAS_SILICON(ver) 1
+#endif
+
 /* This flag to be used by FSBL to check whether ps7_post_config() proc exixts */
 #define PS7_POST_CONFIG
 
@@ -136,6 +152,9 @@ extern unsigned long  * ps7_peripherals_init_data;
 int ps7_config( unsigned long*);
 int ps7_init();
 int ps7_post_config();
+#ifdef PS7_INIT_SILICON
+int ps7_silicon_check();
+#endif
 char* getPS7MessageInfo(unsigned key);
 
 void perf_start_clock(void);
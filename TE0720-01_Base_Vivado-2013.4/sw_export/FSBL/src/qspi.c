@@ -64,6 +64,15 @@
 *                                        changelogs in FSBL
 *                    Fix for CR#739711 - FSBL not able to read Large QSPI
 *                    					 (512M) in IO Mode
+* 7.00a te	10/16/26 Linear window access for flash > 16MB, the bank is
+*                    switched only when a read leaves the current window,
+*                    QSPI_LINEAR_WINDOW
+*                    Clock calibration, QSPI_CALIBRATION
+*                    Word aligned transfer buffers
+* 7.01a te	10/16/26 Linear window only for Micron and Spansion flashes
+*                    > 16MB, also in dual stack
+*                    No word tail read past the end of the flash
+*                    Calibration cache in the .qspical_cache section
 * </pre>
 *
 * @note
@@ -78,6 +87,10 @@
 #ifdef XPAR_PS7_QSPI_LINEAR_0_S_AXI_BASEADDR
 #include "xqspips_hw.h"
 #include "xqspips.h"
+#ifdef QSPI_CALIBRATION
+#include "qspical.h"
+#include "xtime_l.h"
+#endif
 
 /************************** Constant Definitions *****************************/
 
@@ -149,12 +162,49 @@
 					 LQSPI_CR_1_DUMMY_BYTE | \
 					 LQSPI_CR_FAST_QUAD_READ)
 
+#ifdef QSPI_LINEAR_WINDOW
+/*
+ * Linear read of the flash stacked on the upper chip select
+ */
+#define DUAL_STACK_CONFIG_LINEAR_READ	(XQSPIPS_LQSPI_CR_LINEAR_MASK | \
+					 DUAL_STACK_CONFIG_READ)
+
+/*
+ * The 24 bit linear address reaches 16MB of each flash, the bank register
+ * of the flash selects which 16MB
+ */
+#define NO_BANK_SELECTED	0xFF
+#endif
+
+#ifdef QSPI_CALIBRATION
+#define LQSPI_CLK_CTRL_REG	(XPS_SYS_CTRL_BASEADDR + 0x14C)
+
+/*
+ * Little endian word of the boot header in the read buffer
+ */
+#define CAL_GET_WORD(Ptr)	((u32)(Ptr)[0] | ((u32)(Ptr)[1] << 8) | \
+				 ((u32)(Ptr)[2] << 16) | ((u32)(Ptr)[3] << 24))
+#endif
+
 /**************************** Type Definitions *******************************/
 
 /***************** Macros (Inline Functions) Definitions *********************/
 
 /************************** Function Prototypes ******************************/
 
+#ifdef QSPI_LINEAR_WINDOW
+static void LinearWindowEnable(u32 LqspiConfig);
+static u32 LinearWindowSelect(u32 Device, u8 Bank);
+static u32 LinearWindowAccess(u32 SourceAddress, u32 DestinationAddress,
+		u32 LengthBytes);
+#endif
+
+#ifdef QSPI_CALIBRATION
+static void QspiCalibrateClock(void);
+static void QspiSetClock(u32 Setting);
+static u8 *CalReadSignature(u32 Setting);
+#endif
+
 /************************** Variable Definitions *****************************/
 
 XQspiPs QspiInstance;
@@ -166,10 +216,32 @@ extern u8 LinearBootDeviceFlag;
 
 /*
  * The following variables are used to read and write to the eeprom and they
- * are global to avoid having large buffers on the stack
+ * are global to avoid having large buffers on the stack. Word aligned, the
+ * driver moves them with 32-bit accesses
+ */
+u8 ReadBuffer[DATA_SIZE + DATA_OFFSET + DUMMY_SIZE] __attribute__ ((aligned(4)));
+u8 WriteBuffer[DATA_OFFSET + DUMMY_SIZE] __attribute__ ((aligned(4)));
+
+#ifdef QSPI_LINEAR_WINDOW
+/*
+ * Linear window mode and the bank selected in the lower and upper flash
+ */
+u8 QspiLinearWindowFlag;
+static u8 WindowBank[2];
+#endif
+
+#ifdef QSPI_CALIBRATION
+/*
+ * Flash address of the calibration signature
  */
-u8 ReadBuffer[DATA_SIZE + DATA_OFFSET + DUMMY_SIZE];
-u8 WriteBuffer[DATA_OFFSET + DUMMY_SIZE];
+static u32 CalSignatureAddress;
+
+/*
+ * Calibration of the last boot, kept in OCM over resets
+ */
+static QspiCalCache CalCache
+		__attribute__ ((section (QSPI_CAL_CACHE_SECTION)));
+#endif
 
 /******************************************************************************/
 /**
@@ -233,6 +305,13 @@ u32 InitQspi(void)
 		return XST_FAILURE;
 	}
 
+#ifdef QSPI_CALIBRATION
+	/*
+	 * Raise the clock from the default prescaler
+	 */
+	QspiCalibrateClock();
+#endif
+
 	if (XPAR_PS7_QSPI_0_QSPI_MODE == SINGLE_FLASH_CONNECTION) {
 
 		fsbl_printf(DEBUG_INFO,"QSPI is in single flash connection\r\n");
@@ -258,6 +337,11 @@ u32 InitQspi(void)
 			 */
 			XQspiPs_Enable(QspiInstancePtr);
 		}
+#ifdef QSPI_LINEAR_WINDOW
+		else {
+			LinearWindowEnable(SINGLE_QSPI_CONFIG_QUAD_READ);
+		}
+#endif
 	}
 
 	if (XPAR_PS7_QSPI_0_QSPI_MODE == DUAL_PARALLEL_CONNECTION) {
@@ -288,6 +372,11 @@ u32 InitQspi(void)
 			 */
 			XQspiPs_Enable(QspiInstancePtr);
 		}
+#ifdef QSPI_LINEAR_WINDOW
+		else {
+			LinearWindowEnable(DUAL_QSPI_CONFIG_QUAD_READ);
+		}
+#endif
 
 		/*
 		 * Total flash size is two time of single flash size
@@ -308,6 +397,16 @@ u32 InitQspi(void)
 		 * Enable two flash memories on separate buses
 		 */
 		XQspiPs_SetLqspiConfigReg(QspiInstancePtr, DUAL_STACK_CONFIG_READ);
+
+#ifdef QSPI_LINEAR_WINDOW
+		/*
+		 * Lower flash at the linear base, upper flash 16MB above, only
+		 * for flashes > 16MB, smaller ones stay in I/O mode
+		 */
+		if ((QspiFlashSize/2) > FLASH_SIZE_16MB) {
+			LinearWindowEnable(DUAL_STACK_CONFIG_LINEAR_READ);
+		}
+#endif
 	}
 
 	return XST_SUCCESS;
@@ -449,6 +548,16 @@ u32 QspiAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 	u32 Status;
 	u8 BankSwitchFlag = 1;
 
+#ifdef QSPI_LINEAR_WINDOW
+	/*
+	 * Linear access through the bank window
+	 */
+	if (QspiLinearWindowFlag == 1) {
+		return LinearWindowAccess(SourceAddress, DestinationAddress,
+				LengthBytes);
+	}
+#endif
+
 	/*
 	 * Linear access check
 	 */
@@ -720,5 +829,346 @@ u32 SendBankSelect(u8 BankSel)
 
 	return XST_SUCCESS;
 }
+#ifdef QSPI_LINEAR_WINDOW
+/******************************************************************************
+*
+* This function puts the controller in linear mode for a flash that does not
+* fit in the 16MB linear address range. The bank register of the flash is
+* unknown until the first access selects it.
+*
+* @param	LqspiConfig is the LQSPI configuration of the connection mode
+*
+* @return	None
+*
+* @note		Only Micron and Spansion flashes have the bank register
+*			SendBankSelect writes, others stay in I/O mode.
+*
+******************************************************************************/
+static void LinearWindowEnable(u32 LqspiConfig)
+{
+	if ((QspiFlashMake != MICRON_ID) && (QspiFlashMake != SPANSION_ID)) {
+		return;
+	}
+
+	fsbl_printf(DEBUG_INFO, "QSPI linear window mode\r\n");
+
+	QspiLinearWindowFlag = 1;
+	WindowBank[0] = NO_BANK_SELECTED;
+	WindowBank[1] = NO_BANK_SELECTED;
+
+	/*
+	 * Enable linear mode
+	 */
+	XQspiPs_SetOptions(QspiInstancePtr,  XQSPIPS_LQSPI_MODE_OPTION |
+			XQSPIPS_HOLD_B_DRIVE_OPTION);
+
+	XQspiPs_SetLqspiConfigReg(QspiInstancePtr, LqspiConfig);
+
+	/*
+	 * Enable the controller
+	 */
+	XQspiPs_Enable(QspiInstancePtr);
+}
+
+/******************************************************************************
+*
+* This function moves the linear window of a flash to another bank. The bank
+* register can only be written in I/O mode, so the controller leaves linear
+* mode for the write. In dual stack U_PAGE selects the flash written, in dual
+* parallel both flashes get the same bank.
+*
+* @param	Device is 0 for the lower and 1 for the upper stacked flash
+* @param	Bank is the 16MB bank of the flash to map
+*
+* @return	XST_SUCCESS if bank selected
+*			XST_FAILURE if selection failed
+*
+* @note		FSBL runs with the data cache disabled, so no stale data of
+*			the previous bank is read from the window.
+*
+******************************************************************************/
+static u32 LinearWindowSelect(u32 Device, u8 Bank)
+{
+	u32 LqspiCrReg;
+	u32 Status;
+
+	if (WindowBank[Device] == Bank) {
+		return XST_SUCCESS;
+	}
+
+	fsbl_printf(DEBUG_INFO, "Linear window %d bank %d\n\r", Device, Bank);
+
+	LqspiCrReg = XQspiPs_GetLqspiConfigReg(QspiInstancePtr);
+
+	/*
+	 * I/O mode with manual chip select
+	 */
+	XQspiPs_Disable(QspiInstancePtr);
+	XQspiPs_SetOptions(QspiInstancePtr, XQSPIPS_FORCE_SSELECT_OPTION |
+			XQSPIPS_HOLD_B_DRIVE_OPTION);
+
+	if (Device == 1) {
+		XQspiPs_SetLqspiConfigReg(QspiInstancePtr,
+				(LqspiCrReg & (~XQSPIPS_LQSPI_CR_LINEAR_MASK)) |
+				XQSPIPS_LQSPI_CR_U_PAGE_MASK);
+	} else {
+		XQspiPs_SetLqspiConfigReg(QspiInstancePtr,
+				LqspiCrReg & (~XQSPIPS_LQSPI_CR_LINEAR_MASK));
+	}
+
+	XQspiPs_SetSlaveSelect(QspiInstancePtr);
+
+	Status = SendBankSelect(Bank);
+
+	/*
+	 * Back to linear mode, also when the selection failed
+	 */
+	XQspiPs_Disable(QspiInstancePtr);
+	XQspiPs_SetOptions(QspiInstancePtr,  XQSPIPS_LQSPI_MODE_OPTION |
+			XQSPIPS_HOLD_B_DRIVE_OPTION);
+	XQspiPs_SetLqspiConfigReg(QspiInstancePtr, LqspiCrReg);
+	XQspiPs_Enable(QspiInstancePtr);
+
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO, "Bank Selection Failed\n\r");
+		WindowBank[Device] = NO_BANK_SELECTED;
+		return XST_FAILURE;
+	}
+
+	WindowBank[Device] = Bank;
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************
+*
+* This function reads the flash through the linear window. A read is split
+* only where it crosses into another window, all data of a window is copied
+* with one memcpy. The window is 16MB of each flash, 32MB of the image in
+* dual parallel where the two flashes hold alternate bytes.
+*
+* @param	SourceAddress is address in FLASH data space
+* @param	DestinationAddress is address in DDR data space
+* @param	LengthBytes is the length of the data in Bytes
+*
+* @return
+*		- XST_SUCCESS if the read completes correctly
+*		- XST_FAILURE if a bank selection fails or the read starts
+*		  past the end of the flash
+*
+* @note		The bank stays selected after the read, ReleaseQspi returns
+*			to bank 0.
+*
+******************************************************************************/
+static u32 LinearWindowAccess(u32 SourceAddress, u32 DestinationAddress,
+		u32 LengthBytes)
+{
+	u32 WindowSize = FLASH_SIZE_16MB;
+	u32 DeviceSize = QspiFlashSize;
+	u32 Device;
+	u32 Offset;
+	u32 Length;
+	u32 Status;
+
+	if (XPAR_PS7_QSPI_0_QSPI_MODE == DUAL_PARALLEL_CONNECTION) {
+		WindowSize = 2 * FLASH_SIZE_16MB;
+	}
+
+	if (XPAR_PS7_QSPI_0_QSPI_MODE == DUAL_STACK_CONNECTION) {
+		DeviceSize = QspiFlashSize/2;
+	}
+
+	/*
+	 * Check for non-word tail, add bytes to cover the end, but not past
+	 * the end of the flash
+	 */
+	if ((LengthBytes%4) != 0){
+		LengthBytes += (4 - (LengthBytes & 0x00000003));
+	}
+	if (SourceAddress >= QspiFlashSize) {
+		return XST_FAILURE;
+	}
+	if (LengthBytes > QspiFlashSize - SourceAddress) {
+		LengthBytes = QspiFlashSize - SourceAddress;
+	}
+
+	while (LengthBytes > 0) {
+		/*
+		 * Select lower or upper Flash based on address
+		 */
+		Device = SourceAddress / DeviceSize;
+		Offset = SourceAddress % DeviceSize;
+
+		Status = LinearWindowSelect(Device, (u8)(Offset / WindowSize));
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		/*
+		 * Copy up to the end of the window or of the flash
+		 */
+		Length = WindowSize - (Offset % WindowSize);
+		if (Length > DeviceSize - Offset) {
+			Length = DeviceSize - Offset;
+		}
+		if (Length > LengthBytes) {
+			Length = LengthBytes;
+		}
+
+		memcpy((void*)DestinationAddress,
+		      (const void*)(FlashReadBaseAddress +
+		      (Device * FLASH_SIZE_16MB) + (Offset % WindowSize)),
+		      (size_t)Length);
+
+		SourceAddress += Length;
+		DestinationAddress += Length;
+		LengthBytes -= Length;
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************
+*
+* This function returns the flashes to bank 0 before the application or the
+* Boot ROM reads them with 24 bit addresses.
+*
+* @param	None
+*
+* @return	None
+*
+* @note		None.
+*
+******************************************************************************/
+void ReleaseQspi(void)
+{
+	if (QspiLinearWindowFlag == 1) {
+		LinearWindowSelect(0, 0);
+
+		if (XPAR_PS7_QSPI_0_QSPI_MODE == DUAL_STACK_CONNECTION) {
+			LinearWindowSelect(1, 0);
+		}
+	}
+}
+#endif
+#ifdef QSPI_CALIBRATION
+/******************************************************************************
+*
+* This function calibrates the QSPI clock. The signature is the first
+* QSPI_CAL_SIZE bytes of the FSBL partition of the image at flash offset 0,
+* found through its boot header. The read rate reached is reported.
+*
+* @param	None
+*
+* @return	None
+*
+* @note		The clock stays at the default prescaler when there is no
+*			image at offset 0.
+*
+******************************************************************************/
+static void QspiCalibrateClock(void)
+{
+	u8 *Header;
+	u32 ImageOffset;
+	u32 ConfigId;
+	u32 Setting;
+	u32 KBps;
+	XTime tStart;
+	XTime tEnd;
+
+	QspiSetClock(QSPI_CAL_DEFAULT);
+
+	FlashRead(0, IMAGE_HEADER_SIZE);
+	Header = &ReadBuffer[DATA_OFFSET + DUMMY_SIZE];
+
+	if (CAL_GET_WORD(Header + IMAGE_IDENT_OFFSET) != IMAGE_IDENT) {
+		fsbl_printf(DEBUG_INFO, "No image at 0, QSPI clock not calibrated\r\n");
+		return;
+	}
+
+	ImageOffset = CAL_GET_WORD(Header + IMAGE_SOURCE_ADDR_OFFSET);
+
+	/*
+	 * Dual parallel connection actual flash is half
+	 */
+	if (XPAR_PS7_QSPI_0_QSPI_MODE == DUAL_PARALLEL_CONNECTION) {
+		ImageOffset = ImageOffset/2;
+	}
+
+	if ((ImageOffset + DATA_SIZE) > FLASH_SIZE_16MB) {
+		return;
+	}
+
+	CalSignatureAddress = ImageOffset;
+
+	/*
+	 * The setting holds for this flash at this reference clock
+	 */
+	ConfigId = (Xil_In32(LQSPI_CLK_CTRL_REG) & 0x00003F31) |
+			(QspiFlashMake << 16) | QspiFlashSize;
+
+	Setting = QspiCalibrate(CalReadSignature, ConfigId, &CalCache);
+
+	QspiSetClock(Setting);
+
+	XTime_GetTime(&tStart);
+	FlashRead(CalSignatureAddress, DATA_SIZE);
+	XTime_GetTime(&tEnd);
+
+	KBps = (u32)(((u64)DATA_SIZE * COUNTS_PER_SECOND) /
+			((tEnd - tStart + 1) * 1000));
+
+	fsbl_printf(DEBUG_GENERAL, "QSPI prescaler %d loopback %d, %d.%03d MB/s\r\n",
+			QSPI_CAL_PRESCALER(Setting),
+			(Setting & QSPI_CAL_LOOPBACK) ? 1 : 0,
+			KBps / 1000, KBps % 1000);
+}
+
+/******************************************************************************
+*
+* This function sets the baud rate prescaler and the loopback feedback
+* clock of a calibration setting.
+*
+* @param	Setting is the prescaler, ORed with QSPI_CAL_LOOPBACK
+*
+* @return	None
+*
+* @note		None.
+*
+******************************************************************************/
+static void QspiSetClock(u32 Setting)
+{
+	XQspiPs_SetClkPrescaler(QspiInstancePtr, QSPI_CAL_PRESCALER(Setting));
+
+	if (Setting & QSPI_CAL_LOOPBACK) {
+		XQspiPs_WriteReg(QspiInstancePtr->Config.BaseAddress,
+				XQSPIPS_LPBK_DLY_ADJ_OFFSET,
+				XQSPIPS_LPBK_DLY_ADJ_USE_LPBK_MASK);
+	} else {
+		XQspiPs_WriteReg(QspiInstancePtr->Config.BaseAddress,
+				XQSPIPS_LPBK_DLY_ADJ_OFFSET, 0);
+	}
+}
+
+/******************************************************************************
+*
+* This function reads the calibration signature at a setting.
+*
+* @param	Setting is the prescaler, ORed with QSPI_CAL_LOOPBACK
+*
+* @return	Pointer to the signature in the read buffer
+*
+* @note		None.
+*
+******************************************************************************/
+static u8 *CalReadSignature(u32 Setting)
+{
+	QspiSetClock(Setting);
+
+	FlashRead(CalSignatureAddress, QSPI_CAL_SIZE);
+
+	return &ReadBuffer[DATA_OFFSET + DUMMY_SIZE];
+}
+#endif
 #endif
 
@@ -54,6 +54,8 @@
 * 3.00a mb  01/09/12 Added the Delay Values defines for qspi
 * 5.00a sgd	05/17/13 Added Flash Size > 128Mbit support
 * 					 Dual Stack support
+* 6.00a te	10/16/26 Linear window access for flash > 16MB,
+* 					 QSPI_LINEAR_WINDOW
 * </pre>
 *
 * @note
@@ -121,6 +123,9 @@ u32 QspiAccess( u32 SourceAddress,
 
 u32 FlashReadID(void);
 u32 SendBankSelect(u8 BankSel);
+#ifdef QSPI_LINEAR_WINDOW
+void ReleaseQspi(void);
+#endif
 /************************** Variable Definitions *****************************/
 
 
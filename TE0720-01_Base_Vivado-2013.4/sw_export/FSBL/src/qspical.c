@@ -0,0 +1,280 @@
+/******************************************************************************
+*
+* (c) Copyright 2012-2013 Xilinx, Inc. All rights reserved.
+*
+* This file contains confidential and proprietary information of Xilinx, Inc.
+* and is protected under U.S. and international copyright and other
+* intellectual property laws.
+*
+* DISCLAIMER
+* This disclaimer is not a license and does not grant any rights to the
+* materials distributed herewith. Except as otherwise provided in a valid
+* license issued to you by Xilinx, and to the maximum extent permitted by
+* applicable law: (1) THESE MATERIALS ARE MADE AVAILABLE "AS IS" AND WITH ALL
+* FAULTS, AND XILINX HEREBY DISCLAIMS ALL WARRANTIES AND CONDITIONS, EXPRESS,
+* IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF
+* MERCHANTABILITY, NON-INFRINGEMENT, OR FITNESS FOR ANY PARTICULAR PURPOSE;
+* and (2) Xilinx shall not be liable (whether in contract or tort, including
+* negligence, or under any other theory of liability) for any loss or damage
+* of any kind or nature related to, arising under or in connection with these
+* materials, including for any direct, or any indirect, special, incidental,
+* or consequential loss or damage (including loss of data, profits, goodwill,
+* or any type of loss or damage suffered as a result of any action brought by
+* a third party) even if such damage or loss was reasonably foreseeable or
+* Xilinx had been advised of the possibility of the same.
+*
+* CRITICAL APPLICATIONS
+* Xilinx products are not designed or intended to be fail-safe, or for use in
+* any application requiring fail-safe performance, such as life-support or
+* safety devices or systems, Class III medical devices, nuclear facilities,
+* applications related to the deployment of airbags, or any other applications
+* that could lead to death, personal injury, or severe property or
+* environmental damage (individually and collectively, "Critical
+* Applications"). Customer assumes the sole risk and liability of any use of
+* Xilinx products in Critical Applications, subject only to applicable laws
+* and regulations governing limitations on product liability.
+*
+* THIS COPYRIGHT NOTICE AND DISCLAIMER MUST BE RETAINED AS PART OF THIS FILE
+* AT ALL TIMES.
+*
+*******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file qspical.c
+*
+* Contains the QSPI clock calibration.
+*
+* The signature, a fixed region of the flash, is read once at the default
+* prescaler as reference. It is then read at each faster prescaler with the
+* loopback feedback clock, which the controller needs above 40MHz. A
+* setting passes when all its reads match the reference bit for bit. For
+* margin a setting is taken only when the next faster one passes as well,
+* so the fastest prescaler is never used. The hardware is reached only
+* through the read function passed in, which sets the clock before it
+* reads.
+*
+* The setting is kept in OCM together with a hash of the signature. After
+* a reset that keeps OCM the reference read must hash to the recorded
+* value and the cached setting and the next faster one must pass again,
+* this replaces the search.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te	10/16/26 Initial release
+* 1.01a te	10/16/26 Loopback settings only, the next faster setting must
+*                    pass too, the cache is checked with all passes
+*
+* </pre>
+*
+* @note
+*	The ConfigId passed in must change with everything the result
+*	depends on, the flash and the QSPI reference clock.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#ifdef QSPI_CALIBRATION
+#include <string.h>
+#include "xstatus.h"
+#include "qspical.h"
+
+/************************** Constant Definitions *****************************/
+#define QSPI_CAL_CHECKSUM_WORDS \
+		((sizeof(QspiCalCache) - sizeof(u32)) / sizeof(u32))
+
+#define QSPI_CAL_SETTINGS	(sizeof(CalSettings) / sizeof(CalSettings[0]))
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+static u32 QspiCalPasses(QspiCalReadType ReadSignature, u32 Setting);
+static u32 QspiCalChecksum(QspiCalCache *CachePtr);
+static u32 QspiCalHash(u8 *Data);
+
+/************************** Variable Definitions *****************************/
+/*
+ * Settings tried, slowest first
+ */
+static const u32 CalSettings[] = {
+	XQSPIPS_CLK_PRESCALE_4 | QSPI_CAL_LOOPBACK,
+	XQSPIPS_CLK_PRESCALE_2 | QSPI_CAL_LOOPBACK
+};
+
+static u8 CalReference[QSPI_CAL_SIZE];
+
+/******************************************************************************/
+/**
+*
+* This function finds the fastest QSPI clock setting that reads the
+* signature correctly with one setting of margin.
+*
+* @param	ReadSignature sets the clock and reads the signature
+* @param	ConfigId identifies the flash and clock configuration
+* @param	CachePtr is the cache of the previous calibration
+*
+* @return	Setting to use, QSPI_CAL_DEFAULT if no faster one works
+*
+* @note		The clock is left at the setting of the last read, the
+*			caller applies the returned one.
+*
+****************************************************************************/
+u32 QspiCalibrate(QspiCalReadType ReadSignature, u32 ConfigId,
+		QspiCalCache *CachePtr)
+{
+	u8 *Data;
+	u32 Index;
+	u32 Passed;
+	u32 FasterPassed = 0;
+	u32 Setting = QSPI_CAL_DEFAULT;
+
+	/*
+	 * Reference read at the default clock
+	 */
+	Data = ReadSignature(QSPI_CAL_DEFAULT);
+	if (Data == NULL) {
+		CachePtr->Magic = 0;
+		return QSPI_CAL_DEFAULT;
+	}
+	memcpy(CalReference, Data, QSPI_CAL_SIZE);
+
+	/*
+	 * Cached setting of the last boot, checked like in the search
+	 */
+	if ((CachePtr->Magic == QSPI_CAL_MAGIC) &&
+			(CachePtr->ConfigId == ConfigId) &&
+			(CachePtr->Checksum == QspiCalChecksum(CachePtr)) &&
+			(CachePtr->Hash == QspiCalHash(CalReference))) {
+		if (CachePtr->Setting == QSPI_CAL_DEFAULT) {
+			fsbl_printf(DEBUG_INFO, "QSPI calibration cached\r\n");
+			return QSPI_CAL_DEFAULT;
+		}
+
+		for (Index = 0; Index + 1 < QSPI_CAL_SETTINGS; Index++) {
+			if (CalSettings[Index] == CachePtr->Setting) {
+				break;
+			}
+		}
+
+		if ((Index + 1 < QSPI_CAL_SETTINGS) &&
+				QspiCalPasses(ReadSignature, CalSettings[Index + 1]) &&
+				QspiCalPasses(ReadSignature, CalSettings[Index])) {
+			fsbl_printf(DEBUG_INFO, "QSPI calibration cached\r\n");
+			return CachePtr->Setting;
+		}
+	}
+
+	CachePtr->Magic = 0;
+
+	/*
+	 * Fastest setting first, a setting is taken when it and the next
+	 * faster one pass
+	 */
+	for (Index = QSPI_CAL_SETTINGS; Index > 0; Index--) {
+		Passed = QspiCalPasses(ReadSignature, CalSettings[Index - 1]);
+
+		fsbl_printf(DEBUG_INFO, "QSPI prescaler %d loopback %d: %s\r\n",
+				QSPI_CAL_PRESCALER(CalSettings[Index - 1]),
+				(CalSettings[Index - 1] & QSPI_CAL_LOOPBACK) ? 1 : 0,
+				Passed ? "pass" : "fail");
+
+		if (Passed && FasterPassed) {
+			Setting = CalSettings[Index - 1];
+			break;
+		}
+		FasterPassed = Passed;
+	}
+
+	CachePtr->ConfigId = ConfigId;
+	CachePtr->Setting = Setting;
+	CachePtr->Hash = QspiCalHash(CalReference);
+	CachePtr->Magic = QSPI_CAL_MAGIC;
+	CachePtr->Checksum = QspiCalChecksum(CachePtr);
+
+	return Setting;
+}
+
+/******************************************************************************/
+/**
+*
+* This function reads the signature QSPI_CAL_PASSES times at a setting.
+*
+* @param	ReadSignature sets the clock and reads the signature
+* @param	Setting is the prescaler, ORed with QSPI_CAL_LOOPBACK
+*
+* @return	1 if all reads match the reference, 0 otherwise
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 QspiCalPasses(QspiCalReadType ReadSignature, u32 Setting)
+{
+	u8 *Data;
+	u32 Pass;
+
+	for (Pass = 0; Pass < QSPI_CAL_PASSES; Pass++) {
+		Data = ReadSignature(Setting);
+		if ((Data == NULL) ||
+				(memcmp(Data, CalReference, QSPI_CAL_SIZE) != 0)) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/******************************************************************************/
+/**
+*
+* This function computes the checksum of the cache.
+*
+* @param	CachePtr is the cache
+*
+* @return	Inverted sum of all words before the checksum
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 QspiCalChecksum(QspiCalCache *CachePtr)
+{
+	u32 *Word = (u32 *)CachePtr;
+	u32 Sum = 0;
+	u32 Index;
+
+	for (Index = 0; Index < QSPI_CAL_CHECKSUM_WORDS; Index++) {
+		Sum += Word[Index];
+	}
+
+	return ~Sum;
+}
+
+/******************************************************************************/
+/**
+*
+* This function hashes the signature (FNV-1a).
+*
+* @param	Data is the signature
+*
+* @return	Hash of the QSPI_CAL_SIZE bytes
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 QspiCalHash(u8 *Data)
+{
+	u32 Hash = 0x811C9DC5;
+	u32 Index;
+
+	for (Index = 0; Index < QSPI_CAL_SIZE; Index++) {
+		Hash = ((Hash ^ Data[Index]) * 0x01000193) & 0xFFFFFFFF;
+	}
+
+	return Hash;
+}
+#endif
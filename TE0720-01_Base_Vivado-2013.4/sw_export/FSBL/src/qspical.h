@@ -0,0 +1,125 @@
+/******************************************************************************
+*
+* (c) Copyright 2012-2013 Xilinx, Inc. All rights reserved.
+*
+* This file contains confidential and proprietary information of Xilinx, Inc.
+* and is protected under U.S. and international copyright and other
+* intellectual property laws.
+*
+* DISCLAIMER
+* This disclaimer is not a license and does not grant any rights to the
+* materials distributed herewith. Except as otherwise provided in a valid
+* license issued to you by Xilinx, and to the maximum extent permitted by
+* applicable law: (1) THESE MATERIALS ARE MADE AVAILABLE "AS IS" AND WITH ALL
+* FAULTS, AND XILINX HEREBY DISCLAIMS ALL WARRANTIES AND CONDITIONS, EXPRESS,
+* IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF
+* MERCHANTABILITY, NON-INFRINGEMENT, OR FITNESS FOR ANY PARTICULAR PURPOSE;
+* and (2) Xilinx shall not be liable (whether in contract or tort, including
+* negligence, or under any other theory of liability) for any loss or damage
+* of any kind or nature related to, arising under or in connection with these
+* materials, including for any direct, or any indirect, special, incidental,
+* or consequential loss or damage (including loss of data, profits, goodwill,
+* or any type of loss or damage suffered as a result of any action brought by
+* a third party) even if such damage or loss was reasonably foreseeable or
+* Xilinx had been advised of the possibility of the same.
+*
+* CRITICAL APPLICATIONS
+* Xilinx products are not designed or intended to be fail-safe, or for use in
+* any application requiring fail-safe performance, such as life-support or
+* safety devices or systems, Class III medical devices, nuclear facilities,
+* applications related to the deployment of airbags, or any other applications
+* that could lead to death, personal injury, or severe property or
+* environmental damage (individually and collectively, "Critical
+* Applications"). Customer assumes the sole risk and liability of any use of
+* Xilinx products in Critical Applications, subject only to applicable laws
+* and regulations governing limitations on product liability.
+*
+* THIS COPYRIGHT NOTICE AND DISCLAIMER MUST BE RETAINED AS PART OF THIS FILE
+* AT ALL TIMES.
+*
+*******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file qspical.h
+*
+* This file contains the interface for the QSPI clock calibration
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te	10/16/26 Initial release
+* 1.01a te	10/16/26 Cache in the .qspical_cache section
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___QSPICAL_H___
+#define ___QSPICAL_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#include "xqspips.h"
+
+/************************** Constant Definitions *****************************/
+/*
+ * Linker section of the cache, lscript.ld places it in OCM below the Boot
+ * ROM area
+ */
+#define QSPI_CAL_CACHE_SECTION		".qspical_cache"
+
+#define QSPI_CAL_MAGIC			0x4C414351	/* "QCAL" */
+
+/*
+ * Bytes of the signature and number of reads that must match it
+ */
+#define QSPI_CAL_SIZE			1024
+#define QSPI_CAL_PASSES			16
+
+/*
+ * A setting is the baud rate prescaler, ORed with QSPI_CAL_LOOPBACK when
+ * the data is sampled with the loopback feedback clock
+ */
+#define QSPI_CAL_LOOPBACK		0x100
+#define QSPI_CAL_PRESCALER(Setting)	((Setting) & XQSPIPS_CR_PRESC_MAXIMUM)
+
+/*
+ * Setting used until calibration is done, known to work on all boards
+ */
+#define QSPI_CAL_DEFAULT		XQSPIPS_CLK_PRESCALE_8
+
+/**************************** Type Definitions *******************************/
+/*
+ * Reads the signature at the given setting, returns a pointer to the
+ * QSPI_CAL_SIZE bytes read or NULL if the transfer failed
+ */
+typedef u8 *(*QspiCalReadType)(u32 Setting);
+
+typedef struct {
+	u32 Magic;
+	u32 ConfigId;			/* Flash and clock the setting is valid for */
+	u32 Setting;
+	u32 Hash;				/* Hash of the signature */
+	u32 Checksum;			/* Inverted sum of the words above */
+} QspiCalCache;
+
+/************************** Function Prototypes ******************************/
+u32 QspiCalibrate(QspiCalReadType ReadSignature, u32 ConfigId,
+		QspiCalCache *CachePtr);
+
+/************************** Variable Definitions *****************************/
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___QSPICAL_H___ */
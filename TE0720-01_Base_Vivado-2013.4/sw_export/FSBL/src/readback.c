@@ -0,0 +1,623 @@
+/******************************************************************************
+*
+* (c) Copyright 2012-2013 Xilinx, Inc. All rights reserved.
+*
+* This file contains confidential and proprietary information of Xilinx, Inc.
+* and is protected under U.S. and international copyright and other
+* intellectual property laws.
+*
+* DISCLAIMER
+* This disclaimer is not a license and does not grant any rights to the
+* materials distributed herewith. Except as otherwise provided in a valid
+* license issued to you by Xilinx, and to the maximum extent permitted by
+* applicable law: (1) THESE MATERIALS ARE MADE AVAILABLE "AS IS" AND WITH ALL
+* FAULTS, AND XILINX HEREBY DISCLAIMS ALL WARRANTIES AND CONDITIONS, EXPRESS,
+* IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF
+* MERCHANTABILITY, NON-INFRINGEMENT, OR FITNESS FOR ANY PARTICULAR PURPOSE;
+* and (2) Xilinx shall not be liable (whether in contract or tort, including
+* negligence, or under any other theory of liability) for any loss or damage
+* of any kind or nature related to, arising under or in connection with these
+* materials, including for any direct, or any indirect, special, incidental,
+* or consequential loss or damage (including loss of data, profits, goodwill,
+* or any type of loss or damage suffered as a result of any action brought by
+* a third party) even if such damage or loss was reasonably foreseeable or
+* Xilinx had been advised of the possibility of the same.
+*
+* CRITICAL APPLICATIONS
+* Xilinx products are not designed or intended to be fail-safe, or for use in
+* any application requiring fail-safe performance, such as life-support or
+* safety devices or systems, Class III medical devices, nuclear facilities,
+* applications related to the deployment of airbags, or any other applications
+* that could lead to death, personal injury, or severe property or
+* environmental damage (individually and collectively, "Critical
+* Applications"). Customer assumes the sole risk and liability of any use of
+* Xilinx products in Critical Applications, subject only to applicable laws
+* and regulations governing limitations on product liability.
+*
+* THIS COPYRIGHT NOTICE AND DISCLAIMER MUST BE RETAINED AS PART OF THIS FILE
+* AT ALL TIMES.
+*
+*******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file readback.c
+*
+* Contains the PCAP configuration readback.
+*
+* After a bitstream is loaded its frames are read back through the PCAP
+* with the DMA commands of XDcfg_PcapReadback() and compared to the frame
+* data of the bitstream. One read command covers all frames, the data is taken
+* by DMA commands of READBACK_CHUNK_FRAMES frames into READBACK_BUFFER_ADDR.
+* Further DMA commands are queued while the frames that arrived are
+* checked, so the PCAP keeps running during the compare.
+*
+* Every frame goes into the CRC-32C of its region. The region CRCs of a
+* verified configuration are kept in a ReadbackTable, ReadbackScrub() reads
+* the frames back later and reports the regions whose CRC changed, an upset
+* configuration bit. The bitstream is not needed for that.
+*
+* Frames set in the mask, one bit per frame, are neither compared nor part
+* of a CRC. Frames of LUTRAM, SRL and block RAM contents change while the
+* design runs and have to be masked. Without a mask the frames that differ
+* are reported but do not fail the download, which frames hold memory
+* contents depends on the column layout of the device.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te	10/16/26 Initial release
+* 1.01a te	10/16/26 Differing frames only fail the download with a mask
+*
+* </pre>
+*
+* @note
+*	Compressed and encrypted bitstreams and bitstreams writing more than
+*	one block of frames are not verified.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#ifdef PCAP_READBACK_VERIFY
+#include <string.h>
+#include "xstatus.h"
+#include "xil_cache.h"
+#include "xtime_l.h"
+#include "pcap.h"
+#include "crc32c.h"
+#include "readback.h"
+
+/************************** Constant Definitions *****************************/
+#define READBACK_CHUNK_WORDS	(READBACK_CHUNK_FRAMES * READBACK_FRAME_WORDS)
+
+/*
+ * Read command, the frame address and the read packet are filled in
+ */
+#define READ_COMMAND_FAR		14
+#define READ_COMMAND_COUNT		16
+#define READ_COMMAND_NOOPS		32
+#define READ_COMMAND_WORDS		(READ_COMMAND_COUNT + 1 + READ_COMMAND_NOOPS)
+
+#define READBACK_TABLE_WORDS \
+		((sizeof(ReadbackTable) - sizeof(u32)) / sizeof(u32))
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+#define READBACK_MASKED(Mask, Frame) \
+		(((Mask) != NULL) && ((Mask)[(Frame) >> 5] & (1U << ((Frame) & 31))))
+
+/************************** Function Prototypes ******************************/
+static u32 ReadbackRun(u32 Far, u32 Frames, u32 *Expected, const u32 *Mask,
+		ReadbackTable *Table, u32 Scrub, ReadbackResult *Result);
+static u32 ReadbackTableChecksum(ReadbackTable *Table);
+
+/************************** Variable Definitions *****************************/
+extern XDcfg *DcfgInstPtr;
+
+/*
+ * Frames to skip, set by FsblHookBeforeBitstreamDload() for designs with
+ * frames that change
+ */
+const u32 *ReadbackMask;
+
+static u32 ReadCommand[READ_COMMAND_WORDS] = {
+	CFG_DUMMY,
+	CFG_BUS_WIDTH_SYNC,
+	CFG_BUS_WIDTH_DETECT,
+	CFG_DUMMY,
+	CFG_SYNC,
+	CFG_NOOP,
+	CFG_TYPE1_PACKET(CFG_OP_WRITE, CFG_REG_CMD, 1),
+	CFG_CMD_RCRC,
+	CFG_NOOP,
+	CFG_NOOP,
+	CFG_TYPE1_PACKET(CFG_OP_WRITE, CFG_REG_CMD, 1),
+	CFG_CMD_RCFG,
+	CFG_NOOP,
+	CFG_TYPE1_PACKET(CFG_OP_WRITE, CFG_REG_FAR, 1),
+	0,
+	CFG_TYPE1_PACKET(CFG_OP_READ, CFG_REG_FDRO, 0),
+	0
+};
+
+static u32 DesyncCommand[] = {
+	CFG_NOOP,
+	CFG_TYPE1_PACKET(CFG_OP_WRITE, CFG_REG_CMD, 1),
+	CFG_CMD_DESYNC,
+	CFG_NOOP,
+	CFG_NOOP
+};
+
+/******************************************************************************/
+/**
+*
+* This function finds the frame data of a bitstream. It is the data of
+* the FDRI write, the frame address is the last one written before.
+*
+* @param	Bitstream is the bitstream as the PCAP takes it
+* @param	WordLen is the length of the bitstream in words
+* @param	Image is filled with the frame data
+*
+* @return
+*		- XST_SUCCESS if the bitstream has one block of plain frames
+*		- XST_FAILURE if it has none, more or compressed or encrypted ones
+*
+* @note		None.
+*
+****************************************************************************/
+u32 ReadbackParse(u32 *Bitstream, u32 WordLen, ReadbackImage *Image)
+{
+	u32 Index;
+	u32 Header;
+	u32 Reg = CFG_REG_CRC;
+	u32 Count;
+	u32 Far = 0;
+	u32 DataWords = 0;
+
+	Image->Data = NULL;
+
+	for (Index = 0; Index < WordLen; Index++) {
+		if (Bitstream[Index] == CFG_SYNC) {
+			break;
+		}
+	}
+
+	for (Index++; Index < WordLen; Index += Count) {
+		Header = Bitstream[Index++];
+		if (CFG_TYPE(Header) == CFG_TYPE1) {
+			Reg = CFG_REG(Header);
+			Count = CFG_TYPE1_COUNT(Header);
+		} else if (CFG_TYPE(Header) == CFG_TYPE2) {
+			Count = CFG_TYPE2_COUNT(Header);
+		} else {
+			return XST_FAILURE;
+		}
+
+		if ((Count > WordLen - Index) || (CFG_OPCODE(Header) != CFG_OP_WRITE) ||
+				(Count == 0)) {
+			continue;
+		}
+
+		if ((Reg == CFG_REG_MFWR) || (Reg == CFG_REG_CBC)) {
+			fsbl_printf(DEBUG_INFO,"Readback: compressed or encrypted\r\n");
+			return XST_FAILURE;
+		}
+
+		if (Reg == CFG_REG_FAR) {
+			Far = Bitstream[Index];
+		}
+
+		if (Reg == CFG_REG_FDRI) {
+			if (Image->Data != NULL) {
+				fsbl_printf(DEBUG_INFO,"Readback: more than one FDRI write\r\n");
+				return XST_FAILURE;
+			}
+			Image->Far = Far;
+			Image->Data = &Bitstream[Index];
+			DataWords = Count;
+		}
+
+		if ((Reg == CFG_REG_CMD) && (Bitstream[Index] == CFG_CMD_DESYNC)) {
+			break;
+		}
+	}
+
+	if ((Image->Data == NULL) || (DataWords % READBACK_FRAME_WORDS) ||
+			(DataWords < 2 * READBACK_FRAME_WORDS)) {
+		return XST_FAILURE;
+	}
+
+	Image->Frames = DataWords / READBACK_FRAME_WORDS - READBACK_PAD_FRAMES;
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function reads the frames of a bitstream back and compares them.
+* With a table the region CRCs are stored in it, the table is valid when
+* all frames match.
+*
+* @param	Image is the frame data from ReadbackParse()
+* @param	Mask has a bit set for every frame to skip, NULL for none
+* @param	Table is filled with the region CRCs, NULL for none
+* @param	Result is filled with the counts
+*
+* @return
+*		- XST_SUCCESS if all frames that are not masked match
+*		- XST_FAILURE if a frame differs or the readback failed
+*
+* @note		None.
+*
+****************************************************************************/
+u32 ReadbackVerify(ReadbackImage *Image, const u32 *Mask,
+		ReadbackTable *Table, ReadbackResult *Result)
+{
+	u32 Status;
+
+	if (Table != NULL) {
+		Table->Magic = 0;
+		Table->Far = Image->Far;
+		Table->Frames = Image->Frames;
+		Table->RegionFrames = READBACK_REGION_FRAMES;
+		while (Image->Frames > Table->RegionFrames * READBACK_MAX_REGIONS) {
+			Table->RegionFrames <<= 1;
+		}
+		Table->Regions = (Image->Frames + Table->RegionFrames - 1) /
+				Table->RegionFrames;
+	}
+
+	Status = ReadbackRun(Image->Far, Image->Frames, Image->Data, Mask, Table,
+			FALSE, Result);
+	if ((Status != XST_SUCCESS) || (Result->BadFrames != 0)) {
+		return XST_FAILURE;
+	}
+
+	if (Table != NULL) {
+		Table->Magic = READBACK_TABLE_MAGIC;
+		Table->Checksum = ReadbackTableChecksum(Table);
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function reads the frames of a verified configuration back and
+* compares the region CRCs to the table. Result->FirstBad is the first
+* region that differs.
+*
+* @param	Table holds the region CRCs from ReadbackVerify()
+* @param	Mask has a bit set for every frame to skip, the one used for
+*			the table
+* @param	Result is filled with the counts
+*
+* @return
+*		- XST_SUCCESS if all region CRCs match
+*		- XST_FAILURE if a region differs, the table is invalid or the
+*		  readback failed
+*
+* @note		None.
+*
+****************************************************************************/
+u32 ReadbackScrub(ReadbackTable *Table, const u32 *Mask,
+		ReadbackResult *Result)
+{
+	u32 Status;
+
+	if ((Table->Magic != READBACK_TABLE_MAGIC) ||
+			(Table->Checksum != ReadbackTableChecksum(Table))) {
+		fsbl_printf(DEBUG_INFO,"Readback: no table\r\n");
+		return XST_FAILURE;
+	}
+
+	Status = ReadbackRun(Table->Far, Table->Frames, NULL, Mask, Table, TRUE,
+			Result);
+	if ((Status != XST_SUCCESS) || (Result->BadRegions != 0)) {
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function verifies the configuration after a bitstream is loaded.
+* The region CRCs go to READBACK_TABLE_ADDR. A bitstream that cannot be
+* parsed is not verified. Without ReadbackMask differing frames are only
+* reported, they may be memory contents the design changed. The table is
+* not stored then.
+*
+* @param	Bitstream is the bitstream that was loaded
+* @param	WordLen is the length of the bitstream in words
+*
+* @return
+*		- XST_SUCCESS if the configuration matches, was not verified or
+*		  differs without a mask
+*		- XST_FAILURE if it differs in frames not masked or the readback
+*		  failed
+*
+* @note		None.
+*
+****************************************************************************/
+u32 ReadbackCheckBitstream(u32 *Bitstream, u32 WordLen)
+{
+	ReadbackImage Image;
+	ReadbackResult Result;
+	u32 Status;
+
+	Status = ReadbackParse(Bitstream, WordLen, &Image);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL,"Readback: bitstream not verified\r\n");
+		return XST_SUCCESS;
+	}
+
+	Status = ReadbackVerify(&Image, ReadbackMask,
+			(ReadbackTable *)READBACK_TABLE_ADDR, &Result);
+
+	fsbl_printf(DEBUG_GENERAL,"Readback: %d frames, %d masked, %d bad, "
+			"%d frames/s\r\n", Result.Frames, Result.Skipped,
+			Result.BadFrames, Result.FramesPerSec);
+
+	if (Status != XST_SUCCESS) {
+		if (Result.BadFrames != 0) {
+			fsbl_printf(DEBUG_GENERAL,"Readback: first bad frame %d\r\n",
+					Result.FirstBad);
+			if (ReadbackMask == NULL) {
+				fsbl_printf(DEBUG_GENERAL,"Readback: no mask, "
+						"frames that differ are ignored\r\n");
+				return XST_SUCCESS;
+			}
+		}
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function reads frames back and checks them while they arrive. The
+* read command and the first DMA command are queued together, the other DMA
+* commands are queued as long as the queue takes them. The frames are
+* checked once their DMA command is done.
+*
+* @param	Far is the frame address of the first frame
+* @param	Frames is the number of frames
+* @param	Expected is the frame data to compare to, NULL for none
+* @param	Mask has a bit set for every frame to skip, NULL for none
+* @param	Table takes the region CRCs, NULL for none
+* @param	Scrub compares the region CRCs to the table instead
+* @param	Result is filled with the counts
+*
+* @return
+*		- XST_SUCCESS if all frames were read back
+*		- XST_FAILURE if the readback failed
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 ReadbackRun(u32 Far, u32 Frames, u32 *Expected, const u32 *Mask,
+		ReadbackTable *Table, u32 Scrub, ReadbackResult *Result)
+{
+	u32 *Buffer = (u32 *)READBACK_BUFFER_ADDR;
+	u32 Words = (Frames + READBACK_PAD_FRAMES) * READBACK_FRAME_WORDS;
+	u32 Queued;
+	u32 Landed = 0;
+	u32 Commands = 0;
+	u32 Frame = 0;
+	u32 Index;
+	u32 Length;
+	u32 Crc = CRC32C_INIT;
+	u32 Diff;
+	u32 Checked;
+	u32 IntrStsReg;
+	u32 StatusReg;
+	u32 Count = MAX_COUNT;
+	u32 Status;
+	XTime tStart;
+	XTime tEnd;
+
+	memset(Result, 0, sizeof(*Result));
+	Crc32cInit();
+
+	ReadCommand[READ_COMMAND_FAR] = Far;
+	ReadCommand[READ_COMMAND_COUNT] = CFG_TYPE2_PACKET(CFG_OP_READ, Words);
+	for (Index = READ_COMMAND_COUNT + 1; Index < READ_COMMAND_WORDS;
+			Index++) {
+		ReadCommand[Index] = CFG_NOOP;
+	}
+	Xil_DCacheFlushRange((u32)ReadCommand, sizeof(ReadCommand));
+
+	Status = ClearPcapStatus();
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"PCAP_CLEAR_STATUS_FAIL \r\n");
+		return XST_FAILURE;
+	}
+
+	XTime_GetTime(&tStart);
+
+	/*
+	 * Read command and first DMA command back to back, the way
+	 * XDcfg_PcapReadback() sends them but without its interrupt mask
+	 * accesses in between, the readback data does not wait for them
+	 */
+	XDcfg_WriteReg(DcfgInstPtr->Config.BaseAddr, XDCFG_MCTRL_OFFSET,
+			XDcfg_ReadReg(DcfgInstPtr->Config.BaseAddr, XDCFG_MCTRL_OFFSET) &
+			~XDCFG_MCTRL_PCAP_LPBK_MASK);
+
+	Queued = (Words < READBACK_CHUNK_WORDS) ? Words : READBACK_CHUNK_WORDS;
+	XDcfg_InitiateDma(DcfgInstPtr, (u32)ReadCommand | PCAP_LAST_TRANSFER,
+			XDCFG_DMA_INVALID_ADDRESS, READ_COMMAND_WORDS, 0);
+	XDcfg_InitiateDma(DcfgInstPtr, XDCFG_DMA_INVALID_ADDRESS,
+			(u32)Buffer | ((Queued == Words) ? PCAP_LAST_TRANSFER : 0),
+			0, Queued);
+
+	while (Frame < Frames + READBACK_PAD_FRAMES) {
+		IntrStsReg = XDcfg_IntrGetStatus(DcfgInstPtr);
+		if (IntrStsReg & FSBL_XDCFG_IXR_ERROR_FLAGS_MASK) {
+			fsbl_printf(DEBUG_INFO,"FATAL errors in PCAP %x\r\n",
+					IntrStsReg);
+			PcapDumpRegisters();
+			return XST_FAILURE;
+		}
+
+		/*
+		 * Count the DMA commands done, clearing DMA_DONE acknowledges one.
+		 * The read command is the first.
+		 */
+		StatusReg = XDcfg_GetStatusRegister(DcfgInstPtr);
+		while (StatusReg & XDCFG_STATUS_DMA_DONE_CNT_MASK) {
+			XDcfg_IntrClear(DcfgInstPtr, XDCFG_IXR_DMA_DONE_MASK);
+			Commands++;
+			StatusReg = XDcfg_GetStatusRegister(DcfgInstPtr);
+		}
+
+		if (Commands > 1) {
+			Length = (Commands - 1) * READBACK_CHUNK_WORDS;
+			if (Length > Words) {
+				Length = Words;
+			}
+			if (Length > Landed) {
+				Xil_DCacheInvalidateRange((u32)(Buffer + Landed),
+						(Length - Landed) << WORD_LENGTH_SHIFT);
+				Landed = Length;
+			}
+		}
+
+		/*
+		 * The readback does not wait for DMA commands, keep them queued
+		 */
+		while ((Queued < Words) &&
+				!(StatusReg & XDCFG_STATUS_DMA_CMD_Q_F_MASK)) {
+			Length = Words - Queued;
+			if (Length > READBACK_CHUNK_WORDS) {
+				Length = READBACK_CHUNK_WORDS;
+			}
+			XDcfg_InitiateDma(DcfgInstPtr, XDCFG_DMA_INVALID_ADDRESS,
+					(u32)(Buffer + Queued) |
+					((Queued + Length == Words) ? PCAP_LAST_TRANSFER : 0),
+					0, Length);
+			Queued += Length;
+			StatusReg = XDcfg_GetStatusRegister(DcfgInstPtr);
+		}
+
+		if ((Frame + 1) * READBACK_FRAME_WORDS > Landed) {
+			if (--Count == 0) {
+				fsbl_printf(DEBUG_GENERAL,"PCAP readback timed out \r\n");
+				return XST_FAILURE;
+			}
+			continue;
+		}
+		Count = MAX_COUNT;
+
+		for (Checked = 0; (Checked < READBACK_POLL_FRAMES) &&
+				((Frame + 1) * READBACK_FRAME_WORDS <= Landed);
+				Checked++, Frame++) {
+			if (Frame < READBACK_PAD_FRAMES) {
+				continue;
+			}
+			Index = Frame - READBACK_PAD_FRAMES;
+
+			if (READBACK_MASKED(Mask, Index)) {
+				Result->Skipped++;
+			} else if (Expected != NULL) {
+				Diff = 0;
+				Crc = Crc32cCompare(Crc,
+						Buffer + Frame * READBACK_FRAME_WORDS,
+						Expected + Index * READBACK_FRAME_WORDS,
+						READBACK_FRAME_WORDS, &Diff);
+				if (Diff != 0) {
+					if (Result->BadFrames == 0) {
+						Result->FirstBad = Index;
+					}
+					Result->BadFrames++;
+				}
+			} else {
+				Crc = Crc32cWords(Crc, Buffer + Frame * READBACK_FRAME_WORDS,
+						READBACK_FRAME_WORDS);
+			}
+
+			/*
+			 * End of a region
+			 */
+			if ((Table == NULL) || (((Index + 1) % Table->RegionFrames != 0) &&
+					(Index + 1 != Frames))) {
+				continue;
+			}
+
+			Index /= Table->RegionFrames;
+			if (!Scrub) {
+				Table->Crc[Index] = ~Crc;
+			} else if (Table->Crc[Index] != ~Crc) {
+				if (Result->BadRegions == 0) {
+					Result->FirstBad = Index;
+				}
+				Result->BadRegions++;
+			}
+			Crc = CRC32C_INIT;
+		}
+	}
+
+	XTime_GetTime(&tEnd);
+	Result->Frames = Frames;
+	if (tEnd > tStart) {
+		Result->FramesPerSec = (u32)(((u64)Frames * COUNTS_PER_SECOND) /
+				(tEnd - tStart));
+	}
+
+	/*
+	 * Leave the configuration logic
+	 */
+	Status = ClearPcapStatus();
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"PCAP_CLEAR_STATUS_FAIL \r\n");
+		return XST_FAILURE;
+	}
+
+	Status = XDcfg_Transfer(DcfgInstPtr,
+			(u8 *)((u32)DesyncCommand | PCAP_LAST_TRANSFER),
+			sizeof(DesyncCommand) / sizeof(u32),
+			(u8 *)(XDCFG_DMA_INVALID_ADDRESS | PCAP_LAST_TRANSFER), 0,
+			XDCFG_NON_SECURE_PCAP_WRITE);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"Status of XDcfg_Transfer = %d \r \n",Status);
+		return XST_FAILURE;
+	}
+
+	return XDcfgPollDone(XDCFG_IXR_DMA_DONE_MASK, MAX_COUNT);
+}
+
+/******************************************************************************/
+/**
+*
+* This function computes the checksum of a table.
+*
+* @param	Table is the table
+*
+* @return	The inverted sum of the words before the checksum
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 ReadbackTableChecksum(ReadbackTable *Table)
+{
+	u32 *Word = (u32 *)Table;
+	u32 Sum = 0;
+	u32 Index;
+
+	for (Index = 0; Index < READBACK_TABLE_WORDS; Index++) {
+		Sum += Word[Index];
+	}
+
+	return ~Sum;
+}
+#endif
@@ -0,0 +1,201 @@
+/******************************************************************************
+*
+* (c) Copyright 2012-2013 Xilinx, Inc. All rights reserved.
+*
+* This file contains confidential and proprietary information of Xilinx, Inc.
+* and is protected under U.S. and international copyright and other
+* intellectual property laws.
+*
+* DISCLAIMER
+* This disclaimer is not a license and does not grant any rights to the
+* materials distributed herewith. Except as otherwise provided in a valid
+* license issued to you by Xilinx, and to the maximum extent permitted by
+* applicable law: (1) THESE MATERIALS ARE MADE AVAILABLE "AS IS" AND WITH ALL
+* FAULTS, AND XILINX HEREBY DISCLAIMS ALL WARRANTIES AND CONDITIONS, EXPRESS,
+* IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF
+* MERCHANTABILITY, NON-INFRINGEMENT, OR FITNESS FOR ANY PARTICULAR PURPOSE;
+* and (2) Xilinx shall not be liable (whether in contract or tort, including
+* negligence, or under any other theory of liability) for any loss or damage
+* of any kind or nature related to, arising under or in connection with these
+* materials, including for any direct, or any indirect, special, incidental,
+* or consequential loss or damage (including loss of data, profits, goodwill,
+* or any type of loss or damage suffered as a result of any action brought by
+* a third party) even if such damage or loss was reasonably foreseeable or
+* Xilinx had been advised of the possibility of the same.
+*
+* CRITICAL APPLICATIONS
+* Xilinx products are not designed or intended to be fail-safe, or for use in
+* any application requiring fail-safe performance, such as life-support or
+* safety devices or systems, Class III medical devices, nuclear facilities,
+* applications related to the deployment of airbags, or any other applications
+* that could lead to death, personal injury, or severe property or
+* environmental damage (individually and collectively, "Critical
+* Applications"). Customer assumes the sole risk and liability of any use of
+* Xilinx products in Critical Applications, subject only to applicable laws
+* and regulations governing limitations on product liability.
+*
+* THIS COPYRIGHT NOTICE AND DISCLAIMER MUST BE RETAINED AS PART OF THIS FILE
+* AT ALL TIMES.
+*
+*******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file readback.h
+*
+* This file contains the interface for the PCAP configuration readback
+*
+* Frames are read back in the order the bitstream writes them, starting at
+* its frame address. The stream of both has two pad frames at the end of
+* every row. The bitstream ends with a pad frame that flushes the frame
+* buffer, the readback starts with one.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te	10/16/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___READBACK_H___
+#define ___READBACK_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+
+/************************** Constant Definitions *****************************/
+/*
+ * DDR the frames are read back to, the readback of a 7z030 takes 6MB.
+ * Partitions loaded before the bitstream must not be there.
+ */
+#ifndef READBACK_BUFFER_ADDR
+#define READBACK_BUFFER_ADDR	(DDR_START_ADDR + 0x1000000)
+#endif
+
+/*
+ * DDR region holding the region CRCs for scrubbing by the application
+ */
+#ifndef READBACK_TABLE_ADDR
+#define READBACK_TABLE_ADDR		0x3FFFE000
+#endif
+
+#define READBACK_TABLE_MAGIC	0x4B424452	/* "RDBK" */
+
+#define READBACK_FRAME_WORDS	101
+#define READBACK_PAD_FRAMES		1
+
+/*
+ * Frames per DMA command and frames checked between two polls of the DMA
+ */
+#ifndef READBACK_CHUNK_FRAMES
+#define READBACK_CHUNK_FRAMES	256
+#endif
+#define READBACK_POLL_FRAMES	8
+
+/*
+ * Frames per CRC region, doubled until the regions fit into the table
+ */
+#define READBACK_REGION_FRAMES	32
+#define READBACK_MAX_REGIONS	1000
+
+/*
+ * Configuration packets
+ */
+#define CFG_DUMMY				0xFFFFFFFF
+#define CFG_BUS_WIDTH_SYNC		0x000000BB
+#define CFG_BUS_WIDTH_DETECT	0x11220044
+#define CFG_SYNC				0xAA995566
+#define CFG_NOOP				0x20000000
+
+#define CFG_TYPE(Header)		((Header) >> 29)
+#define CFG_OPCODE(Header)		(((Header) >> 27) & 0x3)
+#define CFG_REG(Header)			(((Header) >> 13) & 0x1F)
+#define CFG_TYPE1_COUNT(Header)	((Header) & 0x7FF)
+#define CFG_TYPE2_COUNT(Header)	((Header) & 0x7FFFFFF)
+
+#define CFG_TYPE1				1
+#define CFG_TYPE2				2
+#define CFG_OP_READ				1
+#define CFG_OP_WRITE			2
+
+#define CFG_TYPE1_PACKET(Op, Reg, Count) \
+		((CFG_TYPE1 << 29) | ((Op) << 27) | ((Reg) << 13) | (Count))
+#define CFG_TYPE2_PACKET(Op, Count) \
+		((CFG_TYPE2 << 29) | ((Op) << 27) | (Count))
+
+#define CFG_REG_CRC				0
+#define CFG_REG_FAR				1
+#define CFG_REG_FDRI			2
+#define CFG_REG_FDRO			3
+#define CFG_REG_CMD				4
+#define CFG_REG_MFWR			10
+#define CFG_REG_CBC				11
+
+#define CFG_CMD_WCFG			1
+#define CFG_CMD_RCFG			4
+#define CFG_CMD_START			5
+#define CFG_CMD_RCRC			7
+#define CFG_CMD_DESYNC			13
+
+/**************************** Type Definitions *******************************/
+/*
+ * Frame data of a bitstream
+ */
+typedef struct {
+	u32 Far;				/* Frame address of the first frame */
+	u32 Frames;				/* Frames without the trailing pad frame */
+	u32 *Data;				/* READBACK_FRAME_WORDS per frame */
+} ReadbackImage;
+
+/*
+ * Region CRCs of a verified configuration
+ */
+typedef struct {
+	u32 Magic;
+	u32 Far;
+	u32 Frames;
+	u32 RegionFrames;
+	u32 Regions;
+	u32 Crc[READBACK_MAX_REGIONS];	/* CRC-32C of the unmasked frames */
+	u32 Checksum;			/* Inverted sum of the words above */
+} ReadbackTable;
+
+typedef struct {
+	u32 Frames;				/* Frames read back */
+	u32 Skipped;			/* Masked frames */
+	u32 BadFrames;			/* Frames that differ from the bitstream */
+	u32 BadRegions;			/* Regions with a CRC that differs */
+	u32 FirstBad;			/* First bad frame, or region when scrubbing */
+	u32 FramesPerSec;
+} ReadbackResult;
+
+/************************** Function Prototypes ******************************/
+u32 ReadbackParse(u32 *Bitstream, u32 WordLen, ReadbackImage *Image);
+
+u32 ReadbackVerify(ReadbackImage *Image, const u32 *Mask,
+		ReadbackTable *Table, ReadbackResult *Result);
+
+u32 ReadbackScrub(ReadbackTable *Table, const u32 *Mask,
+		ReadbackResult *Result);
+
+u32 ReadbackCheckBitstream(u32 *Bitstream, u32 WordLen);
+
+/************************** Variable Definitions *****************************/
+extern const u32 *ReadbackMask;
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___READBACK_H___ */
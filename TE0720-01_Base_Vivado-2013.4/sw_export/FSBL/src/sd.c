@@ -45,12 +45,17 @@
 *
 * Contains code for the SD card FLASH functionality.
 *
+* Long reads into DDR of a partition with a checksum are posted to the
+* card driver: FatFs queues the cluster reads and the MD5 checksum of each
+* one is computed while the card transfers the next.
+*
 * <pre>
 * MODIFICATION HISTORY:
 *
 * Ver	Who	Date		Changes
 * ----- ---- -------- -------------------------------------------------------
 * 1.00a jz	04/28/11 Initial release
+* 7.00a te	10/16/26 MD5 checksum of long reads computed during the read
 *
 * </pre>
 *
@@ -63,21 +68,33 @@
 #include "fsbl.h"
 #ifdef XPAR_PS7_SD_0_S_AXI_BASEADDR
 #include "xstatus.h"
+#include <string.h>
 
 #include "ff.h"
+#include "diskio.h"
+#include "md5.h"
 #include "sd.h"
 
 /************************** Constant Definitions *****************************/
 
+#define SD_STREAM_MIN_LEN	0x10000	/* Reads checksummed on the way */
+#define SD_STREAM_CHUNK		0x1000	/* Bytes hashed between card polls */
+#define SD_SECTOR_SIZE		512
+#define SD_MD5_SIZE		16
+
 /**************************** Type Definitions *******************************/
 
 /***************** Macros (Inline Functions) Definitions *********************/
 
 /************************** Function Prototypes ******************************/
 
+static void SdStreamHash(u8 *End);
+static void SdStreamDone(DISK_REQ *Req);
+
 /************************** Variable Definitions *****************************/
 
 extern u32 FlashReadBaseAddress;
+extern u8 PartitionChecksumFlag;
 
 
 static FIL fil;		/* File object */
@@ -85,6 +102,13 @@ static FATFS fatfs;
 static char buffer[32];
 static char *boot_file = buffer;
 
+static MD5Context StreamContext;
+static u8 *StreamHashed;	/* Read data hashed up to here */
+static u32 StreamError;
+static u8 StreamChecksum[SD_MD5_SIZE];
+static u32 ChecksumAddress;
+static u32 ChecksumLength;
+
 /******************************************************************************/
 /******************************************************************************/
 /**
@@ -116,6 +140,7 @@ u32 InitSD(const char *filename)
 	strcpy_rom(buffer, filename);
 	boot_file = (char *)buffer;
 	FlashReadBaseAddress = XPAR_PS7_SD_0_S_AXI_BASEADDR;
+	ChecksumLength = 0;
 
 	rc = f_open(&fil, boot_file, FA_READ);
 	if (rc) {
@@ -149,6 +174,7 @@ u32 SDAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 
 	FRESULT rc;	 /* Result code */
 	UINT br;
+	u32 Stream;
 
 	rc = f_lseek(&fil, SourceAddress);
 	if (rc) {
@@ -156,16 +182,146 @@ u32 SDAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 		return XST_FAILURE;
 	}
 
+	/*
+	 * Checksum of a range that gets overwritten is stale
+	 */
+	if ((DestinationAddress < (ChecksumAddress + ChecksumLength)) &&
+			((DestinationAddress + LengthBytes) > ChecksumAddress)) {
+		ChecksumLength = 0;
+	}
+
+	/*
+	 * Long reads into DDR of a partition with a checksum are posted,
+	 * the data is hashed as the cluster reads complete
+	 */
+	Stream = PartitionChecksumFlag &&
+			(LengthBytes >= SD_STREAM_MIN_LEN) &&
+			(DestinationAddress >= DDR_START_ADDR);
+	if (Stream) {
+		MD5Init(&StreamContext);
+		StreamHashed = (u8 *)DestinationAddress;
+		StreamError = 0;
+		disk_read_post(0, (BYTE *)DestinationAddress, LengthBytes,
+				SdStreamDone);
+	}
+
 	rc = f_read(&fil, (void*)DestinationAddress, LengthBytes, &br);
 
 	if (rc) {
 		fsbl_printf(DEBUG_GENERAL,"*** ERROR: f_read returned %d\r\n", rc);
 	}
 
+	if (Stream) {
+		/*
+		 * Wait for the posted reads, partial sectors at the end were
+		 * copied by FatFs
+		 */
+		disk_read_post(0, NULL, 0, NULL);
+		if (StreamError) {
+			fsbl_printf(DEBUG_GENERAL,"SD: Read error at %x\r\n",
+					SourceAddress);
+			return XST_FAILURE;
+		}
+
+		if ((rc == FR_OK) && (br == LengthBytes)) {
+			SdStreamHash((u8 *)(DestinationAddress + LengthBytes));
+			MD5Final(&StreamContext, StreamChecksum, 0);
+			ChecksumAddress = DestinationAddress;
+			ChecksumLength = LengthBytes;
+		}
+	}
+
 	return XST_SUCCESS;
 
 } /* End of SDAccess */
 
+/******************************************************************************/
+/**
+*
+* This function returns the MD5 checksum computed while the last long read
+* was transferred from the card.
+*
+* @param	Address is the start address of the data
+* @param	Length is the length of the data in bytes
+* @param	Checksum is the buffer the checksum is copied to
+*
+* @return
+*		- XST_SUCCESS if the checksum of this range is known
+*		- XST_FAILURE if the range was not streamed, the caller has
+*		  to compute the checksum
+*
+* @note		None.
+*
+****************************************************************************/
+u32 SdGetStreamChecksum(u32 Address, u32 Length, u8 *Checksum)
+{
+	if ((FlashReadBaseAddress != XPAR_PS7_SD_0_S_AXI_BASEADDR) ||
+			(ChecksumLength == 0) ||
+			(Address != ChecksumAddress) ||
+			(Length != ChecksumLength)) {
+		return XST_FAILURE;
+	}
+
+	memcpy(Checksum, StreamChecksum, SD_MD5_SIZE);
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function hashes the read data up to an address. The card is polled
+* between chunks, so that the next queued read starts as soon as the
+* current one ends.
+*
+* @param	End is the address the data is complete up to
+*
+* @return	None.
+*
+* @note		All data below End must be in memory, the reads complete
+*			in order and FatFs copies partial sectors before it posts
+*			the following reads.
+*
+****************************************************************************/
+static void SdStreamHash(u8 *End)
+{
+	u32 Chunk;
+
+	while (StreamHashed < End) {
+		Chunk = End - StreamHashed;
+		if (Chunk > SD_STREAM_CHUNK) {
+			Chunk = SD_STREAM_CHUNK;
+		}
+
+		MD5Update(&StreamContext, StreamHashed, Chunk, 0);
+		StreamHashed += Chunk;
+
+		disk_read_poll(0);
+	}
+}
+
+/******************************************************************************/
+/**
+*
+* This function is called by the card driver for each completed posted read
+*
+* @param	Req is the completed request
+*
+* @return	None.
+*
+* @note		None.
+*
+****************************************************************************/
+static void SdStreamDone(DISK_REQ *Req)
+{
+	if (Req->res != RES_OK) {
+		StreamError = 1;
+		return;
+	}
+
+	SdStreamHash(Req->buff + (Req->count * SD_SECTOR_SIZE));
+}
+
 
 /******************************************************************************/
 /**
@@ -51,6 +51,7 @@
 * Ver	Who	Date		Changes
 * ----- ---- -------- -------------------------------------------------------
 * 1.00a bh	03/10/11 Initial release
+* 7.00a te	10/16/26 Added SdGetStreamChecksum
 *
 * </pre>
 *
@@ -76,6 +77,8 @@ u32 SDAccess( u32 SourceAddress,
 		u32 LengthWords);
 
 void ReleaseSD(void);
+
+u32 SdGetStreamChecksum(u32 Address, u32 Length, u8 *Checksum);
 #endif
 /************************** Variable Definitions *****************************/
 #ifdef __cplusplus
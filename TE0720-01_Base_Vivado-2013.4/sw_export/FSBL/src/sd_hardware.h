@@ -49,6 +49,8 @@
 * Ver	Who	Date	 Changes
 * ----- ---- -------- ---------------------------------------------------
 * 1.00a bh	02/01/11 Initial version,
+* 7.00a te	10/16/26 Added 8-bit, DDR and capability bits for the bus
+*			 negotiation of mmc.c
 * </pre>
 *
 * @note	None.
@@ -103,6 +105,7 @@
 #define SD_HOST_HS		0x04
 #define SD_HOST_ADMA1		0x08
 #define SD_HOST_ADMA2		0x10
+#define SD_HOST_8BIT		0x20
 
 #define SD_PWR_CTRL_R	 	0x29
 #define	SD_POWER_ON		0x01
@@ -146,7 +149,16 @@
 #define	SD_INT_ERR_ADMA	 	0x02000000
 #define	SD_INT_ERR_TRESP	0x10000000
 
+#define SD_HOST_CTRL2_R		0x3E
+#define	SD_CTRL2_UHS_MASK	0x0007
+#define	SD_CTRL2_DDR50		0x0004
+
 #define SD_CAPABILITIES_R	0x40
+#define	SD_CAP_8BIT		0x00040000
+#define	SD_CAP_HS		0x00200000
+
+#define SD_CAPABILITIES2_R	0x44
+#define	SD_CAP2_DDR50		0x00000004
 
 #define SD_ADMA_ADDR_R		0x58
 #define DESC_ATBR_VALID     	(0x1 << 0)
@@ -155,4 +167,8 @@
 #define DESC_ATBR_ACT_TRAN  	(0x2 << 4)
 #define DESC_ATBR_LEN_SHIFT	16
 
+#define SD_HOST_VER_R		0xFE
+#define	SD_SPEC_VER_MASK	0x00FF
+#define	SD_SPEC_VER_300		0x0002
+
 #endif
@@ -0,0 +1,1140 @@
+/******************************************************************************
+*
+* (c) Copyright 2012-2013 Xilinx, Inc. All rights reserved.
+*
+* This file contains confidential and proprietary information of Xilinx, Inc.
+* and is protected under U.S. and international copyright and other
+* intellectual property laws.
+*
+* DISCLAIMER
+* This disclaimer is not a license and does not grant any rights to the
+* materials distributed herewith. Except as otherwise provided in a valid
+* license issued to you by Xilinx, and to the maximum extent permitted by
+* applicable law: (1) THESE MATERIALS ARE MADE AVAILABLE "AS IS" AND WITH ALL
+* FAULTS, AND XILINX HEREBY DISCLAIMS ALL WARRANTIES AND CONDITIONS, EXPRESS,
+* IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF
+* MERCHANTABILITY, NON-INFRINGEMENT, OR FITNESS FOR ANY PARTICULAR PURPOSE;
+* and (2) Xilinx shall not be liable (whether in contract or tort, including
+* negligence, or under any other theory of liability) for any loss or damage
+* of any kind or nature related to, arising under or in connection with these
+* materials, including for any direct, or any indirect, special, incidental,
+* or consequential loss or damage (including loss of data, profits, goodwill,
+* or any type of loss or damage suffered as a result of any action brought by
+* a third party) even if such damage or loss was reasonably foreseeable or
+* Xilinx had been advised of the possibility of the same.
+*
+* CRITICAL APPLICATIONS
+* Xilinx products are not designed or intended to be fail-safe, or for use in
+* any application requiring fail-safe performance, such as life-support or
+* safety devices or systems, Class III medical devices, nuclear facilities,
+* applications related to the deployment of airbags, or any other applications
+* that could lead to death, personal injury, or severe property or
+* environmental damage (individually and collectively, "Critical
+* Applications"). Customer assumes the sole risk and liability of any use of
+* Xilinx products in Critical Applications, subject only to applicable laws
+* and regulations governing limitations on product liability.
+*
+* THIS COPYRIGHT NOTICE AND DISCLAIMER MUST BE RETAINED AS PART OF THIS FILE
+* AT ALL TIMES.
+*
+*******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file sdmanifest.c
+*
+* Contains SD boot from a manifest of partition files.
+*
+* Instead of the partitions of BOOT.BIN, the files listed in the manifest
+* SD_MANIFEST_FILE are loaded, so that a bitstream or an application can be
+* replaced on the card without packing a new boot image. BOOT.BIN is still
+* needed for the FSBL itself. Each line of the manifest names a file in the
+* root directory, its type and the MD5 digest of the file as printed by
+* md5sum, '#' starts a comment:
+*
+*	system.bit	bit			md5	bitstream, .bit file or .bin
+*	u-boot.elf	elf	[exec]	md5	ELF, loaded by its program headers
+*	devtree.dtb	bin	load [exec]	md5	raw data at the load address
+*
+* The digest is computed over the bytes as they are read, sectors the load
+* does not need are read for it as well. A bitstream is checked before it
+* goes to the PCAP, a PS file once it is loaded; a mismatch fails the boot
+* like a partition checksum of BOOT.BIN.
+*
+* When the eFuse enforces RSA authentication the manifest is not used and
+* the signed partitions of BOOT.BIN are loaded.
+*
+* Addresses are decimal or 0x hex. Bitstreams are staged at
+* DDR_TEMP_START_ADDR and have to come before the PS files. The handoff
+* goes to the first PS file with an execution address, the ELF entry unless
+* one is given.
+*
+* When the manifest is opened, the FAT cluster chain of every file is
+* followed once and kept as a list of contiguous sector runs. The files are
+* then read with multi-sector disk_read() calls straight to their
+* destination, only partial sectors and unaligned destinations go through
+* a sector buffer.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te	10/16/26 Initial release
+*                   MD5 digest per file, not used with RSA enforced
+*
+* </pre>
+*
+* @note
+*	A bitstream .bin in PCAP byte order at the start of a sector is handed
+*	to the PCAP as read. A .bit file is swapped into PCAP order in DDR.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#if defined(SD_MANIFEST_BOOT) && defined(XPAR_PS7_SD_0_S_AXI_BASEADDR)
+#include <string.h>
+#include "xstatus.h"
+#include "ff.h"
+#include "diskio.h"
+#include "fsbl_hooks.h"
+#include "md5.h"
+#include "sdmanifest.h"
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+#include "xwdtps.h"
+#endif
+
+/************************** Constant Definitions *****************************/
+#define SD_MANIFEST_MAX_TOKENS	5
+
+/*
+ * .bit file preamble and the field holding the bitstream
+ */
+#define BIT_PREAMBLE_SIZE		13
+#define BIT_DATA_KEY			'e'
+
+/*
+ * Words searched for the sync word at the start of a bitstream
+ */
+#define BIT_SYNC_SEARCH			64
+
+/*
+ * ELF32 header and program header fields used
+ */
+#define ELF_HEADER_SIZE			52
+#define ELF_ENTRY_OFFSET		24
+#define ELF_PHOFF_OFFSET		28
+#define ELF_PHENTSIZE_OFFSET	42
+#define ELF_PHNUM_OFFSET		44
+#define ELF_MACHINE_OFFSET		18
+#define ELF_MACHINE_ARM			40
+
+#define ELF_PH_SIZE				32
+#define ELF_PH_TYPE_OFFSET		0
+#define ELF_PH_OFFSET_OFFSET	4
+#define ELF_PH_PADDR_OFFSET		12
+#define ELF_PH_FILESZ_OFFSET	16
+#define ELF_PH_MEMSZ_OFFSET		20
+#define ELF_PT_LOAD				1
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+#define SD_LE16(p)	((u32)(p)[0] | ((u32)(p)[1] << 8))
+#define SD_LE32(p)	((u32)(p)[0] | ((u32)(p)[1] << 8) | \
+					 ((u32)(p)[2] << 16) | ((u32)(p)[3] << 24))
+#define SD_BE32(p)	((u32)(p)[3] | ((u32)(p)[2] << 8) | \
+					 ((u32)(p)[1] << 16) | ((u32)(p)[0] << 24))
+
+/************************** Function Prototypes ******************************/
+static u32 SdManifestParse(char *Text, u32 Length);
+static u32 SdManifestEntry(char **Token, u32 TokenCount);
+static u32 SdManifestNumber(const char *Token, u32 *ValuePtr);
+static u32 SdManifestDigest(const char *Token, u8 *Digest);
+static u32 SdManifestIndex(SdManifestFile *File);
+static u32 SdManifestRead(SdManifestFile *File, u32 Offset, u8 *Dest,
+		u32 Length);
+static u32 SdManifestHash(SdManifestFile *File, u32 Offset);
+static u32 SdManifestVerify(SdManifestFile *File);
+static u32 SdManifestCheckRange(u32 Address, u32 Length);
+static u32 SdManifestLoadBitstream(SdManifestFile *File, u32 *WordCountPtr);
+static u32 SdManifestLoadElf(SdManifestFile *File, u32 *EntryPtr);
+
+/*
+ * FAT access of ff.c
+ */
+DWORD clust2sect(FATFS *fs, DWORD clst);
+DWORD get_fat(FATFS *fs, DWORD clst);
+
+/************************** Variable Definitions *****************************/
+
+extern u8 BitstreamFlag;
+extern u32 Silicon_Version;
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+extern XWdtPs Watchdog;	/* Instance of WatchDog Timer	*/
+#endif
+
+static FATFS *Fs;
+static SdManifestFile Files[SD_MANIFEST_MAX_FILES];
+static u32 FileCount;
+static SdManifestExtent Extents[SD_MANIFEST_MAX_EXTENTS];
+static u32 ExtentCount;
+
+/*
+ * Manifest text, then partial sectors of the files
+ */
+static u8 SdSector[SD_MANIFEST_SECTOR_SIZE] __attribute__ ((aligned(4)));
+
+/*
+ * Digest of the file being loaded, over its first HashOffset bytes
+ */
+static MD5Context HashContext;
+static u32 HashOffset;
+
+/******************************************************************************/
+/**
+*
+* This function reads the manifest and indexes the sector runs of the files
+* it lists. The SD card must be mounted by InitSD().
+*
+* @param	Name is the file name of the manifest
+*
+* @return
+*		- XST_SUCCESS if the files of the manifest can be loaded
+*		- XST_NO_DATA if there is no manifest or RSA authentication is
+*		  enforced
+*		- XST_FAILURE if the manifest or one of its files is not usable
+*
+* @note		None.
+*
+****************************************************************************/
+u32 SdManifestOpen(const char *Name)
+{
+	FIL Fil;
+	FRESULT rc;
+	UINT br;
+	u32 Index;
+
+	FileCount = 0;
+	ExtentCount = 0;
+
+	/*
+	 * The files of the manifest are not signed, only the partitions of
+	 * the boot image may run when the eFuse enforces RSA. RSA is not
+	 * implemented in 1.0 and 2.0 silicon.
+	 */
+	if ((Silicon_Version != SILICON_VERSION_1) &&
+			(Silicon_Version != SILICON_VERSION_2) &&
+			(Xil_In32(EFUSE_STATUS_REG) & EFUSE_STATUS_RSA_ENABLE_MASK)) {
+		fsbl_printf(DEBUG_GENERAL,"SD: RSA enabled, manifest not used\r\n");
+		return XST_NO_DATA;
+	}
+
+	rc = f_open(&Fil, Name, FA_READ);
+	if (rc == FR_NO_FILE) {
+		fsbl_printf(DEBUG_INFO,"SD: No manifest %s\r\n", Name);
+		return XST_NO_DATA;
+	}
+	if (rc != FR_OK) {
+		fsbl_printf(DEBUG_GENERAL,"SD: Unable to open file %s: %d\r\n",
+				Name, rc);
+		return XST_FAILURE;
+	}
+	Fs = Fil.fs;
+
+	/*
+	 * One byte of the sector is left for the end of the text
+	 */
+	if (Fil.fsize >= SD_MANIFEST_SECTOR_SIZE) {
+		fsbl_printf(DEBUG_GENERAL,"SD: Manifest is larger than %d bytes\r\n",
+				SD_MANIFEST_SECTOR_SIZE - 1);
+		return XST_FAILURE;
+	}
+
+	rc = f_read(&Fil, SdSector, Fil.fsize, &br);
+	f_close(&Fil);
+	if ((rc != FR_OK) || (br != Fil.fsize)) {
+		fsbl_printf(DEBUG_GENERAL,"SD: Unable to read manifest: %d\r\n", rc);
+		return XST_FAILURE;
+	}
+
+	if (SdManifestParse((char *)SdSector, br) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	if (FileCount == 0) {
+		fsbl_printf(DEBUG_GENERAL,"SD: Manifest lists no files\r\n");
+		return XST_FAILURE;
+	}
+
+	for (Index = 0; Index < FileCount; Index++) {
+		if (SdManifestIndex(&Files[Index]) != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		fsbl_printf(DEBUG_INFO,"SD: %s %d bytes in %d runs\r\n",
+				Files[Index].Name, Files[Index].Size,
+				Files[Index].ExtentCount);
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function loads the files of the manifest in their order, the
+* bitstreams into the fabric and the PS files into DDR.
+*
+* @param	None
+*
+* @return	Execution address of the first PS file that has one, 0 if
+*		none has
+*
+* @note		Falls back on any failure, like LoadBootImage().
+*
+****************************************************************************/
+u32 SdManifestLoad(void)
+{
+	SdManifestFile *File;
+	u32 ExecAddress = 0;
+	u8 ExecAddrFlag = 0;
+	u32 Entry;
+	u32 WordCount;
+	u32 Status;
+	u32 Index;
+
+	BitstreamFlag = 0;
+
+	for (Index = 0; Index < FileCount; Index++) {
+		File = &Files[Index];
+		Entry = File->ExecAddr;
+
+		fsbl_printf(DEBUG_INFO,"SD: Loading %s\r\n", File->Name);
+
+		MD5Init(&HashContext);
+		HashOffset = 0;
+
+		switch (File->Type) {
+		case SD_MANIFEST_TYPE_BIT:
+			/*
+			 * FSBL user hook call before bitstream download
+			 */
+			Status = FsblHookBeforeBitstreamDload();
+			if (Status != XST_SUCCESS) {
+				fsbl_printf(DEBUG_GENERAL,"FSBL_BEFORE_BSTREAM_HOOK_FAIL\r\n");
+				OutputStatus(FSBL_BEFORE_BSTREAM_HOOK_FAIL);
+				FsblFallback();
+			}
+
+			Status = SdManifestLoadBitstream(File, &WordCount);
+			if (Status == XST_SUCCESS) {
+				Status = SdManifestVerify(File);
+			}
+			if (Status != XST_SUCCESS) {
+				break;
+			}
+
+			Status = PcapLoadPartition((u32 *)DDR_TEMP_START_ADDR, 0,
+					WordCount, WordCount, 0);
+			if (Status != XST_SUCCESS) {
+				fsbl_printf(DEBUG_GENERAL,"BITSTREAM_DOWNLOAD_FAIL\r\n");
+				OutputStatus(BITSTREAM_DOWNLOAD_FAIL);
+				FsblFallback();
+			}
+			BitstreamFlag = 1;
+
+			/*
+			 * FSBL user hook call after bitstream download
+			 */
+			Status = FsblHookAfterBitstreamDload();
+			if (Status != XST_SUCCESS) {
+				fsbl_printf(DEBUG_GENERAL,"FSBL_AFTER_BSTREAM_HOOK_FAIL\r\n");
+				OutputStatus(FSBL_AFTER_BSTREAM_HOOK_FAIL);
+				FsblFallback();
+			}
+			break;
+
+		case SD_MANIFEST_TYPE_ELF:
+			Status = SdManifestLoadElf(File, &Entry);
+			if (File->ExecFlag) {
+				Entry = File->ExecAddr;
+			}
+			break;
+
+		default:
+			Status = SdManifestCheckRange(File->LoadAddr, File->Size);
+			if (Status == XST_SUCCESS) {
+				Status = SdManifestRead(File, 0, (u8 *)File->LoadAddr,
+						File->Size);
+			}
+			break;
+		}
+
+		/*
+		 * The bitstream was checked before the download
+		 */
+		if ((Status == XST_SUCCESS) && (File->Type != SD_MANIFEST_TYPE_BIT)) {
+			Status = SdManifestVerify(File);
+		}
+
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL,"SD_MANIFEST_FAIL\r\n");
+			OutputStatus(SD_MANIFEST_FAIL);
+			FsblFallback();
+		}
+
+		/*
+		 * Execution address of the first PS file that has one
+		 */
+		if ((!ExecAddrFlag) && ((File->Type == SD_MANIFEST_TYPE_ELF) ||
+				((File->Type == SD_MANIFEST_TYPE_BIN) && File->ExecFlag))) {
+			ExecAddrFlag = 1;
+			ExecAddress = Entry;
+		}
+	}
+
+	return ExecAddress;
+}
+
+/******************************************************************************/
+/**
+*
+* This function splits the manifest into lines and fields
+*
+* @param	Text is the manifest, with room for one more byte
+* @param	Length is the length of the manifest in bytes
+*
+* @return
+*		- XST_SUCCESS if all lines are valid
+*		- XST_FAILURE if a line is not
+*
+* @note		The text is modified.
+*
+****************************************************************************/
+static u32 SdManifestParse(char *Text, u32 Length)
+{
+	char *Token[SD_MANIFEST_MAX_TOKENS];
+	u32 TokenCount;
+	u32 Line = 1;
+	u32 Pos;
+	u8 Comment = 0;
+
+	/*
+	 * Blanks and comments end the fields
+	 */
+	for (Pos = 0; Pos < Length; Pos++) {
+		if (Text[Pos] == '\n') {
+			Comment = 0;
+			continue;
+		}
+		if (Text[Pos] == '#') {
+			Comment = 1;
+		}
+		if (Comment || (Text[Pos] == ' ') || (Text[Pos] == '\t') ||
+				(Text[Pos] == '\r')) {
+			Text[Pos] = '\0';
+		}
+	}
+	Text[Length] = '\0';
+
+	Pos = 0;
+	while (Pos < Length) {
+		TokenCount = 0;
+		while ((Pos < Length) && (Text[Pos] != '\n')) {
+			if (Text[Pos] == '\0') {
+				Pos++;
+				continue;
+			}
+			if (TokenCount == SD_MANIFEST_MAX_TOKENS) {
+				fsbl_printf(DEBUG_GENERAL,"SD: Manifest line %d has too "
+						"many fields\r\n", Line);
+				return XST_FAILURE;
+			}
+			Token[TokenCount++] = &Text[Pos];
+			while ((Pos < Length) && (Text[Pos] != '\0') &&
+					(Text[Pos] != '\n')) {
+				Pos++;
+			}
+		}
+		Text[Pos++] = '\0';
+
+		if ((TokenCount > 0) &&
+				(SdManifestEntry(Token, TokenCount) != XST_SUCCESS)) {
+			fsbl_printf(DEBUG_GENERAL,"SD: Manifest line %d is invalid\r\n",
+					Line);
+			return XST_FAILURE;
+		}
+		Line++;
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function adds the file of a manifest line
+*
+* @param	Token are the fields of the line
+* @param	TokenCount is the number of fields
+*
+* @return
+*		- XST_SUCCESS if the line is valid
+*		- XST_FAILURE if it is not
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 SdManifestEntry(char **Token, u32 TokenCount)
+{
+	SdManifestFile *File;
+	u32 Index;
+
+	if ((FileCount == SD_MANIFEST_MAX_FILES) || (TokenCount < 3) ||
+			(strlen(Token[0]) >= sizeof(File->Name))) {
+		return XST_FAILURE;
+	}
+
+	File = &Files[FileCount];
+	memset(File, 0, sizeof(*File));
+	strcpy(File->Name, Token[0]);
+
+	/*
+	 * The digest is the last field
+	 */
+	TokenCount--;
+	if (SdManifestDigest(Token[TokenCount], File->Digest) != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL,"SD: %s has no valid MD5 digest\r\n",
+				File->Name);
+		return XST_FAILURE;
+	}
+
+	if ((strcmp(Token[1], "bit") == 0) && (TokenCount == 2)) {
+		/*
+		 * The bitstream is staged where PS files may already be
+		 */
+		for (Index = 0; Index < FileCount; Index++) {
+			if (Files[Index].Type != SD_MANIFEST_TYPE_BIT) {
+				fsbl_printf(DEBUG_GENERAL,"SD: Bitstream %s after "
+						"a PS file\r\n", File->Name);
+				return XST_FAILURE;
+			}
+		}
+		File->Type = SD_MANIFEST_TYPE_BIT;
+	} else if ((strcmp(Token[1], "elf") == 0) && (TokenCount <= 3)) {
+		File->Type = SD_MANIFEST_TYPE_ELF;
+		if (TokenCount == 3) {
+			if (SdManifestNumber(Token[2], &File->ExecAddr) != XST_SUCCESS) {
+				return XST_FAILURE;
+			}
+			File->ExecFlag = 1;
+		}
+	} else if ((strcmp(Token[1], "bin") == 0) && (TokenCount >= 3)) {
+		File->Type = SD_MANIFEST_TYPE_BIN;
+		if (SdManifestNumber(Token[2], &File->LoadAddr) != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		if (TokenCount == 4) {
+			if (SdManifestNumber(Token[3], &File->ExecAddr) != XST_SUCCESS) {
+				return XST_FAILURE;
+			}
+			File->ExecFlag = 1;
+		}
+	} else {
+		return XST_FAILURE;
+	}
+
+	FileCount++;
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function converts a decimal or 0x hex number of the manifest
+*
+* @param	Token is the number
+* @param	ValuePtr receives the value
+*
+* @return
+*		- XST_SUCCESS if the number is valid
+*		- XST_FAILURE if it is not
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 SdManifestNumber(const char *Token, u32 *ValuePtr)
+{
+	u32 Value = 0;
+	u32 Base = 10;
+	u32 Digit;
+
+	if ((Token[0] == '0') && ((Token[1] == 'x') || (Token[1] == 'X'))) {
+		Base = 16;
+		Token += 2;
+	}
+	if (*Token == '\0') {
+		return XST_FAILURE;
+	}
+
+	for (; *Token != '\0'; Token++) {
+		if ((*Token >= '0') && (*Token <= '9')) {
+			Digit = *Token - '0';
+		} else if ((Base == 16) && (*Token >= 'a') && (*Token <= 'f')) {
+			Digit = *Token - 'a' + 10;
+		} else if ((Base == 16) && (*Token >= 'A') && (*Token <= 'F')) {
+			Digit = *Token - 'A' + 10;
+		} else {
+			return XST_FAILURE;
+		}
+
+		if (Value > (0xFFFFFFFF - Digit) / Base) {
+			return XST_FAILURE;
+		}
+		Value = Value * Base + Digit;
+	}
+
+	*ValuePtr = Value;
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function converts the 32 hex digits of an MD5 digest
+*
+* @param	Token is the digest
+* @param	Digest receives the SD_MANIFEST_DIGEST_SIZE bytes
+*
+* @return
+*		- XST_SUCCESS if the digest is valid
+*		- XST_FAILURE if it is not
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 SdManifestDigest(const char *Token, u8 *Digest)
+{
+	u32 Index;
+	u32 Digit;
+
+	if (strlen(Token) != (2 * SD_MANIFEST_DIGEST_SIZE)) {
+		return XST_FAILURE;
+	}
+
+	for (Index = 0; Index < (2 * SD_MANIFEST_DIGEST_SIZE); Index++) {
+		if ((Token[Index] >= '0') && (Token[Index] <= '9')) {
+			Digit = Token[Index] - '0';
+		} else if ((Token[Index] >= 'a') && (Token[Index] <= 'f')) {
+			Digit = Token[Index] - 'a' + 10;
+		} else if ((Token[Index] >= 'A') && (Token[Index] <= 'F')) {
+			Digit = Token[Index] - 'A' + 10;
+		} else {
+			return XST_FAILURE;
+		}
+
+		if ((Index & 1) == 0) {
+			Digest[Index / 2] = Digit << 4;
+		} else {
+			Digest[Index / 2] |= Digit;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function follows the cluster chain of a file and records it as runs
+* of contiguous sectors
+*
+* @param	File is the manifest file
+*
+* @return
+*		- XST_SUCCESS if the file is indexed
+*		- XST_FAILURE if it is missing, empty, broken or has more runs
+*		than are left
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 SdManifestIndex(SdManifestFile *File)
+{
+	FIL Fil;
+	FRESULT rc;
+	SdManifestExtent *Extent = NULL;
+	DWORD Cluster;
+	u32 Sector;
+	u32 Clusters;
+	u32 ClusterSize;
+
+	rc = f_open(&Fil, File->Name, FA_READ);
+	if (rc != FR_OK) {
+		fsbl_printf(DEBUG_GENERAL,"SD: Unable to open file %s: %d\r\n",
+				File->Name, rc);
+		return XST_FAILURE;
+	}
+	File->Size = Fil.fsize;
+	Cluster = Fil.org_clust;
+	f_close(&Fil);
+
+	if (File->Size == 0) {
+		fsbl_printf(DEBUG_GENERAL,"SD: %s is empty\r\n", File->Name);
+		return XST_FAILURE;
+	}
+
+	ClusterSize = Fs->csize * SD_MANIFEST_SECTOR_SIZE;
+	Clusters = (File->Size / ClusterSize) +
+			((File->Size % ClusterSize) ? 1 : 0);
+
+	File->FirstExtent = ExtentCount;
+	File->ExtentCount = 0;
+
+	while (Clusters > 0) {
+		/*
+		 * Also catches the end of the chain and FAT read errors
+		 */
+		Sector = clust2sect(Fs, Cluster);
+		if (Sector == 0) {
+			fsbl_printf(DEBUG_GENERAL,"SD: %s has a broken cluster "
+					"chain\r\n", File->Name);
+			return XST_FAILURE;
+		}
+
+		if ((Extent != NULL) && (Extent->Sector + Extent->Count == Sector)) {
+			Extent->Count += Fs->csize;
+		} else {
+			if (ExtentCount == SD_MANIFEST_MAX_EXTENTS) {
+				fsbl_printf(DEBUG_GENERAL,"SD: %s is too fragmented\r\n",
+						File->Name);
+				return XST_FAILURE;
+			}
+			Extent = &Extents[ExtentCount++];
+			Extent->Sector = Sector;
+			Extent->Count = Fs->csize;
+			File->ExtentCount++;
+		}
+
+		if (--Clusters > 0) {
+			Cluster = get_fat(Fs, Cluster);
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function reads a range of a manifest file through its sector runs.
+* Bytes behind the digest position are added to the digest, the bytes
+* skipped up to Offset are read for it first.
+*
+* @param	File is the manifest file
+* @param	Offset is the offset in the file
+* @param	Dest is the destination address
+* @param	Length is the number of bytes to read
+*
+* @return
+*		- XST_SUCCESS if the range is read
+*		- XST_FAILURE if it is outside of the file or a read fails
+*
+* @note		Whole sectors to a word aligned destination are read
+*		directly, up to SD_MANIFEST_BURST at a time.
+*
+****************************************************************************/
+static u32 SdManifestRead(SdManifestFile *File, u32 Offset, u8 *Dest,
+		u32 Length)
+{
+	u8 *Start = Dest;
+	SdManifestExtent *Extent = &Extents[File->FirstExtent];
+	u32 Skip = Offset / SD_MANIFEST_SECTOR_SIZE;
+	u32 Head = Offset % SD_MANIFEST_SECTOR_SIZE;
+	u32 Sector;
+	u32 Count;
+	u32 Burst;
+	u32 Bytes;
+
+	if ((Offset > File->Size) || (Length > File->Size - Offset)) {
+		fsbl_printf(DEBUG_GENERAL,"SD: Read beyond the end of %s\r\n",
+				File->Name);
+		return XST_FAILURE;
+	}
+	if (Length == 0) {
+		return XST_SUCCESS;
+	}
+
+	if ((HashOffset < Offset) &&
+			(SdManifestHash(File, Offset) != XST_SUCCESS)) {
+		return XST_FAILURE;
+	}
+
+	/*
+	 * Run holding the first sector
+	 */
+	while (Skip >= Extent->Count) {
+		Skip -= Extent->Count;
+		Extent++;
+	}
+	Sector = Extent->Sector + Skip;
+	Count = Extent->Count - Skip;
+
+	while (Length > 0) {
+		if ((Head != 0) || (Length < SD_MANIFEST_SECTOR_SIZE) ||
+				(((u32)Dest & 0x3) != 0)) {
+			/*
+			 * Partial sector or unaligned destination
+			 */
+			if (disk_read(Fs->drv, SdSector, Sector, 1) != RES_OK) {
+				fsbl_printf(DEBUG_GENERAL,"SD: Sector %d read failed\r\n",
+						Sector);
+				return XST_FAILURE;
+			}
+			Bytes = SD_MANIFEST_SECTOR_SIZE - Head;
+			if (Bytes > Length) {
+				Bytes = Length;
+			}
+			memmove(Dest, &SdSector[Head], Bytes);
+			Head = 0;
+			Burst = 1;
+		} else {
+			Burst = Length / SD_MANIFEST_SECTOR_SIZE;
+			if (Burst > Count) {
+				Burst = Count;
+			}
+			if (Burst > SD_MANIFEST_BURST) {
+				Burst = SD_MANIFEST_BURST;
+			}
+			if (disk_read(Fs->drv, Dest, Sector, (BYTE)Burst) != RES_OK) {
+				fsbl_printf(DEBUG_GENERAL,"SD: Sectors %d-%d read failed\r\n",
+						Sector, Sector + Burst - 1);
+				return XST_FAILURE;
+			}
+			Bytes = Burst * SD_MANIFEST_SECTOR_SIZE;
+		}
+
+		Dest += Bytes;
+		Length -= Bytes;
+		Sector += Burst;
+		Count -= Burst;
+
+		if ((Count == 0) && (Length > 0)) {
+			Extent++;
+			Sector = Extent->Sector;
+			Count = Extent->Count;
+		}
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+		/*
+		 * Prevent WDT reset
+		 */
+		XWdtPs_RestartWdt(&Watchdog);
+#endif
+	}
+
+	/*
+	 * Digest of the new bytes, before they are modified by the caller
+	 */
+	Length = Dest - Start;
+	if ((Offset <= HashOffset) && (Offset + Length > HashOffset)) {
+		MD5Update(&HashContext, Start + (HashOffset - Offset),
+				Offset + Length - HashOffset, 0);
+		HashOffset = Offset + Length;
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function adds the bytes of a manifest file up to End to the digest.
+* They are read sector by sector through the sector buffer.
+*
+* @param	File is the manifest file
+* @param	End is the offset in the file to hash up to
+*
+* @return
+*		- XST_SUCCESS if the bytes are hashed
+*		- XST_FAILURE if a read fails
+*
+* @note		The sector buffer may be both source and destination of
+*		SdManifestRead, its partial sector copy is a memmove.
+*
+****************************************************************************/
+static u32 SdManifestHash(SdManifestFile *File, u32 End)
+{
+	u32 Bytes;
+
+	while (HashOffset < End) {
+		Bytes = SD_MANIFEST_SECTOR_SIZE -
+				(HashOffset % SD_MANIFEST_SECTOR_SIZE);
+		if (Bytes > End - HashOffset) {
+			Bytes = End - HashOffset;
+		}
+		if (SdManifestRead(File, HashOffset, SdSector, Bytes) !=
+				XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function completes the digest of a manifest file and compares it to
+* the one of the manifest
+*
+* @param	File is the manifest file
+*
+* @return
+*		- XST_SUCCESS if the digests match
+*		- XST_FAILURE if they do not or a read fails
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 SdManifestVerify(SdManifestFile *File)
+{
+	u8 Digest[SD_MANIFEST_DIGEST_SIZE];
+
+	if (SdManifestHash(File, File->Size) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	MD5Final(&HashContext, Digest, 0);
+
+	if (memcmp(Digest, File->Digest, SD_MANIFEST_DIGEST_SIZE) != 0) {
+		fsbl_printf(DEBUG_GENERAL,"SD: %s MD5 digest mismatch\r\n",
+				File->Name);
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function checks that a PS file goes to DDR
+*
+* @param	Address is the load address
+* @param	Length is the number of bytes
+*
+* @return
+*		- XST_SUCCESS if the range is in DDR
+*		- XST_FAILURE if it is not
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 SdManifestCheckRange(u32 Address, u32 Length)
+{
+	if ((Address < DDR_START_ADDR) || (Address > DDR_END_ADDR) ||
+			(Length > DDR_END_ADDR - Address + 1)) {
+		fsbl_printf(DEBUG_GENERAL,"INVALID_LOAD_ADDRESS 0x%08x\r\n", Address);
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function reads a bitstream to DDR_TEMP_START_ADDR in PCAP byte
+* order. The header of a .bit file is skipped and its words are swapped,
+* the order is told by the sync word.
+*
+* @param	File is the manifest file
+* @param	WordCountPtr receives the bitstream length in words
+*
+* @return
+*		- XST_SUCCESS if the bitstream is in DDR
+*		- XST_FAILURE if the file is no bitstream or can not be read
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 SdManifestLoadBitstream(SdManifestFile *File, u32 *WordCountPtr)
+{
+	u8 *Staging = (u8 *)DDR_TEMP_START_ADDR;
+	u32 *Word = (u32 *)DDR_TEMP_START_ADDR;
+	u8 *Data;
+	u32 Offset = 0;
+	u32 Length = File->Size;
+	u32 Pos;
+	u32 Index;
+	u8 Swap = 0;
+	u8 SyncFlag = 0;
+
+	if (disk_read(Fs->drv, SdSector, Extents[File->FirstExtent].Sector, 1) !=
+			RES_OK) {
+		return XST_FAILURE;
+	}
+
+	/*
+	 * .bit file, the bitstream is the 'e' field after the preamble and
+	 * the 'a' to 'd' text fields
+	 */
+	if ((File->Size > BIT_PREAMBLE_SIZE) && (SdSector[0] == 0x00) &&
+			(SdSector[1] == 0x09) && (SdSector[11] == 0x00) &&
+			(SdSector[12] == 0x01)) {
+		Length = 0;
+		Pos = BIT_PREAMBLE_SIZE;
+		while (Pos + 5 <= SD_MANIFEST_SECTOR_SIZE) {
+			if (SdSector[Pos] == BIT_DATA_KEY) {
+				Length = SD_BE32(&SdSector[Pos + 1]);
+				Offset = Pos + 5;
+				break;
+			}
+			if ((SdSector[Pos] < 'a') || (SdSector[Pos] > 'd')) {
+				break;
+			}
+			Pos += 3 + ((SdSector[Pos + 1] << 8) | SdSector[Pos + 2]);
+		}
+		if ((Length == 0) || (Offset > File->Size) ||
+				(Length > File->Size - Offset)) {
+			fsbl_printf(DEBUG_GENERAL,"SD: %s has an invalid .bit header\r\n",
+					File->Name);
+			return XST_FAILURE;
+		}
+	}
+
+	if (((Length & 0x3) != 0) ||
+			(SdManifestCheckRange(DDR_TEMP_START_ADDR, Offset + Length) !=
+					XST_SUCCESS)) {
+		return XST_FAILURE;
+	}
+
+	/*
+	 * Whole sectors from the start of the file, the bitstream follows
+	 * the header
+	 */
+	if (SdManifestRead(File, 0, Staging, Offset + Length) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	Data = Staging + Offset;
+
+	for (Index = 0; (Index < BIT_SYNC_SEARCH * 4) && (Index + 4 <= Length);
+			Index += 4) {
+		if (SD_BE32(&Data[Index]) == 0xAA995566) {
+			Swap = 1;
+			SyncFlag = 1;
+			break;
+		}
+		if (SD_LE32(&Data[Index]) == 0xAA995566) {
+			SyncFlag = 1;
+			break;
+		}
+	}
+	if (!SyncFlag) {
+		fsbl_printf(DEBUG_GENERAL,"SD: %s has no sync word\r\n", File->Name);
+		return XST_FAILURE;
+	}
+
+	/*
+	 * Move to the start of the staging area in PCAP order, each word is
+	 * read before it is overwritten
+	 */
+	if (Swap || (Offset != 0)) {
+		for (Index = 0; Index < Length / 4; Index++) {
+			Word[Index] = Swap ? SD_BE32(&Data[Index * 4]) :
+					SD_LE32(&Data[Index * 4]);
+		}
+	}
+
+	*WordCountPtr = Length / 4;
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function loads the PT_LOAD segments of an ELF file to their physical
+* addresses and clears the rest of each segment
+*
+* @param	File is the manifest file
+* @param	EntryPtr receives the entry address
+*
+* @return
+*		- XST_SUCCESS if the segments are loaded
+*		- XST_FAILURE if the file is no ARM ELF32 file, a segment is not
+*		in DDR or a read fails
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 SdManifestLoadElf(SdManifestFile *File, u32 *EntryPtr)
+{
+	u8 Header[ELF_HEADER_SIZE];
+	u8 Program[ELF_PH_SIZE];
+	u32 PhOffset;
+	u32 PhEntrySize;
+	u32 PhCount;
+	u32 SegOffset;
+	u32 SegAddr;
+	u32 FileSize;
+	u32 MemSize;
+	u32 Index;
+
+	if (SdManifestRead(File, 0, Header, ELF_HEADER_SIZE) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	/*
+	 * 32-bit little endian ARM
+	 */
+	if ((Header[0] != 0x7F) || (Header[1] != 'E') || (Header[2] != 'L') ||
+			(Header[3] != 'F') || (Header[4] != 1) || (Header[5] != 1) ||
+			(SD_LE16(&Header[ELF_MACHINE_OFFSET]) != ELF_MACHINE_ARM)) {
+		fsbl_printf(DEBUG_GENERAL,"SD: %s is no ARM ELF file\r\n",
+				File->Name);
+		return XST_FAILURE;
+	}
+
+	PhOffset = SD_LE32(&Header[ELF_PHOFF_OFFSET]);
+	PhEntrySize = SD_LE16(&Header[ELF_PHENTSIZE_OFFSET]);
+	PhCount = SD_LE16(&Header[ELF_PHNUM_OFFSET]);
+	if (PhEntrySize < ELF_PH_SIZE) {
+		return XST_FAILURE;
+	}
+
+	for (Index = 0; Index < PhCount; Index++) {
+		if (SdManifestRead(File, PhOffset + (Index * PhEntrySize), Program,
+				ELF_PH_SIZE) != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		MemSize = SD_LE32(&Program[ELF_PH_MEMSZ_OFFSET]);
+		if ((SD_LE32(&Program[ELF_PH_TYPE_OFFSET]) != ELF_PT_LOAD) ||
+				(MemSize == 0)) {
+			continue;
+		}
+		SegOffset = SD_LE32(&Program[ELF_PH_OFFSET_OFFSET]);
+		SegAddr = SD_LE32(&Program[ELF_PH_PADDR_OFFSET]);
+		FileSize = SD_LE32(&Program[ELF_PH_FILESZ_OFFSET]);
+
+		fsbl_printf(DEBUG_INFO,"SD: Segment 0x%08x %d bytes\r\n", SegAddr,
+				MemSize);
+
+		if ((FileSize > MemSize) ||
+				(SdManifestCheckRange(SegAddr, MemSize) != XST_SUCCESS)) {
+			return XST_FAILURE;
+		}
+
+		if (SdManifestRead(File, SegOffset, (u8 *)SegAddr, FileSize) !=
+				XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		memset((u8 *)(SegAddr + FileSize), 0, MemSize - FileSize);
+	}
+
+	*EntryPtr = SD_LE32(&Header[ELF_ENTRY_OFFSET]);
+	return XST_SUCCESS;
+}
+#endif
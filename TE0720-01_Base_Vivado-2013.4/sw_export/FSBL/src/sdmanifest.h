@@ -0,0 +1,135 @@
+/******************************************************************************
+*
+* (c) Copyright 2012-2013 Xilinx, Inc. All rights reserved.
+*
+* This file contains confidential and proprietary information of Xilinx, Inc.
+* and is protected under U.S. and international copyright and other
+* intellectual property laws.
+*
+* DISCLAIMER
+* This disclaimer is not a license and does not grant any rights to the
+* materials distributed herewith. Except as otherwise provided in a valid
+* license issued to you by Xilinx, and to the maximum extent permitted by
+* applicable law: (1) THESE MATERIALS ARE MADE AVAILABLE "AS IS" AND WITH ALL
+* FAULTS, AND XILINX HEREBY DISCLAIMS ALL WARRANTIES AND CONDITIONS, EXPRESS,
+* IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF
+* MERCHANTABILITY, NON-INFRINGEMENT, OR FITNESS FOR ANY PARTICULAR PURPOSE;
+* and (2) Xilinx shall not be liable (whether in contract or tort, including
+* negligence, or under any other theory of liability) for any loss or damage
+* of any kind or nature related to, arising under or in connection with these
+* materials, including for any direct, or any indirect, special, incidental,
+* or consequential loss or damage (including loss of data, profits, goodwill,
+* or any type of loss or damage suffered as a result of any action brought by
+* a third party) even if such damage or loss was reasonably foreseeable or
+* Xilinx had been advised of the possibility of the same.
+*
+* CRITICAL APPLICATIONS
+* Xilinx products are not designed or intended to be fail-safe, or for use in
+* any application requiring fail-safe performance, such as life-support or
+* safety devices or systems, Class III medical devices, nuclear facilities,
+* applications related to the deployment of airbags, or any other applications
+* that could lead to death, personal injury, or severe property or
+* environmental damage (individually and collectively, "Critical
+* Applications"). Customer assumes the sole risk and liability of any use of
+* Xilinx products in Critical Applications, subject only to applicable laws
+* and regulations governing limitations on product liability.
+*
+* THIS COPYRIGHT NOTICE AND DISCLAIMER MUST BE RETAINED AS PART OF THIS FILE
+* AT ALL TIMES.
+*
+*******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file sdmanifest.h
+*
+* This file contains the interface for SD boot from a manifest of
+* partition files
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te	10/16/26 Initial release
+*                   MD5 digest per file
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___SDMANIFEST_H___
+#define ___SDMANIFEST_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+
+/************************** Constant Definitions *****************************/
+/*
+ * Manifest in the root directory of the SD card, 8.3 name
+ */
+#ifndef SD_MANIFEST_FILE
+#define SD_MANIFEST_FILE		"MANIFEST.TXT"
+#endif
+
+#define SD_MANIFEST_MAX_FILES	8
+#ifndef SD_MANIFEST_MAX_EXTENTS
+#define SD_MANIFEST_MAX_EXTENTS	64	/* Contiguous runs of all files */
+#endif
+#define SD_MANIFEST_SECTOR_SIZE	512
+#define SD_MANIFEST_DIGEST_SIZE	16	/* MD5 */
+
+/*
+ * Sectors per disk_read(), one ADMA2 descriptor moves up to 64KB
+ */
+#define SD_MANIFEST_BURST		128
+
+/*
+ * File types of the manifest
+ */
+#define SD_MANIFEST_TYPE_BIT	1	/* Bitstream, .bit or .bin */
+#define SD_MANIFEST_TYPE_ELF	2	/* ELF, loaded by its program headers */
+#define SD_MANIFEST_TYPE_BIN	3	/* Raw data at a load address */
+
+/**************************** Type Definitions *******************************/
+/*
+ * Run of contiguous sectors of a file
+ */
+typedef struct {
+	u32 Sector;				/* First sector */
+	u32 Count;				/* Number of sectors */
+} SdManifestExtent;
+
+/*
+ * File listed in the manifest
+ */
+typedef struct {
+	char Name[13];			/* 8.3 file name */
+	u8 Type;				/* SD_MANIFEST_TYPE_* */
+	u8 ExecFlag;			/* Execution address given */
+	u32 LoadAddr;			/* Load address of a raw file */
+	u32 ExecAddr;			/* Execution address */
+	u32 Size;				/* File size in bytes */
+	u16 FirstExtent;		/* Index of the first run */
+	u16 ExtentCount;		/* Number of runs */
+	u8 Digest[SD_MANIFEST_DIGEST_SIZE];	/* MD5 of the whole file */
+} SdManifestFile;
+
+/************************** Function Prototypes ******************************/
+u32 SdManifestOpen(const char *Name);
+
+u32 SdManifestLoad(void);
+
+/************************** Variable Definitions *****************************/
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___SDMANIFEST_H___ */
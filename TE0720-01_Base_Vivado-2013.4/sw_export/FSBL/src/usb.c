@@ -0,0 +1,880 @@
+/******************************************************************************
+*
+* (c) Copyright 2012-2013 Xilinx, Inc. All rights reserved.
+*
+* This file contains confidential and proprietary information of Xilinx, Inc.
+* and is protected under U.S. and international copyright and other
+* intellectual property laws.
+*
+* DISCLAIMER
+* This disclaimer is not a license and does not grant any rights to the
+* materials distributed herewith. Except as otherwise provided in a valid
+* license issued to you by Xilinx, and to the maximum extent permitted by
+* applicable law: (1) THESE MATERIALS ARE MADE AVAILABLE "AS IS" AND WITH ALL
+* FAULTS, AND XILINX HEREBY DISCLAIMS ALL WARRANTIES AND CONDITIONS, EXPRESS,
+* IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF
+* MERCHANTABILITY, NON-INFRINGEMENT, OR FITNESS FOR ANY PARTICULAR PURPOSE;
+* and (2) Xilinx shall not be liable (whether in contract or tort, including
+* negligence, or under any other theory of liability) for any loss or damage
+* of any kind or nature related to, arising under or in connection with these
+* materials, including for any direct, or any indirect, special, incidental,
+* or consequential loss or damage (including loss of data, profits, goodwill,
+* or any type of loss or damage suffered as a result of any action brought by
+* a third party) even if such damage or loss was reasonably foreseeable or
+* Xilinx had been advised of the possibility of the same.
+*
+* CRITICAL APPLICATIONS
+* Xilinx products are not designed or intended to be fail-safe, or for use in
+* any application requiring fail-safe performance, such as life-support or
+* safety devices or systems, Class III medical devices, nuclear facilities,
+* applications related to the deployment of airbags, or any other applications
+* that could lead to death, personal injury, or severe property or
+* environmental damage (individually and collectively, "Critical
+* Applications"). Customer assumes the sole risk and liability of any use of
+* Xilinx products in Critical Applications, subject only to applicable laws
+* and regulations governing limitations on product liability.
+*
+* THIS COPYRIGHT NOTICE AND DISCLAIMER MUST BE RETAINED AS PART OF THIS FILE
+* AT ALL TIMES.
+*
+*******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file usb.c
+*
+* Contains code for the USB device boot functionality.
+*
+* The board enumerates as a vendor specific bulk device. The host announces
+* the BOOT.BIN length with the USB_REQ_DOWNLOAD vendor request and then
+* writes the image to bulk OUT endpoint 1. The image is consumed as a stream
+* by the regular partition walk. The controller receives into its own
+* buffer pool; long reads that start at the stream position are copied from
+* there to their load address and the MD5 checksum of the data is computed
+* during the copy. Everything else goes through a DDR staging area so that
+* header reads may go backwards.
+*
+* Without a host starting a download within USB_HOST_TIMEOUT_MS the
+* controller is stopped again and the FSBL continues with the JTAG handoff.
+*
+* The controller is polled, no interrupt is used.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te	10/16/26 Initial release
+*
+* </pre>
+*
+* @note
+*	Data copied to a load address is served back from there, reads
+*	going backwards into a partition must be done before the partition
+*	is decrypted in place.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "xparameters.h"
+#include "fsbl.h"
+#ifdef XPAR_PS7_USB_0_BASEADDR
+#include <string.h>
+#include "xstatus.h"
+#include "xusbps.h"
+#include "image_mover.h"
+#include "md5.h"
+#include "usb.h"
+#include "xtime_l.h"
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+#include "xwdtps.h"
+#endif
+
+/************************** Constant Definitions *****************************/
+/*
+ * Chapter 9 request and descriptor codes
+ */
+#define USB_REQ_TYPE_MASK		0x60
+#define USB_REQ_TYPE_STANDARD	0x00
+#define USB_REQ_TYPE_VENDOR		0x40
+
+#define USB_REQ_GET_STATUS_STD	0x00
+#define USB_REQ_SET_ADDRESS		0x05
+#define USB_REQ_GET_DESCRIPTOR	0x06
+#define USB_REQ_GET_CONFIGURATION	0x08
+#define USB_REQ_SET_CONFIGURATION	0x09
+#define USB_REQ_SET_INTERFACE	0x0B
+
+#define USB_DESC_DEVICE			0x01
+#define USB_DESC_CONFIG			0x02
+#define USB_DESC_QUALIFIER		0x06
+
+#define USB_CONFIG_DESC_LEN		25
+
+#define USB_MD5_SIZE			16
+
+/**************************** Type Definitions *******************************/
+/*
+ * Range of the image that was copied directly to its load address
+ */
+typedef struct {
+	u32 Offset;		/* Offset in the image */
+	u32 Length;		/* Length in bytes */
+	u32 Address;	/* Address the range was received to */
+} UsbExtent;
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+static u32 UsbControllerInit(void);
+static void UsbPoll(void);
+static void UsbEp0Handler(void *CallBackRef, u8 EpNum, u8 EventType,
+		void *Data);
+static void UsbIntrHandler(void *CallBackRef, u32 Mask);
+static void UsbHandleSetup(XUsbPs_SetupData *SetupData);
+static void UsbSendReply(const u8 *Data, u32 Length, u16 MaxLength);
+static u32 UsbReceive(u8 *Dest, u32 Length, MD5Context *Context);
+static void UsbCopyReceived(u32 Offset, u32 Dest, u32 Length);
+
+/************************** Variable Definitions *****************************/
+
+extern u32 FlashReadBaseAddress;
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+extern XWdtPs Watchdog;	/* Instance of WatchDog Timer	*/
+#endif
+
+static XUsbPs UsbInstance;
+static XUsbPs_DeviceConfig DeviceConfig;
+
+static volatile u32 UsbState;
+static volatile u32 UsbResetRequest;
+static u32 ImageLength;
+static u32 StreamOffset;
+
+static UsbExtent Extent[MAX_PARTITION_NUMBER];
+static u32 ExtentCount;
+
+static u8 StreamChecksum[USB_MD5_SIZE];
+static u32 ChecksumAddress;
+static u32 ChecksumLength;
+
+static XUsbPs_EpRxBuf RxBuf[USB_RX_NUM_BUFS];
+static u32 RxHandle[USB_RX_NUM_BUFS];
+static u32 RxCount;
+static u32 RxIndex;
+static u32 RxConsumed;
+
+static u8 ReplyBuffer[64] __attribute__ ((aligned(32)));
+
+static const u8 DeviceDesc[] = {
+	18, USB_DESC_DEVICE,
+	0x00, 0x02,						/* bcdUSB 2.0 */
+	0x00, 0x00, 0x00,				/* class defined by interface */
+	64,								/* EP0 max packet */
+	USB_BOOT_VENDOR_ID & 0xFF, USB_BOOT_VENDOR_ID >> 8,
+	USB_BOOT_PRODUCT_ID & 0xFF, USB_BOOT_PRODUCT_ID >> 8,
+	0x00, 0x01,						/* bcdDevice */
+	0, 0, 0,						/* no strings */
+	1								/* one configuration */
+};
+
+static const u8 QualifierDesc[] = {
+	10, USB_DESC_QUALIFIER,
+	0x00, 0x02,
+	0x00, 0x00, 0x00,
+	64,
+	1,
+	0
+};
+
+static const u8 ConfigDesc[USB_CONFIG_DESC_LEN] = {
+	/* Configuration */
+	9, USB_DESC_CONFIG, USB_CONFIG_DESC_LEN, 0, 1, 1, 0, 0xC0, 0,
+	/* Interface, vendor specific */
+	9, 0x04, 0, 0, 1, 0xFF, 0x00, 0x00, 0,
+	/* Bulk OUT endpoint */
+	7, 0x05, USB_BULK_OUT_EP, 0x02,
+	USB_BULK_MAX_PACKET & 0xFF, USB_BULK_MAX_PACKET >> 8, 0
+};
+
+/******************************************************************************/
+/**
+*
+* This function initializes the USB controller in device mode and waits
+* until the host starts a download.
+*
+* @param	None
+*
+* @return
+*		- XST_SUCCESS if a download has been started
+*		- XST_NO_DATA if no host started a download within
+*		  USB_HOST_TIMEOUT_MS, the controller is stopped
+*		- XST_FAILURE if the controller fails to initialize
+*
+* @note		The watchdog is serviced while waiting.
+*
+****************************************************************************/
+u32 InitUsb(void)
+{
+	u32 Status;
+	XTime tStart;
+	XTime tNow;
+
+	UsbState = USB_STATE_IDLE;
+	UsbResetRequest = 0;
+
+	Status = UsbControllerInit();
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	fsbl_printf(DEBUG_GENERAL,"USB: waiting for host\r\n");
+
+	XTime_GetTime(&tStart);
+
+	while (UsbState != USB_STATE_DOWNLOAD) {
+		UsbPoll();
+
+		if (UsbState == USB_STATE_ERROR) {
+			return XST_FAILURE;
+		}
+
+		XTime_GetTime(&tNow);
+		if ((tNow - tStart) >
+				((XTime)USB_HOST_TIMEOUT_MS * COUNTS_PER_SECOND / 1000)) {
+			fsbl_printf(DEBUG_GENERAL,"USB: no host\r\n");
+			XUsbPs_Stop(&UsbInstance);
+			return XST_NO_DATA;
+		}
+	}
+
+	FlashReadBaseAddress = XPAR_PS7_USB_0_BASEADDR;
+
+	fsbl_printf(DEBUG_INFO,"USB: image length 0x%08x\r\n", ImageLength);
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function provides the USB interface for the image mover. The
+* image is a stream, data behind the stream position is served from
+* memory, data in front of it is received from the host.
+*
+* @param	SourceAddress is the offset in the image
+* @param	DestinationAddress is the address to copy to
+* @param	LengthBytes is the number of bytes to move
+*
+* @return
+*		- XST_SUCCESS if the move completes correctly
+*		- XST_FAILURE if the move fails to complete correctly
+*
+* @note		None.
+*
+****************************************************************************/
+u32 UsbAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
+{
+	MD5Context Context;
+	u32 Length;
+	u32 Status;
+
+	if ((UsbState != USB_STATE_DOWNLOAD) ||
+			(SourceAddress > ImageLength) ||
+			(LengthBytes > (ImageLength - SourceAddress))) {
+		fsbl_printf(DEBUG_GENERAL,"USB: invalid read 0x%08x+0x%08x\r\n",
+				SourceAddress, LengthBytes);
+		return XST_FAILURE;
+	}
+
+	/*
+	 * Part already received
+	 */
+	if (SourceAddress < StreamOffset) {
+		Length = StreamOffset - SourceAddress;
+		if (Length > LengthBytes) {
+			Length = LengthBytes;
+		}
+		UsbCopyReceived(SourceAddress, DestinationAddress, Length);
+		SourceAddress += Length;
+		DestinationAddress += Length;
+		LengthBytes -= Length;
+	}
+
+	if (LengthBytes == 0) {
+		return XST_SUCCESS;
+	}
+
+	/*
+	 * Skipped part of the stream goes to the staging area
+	 */
+	if (SourceAddress > StreamOffset) {
+		Status = UsbReceive((u8 *)(USB_STAGING_ADDR + StreamOffset),
+				SourceAddress - StreamOffset, NULL);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+	}
+
+	/*
+	 * Long reads into DDR are copied from the receive buffers to their
+	 * destination and checksummed on the way, short ones go through the
+	 * staging area
+	 */
+	if ((LengthBytes >= USB_DIRECT_MIN_LEN) &&
+			(ExtentCount < MAX_PARTITION_NUMBER) &&
+			(DestinationAddress >= DDR_START_ADDR) &&
+			((DestinationAddress + LengthBytes) <= USB_STAGING_ADDR)) {
+
+		MD5Init(&Context);
+
+		Status = UsbReceive((u8 *)DestinationAddress, LengthBytes, &Context);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		MD5Final(&Context, StreamChecksum, 0);
+		ChecksumAddress = DestinationAddress;
+		ChecksumLength = LengthBytes;
+
+		Extent[ExtentCount].Offset = SourceAddress;
+		Extent[ExtentCount].Length = LengthBytes;
+		Extent[ExtentCount].Address = DestinationAddress;
+		ExtentCount++;
+	} else {
+		Status = UsbReceive((u8 *)(USB_STAGING_ADDR + SourceAddress),
+				LengthBytes, NULL);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		memcpy((void *)DestinationAddress,
+				(void *)(USB_STAGING_ADDR + SourceAddress), LengthBytes);
+	}
+
+	return XST_SUCCESS;
+
+} /* End of UsbAccess */
+
+/******************************************************************************/
+/**
+*
+* This function returns the MD5 checksum computed while the last long read
+* was copied to its destination.
+*
+* @param	Address is the start address of the data
+* @param	Length is the length of the data in bytes
+* @param	Checksum is the buffer the checksum is copied to
+*
+* @return
+*		- XST_SUCCESS if the checksum of this range is known
+*		- XST_FAILURE if the range was not copied directly, the caller has
+*		  to compute the checksum
+*
+* @note		None.
+*
+****************************************************************************/
+u32 UsbGetStreamChecksum(u32 Address, u32 Length, u8 *Checksum)
+{
+	if ((FlashReadBaseAddress != XPAR_PS7_USB_0_BASEADDR) ||
+			(ChecksumLength == 0) ||
+			(Address != ChecksumAddress) ||
+			(Length != ChecksumLength)) {
+		return XST_FAILURE;
+	}
+
+	memcpy(Checksum, StreamChecksum, USB_MD5_SIZE);
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function stops the USB controller before handoff
+*
+* @param	None
+*
+* @return	None.
+*
+* @note		None.
+*
+****************************************************************************/
+void ReleaseUsb(void)
+{
+	XUsbPs_Stop(&UsbInstance);
+	UsbState = USB_STATE_IDLE;
+
+	return;
+}
+
+/******************************************************************************/
+/**
+*
+* This function resets and configures the controller for one control and
+* one bulk OUT endpoint and connects to the bus.
+*
+* @param	None
+*
+* @return
+*		- XST_SUCCESS if the controller is running
+*		- XST_FAILURE if the controller fails to initialize
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 UsbControllerInit(void)
+{
+	XUsbPs_Config *ConfigPtr;
+	u32 Status;
+
+	ConfigPtr = XUsbPs_LookupConfig(XPAR_XUSBPS_0_DEVICE_ID);
+	if (ConfigPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	Status = XUsbPs_CfgInitialize(&UsbInstance, ConfigPtr,
+			ConfigPtr->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL,"USB: CfgInitialize failed\r\n");
+		return XST_FAILURE;
+	}
+
+	memset(&DeviceConfig, 0, sizeof(DeviceConfig));
+
+	DeviceConfig.NumEndpoints = 2;
+
+	DeviceConfig.EpCfg[0].Out.Type = XUSBPS_EP_TYPE_CONTROL;
+	DeviceConfig.EpCfg[0].Out.NumBufs = 2;
+	DeviceConfig.EpCfg[0].Out.BufSize = 64;
+	DeviceConfig.EpCfg[0].Out.MaxPacketSize = 64;
+	DeviceConfig.EpCfg[0].In.Type = XUSBPS_EP_TYPE_CONTROL;
+	DeviceConfig.EpCfg[0].In.NumBufs = 2;
+	DeviceConfig.EpCfg[0].In.MaxPacketSize = 64;
+
+	DeviceConfig.EpCfg[USB_BULK_OUT_EP].Out.Type = XUSBPS_EP_TYPE_BULK;
+	DeviceConfig.EpCfg[USB_BULK_OUT_EP].Out.NumBufs = USB_RX_NUM_BUFS;
+	DeviceConfig.EpCfg[USB_BULK_OUT_EP].Out.BufSize = USB_RX_BUF_SIZE;
+	DeviceConfig.EpCfg[USB_BULK_OUT_EP].Out.MaxPacketSize =
+			USB_BULK_MAX_PACKET;
+	DeviceConfig.EpCfg[USB_BULK_OUT_EP].In.Type = XUSBPS_EP_TYPE_NONE;
+
+	DeviceConfig.DMAMemVirt = USB_DMA_MEM_ADDR;
+	DeviceConfig.DMAMemPhys = USB_DMA_MEM_ADDR;
+
+	Status = XUsbPs_ConfigureDevice(&UsbInstance, &DeviceConfig);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL,"USB: ConfigureDevice failed\r\n");
+		return XST_FAILURE;
+	}
+
+	Status = XUsbPs_IntrSetHandler(&UsbInstance, UsbIntrHandler, NULL,
+			XUSBPS_IXR_UR_MASK);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Status = XUsbPs_EpSetHandler(&UsbInstance, 0, XUSBPS_EP_DIRECTION_OUT,
+			UsbEp0Handler, &UsbInstance);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Status = XUsbPs_EpSetRxBatchMode(&UsbInstance, USB_BULK_OUT_EP, TRUE);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	RxCount = 0;
+	RxIndex = 0;
+	RxConsumed = 0;
+
+	XUsbPs_Start(&UsbInstance);
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function services the controller once. It runs the driver handler
+* on the pending status bits and restarts the controller when a bus reset
+* was handled too late.
+*
+* @param	None
+*
+* @return	None.
+*
+* @note		None.
+*
+****************************************************************************/
+static void UsbPoll(void)
+{
+#ifdef XPAR_XWDTPS_0_BASEADDR
+	/*
+	 * Prevent WDT reset
+	 */
+	XWdtPs_RestartWdt(&Watchdog);
+#endif
+
+	XUsbPs_IntrHandler(&UsbInstance);
+
+	if (UsbResetRequest) {
+		UsbResetRequest = 0;
+		XUsbPs_Stop(&UsbInstance);
+		XUsbPs_Reset(&UsbInstance);
+		if (UsbControllerInit() != XST_SUCCESS) {
+			UsbState = USB_STATE_ERROR;
+		}
+	}
+}
+
+/******************************************************************************/
+/**
+*
+* This function is the general handler of the driver, it is called for
+* every bus reset after the driver flushed the endpoints. A bus reset is
+* part of the normal enumeration and needs no further action. Only when
+* the port reset already ended before the driver got to it (PORTSCR.PR
+* cleared) the controller has to be reset and configured again, which
+* makes the host enumerate the device once more. Any download in progress
+* is lost either way.
+*
+* @param	CallBackRef is unused
+* @param	Mask is the content of the interrupt status register
+*
+* @return	None.
+*
+* @note		None.
+*
+****************************************************************************/
+static void UsbIntrHandler(void *CallBackRef, u32 Mask)
+{
+	if (Mask & XUSBPS_IXR_UR_MASK) {
+		if (UsbState == USB_STATE_DOWNLOAD) {
+			UsbState = USB_STATE_ERROR;
+		}
+
+		if (!(XUsbPs_ReadReg(UsbInstance.Config.BaseAddress,
+				XUSBPS_PORTSCR1_OFFSET) & XUSBPS_PORTSCR_PR_MASK)) {
+			UsbResetRequest = 1;
+		}
+	}
+}
+
+/******************************************************************************/
+/**
+*
+* This function handles the events of the control endpoint.
+*
+* @param	CallBackRef is the driver instance
+* @param	EpNum is the endpoint number
+* @param	EventType is the driver event
+* @param	Data is unused
+*
+* @return	None.
+*
+* @note		None.
+*
+****************************************************************************/
+static void UsbEp0Handler(void *CallBackRef, u8 EpNum, u8 EventType,
+		void *Data)
+{
+	XUsbPs *InstancePtr = (XUsbPs *)CallBackRef;
+	XUsbPs_SetupData SetupData;
+	u8 *BufferPtr;
+	u32 BufferLen;
+	u32 Handle;
+
+	switch (EventType) {
+	case XUSBPS_EP_EVENT_SETUP_DATA_RECEIVED:
+		if (XUsbPs_EpGetSetupData(InstancePtr, EpNum, &SetupData) ==
+				XST_SUCCESS) {
+			UsbHandleSetup(&SetupData);
+		}
+		break;
+
+	case XUSBPS_EP_EVENT_DATA_RX:
+		/*
+		 * Status stage of an IN request, nothing to do with the data
+		 */
+		if (XUsbPs_EpBufferReceive(InstancePtr, EpNum, &BufferPtr,
+				&BufferLen, &Handle) == XST_SUCCESS) {
+			XUsbPs_EpBufferRelease(Handle);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+/******************************************************************************/
+/**
+*
+* This function handles a setup packet: the standard requests needed for
+* enumeration and the two boot vendor requests. Anything else is stalled.
+*
+* @param	SetupData is the received setup packet
+*
+* @return	None.
+*
+* @note		None.
+*
+****************************************************************************/
+static void UsbHandleSetup(XUsbPs_SetupData *SetupData)
+{
+	u32 Reply[2];
+
+	if ((SetupData->bmRequestType & USB_REQ_TYPE_MASK) ==
+			USB_REQ_TYPE_VENDOR) {
+		switch (SetupData->bRequest) {
+		case USB_REQ_DOWNLOAD:
+			ImageLength = ((u32)SetupData->wIndex << 16) |
+					SetupData->wValue;
+			if ((ImageLength == 0) || (ImageLength > USB_STAGING_SIZE)) {
+				break;
+			}
+			StreamOffset = 0;
+			ExtentCount = 0;
+			ChecksumLength = 0;
+			UsbState = USB_STATE_DOWNLOAD;
+			XUsbPs_EpBufferSend(&UsbInstance, 0, NULL, 0);
+			return;
+
+		case USB_REQ_GET_STATUS:
+			Reply[0] = StreamOffset;
+			Reply[1] = UsbState;
+			UsbSendReply((u8 *)Reply, sizeof(Reply), SetupData->wLength);
+			return;
+
+		default:
+			break;
+		}
+	} else if ((SetupData->bmRequestType & USB_REQ_TYPE_MASK) ==
+			USB_REQ_TYPE_STANDARD) {
+		switch (SetupData->bRequest) {
+		case USB_REQ_GET_STATUS_STD:
+			Reply[0] = 0;
+			UsbSendReply((u8 *)Reply, 2, SetupData->wLength);
+			return;
+
+		case USB_REQ_SET_ADDRESS:
+			XUsbPs_SetDeviceAddress(&UsbInstance, SetupData->wValue);
+			XUsbPs_EpBufferSend(&UsbInstance, 0, NULL, 0);
+			return;
+
+		case USB_REQ_GET_DESCRIPTOR:
+			switch (SetupData->wValue >> 8) {
+			case USB_DESC_DEVICE:
+				UsbSendReply(DeviceDesc, sizeof(DeviceDesc),
+						SetupData->wLength);
+				return;
+			case USB_DESC_CONFIG:
+				UsbSendReply(ConfigDesc, sizeof(ConfigDesc),
+						SetupData->wLength);
+				return;
+			case USB_DESC_QUALIFIER:
+				UsbSendReply(QualifierDesc, sizeof(QualifierDesc),
+						SetupData->wLength);
+				return;
+			default:
+				break;
+			}
+			break;
+
+		case USB_REQ_GET_CONFIGURATION:
+			ReplyBuffer[0] = 1;
+			UsbSendReply(ReplyBuffer, 1, SetupData->wLength);
+			return;
+
+		case USB_REQ_SET_CONFIGURATION:
+			/*
+			 * Bulk OUT endpoint, reset data toggle, enable and prime
+			 */
+			XUsbPs_SetBits(&UsbInstance,
+					XUSBPS_EPCRn_OFFSET(USB_BULK_OUT_EP),
+					XUSBPS_EPCR_RXT_BULK_MASK |
+					XUSBPS_EPCR_RXR_MASK);
+			XUsbPs_EpEnable(&UsbInstance, USB_BULK_OUT_EP,
+					XUSBPS_EP_DIRECTION_OUT);
+			XUsbPs_EpPrime(&UsbInstance, USB_BULK_OUT_EP,
+					XUSBPS_EP_DIRECTION_OUT);
+			XUsbPs_EpBufferSend(&UsbInstance, 0, NULL, 0);
+			return;
+
+		case USB_REQ_SET_INTERFACE:
+			XUsbPs_EpBufferSend(&UsbInstance, 0, NULL, 0);
+			return;
+
+		default:
+			break;
+		}
+	}
+
+	XUsbPs_EpStall(&UsbInstance, 0,
+			XUSBPS_EP_DIRECTION_IN | XUSBPS_EP_DIRECTION_OUT);
+}
+
+/******************************************************************************/
+/**
+*
+* This function sends the data stage of a control IN request
+*
+* @param	Data is the reply
+* @param	Length is the length of the reply
+* @param	MaxLength is the length requested by the host
+*
+* @return	None.
+*
+* @note		None.
+*
+****************************************************************************/
+static void UsbSendReply(const u8 *Data, u32 Length, u16 MaxLength)
+{
+	if (Length > MaxLength) {
+		Length = MaxLength;
+	}
+	if (Length > sizeof(ReplyBuffer)) {
+		Length = sizeof(ReplyBuffer);
+	}
+
+	if (Data != ReplyBuffer) {
+		memcpy(ReplyBuffer, Data, Length);
+	}
+
+	XUsbPs_EpBufferSend(&UsbInstance, 0, ReplyBuffer, Length);
+}
+
+/******************************************************************************/
+/**
+*
+* This function receives the next bytes of the image stream. Receive
+* buffers are collected in batches and handed back to the controller once
+* they are consumed.
+*
+* @param	Dest is the address to receive to
+* @param	Length is the number of bytes to receive
+* @param	Context is the MD5 context to update, NULL for none
+*
+* @return
+*		- XST_SUCCESS if the data has been received
+*		- XST_FAILURE if the download has been aborted
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 UsbReceive(u8 *Dest, u32 Length, MD5Context *Context)
+{
+	u32 Chunk;
+	u32 Index;
+	u32 Status;
+
+	while (Length > 0) {
+
+		if (RxIndex == RxCount) {
+			if (RxCount > 0) {
+				for (Index = 0; Index < RxCount; Index++) {
+					RxHandle[Index] = RxBuf[Index].Handle;
+				}
+				XUsbPs_EpBufferReleaseMulti(&UsbInstance, USB_BULK_OUT_EP,
+						RxHandle, RxCount);
+				RxCount = 0;
+				RxIndex = 0;
+			}
+
+			do {
+				UsbPoll();
+				if (UsbState != USB_STATE_DOWNLOAD) {
+					fsbl_printf(DEBUG_GENERAL,"USB: download aborted\r\n");
+					return XST_FAILURE;
+				}
+				Status = XUsbPs_EpBufferReceiveMulti(&UsbInstance,
+						USB_BULK_OUT_EP, RxBuf, USB_RX_NUM_BUFS, &RxCount);
+			} while (Status != XST_SUCCESS);
+
+			RxConsumed = 0;
+		}
+
+		Chunk = RxBuf[RxIndex].Length - RxConsumed;
+		if (Chunk > Length) {
+			Chunk = Length;
+		}
+
+		memcpy(Dest, RxBuf[RxIndex].BufferPtr + RxConsumed, Chunk);
+		if (Context != NULL) {
+			MD5Update(Context, Dest, Chunk, 0);
+		}
+
+		Dest += Chunk;
+		Length -= Chunk;
+		StreamOffset += Chunk;
+		RxConsumed += Chunk;
+
+		if (RxConsumed == RxBuf[RxIndex].Length) {
+			RxIndex++;
+			RxConsumed = 0;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function copies image data behind the stream position, either from
+* the load address it was copied to or from the staging area.
+*
+* @param	Offset is the offset in the image
+* @param	Dest is the address to copy to
+* @param	Length is the number of bytes to copy
+*
+* @return	None.
+*
+* @note		None.
+*
+****************************************************************************/
+static void UsbCopyReceived(u32 Offset, u32 Dest, u32 Length)
+{
+	u32 Chunk;
+	u32 Source;
+	u32 Index;
+	UsbExtent *ExtentPtr;
+
+	while (Length > 0) {
+		Chunk = Length;
+		Source = USB_STAGING_ADDR + Offset;
+
+		for (Index = 0; Index < ExtentCount; Index++) {
+			ExtentPtr = &Extent[Index];
+			if ((Offset >= ExtentPtr->Offset) &&
+					(Offset < (ExtentPtr->Offset + ExtentPtr->Length))) {
+				/*
+				 * Inside a directly copied range
+				 */
+				Source = ExtentPtr->Address + Offset - ExtentPtr->Offset;
+				if (Chunk > (ExtentPtr->Offset + ExtentPtr->Length - Offset)) {
+					Chunk = ExtentPtr->Offset + ExtentPtr->Length - Offset;
+				}
+				break;
+			}
+			if ((ExtentPtr->Offset > Offset) &&
+					(Chunk > (ExtentPtr->Offset - Offset))) {
+				/*
+				 * Staged up to the next directly copied range
+				 */
+				Chunk = ExtentPtr->Offset - Offset;
+			}
+		}
+
+		memcpy((void *)Dest, (void *)Source, Chunk);
+
+		Offset += Chunk;
+		Dest += Chunk;
+		Length -= Chunk;
+	}
+}
+#endif
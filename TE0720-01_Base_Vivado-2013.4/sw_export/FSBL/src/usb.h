@@ -0,0 +1,154 @@
+/******************************************************************************
+*
+* (c) Copyright 2012-2013 Xilinx, Inc. All rights reserved.
+*
+* This file contains confidential and proprietary information of Xilinx, Inc.
+* and is protected under U.S. and international copyright and other
+* intellectual property laws.
+*
+* DISCLAIMER
+* This disclaimer is not a license and does not grant any rights to the
+* materials distributed herewith. Except as otherwise provided in a valid
+* license issued to you by Xilinx, and to the maximum extent permitted by
+* applicable law: (1) THESE MATERIALS ARE MADE AVAILABLE "AS IS" AND WITH ALL
+* FAULTS, AND XILINX HEREBY DISCLAIMS ALL WARRANTIES AND CONDITIONS, EXPRESS,
+* IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF
+* MERCHANTABILITY, NON-INFRINGEMENT, OR FITNESS FOR ANY PARTICULAR PURPOSE;
+* and (2) Xilinx shall not be liable (whether in contract or tort, including
+* negligence, or under any other theory of liability) for any loss or damage
+* of any kind or nature related to, arising under or in connection with these
+* materials, including for any direct, or any indirect, special, incidental,
+* or consequential loss or damage (including loss of data, profits, goodwill,
+* or any type of loss or damage suffered as a result of any action brought by
+* a third party) even if such damage or loss was reasonably foreseeable or
+* Xilinx had been advised of the possibility of the same.
+*
+* CRITICAL APPLICATIONS
+* Xilinx products are not designed or intended to be fail-safe, or for use in
+* any application requiring fail-safe performance, such as life-support or
+* safety devices or systems, Class III medical devices, nuclear facilities,
+* applications related to the deployment of airbags, or any other applications
+* that could lead to death, personal injury, or severe property or
+* environmental damage (individually and collectively, "Critical
+* Applications"). Customer assumes the sole risk and liability of any use of
+* Xilinx products in Critical Applications, subject only to applicable laws
+* and regulations governing limitations on product liability.
+*
+* THIS COPYRIGHT NOTICE AND DISCLAIMER MUST BE RETAINED AS PART OF THIS FILE
+* AT ALL TIMES.
+*
+*******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file usb.h
+*
+* This file contains the interface for the USB device boot functionality
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te	10/16/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___USB_H___
+#define ___USB_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+
+/************************** Constant Definitions *****************************/
+/*
+ * Device identification reported to the host
+ */
+#ifndef USB_BOOT_VENDOR_ID
+#define USB_BOOT_VENDOR_ID		0x03FD	/* Xilinx */
+#endif
+#ifndef USB_BOOT_PRODUCT_ID
+#define USB_BOOT_PRODUCT_ID		0x0050
+#endif
+
+/*
+ * Vendor requests on endpoint 0
+ * USB_REQ_DOWNLOAD: host to device, wValue/wIndex carry the low/high
+ * 16 bits of the BOOT.BIN length, followed by the image on bulk OUT EP1.
+ * USB_REQ_GET_STATUS: device to host, returns the bytes received and
+ * the session state as two little endian words.
+ */
+#define USB_REQ_DOWNLOAD		0x01
+#define USB_REQ_GET_STATUS		0x02
+
+#define USB_BULK_OUT_EP			1
+#define USB_BULK_MAX_PACKET		512
+
+/*
+ * Number and size of the receive buffers of the bulk OUT endpoint
+ */
+#define USB_RX_NUM_BUFS			16
+#define USB_RX_BUF_SIZE			0x4000
+
+/*
+ * Time the FSBL waits in JTAG boot mode for a host to start a download,
+ * the JTAG handoff follows without one
+ */
+#ifndef USB_HOST_TIMEOUT_MS
+#define USB_HOST_TIMEOUT_MS		5000
+#endif
+
+/*
+ * DDR regions used by USB boot, they must not overlap any load address
+ * of the downloaded image
+ * USB_DMA_MEM_ADDR - dQH/dTD and receive buffers of the controller
+ * USB_STAGING_ADDR - image bytes not copied directly to a load address
+ */
+#ifndef USB_DMA_MEM_ADDR
+#define USB_DMA_MEM_ADDR		0x3F000000
+#endif
+#ifndef USB_STAGING_ADDR
+#define USB_STAGING_ADDR		0x30000000
+#endif
+#define USB_STAGING_SIZE		0x0F000000
+
+/*
+ * Reads at least this long that start at the stream position are copied
+ * from the receive buffers to their destination, without the staging area
+ */
+#define USB_DIRECT_MIN_LEN		0x1000
+
+/*
+ * Session states reported by USB_REQ_GET_STATUS
+ */
+#define USB_STATE_IDLE			0
+#define USB_STATE_DOWNLOAD		1
+#define USB_STATE_ERROR			2
+
+/************************** Function Prototypes ******************************/
+#ifdef XPAR_PS7_USB_0_BASEADDR
+u32 InitUsb(void);
+
+u32 UsbAccess( u32 SourceAddress,
+		u32 DestinationAddress,
+		u32 LengthBytes);
+
+u32 UsbGetStreamChecksum(u32 Address, u32 Length, u8 *Checksum);
+
+void ReleaseUsb(void);
+#endif
+/************************** Variable Definitions *****************************/
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___USB_H___ */
@@ -0,0 +1,346 @@
+/******************************************************************************
+*
+* (c) Copyright 2012-2013 Xilinx, Inc. All rights reserved.
+*
+* This file contains confidential and proprietary information of Xilinx, Inc.
+* and is protected under U.S. and international copyright and other
+* intellectual property laws.
+*
+* DISCLAIMER
+* This disclaimer is not a license and does not grant any rights to the
+* materials distributed herewith. Except as otherwise provided in a valid
+* license issued to you by Xilinx, and to the maximum extent permitted by
+* applicable law: (1) THESE MATERIALS ARE MADE AVAILABLE "AS IS" AND WITH ALL
+* FAULTS, AND XILINX HEREBY DISCLAIMS ALL WARRANTIES AND CONDITIONS, EXPRESS,
+* IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF
+* MERCHANTABILITY, NON-INFRINGEMENT, OR FITNESS FOR ANY PARTICULAR PURPOSE;
+* and (2) Xilinx shall not be liable (whether in contract or tort, including
+* negligence, or under any other theory of liability) for any loss or damage
+* of any kind or nature related to, arising under or in connection with these
+* materials, including for any direct, or any indirect, special, incidental,
+* or consequential loss or damage (including loss of data, profits, goodwill,
+* or any type of loss or damage suffered as a result of any action brought by
+* a third party) even if such damage or loss was reasonably foreseeable or
+* Xilinx had been advised of the possibility of the same.
+*
+* CRITICAL APPLICATIONS
+* Xilinx products are not designed or intended to be fail-safe, or for use in
+* any application requiring fail-safe performance, such as life-support or
+* safety devices or systems, Class III medical devices, nuclear facilities,
+* applications related to the deployment of airbags, or any other applications
+* that could lead to death, personal injury, or severe property or
+* environmental damage (individually and collectively, "Critical
+* Applications"). Customer assumes the sole risk and liability of any use of
+* Xilinx products in Critical Applications, subject only to applicable laws
+* and regulations governing limitations on product liability.
+*
+* THIS COPYRIGHT NOTICE AND DISCLAIMER MUST BE RETAINED AS PART OF THIS FILE
+* AT ALL TIMES.
+*
+*******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file warmboot.c
+*
+* Contains the warm boot cache.
+*
+* The cache in DDR at WARM_BOOT_CACHE_ADDR records for every PS partition
+* loaded by the last boot its partition header checksum, the MD5 checksum
+* stored for it in the image and a hash of the bytes it left in DDR. After
+* a reset that keeps the DDR contents, a partition is not read from the boot
+* device again when its header and stored checksum are unchanged and its
+* bytes in DDR still hash to the recorded value.
+*
+* Only partitions with an MD5 checksum in the image are cached, the stored
+* checksum is what tells a rewritten image from the one in DDR. Encrypted,
+* signed and PL partitions are always loaded.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te	10/16/26 Initial release
+*
+* </pre>
+*
+* @note
+*	A partition holding data the application writes to never hashes
+*	to the recorded value and is loaded on every boot.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#ifdef WARM_BOOT_SUPPORT
+#include <string.h>
+#include "xstatus.h"
+#include "image_mover.h"
+#include "warmboot.h"
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+#include "xwdtps.h"
+#endif
+
+/************************** Constant Definitions *****************************/
+#define WARM_BOOT_CHECKSUM_WORDS \
+		((sizeof(WarmBootCache) - sizeof(u32)) / sizeof(u32))
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+static u32 WarmBootChecksum(WarmBootCache *CachePtr);
+static void WarmBootHash(u32 Address, u32 Length, u32 *Digest);
+
+/************************** Variable Definitions *****************************/
+
+extern u32 Silicon_Version;
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+extern XWdtPs Watchdog;	/* Instance of WatchDog Timer	*/
+#endif
+
+static WarmBootCache *Cache = (WarmBootCache *)WARM_BOOT_CACHE_ADDR;
+static u8 WarmBootValid;
+
+/******************************************************************************/
+/**
+*
+* This function opens the warm boot cache at the start of the partition
+* walk. The cache is kept when the last reset retained DDR and it belongs
+* to the image that is booted, else it is cleared. It is marked invalid
+* until WarmBootClose() so that a boot that falls back leaves no cache.
+*
+* @param	ImageStartAddress is the start address of the image
+*
+* @return
+*		- TRUE if partitions may be taken from the cache
+*		- FALSE if all partitions have to be loaded
+*
+* @note		None.
+*
+****************************************************************************/
+u32 WarmBootOpen(u32 ImageStartAddress)
+{
+	u32 ResetReason;
+
+	if (Silicon_Version == SILICON_VERSION_1) {
+		ResetReason = Xil_In32(RESET_REASON_REG);
+	} else {
+		ResetReason = GetResetReason();
+	}
+
+	WarmBootValid = FALSE;
+
+	if (((ResetReason & WARM_BOOT_RESET_MASK) != 0) &&
+			((ResetReason & RESET_REASON_POR) == 0) &&
+			(Cache->Magic == WARM_BOOT_MAGIC) &&
+			(Cache->ImageStartAddress == ImageStartAddress) &&
+			(Cache->Checksum == WarmBootChecksum(Cache))) {
+		fsbl_printf(DEBUG_INFO, "Warm boot cache valid, reset reason 0x%02x\r\n",
+				ResetReason);
+		WarmBootValid = TRUE;
+	} else {
+		memset(Cache, 0, sizeof(WarmBootCache));
+		Cache->ImageStartAddress = ImageStartAddress;
+	}
+
+	Cache->Magic = 0;
+
+	return WarmBootValid;
+}
+
+/******************************************************************************/
+/**
+*
+* This function checks whether a partition loaded by the last boot is
+* still intact in DDR
+*
+* @param	PartitionNum is the partition number
+* @param	Header is the partition header
+* @param	FlashChecksum is the MD5 checksum stored in the image
+*
+* @return
+*		- XST_SUCCESS if the partition does not need to be loaded
+*		- XST_FAILURE if the partition has to be loaded
+*
+* @note		None.
+*
+****************************************************************************/
+u32 WarmBootLookup(u32 PartitionNum, PartHeader *Header, u8 *FlashChecksum)
+{
+	WarmBootEntry *Entry;
+	u32 Digest[2];
+
+	if ((!WarmBootValid) || (PartitionNum >= MAX_PARTITION_NUMBER)) {
+		return XST_FAILURE;
+	}
+
+	Entry = &Cache->Entry[PartitionNum];
+	if ((Entry->Length == 0) ||
+			(Entry->HeaderChecksum != Header->CheckSum) ||
+			(Entry->LoadAddr != Header->LoadAddr) ||
+			(memcmp(Entry->FlashChecksum, FlashChecksum,
+					WARM_BOOT_MD5_SIZE) != 0)) {
+		return XST_FAILURE;
+	}
+
+	WarmBootHash(Entry->LoadAddr, Entry->Length, Digest);
+	if ((Digest[0] != Entry->Digest[0]) || (Digest[1] != Entry->Digest[1])) {
+		fsbl_printf(DEBUG_INFO, "Partition %d changed in DDR\r\n",
+				PartitionNum);
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function records a partition that was loaded and validated
+*
+* @param	PartitionNum is the partition number
+* @param	Header is the partition header
+* @param	FlashChecksum is the MD5 checksum stored in the image
+* @param	Length is the number of bytes loaded to the load address
+*
+* @return	None.
+*
+* @note		None.
+*
+****************************************************************************/
+void WarmBootRecord(u32 PartitionNum, PartHeader *Header, u8 *FlashChecksum,
+		u32 Length)
+{
+	WarmBootEntry *Entry;
+
+	if (PartitionNum >= MAX_PARTITION_NUMBER) {
+		return;
+	}
+
+	Entry = &Cache->Entry[PartitionNum];
+	Entry->HeaderChecksum = Header->CheckSum;
+	memcpy(Entry->FlashChecksum, FlashChecksum, WARM_BOOT_MD5_SIZE);
+	Entry->LoadAddr = Header->LoadAddr;
+	Entry->Length = Length;
+	WarmBootHash(Entry->LoadAddr, Entry->Length, Entry->Digest);
+}
+
+/******************************************************************************/
+/**
+*
+* This function removes a partition that is not cached from the cache
+*
+* @param	PartitionNum is the partition number
+*
+* @return	None.
+*
+* @note		None.
+*
+****************************************************************************/
+void WarmBootDrop(u32 PartitionNum)
+{
+	if (PartitionNum < MAX_PARTITION_NUMBER) {
+		Cache->Entry[PartitionNum].Length = 0;
+	}
+}
+
+/******************************************************************************/
+/**
+*
+* This function marks the cache valid after the last partition was loaded
+*
+* @param	None
+*
+* @return	None.
+*
+* @note		None.
+*
+****************************************************************************/
+void WarmBootClose(void)
+{
+	Cache->Magic = WARM_BOOT_MAGIC;
+	Cache->Checksum = WarmBootChecksum(Cache);
+}
+
+/******************************************************************************/
+/**
+*
+* This function computes the checksum of the cache
+*
+* @param	CachePtr is a pointer to the cache
+*
+* @return	Inverted sum of the cache words
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 WarmBootChecksum(WarmBootCache *CachePtr)
+{
+	u32 *Word = (u32 *)CachePtr;
+	u32 Sum = 0;
+	u32 Index;
+
+	for (Index = 0; Index < WARM_BOOT_CHECKSUM_WORDS; Index++) {
+		Sum += Word[Index];
+	}
+
+	return Sum ^ 0xFFFFFFFF;
+}
+
+/******************************************************************************/
+/**
+*
+* This function hashes a loaded partition. Two word wise multiplicative
+* hashes are run side by side, which is several times faster than MD5 and
+* catches the bit errors a retained DDR may have.
+*
+* @param	Address is the start address, word aligned
+* @param	Length is the length in bytes
+* @param	Digest is filled with the two hash words
+*
+* @return	None.
+*
+* @note		Trailing bytes of a length that is not a word multiple are
+*		not covered, partitions are always whole words.
+*
+****************************************************************************/
+static void WarmBootHash(u32 Address, u32 Length, u32 *Digest)
+{
+	u32 *Word = (u32 *)Address;
+	u32 *End;
+	u32 *ChunkEnd;
+	u32 Hash0 = 0x811C9DC5;
+	u32 Hash1 = Length;
+	u32 Data;
+
+	End = Word + (Length >> WORD_LENGTH_SHIFT);
+
+	while (Word < End) {
+		ChunkEnd = Word + (WARM_BOOT_HASH_CHUNK >> WORD_LENGTH_SHIFT);
+		if ((ChunkEnd > End) || (ChunkEnd < Word)) {
+			ChunkEnd = End;
+		}
+
+		while (Word < ChunkEnd) {
+			Data = *Word++;
+			Hash0 = (Hash0 ^ Data) * 0x01000193;
+			Hash1 = (Hash1 + Data) * 0x9E3779B1;
+		}
+
+#ifdef	XPAR_XWDTPS_0_BASEADDR
+		/*
+		 * Prevent WDT reset
+		 */
+		XWdtPs_RestartWdt(&Watchdog);
+#endif
+	}
+
+	Digest[0] = Hash0;
+	Digest[1] = Hash1;
+}
+#endif
@@ -0,0 +1,133 @@
+/******************************************************************************
+*
+* (c) Copyright 2012-2013 Xilinx, Inc. All rights reserved.
+*
+* This file contains confidential and proprietary information of Xilinx, Inc.
+* and is protected under U.S. and international copyright and other
+* intellectual property laws.
+*
+* DISCLAIMER
+* This disclaimer is not a license and does not grant any rights to the
+* materials distributed herewith. Except as otherwise provided in a valid
+* license issued to you by Xilinx, and to the maximum extent permitted by
+* applicable law: (1) THESE MATERIALS ARE MADE AVAILABLE "AS IS" AND WITH ALL
+* FAULTS, AND XILINX HEREBY DISCLAIMS ALL WARRANTIES AND CONDITIONS, EXPRESS,
+* IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF
+* MERCHANTABILITY, NON-INFRINGEMENT, OR FITNESS FOR ANY PARTICULAR PURPOSE;
+* and (2) Xilinx shall not be liable (whether in contract or tort, including
+* negligence, or under any other theory of liability) for any loss or damage
+* of any kind or nature related to, arising under or in connection with these
+* materials, including for any direct, or any indirect, special, incidental,
+* or consequential loss or damage (including loss of data, profits, goodwill,
+* or any type of loss or damage suffered as a result of any action brought by
+* a third party) even if such damage or loss was reasonably foreseeable or
+* Xilinx had been advised of the possibility of the same.
+*
+* CRITICAL APPLICATIONS
+* Xilinx products are not designed or intended to be fail-safe, or for use in
+* any application requiring fail-safe performance, such as life-support or
+* safety devices or systems, Class III medical devices, nuclear facilities,
+* applications related to the deployment of airbags, or any other applications
+* that could lead to death, personal injury, or severe property or
+* environmental damage (individually and collectively, "Critical
+* Applications"). Customer assumes the sole risk and liability of any use of
+* Xilinx products in Critical Applications, subject only to applicable laws
+* and regulations governing limitations on product liability.
+*
+* THIS COPYRIGHT NOTICE AND DISCLAIMER MUST BE RETAINED AS PART OF THIS FILE
+* AT ALL TIMES.
+*
+*******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file warmboot.h
+*
+* This file contains the interface for the warm boot cache
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te	10/16/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___WARMBOOT_H___
+#define ___WARMBOOT_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#include "image_mover.h"
+
+/************************** Constant Definitions *****************************/
+/*
+ * DDR region holding the cache, the application must leave it alone
+ */
+#ifndef WARM_BOOT_CACHE_ADDR
+#define WARM_BOOT_CACHE_ADDR	0x3FFFF000
+#endif
+
+#define WARM_BOOT_MAGIC			0x4D524157	/* "WARM" */
+#define WARM_BOOT_MD5_SIZE		16
+
+/*
+ * Resets that keep the DDR contents, a power on reset never does
+ */
+#define WARM_BOOT_RESET_MASK	(RESET_REASON_SWDT | RESET_REASON_AWDT0 | \
+								 RESET_REASON_AWDT1 | RESET_REASON_SLC | \
+								 RESET_REASON_SRST)
+
+/*
+ * The DDR image is hashed in chunks of this size, the watchdog is
+ * restarted after each one
+ */
+#define WARM_BOOT_HASH_CHUNK	0x100000
+
+/**************************** Type Definitions *******************************/
+/*
+ * Partition loaded by the previous boot
+ */
+typedef struct {
+	u32 HeaderChecksum;		/* Partition header checksum word */
+	u8 FlashChecksum[WARM_BOOT_MD5_SIZE];	/* MD5 stored in the image */
+	u32 LoadAddr;			/* Address the partition was loaded to */
+	u32 Length;				/* Loaded length in bytes, 0 if unused */
+	u32 Digest[2];			/* Hash of the loaded bytes */
+} WarmBootEntry;
+
+typedef struct {
+	u32 Magic;
+	u32 ImageStartAddress;
+	WarmBootEntry Entry[MAX_PARTITION_NUMBER];
+	u32 Checksum;			/* Inverted sum of the words above */
+} WarmBootCache;
+
+/************************** Function Prototypes ******************************/
+u32 WarmBootOpen(u32 ImageStartAddress);
+
+u32 WarmBootLookup(u32 PartitionNum, PartHeader *Header, u8 *FlashChecksum);
+
+void WarmBootRecord(u32 PartitionNum, PartHeader *Header, u8 *FlashChecksum,
+		u32 Length);
+
+void WarmBootDrop(u32 PartitionNum);
+
+void WarmBootClose(void);
+
+/************************** Variable Definitions *****************************/
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___WARMBOOT_H___ */
@@ -34,6 +34,8 @@ void _system_init( void ) ;
 void _system_clean( void ) ;
 void mcount(unsigned long frompc, unsigned long selfpc);
 void profile_intr_handler( void ) ;
+void profile_lookup_init( void ) ;
+int profile_lookup( unsigned long pc ) ;
 
 
 
@@ -91,6 +93,13 @@ struct gmonparam {
 extern struct gmonparam *_gmonparam;
 extern int n_gmon_sections;
 
+/*
+ * Section lookup table, see profile_lookup_init(). Profiling data with more
+ * sections than PROFILE_MAX_SECTIONS falls back to a linear search.
+ */
+#define PROFILE_MAX_SECTIONS	16
+#define PROFILE_LOOKUP_ENTRIES	256
+
 /*
  * Possible states of profiling.
  */
@@ -0,0 +1,215 @@
+/******************************************************************************
+*
+* (c) Copyright 2010-13 Xilinx, Inc. All rights reserved.
+*
+* This file contains confidential and proprietary information of Xilinx, Inc.
+* and is protected under U.S. and international copyright and other
+* intellectual property laws.
+*
+* DISCLAIMER
+* This disclaimer is not a license and does not grant any rights to the
+* materials distributed herewith. Except as otherwise provided in a valid
+* license issued to you by Xilinx, and to the maximum extent permitted by
+* applicable law: (1) THESE MATERIALS ARE MADE AVAILABLE "AS IS" AND WITH ALL
+* FAULTS, AND XILINX HEREBY DISCLAIMS ALL WARRANTIES AND CONDITIONS, EXPRESS,
+* IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF
+* MERCHANTABILITY, NON-INFRINGEMENT, OR FITNESS FOR ANY PARTICULAR PURPOSE;
+* and (2) Xilinx shall not be liable (whether in contract or tort, including
+* negligence, or under any other theory of liability) for any loss or damage
+* of any kind or nature related to, arising under or in connection with these
+* materials, including for any direct, or any indirect, special, incidental,
+* or consequential loss or damage (including loss of data, profits, goodwill,
+* or any type of loss or damage suffered as a result of any action brought by
+* a third party) even if such damage or loss was reasonably foreseeable or
+* Xilinx had been advised of the possibility of the same.
+*
+* CRITICAL APPLICATIONS
+* Xilinx products are not designed or intended to be fail-safe, or for use in
+* any application requiring fail-safe performance, such as life-support or
+* safety devices or systems, Class III medical devices, nuclear facilities,
+* applications related to the deployment of airbags, or any other applications
+* that could lead to death, personal injury, or severe property or
+* environmental damage (individually and collectively, "Critical
+* Applications"). Customer assumes the sole risk and liability of any use of
+* Xilinx products in Critical Applications, subject only to applicable laws
+* and regulations governing limitations on product liability.
+*
+* THIS COPYRIGHT NOTICE AND DISCLAIMER MUST BE RETAINED AS PART OF THIS FILE
+* AT ALL TIMES.
+*
+******************************************************************************/
+/****************************************************************************/
+/**
+*
+* @file xdevcfg_pr.h
+*
+* This header file contains the partial reconfiguration manager of the XDcfg
+* driver. It swaps modules of reconfigurable regions of the PL at run time
+* through the PCAP.
+*
+* Every module is registered with XDcfgPr_AddModule() with the size of its
+* partial bitstream file. The first request of a module calls the fetch
+* handler to read the file into a cache in DDR. The file is decoded there
+* once, the .bit header is removed and the words are brought into the byte
+* order of the PCAP, so later requests start the DMA straight from the
+* cache. When the cache is full, modules are evicted as decided by the
+* policy, least recently used or greedy dual size, which weighs the time a
+* module took to fetch against the space it takes.
+*
+* XDcfgPr_StartSwap() starts the PCAP DMA and returns, XDcfgPr_Poll() is
+* called until the swap is done, from the main loop or from the XDcfg
+* interrupt handler. A module already loaded in its region is not loaded
+* again. The fetch, load and total time of the last XDCFG_PR_LOG_SIZE swaps
+* are kept in a log. XDcfgPr_Preload() fetches a module while the PCAP
+* loads another one.
+*
+* The manager does not change the PL outside of the PCAP transfer, the
+* user decouples a region before a swap and resets the new module after it.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------
+* 2.04a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+#ifndef XDCFG_PR_H		/* prevent circular inclusions */
+#define XDCFG_PR_H		/* by using protection macros */
+
+/***************************** Include Files *********************************/
+
+#include "xdevcfg.h"
+#include "xtime_l.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************** Constant Definitions *****************************/
+
+#define XDCFG_PR_MAX_MODULES	32	/**< Size of the module table */
+#define XDCFG_PR_MAX_REGIONS	8	/**< Reconfigurable regions */
+#define XDCFG_PR_LOG_SIZE	16	/**< Swaps kept in the log */
+#define XDCFG_PR_ALIGN		32	/**< Cache entry alignment, a cache line */
+
+#define XDCFG_PR_NONE		0xFFFFFFFF /**< No module in a region */
+
+/*
+ * Eviction policies
+ */
+#define XDCFG_PR_POLICY_LRU	0	/**< Least recently used */
+#define XDCFG_PR_POLICY_GDS	1	/**< Greedy dual size, fetch time per
+					  *  byte with aging */
+
+/*
+ * Where the module of a swap came from
+ */
+#define XDCFG_PR_RESIDENT	0	/**< Already loaded, no transfer */
+#define XDCFG_PR_CACHED		1	/**< Loaded from the cache */
+#define XDCFG_PR_FETCHED	2	/**< Fetched into the cache, loaded */
+
+/**************************** Type Definitions *******************************/
+
+/**
+* The fetch handler reads the partial bitstream file of a module, a .bit or
+* a .bin file in either byte order.
+*
+* @param	CallBackRef is the reference passed to
+*		XDcfgPr_SetFetchHandler().
+* @param	Region is the region of the module.
+* @param	Module is the module.
+* @param	BufferPtr is where the file goes.
+* @param	Bytes is the size of the file given to XDcfgPr_AddModule().
+*
+* @return	XST_SUCCESS if the file was read, XST_FAILURE otherwise.
+*/
+typedef int (*XDcfgPr_FetchFunc) (void *CallBackRef, u32 Region, u32 Module,
+				u8 *BufferPtr, u32 Bytes);
+
+/**
+ * A module of a region
+ */
+typedef struct {
+	u32 Region;		/**< Region the module is loaded into */
+	u32 Module;		/**< Module ID */
+	u32 Bytes;		/**< Size of the bitstream file */
+	u32 Addr;		/**< Decoded bitstream in the cache, 0 if
+				  *  not cached */
+	u32 Words;		/**< Length of the decoded bitstream */
+	XTime FetchTicks;	/**< Time of the last fetch and decode */
+	u64 Priority;		/**< Evicted first when lowest */
+} XDcfgPr_Module;
+
+/**
+ * Record of a swap, the times are in XTime ticks
+ */
+typedef struct {
+	u32 Region;		/**< Region swapped */
+	u32 Module;		/**< Module requested */
+	u32 Source;		/**< XDCFG_PR_RESIDENT, _CACHED or _FETCHED */
+	u32 Evicted;		/**< Modules evicted to make room */
+	XTime FetchTicks;	/**< Fetch and decode, 0 unless fetched */
+	XTime LoadTicks;	/**< PCAP transfer */
+	XTime TotalTicks;	/**< Request to done */
+} XDcfgPr_Swap;
+
+/**
+ * The partial reconfiguration manager instance data
+ */
+typedef struct {
+	XDcfg *DcfgPtr;		/**< Initialized devcfg instance */
+	u32 CacheAddr;		/**< Bitstream cache in DDR */
+	u32 CacheSize;		/**< Size of the cache in bytes */
+	u32 Policy;		/**< XDCFG_PR_POLICY_* */
+	XDcfgPr_FetchFunc FetchFunc; /**< Reads a bitstream file */
+	void *FetchRef;		/**< Reference for the fetch handler */
+
+	XDcfgPr_Module Modules[XDCFG_PR_MAX_MODULES]; /**< Module table */
+	u32 NumModules;		/**< Modules registered */
+	u32 Regions;		/**< Number of regions */
+	u32 Resident[XDCFG_PR_MAX_REGIONS]; /**< Module loaded in a region */
+	u64 Age;		/**< Use count (LRU) or inflation (GDS) */
+
+	XDcfgPr_Module *LoadPtr; /**< Module the PCAP loads, NULL if idle */
+	XDcfgPr_Swap Current;	/**< Swap in progress */
+	XTime SwapStart;	/**< Time of the request */
+	XTime LoadStart;	/**< Time the DMA was started */
+
+	XDcfgPr_Swap Log[XDCFG_PR_LOG_SIZE]; /**< Last swaps */
+	u32 Swaps;		/**< Swaps done, resident ones included */
+	u32 Skips;		/**< Swaps of resident modules */
+	u32 Hits;		/**< Loads from the cache */
+	u32 Misses;		/**< Loads that needed a fetch */
+	u32 Evictions;		/**< Modules evicted from the cache */
+	u32 Failures;		/**< Fetches or transfers that failed */
+} XDcfgPr;
+
+/************************** Function Prototypes ******************************/
+
+int XDcfgPr_Initialize(XDcfgPr *PrPtr, XDcfg *DcfgPtr, u32 CacheAddr,
+			u32 CacheSize, u32 Regions);
+
+void XDcfgPr_SetFetchHandler(XDcfgPr *PrPtr, XDcfgPr_FetchFunc FetchFunc,
+				void *CallBackRef);
+
+void XDcfgPr_SetPolicy(XDcfgPr *PrPtr, u32 Policy);
+
+int XDcfgPr_AddModule(XDcfgPr *PrPtr, u32 Region, u32 Module, u32 Bytes);
+
+void XDcfgPr_SetResident(XDcfgPr *PrPtr, u32 Region, u32 Module);
+
+int XDcfgPr_Preload(XDcfgPr *PrPtr, u32 Region, u32 Module);
+
+int XDcfgPr_StartSwap(XDcfgPr *PrPtr, u32 Region, u32 Module);
+
+int XDcfgPr_Poll(XDcfgPr *PrPtr);
+
+const XDcfgPr_Swap *XDcfgPr_GetSwap(XDcfgPr *PrPtr, u32 Back);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* end of protection macro */
@@ -49,6 +49,7 @@
 * Ver   Who  Date     Changes
 * ----- ---- -------- ---------------------------------------------------
 * 1.00a sdm  01/12/12 Initial version
+* 3.11a te   10/16/26 Added Xil_SetTlbAttributesRange
 * </pre>
 *
 * @note
@@ -72,11 +73,16 @@ extern "C" {
 
 /************************** Constant Definitions *****************************/
 
+#define XIL_MMU_SECTION_SIZE		0x100000U	/**< 1MB section */
+#define XIL_MMU_SUPERSECTION_SIZE	0x1000000U	/**< 16MB supersection */
+#define XIL_MMU_SUPERSECTION		0x40000U	/**< Supersection bit */
+
 /************************** Variable Definitions *****************************/
 
 /************************** Function Prototypes ******************************/
 
 void Xil_SetTlbAttributes(u32 addr, u32 attrib);
+void Xil_SetTlbAttributesRange(u32 Addr, u32 Size, u32 Attrib);
 void Xil_EnableMMU(void);
 void Xil_DisableMMU(void);
 
@@ -52,6 +52,7 @@
 * XL2cc_EventCtrInit API can be used to select a set of events and
 * XL2cc_EventCtrStart configures the event counters and starts the counters.
 * XL2cc_EventCtrStop diables the event counters and returns the counter values.
+* XL2cc_EventCtrRead returns the counter values without stopping the counters.
 *
 * <pre>
 * MODIFICATION HISTORY:
@@ -61,6 +62,7 @@
 * 1.00a sdm  07/11/11 First release
 * 3.07a asa  08/30/12 Updated for CR 675636 to provide the L2 Base Address
 *		      inside the APIs
+* 3.11a te   10/16/26 Added XL2cc_EventCtrRead to sample running counters
 * </pre>
 *
 ******************************************************************************/
@@ -109,6 +111,7 @@ extern "C" {
 void XL2cc_EventCtrInit(int Event0, int Event1);
 void XL2cc_EventCtrStart(void);
 void XL2cc_EventCtrStop(u32 *EveCtr0, u32 *EveCtr1);
+void XL2cc_EventCtrRead(u32 *EveCtr0, u32 *EveCtr1);
 
 #ifdef __cplusplus
 }
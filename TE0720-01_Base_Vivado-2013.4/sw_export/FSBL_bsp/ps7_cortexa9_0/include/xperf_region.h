@@ -0,0 +1,134 @@
+/******************************************************************************
+*
+* (c) Copyright 2011-13  Xilinx, Inc. All rights reserved.
+*
+* This file contains confidential and proprietary information of Xilinx, Inc.
+* and is protected under U.S. and international copyright and other
+* intellectual property laws.
+*
+* DISCLAIMER
+* This disclaimer is not a license and does not grant any rights to the
+* materials distributed herewith. Except as otherwise provided in a valid
+* license issued to you by Xilinx, and to the maximum extent permitted by
+* applicable law: (1) THESE MATERIALS ARE MADE AVAILABLE "AS IS" AND WITH ALL
+* FAULTS, AND XILINX HEREBY DISCLAIMS ALL WARRANTIES AND CONDITIONS, EXPRESS,
+* IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF
+* MERCHANTABILITY, NON-INFRINGEMENT, OR FITNESS FOR ANY PARTICULAR PURPOSE;
+* and (2) Xilinx shall not be liable (whether in contract or tort, including
+* negligence, or under any other theory of liability) for any loss or damage
+* of any kind or nature related to, arising under or in connection with these
+* materials, including for any direct, or any indirect, special, incidental,
+* or consequential loss or damage (including loss of data, profits, goodwill,
+* or any type of loss or damage suffered as a result of any action brought by
+* a third party) even if such damage or loss was reasonably foreseeable or
+* Xilinx had been advised of the possibility of the same.
+*
+* CRITICAL APPLICATIONS
+* Xilinx products are not designed or intended to be fail-safe, or for use in
+* any application requiring fail-safe performance, such as life-support or
+* safety devices or systems, Class III medical devices, nuclear facilities,
+* applications related to the deployment of airbags, or any other applications
+* that could lead to death, personal injury, or severe property or
+* environmental damage (individually and collectively, "Critical
+* Applications"). Customer assumes the sole risk and liability of any use of
+* Xilinx products in Critical Applications, subject only to applicable laws
+* and regulations governing limitations on product liability.
+*
+* THIS COPYRIGHT NOTICE AND DISCLAIMER MUST BE RETAINED AS PART OF THIS FILE
+* AT ALL TIMES.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xperf_region.h
+*
+* This header file contains APIs for measuring named code regions with the
+* Cortex-A9 Performance Monitor and the PL310 L2 cache controller event
+* counters.
+*
+* A region is looked up once with XPerf_RegionGet and then bracketed with
+* XPerf_RegionBegin and XPerf_RegionEnd. Regions can be nested up to
+* XPERF_MAX_DEPTH levels, the counts of a region include the counts of the
+* regions nested in it. Each region accumulates the number of calls, the
+* cycles and the events of the active event group.
+*
+* The CPU has 6 and the L2 cache controller 2 event counters, so the events
+* are organized in groups (XPERF_GROUP_*). Counter 0 always counts cycles.
+* The group is selected with XPerf_SelectGroup or advanced round robin with
+* XPerf_NextGroup between repeated runs of the same workload, so all groups
+* are collected over XPERF_NUM_GROUPS runs. XPerf_Report prints the totals
+* of every group and the derived ratios.
+*
+* XPerf uses all PMU event counters and the L2 event counters, it must not
+* be combined with Xpm_SetEvents, XL2cc_EventCtrInit or the PMU profiler.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 3.11a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef XPERF_REGION_H /* prevent circular inclusions */
+#define XPERF_REGION_H /* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xpm_counter.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/************************** Constant Definitions ****************************/
+
+#define XPERF_MAX_REGIONS	32	/**< Size of the region table */
+#define XPERF_MAX_DEPTH		8	/**< Maximum region nesting */
+
+#define XPERF_NUM_PM_CTRS	XPM_CTRCOUNT	/**< PMU counters per group */
+#define XPERF_NUM_L2_CTRS	2		/**< L2 counters per group */
+#define XPERF_NUM_CTRS		(XPERF_NUM_PM_CTRS + XPERF_NUM_L2_CTRS)
+
+/*
+ * Event groups, see XPerfGroups in xperf_region.c for the events.
+ */
+#define XPERF_GROUP_L1		0	/**< L1 cache and L2 data reads */
+#define XPERF_GROUP_STALL	1	/**< Pipeline stalls, L2 data writes */
+#define XPERF_GROUP_TLB		2	/**< TLB and L2 instruction reads */
+#define XPERF_NUM_GROUPS	3
+
+#define XPERF_INVALID_REGION	(-1)
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Accumulated counts of one region
+ */
+typedef struct {
+	const char *Name;			/**< Region name */
+	u32 Calls[XPERF_NUM_GROUPS];		/**< Completed calls per group */
+	u64 Count[XPERF_NUM_GROUPS][XPERF_NUM_CTRS]; /**< Event totals */
+} XPerf_Region;
+
+/************************** Function Prototypes *****************************/
+
+void XPerf_Init(void);
+void XPerf_Reset(void);
+void XPerf_SelectGroup(u32 Group);
+u32 XPerf_NextGroup(void);
+int XPerf_RegionGet(const char *Name);
+void XPerf_RegionBegin(int Id);
+void XPerf_RegionEnd(int Id);
+const XPerf_Region *XPerf_GetRegion(int Id);
+void XPerf_Report(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* XPERF_REGION_H */
@@ -53,6 +53,12 @@
 * Xpm_SetEvents can be used to set the event counters to count a set of events
 * and Xpm_GetEventCounters can be used to read the counter values.
 *
+* For sampling, single counters can be programmed with Xpm_SetCounterEvent and
+* preloaded with Xpm_WriteCounter. A counter raises the PMU interrupt when it
+* overflows if its bit is set with Xpm_EnableOverflowIntr, the overflowed
+* counters are read with Xpm_GetOverflowStatus and acknowledged with
+* Xpm_ClearOverflowStatus. The interrupt of CPU0 is XPS_PMU0_INT_ID.
+*
 * @note
 *
 * This file doesn't handle the Cortex-A9 cycle counter, as the cycle counter is
@@ -64,6 +70,7 @@
 * Ver   Who  Date     Changes
 * ----- ---- -------- -----------------------------------------------
 * 1.00a sdm  07/11/11 First release
+* 3.11a te   10/16/26 Added per counter access and overflow interrupt control
 * </pre>
 *
 ******************************************************************************/
@@ -86,6 +93,9 @@ extern "C" {
 /* Number of performance counters */
 #define XPM_CTRCOUNT 6
 
+/* Mask of all event counters */
+#define XPM_CTRMASK_ALL 0x3F
+
 /* The following constants define the Cortex-A9 Performance Monitor Events */
 
 /*
@@ -573,6 +583,17 @@ extern "C" {
 void Xpm_SetEvents(int PmcrCfg);
 void Xpm_GetEventCounters(u32 *PmCtrValue);
 
+/* Per counter access, Mask has one bit per event counter */
+void Xpm_SetCounterEvent(u32 Counter, u32 Event);
+void Xpm_WriteCounter(u32 Counter, u32 Value);
+u32 Xpm_ReadCounter(u32 Counter);
+void Xpm_StartCounters(u32 Mask);
+void Xpm_StopCounters(u32 Mask);
+void Xpm_EnableOverflowIntr(u32 Mask);
+void Xpm_DisableOverflowIntr(u32 Mask);
+u32 Xpm_GetOverflowStatus(void);
+void Xpm_ClearOverflowStatus(u32 Mask);
+
 #ifdef __cplusplus
 }
 #endif
@@ -147,6 +147,25 @@
  * Data buffers can be aligned at any boundary.
  *
  *
+ * <h3>Streaming</h3>
+ *
+ * For sustained bulk transfers the driver offers list based variants of the
+ * buffer functions. XUsbPs_EpBufferSendMulti() chains any number of buffers
+ * (each of them may be larger than 16 Kbytes) into the descriptor ring and
+ * primes the endpoint once for all of them. Only the last descriptor of such
+ * a batch raises an interrupt. The depth of the descriptor ring is set by the
+ * NumBufs member of the endpoint configuration. Buffers that do not fit into
+ * the ring are held in a queue of XUSBPS_EP_TX_QUEUE_LEN entries and are
+ * chained and primed by the TX complete interrupt as descriptors are freed.
+ *
+ * On the receive side an OUT endpoint can be put into batched mode with
+ * XUsbPs_EpSetRxBatchMode(). The endpoint handler is then called once per
+ * interrupt and the user collects all received buffers with
+ * XUsbPs_EpBufferReceiveMulti(). The buffers are taken directly from the
+ * endpoint's buffer pool and are returned in one go with
+ * XUsbPs_EpBufferReleaseMulti().
+ *
+ *
  * <h3>Zero copy</h3>
  *
  * The driver uses a zero copy mechanism which imposes certain restrictions to
@@ -181,6 +200,10 @@
  *                    handling.
  * 1.04a nm   10/23/12 Fixed CR# 679106.
  *	      11/02/12 Fixed CR# 683931. Mult bits are set properly in dQH.
+ * 1.05a te   10/16/26 Added XUsbPs_EpBufferSendMulti, XUsbPs_EpSetRxBatchMode,
+ *		       XUsbPs_EpBufferReceiveMulti and
+ *		       XUsbPs_EpBufferReleaseMulti for streaming transfers.
+ *		       IN buffers wait in a queue while the ring is full.
  * </pre>
  *
  ******************************************************************************/
@@ -307,6 +330,16 @@ extern "C" {
 #define XUSBPS_MAX_PACKET_SIZE		1024
 				/**< Maximum value can be put into the queue head */
 /* @} */
+
+/*
+ * Number of buffers an IN endpoint holds back while its descriptor ring is
+ * full, see XUsbPs_EpBufferSend()
+ * @{
+ */
+#ifndef XUSBPS_EP_TX_QUEUE_LEN
+#define XUSBPS_EP_TX_QUEUE_LEN		16
+#endif
+/* @} */
 /**************************** Type Definitions *******************************/
 
 /******************************************************************************
@@ -372,6 +405,13 @@ typedef struct {
 		/**< Pointer to the first buffer of the buffer list for this
 		 * endpoint. */
 
+	u32	RxBatch;
+		/**< Buffers are collected with XUsbPs_EpBufferReceiveMulti()
+		 * instead of being reported one by one. */
+	u32	RxOutstanding;
+		/**< Number of buffers handed out in batched mode that have not
+		 * been released yet. */
+
 	XUsbPs_EpHandlerFunc	HandlerFunc;
 		/**< Handler function for this endpoint. */
 	void			*HandlerRef;
@@ -379,6 +419,16 @@ typedef struct {
 } XUsbPs_EpOut;
 
 
+/**
+ * The following data structure represents a buffer that waits for free
+ * descriptors on an IN endpoint.
+ */
+typedef struct {
+	const u8	*BufferPtr;	/**< Buffer to send */
+	u32		BufferLen;	/**< Length of the buffer */
+} XUsbPs_EpTxReq;
+
+
 /**
  * The following data structure represents IN endpoint.
  */
@@ -396,6 +446,13 @@ typedef struct {
 	XUsbPs_dTD	*dTDTail;
 		/**< Buffer to the last unsent descriptor in the list*/
 
+	XUsbPs_EpTxReq	TxQueue[XUSBPS_EP_TX_QUEUE_LEN];
+		/**< Buffers waiting for free descriptors, in order. */
+	u32	TxQueueHead;
+		/**< Index of the oldest waiting buffer. */
+	u32	TxQueueCount;
+		/**< Number of waiting buffers. */
+
 	XUsbPs_EpHandlerFunc	HandlerFunc;
 		/**< Handler function for this endpoint. */
 	void			*HandlerRef;
@@ -436,6 +493,17 @@ typedef struct {
 XUsbPs_SetupData;
 
 
+/**
+ * The following structure describes a buffer handed out by
+ * XUsbPs_EpBufferReceiveMulti().
+ */
+typedef struct {
+	u8  *BufferPtr;		/**< Pointer to the received data */
+	u32 Length;		/**< Number of bytes received */
+	u32 Handle;		/**< Handle to release the buffer with */
+} XUsbPs_EpRxBuf;
+
+
 /**
  * Data structures used to configure endpoints.
  */
@@ -1057,6 +1125,17 @@ int XUsbPs_EpBufferReceive(XUsbPs *InstancePtr, u8 EpNum,
 			u8 **BufferPtr, u32 *BufferLenPtr, u32 *Handle);
 void XUsbPs_EpBufferRelease(u32 Handle);
 
+int XUsbPs_EpBufferSendMulti(XUsbPs *InstancePtr, u8 EpNum,
+			const u8 **BufferList, const u32 *LenList,
+			u32 NumBuffers, u32 *NumQueuedPtr);
+int XUsbPs_EpSetRxBatchMode(XUsbPs *InstancePtr, u8 EpNum, int Enable);
+int XUsbPs_EpBufferReceiveMulti(XUsbPs *InstancePtr, u8 EpNum,
+			XUsbPs_EpRxBuf *BufList, u32 MaxBuffers,
+			u32 *NumReceivedPtr);
+int XUsbPs_EpBufferReleaseMulti(XUsbPs *InstancePtr, u8 EpNum,
+			const u32 *HandleList, u32 NumHandles);
+void XUsbPs_EpInDrainQueue(XUsbPs *InstancePtr, u8 EpNum);
+
 int XUsbPs_EpSetHandler(XUsbPs *InstancePtr, u8 EpNum, u8 Direction,
 			XUsbPs_EpHandlerFunc CallBackFunc,
 			void *CallBackRef);
@@ -55,6 +55,7 @@
  * 1.00a wgr  10/10/10 First release
  * 1.04a nm   10/23/12 Fixed CR# 679106.
  * 1.05a kpc  07/03/13 Added XUsbPs_ResetHw function prototype
+ * 1.05a te   10/16/26 XUSBPS_dTD_BUF_MAX_SIZE is parenthesized.
  * </pre>
  *
  ******************************************************************************/
@@ -470,7 +471,7 @@ extern "C" {
 #define XUSBPS_dTD_BUF_SIZE		4096
 
 /**< Maximum size of one RX/TX buffer. */
-#define XUSBPS_dTD_BUF_MAX_SIZE	16*1024
+#define XUSBPS_dTD_BUF_MAX_SIZE	(16*1024)
 
 /**< Alignment requirement for Transfer Descriptor buffers. */
 #define XUSBPS_dTD_BUF_ALIGN		4096
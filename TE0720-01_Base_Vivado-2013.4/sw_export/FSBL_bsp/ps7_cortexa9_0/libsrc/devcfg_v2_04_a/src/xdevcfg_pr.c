@@ -0,0 +1,774 @@
+/******************************************************************************
+*
+* (c) Copyright 2010-13 Xilinx, Inc. All rights reserved.
+*
+* This file contains confidential and proprietary information of Xilinx, Inc.
+* and is protected under U.S. and international copyright and other
+* intellectual property laws.
+*
+* DISCLAIMER
+* This disclaimer is not a license and does not grant any rights to the
+* materials distributed herewith. Except as otherwise provided in a valid
+* license issued to you by Xilinx, and to the maximum extent permitted by
+* applicable law: (1) THESE MATERIALS ARE MADE AVAILABLE "AS IS" AND WITH ALL
+* FAULTS, AND XILINX HEREBY DISCLAIMS ALL WARRANTIES AND CONDITIONS, EXPRESS,
+* IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF
+* MERCHANTABILITY, NON-INFRINGEMENT, OR FITNESS FOR ANY PARTICULAR PURPOSE;
+* and (2) Xilinx shall not be liable (whether in contract or tort, including
+* negligence, or under any other theory of liability) for any loss or damage
+* of any kind or nature related to, arising under or in connection with these
+* materials, including for any direct, or any indirect, special, incidental,
+* or consequential loss or damage (including loss of data, profits, goodwill,
+* or any type of loss or damage suffered as a result of any action brought by
+* a third party) even if such damage or loss was reasonably foreseeable or
+* Xilinx had been advised of the possibility of the same.
+*
+* CRITICAL APPLICATIONS
+* Xilinx products are not designed or intended to be fail-safe, or for use in
+* any application requiring fail-safe performance, such as life-support or
+* safety devices or systems, Class III medical devices, nuclear facilities,
+* applications related to the deployment of airbags, or any other applications
+* that could lead to death, personal injury, or severe property or
+* environmental damage (individually and collectively, "Critical
+* Applications"). Customer assumes the sole risk and liability of any use of
+* Xilinx products in Critical Applications, subject only to applicable laws
+* and regulations governing limitations on product liability.
+*
+* THIS COPYRIGHT NOTICE AND DISCLAIMER MUST BE RETAINED AS PART OF THIS FILE
+* AT ALL TIMES.
+*
+******************************************************************************/
+/****************************************************************************/
+/**
+*
+* @file xdevcfg_pr.c
+*
+* Contains the partial reconfiguration manager of the XDcfg driver. Refer to
+* the header file xdevcfg_pr.h for more detailed information.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------
+* 2.04a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <string.h>
+#include "xdevcfg_pr.h"
+#include "xil_cache.h"
+
+/************************** Constant Definitions *****************************/
+
+#define XDCFG_PR_SYNC_WORD	0xAA995566 /**< Configuration sync word */
+#define XDCFG_PR_SYNC_SEARCH	64	/**< Words searched for the sync word */
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+#define XDCFG_PR_ROUND(Bytes) \
+	(((Bytes) + XDCFG_PR_ALIGN - 1) & ~(XDCFG_PR_ALIGN - 1))
+
+#define XDCFG_PR_BE16(Ptr)	(((u32)(Ptr)[0] << 8) | (Ptr)[1])
+
+#define XDCFG_PR_BE32(Ptr)	(((u32)(Ptr)[0] << 24) | ((u32)(Ptr)[1] << 16) | \
+				 ((u32)(Ptr)[2] << 8) | (Ptr)[3])
+
+#define XDCFG_PR_LE32(Ptr)	(((u32)(Ptr)[3] << 24) | ((u32)(Ptr)[2] << 16) | \
+				 ((u32)(Ptr)[1] << 8) | (Ptr)[0])
+
+/************************** Function Prototypes ******************************/
+
+static XDcfgPr_Module *XDcfgPr_Lookup(XDcfgPr *PrPtr, u32 Region, u32 Module);
+static void XDcfgPr_Touch(XDcfgPr *PrPtr, XDcfgPr_Module *ModulePtr);
+static XDcfgPr_Module *XDcfgPr_SelectVictim(XDcfgPr *PrPtr,
+				XDcfgPr_Module *KeepPtr);
+static int XDcfgPr_FindSpace(XDcfgPr *PrPtr, u32 Bytes, u32 *AddrPtr);
+static int XDcfgPr_Fetch(XDcfgPr *PrPtr, XDcfgPr_Module *ModulePtr,
+				u32 *EvictedPtr);
+static int XDcfgPr_Decode(u8 *BufferPtr, u32 Bytes, u32 *WordsPtr);
+static void XDcfgPr_Finish(XDcfgPr *PrPtr);
+
+/************************** Variable Definitions *****************************/
+
+/****************************************************************************/
+/**
+*
+* Initialize the partial reconfiguration manager. All regions start without
+* a known module, XDcfgPr_SetResident() sets the modules of the full
+* bitstream.
+*
+* @param	PrPtr is a pointer to the XDcfgPr instance.
+* @param	DcfgPtr is a pointer to the initialized XDcfg instance.
+* @param	CacheAddr is the address of the bitstream cache in DDR,
+*		aligned to XDCFG_PR_ALIGN.
+* @param	CacheSize is the size of the cache in bytes.
+* @param	Regions is the number of reconfigurable regions.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM for too many regions.
+*
+* @note		None.
+*
+*****************************************************************************/
+int XDcfgPr_Initialize(XDcfgPr *PrPtr, XDcfg *DcfgPtr, u32 CacheAddr,
+			u32 CacheSize, u32 Regions)
+{
+	u32 Index;
+
+	Xil_AssertNonvoid(PrPtr != NULL);
+	Xil_AssertNonvoid(DcfgPtr != NULL);
+	Xil_AssertNonvoid(DcfgPtr->IsReady == XIL_COMPONENT_IS_READY);
+	Xil_AssertNonvoid((CacheAddr & (XDCFG_PR_ALIGN - 1)) == 0);
+
+	if ((Regions == 0) || (Regions > XDCFG_PR_MAX_REGIONS)) {
+		return XST_INVALID_PARAM;
+	}
+
+	memset(PrPtr, 0, sizeof(XDcfgPr));
+	PrPtr->DcfgPtr = DcfgPtr;
+	PrPtr->CacheAddr = CacheAddr;
+	PrPtr->CacheSize = CacheSize & ~(XDCFG_PR_ALIGN - 1);
+	PrPtr->Policy = XDCFG_PR_POLICY_GDS;
+	PrPtr->Regions = Regions;
+	for (Index = 0; Index < XDCFG_PR_MAX_REGIONS; Index++) {
+		PrPtr->Resident[Index] = XDCFG_PR_NONE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Set the handler that reads the bitstream files.
+*
+* @param	PrPtr is a pointer to the XDcfgPr instance.
+* @param	FetchFunc is the handler.
+* @param	CallBackRef is passed to the handler.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XDcfgPr_SetFetchHandler(XDcfgPr *PrPtr, XDcfgPr_FetchFunc FetchFunc,
+				void *CallBackRef)
+{
+	Xil_AssertVoid(PrPtr != NULL);
+	Xil_AssertVoid(FetchFunc != NULL);
+
+	PrPtr->FetchFunc = FetchFunc;
+	PrPtr->FetchRef = CallBackRef;
+}
+
+/****************************************************************************/
+/**
+*
+* Select the eviction policy of the cache.
+*
+* @param	PrPtr is a pointer to the XDcfgPr instance.
+* @param	Policy is XDCFG_PR_POLICY_LRU or XDCFG_PR_POLICY_GDS.
+*
+* @return	None.
+*
+* @note		The priorities of the cached modules are kept, they are
+*		recomputed as the modules are used.
+*
+*****************************************************************************/
+void XDcfgPr_SetPolicy(XDcfgPr *PrPtr, u32 Policy)
+{
+	Xil_AssertVoid(PrPtr != NULL);
+	Xil_AssertVoid((Policy == XDCFG_PR_POLICY_LRU) ||
+			(Policy == XDCFG_PR_POLICY_GDS));
+
+	PrPtr->Policy = Policy;
+}
+
+/****************************************************************************/
+/**
+*
+* Register a module of a region.
+*
+* @param	PrPtr is a pointer to the XDcfgPr instance.
+* @param	Region is the region of the module.
+* @param	Module is the module ID, any value but XDCFG_PR_NONE.
+* @param	Bytes is the size of the bitstream file.
+*
+* @return
+*		- XST_SUCCESS if the module was added.
+*		- XST_INVALID_PARAM if the region is out of range, the module
+*		  is known or does not fit into the cache.
+*		- XST_FAILURE if the module table is full.
+*
+* @note		None.
+*
+*****************************************************************************/
+int XDcfgPr_AddModule(XDcfgPr *PrPtr, u32 Region, u32 Module, u32 Bytes)
+{
+	XDcfgPr_Module *ModulePtr;
+
+	Xil_AssertNonvoid(PrPtr != NULL);
+
+	if ((Region >= PrPtr->Regions) || (Module == XDCFG_PR_NONE) ||
+			(Bytes == 0) || (XDCFG_PR_ROUND(Bytes) > PrPtr->CacheSize) ||
+			(XDcfgPr_Lookup(PrPtr, Region, Module) != NULL)) {
+		return XST_INVALID_PARAM;
+	}
+
+	if (PrPtr->NumModules == XDCFG_PR_MAX_MODULES) {
+		return XST_FAILURE;
+	}
+
+	ModulePtr = &PrPtr->Modules[PrPtr->NumModules++];
+	memset(ModulePtr, 0, sizeof(XDcfgPr_Module));
+	ModulePtr->Region = Region;
+	ModulePtr->Module = Module;
+	ModulePtr->Bytes = Bytes;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Set the module loaded in a region by other means, the full bitstream or
+* a swap outside of the manager.
+*
+* @param	PrPtr is a pointer to the XDcfgPr instance.
+* @param	Region is the region.
+* @param	Module is the module in it, XDCFG_PR_NONE if unknown.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XDcfgPr_SetResident(XDcfgPr *PrPtr, u32 Region, u32 Module)
+{
+	Xil_AssertVoid(PrPtr != NULL);
+	Xil_AssertVoid(Region < PrPtr->Regions);
+
+	PrPtr->Resident[Region] = Module;
+}
+
+/****************************************************************************/
+/**
+*
+* Fetch a module into the cache without loading it. This can be called
+* while a swap is in progress, the module being loaded is not evicted.
+*
+* @param	PrPtr is a pointer to the XDcfgPr instance.
+* @param	Region is the region of the module.
+* @param	Module is the module.
+*
+* @return
+*		- XST_SUCCESS if the module is in the cache.
+*		- XST_INVALID_PARAM if the module is not registered.
+*		- XST_FAILURE if the fetch failed.
+*
+* @note		None.
+*
+*****************************************************************************/
+int XDcfgPr_Preload(XDcfgPr *PrPtr, u32 Region, u32 Module)
+{
+	XDcfgPr_Module *ModulePtr;
+	u32 Evicted;
+
+	Xil_AssertNonvoid(PrPtr != NULL);
+
+	ModulePtr = XDcfgPr_Lookup(PrPtr, Region, Module);
+	if (ModulePtr == NULL) {
+		return XST_INVALID_PARAM;
+	}
+
+	if (ModulePtr->Addr == 0) {
+		if (XDcfgPr_Fetch(PrPtr, ModulePtr, &Evicted) != XST_SUCCESS) {
+			PrPtr->Failures++;
+			return XST_FAILURE;
+		}
+		XDcfgPr_Touch(PrPtr, ModulePtr);
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Start loading a module into its region. A module that is not cached is
+* fetched first, the PCAP DMA is started from the cache and the function
+* returns without waiting for it. A module already in its region is not
+* loaded again, the swap is done at once.
+*
+* @param	PrPtr is a pointer to the XDcfgPr instance.
+* @param	Region is the region.
+* @param	Module is the module to load.
+*
+* @return
+*		- XST_SUCCESS if the swap was started or the module is resident.
+*		- XST_DEVICE_BUSY if a swap is in progress.
+*		- XST_INVALID_PARAM if the module is not registered.
+*		- XST_FAILURE if the fetch or the DMA start failed.
+*
+* @note		The region holds no known module until XDcfgPr_Poll()
+*		reports the swap done.
+*
+*****************************************************************************/
+int XDcfgPr_StartSwap(XDcfgPr *PrPtr, u32 Region, u32 Module)
+{
+	XDcfgPr_Module *ModulePtr;
+	u32 Status;
+
+	Xil_AssertNonvoid(PrPtr != NULL);
+
+	if (PrPtr->LoadPtr != NULL) {
+		return XST_DEVICE_BUSY;
+	}
+
+	ModulePtr = XDcfgPr_Lookup(PrPtr, Region, Module);
+	if (ModulePtr == NULL) {
+		return XST_INVALID_PARAM;
+	}
+
+	XTime_GetTime(&PrPtr->SwapStart);
+	memset(&PrPtr->Current, 0, sizeof(XDcfgPr_Swap));
+	PrPtr->Current.Region = Region;
+	PrPtr->Current.Module = Module;
+
+	if (PrPtr->Resident[Region] == Module) {
+		PrPtr->Current.Source = XDCFG_PR_RESIDENT;
+		PrPtr->Skips++;
+		XDcfgPr_Finish(PrPtr);
+		return XST_SUCCESS;
+	}
+
+	if (ModulePtr->Addr == 0) {
+		if (XDcfgPr_Fetch(PrPtr, ModulePtr,
+				&PrPtr->Current.Evicted) != XST_SUCCESS) {
+			PrPtr->Failures++;
+			return XST_FAILURE;
+		}
+		PrPtr->Current.Source = XDCFG_PR_FETCHED;
+		PrPtr->Current.FetchTicks = ModulePtr->FetchTicks;
+		PrPtr->Misses++;
+	} else {
+		PrPtr->Current.Source = XDCFG_PR_CACHED;
+		PrPtr->Hits++;
+	}
+	XDcfgPr_Touch(PrPtr, ModulePtr);
+
+	/*
+	 * The region is undefined from here until the transfer is done
+	 */
+	PrPtr->Resident[Region] = XDCFG_PR_NONE;
+
+	XDcfg_SelectPcapInterface(PrPtr->DcfgPtr);
+	XDcfg_IntrClear(PrPtr->DcfgPtr, XDCFG_IXR_ALL_MASK);
+
+	XTime_GetTime(&PrPtr->LoadStart);
+	Status = XDcfg_Transfer(PrPtr->DcfgPtr,
+			(u8 *)(ModulePtr->Addr | 1), ModulePtr->Words,
+			(u8 *)XDCFG_DMA_INVALID_ADDRESS, 0,
+			XDCFG_NON_SECURE_PCAP_WRITE);
+	if (Status != XST_SUCCESS) {
+		PrPtr->Failures++;
+		return XST_FAILURE;
+	}
+
+	PrPtr->LoadPtr = ModulePtr;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Check the swap in progress without waiting. When the PCAP is done the
+* module becomes resident in its region and the swap is logged.
+*
+* @param	PrPtr is a pointer to the XDcfgPr instance.
+*
+* @return
+*		- XST_SUCCESS if no swap is in progress, it was just finished.
+*		- XST_DEVICE_BUSY if the PCAP is still loading.
+*		- XST_FAILURE if the transfer failed, the region holds no
+*		  known module then.
+*
+* @note		This function can be called from the handler set with
+*		XDcfg_SetHandler() on XDCFG_IXR_D_P_DONE_MASK.
+*
+*****************************************************************************/
+int XDcfgPr_Poll(XDcfgPr *PrPtr)
+{
+	u32 IntrStsReg;
+
+	Xil_AssertNonvoid(PrPtr != NULL);
+
+	if (PrPtr->LoadPtr == NULL) {
+		return XST_SUCCESS;
+	}
+
+	IntrStsReg = XDcfg_IntrGetStatus(PrPtr->DcfgPtr);
+	if (IntrStsReg & XDCFG_IXR_ERROR_FLAGS_MASK) {
+		XDcfg_IntrClear(PrPtr->DcfgPtr, IntrStsReg);
+		PrPtr->LoadPtr = NULL;
+		PrPtr->Failures++;
+		return XST_FAILURE;
+	}
+
+	if ((IntrStsReg & XDCFG_IXR_D_P_DONE_MASK) == 0) {
+		return XST_DEVICE_BUSY;
+	}
+	XDcfg_IntrClear(PrPtr->DcfgPtr,
+			XDCFG_IXR_DMA_DONE_MASK | XDCFG_IXR_D_P_DONE_MASK);
+
+	PrPtr->Resident[PrPtr->LoadPtr->Region] = PrPtr->LoadPtr->Module;
+	PrPtr->LoadPtr = NULL;
+	XDcfgPr_Finish(PrPtr);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Get a swap from the log.
+*
+* @param	PrPtr is a pointer to the XDcfgPr instance.
+* @param	Back is 0 for the last swap, 1 for the one before and so on.
+*
+* @return	The swap, NULL if it is not in the log.
+*
+* @note		None.
+*
+*****************************************************************************/
+const XDcfgPr_Swap *XDcfgPr_GetSwap(XDcfgPr *PrPtr, u32 Back)
+{
+	Xil_AssertNonvoid(PrPtr != NULL);
+
+	if ((Back >= PrPtr->Swaps) || (Back >= XDCFG_PR_LOG_SIZE)) {
+		return NULL;
+	}
+
+	return &PrPtr->Log[(PrPtr->Swaps - 1 - Back) % XDCFG_PR_LOG_SIZE];
+}
+
+/****************************************************************************/
+/**
+*
+* Find a registered module.
+*
+* @param	PrPtr is a pointer to the XDcfgPr instance.
+* @param	Region is the region of the module.
+* @param	Module is the module.
+*
+* @return	The module, NULL if it is not registered.
+*
+* @note		None.
+*
+*****************************************************************************/
+static XDcfgPr_Module *XDcfgPr_Lookup(XDcfgPr *PrPtr, u32 Region, u32 Module)
+{
+	u32 Index;
+
+	for (Index = 0; Index < PrPtr->NumModules; Index++) {
+		if ((PrPtr->Modules[Index].Region == Region) &&
+				(PrPtr->Modules[Index].Module == Module)) {
+			return &PrPtr->Modules[Index];
+		}
+	}
+
+	return NULL;
+}
+
+/****************************************************************************/
+/**
+*
+* Update the priority of a module that is used. With LRU it is the use
+* count. With greedy dual size it is the inflation plus the fetch time per
+* Kbyte, so modules that are slow to fetch for their size stay longer, and
+* the inflation ages the ones not used since.
+*
+* @param	PrPtr is a pointer to the XDcfgPr instance.
+* @param	ModulePtr is the module.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void XDcfgPr_Touch(XDcfgPr *PrPtr, XDcfgPr_Module *ModulePtr)
+{
+	if (PrPtr->Policy == XDCFG_PR_POLICY_LRU) {
+		ModulePtr->Priority = ++PrPtr->Age;
+	} else {
+		ModulePtr->Priority = PrPtr->Age +
+			((u64)ModulePtr->FetchTicks << 10) / ModulePtr->Bytes;
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Select the cached module to evict, the one with the lowest priority.
+*
+* @param	PrPtr is a pointer to the XDcfgPr instance.
+* @param	KeepPtr is a module that must stay, NULL for none.
+*
+* @return	The module, NULL if no cached module can be evicted.
+*
+* @note		The module the PCAP loads is never selected.
+*
+*****************************************************************************/
+static XDcfgPr_Module *XDcfgPr_SelectVictim(XDcfgPr *PrPtr,
+				XDcfgPr_Module *KeepPtr)
+{
+	XDcfgPr_Module *VictimPtr = NULL;
+	XDcfgPr_Module *ModulePtr;
+	u32 Index;
+
+	for (Index = 0; Index < PrPtr->NumModules; Index++) {
+		ModulePtr = &PrPtr->Modules[Index];
+		if ((ModulePtr->Addr == 0) || (ModulePtr == KeepPtr) ||
+				(ModulePtr == PrPtr->LoadPtr)) {
+			continue;
+		}
+		if ((VictimPtr == NULL) ||
+				(ModulePtr->Priority < VictimPtr->Priority)) {
+			VictimPtr = ModulePtr;
+		}
+	}
+
+	return VictimPtr;
+}
+
+/****************************************************************************/
+/**
+*
+* Find the lowest free range of the cache for a module, first fit.
+*
+* @param	PrPtr is a pointer to the XDcfgPr instance.
+* @param	Bytes is the size needed, a multiple of XDCFG_PR_ALIGN.
+* @param	AddrPtr is set to the start of the range.
+*
+* @return	XST_SUCCESS if a range was found, XST_FAILURE otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+static int XDcfgPr_FindSpace(XDcfgPr *PrPtr, u32 Bytes, u32 *AddrPtr)
+{
+	XDcfgPr_Module *ModulePtr;
+	u32 Addr = PrPtr->CacheAddr;
+	u32 End;
+	u32 Index;
+
+	for (Index = 0; Index < PrPtr->NumModules; Index++) {
+		if (Addr + Bytes > PrPtr->CacheAddr + PrPtr->CacheSize) {
+			return XST_FAILURE;
+		}
+
+		/*
+		 * Start over after a cached module in the way
+		 */
+		ModulePtr = &PrPtr->Modules[Index];
+		End = ModulePtr->Addr + XDCFG_PR_ROUND(ModulePtr->Bytes);
+		if ((ModulePtr->Addr != 0) && (ModulePtr->Addr < Addr + Bytes) &&
+				(End > Addr)) {
+			Addr = End;
+			Index = (u32)-1;
+		}
+	}
+
+	if (Addr + Bytes > PrPtr->CacheAddr + PrPtr->CacheSize) {
+		return XST_FAILURE;
+	}
+
+	*AddrPtr = Addr;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Read the bitstream file of a module into the cache and decode it. Other
+* modules are evicted until there is room.
+*
+* @param	PrPtr is a pointer to the XDcfgPr instance.
+* @param	ModulePtr is the module.
+* @param	EvictedPtr is set to the number of modules evicted.
+*
+* @return	XST_SUCCESS if the module is cached, XST_FAILURE otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+static int XDcfgPr_Fetch(XDcfgPr *PrPtr, XDcfgPr_Module *ModulePtr,
+				u32 *EvictedPtr)
+{
+	XDcfgPr_Module *VictimPtr;
+	XTime Start;
+	XTime End;
+	u32 Addr;
+	u32 Words;
+	int Status;
+
+	*EvictedPtr = 0;
+	if (PrPtr->FetchFunc == NULL) {
+		return XST_FAILURE;
+	}
+
+	while (XDcfgPr_FindSpace(PrPtr, XDCFG_PR_ROUND(ModulePtr->Bytes),
+			&Addr) != XST_SUCCESS) {
+		VictimPtr = XDcfgPr_SelectVictim(PrPtr, ModulePtr);
+		if (VictimPtr == NULL) {
+			return XST_FAILURE;
+		}
+		if (PrPtr->Policy == XDCFG_PR_POLICY_GDS) {
+			PrPtr->Age = VictimPtr->Priority;
+		}
+		VictimPtr->Addr = 0;
+		PrPtr->Evictions++;
+		(*EvictedPtr)++;
+	}
+
+	XTime_GetTime(&Start);
+
+	Status = PrPtr->FetchFunc(PrPtr->FetchRef, ModulePtr->Region,
+			ModulePtr->Module, (u8 *)Addr, ModulePtr->Bytes);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Status = XDcfgPr_Decode((u8 *)Addr, ModulePtr->Bytes, &Words);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	Xil_DCacheFlushRange(Addr, Words << 2);
+
+	XTime_GetTime(&End);
+
+	ModulePtr->Addr = Addr;
+	ModulePtr->Words = Words;
+	ModulePtr->FetchTicks = End - Start;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Decode a bitstream file in place into the words the PCAP takes. The header
+* of a .bit file is removed. The byte order is taken from the sync word, the
+* configuration data of .bit and .bin files is big endian, a .bin from
+* bootgen is already swapped.
+*
+* @param	BufferPtr is the file, the decoded words start there.
+* @param	Bytes is the size of the file.
+* @param	WordsPtr is set to the number of decoded words.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if the file is not a bitstream.
+*
+* @note		None.
+*
+*****************************************************************************/
+static int XDcfgPr_Decode(u8 *BufferPtr, u32 Bytes, u32 *WordsPtr)
+{
+	u32 *WordPtr = (u32 *)BufferPtr;
+	u32 Offset = 0;
+	u32 Length = Bytes;
+	u32 Swap = 2;
+	u32 Index;
+	u8 Key = 0;
+
+	/*
+	 * .bit header: a 9 byte field, then the fields 'a' to 'd' with a 16
+	 * bit and field 'e', the configuration data, with a 32 bit length
+	 */
+	if ((Bytes > 13) && (XDCFG_PR_BE16(BufferPtr) == 9) &&
+			(XDCFG_PR_BE16(BufferPtr + 11) == 1)) {
+		Offset = 13;
+		while (Offset + 5 <= Bytes) {
+			Key = BufferPtr[Offset++];
+			if (Key == 'e') {
+				Length = XDCFG_PR_BE32(BufferPtr + Offset);
+				Offset += 4;
+				break;
+			}
+			if ((Key < 'a') || (Key > 'd')) {
+				return XST_FAILURE;
+			}
+			Offset += 2 + XDCFG_PR_BE16(BufferPtr + Offset);
+		}
+		if ((Key != 'e') || (Length > Bytes - Offset)) {
+			return XST_FAILURE;
+		}
+	}
+
+	if ((Length == 0) || (Length & 3)) {
+		return XST_FAILURE;
+	}
+
+	for (Index = 0; (Index < XDCFG_PR_SYNC_SEARCH) && (Index < Length / 4);
+			Index++) {
+		if (XDCFG_PR_BE32(BufferPtr + Offset + Index * 4) ==
+				XDCFG_PR_SYNC_WORD) {
+			Swap = 1;
+			break;
+		}
+		if (XDCFG_PR_LE32(BufferPtr + Offset + Index * 4) ==
+				XDCFG_PR_SYNC_WORD) {
+			Swap = 0;
+			break;
+		}
+	}
+	if (Swap == 2) {
+		return XST_FAILURE;
+	}
+
+	/*
+	 * The words move down by the header, each one is read before it is
+	 * overwritten
+	 */
+	for (Index = 0; Index < Length / 4; Index++) {
+		WordPtr[Index] = Swap ?
+			XDCFG_PR_BE32(BufferPtr + Offset + Index * 4) :
+			XDCFG_PR_LE32(BufferPtr + Offset + Index * 4);
+	}
+
+	*WordsPtr = Length / 4;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Log the swap in progress.
+*
+* @param	PrPtr is a pointer to the XDcfgPr instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void XDcfgPr_Finish(XDcfgPr *PrPtr)
+{
+	XTime Now;
+
+	XTime_GetTime(&Now);
+	if (PrPtr->Current.Source != XDCFG_PR_RESIDENT) {
+		PrPtr->Current.LoadTicks = Now - PrPtr->LoadStart;
+	}
+	PrPtr->Current.TotalTicks = Now - PrPtr->SwapStart;
+
+	PrPtr->Log[PrPtr->Swaps % XDCFG_PR_LOG_SIZE] = PrPtr->Current;
+	PrPtr->Swaps++;
+}
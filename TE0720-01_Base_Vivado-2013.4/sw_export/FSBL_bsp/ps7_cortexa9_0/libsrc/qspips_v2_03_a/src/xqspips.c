@@ -102,6 +102,10 @@
 *                    Added RX threshold reset(1) after transfer in polled and
 *                    interrupt transfers. Made changes to make sure threshold
 *                    change is done only when no transfer is in progress.
+* 2.03a te  10/16/26 XQspiPs_PolledTransfer waits for the RX FIFO to hold
+*                    the words it reads, the RX threshold is lowered for
+*                    the last batch. Waiting for TX FIFO empty instead read
+*                    the last word while it was still on the bus.
 *
 * </pre>
 *
@@ -132,6 +136,7 @@ typedef struct {
 
 /************************** Function Prototypes ******************************/
 static void XQspiPs_GetReadData(XQspiPs *InstancePtr, u32 Data, u8 Size);
+static void XQspiPs_WaitRxData(u32 BaseAddress, s32 RxBytes);
 static void StubStatusHandler(void *CallBackRef, u32 StatusEvent,
 				unsigned ByteCount);
 
@@ -947,19 +952,10 @@ int XQspiPs_PolledTransfer(XQspiPs *InstancePtr, u8 *SendBufPtr,
 		TransCount = 0;
 
 		/*
-		 * Wait for RX FIFO to reach threshold (or)
-		 * TX FIFO to become empty.
-		 * The latter check is required for
-		 * small transfers (<32 words) and
-		 * when the last chunk in a large data transfer is < 32 words.
+		 * Wait for the words read below to be in the RX FIFO
 		 */
-
-		do {
-			StatusReg = XQspiPs_ReadReg(
-					InstancePtr->Config.BaseAddress,
-					XQSPIPS_SR_OFFSET);
-		} while ( ((StatusReg & XQSPIPS_IXR_TXOW_MASK) == 0) &&
-			((StatusReg & XQSPIPS_IXR_RXNEMPTY_MASK) == 0) );
+		XQspiPs_WaitRxData(InstancePtr->Config.BaseAddress,
+				   InstancePtr->RequestedBytes);
 
 		/*
 		 * A transmit has just completed. Process received data
@@ -1556,3 +1552,36 @@ static void XQspiPs_GetReadData(XQspiPs *InstancePtr, u32 Data, u8 Size)
 		InstancePtr->RequestedBytes = 0;
 	}
 }
+
+/*****************************************************************************/
+/**
+*
+* Waits until the RX FIFO holds the next batch of a polled transfer, the RX
+* threshold number of words or all words still to come when that is less.
+* For the last batch the RX threshold is lowered to the words still to come.
+* The TX FIFO running empty is no sign that they are in, the last word is
+* still on the bus then.
+*
+* @param	BaseAddress is the base address of the device.
+* @param	RxBytes is the number of bytes still to be received.
+*
+* @return	None.
+*
+* @note		The RX threshold changes while the last words are on the bus,
+*		polled transfers have no interrupt that could see it. The
+*		transfer functions set it back to one when they are done.
+*
+******************************************************************************/
+static void XQspiPs_WaitRxData(u32 BaseAddress, s32 RxBytes)
+{
+	u32 RxWords = (RxBytes + 3) / 4;
+	u32 StatusReg;
+
+	if (RxWords < XQSPIPS_RXFIFO_THRESHOLD_OPT) {
+		XQspiPs_WriteReg(BaseAddress, XQSPIPS_RXWR_OFFSET, RxWords);
+	}
+
+	do {
+		StatusReg = XQspiPs_ReadReg(BaseAddress, XQSPIPS_SR_OFFSET);
+	} while ((StatusReg & XQSPIPS_IXR_RXNEMPTY_MASK) == 0);
+}
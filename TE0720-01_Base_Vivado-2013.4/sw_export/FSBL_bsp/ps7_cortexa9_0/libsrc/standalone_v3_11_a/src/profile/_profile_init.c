@@ -69,6 +69,8 @@ void _profile_init( void )
 /* 		putnum( _gmonparam[i].kcountsize * sizeof(unsigned short));print("\r\n"); */
 /* 	} */
 
+	profile_lookup_init() ;
+
 #ifdef PROC_MICROBLAZE
 	microblaze_init();
 #elif defined PROC_PPC
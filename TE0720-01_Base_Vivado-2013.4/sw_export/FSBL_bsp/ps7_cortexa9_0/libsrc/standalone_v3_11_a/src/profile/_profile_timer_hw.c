@@ -318,25 +318,44 @@ int cortexa9_init(void)
 	 * interrupt for the device occurs, the handler defined above performs
 	 * the specific interrupt processing for the device.
 	 */
+#ifdef PROFILE_PMU_SAMPLING
+	XScuGic_RegisterHandler(SCUGIC_CPU_BASEADDR,
+				PROFILE_PMU_INTR_ID,
+				(Xil_ExceptionHandler)profile_pmu_intr_handler,
+				(void *)0);
+#else
 	XScuGic_RegisterHandler(SCUGIC_CPU_BASEADDR,
 				PROFILE_TIMER_INTR_ID,
 				(Xil_ExceptionHandler)profile_intr_handler,
 				(void *)0);
+#endif
 
 	/*
 	 * Enable the interrupt for scu timer.
 	 */
+#ifdef PROFILE_PMU_SAMPLING
+	XScuGic_EnableIntr(SCUGIC_DIST_BASEADDR, PROFILE_PMU_INTR_ID);
+#else
 	XScuGic_EnableIntr(SCUGIC_DIST_BASEADDR, PROFILE_TIMER_INTR_ID);
+#endif
 
 	/*
 	 * Enable interrupts in the Processor.
 	 */
 	Xil_ExceptionEnableMask(XIL_EXCEPTION_IRQ);
 
+#ifdef PROFILE_PMU_SAMPLING
+	/*
+	 * Sample on PMU counter overflow instead of the scu timer
+	 */
+	if (profile_pmu_init() != 0)
+		return -1;
+#else
 	/*
 	 * Initialize the timer with Timer Ticks
 	 */
 	scu_timer_init() ;
+#endif
 
 	Xil_ExceptionEnable();
 
@@ -244,6 +244,19 @@ unsigned long timer_lo_clk_ticks ;	// Clk ticks when Timer is disabled in CG
 //--------------------------------------------------------------------
 #ifdef PROC_CORTEXA9
 
+#ifdef PROFILE_PMU_SAMPLING
+#include "profile_pmu.h"
+
+//--------------------------------------------------------------------
+// PMU counters are the sample source, the scu timer is not used
+//
+//--------------------------------------------------------------------
+#define disable_timer()		profile_pmu_stop()
+#define enable_timer()		profile_pmu_start()
+#define timer_ack()
+
+#else
+
 //--------------------------------------------------------------------
 // Disable the Timer during Call-Graph Data collection
 //
@@ -280,6 +293,8 @@ unsigned long timer_lo_clk_ticks ;	// Clk ticks when Timer is disabled in CG
 		XSCUTIMER_ISR_EVENT_FLAG_MASK);\
 }
 
+#endif	// PROFILE_PMU_SAMPLING
+
 //--------------------------------------------------------------------
 #endif	// PROC_CORTEXA9
 //--------------------------------------------------------------------
@@ -28,6 +28,97 @@
 extern int binsize ;
 uint32_t prof_pc ;
 
+// Section lookup: sections sorted by lowpc and, for every chunk of the
+// profiled address range, the first sorted section ending above the chunk
+static unsigned char lookup_order[PROFILE_MAX_SECTIONS] ;
+static unsigned char lookup_tbl[PROFILE_LOOKUP_ENTRIES] ;
+static unsigned long lookup_lowpc ;
+static unsigned long lookup_highpc ;
+static unsigned int lookup_shift ;
+static int lookup_valid = 0 ;
+
+//--------------------------------------------------------------------
+// Build the section lookup table. Must be called once _gmonparam has
+// been set up and before sampling starts.
+//
+//--------------------------------------------------------------------
+void profile_lookup_init( void )
+{
+	int i, j, n ;
+	unsigned char t ;
+	unsigned long chunk ;
+
+	lookup_valid = 0 ;
+	n = n_gmon_sections ;
+	if( (n <= 0) || (n > PROFILE_MAX_SECTIONS) )
+		return ;
+
+	// Sort the sections by start address
+	for( i = 0; i < n; i++ )
+		lookup_order[i] = i ;
+	for( i = 1; i < n; i++ ) {
+		t = lookup_order[i] ;
+		for( j = i; (j > 0) &&
+			(_gmonparam[lookup_order[j-1]].lowpc > _gmonparam[t].lowpc); j-- )
+			lookup_order[j] = lookup_order[j-1] ;
+		lookup_order[j] = t ;
+	}
+
+	lookup_lowpc = _gmonparam[lookup_order[0]].lowpc ;
+	lookup_highpc = 0 ;
+	for( i = 0; i < n; i++ )
+		if( _gmonparam[i].highpc > lookup_highpc )
+			lookup_highpc = _gmonparam[i].highpc ;
+	if( lookup_highpc <= lookup_lowpc )
+		return ;
+
+	lookup_shift = 0 ;
+	while( ((lookup_highpc - lookup_lowpc - 1) >> lookup_shift) >=
+						PROFILE_LOOKUP_ENTRIES )
+		lookup_shift++ ;
+
+	j = 0 ;
+	for( i = 0; i < PROFILE_LOOKUP_ENTRIES; i++ ) {
+		chunk = lookup_lowpc + ((unsigned long)i << lookup_shift) ;
+		while( (j < n) && (_gmonparam[lookup_order[j]].highpc <= chunk) )
+			j++ ;
+		lookup_tbl[i] = j ;
+	}
+
+	lookup_valid = 1 ;
+}
+
+//--------------------------------------------------------------------
+// Return the section containing pc, -1 if pc is not profiled.
+// Sections do not overlap, so at most the sections starting inside
+// the chunk of pc are visited.
+//
+//--------------------------------------------------------------------
+int profile_lookup( unsigned long pc )
+{
+	int j ;
+
+	if( !lookup_valid ) {
+		for( j = 0; j < n_gmon_sections; j++ ) {
+			if( (pc >= _gmonparam[j].lowpc) && (pc < _gmonparam[j].highpc) )
+				return j ;
+		}
+		return -1 ;
+	}
+
+	if( (pc < lookup_lowpc) || (pc >= lookup_highpc) )
+		return -1 ;
+
+	j = lookup_tbl[(pc - lookup_lowpc) >> lookup_shift] ;
+	while( (j < n_gmon_sections) && (pc >= _gmonparam[lookup_order[j]].highpc) )
+		j++ ;
+
+	if( (j < n_gmon_sections) && (pc >= _gmonparam[lookup_order[j]].lowpc) )
+		return lookup_order[j] ;
+
+	return -1 ;
+}
+
 void profile_intr_handler( void )
 {
 
@@ -41,11 +132,9 @@ void profile_intr_handler( void )
 	// for cortexa9, lr is saved in asm interrupt handler
 #endif
 	//print("PC: "); putnum(prof_pc); print("\r\n");
-	for(j = 0; j < n_gmon_sections; j++ ){
-		if((prof_pc >= _gmonparam[j].lowpc) && (prof_pc < _gmonparam[j].highpc)) {
-			_gmonparam[j].kcount[(prof_pc-_gmonparam[j].lowpc)/(4 * binsize)]++;
-			break;
-		}
+	j = profile_lookup( prof_pc ) ;
+	if( j >= 0 ) {
+		_gmonparam[j].kcount[(prof_pc-_gmonparam[j].lowpc)/(4 * binsize)]++;
 	}
 	// Ack the Timer Interrupt
 	timer_ack();
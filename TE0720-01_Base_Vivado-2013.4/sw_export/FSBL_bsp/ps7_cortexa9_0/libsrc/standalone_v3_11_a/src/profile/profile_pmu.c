@@ -0,0 +1,218 @@
+//
+// Copyright (c) 2002-2010 Xilinx, Inc.  All rights reserved.
+// Xilinx, Inc.
+//
+// XILINX IS PROVIDING THIS DESIGN, CODE, OR INFORMATION "AS IS" AS A
+// COURTESY TO YOU.  BY PROVIDING THIS DESIGN, CODE, OR INFORMATION AS
+// ONE POSSIBLE   IMPLEMENTATION OF THIS FEATURE, APPLICATION OR
+// STANDARD, XILINX IS MAKING NO REPRESENTATION THAT THIS IMPLEMENTATION
+// IS FREE FROM ANY CLAIMS OF INFRINGEMENT, AND YOU ARE RESPONSIBLE
+// FOR OBTAINING ANY RIGHTS YOU MAY REQUIRE FOR YOUR IMPLEMENTATION.
+// XILINX EXPRESSLY DISCLAIMS ANY WARRANTY WHATSOEVER WITH RESPECT TO
+// THE ADEQUACY OF THE IMPLEMENTATION, INCLUDING BUT NOT LIMITED TO
+// ANY WARRANTIES OR REPRESENTATIONS THAT THIS IMPLEMENTATION IS FREE
+// FROM CLAIMS OF INFRINGEMENT, IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Cortex A9 PMU overflow sampling, see profile_pmu.h
+//
+
+#include "profile.h"
+#include "profile_pmu.h"
+
+#ifdef PROC_CORTEXA9
+
+#include <stdlib.h>
+#include <string.h>
+#include "xpm_counter.h"
+
+extern int binsize ;
+extern unsigned int sample_freq_hz ;
+extern unsigned int timer_clk_ticks ;
+extern uint32_t prof_pc ;
+
+static const unsigned int pmu_events[] = PROFILE_PMU_EVENTS ;
+static const unsigned int pmu_periods[] = PROFILE_PMU_PERIODS ;
+
+static int pmu_num_events = 0 ;
+static unsigned int pmu_mask = 0 ;
+static unsigned int pmu_reload[PROFILE_PMU_MAX_EVENTS] ;
+
+// Histograms per event and section, event 0 uses the gmon histogram
+static unsigned short *pmu_hist[PROFILE_PMU_MAX_EVENTS][PROFILE_MAX_SECTIONS] ;
+
+//--------------------------------------------------------------------
+// Name of an event for the gmon histogram dimension
+//
+//--------------------------------------------------------------------
+static const char *pmu_event_name( unsigned int event )
+{
+	switch( event ) {
+	case XPM_EVENT_CLOCKCYCLES:		return "seconds" ;
+	case XPM_EVENT_DATA_CACHEREFILL:	return "dcache-refill" ;
+	case XPM_EVENT_INSRFETCH_CACHEREFILL:	return "icache-refill" ;
+	case XPM_EVENT_BRANCHMISS:		return "branch-miss" ;
+	case XPM_EVENT_DATA_TLBREFILL:		return "dtlb-refill" ;
+	case XPM_EVENT_DATASTALL:		return "data-stall" ;
+	case XPM_EVENT_INSTRSTALL:		return "instr-stall" ;
+	default:				return "events" ;
+	}
+}
+
+//--------------------------------------------------------------------
+// Program the event counters and allocate the histograms. Returns 0
+// on success, -1 if the configuration cannot be sampled.
+//
+//--------------------------------------------------------------------
+int profile_pmu_init( void )
+{
+	int e, j ;
+
+	pmu_num_events = sizeof(pmu_events) / sizeof(pmu_events[0]) ;
+	if( (pmu_num_events > PROFILE_PMU_MAX_EVENTS) ||
+		(pmu_num_events != sizeof(pmu_periods) / sizeof(pmu_periods[0])) ||
+		(n_gmon_sections > PROFILE_MAX_SECTIONS) ) {
+		pmu_num_events = 0 ;
+		return -1 ;
+	}
+
+	Xpm_StopCounters( XPM_CTRMASK_ALL ) ;
+	Xpm_DisableOverflowIntr( XPM_CTRMASK_ALL ) ;
+	Xpm_ClearOverflowStatus( XPM_CTRMASK_ALL ) ;
+
+	pmu_mask = 0 ;
+	for( e = 0; e < pmu_num_events; e++ ) {
+		pmu_reload[e] = pmu_periods[e] ? pmu_periods[e] : timer_clk_ticks ;
+
+		for( j = 0; j < n_gmon_sections; j++ ) {
+			if( e == 0 ) {
+				pmu_hist[e][j] = _gmonparam[j].kcount ;
+			} else {
+				pmu_hist[e][j] = (unsigned short *)
+					calloc( _gmonparam[j].kcountsize, sizeof(unsigned short) ) ;
+			}
+		}
+
+		Xpm_SetCounterEvent( e, pmu_events[e] ) ;
+		Xpm_WriteCounter( e, 0 - pmu_reload[e] ) ;
+		pmu_mask |= 1 << e ;
+	}
+
+	Xpm_EnableOverflowIntr( pmu_mask ) ;
+	Xpm_StartCounters( pmu_mask ) ;
+
+	return 0 ;
+}
+
+//--------------------------------------------------------------------
+// PMU overflow interrupt handler. The interrupted PC is saved to
+// prof_pc by the IRQ vector. Every overflowed counter is rearmed and
+// counts one sample in its histogram.
+//
+//--------------------------------------------------------------------
+void profile_pmu_intr_handler( void )
+{
+	unsigned int status ;
+	unsigned long bin = 0 ;
+	unsigned short *hist ;
+	int e, j ;
+
+	status = Xpm_GetOverflowStatus() & pmu_mask ;
+
+	j = profile_lookup( prof_pc ) ;
+	if( j >= 0 )
+		bin = (prof_pc - _gmonparam[j].lowpc) / (4 * binsize) ;
+
+	for( e = 0; e < pmu_num_events; e++ ) {
+		if( !(status & (1 << e)) )
+			continue ;
+
+		Xpm_WriteCounter( e, 0 - pmu_reload[e] ) ;
+
+		if( j < 0 )
+			continue ;
+		hist = pmu_hist[e][j] ;
+		if( (hist != NULL) && (hist[bin] != 0xFFFF) )
+			hist[bin]++ ;
+	}
+
+	Xpm_ClearOverflowStatus( status ) ;
+}
+
+//--------------------------------------------------------------------
+// Start and stop sampling, used around call-graph data collection
+//
+//--------------------------------------------------------------------
+void profile_pmu_start( void )
+{
+	Xpm_StartCounters( pmu_mask ) ;
+}
+
+void profile_pmu_stop( void )
+{
+	Xpm_StopCounters( pmu_mask ) ;
+}
+
+int profile_pmu_num_events( void )
+{
+	return pmu_num_events ;
+}
+
+//--------------------------------------------------------------------
+// Write the histogram of one event as a gmon.out stream: the gmon
+// header followed by one histogram record per section. Returns 0 on
+// success, -1 for an invalid event.
+//
+//--------------------------------------------------------------------
+static void gmon_put32( unsigned char *p, unsigned long v )
+{
+	p[0] = v ;
+	p[1] = v >> 8 ;
+	p[2] = v >> 16 ;
+	p[3] = v >> 24 ;
+}
+
+int profile_pmu_write_gmon( int event,
+		void (*out)( const void *data, unsigned int len ) )
+{
+	unsigned char rec[1 + 4 * 4 + GMON_HIST_DIMEN_LEN + 1] ;
+	unsigned short *hist ;
+	unsigned short zero = 0 ;
+	unsigned long i ;
+	int j ;
+
+	if( (event < 0) || (event >= pmu_num_events) || (out == NULL) )
+		return -1 ;
+
+	// Header: magic, version, spare
+	memset( rec, 0, 20 ) ;
+	memcpy( rec, GMON_MAGIC, 4 ) ;
+	gmon_put32( rec + 4, GMON_VERSION ) ;
+	out( rec, 20 ) ;
+
+	for( j = 0; j < n_gmon_sections; j++ ) {
+		memset( rec, 0, sizeof(rec) ) ;
+		rec[0] = GMON_TAG_TIME_HIST ;
+		gmon_put32( rec + 1, _gmonparam[j].lowpc ) ;
+		gmon_put32( rec + 5, _gmonparam[j].lowpc +
+				_gmonparam[j].kcountsize * 4 * binsize ) ;
+		gmon_put32( rec + 9, _gmonparam[j].kcountsize ) ;
+		gmon_put32( rec + 13, (event == 0) ? sample_freq_hz : 1 ) ;
+		strncpy( (char *)rec + 17, pmu_event_name( pmu_events[event] ),
+				GMON_HIST_DIMEN_LEN ) ;
+		rec[17 + GMON_HIST_DIMEN_LEN] = (event == 0) ? 's' : 'n' ;
+		out( rec, sizeof(rec) ) ;
+
+		hist = pmu_hist[event][j] ;
+		for( i = 0; i < _gmonparam[j].kcountsize; i++ ) {
+			if( hist != NULL )
+				out( &hist[i], sizeof(unsigned short) ) ;
+			else
+				out( &zero, sizeof(unsigned short) ) ;
+		}
+	}
+
+	return 0 ;
+}
+
+#endif	// PROC_CORTEXA9
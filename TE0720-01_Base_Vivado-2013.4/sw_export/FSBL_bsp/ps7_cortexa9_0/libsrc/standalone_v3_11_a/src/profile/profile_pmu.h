@@ -0,0 +1,74 @@
+//
+// Copyright (c) 2002-2010 Xilinx, Inc.  All rights reserved.
+// Xilinx, Inc.
+//
+// XILINX IS PROVIDING THIS DESIGN, CODE, OR INFORMATION "AS IS" AS A
+// COURTESY TO YOU.  BY PROVIDING THIS DESIGN, CODE, OR INFORMATION AS
+// ONE POSSIBLE   IMPLEMENTATION OF THIS FEATURE, APPLICATION OR
+// STANDARD, XILINX IS MAKING NO REPRESENTATION THAT THIS IMPLEMENTATION
+// IS FREE FROM ANY CLAIMS OF INFRINGEMENT, AND YOU ARE RESPONSIBLE
+// FOR OBTAINING ANY RIGHTS YOU MAY REQUIRE FOR YOUR IMPLEMENTATION.
+// XILINX EXPRESSLY DISCLAIMS ANY WARRANTY WHATSOEVER WITH RESPECT TO
+// THE ADEQUACY OF THE IMPLEMENTATION, INCLUDING BUT NOT LIMITED TO
+// ANY WARRANTIES OR REPRESENTATIONS THAT THIS IMPLEMENTATION IS FREE
+// FROM CLAIMS OF INFRINGEMENT, IMPLIED WARRANTIES OF MERCHANTABILITY
+// AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// profile_pmu.h:
+//	Cortex A9 PMU overflow sampling.
+//
+//	With PROFILE_PMU_SAMPLING defined the Performance Monitor event
+//	counters replace the scu timer as sample source. Every counter is
+//	preloaded to overflow after its period, the overflow interrupt
+//	records the interrupted PC in a histogram per event. Event 0 fills
+//	the gmon histogram (_gmonparam[].kcount) used by XMD, all events can
+//	be written as gmon.out streams with profile_pmu_write_gmon().
+//
+//////////////////////////////////////////////////////////////////////
+
+#ifndef _PROFILE_PMU_H
+#define _PROFILE_PMU_H
+
+#include "profile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// PMU interrupt of CPU0 (XPS_PMU0_INT_ID)
+#ifndef PROFILE_PMU_INTR_ID
+#define PROFILE_PMU_INTR_ID	37
+#endif
+
+// Sampled events (XPM_EVENT_* codes) and their periods in events per
+// sample. A period of 0 selects timer_clk_ticks, which gives the timer
+// sample rate for the cycle count event.
+#ifndef PROFILE_PMU_EVENTS
+#define PROFILE_PMU_EVENTS	{ 0x11, 0x03, 0x10 }	// cycles, D-cache refill,
+							// branch mispredict
+#endif
+#ifndef PROFILE_PMU_PERIODS
+#define PROFILE_PMU_PERIODS	{ 0, 1000, 1000 }
+#endif
+
+#define PROFILE_PMU_MAX_EVENTS	6
+
+// gmon.out record tags and sizes
+#define GMON_MAGIC		"gmon"
+#define GMON_VERSION		1
+#define GMON_TAG_TIME_HIST	0
+#define GMON_HIST_DIMEN_LEN	15
+
+int profile_pmu_init( void ) ;
+void profile_pmu_intr_handler( void ) ;
+void profile_pmu_start( void ) ;
+void profile_pmu_stop( void ) ;
+int profile_pmu_num_events( void ) ;
+int profile_pmu_write_gmon( int event,
+		void (*out)( const void *data, unsigned int len ) ) ;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif 		/* _PROFILE_PMU_H */
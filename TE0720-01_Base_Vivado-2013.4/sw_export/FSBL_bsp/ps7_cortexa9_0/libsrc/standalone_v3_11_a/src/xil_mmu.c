@@ -63,6 +63,16 @@
 * 3.11a  asa 09/23/13 Modified Xil_SetTlbAttributes to flush the complete
 *			 D cache after the translation table update. Removed the
 *			 redundant TLB invalidation in the same API at the beginning.
+* 3.11a  te  10/16/26 Added Xil_SetTlbAttributesRange which updates a range
+*			 of sections with one table clean and one TLB invalidation
+*			 and maps aligned 16MB blocks as supersections.
+*			 Xil_SetTlbAttributes uses it and flushes the D cache only
+*			 when the old mapping was cacheable.
+* 3.11a  te  10/16/26 Split supersections keep the domain of the new
+*			 attributes, the table lines of split blocks are cleaned.
+* 3.11a  te  10/16/26 Blocks changing between a supersection and sections
+*			 are unmapped, cleaned and the TLBs invalidated before
+*			 the new entries are written (break-before-make).
 * </pre>
 *
 * @note
@@ -85,6 +95,13 @@
 
 /************************** Constant Definitions *****************************/
 
+#define SECTIONS_PER_SUPER	16	/* 64 bytes of the table, 2 cache lines */
+#define DESC_TYPE_MASK		0x3U
+#define DESC_TYPE_SECTION	0x2U
+#define DESC_DOMAIN_MASK	0x1E0U
+#define DESC_ATTR_MASK		0x000FFFFFU
+#define DESC_CACHEABLE_MASK	0x4008U	/* TEX[2] or C */
+
 /************************** Variable Definitions *****************************/
 
 extern u32 MMUTable;
@@ -106,22 +123,185 @@ extern u32 MMUTable;
 *
 ******************************************************************************/
 void Xil_SetTlbAttributes(u32 addr, u32 attrib)
+{
+	Xil_SetTlbAttributesRange(addr & ~(XIL_MMU_SECTION_SIZE - 1),
+				  XIL_MMU_SECTION_SIZE, attrib);
+}
+
+/*****************************************************************************
+*
+* Unmap a block of 16 sections before it changes between a supersection and
+* sections. The TLB could otherwise hold entries of both sizes for the same
+* address, a multiple hit is UNPREDICTABLE on ARMv7. The entries are set to
+* fault, cleaned to the table walk, and the TLBs invalidated.
+*
+* @param	ptr points to the first entry of the block.
+*
+* @return	None.
+*
+* @note		The block must not hold the code, stack or translation table
+*		of the caller.
+*
+******************************************************************************/
+static void Xil_BreakBlock(u32 *ptr)
+{
+	u32 index;
+
+	for (index = 0; index < SECTIONS_PER_SUPER; index++) {
+		ptr[index] = 0;
+	}
+	Xil_DCacheFlushRange((unsigned int)ptr,
+			     SECTIONS_PER_SUPER * sizeof(u32));
+
+	mtcp(XREG_CP15_INVAL_UTLB_UNLOCKED, 0);
+	dsb();
+	isb();
+}
+
+/*****************************************************************************
+*
+* Convert the supersection holding a section back to 16 sections with the
+* same attributes, so single sections of the block can be changed. The
+* supersection has no domain field, the sections get the given domain.
+*
+* @param	Section is the index of a section in the translation table.
+* @param	Domain is the domain field for the sections.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_SplitSupersection(u32 Section, u32 Domain)
+{
+	u32 *ptr;
+	u32 first;
+	u32 attrib;
+	u32 index;
+
+	first = Section & ~(SECTIONS_PER_SUPER - 1);
+	ptr = &MMUTable + first;
+	if ((ptr[0] & (XIL_MMU_SUPERSECTION | DESC_TYPE_MASK)) !=
+	    (XIL_MMU_SUPERSECTION | DESC_TYPE_SECTION)) {
+		return;
+	}
+
+	attrib = (ptr[0] & DESC_ATTR_MASK &
+		  ~(XIL_MMU_SUPERSECTION | DESC_DOMAIN_MASK)) |
+		 (Domain & DESC_DOMAIN_MASK);
+	Xil_BreakBlock(ptr);
+	for (index = 0; index < SECTIONS_PER_SUPER; index++) {
+		ptr[index] = ((first + index) * XIL_MMU_SECTION_SIZE) | attrib;
+	}
+}
+
+/*****************************************************************************
+*
+* Set the memory attributes for a range of sections, in the translation
+* table. All entries are updated first, then the table lines are cleaned,
+* and the TLBs and branch predictors are invalidated once for the range.
+*
+* Blocks of 16 sections that are 16MB aligned and fully inside the range
+* are mapped as supersections, so they take one TLB entry instead of 16.
+* Supersections have no domain field, the domain bits of attrib are dropped
+* for them; all domains are set to manager by the boot code. The sections
+* of a supersection split at either end of the range get the domain of
+* attrib.
+*
+* A block that changes between a supersection and sections is unmapped
+* and the TLBs invalidated before its new entries are written, so that
+* part of the range faults for a short time.
+*
+* @param	Addr is the start address of the range, rounded down to 1MB.
+* @param	Size is the size of the range in bytes, rounded up to 1MB.
+* @param	Attrib specifies the section attributes for the range.
+*
+* @return	None.
+*
+* @note		The D-cache is flushed once, and only if part of the range was
+*		cacheable before the update. The MMU and D-cache need not be
+*		disabled before calling this function, but the code, stack
+*		and translation table of the caller must not be in a block
+*		that changes between a supersection and sections.
+*
+******************************************************************************/
+void Xil_SetTlbAttributesRange(u32 Addr, u32 Size, u32 Attrib)
 {
 	u32 *ptr;
+	u32 first;
+	u32 last;
 	u32 section;
+	u32 index;
+	u32 entry;
+	u32 cacheable = 0;
+	u32 mapped;
+	int super;
 
-	section = addr / 0x100000;
-	ptr = &MMUTable + section;
-	*ptr = (addr & 0xFFF00000) | attrib;
+	if (Size == 0) {
+		return;
+	}
 
-	Xil_DCacheFlush();
+	first = Addr / XIL_MMU_SECTION_SIZE;
+	if (Size - 1 > 0xFFFFFFFFU - Addr) {
+		last = 0xFFFFFFFFU / XIL_MMU_SECTION_SIZE;
+	} else {
+		last = (Addr + Size - 1) / XIL_MMU_SECTION_SIZE;
+	}
+
+	super = ((Attrib & DESC_TYPE_MASK) == DESC_TYPE_SECTION) &&
+		((Attrib & XIL_MMU_SUPERSECTION) == 0);
+
+	section = first;
+	while (section <= last) {
+		ptr = &MMUTable + section;
+
+		if (super && ((section % SECTIONS_PER_SUPER) == 0) &&
+		    (last - section >= SECTIONS_PER_SUPER - 1)) {
+			entry = (section * XIL_MMU_SECTION_SIZE) |
+				(Attrib & DESC_ATTR_MASK & ~DESC_DOMAIN_MASK) |
+				XIL_MMU_SUPERSECTION;
+			mapped = 0;
+			for (index = 0; index < SECTIONS_PER_SUPER; index++) {
+				cacheable |= ptr[index];
+				mapped |= ptr[index] & DESC_TYPE_MASK;
+			}
+			if ((mapped != 0) &&
+			    ((ptr[0] & (XIL_MMU_SUPERSECTION |
+					DESC_TYPE_MASK)) !=
+			     (XIL_MMU_SUPERSECTION | DESC_TYPE_SECTION))) {
+				Xil_BreakBlock(ptr);
+			}
+			for (index = 0; index < SECTIONS_PER_SUPER; index++) {
+				ptr[index] = entry;
+			}
+			section += SECTIONS_PER_SUPER;
+		} else {
+			/* A supersection not kept as one goes back to sections */
+			Xil_SplitSupersection(section, Attrib);
+			cacheable |= *ptr;
+			*ptr = (section * XIL_MMU_SECTION_SIZE) | Attrib;
+			section++;
+		}
+	}
+
+	/*
+	 * Make the new entries visible to the table walk, including the rest
+	 * of the blocks a split rewrote
+	 */
+	first &= ~(SECTIONS_PER_SUPER - 1);
+	last |= SECTIONS_PER_SUPER - 1;
+	Xil_DCacheFlushRange((unsigned int)(&MMUTable + first),
+			     (last - first + 1) * sizeof(u32));
+
+	/* Write back and drop lines cached under the old attributes */
+	if ((cacheable & DESC_CACHEABLE_MASK) != 0) {
+		Xil_DCacheFlush();
+	}
 
 	mtcp(XREG_CP15_INVAL_UTLB_UNLOCKED, 0);
 	/* Invalidate all branch predictors */
 	mtcp(XREG_CP15_INVAL_BRANCH_ARRAY, 0);
 
 	dsb(); /* ensure completion of the BP and TLB invalidation */
-    isb(); /* synchronize context on this processor */
+	isb(); /* synchronize context on this processor */
 }
 
 /*****************************************************************************
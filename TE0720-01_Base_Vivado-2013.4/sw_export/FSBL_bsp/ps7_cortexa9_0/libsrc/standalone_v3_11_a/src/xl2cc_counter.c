@@ -55,6 +55,7 @@
 * 1.00a sdm  07/11/11 First release
 * 3.07a asa  08/30/12 Updated for CR 675636 to provide the L2 Base Address
 *		      inside the APIs
+* 3.11a te   10/16/26 Added XL2cc_EventCtrRead to sample running counters
 * </pre>
 *
 ******************************************************************************/
@@ -156,6 +157,28 @@ void XL2cc_EventCtrStop(u32 *EveCtr0, u32 *EveCtr1)
 	XL2cc_EventCtrReset();
 }
 
+/****************************************************************************/
+/**
+*
+* This function reads the event counters in L2 Cache controller while they
+* keep counting.
+*
+* @param	EveCtr0 is an output parameter which is used to return the value
+*		in event counter 0.
+*		EveCtr1 is an output parameter which is used to return the value
+*		in event counter 1.
+*
+* @return	None.
+*
+* @note		The counters saturate at 0xFFFFFFFF, they do not wrap.
+*
+*****************************************************************************/
+void XL2cc_EventCtrRead(u32 *EveCtr0, u32 *EveCtr1)
+{
+	*EveCtr0 = *((volatile u32*)(XPS_L2CC_BASEADDR + XPS_L2CC_EVNT_CNT0_VAL_OFFSET));
+	*EveCtr1 = *((volatile u32*)(XPS_L2CC_BASEADDR + XPS_L2CC_EVNT_CNT1_VAL_OFFSET));
+}
+
 /****************************************************************************/
 /**
 *
@@ -0,0 +1,506 @@
+/******************************************************************************
+*
+* (c) Copyright 2011-13  Xilinx, Inc. All rights reserved.
+*
+* This file contains confidential and proprietary information of Xilinx, Inc.
+* and is protected under U.S. and international copyright and other
+* intellectual property laws.
+*
+* DISCLAIMER
+* This disclaimer is not a license and does not grant any rights to the
+* materials distributed herewith. Except as otherwise provided in a valid
+* license issued to you by Xilinx, and to the maximum extent permitted by
+* applicable law: (1) THESE MATERIALS ARE MADE AVAILABLE "AS IS" AND WITH ALL
+* FAULTS, AND XILINX HEREBY DISCLAIMS ALL WARRANTIES AND CONDITIONS, EXPRESS,
+* IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF
+* MERCHANTABILITY, NON-INFRINGEMENT, OR FITNESS FOR ANY PARTICULAR PURPOSE;
+* and (2) Xilinx shall not be liable (whether in contract or tort, including
+* negligence, or under any other theory of liability) for any loss or damage
+* of any kind or nature related to, arising under or in connection with these
+* materials, including for any direct, or any indirect, special, incidental,
+* or consequential loss or damage (including loss of data, profits, goodwill,
+* or any type of loss or damage suffered as a result of any action brought by
+* a third party) even if such damage or loss was reasonably foreseeable or
+* Xilinx had been advised of the possibility of the same.
+*
+* CRITICAL APPLICATIONS
+* Xilinx products are not designed or intended to be fail-safe, or for use in
+* any application requiring fail-safe performance, such as life-support or
+* safety devices or systems, Class III medical devices, nuclear facilities,
+* applications related to the deployment of airbags, or any other applications
+* that could lead to death, personal injury, or severe property or
+* environmental damage (individually and collectively, "Critical
+* Applications"). Customer assumes the sole risk and liability of any use of
+* Xilinx products in Critical Applications, subject only to applicable laws
+* and regulations governing limitations on product liability.
+*
+* THIS COPYRIGHT NOTICE AND DISCLAIMER MUST BE RETAINED AS PART OF THIS FILE
+* AT ALL TIMES.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xperf_region.c
+*
+* This file contains APIs for measuring named code regions with the
+* Cortex-A9 Performance Monitor and the PL310 L2 cache controller event
+* counters. For more information, see xperf_region.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 3.11a te   10/16/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <string.h>
+#include "xperf_region.h"
+#include "xl2cc_counter.h"
+#include "xil_printf.h"
+
+/************************** Constant Definitions ****************************/
+
+/*
+ * A region is reported as memory bound when the data stall cycles exceed
+ * this percentage of its cycles.
+ */
+#define XPERF_MEMBOUND_PCT	30
+
+/*
+ * Counter index of the events used for the derived ratios
+ */
+#define XPERF_CTR_CYCLES	0
+#define XPERF_CTR_INSTR		1
+#define XPERF_CTR_L2_REQ	6
+#define XPERF_CTR_L2_HIT	7
+
+/**************************** Type Definitions ******************************/
+
+typedef struct {
+	const char *Name;
+	u32 PmEvent[XPERF_NUM_PM_CTRS];
+	int L2Event[XPERF_NUM_L2_CTRS];
+	const char *EventName[XPERF_NUM_CTRS];
+} XPerf_Group;
+
+typedef struct {
+	int Id;
+	u32 Start[XPERF_NUM_CTRS];
+} XPerf_Frame;
+
+/************************** Variable Definitions *****************************/
+
+static const XPerf_Group XPerfGroups[XPERF_NUM_GROUPS] = {
+	{
+		"l1",
+		{ XPM_EVENT_CLOCKCYCLES, XPM_EVENT_INSTRRENAME,
+		  XPM_EVENT_DATA_CACHEACCESS, XPM_EVENT_DATA_CACHEREFILL,
+		  XPM_EVENT_INSRFETCH_CACHEREFILL, XPM_EVENT_DATAEVICT },
+		{ XL2CC_DRREQ, XL2CC_DRHIT },
+		{ "cycles", "instr", "dc_access", "dc_refill",
+		  "ic_refill", "dc_evict", "l2_drreq", "l2_drhit" }
+	},
+	{
+		"stall",
+		{ XPM_EVENT_CLOCKCYCLES, XPM_EVENT_INSTRRENAME,
+		  XPM_EVENT_DATASTALL, XPM_EVENT_INSTRSTALL,
+		  XPM_EVENT_BRANCHMISS, XPM_EVENT_WRITESTALL },
+		{ XL2CC_DWREQ, XL2CC_DWHIT },
+		{ "cycles", "instr", "data_stall", "instr_stall",
+		  "br_miss", "wr_stall", "l2_dwreq", "l2_dwhit" }
+	},
+	{
+		"tlb",
+		{ XPM_EVENT_CLOCKCYCLES, XPM_EVENT_INSTRRENAME,
+		  XPM_EVENT_DATA_TLBREFILL, XPM_EVENT_INSTRFECT_TLBREFILL,
+		  XPM_EVENT_MAINTLBSTALL, XPM_EVENT_PLDSTALL },
+		{ XL2CC_IRREQ, XL2CC_IRHIT },
+		{ "cycles", "instr", "dtlb_refill", "itlb_refill",
+		  "tlb_stall", "pld_stall", "l2_irreq", "l2_irhit" }
+	},
+};
+
+static XPerf_Region XPerfRegions[XPERF_MAX_REGIONS];
+static u32 XPerfNumRegions;
+
+static XPerf_Frame XPerfStack[XPERF_MAX_DEPTH];
+static u32 XPerfDepth;
+static u32 XPerfGroup;
+
+/************************** Function Prototypes ******************************/
+
+static void XPerf_ReadCounters(u32 *Value);
+static void XPerf_PrintU64(u64 Value);
+static void XPerf_PrintRatio(const char *Name, u64 Num, u64 Den, u32 Scale);
+
+/******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* This function clears the region table and starts the counters with the
+* first event group.
+*
+* @param	None.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XPerf_Init(void)
+{
+	memset(XPerfRegions, 0, sizeof(XPerfRegions));
+	XPerfNumRegions = 0;
+	XPerfDepth = 0;
+
+	XPerf_SelectGroup(XPERF_GROUP_L1);
+}
+
+/****************************************************************************/
+/**
+*
+* This function clears the accumulated counts of all regions. The regions
+* stay registered.
+*
+* @param	None.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XPerf_Reset(void)
+{
+	u32 Index;
+
+	for (Index = 0; Index < XPerfNumRegions; Index++) {
+		memset(XPerfRegions[Index].Calls, 0,
+			sizeof(XPerfRegions[Index].Calls));
+		memset(XPerfRegions[Index].Count, 0,
+			sizeof(XPerfRegions[Index].Count));
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* This function programs the PMU and L2 event counters with an event group
+* and restarts them from zero.
+*
+* @param	Group is the event group, XPERF_GROUP_*.
+*
+* @return	None.
+*
+* @note		The group cannot be changed while a region is open, the call
+*		is ignored in that case.
+*
+*****************************************************************************/
+void XPerf_SelectGroup(u32 Group)
+{
+	const XPerf_Group *GroupPtr;
+	u32 Counter;
+
+	if ((Group >= XPERF_NUM_GROUPS) || (XPerfDepth != 0)) {
+		return;
+	}
+
+	GroupPtr = &XPerfGroups[Group];
+	XPerfGroup = Group;
+
+	Xpm_StopCounters(XPM_CTRMASK_ALL);
+	Xpm_DisableOverflowIntr(XPM_CTRMASK_ALL);
+	for (Counter = 0; Counter < XPERF_NUM_PM_CTRS; Counter++) {
+		Xpm_SetCounterEvent(Counter, GroupPtr->PmEvent[Counter]);
+		Xpm_WriteCounter(Counter, 0);
+	}
+	Xpm_ClearOverflowStatus(XPM_CTRMASK_ALL);
+	Xpm_StartCounters(XPM_CTRMASK_ALL);
+
+	XL2cc_EventCtrInit(GroupPtr->L2Event[0], GroupPtr->L2Event[1]);
+	XL2cc_EventCtrStart();
+}
+
+/****************************************************************************/
+/**
+*
+* This function selects the next event group, round robin. Call it between
+* repeated runs of the measured code to collect all groups.
+*
+* @param	None.
+*
+* @return	The selected group.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 XPerf_NextGroup(void)
+{
+	XPerf_SelectGroup((XPerfGroup + 1) % XPERF_NUM_GROUPS);
+
+	return XPerfGroup;
+}
+
+/****************************************************************************/
+/**
+*
+* This function returns the id of a region, registering it on first use.
+*
+* @param	Name is the region name. The string is referenced, not copied.
+*
+* @return	The region id, or XPERF_INVALID_REGION if the table is full.
+*
+* @note		Look the id up once outside the measured code, the lookup
+*		compares names.
+*
+*****************************************************************************/
+int XPerf_RegionGet(const char *Name)
+{
+	u32 Index;
+
+	for (Index = 0; Index < XPerfNumRegions; Index++) {
+		if ((XPerfRegions[Index].Name == Name) ||
+				(strcmp(XPerfRegions[Index].Name, Name) == 0)) {
+			return Index;
+		}
+	}
+
+	if (XPerfNumRegions == XPERF_MAX_REGIONS) {
+		return XPERF_INVALID_REGION;
+	}
+
+	XPerfRegions[XPerfNumRegions].Name = Name;
+	return XPerfNumRegions++;
+}
+
+/****************************************************************************/
+/**
+*
+* This function opens a region and samples the counters.
+*
+* @param	Id is the region id returned by XPerf_RegionGet.
+*
+* @return	None.
+*
+* @note		Regions nested deeper than XPERF_MAX_DEPTH are not counted.
+*
+*****************************************************************************/
+void XPerf_RegionBegin(int Id)
+{
+	XPerf_Frame *Frame;
+
+	if (XPerfDepth++ >= XPERF_MAX_DEPTH) {
+		return;
+	}
+
+	Frame = &XPerfStack[XPerfDepth - 1];
+	Frame->Id = Id;
+	XPerf_ReadCounters(Frame->Start);
+}
+
+/****************************************************************************/
+/**
+*
+* This function closes the innermost open region and adds the counter
+* deltas to it.
+*
+* @param	Id is the region id passed to the matching XPerf_RegionBegin.
+*
+* @return	None.
+*
+* @note		A region that is closed with a different id than it was opened
+*		with is dropped.
+*
+*****************************************************************************/
+void XPerf_RegionEnd(int Id)
+{
+	u32 Now[XPERF_NUM_CTRS];
+	XPerf_Frame *Frame;
+	XPerf_Region *Region;
+	u32 Counter;
+
+	XPerf_ReadCounters(Now);
+
+	if (XPerfDepth == 0) {
+		return;
+	}
+	if (XPerfDepth-- > XPERF_MAX_DEPTH) {
+		return;
+	}
+
+	Frame = &XPerfStack[XPerfDepth];
+	if ((Frame->Id != Id) || (Id < 0) || (Id >= (int)XPerfNumRegions)) {
+		return;
+	}
+
+	Region = &XPerfRegions[Id];
+	Region->Calls[XPerfGroup]++;
+	for (Counter = 0; Counter < XPERF_NUM_CTRS; Counter++) {
+		Region->Count[XPerfGroup][Counter] +=
+			(u32)(Now[Counter] - Frame->Start[Counter]);
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* This function returns the accumulated counts of a region.
+*
+* @param	Id is the region id.
+*
+* @return	Pointer to the region, or NULL for an invalid id.
+*
+* @note		None.
+*
+*****************************************************************************/
+const XPerf_Region *XPerf_GetRegion(int Id)
+{
+	if ((Id < 0) || (Id >= (int)XPerfNumRegions)) {
+		return NULL;
+	}
+
+	return &XPerfRegions[Id];
+}
+
+/****************************************************************************/
+/**
+*
+* This function prints the totals of every region and event group and the
+* ratios derived from them: instructions per cycle, L1 D-cache miss rate,
+* L2 hit rate and the share of data stall cycles.
+*
+* @param	None.
+*
+* @return	None.
+*
+* @note		The ratios of a group only use counts of that group. Counts
+*		of different groups come from different runs.
+*
+*****************************************************************************/
+void XPerf_Report(void)
+{
+	const XPerf_Region *Region;
+	const u64 *Count;
+	u32 Index, Group, Counter;
+
+	for (Index = 0; Index < XPerfNumRegions; Index++) {
+		Region = &XPerfRegions[Index];
+		xil_printf("region %s\r\n", Region->Name);
+
+		for (Group = 0; Group < XPERF_NUM_GROUPS; Group++) {
+			if (Region->Calls[Group] == 0) {
+				continue;
+			}
+			Count = Region->Count[Group];
+
+			xil_printf("  %s: calls %d", XPerfGroups[Group].Name,
+					Region->Calls[Group]);
+			for (Counter = 0; Counter < XPERF_NUM_CTRS; Counter++) {
+				xil_printf(" %s ",
+					XPerfGroups[Group].EventName[Counter]);
+				XPerf_PrintU64(Count[Counter]);
+			}
+			xil_printf("\r\n   ");
+
+			XPerf_PrintRatio("ipc", Count[XPERF_CTR_INSTR],
+					Count[XPERF_CTR_CYCLES], 100);
+			XPerf_PrintRatio("l2_hit%", Count[XPERF_CTR_L2_HIT],
+					Count[XPERF_CTR_L2_REQ], 10000);
+			if (Group == XPERF_GROUP_L1) {
+				XPerf_PrintRatio("dc_miss%", Count[3],
+						Count[2], 10000);
+			}
+			if (Group == XPERF_GROUP_STALL) {
+				XPerf_PrintRatio("data_stall%", Count[2],
+						Count[XPERF_CTR_CYCLES], 10000);
+				xil_printf(" %s",
+					(Count[2] * 100 > Count[XPERF_CTR_CYCLES] *
+					 XPERF_MEMBOUND_PCT) ?
+					"memory-bound" : "compute-bound");
+			}
+			xil_printf("\r\n");
+		}
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* This function reads the PMU and L2 event counters.
+*
+* @param	Value is an array of XPERF_NUM_CTRS entries for the counts.
+*
+* @return	None.
+*
+* @note		The L2 counters saturate, counts above 2^32 events per group
+*		selection are lost.
+*
+*****************************************************************************/
+static void XPerf_ReadCounters(u32 *Value)
+{
+	u32 Counter;
+
+	for (Counter = 0; Counter < XPERF_NUM_PM_CTRS; Counter++) {
+		Value[Counter] = Xpm_ReadCounter(Counter);
+	}
+	XL2cc_EventCtrRead(&Value[XPERF_NUM_PM_CTRS],
+			&Value[XPERF_NUM_PM_CTRS + 1]);
+}
+
+/****************************************************************************/
+/**
+*
+* This function prints an unsigned 64 bit value in decimal, xil_printf has
+* no 64 bit conversion.
+*
+* @param	Value is the value to print.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void XPerf_PrintU64(u64 Value)
+{
+	if (Value >= 1000000000ULL) {
+		XPerf_PrintU64(Value / 1000000000ULL);
+		xil_printf("%09d", (u32)(Value % 1000000000ULL));
+	} else {
+		xil_printf("%d", (u32)Value);
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* This function prints Num / Den with two decimals.
+*
+* @param	Name is the label.
+* @param	Num is the numerator.
+* @param	Den is the denominator.
+* @param	Scale is 100 for a plain ratio and 10000 for a percentage.
+*
+* @return	None.
+*
+* @note		Nothing is printed for a zero denominator.
+*
+*****************************************************************************/
+static void XPerf_PrintRatio(const char *Name, u64 Num, u64 Den, u32 Scale)
+{
+	u64 Ratio;
+
+	if (Den == 0) {
+		return;
+	}
+
+	Ratio = (Num * Scale) / Den;
+	xil_printf(" %s ", Name);
+	XPerf_PrintU64(Ratio / 100);
+	xil_printf(".%02d", (u32)(Ratio % 100));
+}
@@ -53,6 +53,7 @@
 * Ver   Who  Date     Changes
 * ----- ---- -------- -----------------------------------------------
 * 1.00a sdm  07/11/11 First release
+* 3.11a te   10/16/26 Added per counter access and overflow interrupt control
 * </pre>
 *
 ******************************************************************************/
@@ -298,3 +299,193 @@ void Xpm_GetEventCounters(u32 *PmCtrValue)
 #endif
 	}
 }
+
+/****************************************************************************/
+/**
+*
+* This function sets the event counted by one event counter.
+*
+* @param	Counter is the event counter, 0 to XPM_CTRCOUNT - 1.
+* @param	Event is one of the XPM_EVENT_* codes.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void Xpm_SetCounterEvent(u32 Counter, u32 Event)
+{
+	mtcp(XREG_CP15_EVENT_CNTR_SEL, Counter);
+	mtcp(XREG_CP15_EVENT_TYPE_SEL, Event);
+}
+
+/****************************************************************************/
+/**
+*
+* This function writes the value of one event counter. Writing the two's
+* complement of a period makes the counter overflow after period events.
+*
+* @param	Counter is the event counter, 0 to XPM_CTRCOUNT - 1.
+* @param	Value is the new counter value.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void Xpm_WriteCounter(u32 Counter, u32 Value)
+{
+	mtcp(XREG_CP15_EVENT_CNTR_SEL, Counter);
+	mtcp(XREG_CP15_PERF_MONITOR_COUNT, Value);
+}
+
+/****************************************************************************/
+/**
+*
+* This function reads the value of one event counter without stopping it.
+*
+* @param	Counter is the event counter, 0 to XPM_CTRCOUNT - 1.
+*
+* @return	The counter value.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 Xpm_ReadCounter(u32 Counter)
+{
+	u32 Value;
+
+	mtcp(XREG_CP15_EVENT_CNTR_SEL, Counter);
+#ifdef __GNUC__
+	Value = mfcp(XREG_CP15_PERF_MONITOR_COUNT);
+#else
+	{ register unsigned int Cp15Reg __asm(XREG_CP15_PERF_MONITOR_COUNT);
+	  Value = Cp15Reg; }
+#endif
+
+	return Value;
+}
+
+/****************************************************************************/
+/**
+*
+* This function enables the performance monitor and starts a set of event
+* counters. The other counters are left as they are.
+*
+* @param	Mask selects the counters, bit n is event counter n.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void Xpm_StartCounters(u32 Mask)
+{
+	u32 Reg;
+
+#ifdef __GNUC__
+	Reg = mfcp(XREG_CP15_PERF_MONITOR_CTRL);
+#else
+	{ register unsigned int C15Reg __asm(XREG_CP15_PERF_MONITOR_CTRL);
+	  Reg = C15Reg; }
+#endif
+	Reg |= 1; /* enable the performance monitor */
+	mtcp(XREG_CP15_PERF_MONITOR_CTRL, Reg);
+
+	mtcp(XREG_CP15_COUNT_ENABLE_SET, Mask & XPM_CTRMASK_ALL);
+}
+
+/****************************************************************************/
+/**
+*
+* This function stops a set of event counters.
+*
+* @param	Mask selects the counters, bit n is event counter n.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void Xpm_StopCounters(u32 Mask)
+{
+	mtcp(XREG_CP15_COUNT_ENABLE_CLR, Mask & XPM_CTRMASK_ALL);
+}
+
+/****************************************************************************/
+/**
+*
+* This function enables the overflow interrupt of a set of event counters.
+*
+* @param	Mask selects the counters, bit n is event counter n.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void Xpm_EnableOverflowIntr(u32 Mask)
+{
+	mtcp(XREG_CP15_INTR_ENABLE_SET, Mask & XPM_CTRMASK_ALL);
+}
+
+/****************************************************************************/
+/**
+*
+* This function disables the overflow interrupt of a set of event counters.
+*
+* @param	Mask selects the counters, bit n is event counter n.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void Xpm_DisableOverflowIntr(u32 Mask)
+{
+	mtcp(XREG_CP15_INTR_ENABLE_CLR, Mask & XPM_CTRMASK_ALL);
+}
+
+/****************************************************************************/
+/**
+*
+* This function returns which event counters have overflowed.
+*
+* @param	None.
+*
+* @return	Overflow flags, bit n is event counter n.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 Xpm_GetOverflowStatus(void)
+{
+	u32 Reg;
+
+#ifdef __GNUC__
+	Reg = mfcp(XREG_CP15_V_FLAG_STATUS);
+#else
+	{ register unsigned int C15Reg __asm(XREG_CP15_V_FLAG_STATUS);
+	  Reg = C15Reg; }
+#endif
+
+	return Reg & XPM_CTRMASK_ALL;
+}
+
+/****************************************************************************/
+/**
+*
+* This function clears the overflow flags of a set of event counters, which
+* also deasserts the PMU interrupt once no enabled flag is left.
+*
+* @param	Mask selects the counters, bit n is event counter n.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void Xpm_ClearOverflowStatus(u32 Mask)
+{
+	mtcp(XREG_CP15_V_FLAG_STATUS, Mask & XPM_CTRMASK_ALL);
+}
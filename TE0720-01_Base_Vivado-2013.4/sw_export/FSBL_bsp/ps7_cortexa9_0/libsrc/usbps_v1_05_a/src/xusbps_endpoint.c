@@ -55,6 +55,13 @@
  * 1.03a nm  09/21/12 Fixed CR#678977. Added proper sequence for setup packet
  *                    handling.
  * 1.04a nm  11/02/12 Fixed CR#683931. Mult bits are set properly in dQH.
+ * 1.05a te  10/16/26 XUsbPs_EpBufferSend checks for free descriptors before
+ *                    building the chain. Added XUsbPs_EpBufferSendMulti,
+ *                    XUsbPs_EpSetRxBatchMode, XUsbPs_EpBufferReceiveMulti
+ *                    and XUsbPs_EpBufferReleaseMulti for streaming bulk
+ *                    transfers.
+ *                    IN buffers that find the ring full wait in a queue,
+ *                    free descriptors are counted up to dTDTail.
  * </pre>
  ******************************************************************************/
 
@@ -82,6 +89,19 @@ static int  XUsbPs_dTDAttachBuffer(XUsbPs_dTD *dTDPtr,
 
 static void XUsbPs_dQHSetMaxPacketLenISO(XUsbPs_dQH *dQHPtr, u32 Len);
 
+/* Functions to build and start chains of IN transfer descriptors. */
+static u32 XUsbPs_dTDsRequired(u32 BufferLen);
+static int XUsbPs_EpInHasFreedTDs(XUsbPs_EpIn *Ep, u32 NumdTDs);
+static int XUsbPs_EpQueueIn(XUsbPs_EpIn *Ep, const u8 *BufferPtr,
+				u32 BufferLen, int SetIOC, XUsbPs_dTD **LastPtr);
+static int XUsbPs_EpInStart(XUsbPs *InstancePtr, u8 EpNum,
+				XUsbPs_dTD *DescPtr, u32 PipeEmpty);
+static int XUsbPs_EpInChainDone(XUsbPs *InstancePtr, u8 EpNum,
+				XUsbPs_dTD *DescPtr, XUsbPs_dTD *LastPtr,
+				u32 PipeEmpty);
+static int XUsbPs_EpInQueueReq(XUsbPs_EpIn *Ep, const u8 *BufferPtr,
+				u32 BufferLen);
+
 /* Functions to reconfigure endpoint upon host's set alternate interface
  * request.
  */
@@ -193,23 +213,26 @@ int XUsbPs_ConfigureDevice(XUsbPs *InstancePtr,
 * @return
 *		- XST_SUCCESS: The operation completed successfully.
 *		- XST_FAILURE: An error occured.
-*		- XST_USB_BUF_TOO_BIG: Provided buffer is too big (>16kB).
-*		- XST_USB_NO_DESC_AVAILABLE: No TX descriptor is available.
+*		- XST_USB_BUF_TOO_BIG: The buffer needs more descriptors than
+*		  the ring of the endpoint has.
+*		- XST_USB_NO_DESC_AVAILABLE: The ring and the queue of waiting
+*		  buffers are both full.
+*
+* @note		When the descriptor ring has no room for the buffer, the
+*		buffer waits in the queue of the endpoint and is primed by the
+*		TX complete interrupt. Buffers are sent in the order they were
+*		passed in. The queue is shared with the interrupt handler, a
+*		caller running with the USB interrupt enabled has to disable it
+*		around this call.
 *
 ******************************************************************************/
 int XUsbPs_EpBufferSend(XUsbPs *InstancePtr, u8 EpNum,
 				const u8 *BufferPtr, u32 BufferLen)
 {
 	int		Status;
-	u32		Token;
 	XUsbPs_EpIn	*Ep;
 	XUsbPs_dTD	*DescPtr;
-	u32 		Length;
 	u32		PipeEmpty = 1;
-	u32		Mask = 0x00010000;
-	u32		BitMask = Mask << EpNum;
-	u32		RegValue;
-	u32		Temp;
 
 	Xil_AssertNonvoid(InstancePtr  != NULL);
 	Xil_AssertNonvoid(EpNum < InstancePtr->DeviceConfig.NumEndpoints);
@@ -219,95 +242,196 @@ int XUsbPs_EpBufferSend(XUsbPs *InstancePtr, u8 EpNum,
 	 */
 	Ep = &InstancePtr->DeviceConfig.Ep[EpNum].In;
 
-	Xil_DCacheFlushRange((unsigned int)BufferPtr, BufferLen);
-
 	if(Ep->dTDTail != Ep->dTDHead) {
 		PipeEmpty = 0;
 	}
-	XUsbPs_dTDInvalidateCache(Ep->dTDHead);
 
-	/* Tell the caller if we do not have any descriptors available. */
-	if (XUsbPs_dTDIsActive(Ep->dTDHead)) {
-		return XST_USB_NO_DESC_AVAILABLE;
+	/* A buffer that never fits into the ring would block the queue. */
+	if (XUsbPs_dTDsRequired(BufferLen) >=
+			InstancePtr->DeviceConfig.EpCfg[EpNum].In.NumBufs) {
+		return XST_USB_BUF_TOO_BIG;
 	}
 
-	/* Remember the current head. */
-	DescPtr = Ep->dTDHead;
+	/* Wait behind the buffers already queued, or for free descriptors. */
+	if ((0 != Ep->TxQueueCount) ||
+		!XUsbPs_EpInHasFreedTDs(Ep, XUsbPs_dTDsRequired(BufferLen))) {
+		return XUsbPs_EpInQueueReq(Ep, BufferPtr, BufferLen);
+	}
 
-	do {
-		Length = (BufferLen > XUSBPS_dTD_BUF_MAX_SIZE) ? XUSBPS_dTD_BUF_MAX_SIZE : BufferLen;
-		/* Attach the provided buffer to the current descriptor.*/
-		Status = XUsbPs_dTDAttachBuffer(Ep->dTDHead, BufferPtr, Length);
-		if (XST_SUCCESS != Status) {
-			return XST_FAILURE;
-		}
-		BufferLen -= Length;
-		BufferPtr += Length;
+	Xil_DCacheFlushRange((unsigned int)BufferPtr, BufferLen);
 
-		XUsbPs_dTDSetActive(Ep->dTDHead);
-		if(BufferLen == 0)
-			XUsbPs_dTDSetIOC(Ep->dTDHead);
-		XUsbPs_dTDClrTerminate(Ep->dTDHead);
-		XUsbPs_dTDFlushCache(Ep->dTDHead);
+	/* Remember the current head. */
+	DescPtr = Ep->dTDHead;
 
-		/* Advance the head descriptor pointer to the next descriptor. */
-		Ep->dTDHead = XUsbPs_dTDGetNLP(Ep->dTDHead);
-		/* Terminate the next descriptor and flush the cache.*/
-		XUsbPs_dTDInvalidateCache(Ep->dTDHead);
-		/* Tell the caller if we do not have any descriptors available. */
-		if (XUsbPs_dTDIsActive(Ep->dTDHead)) {
-			return XST_USB_NO_DESC_AVAILABLE;
-		}
-	} while(BufferLen);
+	Status = XUsbPs_EpQueueIn(Ep, BufferPtr, BufferLen, TRUE, NULL);
+	if (XST_SUCCESS != Status) {
+		return Status;
+	}
 
 	XUsbPs_dTDSetTerminate(Ep->dTDHead);
 	XUsbPs_dTDFlushCache(Ep->dTDHead);
 
-	if(!PipeEmpty) {
-		/* Read the endpoint prime register. */
-		RegValue = XUsbPs_ReadReg(InstancePtr->Config.BaseAddress, XUSBPS_EPPRIME_OFFSET);
-		if(RegValue & BitMask) {
-			return XST_SUCCESS;
+	return XUsbPs_EpInStart(InstancePtr, EpNum, DescPtr, PipeEmpty);
+}
+
+/*****************************************************************************/
+/**
+* This function queues a list of data buffers on an IN endpoint and hands
+* all of them to the controller with a single prime.
+*
+* All buffers are chained into the descriptor ring back to back before the
+* endpoint is primed (or, if the endpoint is already running, before the
+* chain is appended with the ATDTW tripwire), so the controller can move from
+* one buffer to the next without software intervention. Only the last
+* descriptor of the chain requests an interrupt on completion; the TX
+* complete handler then reports all buffers of the batch in one pass.
+*
+* @param	InstancePtr is a pointer to XUsbPs instance of the controller.
+* @param	EpNum is the number of the endpoint to send data on.
+* @param	BufferList is an array of pointers to the buffers to send.
+* @param	LenList is an array holding the length of each buffer.
+* @param	NumBuffers is the number of entries in BufferList and LenList.
+* @param	NumQueuedPtr (OUT param) returns how many buffers, starting
+*		with the first one, have been accepted. May be NULL.
+*
+* @return
+*		- XST_SUCCESS: All buffers have been accepted.
+*		- XST_FAILURE: An error occured.
+*		- XST_USB_BUF_TOO_BIG: A buffer needs more descriptors than
+*		  the ring has.
+*		- XST_USB_NO_DESC_AVAILABLE: The ring and the queue of waiting
+*		  buffers are both full.
+*		  The first *NumQueuedPtr buffers have been accepted, the
+*		  remaining ones have to be submitted again later.
+*
+* @note		A single buffer may be larger than 16kB, it is split over
+*		multiple descriptors. Each buffer is flushed from the data
+*		cache individually, so the cost of the cache maintenance only
+*		depends on the amount of data sent. Buffers that do not fit
+*		into the ring wait in the queue of the endpoint, as for
+*		XUsbPs_EpBufferSend().
+*
+******************************************************************************/
+int XUsbPs_EpBufferSendMulti(XUsbPs *InstancePtr, u8 EpNum,
+				const u8 **BufferList, const u32 *LenList,
+				u32 NumBuffers, u32 *NumQueuedPtr)
+{
+	int		Status = XST_SUCCESS;
+	XUsbPs_EpIn	*Ep;
+	XUsbPs_dTD	*DescPtr;
+	XUsbPs_dTD	*LastPtr = NULL;
+	u32		PipeEmpty = 1;
+	u32		Index;
+
+	Xil_AssertNonvoid(InstancePtr  != NULL);
+	Xil_AssertNonvoid(BufferList   != NULL);
+	Xil_AssertNonvoid(LenList      != NULL);
+	Xil_AssertNonvoid(EpNum < InstancePtr->DeviceConfig.NumEndpoints);
+
+	Ep = &InstancePtr->DeviceConfig.Ep[EpNum].In;
+
+	if(Ep->dTDTail != Ep->dTDHead) {
+		PipeEmpty = 0;
+	}
+
+	DescPtr = Ep->dTDHead;
+
+	for (Index = 0; Index < NumBuffers; Index++) {
+		if (XUsbPs_dTDsRequired(LenList[Index]) >=
+			InstancePtr->DeviceConfig.EpCfg[EpNum].In.NumBufs) {
+			Status = XST_USB_BUF_TOO_BIG;
+			break;
 		}
 
-		do {
-			RegValue = XUsbPs_ReadReg(InstancePtr->Config.BaseAddress, XUSBPS_CMD_OFFSET);
-			XUsbPs_WriteReg(InstancePtr->Config.BaseAddress, XUSBPS_CMD_OFFSET,
-						RegValue | XUSBPS_CMD_ATDTW_MASK);
-			Temp = XUsbPs_ReadReg(InstancePtr->Config.BaseAddress, XUSBPS_EPRDY_OFFSET)
-						& BitMask;
-		} while(!(XUsbPs_ReadReg(InstancePtr->Config.BaseAddress, XUSBPS_CMD_OFFSET) &
-				XUSBPS_CMD_ATDTW_MASK));
+		if ((0 != Ep->TxQueueCount) ||
+			!XUsbPs_EpInHasFreedTDs(Ep,
+				XUsbPs_dTDsRequired(LenList[Index]))) {
+			Status = XUsbPs_EpInQueueReq(Ep, BufferList[Index],
+							LenList[Index]);
+			if (XST_SUCCESS != Status) {
+				break;
+			}
+			continue;
+		}
 
-		RegValue = XUsbPs_ReadReg(InstancePtr->Config.BaseAddress, XUSBPS_CMD_OFFSET);
-		XUsbPs_WriteReg(InstancePtr->Config.BaseAddress, XUSBPS_CMD_OFFSET,
-					RegValue & ~XUSBPS_CMD_ATDTW_MASK);
+		Xil_DCacheFlushRange((unsigned int)BufferList[Index],
+					LenList[Index]);
 
-		if(Temp) {
-			return XST_SUCCESS;
+		/* Interrupt on complete is only requested for the last
+		 * descriptor of the batch, see below.
+		 */
+		if (XST_SUCCESS != XUsbPs_EpQueueIn(Ep, BufferList[Index],
+					LenList[Index], FALSE, &LastPtr)) {
+			Status = XST_FAILURE;
+			break;
 		}
 	}
 
-	/* Check, if the DMA engine is still running. If it is running, we do
-	 * not clear Queue Head fields.
-	 *
-	 * Same cache rule as for the Transfer Descriptor applies for the Queue
-	 * Head.
-	 */
-	XUsbPs_dQHInvalidateCache(Ep->dQH);
-	/* Add the dTD to the dQH */
-	XUsbPs_WritedQH(Ep->dQH, XUSBPS_dQHdTDNLP, DescPtr);
-	Token = XUsbPs_ReaddQH(Ep->dQH, XUSBPS_dQHdTDTOKEN);
-	Token &= ~(XUSBPS_dTDTOKEN_ACTIVE_MASK | XUSBPS_dTDTOKEN_HALT_MASK);
-	XUsbPs_WritedQH(Ep->dQH, XUSBPS_dQHdTDTOKEN, Token);
-
-	XUsbPs_dQHFlushCache(Ep->dQH);
+	if (NULL != NumQueuedPtr) {
+		*NumQueuedPtr = Index;
+	}
 
-	Status = XUsbPs_EpPrime(InstancePtr, EpNum, XUSBPS_EP_DIRECTION_IN);
+	if (XST_SUCCESS != XUsbPs_EpInChainDone(InstancePtr, EpNum, DescPtr,
+						LastPtr, PipeEmpty)) {
+		return XST_FAILURE;
+	}
 
 	return Status;
 }
 
+/*****************************************************************************/
+/**
+* This function moves buffers waiting in the queue of an IN endpoint into the
+* descriptor ring, as far as there are free descriptors, and primes them
+* with a single prime. It is called by the TX complete interrupt handler
+* after the completed descriptors have been reaped.
+*
+* @param	InstancePtr is a pointer to XUsbPs instance of the controller.
+* @param	EpNum is the number of the endpoint.
+*
+* @return	None.
+*
+******************************************************************************/
+void XUsbPs_EpInDrainQueue(XUsbPs *InstancePtr, u8 EpNum)
+{
+	XUsbPs_EpIn	*Ep;
+	XUsbPs_EpTxReq	*Req;
+	XUsbPs_dTD	*DescPtr;
+	XUsbPs_dTD	*LastPtr = NULL;
+	u32		PipeEmpty = 1;
+
+	Ep = &InstancePtr->DeviceConfig.Ep[EpNum].In;
+
+	if(Ep->dTDTail != Ep->dTDHead) {
+		PipeEmpty = 0;
+	}
+
+	DescPtr = Ep->dTDHead;
+
+	while (0 != Ep->TxQueueCount) {
+		Req = &Ep->TxQueue[Ep->TxQueueHead];
+
+		if (!XUsbPs_EpInHasFreedTDs(Ep,
+				XUsbPs_dTDsRequired(Req->BufferLen))) {
+			break;
+		}
+
+		Xil_DCacheFlushRange((unsigned int)Req->BufferPtr,
+					Req->BufferLen);
+
+		if (XST_SUCCESS != XUsbPs_EpQueueIn(Ep, Req->BufferPtr,
+					Req->BufferLen, FALSE, &LastPtr)) {
+			break;
+		}
+
+		Ep->TxQueueHead = (Ep->TxQueueHead + 1) %
+						XUSBPS_EP_TX_QUEUE_LEN;
+		Ep->TxQueueCount--;
+	}
+
+	XUsbPs_EpInChainDone(InstancePtr, EpNum, DescPtr, LastPtr, PipeEmpty);
+}
+
 /*****************************************************************************/
 /**
  * This function receives a data buffer from the endpoint of the given endpoint
@@ -429,6 +553,190 @@ void XUsbPs_EpBufferRelease(u32 Handle)
 }
 
 
+/*****************************************************************************/
+/**
+ * This function switches an OUT endpoint between per-buffer and batched
+ * receive handling.
+ *
+ * In per-buffer mode (the default) the interrupt handler reports every
+ * received buffer with its own XUSBPS_EP_EVENT_DATA_RX event and the buffer
+ * has to be fetched with XUsbPs_EpBufferReceive() from within the handler.
+ *
+ * In batched mode the interrupt handler only signals that data is pending
+ * with a single XUSBPS_EP_EVENT_DATA_RX event per interrupt. The user then
+ * collects all received buffers at once with XUsbPs_EpBufferReceiveMulti()
+ * and may keep them as long as it needs to before handing them back with
+ * XUsbPs_EpBufferReleaseMulti().
+ *
+ * @param	InstancePtr is a pointer to the XUsbPs instance of the
+ *		controller.
+ * @param	EpNum is the number of the OUT endpoint.
+ * @param	Enable selects batched (TRUE) or per-buffer (FALSE) mode.
+ *
+ * @return
+ *		- XST_SUCCESS: The operation completed successfully.
+ *
+ * @note	The mode should only be changed while no buffers of the
+ *		endpoint are held by the user.
+ *
+ ******************************************************************************/
+int XUsbPs_EpSetRxBatchMode(XUsbPs *InstancePtr, u8 EpNum, int Enable)
+{
+	XUsbPs_EpOut	*Ep;
+
+	Xil_AssertNonvoid(InstancePtr  != NULL);
+	Xil_AssertNonvoid(EpNum < InstancePtr->DeviceConfig.NumEndpoints);
+
+	Ep = &InstancePtr->DeviceConfig.Ep[EpNum].Out;
+
+	Ep->RxBatch		= Enable ? TRUE : FALSE;
+	Ep->RxOutstanding	= 0;
+
+	return XST_SUCCESS;
+}
+
+
+/*****************************************************************************/
+/**
+ * This function hands out all buffers that have been received on an OUT
+ * endpoint in batched receive mode, up to a given maximum.
+ *
+ * The buffers are the DMA buffers of the endpoint's descriptor ring, no data
+ * is copied. The received part of every buffer is invalidated in the data
+ * cache before it is handed out. A buffer stays owned by the user until it is
+ * returned with XUsbPs_EpBufferReleaseMulti(); the controller skips it in the
+ * meantime.
+ *
+ * @param	InstancePtr is a pointer to the XUsbPs instance of the
+ *		controller.
+ * @param	EpNum is the number of the endpoint to receive data from.
+ * @param	BufList (OUT param) is an array that is filled with the buffer
+ *		pointer, length and release handle of every received buffer.
+ * @param	MaxBuffers is the number of entries in BufList.
+ * @param	NumReceivedPtr (OUT param) returns the number of entries
+ *		filled in.
+ *
+ * @return
+ *		- XST_SUCCESS: At least one buffer has been received.
+ *		- XST_USB_NO_BUF: No buffer available.
+ *
+ ******************************************************************************/
+int XUsbPs_EpBufferReceiveMulti(XUsbPs *InstancePtr, u8 EpNum,
+				XUsbPs_EpRxBuf *BufList, u32 MaxBuffers,
+				u32 *NumReceivedPtr)
+{
+	XUsbPs_EpOut	*Ep;
+	XUsbPs_EpSetup	*EpSetup;
+	u32		Count = 0;
+	u8		*BufferPtr;
+	u32		Length;
+
+	Xil_AssertNonvoid(InstancePtr    != NULL);
+	Xil_AssertNonvoid(BufList        != NULL);
+	Xil_AssertNonvoid(NumReceivedPtr != NULL);
+	Xil_AssertNonvoid(EpNum < InstancePtr->DeviceConfig.NumEndpoints);
+
+	Ep	= &InstancePtr->DeviceConfig.Ep[EpNum].Out;
+	EpSetup	= &InstancePtr->DeviceConfig.EpCfg[EpNum].Out;
+
+	/* Once all buffers of the ring are held by the user the descriptor
+	 * at dTDCurr is an old one that has not been released yet.
+	 */
+	while ((Count < MaxBuffers) &&
+			(Ep->RxOutstanding < EpSetup->NumBufs)) {
+		XUsbPs_dTDInvalidateCache(Ep->dTDCurr);
+
+		if (XUsbPs_dTDIsActive(Ep->dTDCurr)) {
+			break;
+		}
+
+		BufferPtr = (u8 *) XUsbPs_ReaddTD(Ep->dTDCurr,
+						XUSBPS_dTDUSERDATA);
+		Length = EpSetup->BufSize -
+				XUsbPs_dTDGetTransferLen(Ep->dTDCurr);
+
+		Xil_DCacheInvalidateRange((unsigned int)BufferPtr, Length);
+
+		BufList[Count].BufferPtr	= BufferPtr;
+		BufList[Count].Length		= Length;
+		BufList[Count].Handle		= (u32) Ep->dTDCurr;
+
+		/* Restore the descriptor for the next transfer, it is only
+		 * re-activated when the buffer is released.
+		 */
+		XUsbPs_WritedTD(Ep->dTDCurr, XUSBPS_dTDBPTR0, BufferPtr);
+		XUsbPs_dTDSetTransferLen(Ep->dTDCurr, EpSetup->BufSize);
+		XUsbPs_dTDFlushCache(Ep->dTDCurr);
+
+		Ep->RxOutstanding++;
+		Ep->dTDCurr = XUsbPs_dTDGetNLP(Ep->dTDCurr);
+		Count++;
+	}
+
+	*NumReceivedPtr = Count;
+
+	return (Count > 0) ? XST_SUCCESS : XST_USB_NO_BUF;
+}
+
+
+/*****************************************************************************/
+/**
+ * This function returns a list of buffers obtained with
+ * XUsbPs_EpBufferReceiveMulti() to the driver and re-primes the endpoint once
+ * for the whole list.
+ *
+ * @param	InstancePtr is a pointer to the XUsbPs instance of the
+ *		controller.
+ * @param	EpNum is the number of the endpoint the buffers belong to.
+ * @param	HandleList is an array with the handles of the buffers.
+ * @param	NumHandles is the number of entries in HandleList.
+ *
+ * @return
+ *		- XST_SUCCESS: The operation completed successfully.
+ *		- XST_INVALID_PARAM: Invalid parameter passed.
+ *
+ ******************************************************************************/
+int XUsbPs_EpBufferReleaseMulti(XUsbPs *InstancePtr, u8 EpNum,
+				const u32 *HandleList, u32 NumHandles)
+{
+	XUsbPs_EpOut	*Ep;
+	XUsbPs_dTD	*dTDPtr;
+	u32		Index;
+
+	Xil_AssertNonvoid(InstancePtr  != NULL);
+	Xil_AssertNonvoid(HandleList   != NULL);
+	Xil_AssertNonvoid(EpNum < InstancePtr->DeviceConfig.NumEndpoints);
+
+	Ep = &InstancePtr->DeviceConfig.Ep[EpNum].Out;
+
+	for (Index = 0; Index < NumHandles; Index++) {
+		if ((0 == HandleList[Index]) ||
+				(0 != (HandleList[Index] % XUSBPS_dTD_ALIGN))) {
+			return XST_INVALID_PARAM;
+		}
+
+		dTDPtr = (XUsbPs_dTD *) HandleList[Index];
+
+		XUsbPs_dTDInvalidateCache(dTDPtr);
+
+		XUsbPs_dTDClrTerminate(dTDPtr);
+		XUsbPs_dTDSetActive(dTDPtr);
+		XUsbPs_dTDSetIOC(dTDPtr);
+
+		XUsbPs_dTDFlushCache(dTDPtr);
+
+		if (Ep->RxOutstanding > 0) {
+			Ep->RxOutstanding--;
+		}
+	}
+
+	/* The controller stops on the first descriptor that is still held by
+	 * the user. Prime the endpoint so it picks up the released ones.
+	 */
+	return XUsbPs_EpPrime(InstancePtr, EpNum, XUSBPS_EP_DIRECTION_OUT);
+}
+
+
 /*****************************************************************************/
 /**
  * This function sets the handler for endpoint events.
@@ -715,6 +1023,8 @@ static void XUsbPs_EpListInit(XUsbPs_DeviceConfig *DevCfgPtr)
 			Ep[EpNum].In.dTDs		= (XUsbPs_dTD *) p;
 			Ep[EpNum].In.dTDHead	= (XUsbPs_dTD *) p;
 			Ep[EpNum].In.dTDTail	= (XUsbPs_dTD *) p;
+			Ep[EpNum].In.TxQueueHead	= 0;
+			Ep[EpNum].In.TxQueueCount	= 0;
 			p += XUSBPS_dTD_ALIGN * EpCfg[EpNum].In.NumBufs;
 		}
 	}
@@ -746,11 +1056,14 @@ static void XUsbPs_EpListInit(XUsbPs_DeviceConfig *DevCfgPtr)
 	}
 
 
-	/* Initialize the endpoint event handlers to NULL.
+	/* Initialize the endpoint event handlers to NULL and start all OUT
+	 * endpoints in per-buffer receive mode.
 	 */
 	for (EpNum = 0; EpNum < DevCfgPtr->NumEndpoints; ++EpNum) {
 		Ep[EpNum].Out.HandlerFunc = NULL;
 		Ep[EpNum].In.HandlerFunc  = NULL;
+		Ep[EpNum].Out.RxBatch		= FALSE;
+		Ep[EpNum].Out.RxOutstanding	= 0;
 	}
 }
 
@@ -1054,6 +1367,287 @@ static int XUsbPs_dTDAttachBuffer(XUsbPs_dTD *dTDPtr,
 }
 
 
+/*****************************************************************************/
+/**
+ *
+ * This function returns the number of Transfer Descriptors needed to send a
+ * buffer of the given length.
+ *
+ * @param	BufferLen is the length of the buffer.
+ *
+ * @return	Number of descriptors, at least one for a 0-length buffer.
+ *
+ ******************************************************************************/
+static u32 XUsbPs_dTDsRequired(u32 BufferLen)
+{
+	if (0 == BufferLen) {
+		return 1;
+	}
+
+	return (BufferLen + XUSBPS_dTD_BUF_MAX_SIZE - 1) /
+						XUSBPS_dTD_BUF_MAX_SIZE;
+}
+
+
+/*****************************************************************************/
+/**
+ *
+ * This function checks whether the IN descriptor ring has a given number of
+ * free descriptors starting at the head. One more descriptor is required to
+ * terminate the chain.
+ *
+ * The free descriptors are the ones from dTDHead up to dTDTail. Descriptors
+ * from dTDTail to dTDHead are in flight or have completed without being
+ * reaped by the TX complete handler yet, they are not free even when their
+ * active bit is clear.
+ *
+ * @param	Ep is a pointer to the IN endpoint.
+ * @param	NumdTDs is the number of descriptors needed.
+ *
+ * @return	TRUE if enough descriptors are available, FALSE otherwise.
+ *
+ ******************************************************************************/
+static int XUsbPs_EpInHasFreedTDs(XUsbPs_EpIn *Ep, u32 NumdTDs)
+{
+	XUsbPs_dTD	*dTDPtr = Ep->dTDHead;
+	u32		Count;
+
+	/* The descriptor after the last one used terminates the chain, it
+	 * must not be dTDTail either, or a full ring would look empty.
+	 */
+	for (Count = 0; Count < NumdTDs; Count++) {
+		dTDPtr = XUsbPs_dTDGetNLP(dTDPtr);
+
+		if (dTDPtr == Ep->dTDTail) {
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+
+/*****************************************************************************/
+/**
+ *
+ * This function appends a buffer to the queue of buffers that wait for free
+ * descriptors on an IN endpoint.
+ *
+ * @param	Ep is a pointer to the IN endpoint.
+ * @param	BufferPtr is a pointer to the buffer to send.
+ * @param	BufferLen is the length of the buffer.
+ *
+ * @return
+ *		- XST_SUCCESS: The buffer is queued.
+ *		- XST_USB_NO_DESC_AVAILABLE: The queue is full.
+ *
+ ******************************************************************************/
+static int XUsbPs_EpInQueueReq(XUsbPs_EpIn *Ep, const u8 *BufferPtr,
+				u32 BufferLen)
+{
+	XUsbPs_EpTxReq	*Req;
+
+	if (Ep->TxQueueCount == XUSBPS_EP_TX_QUEUE_LEN) {
+		return XST_USB_NO_DESC_AVAILABLE;
+	}
+
+	Req = &Ep->TxQueue[(Ep->TxQueueHead + Ep->TxQueueCount) %
+						XUSBPS_EP_TX_QUEUE_LEN];
+	Req->BufferPtr = BufferPtr;
+	Req->BufferLen = BufferLen;
+	Ep->TxQueueCount++;
+
+	return XST_SUCCESS;
+}
+
+
+/*****************************************************************************/
+/**
+ *
+ * This function attaches a buffer to the descriptors at the head of the IN
+ * ring and activates them. Buffers bigger than 16kB are split over multiple
+ * descriptors. The descriptors are not handed to the controller, that is
+ * done by XUsbPs_EpInStart().
+ *
+ * @param	Ep is a pointer to the IN endpoint.
+ * @param	BufferPtr is a pointer to the buffer to send.
+ * @param	BufferLen is the length of the buffer.
+ * @param	SetIOC requests an interrupt on completion of the last
+ *		descriptor of the buffer.
+ * @param	LastPtr (OUT param) returns the last descriptor used for the
+ *		buffer. May be NULL.
+ *
+ * @return
+ *		- XST_SUCCESS: The operation completed successfully.
+ *		- XST_FAILURE: An error occured.
+ *
+ * @note	The caller has to make sure with XUsbPs_EpInHasFreedTDs() that
+ *		enough descriptors are available.
+ *
+ ******************************************************************************/
+static int XUsbPs_EpQueueIn(XUsbPs_EpIn *Ep, const u8 *BufferPtr,
+				u32 BufferLen, int SetIOC, XUsbPs_dTD **LastPtr)
+{
+	int	Status;
+	u32	Length;
+
+	do {
+		Length = (BufferLen > XUSBPS_dTD_BUF_MAX_SIZE) ?
+					XUSBPS_dTD_BUF_MAX_SIZE : BufferLen;
+
+		/* Start from a clean token, a recycled descriptor may still
+		 * carry the IOC and status bits of its previous transfer.
+		 */
+		XUsbPs_WritedTD(Ep->dTDHead, XUSBPS_dTDTOKEN, 0);
+
+		/* Attach the provided buffer to the current descriptor.*/
+		Status = XUsbPs_dTDAttachBuffer(Ep->dTDHead, BufferPtr, Length);
+		if (XST_SUCCESS != Status) {
+			return XST_FAILURE;
+		}
+		BufferLen -= Length;
+		BufferPtr += Length;
+
+		XUsbPs_dTDSetActive(Ep->dTDHead);
+		if ((BufferLen == 0) && SetIOC) {
+			XUsbPs_dTDSetIOC(Ep->dTDHead);
+		}
+		XUsbPs_dTDClrTerminate(Ep->dTDHead);
+		XUsbPs_dTDFlushCache(Ep->dTDHead);
+
+		if (NULL != LastPtr) {
+			*LastPtr = Ep->dTDHead;
+		}
+
+		/* Advance the head descriptor pointer to the next descriptor. */
+		Ep->dTDHead = XUsbPs_dTDGetNLP(Ep->dTDHead);
+		XUsbPs_dTDInvalidateCache(Ep->dTDHead);
+	} while(BufferLen);
+
+	return XST_SUCCESS;
+}
+
+
+/*****************************************************************************/
+/**
+ *
+ * This function finishes a chain built with XUsbPs_EpQueueIn() without
+ * interrupt on complete: the last descriptor requests the interrupt, the
+ * descriptor at the head terminates the chain and the chain is started.
+ *
+ * @param	InstancePtr is a pointer to XUsbPs instance of the controller.
+ * @param	EpNum is the number of the endpoint.
+ * @param	DescPtr is the first descriptor of the chain.
+ * @param	LastPtr is the last descriptor of the chain, NULL if nothing
+ *		has been queued.
+ * @param	PipeEmpty is non zero if no descriptors were pending before
+ *		the chain was queued.
+ *
+ * @return
+ *		- XST_SUCCESS: The operation completed successfully.
+ *		- XST_INVALID_PARAM: Invalid parameter passed.
+ *
+ ******************************************************************************/
+static int XUsbPs_EpInChainDone(XUsbPs *InstancePtr, u8 EpNum,
+				XUsbPs_dTD *DescPtr, XUsbPs_dTD *LastPtr,
+				u32 PipeEmpty)
+{
+	XUsbPs_EpIn	*Ep;
+
+	/* Nothing has been queued, leave the ring alone. */
+	if (NULL == LastPtr) {
+		return XST_SUCCESS;
+	}
+
+	Ep = &InstancePtr->DeviceConfig.Ep[EpNum].In;
+
+	XUsbPs_dTDInvalidateCache(LastPtr);
+	XUsbPs_dTDSetIOC(LastPtr);
+	XUsbPs_dTDFlushCache(LastPtr);
+
+	XUsbPs_dTDSetTerminate(Ep->dTDHead);
+	XUsbPs_dTDFlushCache(Ep->dTDHead);
+
+	return XUsbPs_EpInStart(InstancePtr, EpNum, DescPtr, PipeEmpty);
+}
+
+
+/*****************************************************************************/
+/**
+ *
+ * This function hands a chain of activated IN descriptors to the controller.
+ * If the endpoint is still processing earlier descriptors the chain has
+ * already been linked in and the ATDTW tripwire is used to find out whether
+ * the controller picked it up. Otherwise the chain is written to the Queue
+ * Head and the endpoint is primed.
+ *
+ * @param	InstancePtr is a pointer to XUsbPs instance of the controller.
+ * @param	EpNum is the number of the endpoint.
+ * @param	DescPtr is the first descriptor of the new chain.
+ * @param	PipeEmpty is non zero if no descriptors were pending before
+ *		the chain was queued.
+ *
+ * @return
+ *		- XST_SUCCESS: The operation completed successfully.
+ *		- XST_INVALID_PARAM: Invalid parameter passed.
+ *
+ ******************************************************************************/
+static int XUsbPs_EpInStart(XUsbPs *InstancePtr, u8 EpNum,
+				XUsbPs_dTD *DescPtr, u32 PipeEmpty)
+{
+	XUsbPs_EpIn	*Ep;
+	u32		Token;
+	u32		Mask = 0x00010000;
+	u32		BitMask = Mask << EpNum;
+	u32		RegValue;
+	u32		Temp;
+
+	Ep = &InstancePtr->DeviceConfig.Ep[EpNum].In;
+
+	if(!PipeEmpty) {
+		/* Read the endpoint prime register. */
+		RegValue = XUsbPs_ReadReg(InstancePtr->Config.BaseAddress, XUSBPS_EPPRIME_OFFSET);
+		if(RegValue & BitMask) {
+			return XST_SUCCESS;
+		}
+
+		do {
+			RegValue = XUsbPs_ReadReg(InstancePtr->Config.BaseAddress, XUSBPS_CMD_OFFSET);
+			XUsbPs_WriteReg(InstancePtr->Config.BaseAddress, XUSBPS_CMD_OFFSET,
+						RegValue | XUSBPS_CMD_ATDTW_MASK);
+			Temp = XUsbPs_ReadReg(InstancePtr->Config.BaseAddress, XUSBPS_EPRDY_OFFSET)
+						& BitMask;
+		} while(!(XUsbPs_ReadReg(InstancePtr->Config.BaseAddress, XUSBPS_CMD_OFFSET) &
+				XUSBPS_CMD_ATDTW_MASK));
+
+		RegValue = XUsbPs_ReadReg(InstancePtr->Config.BaseAddress, XUSBPS_CMD_OFFSET);
+		XUsbPs_WriteReg(InstancePtr->Config.BaseAddress, XUSBPS_CMD_OFFSET,
+					RegValue & ~XUSBPS_CMD_ATDTW_MASK);
+
+		if(Temp) {
+			return XST_SUCCESS;
+		}
+	}
+
+	/* Check, if the DMA engine is still running. If it is running, we do
+	 * not clear Queue Head fields.
+	 *
+	 * Same cache rule as for the Transfer Descriptor applies for the Queue
+	 * Head.
+	 */
+	XUsbPs_dQHInvalidateCache(Ep->dQH);
+	/* Add the dTD to the dQH */
+	XUsbPs_WritedQH(Ep->dQH, XUSBPS_dQHdTDNLP, DescPtr);
+	Token = XUsbPs_ReaddQH(Ep->dQH, XUSBPS_dQHdTDTOKEN);
+	Token &= ~(XUSBPS_dTDTOKEN_ACTIVE_MASK | XUSBPS_dTDTOKEN_HALT_MASK);
+	XUsbPs_WritedQH(Ep->dQH, XUSBPS_dQHdTDTOKEN, Token);
+
+	XUsbPs_dQHFlushCache(Ep->dQH);
+
+	return XUsbPs_EpPrime(InstancePtr, EpNum, XUSBPS_EP_DIRECTION_IN);
+}
+
+
 /*****************************************************************************/
 /**
  * This function set the Max PacketLen for the queue head for isochronous EP.
@@ -1157,6 +1751,7 @@ int XUsbPs_ReconfigureEp(XUsbPs *InstancePtr, XUsbPs_DeviceConfig *CfgPtr,
 	 */
 	if(NewDirection == XUSBPS_EP_DIRECTION_IN) {
 		Ep[EpNum].In.dTDHead = Ep[EpNum].In.dTDTail = Ep[EpNum].In.dTDs;
+		Ep[EpNum].In.TxQueueHead = Ep[EpNum].In.TxQueueCount = 0;
 	} else if(NewDirection == XUSBPS_EP_DIRECTION_OUT) {
 		Ep[EpNum].Out.dTDCurr = Ep[EpNum].Out.dTDs;
 	}
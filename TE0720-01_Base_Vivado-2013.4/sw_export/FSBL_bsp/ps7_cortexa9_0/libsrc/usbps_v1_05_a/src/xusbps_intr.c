@@ -53,6 +53,9 @@
  * 1.00a jz  10/10/10 First release
  * 1.03a nm  09/21/12 Fixed CR#678977. Added proper sequence for setup packet
  *                    handling.
+ * 1.05a te  10/16/26 Endpoints in batched receive mode get one RX event per
+ *                    interrupt.
+ *                    Queued IN buffers are primed after the TX reap.
  * </pre>
  ******************************************************************************/
 
@@ -297,6 +300,13 @@ static void XUsbPs_IntrHandleTX(XUsbPs *InstancePtr, u32 EpCompl)
 
 			Ep->dTDTail = XUsbPs_dTDGetNLP(Ep->dTDTail);
 		}
+
+		/* Reaping freed descriptors, move waiting buffers into the
+		 * ring.
+		 */
+		if (0 != Ep->TxQueueCount) {
+			XUsbPs_EpInDrainQueue(InstancePtr, Index);
+		}
 	}
 }
 
@@ -340,6 +350,21 @@ static void XUsbPs_IntrHandleRX(XUsbPs *InstancePtr, u32 EpCompl)
 
 		XUsbPs_dTDInvalidateCache(Ep->dTDCurr);
 
+		/* In batched mode the buffers are collected by the user with
+		 * XUsbPs_EpBufferReceiveMulti(), which also advances dTDCurr.
+		 * A single notification is enough.
+		 */
+		if (Ep->RxBatch) {
+			if (Ep->HandlerFunc &&
+					!XUsbPs_dTDIsActive(Ep->dTDCurr)) {
+				Ep->HandlerFunc(Ep->HandlerRef, Index,
+						XUSBPS_EP_EVENT_DATA_RX, NULL);
+			}
+			XUsbPs_EpPrime(InstancePtr, Index,
+					XUSBPS_EP_DIRECTION_OUT);
+			continue;
+		}
+
 		/* Handle all finished dTDs */
 		while (!XUsbPs_dTDIsActive(Ep->dTDCurr)) {
 			numP += 1;
@@ -0,0 +1,777 @@
+/******************************************************************************
+*
+* lz4pack.c
+*
+* Host side packer for the LZ4 compressed partitions of the FSBL
+* (LZ4_SUPPORT). Reads a BOOT.BIN, compresses its plain PS partitions into
+* the stream format of lz4.h and writes the image back with the compressed
+* attribute set, the partition lengths and header checksums updated and
+* the MD5 checksums recomputed over the stored bytes. The partitions and
+* checksums behind the first compressed partition are moved down so that
+* the image gets shorter. The FSBL, bitstreams, encrypted partitions and
+* images with RSA authentication are left alone.
+*
+* The compressor is a hash chain LZ4 encoder. Blocks are linked: a match
+* may refer back up to 64KB into the previous blocks. A block that does
+* not get smaller is stored uncompressed.
+*
+* With -t the files given are compressed and decoded again with the block
+* decoder of the FSBL (FSBL/src/lz4.c) in the same loop as
+* MoveCompressedPartition(). For ELF files the PT_LOAD segments are used,
+* which is what bootgen stores. The test prints the ratio, the host decode
+* rate and the decode rate the target needs for the compressed image to
+* load faster at a boot device read rate of -r MB/s. It then decodes
+* corrupted copies of every stream to check that the decoder stays within
+* its buffers.
+*
+* Build: gcc -O2 -DLZ4_SUPPORT -o lz4pack lz4pack.c ../../FSBL/src/lz4.c
+*		 -I../../FSBL/src -I../../FSBL_bsp/ps7_cortexa9_0/include
+*
+* Usage: lz4pack [-b <block KB>] [-p <partition>]... <BOOT.BIN> <out.bin>
+*		 lz4pack -t [-b <block KB>] [-n <loops>] [-r <MB/s>] <file> ...
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "xstatus.h"
+#include "lz4.h"
+
+#define PT_LOAD			1
+
+#define BOOT_FSBL_OFFSET	0x30
+#define BOOT_PHDR_OFFSET	0x9C
+#define PHDR_LEN		0x40
+#define PHDR_WORDS		16
+#define MAX_PARTITIONS		14
+
+#define PH_IMAGE_LEN		0
+#define PH_DATA_LEN		1
+#define PH_PART_LEN		2
+#define PH_LOAD_ADDR		3
+#define PH_START		5
+#define PH_ATTR			6
+#define PH_CSUM_OFFSET		8
+#define PH_AC_OFFSET		10
+#define PH_CHECKSUM		15
+
+#define ATTR_PS			0x10
+#define ATTR_CHECKSUM		0x7000
+#define ATTR_RSA		0x8000
+#define ATTR_COMPRESSED		0x100000	/* ATTRIBUTE_COMPRESSED_MASK */
+
+#define PART_ALIGN		64
+#define MD5_LEN			16
+
+#define HASH_LOG		16
+#define CHAIN_DEPTH		256
+#define MF_LIMIT		12
+#define LAST_LITERALS		5
+#define DEFAULT_BLOCK_KB	64
+#define DEFAULT_LOOPS		20
+#define DEFAULT_RATE		20.0	/* MB/s, polled quad SPI */
+#define FUZZ_RUNS		200
+
+typedef struct {
+	unsigned long Offset;
+	unsigned long Length;
+	int Part;
+	int IsChecksum;
+} Extent;
+
+typedef struct {
+	unsigned long Words[PHDR_WORDS];
+	unsigned char *Data;	/* Stored bytes when packed */
+	unsigned long DataLen;
+} Partition;
+
+static unsigned long BlockSize = DEFAULT_BLOCK_KB * 1024;
+static int *Head;
+static int *Chain;
+
+static unsigned long Get32(const unsigned char *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+static void Put32(unsigned char *p, unsigned long Val)
+{
+	p[0] = Val & 0xFF;
+	p[1] = (Val >> 8) & 0xFF;
+	p[2] = (Val >> 16) & 0xFF;
+	p[3] = (Val >> 24) & 0xFF;
+}
+
+static double Now(void)
+{
+	struct timespec Ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+	return Ts.tv_sec + Ts.tv_nsec * 1e-9;
+}
+
+static unsigned char *ReadFile(const char *Path, unsigned long *LenPtr)
+{
+	FILE *Fp;
+	unsigned char *Buf;
+	long Len;
+
+	Fp = fopen(Path, "rb");
+	if (Fp == NULL) {
+		perror(Path);
+		return NULL;
+	}
+	fseek(Fp, 0, SEEK_END);
+	Len = ftell(Fp);
+	fseek(Fp, 0, SEEK_SET);
+
+	Buf = malloc(Len > 0 ? Len : 1);
+	if ((Buf == NULL) || (fread(Buf, 1, Len, Fp) != (size_t)Len)) {
+		fprintf(stderr, "%s: read failed\n", Path);
+		free(Buf);
+		fclose(Fp);
+		return NULL;
+	}
+	fclose(Fp);
+
+	*LenPtr = Len;
+	return Buf;
+}
+
+/*
+ * MD5 as in RFC 1321, little endian input as the FSBL md5() is called
+ */
+static const unsigned int Md5K[64] = {
+	0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a,
+	0xa8304613, 0xfd469501, 0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+	0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821, 0xf61e2562, 0xc040b340,
+	0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+	0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8,
+	0x676f02d9, 0x8d2a4c8a, 0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+	0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70, 0x289b7ec6, 0xeaa127fa,
+	0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+	0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92,
+	0xffeff47d, 0x85845dd1, 0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+	0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+static const unsigned char Md5R[64] = {
+	7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+	5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+	4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+	6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+};
+
+static void Md5Block(unsigned int *State, const unsigned char *p)
+{
+	unsigned int a = State[0], b = State[1], c = State[2], d = State[3];
+	unsigned int f, t, i, g;
+
+	for (i = 0; i < 64; i++) {
+		if (i < 16) {
+			f = (b & c) | (~b & d);
+			g = i;
+		} else if (i < 32) {
+			f = (d & b) | (~d & c);
+			g = (5 * i + 1) & 15;
+		} else if (i < 48) {
+			f = b ^ c ^ d;
+			g = (3 * i + 5) & 15;
+		} else {
+			f = c ^ (b | ~d);
+			g = (7 * i) & 15;
+		}
+		t = d;
+		d = c;
+		c = b;
+		f += a + Md5K[i] + (unsigned int)Get32(p + 4 * g);
+		b += (f << Md5R[i]) | (f >> (32 - Md5R[i]));
+		a = t;
+	}
+	State[0] += a;
+	State[1] += b;
+	State[2] += c;
+	State[3] += d;
+}
+
+static void Md5(const unsigned char *Buf, unsigned long Len, unsigned char *Out)
+{
+	unsigned int State[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+	unsigned char Tail[128];
+	unsigned long Done, Rest, i;
+
+	for (Done = 0; Len - Done >= 64; Done += 64)
+		Md5Block(State, Buf + Done);
+
+	Rest = Len - Done;
+	memset(Tail, 0, sizeof(Tail));
+	memcpy(Tail, Buf + Done, Rest);
+	Tail[Rest] = 0x80;
+	Rest = (Rest < 56) ? 64 : 128;
+	Put32(Tail + Rest - 8, (Len << 3) & 0xFFFFFFFF);
+	Put32(Tail + Rest - 4, (Len >> 29) & 0xFFFFFFFF);
+	for (i = 0; i < Rest; i += 64)
+		Md5Block(State, Tail + i);
+
+	for (i = 0; i < 4; i++)
+		Put32(Out + 4 * i, State[i]);
+}
+
+static unsigned long Hash(const unsigned char *p)
+{
+	return ((unsigned int)Get32(p) * 2654435761U) >> (32 - HASH_LOG);
+}
+
+static void Insert(const unsigned char *Src, unsigned long Pos)
+{
+	unsigned long h = Hash(Src + Pos);
+
+	Chain[Pos] = Head[h];
+	Head[h] = Pos;
+}
+
+/*
+ * Longest match for Pos within the window, the match may run up to Limit
+ */
+static unsigned long FindMatch(const unsigned char *Src, unsigned long Pos,
+		unsigned long Limit, unsigned long *Offset)
+{
+	unsigned long Best = 0, Len;
+	int Cand, Depth;
+
+	Cand = Head[Hash(Src + Pos)];
+	for (Depth = 0; (Cand >= 0) && (Depth < CHAIN_DEPTH); Depth++) {
+		if (Pos - Cand > LZ4_WINDOW_SIZE)
+			break;
+		if ((Src[Cand + Best] == Src[Pos + Best]) &&
+				(Get32(Src + Cand) == Get32(Src + Pos))) {
+			for (Len = 4; (Pos + Len < Limit) &&
+					(Src[Cand + Len] == Src[Pos + Len]); Len++)
+				;
+			if (Len > Best) {
+				Best = Len;
+				*Offset = Pos - Cand;
+				if (Pos + Len >= Limit)
+					break;
+			}
+		}
+		Cand = Chain[Cand];
+	}
+
+	return (Best >= LZ4_MIN_MATCH) ? Best : 0;
+}
+
+static unsigned char *PutLength(unsigned char *Op, unsigned long Len)
+{
+	for (; Len >= 0xFF; Len -= 0xFF)
+		*Op++ = 0xFF;
+	*Op++ = Len;
+	return Op;
+}
+
+static unsigned char *PutSequence(unsigned char *Op, const unsigned char *Lit,
+		unsigned long LitLen, unsigned long MatchLen, unsigned long Offset)
+{
+	unsigned char *Token = Op++;
+	unsigned long Ml = MatchLen ? MatchLen - LZ4_MIN_MATCH : 0;
+
+	*Token = ((LitLen < LZ4_RUN_MASK) ? LitLen : LZ4_RUN_MASK) << LZ4_ML_BITS;
+	if (LitLen >= LZ4_RUN_MASK)
+		Op = PutLength(Op, LitLen - LZ4_RUN_MASK);
+	memcpy(Op, Lit, LitLen);
+	Op += LitLen;
+	if (MatchLen == 0)
+		return Op;
+
+	*Op++ = Offset & 0xFF;
+	*Op++ = Offset >> 8;
+	*Token |= (Ml < LZ4_ML_MASK) ? Ml : LZ4_ML_MASK;
+	if (Ml >= LZ4_ML_MASK)
+		Op = PutLength(Op, Ml - LZ4_ML_MASK);
+	return Op;
+}
+
+/*
+ * Compresses Src[Start, End) into Out, matches may reach back before Start.
+ * Returns the compressed length.
+ */
+static unsigned long CompressBlock(const unsigned char *Src, unsigned long Start,
+		unsigned long End, unsigned char *Out)
+{
+	unsigned char *Op = Out;
+	unsigned long Pos = Start, Anchor = Start;
+	unsigned long Len, Offset = 0, NextLen, NextOffset = 0;
+	unsigned long MatchLimit = End - LAST_LITERALS;
+
+	while ((End - Start > MF_LIMIT) && (Pos + MF_LIMIT <= End)) {
+		Len = FindMatch(Src, Pos, MatchLimit, &Offset);
+		if (Len == 0) {
+			Insert(Src, Pos++);
+			continue;
+		}
+
+		/*
+		 * One step lazy evaluation
+		 */
+		Insert(Src, Pos);
+		if (Pos + 1 + MF_LIMIT <= End) {
+			NextLen = FindMatch(Src, Pos + 1, MatchLimit, &NextOffset);
+			if (NextLen > Len + 1) {
+				Pos++;
+				Len = NextLen;
+				Offset = NextOffset;
+				Insert(Src, Pos);
+			}
+		}
+
+		Op = PutSequence(Op, Src + Anchor, Pos - Anchor, Len, Offset);
+		for (Len += Pos, Pos++; Pos < Len; Pos++)
+			Insert(Src, Pos);
+		Anchor = Pos;
+	}
+
+	for (; Pos + 4 <= End; Pos++)
+		Insert(Src, Pos);
+	return PutSequence(Op, Src + Anchor, End - Anchor, 0, 0) - Out;
+}
+
+/*
+ * Packs Src into the stream format of lz4.h, padded to a word
+ */
+static unsigned char *Pack(const unsigned char *Src, unsigned long Len,
+		unsigned long *OutLen)
+{
+	unsigned char *Out, *Op;
+	unsigned long Start, End, Packed;
+	unsigned long i;
+
+	Out = malloc(LZ4_STREAM_HDR_LEN + Len + Len / 255 +
+			(Len / BlockSize + 2) * (LZ4_BLOCK_HDR_LEN + 16) + 4);
+	Head = malloc(sizeof(int) << HASH_LOG);
+	Chain = malloc(sizeof(int) * (Len + 1));
+	if ((Out == NULL) || (Head == NULL) || (Chain == NULL)) {
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+	for (i = 0; i < (1UL << HASH_LOG); i++)
+		Head[i] = -1;
+
+	Put32(Out, LZ4_STREAM_MAGIC);
+	Put32(Out + 4, Len);
+	Put32(Out + 8, BlockSize);
+	Put32(Out + 12, 0);
+	Op = Out + LZ4_STREAM_HDR_LEN;
+
+	for (Start = 0; Start < Len; Start = End) {
+		End = (Len - Start > BlockSize) ? Start + BlockSize : Len;
+		Packed = CompressBlock(Src, Start, End, Op + LZ4_BLOCK_HDR_LEN);
+		if (Packed >= End - Start) {
+			memcpy(Op + LZ4_BLOCK_HDR_LEN, Src + Start, End - Start);
+			Packed = End - Start;
+			Put32(Op, Packed | LZ4_BLOCK_RAW_MASK);
+		} else {
+			Put32(Op, Packed);
+		}
+		Op += LZ4_BLOCK_HDR_LEN + Packed;
+	}
+	Put32(Op, 0);
+	Op += LZ4_BLOCK_HDR_LEN;
+	while ((Op - Out) & 3)
+		*Op++ = 0;
+
+	free(Head);
+	free(Chain);
+	*OutLen = Op - Out;
+	return Out;
+}
+
+/*
+ * Decodes a stream the way MoveCompressedPartition() does, returns 0 when
+ * the stream decoded to exactly Dst[0, *DstLen)
+ */
+static int Unpack(const unsigned char *Src, unsigned long SrcLen,
+		unsigned char *Dst, unsigned long *DstLen)
+{
+	u32 Length, Size, OutLen;
+	unsigned long BlockLen, ReadLen, Consumed, Decoded = 0, Dict;
+
+	if ((SrcLen < LZ4_STREAM_HDR_LEN + LZ4_BLOCK_HDR_LEN) ||
+			(Lz4GetStreamInfo(Src, &Length, &Size) != XST_SUCCESS) ||
+			(Length > *DstLen))
+		return -1;
+
+	Consumed = LZ4_STREAM_HDR_LEN + LZ4_BLOCK_HDR_LEN;
+	BlockLen = Get32(Src + LZ4_STREAM_HDR_LEN);
+	while (BlockLen != 0) {
+		ReadLen = (BlockLen & LZ4_BLOCK_LEN_MASK) + LZ4_BLOCK_HDR_LEN;
+		if (((BlockLen & LZ4_BLOCK_LEN_MASK) > Size) ||
+				(ReadLen > SrcLen - Consumed))
+			return -1;
+		if (BlockLen & LZ4_BLOCK_RAW_MASK) {
+			OutLen = BlockLen & LZ4_BLOCK_LEN_MASK;
+			if (OutLen > Length - Decoded)
+				return -1;
+			memcpy(Dst + Decoded, Src + Consumed, OutLen);
+		} else {
+			Dict = (Decoded > LZ4_WINDOW_SIZE) ? LZ4_WINDOW_SIZE : Decoded;
+			if (Lz4DecompressBlock(Src + Consumed, ReadLen - LZ4_BLOCK_HDR_LEN,
+					Dst + Decoded, Length - Decoded, Dict,
+					&OutLen) != XST_SUCCESS)
+				return -1;
+		}
+		Decoded += OutLen;
+		Consumed += ReadLen;
+		BlockLen = Get32(Src + Consumed - LZ4_BLOCK_HDR_LEN);
+	}
+
+	if ((Decoded != Length) || (SrcLen - Consumed >= LZ4_BLOCK_HDR_LEN))
+		return -1;
+	*DstLen = Decoded;
+	return 0;
+}
+
+static int TestData(const char *Name, const unsigned char *Src,
+		unsigned long Len, int Loops, double Rate)
+{
+	unsigned char *Packed, *Out, *Bad;
+	unsigned long PackedLen, OutLen, Pos;
+	double T0, Pack_s, Unpack_s, Need;
+	int Loop, Run, Rejected = 0;
+
+	T0 = Now();
+	Packed = Pack(Src, Len, &PackedLen);
+	Pack_s = Now() - T0;
+
+	Out = malloc(Len + 1);
+	Bad = malloc(PackedLen);
+	if ((Out == NULL) || (Bad == NULL)) {
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+
+	T0 = Now();
+	for (Loop = 0; Loop < Loops; Loop++) {
+		OutLen = Len;
+		if ((Unpack(Packed, PackedLen, Out, &OutLen) != 0) ||
+				(OutLen != Len) || (memcmp(Out, Src, Len) != 0)) {
+			fprintf(stderr, "%s: round trip FAILED\n", Name);
+			return 1;
+		}
+	}
+	Unpack_s = (Now() - T0) / Loops;
+
+	/*
+	 * Corrupted streams must be rejected or decode within the buffer
+	 */
+	srand(1);
+	for (Run = 0; Run < FUZZ_RUNS; Run++) {
+		memcpy(Bad, Packed, PackedLen);
+		Pos = LZ4_STREAM_HDR_LEN +
+				(unsigned long)rand() % (PackedLen - LZ4_STREAM_HDR_LEN);
+		Bad[Pos] ^= 1 << (rand() & 7);
+		Out[Len] = 0xA5;
+		OutLen = Len;
+		if (Unpack(Bad, PackedLen - ((Run & 1) ? Pos / 2 : 0), Out,
+				&OutLen) != 0)
+			Rejected++;
+		if (Out[Len] != 0xA5) {
+			fprintf(stderr, "%s: decoder overran its buffer\n", Name);
+			return 1;
+		}
+	}
+
+	printf("%-28s %9lu %9lu %5.1f%% %7.1f %8.1f", Name, Len, PackedLen,
+			100.0 * PackedLen / Len, Len / Pack_s / 1e6, Len / Unpack_s / 1e6);
+	if (PackedLen < Len) {
+		Need = Rate * Len / (Len - PackedLen);
+		printf(" %8.1f %7.1f", Need,
+				1e3 * (Len - PackedLen) / (Rate * 1e6));
+	}
+	printf("   %d/%d\n", Rejected, FUZZ_RUNS);
+
+	free(Packed);
+	free(Out);
+	free(Bad);
+	return 0;
+}
+
+static int TestFile(const char *Path, int Loops, double Rate)
+{
+	unsigned char *Buf;
+	unsigned long Len, PhOff, Off, Size;
+	unsigned int Num, i;
+	char Name[64];
+	const char *Base;
+	int Status = 0;
+
+	Buf = ReadFile(Path, &Len);
+	if (Buf == NULL)
+		return 1;
+
+	Base = strrchr(Path, '/');
+	Base = (Base != NULL) ? Base + 1 : Path;
+
+	/*
+	 * Loadable segments of a little endian ELF32, the whole file else
+	 */
+	if ((Len >= 52) && (memcmp(Buf, "\177ELF", 4) == 0) &&
+			(Buf[4] == 1) && (Buf[5] == 1)) {
+		PhOff = Get32(Buf + 28);
+		Num = Buf[44] | (Buf[45] << 8);
+		for (i = 0; i < Num; i++) {
+			Off = PhOff + i * 32;
+			if ((Off + 32 > Len) || (Get32(Buf + Off) != PT_LOAD))
+				continue;
+			Size = Get32(Buf + Off + 16);
+			if ((Size == 0) || (Get32(Buf + Off + 4) + Size > Len))
+				continue;
+			snprintf(Name, sizeof(Name), "%.18s@%08lx", Base,
+					Get32(Buf + Off + 8));
+			Status |= TestData(Name, Buf + Get32(Buf + Off + 4), Size,
+					Loops, Rate);
+		}
+	} else {
+		Status = TestData(Base, Buf, Len, Loops, Rate);
+	}
+
+	free(Buf);
+	return Status;
+}
+
+static void HeaderChecksum(unsigned long *Words)
+{
+	unsigned long Sum = 0;
+	int i;
+
+	for (i = 0; i < PH_CHECKSUM; i++)
+		Sum += Words[i];
+	Words[PH_CHECKSUM] = ~Sum & 0xFFFFFFFF;
+}
+
+static int CompareExtent(const void *A, const void *B)
+{
+	const Extent *Ea = A, *Eb = B;
+
+	return (Ea->Offset > Eb->Offset) - (Ea->Offset < Eb->Offset);
+}
+
+static int PackImage(const char *InPath, const char *OutPath,
+		unsigned long Select)
+{
+	Partition Part[MAX_PARTITIONS];
+	Extent Ext[2 * MAX_PARTITIONS];
+	unsigned char *Img, *Out;
+	unsigned long Len, PhOff, FsblOff, Cut, Pos, Raw, Total = 0;
+	unsigned int Num, NumExt = 0, i, j, Packed = 0;
+	unsigned char Sum[MD5_LEN];
+	FILE *Fp;
+
+	Img = ReadFile(InPath, &Len);
+	if (Img == NULL)
+		return 1;
+	if (Len < BOOT_PHDR_OFFSET + 4) {
+		fprintf(stderr, "%s: not a boot image\n", InPath);
+		return 1;
+	}
+
+	FsblOff = Get32(Img + BOOT_FSBL_OFFSET);
+	PhOff = Get32(Img + BOOT_PHDR_OFFSET);
+	for (Num = 0; Num < MAX_PARTITIONS; Num++) {
+		if (PhOff + (Num + 1) * PHDR_LEN > Len) {
+			fprintf(stderr, "%s: bad partition header table\n", InPath);
+			return 1;
+		}
+		for (j = 0; j < PHDR_WORDS; j++)
+			Part[Num].Words[j] = Get32(Img + PhOff + Num * PHDR_LEN + 4 * j);
+		Part[Num].Data = NULL;
+		for (j = 0; (j < PH_CHECKSUM) && (Part[Num].Words[j] == 0); j++)
+			;
+		if (j == PH_CHECKSUM)
+			break;
+		if ((Part[Num].Words[PH_ATTR] & ATTR_RSA) ||
+				Part[Num].Words[PH_AC_OFFSET]) {
+			fprintf(stderr, "%s: RSA authenticated images can not be "
+					"packed\n", InPath);
+			return 1;
+		}
+		if ((Part[Num].Words[PH_START] +
+				Part[Num].Words[PH_PART_LEN]) * 4 > Len) {
+			fprintf(stderr, "%s: partition %u out of the image\n",
+					InPath, Num);
+			return 1;
+		}
+	}
+
+	/*
+	 * Compress the selected plain PS partitions
+	 */
+	Cut = Len;
+	for (i = 0; i < Num; i++) {
+		unsigned long *W = Part[i].Words;
+
+		if ((W[PH_START] * 4 == FsblOff) || !(W[PH_ATTR] & ATTR_PS) ||
+				(W[PH_ATTR] & ATTR_COMPRESSED) ||
+				(W[PH_IMAGE_LEN] != W[PH_DATA_LEN]) ||
+				(W[PH_IMAGE_LEN] != W[PH_PART_LEN]) ||
+				(W[PH_LOAD_ADDR] == 0) || !((Select >> i) & 1))
+			continue;
+
+		Raw = W[PH_IMAGE_LEN] * 4;
+		Part[i].Data = Pack(Img + W[PH_START] * 4, Raw, &Part[i].DataLen);
+		printf("partition %u: %lu -> %lu bytes", i, Raw, Part[i].DataLen);
+		if (Part[i].DataLen >= Raw) {
+			printf(", left uncompressed\n");
+			free(Part[i].Data);
+			Part[i].Data = NULL;
+			continue;
+		}
+		printf(" (%.1f%%)\n", 100.0 * Part[i].DataLen / Raw);
+
+		W[PH_IMAGE_LEN] = W[PH_DATA_LEN] = W[PH_PART_LEN] =
+				Part[i].DataLen / 4;
+		W[PH_ATTR] |= ATTR_COMPRESSED;
+		if (W[PH_START] * 4 < Cut)
+			Cut = W[PH_START] * 4;
+		Total += Raw - Part[i].DataLen;
+		Packed++;
+	}
+	if (Packed == 0) {
+		fprintf(stderr, "%s: no partition to compress\n", InPath);
+		return 1;
+	}
+
+	/*
+	 * Move the partitions and checksums behind the first packed one down
+	 */
+	for (i = 0; i < Num; i++) {
+		unsigned long *W = Part[i].Words;
+
+		if (W[PH_START] * 4 >= Cut) {
+			Ext[NumExt].Offset = W[PH_START] * 4;
+			Ext[NumExt].Length = W[PH_PART_LEN] * 4;
+			Ext[NumExt].Part = i;
+			Ext[NumExt++].IsChecksum = 0;
+		}
+		if ((W[PH_ATTR] & ATTR_CHECKSUM) && (W[PH_CSUM_OFFSET] * 4 >= Cut)) {
+			Ext[NumExt].Offset = W[PH_CSUM_OFFSET] * 4;
+			Ext[NumExt].Length = MD5_LEN;
+			Ext[NumExt].Part = i;
+			Ext[NumExt++].IsChecksum = 1;
+		}
+	}
+	qsort(Ext, NumExt, sizeof(Extent), CompareExtent);
+
+	Out = malloc(Len);
+	if (Out == NULL) {
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+	memcpy(Out, Img, Cut);
+	Pos = Cut;
+	for (i = 0; i < NumExt; i++) {
+		Partition *P = &Part[Ext[i].Part];
+
+		while (Pos % PART_ALIGN)
+			Out[Pos++] = 0xFF;
+		if (Ext[i].IsChecksum) {
+			P->Words[PH_CSUM_OFFSET] = Pos / 4;
+		} else {
+			if (P->Data != NULL)
+				memcpy(Out + Pos, P->Data, P->DataLen);
+			else
+				memcpy(Out + Pos, Img + Ext[i].Offset, Ext[i].Length);
+			P->Words[PH_START] = Pos / 4;
+		}
+		Pos += Ext[i].Length;
+	}
+
+	/*
+	 * Checksums over the stored bytes, then the partition headers
+	 */
+	for (i = 0; i < Num; i++) {
+		unsigned long *W = Part[i].Words;
+
+		if ((Part[i].Data != NULL) && (W[PH_ATTR] & ATTR_CHECKSUM)) {
+			Md5(Part[i].Data, Part[i].DataLen, Sum);
+			memcpy(Out + W[PH_CSUM_OFFSET] * 4, Sum, MD5_LEN);
+		}
+		HeaderChecksum(W);
+		for (j = 0; j < PHDR_WORDS; j++)
+			Put32(Out + PhOff + i * PHDR_LEN + 4 * j, W[j]);
+		free(Part[i].Data);
+	}
+
+	Fp = fopen(OutPath, "wb");
+	if ((Fp == NULL) || (fwrite(Out, 1, Pos, Fp) != Pos)) {
+		perror(OutPath);
+		return 1;
+	}
+	fclose(Fp);
+
+	printf("%s: %lu -> %lu bytes, %lu bytes less to read\n", OutPath, Len,
+			Pos, Total);
+
+	free(Img);
+	free(Out);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned long Select = 0;
+	double Rate = DEFAULT_RATE;
+	int Loops = DEFAULT_LOOPS;
+	int Test = 0;
+	int Arg;
+	int Status = 0;
+
+	for (Arg = 1; (Arg < argc) && (argv[Arg][0] == '-'); Arg += 2) {
+		if (strcmp(argv[Arg], "-t") == 0) {
+			Test = 1;
+			Arg--;
+		} else if (Arg + 1 >= argc) {
+			break;
+		} else if (strcmp(argv[Arg], "-b") == 0) {
+			BlockSize = strtoul(argv[Arg + 1], NULL, 0) * 1024;
+		} else if (strcmp(argv[Arg], "-p") == 0) {
+			Select |= 1UL << strtoul(argv[Arg + 1], NULL, 0);
+		} else if (strcmp(argv[Arg], "-n") == 0) {
+			Loops = atoi(argv[Arg + 1]);
+		} else if (strcmp(argv[Arg], "-r") == 0) {
+			Rate = strtod(argv[Arg + 1], NULL);
+		} else {
+			break;
+		}
+	}
+	if ((BlockSize == 0) || (BlockSize > LZ4_MAX_BLOCK_SIZE) ||
+			(Loops <= 0) || (Rate <= 0) || (Arg >= argc) ||
+			(argv[Arg][0] == '-') || (!Test && (Arg + 2 != argc))) {
+		fprintf(stderr, "usage: %s [-b <block KB>] [-p <partition>]... "
+				"<BOOT.BIN> <out.bin>\n"
+				"       %s -t [-b <block KB>] [-n <loops>] [-r <MB/s>] "
+				"<file> ...\n", argv[0], argv[0]);
+		return 1;
+	}
+
+	if (!Test)
+		return PackImage(argv[Arg], argv[Arg + 1],
+				Select ? Select : ~0UL);
+
+	printf("%-28s %9s %9s %6s %7s %8s %8s %7s   %s\n", "data", "raw",
+			"packed", "ratio", "pk MB/s", "dec MB/s", "need", "ms saved",
+			"bad rejected");
+	printf("%-28s %9s %9s %6s %7s %8s %8s %7s\n", "", "", "", "", "host",
+			"host", "MB/s", "@-r");
+	for (; Arg < argc; Arg++)
+		Status |= TestFile(argv[Arg], Loops, Rate);
+
+	return Status;
+}
@@ -0,0 +1,441 @@
+/******************************************************************************
+*
+* mmuremapsim.c
+*
+* Host side benchmark and test of the translation table updates of
+* xil_mmu.c in standalone_v3_11_a. Xil_SetTlbAttributesRange() runs on a
+* copy of the boot translation table, the CP15 operations and the cache
+* maintenance calls go to a cost model. The per section loop of
+* Xil_SetTlbAttributes() of 3.11a before the range update runs on a second
+* table as the reference.
+*
+* The table starts as translation_table.s maps it: DDR write back
+* cacheable in domain 15, the PL and the devices uncached in domain 0. Each
+* scenario remaps a range with both versions. The test checks that
+*   - both tables translate every address of the range to the same
+*     physical address with the same attributes, and the rest of the table
+*     is unchanged,
+*   - aligned 16MB blocks of the range are supersections, other sections
+*     have the domain of the attributes, also those split off a
+*     supersection the range only partly covers,
+*   - every changed table word was cleaned by Xil_DCacheFlushRange(),
+*   - every block that changed between a supersection and sections was
+*     all fault entries, cleaned, when the TLBs were invalidated before
+*     its new entries (break-before-make),
+*   - the TLBs are invalidated once per call and once per such block, the
+*     branch predictors once per call, and the D-cache is flushed only if
+*     part of the range was cacheable.
+* Reported are the full D-cache flushes, the table lines cleaned, the TLB
+* entries the range needs and the modelled remap time of both versions.
+*
+* Build: gcc -O2 -no-pie -Wno-pointer-to-int-cast -o mmuremapsim mmuremapsim.c
+*		 -I../../FSBL_bsp/ps7_cortexa9_0/libsrc/standalone_v3_11_a/src
+*
+* Xil_DCacheFlushRange() takes 32-bit addresses, -no-pie keeps the table
+* below 4GB.
+*
+* Usage: mmuremapsim [-f <full D-cache flush us>] [-l <line clean ns>]
+*		 [-t <TLB or BP invalidate ns>]
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+* 1.01a te   10/16/26 Check break-before-make of resized blocks
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * 32-bit register and pointer arithmetic types of the target, xil_types.h
+ * leaves them out when XBASIC_TYPES_H is defined
+ */
+#define XBASIC_TYPES_H
+typedef unsigned char u8;
+typedef unsigned short u16;
+typedef unsigned int u32;
+
+/*
+ * CP15 accesses and barriers go to the model instead of the ARM inline
+ * assembly of xpseudo_asm_gcc.h
+ */
+#define XPSEUDO_ASM_GCC_H
+#define mtcp(rn, v)	Cp15Write(rn)
+#define mfcp(rn)	0
+#define dsb()
+#define isb()
+
+static void Cp15Write(const char *Reg);
+
+/* MMUTable is 16KB, xil_mmu.c declares it as one u32 */
+#pragma GCC diagnostic ignored "-Warray-bounds"
+#pragma GCC diagnostic ignored "-Wstringop-overflow"
+
+#include "xil_mmu.c"
+
+#define TABLE_ENTRIES	4096
+#define LINE_SIZE		32
+#define MAX_RANGES		512
+#define NUM_BLOCKS		(TABLE_ENTRIES / SECTIONS_PER_SUPER)
+
+#define ATTR_DDR		0x15de6		/* Cacheable, domain 15 */
+#define ATTR_DDR_NC		0x14de2		/* Normal uncached, domain 15 */
+#define ATTR_PL			0x00c02		/* Strongly ordered, domain 0 */
+#define ATTR_DEV		0x00c06		/* Device, domain 0 */
+
+/*
+ * Translation table of the boot code, 16KB aligned like MMUTable of
+ * translation_table.s
+ */
+__asm__(".bss\n"
+	".balign 16384\n"
+	".globl MMUTable\n"
+	"MMUTable: .space 16384\n"
+	".text\n");
+
+static u32 *Table;
+static u32 OldTable[TABLE_ENTRIES];
+static u32 Before[TABLE_ENTRIES];
+
+/*
+ * Cost model
+ */
+static double FullFlushNs = 250000;
+static double LineNs = 100;
+static double InvalNs = 50;
+
+static struct {
+	u32 FullFlushes;
+	u32 Lines;
+	u32 TlbInvals;
+	u32 BpInvals;
+	u32 Ranges;
+	u32 Start[MAX_RANGES];
+	u32 End[MAX_RANGES];
+} Cost;
+
+/*
+ * Break-before-make per block: all fault and cleaned, then invalidated
+ */
+static int FaultCleaned[NUM_BLOCKS];
+static int Broken[NUM_BLOCKS];
+
+static int Errors;
+
+static void Check(int Condition, const char *Text)
+{
+	if (!Condition) {
+		printf("  FAIL: %s\n", Text);
+		Errors++;
+	}
+}
+
+static int BlockFault(u32 Block)
+{
+	u32 Index;
+
+	for (Index = 0; Index < SECTIONS_PER_SUPER; Index++)
+		if (Table[Block * SECTIONS_PER_SUPER + Index] != 0)
+			return 0;
+	return 1;
+}
+
+static void Cp15Write(const char *Reg)
+{
+	u32 Block;
+
+	if (!strcmp(Reg, XREG_CP15_INVAL_UTLB_UNLOCKED)) {
+		Cost.TlbInvals++;
+		for (Block = 0; Block < NUM_BLOCKS; Block++)
+			if (FaultCleaned[Block] && BlockFault(Block))
+				Broken[Block] = 1;
+	} else if (!strcmp(Reg, XREG_CP15_INVAL_BRANCH_ARRAY))
+		Cost.BpInvals++;
+}
+
+void Xil_DCacheFlush(void)
+{
+	Cost.FullFlushes++;
+}
+
+void Xil_DCacheFlushRange(unsigned int adr, unsigned len)
+{
+	u32 Start = adr & ~(LINE_SIZE - 1);
+	u32 End = (adr + len + LINE_SIZE - 1) & ~(LINE_SIZE - 1);
+	u32 Base = (u32)(unsigned long)Table;
+	u32 Block;
+
+	if (Table != NULL) {
+		for (Block = 0; Block < NUM_BLOCKS; Block++)
+			if ((Base + Block * 64 >= Start) &&
+					(Base + Block * 64 + 64 <= End) && BlockFault(Block))
+				FaultCleaned[Block] = 1;
+	}
+
+	Cost.Lines += (End - Start) / LINE_SIZE;
+	if (Cost.Ranges < MAX_RANGES) {
+		Cost.Start[Cost.Ranges] = Start;
+		Cost.End[Cost.Ranges] = End;
+	}
+	Cost.Ranges++;
+}
+
+void Xil_DCacheInvalidate(void)
+{
+}
+
+void Xil_ICacheInvalidate(void)
+{
+}
+
+/*
+ * Xil_SetTlbAttributes() of 3.11a before the range update
+ */
+static void OldSetTlbAttributes(u32 addr, u32 attrib)
+{
+	u32 *ptr;
+	u32 section;
+
+	section = addr / 0x100000;
+	ptr = &OldTable[section];
+	*ptr = (addr & 0xFFF00000) | attrib;
+
+	Xil_DCacheFlush();
+
+	mtcp(XREG_CP15_INVAL_UTLB_UNLOCKED, 0);
+	/* Invalidate all branch predictors */
+	mtcp(XREG_CP15_INVAL_BRANCH_ARRAY, 0);
+
+	dsb(); /* ensure completion of the BP and TLB invalidation */
+	isb(); /* synchronize context on this processor */
+}
+
+static void BootTable(void)
+{
+	u32 Index;
+	u32 Attr;
+
+	for (Index = 0; Index < TABLE_ENTRIES; Index++) {
+		if (Index < 0x400)
+			Attr = ATTR_DDR;
+		else if (Index < 0xC00)
+			Attr = ATTR_PL;
+		else
+			Attr = ATTR_DEV;
+		Table[Index] = (Index * XIL_MMU_SECTION_SIZE) | Attr;
+		OldTable[Index] = Table[Index];
+	}
+}
+
+/*
+ * Physical address and attributes of a section, without the domain
+ * supersections do not have
+ */
+static u32 Translate(const u32 *Tbl, u32 Section)
+{
+	u32 Entry = Tbl[Section];
+
+	if (Entry & XIL_MMU_SUPERSECTION)
+		return (Entry & 0xFF000000) + ((Section % SECTIONS_PER_SUPER) *
+				XIL_MMU_SECTION_SIZE) + (Entry & DESC_ATTR_MASK &
+				~(XIL_MMU_SUPERSECTION | DESC_DOMAIN_MASK));
+	return Entry & ~DESC_DOMAIN_MASK;
+}
+
+static double TimeNs(void)
+{
+	return Cost.FullFlushes * FullFlushNs + Cost.Lines * LineNs +
+			(Cost.TlbInvals + Cost.BpInvals) * InvalNs;
+}
+
+/*
+ * TLB entries mapping the range
+ */
+static u32 TlbEntries(u32 First, u32 Last)
+{
+	u32 Entries = 0;
+	u32 Section;
+
+	for (Section = First; Section <= Last; Section++)
+		if (!(Table[Section] & XIL_MMU_SUPERSECTION) ||
+				(Section == First) ||
+				((Section % SECTIONS_PER_SUPER) == 0))
+			Entries++;
+	return Entries;
+}
+
+static void Remap(const char *Name, u32 Addr, u32 Size, u32 Attrib)
+{
+	u32 First = Addr / XIL_MMU_SECTION_SIZE;
+	u32 Last = (Addr + Size - 1) / XIL_MMU_SECTION_SIZE;
+	u32 Section;
+	u32 Block;
+	u32 Range;
+	u32 Byte;
+	u32 OldCacheable = 0;
+	u32 OldFlushes;
+	u32 Resized;
+	u32 Mapped;
+	u32 Index;
+	double OldNs;
+	int Covered;
+	int Super;
+	int Ok;
+
+	Super = ((Attrib & DESC_TYPE_MASK) == DESC_TYPE_SECTION) &&
+			!(Attrib & XIL_MMU_SUPERSECTION);
+
+	/* Reference, one call per section */
+	memset(&Cost, 0, sizeof(Cost));
+	for (Section = First; Section <= Last; Section++)
+		OldSetTlbAttributes(Section * XIL_MMU_SECTION_SIZE, Attrib);
+	OldNs = TimeNs();
+	OldFlushes = Cost.FullFlushes;
+
+	for (Section = 0; Section < TABLE_ENTRIES; Section++)
+		Before[Section] = Table[Section];
+	for (Section = First; Section <= Last; Section++)
+		OldCacheable |= Before[Section];
+	memset(&Cost, 0, sizeof(Cost));
+	memset(FaultCleaned, 0, sizeof(FaultCleaned));
+	memset(Broken, 0, sizeof(Broken));
+	Xil_SetTlbAttributesRange(Addr, Size, Attrib);
+
+	printf("  %-22s %5u MB  old %4u flushes %9.1f us  range %u flushes "
+			"%3u lines %7.1f us  %4u TLB entries\n", Name, Last - First + 1,
+			OldFlushes, OldNs / 1000, Cost.FullFlushes, Cost.Lines,
+			TimeNs() / 1000, TlbEntries(First, Last));
+
+	Ok = 1;
+	for (Section = 0; Section < TABLE_ENTRIES; Section++)
+		Ok &= (Translate(Table, Section) == Translate(OldTable, Section));
+	Check(Ok, "translation differs from the per section update");
+
+	/*
+	 * Only the blocks of the range change, aligned blocks inside it are
+	 * supersections
+	 */
+	Ok = 1;
+	for (Section = 0; Section < TABLE_ENTRIES; Section++) {
+		Block = Section & ~(SECTIONS_PER_SUPER - 1);
+		if ((Block + SECTIONS_PER_SUPER - 1 < First) || (Block > Last)) {
+			Ok &= (Table[Section] == Before[Section]);
+		} else if (Super && (Block >= First) &&
+				(Block + SECTIONS_PER_SUPER - 1 <= Last)) {
+			Ok &= ((Table[Section] & XIL_MMU_SUPERSECTION) != 0) &&
+					(Table[Section] == Table[Block]);
+		} else if (Table[Section] & XIL_MMU_SUPERSECTION) {
+			Ok = 0;
+		} else if ((Table[Section] != Before[Section]) ||
+				((Section >= First) && (Section <= Last))) {
+			Ok &= ((Table[Section] & DESC_DOMAIN_MASK) ==
+					(Attrib & DESC_DOMAIN_MASK));
+		}
+	}
+	Check(Ok, "supersections or domains wrong");
+
+	Ok = 1;
+	for (Section = 0; Section < TABLE_ENTRIES; Section++) {
+		if (Table[Section] == Before[Section])
+			continue;
+		for (Byte = 0; Byte < 4; Byte++) {
+			u32 Address = (u32)(unsigned long)&Table[Section] + Byte;
+
+			Covered = 0;
+			for (Range = 0; (Range < Cost.Ranges) &&
+					(Range < MAX_RANGES); Range++)
+				Covered |= (Address >= Cost.Start[Range]) &&
+						(Address < Cost.End[Range]);
+			Ok &= Covered;
+		}
+	}
+	Check(Ok, "changed table line not cleaned");
+
+	/* Blocks whose supersection state changed were broken first */
+	Ok = 1;
+	Resized = 0;
+	for (Section = 0; Section < TABLE_ENTRIES; Section += SECTIONS_PER_SUPER) {
+		Mapped = 0;
+		for (Index = 0; Index < SECTIONS_PER_SUPER; Index++)
+			Mapped |= Before[Section + Index] & DESC_TYPE_MASK;
+		if (((Table[Section] ^ Before[Section]) & XIL_MMU_SUPERSECTION) &&
+				Mapped) {
+			Ok &= Broken[Section / SECTIONS_PER_SUPER];
+			Resized++;
+		}
+	}
+	Check(Ok, "block resized without break-before-make");
+
+	Check((Cost.TlbInvals == 1 + Resized) && (Cost.BpInvals == 1),
+			"TLB not invalidated once per resized block and call, or "
+			"branch predictors not once");
+	Check(Cost.FullFlushes == ((OldCacheable & DESC_CACHEABLE_MASK) ? 1 : 0),
+			"D-cache flush does not follow the old cacheability");
+}
+
+int main(int argc, char **argv)
+{
+	u32 Section;
+	int Ok;
+	int Arg;
+
+	for (Arg = 1; (Arg + 1 < argc) && (argv[Arg][0] == '-'); Arg += 2) {
+		if (!strcmp(argv[Arg], "-f")) {
+			FullFlushNs = strtod(argv[Arg + 1], NULL) * 1000;
+		} else if (!strcmp(argv[Arg], "-l")) {
+			LineNs = strtod(argv[Arg + 1], NULL);
+		} else if (!strcmp(argv[Arg], "-t")) {
+			InvalNs = strtod(argv[Arg + 1], NULL);
+		} else {
+			break;
+		}
+	}
+	if (Arg != argc) {
+		fprintf(stderr, "usage: %s [-f <full D-cache flush us>] "
+				"[-l <line clean ns>] [-t <TLB or BP invalidate ns>]\n",
+				argv[0]);
+		return 1;
+	}
+
+	Table = &MMUTable;
+	BootTable();
+
+	/* Large DMA buffer in DDR, then back to cacheable */
+	Remap("256MB DMA uncached", 0x10000000, 0x10000000, ATTR_DDR_NC);
+	Remap("256MB DMA cached", 0x10000000, 0x10000000, ATTR_DDR);
+
+	/* Unaligned range with an aligned 16MB block inside */
+	Remap("40MB unaligned", 0x00300000, 40 * XIL_MMU_SECTION_SIZE,
+			ATTR_DDR_NC);
+
+	/* One section out of a supersection, the rest keeps the domain */
+	Remap("1MB in a supersection", 0x13500000, XIL_MMU_SECTION_SIZE,
+			ATTR_DDR_NC);
+	Ok = 1;
+	for (Section = 0x130; Section < 0x140; Section++)
+		Ok &= !(Table[Section] & XIL_MMU_SUPERSECTION) &&
+				((Table[Section] & DESC_DOMAIN_MASK) == DESC_DOMAIN_MASK);
+	Check(Ok, "split supersection lost its domain");
+
+	/* Range ending inside a supersection */
+	Remap("20MB across a block", 0x10800000, 20 * XIL_MMU_SECTION_SIZE,
+			ATTR_DDR);
+
+	/* Fault entries are not mapped as supersections */
+	Remap("16MB fault over a block", 0x1A000000, 0x01000000, 0);
+	Remap("16MB back to cached", 0x1A000000, 0x01000000, ATTR_DDR);
+
+	/* Uncached device window, no flush needed */
+	Remap("1MB device", 0xE0000000, XIL_MMU_SECTION_SIZE, ATTR_PL);
+	Remap("64MB PL", 0x40000000, 0x04000000, ATTR_DEV);
+
+	/* End of the address space */
+	Remap("16MB top", 0xFF000000, 0x01000000, ATTR_DEV);
+
+	printf("%d errors\n", Errors);
+	return Errors ? 1 : 0;
+}
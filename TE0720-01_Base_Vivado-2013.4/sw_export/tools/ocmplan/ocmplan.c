@@ -0,0 +1,1499 @@
+/******************************************************************************
+*
+* ocmplan.c
+*
+* Host side OCM budget report and placement planner for the FSBL. Reads a
+* little endian ELF32 image, optionally the GNU ld map file of the link
+* (-Wl,-Map=FSBL.map), the MEMORY block of the linker script and gmon
+* files of a profiled boot written by profile_pmu_write_gmon().
+*
+* The report gives the use of every memory region, the size of every
+* module split into text, rodata, data and bss, and the size of each
+* silicon version of the ps7_init tables. Modules are taken from the input
+* sections of the map file, else from the DWARF address ranges of the
+* compilation units, else from the STT_FILE symbols.
+*
+* The plan splits the code into three boot phases. Everything reachable
+* from reset up to main, from ps7_init, from the ps7_init failure path,
+* from the boot device drivers and from function pointers held in data
+* runs before DDR is up, or is needed to load the overlay, and stays in
+* OCM. So does everything reachable from the fallback and lockdown paths,
+* the exception handlers and xil_printf, which may run before the overlay
+* is loaded. The call graph is built from the ARM branches, the MOVW/MOVT
+* pairs and the literal pools of every function. Of the remaining post DDR
+* code the functions without samples in the profile are cold, without a
+* profile only the debug paths are. Cold functions and the data only they
+* use are proposed for a DDR overlay that is loaded after ps7_init; their
+* bss moves to DDR without any load cost.
+*
+* With -o the plan is written as a linker script fragment to be included
+* ahead of .text in lscript.ld. It needs objects built with
+* -ffunction-sections -fdata-sections. .ddr_overlay is removed from the
+* FSBL partition with objcopy and stored as a partition of its own, which
+* the FSBL copies to __ddr_overlay_start after ps7_init. .ddr_bss is
+* cleared at the same time.
+*
+* -r gives the boot media read rate in MB/s for the load time savings.
+*
+* Usage: ocmplan [-m <map>] [-l <lscript.ld>] [-k <function>]...
+*		 [-a <overlay address>] [-r <MB/s>] [-o <fragment.ld>]
+*		 <image.elf> [<gmon file> ...]
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+* 1.00a te   10/16/26 Fallback, lockdown, exception handlers and console
+*                    output are roots instead of cold
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SHT_SYMTAB		2
+#define SHT_NOBITS		8
+#define SHF_WRITE		1
+#define SHF_ALLOC		2
+#define SHF_EXECINSTR		4
+#define STT_OBJECT		1
+#define STT_FUNC		2
+#define STT_FILE		4
+#define STB_LOCAL		0
+
+#define DW_AT_name		0x03
+#define DW_TAG_compile_unit	0x11
+
+#define GMON_HDR_LEN		20
+#define GMON_TAG_TIME_HIST	0
+#define GMON_TAG_CG_ARC		1
+#define GMON_HIST_DIMEN_LEN	15
+#define GMON_CG_ARC_LEN		12
+
+#define MAX_REGIONS		8
+#define MAX_KEEP		64
+#define DEFAULT_OVERLAY_ADDR	0x3FF00000UL	/* Last MB of the 1 GB DDR */
+
+/*
+ * Size columns of a module
+ */
+#define COL_TEXT		0
+#define COL_RODATA		1
+#define COL_DATA		2
+#define COL_BSS			3
+#define NUM_COLS		4
+
+/*
+ * Placement classes of a function
+ */
+#define CLASS_WARM		0	/* Post DDR, stays */
+#define CLASS_RESIDENT		1	/* Needed before DDR or by the loader */
+#define CLASS_HOT		2	/* Sampled in the profile */
+#define CLASS_COLD		3	/* Overlay candidate */
+
+typedef struct {
+	const char *Name;
+	unsigned long Type;
+	unsigned long Flags;
+	unsigned long Addr;
+	unsigned long Size;
+	unsigned long Offset;
+	int Region;
+	int Col;
+} Section;
+
+typedef struct {
+	char Name[64];
+	unsigned long Origin;
+	unsigned long Length;
+	unsigned long Used;
+} Region;
+
+typedef struct {
+	const char *Name;
+	unsigned long Size[NUM_COLS];
+	unsigned long Total;
+} Module;
+
+typedef struct {
+	unsigned long Addr;
+	unsigned long Size;
+	int Module;
+} Range;
+
+typedef struct {
+	unsigned long Addr;
+	unsigned long Size;
+	const char *Name;
+	int Type;
+	int Sect;
+	int Module;
+	int Root;
+	int Class;
+	int RefResident;	/* Object used before DDR or by data */
+	int RefHot;		/* Object used by sampled code */
+	int RefOther;		/* Object used by other post DDR code */
+	unsigned long long Samples;
+	unsigned long FirstEdge;
+	unsigned long NumEdges;
+} Symbol;
+
+typedef struct {
+	unsigned long From;
+	unsigned long To;
+} Edge;
+
+/*
+ * Functions that run before DDR is up or load the overlay. Reset runs into
+ * main, which is kept but not followed, since it calls everything. The
+ * fallback and lockdown paths, the exception handlers and the console
+ * output may run at any time, also before the overlay is loaded or when
+ * DDR failed.
+ */
+static const char *DefaultRoots[] = {
+	"_vector_table", "_boot", "_start", "main", "ps7_init",
+	"FsblHookFallback", "OutputStatus", "getPS7MessageInfo",
+	"InitQspi", "QspiAccess", "InitSD", "SDAccess", "InitNand",
+	"NandAccess", "NorAccess", "InitUsb", "UsbAccess",
+	"FsblFallback", "ErrorLockdown", "Undef_Handler", "SVC_Handler",
+	"PreFetch_Abort_Handler", "Data_Abort_Handler", "IRQ_Handler",
+	"FIQ_Handler", "xil_printf", "outbyte", NULL
+};
+
+static const char *StopAt = "main";
+
+/*
+ * Name fragments of the debug paths, cold without a profile. The error
+ * paths that may run before the overlay is loaded are roots instead.
+ */
+static const char *ColdNames[] = {
+	"Fail", "Assert", "Print", "Dump", NULL
+};
+
+static const char *ColName[NUM_COLS] = { "text", "rodata", "data", "bss" };
+
+static unsigned char *Elf;
+static unsigned long ElfLen;
+static Section *SectTbl;
+static unsigned long NumSects;
+static Region RegionTbl[MAX_REGIONS];
+static unsigned int NumRegions;
+static Module *ModTbl;
+static unsigned int NumMods;
+static Range *RangeTbl;
+static unsigned long NumRanges;
+static int RangesFromMap;
+static Symbol *SymTbl;
+static unsigned long NumSyms;
+static Edge *EdgeTbl;
+static unsigned long NumEdges;
+static unsigned long MaxEdges;
+static const char *KeepTbl[MAX_KEEP];
+static unsigned int NumKeep;
+static int HaveProfile;
+static unsigned long ThumbFuncs;
+static double MediaRate;			/* MB/s */
+
+static unsigned long Get16(const unsigned char *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static unsigned long Get32(const unsigned char *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+static unsigned long GetUleb(const unsigned char **Pp, const unsigned char *End)
+{
+	unsigned long Value = 0;
+	unsigned int Shift = 0;
+
+	while (*Pp < End) {
+		unsigned char Byte = *(*Pp)++;
+
+		if (Shift < 32)
+			Value |= (unsigned long)(Byte & 0x7F) << Shift;
+		Shift += 7;
+		if ((Byte & 0x80) == 0)
+			break;
+	}
+	return Value;
+}
+
+static unsigned char *ReadFile(const char *Path, unsigned long *LenPtr)
+{
+	FILE *Fp;
+	unsigned char *Buf;
+	long Len;
+
+	Fp = fopen(Path, "rb");
+	if (Fp == NULL) {
+		perror(Path);
+		return NULL;
+	}
+	fseek(Fp, 0, SEEK_END);
+	Len = ftell(Fp);
+	fseek(Fp, 0, SEEK_SET);
+
+	Buf = malloc(Len > 0 ? Len : 1);
+	if ((Buf == NULL) || (fread(Buf, 1, Len, Fp) != (size_t)Len)) {
+		fprintf(stderr, "%s: read failed\n", Path);
+		free(Buf);
+		fclose(Fp);
+		return NULL;
+	}
+	fclose(Fp);
+
+	*LenPtr = Len;
+	return Buf;
+}
+
+/*
+ * Module names are the file name without its directory, archive members
+ * keep their archive.
+ */
+static int GetModule(const char *Path)
+{
+	const char *Base = Path;
+	const char *Paren = strchr(Path, '(');
+	const char *p;
+	unsigned int Index;
+
+	for (p = Path; (*p != '\0') && ((Paren == NULL) || (p < Paren)); p++) {
+		if ((*p == '/') || (*p == '\\'))
+			Base = p + 1;
+	}
+
+	for (Index = 0; Index < NumMods; Index++) {
+		if (strcmp(ModTbl[Index].Name, Base) == 0)
+			return Index;
+	}
+
+	ModTbl = realloc(ModTbl, (NumMods + 1) * sizeof(Module));
+	if (ModTbl == NULL) {
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+	memset(&ModTbl[NumMods], 0, sizeof(Module));
+	ModTbl[NumMods].Name = strdup(Base);
+	return NumMods++;
+}
+
+static void AddRange(unsigned long Addr, unsigned long Size, int Mod)
+{
+	static unsigned long MaxRanges;
+
+	if (NumRanges == MaxRanges) {
+		MaxRanges = MaxRanges ? MaxRanges * 2 : 256;
+		RangeTbl = realloc(RangeTbl, MaxRanges * sizeof(Range));
+		if (RangeTbl == NULL) {
+			fprintf(stderr, "out of memory\n");
+			exit(1);
+		}
+	}
+	RangeTbl[NumRanges].Addr = Addr;
+	RangeTbl[NumRanges].Size = Size;
+	RangeTbl[NumRanges].Module = Mod;
+	NumRanges++;
+}
+
+static int CompareRangeAddr(const void *A, const void *B)
+{
+	const Range *RangeA = A;
+	const Range *RangeB = B;
+
+	if (RangeA->Addr != RangeB->Addr)
+		return RangeA->Addr < RangeB->Addr ? -1 : 1;
+	return 0;
+}
+
+static int FindRangeModule(unsigned long Addr)
+{
+	unsigned long Low = 0;
+	unsigned long High = NumRanges;
+
+	while (Low < High) {
+		unsigned long Mid = (Low + High) / 2;
+
+		if (RangeTbl[Mid].Addr <= Addr)
+			Low = Mid + 1;
+		else
+			High = Mid;
+	}
+	if ((Low == 0) ||
+			(Addr >= RangeTbl[Low - 1].Addr + RangeTbl[Low - 1].Size))
+		return -1;
+
+	return RangeTbl[Low - 1].Module;
+}
+
+static Section *FindSection(const char *Name)
+{
+	unsigned long Index;
+
+	for (Index = 0; Index < NumSects; Index++) {
+		if ((SectTbl[Index].Flags & SHF_ALLOC) &&
+				(strcmp(SectTbl[Index].Name, Name) == 0))
+			return &SectTbl[Index];
+	}
+	return NULL;
+}
+
+static Section *FindSectionAddr(unsigned long Addr)
+{
+	unsigned long Index;
+
+	for (Index = 0; Index < NumSects; Index++) {
+		if ((SectTbl[Index].Flags & SHF_ALLOC) && (SectTbl[Index].Size != 0) &&
+				(Addr >= SectTbl[Index].Addr) &&
+				(Addr < SectTbl[Index].Addr + SectTbl[Index].Size))
+			return &SectTbl[Index];
+	}
+	return NULL;
+}
+
+/*
+ * Memory regions of the MEMORY block of a linker script. The defaults are
+ * the ones of FSBL/src/lscript.ld.
+ */
+static int LoadLscript(const char *Path)
+{
+	FILE *Fp;
+	char Line[512];
+	int InMemory = 0;
+
+	Fp = fopen(Path, "r");
+	if (Fp == NULL) {
+		perror(Path);
+		return -1;
+	}
+
+	NumRegions = 0;
+	while (fgets(Line, sizeof(Line), Fp) != NULL) {
+		Region *Reg = &RegionTbl[NumRegions];
+
+		if (!InMemory) {
+			if (strncmp(Line, "MEMORY", 6) == 0)
+				InMemory = 1;
+			continue;
+		}
+		if (strchr(Line, '}') != NULL)
+			break;
+		if ((NumRegions < MAX_REGIONS) &&
+				(sscanf(Line, " %63s : ORIGIN = %li , LENGTH = %li",
+					Reg->Name, &Reg->Origin, &Reg->Length) == 3))
+			NumRegions++;
+	}
+	fclose(Fp);
+
+	if (NumRegions == 0) {
+		fprintf(stderr, "%s: no MEMORY regions\n", Path);
+		return -1;
+	}
+	return 0;
+}
+
+static void DefaultRegions(void)
+{
+	strcpy(RegionTbl[0].Name, "ps7_ram_0_S_AXI_BASEADDR");
+	RegionTbl[0].Origin = 0x00000000;
+	RegionTbl[0].Length = 0x00030000;
+	strcpy(RegionTbl[1].Name, "ps7_ram_1_S_AXI_BASEADDR");
+	RegionTbl[1].Origin = 0xFFFF0000;
+	RegionTbl[1].Length = 0x0000FE00;
+	NumRegions = 2;
+}
+
+static int LoadSections(void)
+{
+	unsigned long ShOff, ShEntSize, ShStrNdx, StrOff;
+	unsigned long Index;
+	unsigned int Reg;
+
+	if ((ElfLen < 52) || memcmp(Elf, "\177ELF", 4) || (Elf[4] != 1) ||
+			(Elf[5] != 1)) {
+		fprintf(stderr, "not a little endian ELF32 image\n");
+		return -1;
+	}
+
+	ShOff = Get32(Elf + 32);
+	ShEntSize = Get16(Elf + 46);
+	NumSects = Get16(Elf + 48);
+	ShStrNdx = Get16(Elf + 50);
+	if ((ShEntSize < 40) || (ShOff + NumSects * ShEntSize > ElfLen) ||
+			(ShStrNdx >= NumSects)) {
+		fprintf(stderr, "bad section header table\n");
+		return -1;
+	}
+
+	SectTbl = calloc(NumSects, sizeof(Section));
+	if (SectTbl == NULL)
+		return -1;
+
+	StrOff = Get32(Elf + ShOff + ShStrNdx * ShEntSize + 16);
+	for (Index = 0; Index < NumSects; Index++) {
+		const unsigned char *Sh = Elf + ShOff + Index * ShEntSize;
+		Section *Sect = &SectTbl[Index];
+
+		Sect->Name = (const char *)Elf + StrOff + Get32(Sh);
+		Sect->Type = Get32(Sh + 4);
+		Sect->Flags = Get32(Sh + 8);
+		Sect->Addr = Get32(Sh + 12);
+		Sect->Offset = Get32(Sh + 16);
+		Sect->Size = Get32(Sh + 20);
+		Sect->Region = -1;
+
+		if ((Sect->Type != SHT_NOBITS) &&
+				(Sect->Offset + Sect->Size > ElfLen))
+			Sect->Flags &= ~SHF_ALLOC;
+		if (!(Sect->Flags & SHF_ALLOC))
+			continue;
+
+		if (Sect->Flags & SHF_EXECINSTR)
+			Sect->Col = COL_TEXT;
+		else if (Sect->Type == SHT_NOBITS)
+			Sect->Col = COL_BSS;
+		else if (Sect->Flags & SHF_WRITE)
+			Sect->Col = COL_DATA;
+		else
+			Sect->Col = COL_RODATA;
+
+		for (Reg = 0; Reg < NumRegions; Reg++) {
+			if ((Sect->Addr >= RegionTbl[Reg].Origin) &&
+					(Sect->Addr - RegionTbl[Reg].Origin <
+					 RegionTbl[Reg].Length)) {
+				Sect->Region = Reg;
+				RegionTbl[Reg].Used += Sect->Size;
+				break;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int SkipForm(const unsigned char **Pp, const unsigned char *End,
+		unsigned long Form, unsigned int AddrSize, unsigned long Version)
+{
+	unsigned long Len;
+
+	switch (Form) {
+	case 0x01: *Pp += AddrSize; break;		/* addr */
+	case 0x0b: case 0x0c: case 0x11: *Pp += 1; break;
+	case 0x05: case 0x12: *Pp += 2; break;
+	case 0x06: case 0x0e: case 0x13: case 0x17: *Pp += 4; break;
+	case 0x07: case 0x14: case 0x20: *Pp += 8; break;
+	case 0x10: *Pp += (Version <= 2) ? AddrSize : 4; break;	/* ref_addr */
+	case 0x0d: case 0x0f: case 0x15: GetUleb(Pp, End); break;
+	case 0x19: break;				/* flag_present */
+	case 0x08:					/* string */
+		while ((*Pp < End) && (**Pp != 0))
+			(*Pp)++;
+		(*Pp)++;
+		break;
+	case 0x09: case 0x18:				/* block, exprloc */
+		Len = GetUleb(Pp, End);
+		*Pp += Len;
+		break;
+	case 0x0a: Len = **Pp; *Pp += 1 + Len; break;
+	case 0x03: Len = Get16(*Pp); *Pp += 2 + Len; break;
+	case 0x04: Len = Get32(*Pp); *Pp += 4 + Len; break;
+	default:
+		return -1;
+	}
+	return (*Pp <= End) ? 0 : -1;
+}
+
+/*
+ * DW_AT_name of the compilation unit at an offset of .debug_info
+ */
+static const char *CuName(Section *Info, Section *Abbrev, Section *Str,
+		unsigned long CuOff)
+{
+	const unsigned char *p, *End, *a, *AbbrevEnd;
+	unsigned long Version, Code;
+	unsigned int AddrSize;
+
+	if (CuOff + 11 > Info->Size)
+		return NULL;
+	p = Elf + Info->Offset + CuOff;
+	End = p + 4 + Get32(p);
+	if ((Get32(p) == 0xFFFFFFFF) || (End > Elf + Info->Offset + Info->Size))
+		return NULL;
+	Version = Get16(p + 4);
+	a = Elf + Abbrev->Offset + Get32(p + 6);
+	AbbrevEnd = Elf + Abbrev->Offset + Abbrev->Size;
+	AddrSize = p[10];
+	p += 11;
+
+	Code = GetUleb(&p, End);
+	while (a < AbbrevEnd) {
+		unsigned long ThisCode = GetUleb(&a, AbbrevEnd);
+		unsigned long Tag = GetUleb(&a, AbbrevEnd);
+
+		if (ThisCode == 0)
+			return NULL;
+		a++;				/* children */
+		if (ThisCode == Code) {
+			if (Tag != DW_TAG_compile_unit)
+				return NULL;
+			break;
+		}
+		while (a < AbbrevEnd) {
+			unsigned long Attr = GetUleb(&a, AbbrevEnd);
+			unsigned long Form = GetUleb(&a, AbbrevEnd);
+
+			if ((Attr == 0) && (Form == 0))
+				break;
+		}
+	}
+
+	while (a < AbbrevEnd) {
+		unsigned long Attr = GetUleb(&a, AbbrevEnd);
+		unsigned long Form = GetUleb(&a, AbbrevEnd);
+
+		if ((Attr == 0) && (Form == 0))
+			break;
+		if (Attr == DW_AT_name) {
+			if (Form == 0x08)
+				return (const char *)p;
+			if ((Form == 0x0e) && (Str != NULL) &&
+					(Get32(p) < Str->Size))
+				return (const char *)Elf + Str->Offset + Get32(p);
+			return NULL;
+		}
+		if (SkipForm(&p, End, Form, AddrSize, Version) != 0)
+			return NULL;
+	}
+	return NULL;
+}
+
+/*
+ * Address ranges of the compilation units from .debug_aranges
+ */
+static void LoadAranges(void)
+{
+	Section *Aranges = NULL, *Info = NULL, *Abbrev = NULL, *Str = NULL;
+	const unsigned char *p, *End;
+	unsigned long Index;
+
+	for (Index = 0; Index < NumSects; Index++) {
+		Section *Sect = &SectTbl[Index];
+
+		if ((Sect->Type == SHT_NOBITS) || (Sect->Offset + Sect->Size > ElfLen))
+			continue;
+		if (strcmp(Sect->Name, ".debug_aranges") == 0)
+			Aranges = Sect;
+		else if (strcmp(Sect->Name, ".debug_info") == 0)
+			Info = Sect;
+		else if (strcmp(Sect->Name, ".debug_abbrev") == 0)
+			Abbrev = Sect;
+		else if (strcmp(Sect->Name, ".debug_str") == 0)
+			Str = Sect;
+	}
+	if ((Aranges == NULL) || (Info == NULL) || (Abbrev == NULL))
+		return;
+
+	p = Elf + Aranges->Offset;
+	End = p + Aranges->Size;
+	while (p + 16 <= End) {
+		const unsigned char *SetEnd = p + 4 + Get32(p);
+		const unsigned char *Tuple = p + 16;
+		const char *Name;
+		int Mod;
+
+		if ((SetEnd > End) || (p[10] != 4) || (p[11] != 0))
+			break;
+
+		Name = CuName(Info, Abbrev, Str, Get32(p + 6));
+		Mod = GetModule(Name != NULL ? Name : "<unnamed cu>");
+		for (; Tuple + 8 <= SetEnd; Tuple += 8) {
+			unsigned long Addr = Get32(Tuple);
+			unsigned long Size = Get32(Tuple + 4);
+
+			if ((Addr == 0) && (Size == 0))
+				break;
+			if (FindSectionAddr(Addr) != NULL)
+				AddRange(Addr, Size, Mod);
+		}
+		p = SetEnd;
+	}
+}
+
+/*
+ * Input sections of the memory map part of a GNU ld map file. Long input
+ * section names put the address, size and file on the next line.
+ */
+static int LoadMap(const char *Path)
+{
+	FILE *Fp;
+	char Line[1024];
+	char Pending[256] = "";
+	int InMap = 0;
+	int InAlloc = 0;
+
+	Fp = fopen(Path, "r");
+	if (Fp == NULL) {
+		perror(Path);
+		return -1;
+	}
+
+	while (fgets(Line, sizeof(Line), Fp) != NULL) {
+		char Name[256], File[512];
+		unsigned long Addr, Size;
+		int Fields;
+
+		if (!InMap) {
+			if (strncmp(Line, "Linker script and memory map", 28) == 0)
+				InMap = 1;
+			continue;
+		}
+		if (strncmp(Line, "OUTPUT(", 7) == 0)
+			break;
+
+		if (Line[0] == '.') {
+			/* Output section */
+			if (sscanf(Line, "%255s", Name) == 1)
+				InAlloc = (FindSection(Name) != NULL);
+			Pending[0] = '\0';
+			continue;
+		}
+		if (!InAlloc)
+			continue;
+
+		if (Pending[0] != '\0') {
+			Fields = sscanf(Line, " %li %li %511[^\r\n]", &Addr, &Size, File);
+			Pending[0] = '\0';
+			if ((Fields == 3) && (Size != 0))
+				AddRange(Addr, Size, GetModule(File));
+			continue;
+		}
+		if ((Line[0] != ' ') || (Line[1] == ' ') || (Line[1] == '\n'))
+			continue;
+
+		Fields = sscanf(Line, " %255s %li %li %511[^\r\n]", Name, &Addr,
+				&Size, File);
+		if ((Fields == 1) && (Name[0] == '.'))
+			strcpy(Pending, Name);
+		else if ((Fields == 4) && (Size != 0))
+			AddRange(Addr, Size, GetModule(File));
+		else if ((Fields == 3) && (strcmp(Name, "*fill*") == 0) &&
+				(Size != 0))
+			AddRange(Addr, Size, GetModule("<fill>"));
+	}
+	fclose(Fp);
+
+	if (NumRanges == 0) {
+		fprintf(stderr, "%s: no input sections\n", Path);
+		return -1;
+	}
+	RangesFromMap = 1;
+	return 0;
+}
+
+static int CompareSymAddr(const void *A, const void *B)
+{
+	const Symbol *SymA = A;
+	const Symbol *SymB = B;
+
+	if (SymA->Addr != SymB->Addr)
+		return SymA->Addr < SymB->Addr ? -1 : 1;
+	return SymA->Type - SymB->Type;
+}
+
+/*
+ * Collect the sized STT_FUNC and STT_OBJECT symbols of allocated sections,
+ * sorted by address. Locals remember the STT_FILE symbol before them.
+ */
+static int LoadSymbols(void)
+{
+	unsigned long ShOff = Get32(Elf + 32);
+	unsigned long ShEntSize = Get16(Elf + 46);
+	unsigned long Index, Out;
+
+	for (Index = 0; Index < NumSects; Index++) {
+		const unsigned char *Sh = Elf + ShOff + Index * ShEntSize;
+		unsigned long SymOff, SymSize, StrOff, StrSize, Entry;
+		const unsigned char *StrSh;
+		int FileMod = -1;
+
+		if (SectTbl[Index].Type != SHT_SYMTAB)
+			continue;
+
+		SymOff = Get32(Sh + 16);
+		SymSize = Get32(Sh + 20);
+		if ((Get32(Sh + 24) >= NumSects) || (Get32(Sh + 36) != 16) ||
+				(SymOff + SymSize > ElfLen))
+			return -1;
+		StrSh = Elf + ShOff + Get32(Sh + 24) * ShEntSize;
+		StrOff = Get32(StrSh + 16);
+		StrSize = Get32(StrSh + 20);
+		if (StrOff + StrSize > ElfLen)
+			return -1;
+
+		SymTbl = calloc(SymSize / 16 + 1, sizeof(Symbol));
+		if (SymTbl == NULL)
+			return -1;
+
+		for (Entry = 0; Entry < SymSize / 16; Entry++) {
+			const unsigned char *Sym = Elf + SymOff + Entry * 16;
+			unsigned long NameOff = Get32(Sym);
+			unsigned long Ndx = Get16(Sym + 14);
+			int Type = Sym[12] & 0xF;
+			Symbol *New = &SymTbl[NumSyms];
+
+			if (NameOff >= StrSize)
+				continue;
+			if (Type == STT_FILE) {
+				FileMod = GetModule((const char *)Elf + StrOff + NameOff);
+				continue;
+			}
+			if (((Type != STT_FUNC) && (Type != STT_OBJECT)) ||
+					(Get32(Sym + 8) == 0) || (Ndx >= NumSects) ||
+					!(SectTbl[Ndx].Flags & SHF_ALLOC))
+				continue;
+
+			New->Addr = Get32(Sym + 4);
+			New->Size = Get32(Sym + 8);
+			New->Name = (const char *)Elf + StrOff + NameOff;
+			New->Type = Type;
+			New->Sect = Ndx;
+			New->Module = ((Sym[12] >> 4) == STB_LOCAL) ? FileMod : -1;
+			if (Type == STT_FUNC) {
+				if (New->Addr & 1)
+					ThumbFuncs++;
+				New->Addr &= ~1UL;
+			}
+			NumSyms++;
+		}
+		break;
+	}
+
+	if (NumSyms == 0) {
+		fprintf(stderr, "no symbols\n");
+		return -1;
+	}
+
+	qsort(SymTbl, NumSyms, sizeof(Symbol), CompareSymAddr);
+
+	/* Aliases share an address, keep the first */
+	for (Index = 1, Out = 1; Index < NumSyms; Index++) {
+		if (SymTbl[Index].Addr != SymTbl[Out - 1].Addr)
+			SymTbl[Out++] = SymTbl[Index];
+	}
+	NumSyms = Out;
+
+	return 0;
+}
+
+static Symbol *FindSymbol(unsigned long Addr)
+{
+	unsigned long Low = 0;
+	unsigned long High = NumSyms;
+
+	while (Low < High) {
+		unsigned long Mid = (Low + High) / 2;
+
+		if (SymTbl[Mid].Addr <= Addr)
+			Low = Mid + 1;
+		else
+			High = Mid;
+	}
+	if ((Low == 0) || (Addr >= SymTbl[Low - 1].Addr + SymTbl[Low - 1].Size))
+		return NULL;
+
+	return &SymTbl[Low - 1];
+}
+
+static Symbol *FindSymbolName(const char *Name)
+{
+	unsigned long Index;
+
+	for (Index = 0; Index < NumSyms; Index++) {
+		if (strcmp(SymTbl[Index].Name, Name) == 0)
+			return &SymTbl[Index];
+	}
+	return NULL;
+}
+
+static void PushEdge(unsigned long From, unsigned long To)
+{
+	if (NumEdges == MaxEdges) {
+		MaxEdges = MaxEdges ? MaxEdges * 2 : 1024;
+		EdgeTbl = realloc(EdgeTbl, MaxEdges * sizeof(Edge));
+		if (EdgeTbl == NULL) {
+			fprintf(stderr, "out of memory\n");
+			exit(1);
+		}
+	}
+	EdgeTbl[NumEdges].From = From;
+	EdgeTbl[NumEdges].To = To;
+	NumEdges++;
+}
+
+/*
+ * A branch target or an address found in code or data. From is the index
+ * of the referencing function, or -1 for data and code outside functions,
+ * which always stays in OCM.
+ */
+static void AddRef(long From, unsigned long Value, int IsBranch)
+{
+	Symbol *Sym = FindSymbol(Value & ~1UL);
+
+	if ((Sym == NULL) || (Sym - SymTbl == From))
+		return;
+
+	if (Sym->Type == STT_FUNC) {
+		if (!IsBranch && (Sym->Addr != (Value & ~1UL)))
+			return;
+		if (From < 0)
+			Sym->Root = 1;
+		else
+			PushEdge(From, Sym - SymTbl);
+		return;
+	}
+	if (IsBranch)
+		return;
+	if (From < 0)
+		Sym->RefResident = 1;
+	else
+		PushEdge(From, Sym - SymTbl);
+}
+
+/*
+ * Walk the words of ARM code: B, BL and BLX give call edges, MOVW/MOVT
+ * pairs and literal pool words give address references.
+ */
+static void ScanCode(long From, unsigned long Addr, unsigned long Size,
+		const unsigned char *Code, int Thumb)
+{
+	unsigned long Movw[16];
+	unsigned int MovwValid = 0;
+	unsigned long Off;
+
+	for (Off = 0; Off + 4 <= Size; Off += 4) {
+		unsigned long Insn = Get32(Code + Off);
+		unsigned long Rd = (Insn >> 12) & 0xF;
+		unsigned long Imm16 = ((Insn >> 4) & 0xF000) | (Insn & 0xFFF);
+
+		AddRef(From, Insn, 0);
+		if (Thumb)
+			continue;
+
+		if ((Insn & 0x0E000000) == 0x0A000000) {
+			long Imm = Insn & 0x00FFFFFF;
+			unsigned long Target;
+
+			if (Imm & 0x00800000)
+				Imm -= 0x01000000;
+			Target = Addr + Off + 8 + Imm * 4;
+			if ((Insn >> 28) == 0xF)
+				Target += (Insn >> 23) & 2;
+			AddRef(From, Target, 1);
+		} else if ((Insn & 0x0FF00000) == 0x03000000) {
+			Movw[Rd] = Imm16;
+			MovwValid |= 1 << Rd;
+		} else if (((Insn & 0x0FF00000) == 0x03400000) &&
+				(MovwValid & (1 << Rd))) {
+			AddRef(From, (Imm16 << 16) | Movw[Rd], 0);
+			MovwValid &= ~(1 << Rd);
+		}
+	}
+}
+
+static void BuildGraph(void)
+{
+	unsigned long Index;
+
+	for (Index = 0; Index < NumSyms; Index++) {
+		Symbol *Sym = &SymTbl[Index];
+		Section *Sect = &SectTbl[Sym->Sect];
+
+		Sym->FirstEdge = NumEdges;
+		if ((Sym->Type == STT_FUNC) && (Sect->Type != SHT_NOBITS) &&
+				(Sym->Addr + Sym->Size <= Sect->Addr + Sect->Size))
+			ScanCode(Index, Sym->Addr, Sym->Size,
+					Elf + Sect->Offset + Sym->Addr - Sect->Addr,
+					(Sym->Addr & 3) != 0);
+		Sym->NumEdges = NumEdges - Sym->FirstEdge;
+	}
+
+	/* Data and assembly code outside function symbols */
+	for (Index = 0; Index < NumSects; Index++) {
+		Section *Sect = &SectTbl[Index];
+		unsigned long Addr;
+
+		if (!(Sect->Flags & SHF_ALLOC) || (Sect->Type == SHT_NOBITS))
+			continue;
+
+		for (Addr = Sect->Addr; Addr + 4 <= Sect->Addr + Sect->Size;
+				Addr += 4) {
+			Symbol *Sym = FindSymbol(Addr);
+			const unsigned char *Word = Elf + Sect->Offset +
+				(Addr - Sect->Addr);
+
+			if ((Sym != NULL) && (Sym->Type == STT_FUNC)) {
+				Addr = ((Sym->Addr + Sym->Size + 3) & ~3UL) - 4;
+				continue;
+			}
+			if (Sect->Flags & SHF_EXECINSTR)
+				ScanCode(-1, Addr, 4, Word, 0);
+			else
+				AddRef(-1, Get32(Word), 0);
+		}
+	}
+}
+
+/*
+ * Debug ranges only cover code. A global object without a module goes to
+ * the module of the first function using it.
+ */
+static void InferObjectModules(void)
+{
+	unsigned long Edge;
+
+	for (Edge = 0; Edge < NumEdges; Edge++) {
+		Symbol *From = &SymTbl[EdgeTbl[Edge].From];
+		Symbol *To = &SymTbl[EdgeTbl[Edge].To];
+		int Mod;
+
+		if ((To->Type != STT_OBJECT) || (To->Module >= 0) ||
+				(FindRangeModule(To->Addr) >= 0))
+			continue;
+		Mod = FindRangeModule(From->Addr);
+		To->Module = (Mod >= 0) ? Mod : From->Module;
+	}
+}
+
+static void MarkResident(unsigned long Index)
+{
+	unsigned long *Stack;
+	unsigned long Depth = 0;
+
+	Stack = malloc(NumSyms * sizeof(unsigned long));
+	if (Stack == NULL) {
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+
+	if (SymTbl[Index].Class != CLASS_RESIDENT) {
+		SymTbl[Index].Class = CLASS_RESIDENT;
+		Stack[Depth++] = Index;
+	}
+	while (Depth != 0) {
+		Symbol *Sym = &SymTbl[Stack[--Depth]];
+		unsigned long Edge;
+
+		if (strcmp(Sym->Name, StopAt) == 0)
+			continue;
+		for (Edge = Sym->FirstEdge; Edge < Sym->FirstEdge + Sym->NumEdges;
+				Edge++) {
+			Symbol *To = &SymTbl[EdgeTbl[Edge].To];
+
+			if ((To->Type == STT_FUNC) && (To->Class != CLASS_RESIDENT)) {
+				To->Class = CLASS_RESIDENT;
+				Stack[Depth++] = To - SymTbl;
+			}
+		}
+	}
+
+	free(Stack);
+}
+
+static int IsColdName(const char *Name)
+{
+	unsigned int Index;
+
+	for (Index = 0; ColdNames[Index] != NULL; Index++) {
+		if (strstr(Name, ColdNames[Index]) != NULL)
+			return 1;
+	}
+	return 0;
+}
+
+static void Classify(void)
+{
+	unsigned long Index, Edge;
+	unsigned int Keep;
+
+	for (Index = 0; DefaultRoots[Index] != NULL; Index++) {
+		Symbol *Sym = FindSymbolName(DefaultRoots[Index]);
+
+		if (Sym != NULL)
+			Sym->Root = 1;
+	}
+	for (Keep = 0; Keep < NumKeep; Keep++) {
+		Symbol *Sym = FindSymbolName(KeepTbl[Keep]);
+
+		if (Sym != NULL)
+			Sym->Root = 1;
+		else
+			fprintf(stderr, "warning: %s not found\n", KeepTbl[Keep]);
+	}
+
+	for (Index = 0; Index < NumSyms; Index++) {
+		if ((SymTbl[Index].Type == STT_FUNC) && SymTbl[Index].Root)
+			MarkResident(Index);
+	}
+
+	for (Index = 0; Index < NumSyms; Index++) {
+		Symbol *Sym = &SymTbl[Index];
+
+		if ((Sym->Type != STT_FUNC) || (Sym->Class == CLASS_RESIDENT))
+			continue;
+		if (Sym->Samples != 0)
+			Sym->Class = CLASS_HOT;
+		else if (HaveProfile || IsColdName(Sym->Name))
+			Sym->Class = CLASS_COLD;
+	}
+
+	for (Edge = 0; Edge < NumEdges; Edge++) {
+		Symbol *From = &SymTbl[EdgeTbl[Edge].From];
+		Symbol *To = &SymTbl[EdgeTbl[Edge].To];
+
+		if (To->Type != STT_OBJECT)
+			continue;
+		if (From->Class == CLASS_RESIDENT)
+			To->RefResident = 1;
+		else if (From->Class == CLASS_COLD)
+			To->RefOther = 1;
+		else
+			To->RefHot = 1;
+	}
+}
+
+/*
+ * Objects only used by cold code follow it into DDR
+ */
+static int IsMovableObject(const Symbol *Sym)
+{
+	return (Sym->Type == STT_OBJECT) && !Sym->RefResident && !Sym->RefHot &&
+		Sym->RefOther && !Sym->Root;
+}
+
+/*
+ * Attribute every histogram bin of a gmon file to the function holding the
+ * start of the bin.
+ */
+static int LoadGmon(const char *Path)
+{
+	unsigned char *Buf;
+	unsigned long Len, Pos;
+
+	Buf = ReadFile(Path, &Len);
+	if (Buf == NULL)
+		return -1;
+
+	if ((Len < GMON_HDR_LEN) || memcmp(Buf, "gmon", 4)) {
+		fprintf(stderr, "%s: not a gmon file\n", Path);
+		free(Buf);
+		return -1;
+	}
+
+	Pos = GMON_HDR_LEN;
+	while (Pos < Len) {
+		unsigned long LowPc, HighPc, NumBins, Bin, BinSize;
+		const unsigned char *Rec = Buf + Pos;
+
+		if (Rec[0] == GMON_TAG_CG_ARC) {
+			Pos += 1 + GMON_CG_ARC_LEN;
+			continue;
+		}
+		if ((Rec[0] != GMON_TAG_TIME_HIST) ||
+				(Pos + 18 + GMON_HIST_DIMEN_LEN > Len)) {
+			fprintf(stderr, "%s: unsupported record at %lu\n", Path, Pos);
+			free(Buf);
+			return -1;
+		}
+
+		LowPc = Get32(Rec + 1);
+		HighPc = Get32(Rec + 5);
+		NumBins = Get32(Rec + 9);
+		Pos += 18 + GMON_HIST_DIMEN_LEN;
+
+		if ((NumBins == 0) || (Pos + NumBins * 2 > Len)) {
+			fprintf(stderr, "%s: truncated histogram\n", Path);
+			free(Buf);
+			return -1;
+		}
+		BinSize = (HighPc - LowPc) / NumBins;
+
+		for (Bin = 0; Bin < NumBins; Bin++) {
+			unsigned long Count = Get16(Buf + Pos + Bin * 2);
+			Symbol *Sym;
+
+			if (Count == 0)
+				continue;
+			Sym = FindSymbol(LowPc + Bin * BinSize);
+			if ((Sym != NULL) && (Sym->Type == STT_FUNC))
+				Sym->Samples += Count;
+		}
+		Pos += NumBins * 2;
+	}
+	free(Buf);
+
+	HaveProfile = 1;
+	return 0;
+}
+
+static int CompareModTotal(const void *A, const void *B)
+{
+	const Module *ModA = A;
+	const Module *ModB = B;
+
+	if (ModA->Total != ModB->Total)
+		return ModA->Total > ModB->Total ? -1 : 1;
+	return strcmp(ModA->Name, ModB->Name);
+}
+
+/*
+ * Module of a symbol: its input section or compilation unit, else the
+ * STT_FILE symbol of a local
+ */
+static const char *SymModule(const Symbol *Sym)
+{
+	int Mod = FindRangeModule(Sym->Addr);
+
+	if (Mod < 0)
+		Mod = Sym->Module;
+	return (Mod < 0) ? "?" : ModTbl[Mod].Name;
+}
+
+static void ReportRegions(const char *Path)
+{
+	unsigned long Index;
+	unsigned int Reg;
+
+	printf("%s\n\n", Path);
+	printf("region                     origin     length     used     free\n");
+	for (Reg = 0; Reg < NumRegions; Reg++) {
+		printf("%-26s 0x%08lx %8lu %8lu %8ld\n", RegionTbl[Reg].Name,
+				RegionTbl[Reg].Origin, RegionTbl[Reg].Length,
+				RegionTbl[Reg].Used,
+				(long)(RegionTbl[Reg].Length - RegionTbl[Reg].Used));
+	}
+
+	printf("\nsection            address      size  class   region\n");
+	for (Index = 0; Index < NumSects; Index++) {
+		Section *Sect = &SectTbl[Index];
+
+		if (!(Sect->Flags & SHF_ALLOC) || (Sect->Size == 0))
+			continue;
+		printf("%-18s 0x%08lx %8lu  %-7s %s\n", Sect->Name, Sect->Addr,
+				Sect->Size, ColName[Sect->Col],
+				(Sect->Region >= 0) ? RegionTbl[Sect->Region].Name :
+				"<none>");
+	}
+}
+
+/*
+ * Per module sizes from the input sections of the map file, else from the
+ * symbols. The rest of a section goes to a pseudo module named after it.
+ */
+static void ReportModules(void)
+{
+	unsigned long Index, Attributed;
+	unsigned long Total = 0;
+	Module *Sorted;
+	unsigned int Mod, Col;
+	char Name[64];
+
+	for (Index = 0; Index < NumSects; Index++) {
+		Section *Sect = &SectTbl[Index];
+		unsigned long Entry;
+
+		if (!(Sect->Flags & SHF_ALLOC) || (Sect->Size == 0) ||
+				(Sect->Region < 0))
+			continue;
+
+		Attributed = 0;
+		if (RangesFromMap) {
+			for (Entry = 0; Entry < NumRanges; Entry++) {
+				Range *Rng = &RangeTbl[Entry];
+
+				if ((Rng->Addr < Sect->Addr) ||
+						(Rng->Addr >= Sect->Addr + Sect->Size))
+					continue;
+				ModTbl[Rng->Module].Size[Sect->Col] += Rng->Size;
+				Attributed += Rng->Size;
+			}
+		} else {
+			for (Entry = 0; Entry < NumSyms; Entry++) {
+				Symbol *Sym = &SymTbl[Entry];
+				int SymMod;
+
+				if (Sym->Sect != (int)Index)
+					continue;
+				SymMod = FindRangeModule(Sym->Addr);
+				if (SymMod < 0)
+					SymMod = (Sym->Module >= 0) ? Sym->Module :
+						GetModule("<no debug info>");
+				ModTbl[SymMod].Size[Sect->Col] += Sym->Size;
+				Attributed += Sym->Size;
+			}
+		}
+		if (Attributed < Sect->Size) {
+			snprintf(Name, sizeof(Name), "<%s>", Sect->Name);
+			Mod = GetModule(Name);
+			ModTbl[Mod].Size[Sect->Col] += Sect->Size - Attributed;
+		}
+	}
+
+	Sorted = malloc(NumMods * sizeof(Module));
+	if (Sorted == NULL)
+		return;
+	memcpy(Sorted, ModTbl, NumMods * sizeof(Module));
+	for (Mod = 0; Mod < NumMods; Mod++) {
+		Sorted[Mod].Total = 0;
+		for (Col = 0; Col < NUM_COLS; Col++)
+			Sorted[Mod].Total += Sorted[Mod].Size[Col];
+		Total += Sorted[Mod].Total;
+	}
+	qsort(Sorted, NumMods, sizeof(Module), CompareModTotal);
+
+	printf("\nmodules by %s\n", RangesFromMap ? "input section" :
+			(NumRanges != 0) ? "compilation unit" : "symbol file");
+	printf("module                        text   rodata     data      bss"
+			"    total      %%\n");
+	for (Mod = 0; (Mod < NumMods) && (Sorted[Mod].Total != 0); Mod++) {
+		printf("%-24.24s %9lu %8lu %8lu %8lu %8lu %6.2f\n", Sorted[Mod].Name,
+				Sorted[Mod].Size[COL_TEXT], Sorted[Mod].Size[COL_RODATA],
+				Sorted[Mod].Size[COL_DATA], Sorted[Mod].Size[COL_BSS],
+				Sorted[Mod].Total, 100.0 * Sorted[Mod].Total / Total);
+	}
+	free(Sorted);
+}
+
+/*
+ * ps7_init.c carries its tables for every silicon version as
+ * ps7_<group>_init_data_<major>_<minor> and ps7_post_config_<major>_<minor>.
+ */
+static void ReportSilicon(void)
+{
+	unsigned long Size[10] = { 0 };
+	unsigned long Count[10] = { 0 };
+	unsigned long Total = 0, Largest = 0;
+	unsigned long Index;
+	unsigned int Ver, NumVers = 0;
+
+	for (Index = 0; Index < NumSyms; Index++) {
+		const char *Name = SymTbl[Index].Name;
+		const char *Suffix = strstr(Name, "_init_data_");
+		unsigned int Major, Minor;
+
+		if (strncmp(Name, "ps7_", 4) != 0)
+			continue;
+		if (Suffix == NULL)
+			Suffix = strstr(Name, "_post_config_");
+		if ((Suffix == NULL) ||
+				(sscanf(strchr(Suffix + 1, '_') + 1, "%*[a-z]_%u_%u",
+					&Major, &Minor) != 2) || (Major >= 10))
+			continue;
+		Size[Major] += SymTbl[Index].Size;
+		Count[Major]++;
+	}
+
+	for (Ver = 0; Ver < 10; Ver++) {
+		Total += Size[Ver];
+		if (Size[Ver] > Largest)
+			Largest = Size[Ver];
+		if (Count[Ver] != 0)
+			NumVers++;
+	}
+	if (Total == 0)
+		return;
+
+	printf("\nps7_init tables per silicon version\n");
+	for (Ver = 0; Ver < 10; Ver++) {
+		if (Count[Ver] != 0)
+			printf("  %u.0: %lu tables, %lu bytes\n", Ver, Count[Ver],
+					Size[Ver]);
+	}
+	if (NumVers == 1) {
+		printf("  built for a single silicon version (PS7_INIT_SILICON)\n");
+		return;
+	}
+	printf("  they run before DDR is up and stay in OCM, a build for a single\n"
+			"  silicon version (PS7_INIT_SILICON) frees up to %lu bytes",
+			Total - Largest);
+	if (MediaRate != 0)
+		printf(", %.0f us of\n  FSBL load at %.1f MB/s",
+				(Total - Largest) / MediaRate, MediaRate);
+	printf("\n");
+}
+
+static unsigned long ReportPlan(FILE *Ld, unsigned long OverlayAddr)
+{
+	unsigned long Size[4] = { 0 };
+	unsigned long Count[4] = { 0 };
+	unsigned long Code = 0, Data = 0, Bss = 0;
+	unsigned long Index;
+
+	for (Index = 0; Index < NumSyms; Index++) {
+		if (SymTbl[Index].Type == STT_FUNC) {
+			Size[SymTbl[Index].Class] += SymTbl[Index].Size;
+			Count[SymTbl[Index].Class]++;
+		}
+	}
+
+	printf("\nboot phases: reset -> ps7_init (DDR up) -> %s\n",
+			HaveProfile ? "profiled boot" : "post DDR, no profile");
+	printf("  resident  %4lu functions %8lu bytes  reset, ps7_init, "
+			"loader, indirect\n", Count[CLASS_RESIDENT],
+			Size[CLASS_RESIDENT]);
+	if (HaveProfile)
+		printf("  hot       %4lu functions %8lu bytes  sampled after DDR\n",
+				Count[CLASS_HOT], Size[CLASS_HOT]);
+	else
+		printf("  warm      %4lu functions %8lu bytes  post DDR, needs a "
+				"profile to place\n", Count[CLASS_WARM],
+				Size[CLASS_WARM]);
+	printf("  cold      %4lu functions %8lu bytes  %s\n", Count[CLASS_COLD],
+			Size[CLASS_COLD], HaveProfile ? "never sampled" :
+			"debug paths");
+	if (ThumbFuncs != 0)
+		printf("  %lu Thumb functions, their branches are not followed\n",
+				ThumbFuncs);
+
+	printf("\noverlay candidates at 0x%08lx\n", OverlayAddr);
+	printf("  %-32s %8s  %-7s %s\n", "symbol", "size", "class", "module");
+	for (Index = 0; Index < NumSyms; Index++) {
+		Symbol *Sym = &SymTbl[Index];
+		int Col = SectTbl[Sym->Sect].Col;
+
+		if ((Sym->Type == STT_FUNC) ? (Sym->Class != CLASS_COLD) :
+				!IsMovableObject(Sym))
+			continue;
+		printf("  %-32.32s %8lu  %-7s %s\n", Sym->Name, Sym->Size,
+				ColName[Col], SymModule(Sym));
+		if (Col == COL_BSS)
+			Bss += Sym->Size;
+		else if (Col == COL_TEXT)
+			Code += Sym->Size;
+		else
+			Data += Sym->Size;
+	}
+
+	if (Ld != NULL) {
+		fprintf(Ld, "/* Generated by ocmplan, include ahead of .text */\n\n");
+		fprintf(Ld, ".ddr_overlay 0x%08lx : {\n", OverlayAddr);
+		fprintf(Ld, "   __ddr_overlay_start = .;\n");
+		for (Index = 0; Index < NumSyms; Index++) {
+			Symbol *Sym = &SymTbl[Index];
+			int Col = SectTbl[Sym->Sect].Col;
+
+			if (Sym->Type == STT_FUNC && Sym->Class == CLASS_COLD)
+				fprintf(Ld, "   *(.text.%s)\n", Sym->Name);
+			else if (IsMovableObject(Sym) && (Col == COL_RODATA))
+				fprintf(Ld, "   *(.rodata.%s)\n", Sym->Name);
+			else if (IsMovableObject(Sym) && (Col == COL_DATA))
+				fprintf(Ld, "   *(.data.%s)\n", Sym->Name);
+		}
+		fprintf(Ld, "   __ddr_overlay_end = .;\n}\n\n");
+		fprintf(Ld, ".ddr_bss (NOLOAD) : {\n");
+		fprintf(Ld, "   __ddr_bss_start = .;\n");
+		for (Index = 0; Index < NumSyms; Index++) {
+			Symbol *Sym = &SymTbl[Index];
+
+			if (IsMovableObject(Sym) && (SectTbl[Sym->Sect].Col == COL_BSS))
+				fprintf(Ld, "   *(.bss.%s)\n", Sym->Name);
+		}
+		fprintf(Ld, "   __ddr_bss_end = .;\n}\n");
+	}
+
+	printf("\n  code %lu, data %lu, bss %lu bytes leave OCM, %lu bytes are "
+			"loaded after ps7_init\n", Code, Data, Bss, Code + Data);
+	return Code + Data + Bss;
+}
+
+int main(int argc, char **argv)
+{
+	const char *MapPath = NULL, *LdPath = NULL, *FragPath = NULL;
+	const char *ElfPath;
+	unsigned long OverlayAddr = DEFAULT_OVERLAY_ADDR;
+	unsigned long Freed;
+	FILE *Ld = NULL;
+	int Arg;
+	int Status = 0;
+
+	for (Arg = 1; (Arg < argc - 1) && (argv[Arg][0] == '-'); Arg += 2) {
+		if (strcmp(argv[Arg], "-m") == 0)
+			MapPath = argv[Arg + 1];
+		else if (strcmp(argv[Arg], "-l") == 0)
+			LdPath = argv[Arg + 1];
+		else if (strcmp(argv[Arg], "-o") == 0)
+			FragPath = argv[Arg + 1];
+		else if (strcmp(argv[Arg], "-r") == 0)
+			MediaRate = strtod(argv[Arg + 1], NULL);
+		else if (strcmp(argv[Arg], "-a") == 0)
+			OverlayAddr = strtoul(argv[Arg + 1], NULL, 0);
+		else if ((strcmp(argv[Arg], "-k") == 0) && (NumKeep < MAX_KEEP))
+			KeepTbl[NumKeep++] = argv[Arg + 1];
+		else
+			break;
+	}
+	if ((Arg >= argc) || (argv[Arg][0] == '-')) {
+		fprintf(stderr, "usage: %s [-m <map>] [-l <lscript.ld>] "
+				"[-k <function>]... [-a <overlay address>] [-r <MB/s>] "
+				"[-o <fragment.ld>] <image.elf> [<gmon file> ...]\n",
+				argv[0]);
+		return 1;
+	}
+
+	if (LdPath != NULL) {
+		if (LoadLscript(LdPath) != 0)
+			return 1;
+	} else {
+		DefaultRegions();
+	}
+
+	ElfPath = argv[Arg];
+	Elf = ReadFile(ElfPath, &ElfLen);
+	if ((Elf == NULL) || (LoadSections() != 0))
+		return 1;
+	if (MapPath != NULL) {
+		if (LoadMap(MapPath) != 0)
+			return 1;
+	} else {
+		LoadAranges();
+	}
+	qsort(RangeTbl, NumRanges, sizeof(Range), CompareRangeAddr);
+	if (LoadSymbols() != 0)
+		return 1;
+
+	for (Arg++; Arg < argc; Arg++) {
+		if (LoadGmon(argv[Arg]) != 0)
+			Status = 1;
+	}
+
+	BuildGraph();
+	InferObjectModules();
+	Classify();
+
+	if (FragPath != NULL) {
+		Ld = fopen(FragPath, "w");
+		if (Ld == NULL) {
+			perror(FragPath);
+			return 1;
+		}
+	}
+
+	ReportRegions(ElfPath);
+	ReportModules();
+	ReportSilicon();
+	Freed = ReportPlan(Ld, OverlayAddr);
+
+	if ((NumRegions != 0) && (RegionTbl[0].Used <= RegionTbl[0].Length))
+		printf("  %s: %lu bytes free now, %lu after the move, for "
+				"bounce buffers\n", RegionTbl[0].Name,
+				RegionTbl[0].Length - RegionTbl[0].Used,
+				RegionTbl[0].Length - RegionTbl[0].Used + Freed);
+
+	if (Ld != NULL)
+		fclose(Ld);
+
+	return Status;
+}
@@ -0,0 +1,529 @@
+/******************************************************************************
+*
+* pcapasyncsim.c
+*
+* Host side test of the asynchronous bitstream load of the FSBL
+* (PCAP_ASYNC_LOAD). pcap.c, md5.c and the devcfg driver are built into the
+* tool, the register accesses go to a timed model of the devcfg DMA and of
+* the configuration logic.
+*
+* The boot image is a bitstream of -b KB followed by two PS partitions, a
+* 448 KB boot loader and an application of -a KB. Partitions are read from
+* SD at -s MB/s into DDR and hashed with md5() at -m MB/s, as image_mover.c
+* does for partitions with a checksum. The DMA writes the bitstream to the
+* configuration logic at -p MB/s, PCFG_DONE follows 100 us after the last
+* word. Each register access costs -r ns.
+*
+* The boot is run four ways:
+*   - sequential, PcapLoadPartition() blocks until PCFG_DONE,
+*   - FSBL, PcapLoadPartitionStart(), the PS partitions, PcapAsyncWait(),
+*   - polled, as FSBL with PcapAsyncPoll() after every 64 KB of work,
+*   - interrupt, as FSBL with the devcfg events unmasked and
+*     XDcfg_InterruptHandler() called by a modeled GIC after every 64 KB.
+* The test checks that
+*   - the configuration logic receives the bitstream in every run,
+*   - the PS partition hashes are those of the partitions,
+*   - PcapLoadPartitionStart() returns while the DMA runs,
+*   - ClearPcapStatus(), PcapDataTransfer() and a second load fail while a
+*     load is in flight and leave it running,
+*   - the completion handler is called once, with XST_SUCCESS,
+*   - an AXI read error during the load reaches the handler and
+*     PcapAsyncWait() as XST_FAILURE and releases the PCAP,
+*   - the asynchronous runs take less time than the sequential one.
+* Reported are the boot time of each run, the time saved, the part of the
+* PS partition work done while the fabric was programmed and the delay
+* from PCFG_DONE to the handler.
+*
+* Build: gcc -O2 -no-pie -DPCAP_ASYNC_LOAD -Wno-pointer-to-int-cast
+*		 -Wno-int-to-pointer-cast -o pcapasyncsim pcapasyncsim.c
+*		 -I../../FSBL/src -I../../FSBL_bsp/ps7_cortexa9_0/include
+*		 -I../../FSBL_bsp/ps7_cortexa9_0/libsrc/devcfg_v2_04_a/src
+*
+* The DMA addresses are 32-bit, -no-pie keeps the static buffers of the tool
+* below 4GB.
+*
+* Usage: pcapasyncsim [-a <KB>] [-b <KB>] [-m <MB/s>] [-p <MB/s>] [-r <ns>]
+*		 [-s <MB/s>]
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * 32-bit register and pointer arithmetic types of the target, xil_types.h
+ * leaves them out when XBASIC_TYPES_H is defined
+ */
+#define XBASIC_TYPES_H
+typedef unsigned char u8;
+typedef unsigned short u16;
+typedef unsigned int u32;
+
+#include "xdevcfg.c"
+#include "xdevcfg_intr.c"
+#include "xdevcfg_sinit.c"
+#include "xdevcfg_g.c"
+#include "pcap.c"
+#include "md5.c"
+
+#define MODEL_BASEADDR		XPAR_XDCFG_0_BASEADDR
+#define ADDR_INVALID		0xFFFFFFFF
+#define NEVER			1e300
+#define STARTUP_NS		100000.0
+
+#define MAX_BITSTREAM_KB	16384
+#define LOADER_KB		448
+#define MAX_APP_KB		16384
+#define CHUNK_BYTES		0x10000
+
+#define RUN_SEQUENTIAL		0
+#define RUN_FSBL		1
+#define RUN_POLLED		2
+#define RUN_INTERRUPT		3
+#define RUNS			4
+
+/*
+ * Boot image on SD and DDR
+ */
+static u32 Bitstream[MAX_BITSTREAM_KB * 256];
+static u32 BitWords;
+static u8 SdLoader[LOADER_KB * 1024];
+static u8 SdApp[MAX_APP_KB * 1024];
+static u32 AppBytes = 2048 * 1024;
+static u8 DdrTemp[MAX_BITSTREAM_KB * 1024] __attribute__((aligned(64)));
+static u8 DdrLoader[LOADER_KB * 1024];
+static u8 DdrApp[MAX_APP_KB * 1024];
+
+/*
+ * Timing
+ */
+static double Now;			/* ns */
+static double RegNs = 100;
+static double PcapNs = 4000.0 / 128;	/* per word */
+static double SdNs = 1000.0 / 20;	/* per byte */
+static double Md5Ns = 1000.0 / 60;	/* per byte */
+
+/*
+ * devcfg state, one DMA command at a time
+ */
+static u32 Regs[0x100 / 4];
+static u32 IntSts;
+static u32 DoneCount;
+static int Init = 1;
+static int Busy;
+static u32 CmdSrc;
+static u32 CmdSrcLen;
+static u32 CmdDst;
+static double CmdEnd;
+static double CfgDone = NEVER;
+static double ErrorAt = NEVER;
+static double ConfigStart;
+static double FabricEnd;		/* PCFG_DONE of the command running */
+static u32 ConfigHash;
+static int ConfigWords;
+
+/*
+ * Modeled GIC
+ */
+static int IrqRouted;
+static u32 Irqs;
+
+/*
+ * Completion handler
+ */
+static u32 HandlerCalls;
+static u32 HandlerStatus;
+static double HandlerTime;
+
+static u32 Errors;
+
+static u32 Hash(const u32 *Data, u32 Words)
+{
+	u32 Value = 0x12345678;
+	u32 Word;
+
+	for (Word = 0; Word < Words; Word++)
+		Value = ((Value << 5) | (Value >> 27)) ^ Data[Word];
+	return Value;
+}
+
+static void Advance(void)
+{
+	if (Busy && (Now >= ErrorAt)) {
+		/*
+		 * The command stops, no done events follow
+		 */
+		IntSts |= XDCFG_IXR_AXI_RERR_MASK;
+		Busy = 0;
+		ErrorAt = NEVER;
+		return;
+	}
+
+	if (Busy && (Now >= CmdEnd)) {
+		Busy = 0;
+		DoneCount++;
+		IntSts |= XDCFG_IXR_DMA_DONE_MASK;
+		if (((CmdSrc & 3) == 1) || ((CmdDst & 3) == 1))
+			IntSts |= XDCFG_IXR_D_P_DONE_MASK;
+		if (CmdDst == ADDR_INVALID + 0) {
+			ConfigHash = Hash((u32 *)(unsigned long)(CmdSrc & ~3),
+					CmdSrcLen);
+			ConfigWords = CmdSrcLen;
+			CfgDone = CmdEnd + STARTUP_NS;
+		}
+	}
+
+	if (Now >= CfgDone) {
+		IntSts |= XDCFG_IXR_PCFG_DONE_MASK;
+		CfgDone = NEVER;
+	}
+}
+
+static void StartCommand(void)
+{
+	CmdSrc = Regs[XDCFG_DMA_SRC_ADDR_OFFSET / 4];
+	CmdDst = Regs[XDCFG_DMA_DEST_ADDR_OFFSET / 4];
+	CmdSrcLen = Regs[XDCFG_DMA_SRC_LEN_OFFSET / 4];
+	if ((CmdDst & ~3) == (ADDR_INVALID & ~3))
+		CmdDst = ADDR_INVALID;
+	CmdEnd = Now + CmdSrcLen * PcapNs;
+	ConfigStart = Now;
+	FabricEnd = CmdEnd + STARTUP_NS;
+	Busy = 1;
+}
+
+u32 Xil_In32(u32 Addr)
+{
+	u32 Value;
+
+	Now += RegNs;
+	Advance();
+	if ((Addr < MODEL_BASEADDR) || (Addr >= MODEL_BASEADDR + sizeof(Regs)))
+		return 0;
+
+	switch (Addr - MODEL_BASEADDR) {
+	case XDCFG_INT_STS_OFFSET:
+		return IntSts;
+	case XDCFG_STATUS_OFFSET:
+		Value = ((DoneCount > 3) ? 3 : DoneCount) << 28;
+		if (!Busy)
+			Value |= XDCFG_STATUS_DMA_CMD_Q_E_MASK;
+		if (Init)
+			Value |= XDCFG_STATUS_PCFG_INIT_MASK;
+		return Value;
+	default:
+		return Regs[(Addr - MODEL_BASEADDR) / 4];
+	}
+}
+
+void Xil_Out32(u32 Addr, u32 Value)
+{
+	Now += RegNs;
+	Advance();
+	if ((Addr < MODEL_BASEADDR) || (Addr >= MODEL_BASEADDR + sizeof(Regs)))
+		return;
+
+	switch (Addr - MODEL_BASEADDR) {
+	case XDCFG_INT_STS_OFFSET:
+		/*
+		 * Clearing DMA_DONE acknowledges one finished command
+		 */
+		if ((Value & XDCFG_IXR_DMA_DONE_MASK) && DoneCount)
+			DoneCount--;
+		IntSts &= ~Value;
+		if (DoneCount)
+			IntSts |= XDCFG_IXR_DMA_DONE_MASK;
+		break;
+	case XDCFG_CTRL_OFFSET:
+		if (!(Value & XDCFG_CTRL_PCFG_PROG_B_MASK)) {
+			Init = 0;
+			CfgDone = NEVER;
+			ConfigWords = 0;
+		} else {
+			Init = 1;
+		}
+		Regs[XDCFG_CTRL_OFFSET / 4] = Value;
+		break;
+	case XDCFG_DMA_DEST_LEN_OFFSET:
+		Regs[XDCFG_DMA_DEST_LEN_OFFSET / 4] = Value;
+		if (Busy)
+			IntSts |= XDCFG_IXR_DMA_Q_OV_MASK;
+		else
+			StartCommand();
+		break;
+	default:
+		Regs[(Addr - MODEL_BASEADDR) / 4] = Value;
+		break;
+	}
+}
+
+int usleep(unsigned int useconds)
+{
+	Now += useconds * 1000.0;
+	Advance();
+	return 0;
+}
+
+void Xil_DCacheInvalidateRange(unsigned int adr, unsigned len)
+{
+}
+
+void Xil_DCacheFlushRange(unsigned int adr, unsigned len)
+{
+}
+
+unsigned int Xil_AssertStatus;
+
+void Xil_Assert(const char *File, int Line)
+{
+	fprintf(stderr, "assert %s:%d\n", File, Line);
+	exit(1);
+}
+
+static void Check(int Condition, const char *What)
+{
+	if (!Condition) {
+		printf("  FAIL: %s\n", What);
+		Errors++;
+	}
+}
+
+static void Handler(void *CallBackRef, u32 Status)
+{
+	HandlerCalls++;
+	HandlerStatus = Status;
+	HandlerTime = Now;
+}
+
+/*
+ * The devcfg interrupt as a GIC would deliver it at the end of a slice
+ * of CPU work
+ */
+static void Gic(void)
+{
+	if (IrqRouted && (IntSts & ~Regs[XDCFG_INT_MASK_OFFSET / 4] &
+			XDCFG_IXR_ALL_MASK)) {
+		Irqs++;
+		XDcfg_InterruptHandler(DcfgInstPtr);
+	}
+}
+
+/*
+ * Read a partition from SD into DDR and hash it, in slices of
+ * CHUNK_BYTES. Between slices the load is polled or the GIC modeled.
+ * Returns the ns spent while the DMA or the startup was running.
+ */
+static double LoadPartition(const u8 *Sd, u8 *Ddr, u32 Bytes, u8 *Digest,
+		int Run, PcapAsyncToken *Token)
+{
+	MD5Context Context;
+	double Overlap = 0;
+	double Start;
+	u32 Offset;
+	u32 Len;
+
+	MD5Init(&Context);
+	for (Offset = 0; Offset < Bytes; Offset += Len) {
+		Len = (Bytes - Offset > CHUNK_BYTES) ? CHUNK_BYTES : Bytes - Offset;
+		Start = Now;
+		memcpy(Ddr + Offset, Sd + Offset, Len);
+		MD5Update(&Context, Ddr + Offset, Len, FALSE);
+		Now += Len * (SdNs + Md5Ns);
+		Advance();
+		if ((ConfigStart <= Start) && (Start < FabricEnd))
+			Overlap += ((Now < FabricEnd) ? Now : FabricEnd) - Start;
+
+		if (Run == RUN_POLLED)
+			PcapAsyncPoll(Token);
+		else if (Run == RUN_INTERRUPT)
+			Gic();
+	}
+	MD5Final(&Context, Digest, FALSE);
+
+	return Overlap;
+}
+
+int main(int argc, char **argv)
+{
+	static const char *Names[RUNS] = {
+		"sequential", "FSBL", "polled", "interrupt"
+	};
+	PcapAsyncToken Token;
+	u8 LoaderDigest[16];
+	u8 AppDigest[16];
+	u8 Digest[16];
+	double Elapsed[RUNS];
+	double Overlap;
+	double Start;
+	double Returned;
+	double ConfigNs;
+	u32 BitKb = 3952;
+	u32 Word;
+	int Run;
+	int Arg;
+
+	for (Arg = 1; (Arg + 1 < argc) && (argv[Arg][0] == '-'); Arg += 2) {
+		if (strcmp(argv[Arg], "-a") == 0)
+			AppBytes = atoi(argv[Arg + 1]) * 1024;
+		else if (strcmp(argv[Arg], "-b") == 0)
+			BitKb = atoi(argv[Arg + 1]);
+		else if (strcmp(argv[Arg], "-m") == 0)
+			Md5Ns = 1000.0 / atof(argv[Arg + 1]);
+		else if (strcmp(argv[Arg], "-p") == 0)
+			PcapNs = 4000.0 / atof(argv[Arg + 1]);
+		else if (strcmp(argv[Arg], "-r") == 0)
+			RegNs = atof(argv[Arg + 1]);
+		else if (strcmp(argv[Arg], "-s") == 0)
+			SdNs = 1000.0 / atof(argv[Arg + 1]);
+		else
+			break;
+	}
+	if ((Arg < argc) || (AppBytes == 0) || (AppBytes > sizeof(SdApp)) ||
+			(BitKb == 0) || (BitKb > MAX_BITSTREAM_KB) || (PcapNs <= 0) ||
+			(Md5Ns <= 0) || (SdNs <= 0)) {
+		fprintf(stderr, "usage: %s [-a <KB>] [-b <KB>] [-m <MB/s>] "
+				"[-p <MB/s>] [-r <ns>] [-s <MB/s>]\n", argv[0]);
+		return 1;
+	}
+
+	srand(1);
+	BitWords = BitKb * 256;
+	for (Word = 0; Word < BitWords; Word++)
+		Bitstream[Word] = ((u32)rand() << 16) ^ (u32)rand();
+	for (Word = 0; Word < sizeof(SdLoader); Word++)
+		SdLoader[Word] = rand();
+	for (Word = 0; Word < AppBytes; Word++)
+		SdApp[Word] = rand();
+	md5(SdLoader, sizeof(SdLoader), LoaderDigest, FALSE);
+	md5(SdApp, AppBytes, AppDigest, FALSE);
+	Regs[XDCFG_INT_MASK_OFFSET / 4] = 0xFFFFFFFF;
+
+	printf("bitstream %u KB, PS partitions %u+%u KB, PCAP %.0f MB/s, "
+			"SD %.0f MB/s, MD5 %.0f MB/s\n", BitKb, LOADER_KB,
+			AppBytes / 1024, 4000.0 / PcapNs, 1000.0 / SdNs, 1000.0 / Md5Ns);
+
+	if (InitPcap() != XST_SUCCESS) {
+		printf("InitPcap failed\n");
+		return 1;
+	}
+
+	for (Run = 0; Run < RUNS; Run++) {
+		memset(&Token, 0, sizeof(Token));
+		memset(DdrLoader, 0, sizeof(DdrLoader));
+		memset(DdrApp, 0, sizeof(DdrApp));
+		HandlerCalls = 0;
+		Irqs = 0;
+		IrqRouted = (Run == RUN_INTERRUPT);
+		if (IrqRouted)
+			XDcfg_IntrEnable(DcfgInstPtr, PCAP_ASYNC_EVENT_MASK);
+		else
+			XDcfg_IntrDisable(DcfgInstPtr, XDCFG_IXR_ALL_MASK);
+
+		/*
+		 * The bitstream is read to the DDR temporary address first
+		 */
+		Start = Now;
+		memcpy(DdrTemp, Bitstream, BitWords * 4);
+		Now += BitWords * 4 * SdNs;
+
+		if (Run == RUN_SEQUENTIAL) {
+			Check(PcapLoadPartition((u32 *)DdrTemp, (u32 *)ADDR_INVALID,
+					BitWords, BitWords, 0) == XST_SUCCESS,
+					"sequential download");
+		} else {
+			Check(PcapLoadPartitionStart(&Token, (u32 *)DdrTemp, BitWords,
+					BitWords, 0, Handler, NULL) == XST_SUCCESS,
+					"download started");
+			Returned = Now;
+			Check(Busy && (Returned < CmdEnd), "start returns while the "
+					"DMA runs");
+			Check(PcapAsyncPoll(&Token) == XST_DEVICE_BUSY, "poll busy");
+		}
+
+		if (Run == RUN_FSBL) {
+			Check(ClearPcapStatus() == XST_DEVICE_BUSY,
+					"status clear refused");
+			Check(PcapDataTransfer((u32 *)DdrLoader, (u32 *)DdrApp, 16, 16,
+					0) == XST_FAILURE, "data transfer refused");
+			Check(PcapLoadPartitionStart(&Token, (u32 *)DdrTemp, BitWords,
+					BitWords, 0, Handler, NULL) == XST_FAILURE,
+					"second load refused");
+			Token.State = PCAP_ASYNC_BUSY;
+			Check(Busy && (PcapAsyncPoll(&Token) == XST_DEVICE_BUSY),
+					"load still running");
+		}
+
+		Overlap = LoadPartition(SdLoader, DdrLoader, sizeof(SdLoader),
+				Digest, Run, &Token);
+		Check(memcmp(Digest, LoaderDigest, 16) == 0, "boot loader hash");
+		Overlap += LoadPartition(SdApp, DdrApp, AppBytes, Digest, Run,
+				&Token);
+		Check(memcmp(Digest, AppDigest, 16) == 0, "application hash");
+
+		/*
+		 * PCFG_DONE before the end of the PS work is taken by the
+		 * interrupt, otherwise by the wait
+		 */
+		if ((Run == RUN_INTERRUPT) && (Now >= FabricEnd))
+			Check(Token.State == PCAP_ASYNC_DONE,
+					"done through the interrupt");
+
+		if (Run != RUN_SEQUENTIAL) {
+			Check(PcapAsyncWait(&Token) == XST_SUCCESS, "wait");
+			Check((HandlerCalls == 1) && (HandlerStatus == XST_SUCCESS),
+					"handler called once");
+			Check(PcapAsyncWait(&Token) == XST_SUCCESS, "second wait");
+			Check(HandlerCalls == 1, "handler not called again");
+		}
+		Elapsed[Run] = Now - Start;
+
+		Check((ConfigWords == (int)BitWords) &&
+				(ConfigHash == Hash(Bitstream, BitWords)),
+				"bitstream configured");
+		Check(!(IntSts & FSBL_XDCFG_IXR_ERROR_FLAGS_MASK), "no errors");
+
+		ConfigNs = FabricEnd - ConfigStart;
+		printf("%-10s %7.2f ms", Names[Run], Elapsed[Run] / 1e6);
+		if (Run != RUN_SEQUENTIAL) {
+			printf(", saved %6.2f ms (%4.1f%%), %3.0f%% of the fabric "
+					"time overlapped", (Elapsed[RUN_SEQUENTIAL] -
+					Elapsed[Run]) / 1e6, 100.0 * (Elapsed[RUN_SEQUENTIAL] -
+					Elapsed[Run]) / Elapsed[RUN_SEQUENTIAL],
+					100.0 * Overlap / ConfigNs);
+			Check(Elapsed[Run] < Elapsed[RUN_SEQUENTIAL], "faster");
+		}
+		if ((Run == RUN_POLLED) || (Run == RUN_INTERRUPT))
+			printf(", handler %.0f us after PCFG_DONE",
+					(HandlerTime - FabricEnd) / 1e3);
+		if (Run == RUN_INTERRUPT)
+			printf(", %u irqs", Irqs);
+		printf("\n");
+	}
+
+	/*
+	 * AXI read error half way through the bitstream
+	 */
+	XDcfg_IntrDisable(DcfgInstPtr, XDCFG_IXR_ALL_MASK);
+	IrqRouted = 0;
+	memset(&Token, 0, sizeof(Token));
+	HandlerCalls = 0;
+	Check(PcapLoadPartitionStart(&Token, (u32 *)DdrTemp, BitWords, BitWords,
+			0, Handler, NULL) == XST_SUCCESS, "error run started");
+	ErrorAt = Now + BitWords * PcapNs / 2;
+	LoadPartition(SdLoader, DdrLoader, sizeof(SdLoader), Digest, RUN_POLLED,
+			&Token);
+	Check(PcapAsyncWait(&Token) == XST_FAILURE, "error reported by wait");
+	Check((HandlerCalls == 1) && (HandlerStatus == XST_FAILURE),
+			"error reported to the handler");
+	Check(ClearPcapStatus() == XST_SUCCESS, "PCAP released");
+
+	printf("%u errors\n", Errors);
+	return Errors ? 1 : 0;
+}
@@ -0,0 +1,841 @@
+/******************************************************************************
+*
+* pcapreadsim.c
+*
+* Host side test of the PCAP configuration readback of the FSBL
+* (PCAP_READBACK_VERIFY). pcap.c, readback.c, crc32c.c and the devcfg driver
+* are built into the tool, the register accesses go to a timed model of the
+* devcfg DMA and of the configuration logic of a 7z020 sized device.
+*
+* Frame layout: three rows, two in the top half and one in the bottom half,
+* all with the same columns. IOB columns have 42 frames, CLB columns 36,
+* BRAM and DSP columns 28 and the clock column 30. Block type 1 holds the
+* 128 content frames of every BRAM column. A bitstream and a readback run
+* from their frame address through the columns and rows in this order, with
+* two pad frames at the end of every row. Frame writes go through a frame
+* buffer that keeps the last frame until the next one arrives. The bitstream
+* therefore ends with a pad frame and the readback starts with one.
+*
+* The DMA runs the commands of its queue in order at -p MB/s. Readback data
+* comes out of the configuration logic at -p MB/s as well, whether a DMA
+* command takes it or not: the 32 word FIFO overflows when no command is
+* queued. After the start command the design runs, the LUTRAM frames of
+* every sixth CLB column and the BRAM contents change with every readback.
+* The mask has these frames set.
+*
+* The test loads a full bitstream with PcapLoadPartition() and checks that
+*   - the readback matches and the region CRCs are the CRC-32C of the frames,
+*   - without the mask exactly the changing frames are reported, and the
+*     download passes without storing a table,
+*   - a scrub of the intact configuration passes,
+*   - an upset bit in an unmasked frame is found by the verify at its frame
+*     and by the scrub at its region, one in a masked frame is not,
+*   - a bitstream of one row is verified from its frame address,
+*   - compressed, encrypted and multi block bitstreams are not parsed.
+* Reported are the frames per second of the verify and the scrub, the PCAP
+* busy time, and the rate of reading back first and comparing after. Each
+* register access costs -r ns. The kernel costs -w ns per word read back
+* and -e ns per expected word.
+*
+* Build: gcc -O2 -no-pie -DPCAP_READBACK_VERIFY -Wno-pointer-to-int-cast
+*		 -Wno-int-to-pointer-cast [-DREADBACK_CHUNK_FRAMES=<n>]
+*		 -o pcapreadsim pcapreadsim.c -I../../FSBL/src
+*		 -I../../FSBL_bsp/ps7_cortexa9_0/include
+*		 -I../../FSBL_bsp/ps7_cortexa9_0/libsrc/devcfg_v2_04_a/src
+*
+* The DMA addresses are 32-bit, -no-pie keeps the static buffers of the tool
+* below 4GB.
+*
+* Usage: pcapreadsim [-e <ns/word>] [-n <upsets>] [-p <MB/s>] [-r <ns>]
+*		 [-w <ns/word>]
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+* 1.01a te   10/16/26 Download without a mask
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * 32-bit register and pointer arithmetic types of the target, xil_types.h
+ * leaves them out when XBASIC_TYPES_H is defined
+ */
+#define XBASIC_TYPES_H
+typedef unsigned char u8;
+typedef unsigned short u16;
+typedef unsigned int u32;
+
+/*
+ * Device frame layout
+ */
+#define ROWS			3
+#define TOP_ROWS		2
+#define ROW_PAD_FRAMES		2
+#define BRAM_FRAMES		128
+#define FRAME_WORDS		101
+#define COLUMNS			"ICCCCCCCCCCCCCCBCCCCCCCCCCCCCCDCCCCCCCK" \
+				"CCCCCCCBCCCCCCCCCCCCCCDBCCCCCCCCI"
+#define LUTRAM_EVERY		6	/* CLB columns */
+#define LUTRAM_FRAMES		4	/* changing frames of such a column */
+
+#define MAX_SLOTS		12000
+#define MAX_WORDS		((MAX_SLOTS + 1) * FRAME_WORDS)
+
+/*
+ * Memory the readback code uses
+ */
+static u32 ReadbackBuffer[MAX_WORDS] __attribute__((aligned(32)));
+static u32 TableSpace[1024] __attribute__((aligned(32)));
+
+#define READBACK_BUFFER_ADDR	((u32)ReadbackBuffer)
+#define READBACK_TABLE_ADDR	((u32)TableSpace)
+
+#include "xdevcfg.c"
+#include "xdevcfg_intr.c"
+#include "xdevcfg_sinit.c"
+#include "xdevcfg_g.c"
+#include "pcap.c"
+#include "crc32c.c"
+
+/*
+ * Kernel calls of readback.c are timed
+ */
+static double Now;		/* ns */
+static double KernelNs;		/* ns in the kernel */
+static double WordNs = 40;	/* per word read back */
+static double ExpectNs = 25;	/* per expected word */
+
+static u32 TimedCrc32cWords(u32 Crc, const u32 *Data, u32 Words)
+{
+	Now += Words * WordNs;
+	KernelNs += Words * WordNs;
+	return Crc32cWords(Crc, Data, Words);
+}
+
+static u32 TimedCrc32cCompare(u32 Crc, const u32 *Data, const u32 *Expected,
+		u32 Words, u32 *Diff)
+{
+	Now += Words * (WordNs + ExpectNs);
+	KernelNs += Words * (WordNs + ExpectNs);
+	return Crc32cCompare(Crc, Data, Expected, Words, Diff);
+}
+
+#define Crc32cWords TimedCrc32cWords
+#define Crc32cCompare TimedCrc32cCompare
+#include "readback.c"
+#undef Crc32cWords
+#undef Crc32cCompare
+
+#define MODEL_BASEADDR		XPAR_XDCFG_0_BASEADDR
+#define DMA_QUEUE		4
+#define RX_FIFO_WORDS		32
+#define ADDR_INVALID		0xFFFFFFFF
+#define NEVER			1e300
+
+#define FAR(Block, Top, Row, Col, Minor) \
+		(((Block) << 23) | ((Top) << 22) | ((Row) << 17) | ((Col) << 7) | \
+		 (Minor))
+
+/*
+ * Layout, a slot is a frame of the bitstream and readback order
+ */
+static u32 SlotFar[MAX_SLOTS];
+static int SlotFrame[MAX_SLOTS];	/* -1 for a pad frame */
+static u32 Slots;
+static u32 Frames;
+static u8 Dynamic[MAX_SLOTS];		/* frame changes while running */
+
+static u32 ConfigMem[MAX_SLOTS][FRAME_WORDS];
+
+/*
+ * Timing
+ */
+static double RegNs = 100;
+static double PcapNs = 10;		/* per word, 400 MB/s */
+static double PcapBusyNs;
+
+/*
+ * devcfg state
+ */
+typedef struct {
+	u32 Src;
+	u32 SrcLen;
+	u32 Dst;
+	u32 DstLen;
+	double Queued;
+	double End;
+	u32 RxFirst;
+	int Started;
+} DmaCommand;
+
+static u32 Regs[0x100 / 4];
+static u32 IntSts;
+static u32 DoneCount;
+static int Init = 1;
+static DmaCommand Queue[DMA_QUEUE];
+static int QueueHead;
+static int QueueCount;
+static double DmaFree;
+static unsigned long Overflows;
+
+/*
+ * Configuration logic state
+ */
+static int Synced;
+static int Running;
+static u32 PacketReg;
+static u32 PacketLeft;
+static u32 FarReg;
+static int WriteSlot;
+static u32 FrameBuf[FRAME_WORDS];
+static u32 FrameFill;
+static u32 Pending[FRAME_WORDS];
+static int HavePending;
+static u32 Generation;
+
+static u32 RxData[MAX_WORDS];
+static u32 RxLen;
+static u32 RxPos;
+static double RxStart;
+static int RxRequest;		/* words of a read packet, 0 for none */
+
+/*
+ * Test data
+ */
+static u32 Bitstream[MAX_WORDS + 256];
+static u32 BitWords;
+static u32 Mask[(MAX_SLOTS + 31) / 32];
+static u32 Errors;
+
+static void BuildLayout(void)
+{
+	static const char Cols[] = COLUMNS;
+	u32 Block;
+	u32 Row;
+	u32 Col;
+	u32 Minor;
+	u32 Count;
+	u32 Clb;
+	u32 Bram;
+	int Pad;
+
+	for (Block = 0; Block < 2; Block++) {
+		for (Row = 0; Row < ROWS; Row++) {
+			Clb = 0;
+			Bram = 0;
+			for (Col = 0; Col < sizeof(Cols) - 1; Col++) {
+				switch (Cols[Col]) {
+				case 'I': Count = 42; break;
+				case 'C': Count = 36; break;
+				case 'K': Count = 30; break;
+				default: Count = 28; break;
+				}
+				if (Block == 1) {
+					if (Cols[Col] != 'B')
+						continue;
+					Count = BRAM_FRAMES;
+				}
+				for (Minor = 0; Minor < Count; Minor++) {
+					SlotFar[Slots] = FAR(Block, Row >= TOP_ROWS,
+							Row % TOP_ROWS, Block ? Bram : Col, Minor);
+					SlotFrame[Slots] = Frames++;
+					Dynamic[Slots] = (Block == 1) || ((Cols[Col] == 'C') &&
+							(Clb % LUTRAM_EVERY == LUTRAM_EVERY - 1) &&
+							(Minor < LUTRAM_FRAMES));
+					Slots++;
+				}
+				Clb += (Cols[Col] == 'C');
+				Bram += (Cols[Col] == 'B');
+			}
+			for (Pad = 0; Pad < ROW_PAD_FRAMES; Pad++) {
+				SlotFar[Slots] = ADDR_INVALID;
+				SlotFrame[Slots++] = -1;
+			}
+		}
+	}
+}
+
+static int SlotOf(u32 Far)
+{
+	u32 Slot;
+
+	for (Slot = 0; Slot < Slots; Slot++)
+		if ((SlotFrame[Slot] >= 0) && (SlotFar[Slot] == Far))
+			return Slot;
+	return -1;
+}
+
+/*
+ * Frame of a slot as the readback returns it
+ */
+static void ReadSlot(u32 Slot, u32 *Data)
+{
+	u32 Word;
+
+	if ((Slot >= Slots) || (SlotFrame[Slot] < 0)) {
+		memset(Data, 0, FRAME_WORDS * 4);
+		return;
+	}
+	memcpy(Data, ConfigMem[SlotFrame[Slot]], FRAME_WORDS * 4);
+	if (Running && Dynamic[Slot])
+		for (Word = 0; Word < FRAME_WORDS; Word++)
+			Data[Word] ^= (Generation * 0x9E3779B9u) ^ Word;
+}
+
+/*
+ * Configuration logic, one word from the PCAP
+ */
+static void ReadPacket(u32 Count)
+{
+	u32 Slot;
+	int First = SlotOf(FarReg);
+
+	/*
+	 * Frame buffer first, then the frames from the frame address
+	 */
+	RxRequest = Count;
+	RxLen = Count;
+	RxPos = 0;
+	memset(RxData, 0, FRAME_WORDS * 4);
+	Generation++;
+	for (Slot = 0; FRAME_WORDS * (Slot + 2) <= Count; Slot++)
+		ReadSlot((First < 0) ? Slots : First + Slot,
+				&RxData[FRAME_WORDS * (Slot + 1)]);
+}
+
+static void CfgWord(u32 Word)
+{
+	if (!Synced) {
+		Synced = (Word == CFG_SYNC);
+		return;
+	}
+
+	if (PacketLeft == 0) {
+		if (CFG_TYPE(Word) == CFG_TYPE1) {
+			PacketReg = CFG_REG(Word);
+			PacketLeft = CFG_TYPE1_COUNT(Word);
+		} else if (CFG_TYPE(Word) == CFG_TYPE2) {
+			PacketLeft = CFG_TYPE2_COUNT(Word);
+		}
+		if (CFG_OPCODE(Word) == CFG_OP_READ) {
+			if ((PacketReg == CFG_REG_FDRO) && (PacketLeft != 0))
+				ReadPacket(PacketLeft);
+			PacketLeft = 0;
+		}
+		return;
+	}
+
+	PacketLeft--;
+	switch (PacketReg) {
+	case CFG_REG_FAR:
+		FarReg = Word;
+		WriteSlot = SlotOf(Word);
+		FrameFill = 0;
+		HavePending = 0;
+		break;
+	case CFG_REG_FDRI:
+		FrameBuf[FrameFill++] = Word;
+		if (FrameFill < FRAME_WORDS)
+			break;
+		FrameFill = 0;
+		if (HavePending && (WriteSlot >= 0) && (WriteSlot < (int)Slots)) {
+			if (SlotFrame[WriteSlot] >= 0)
+				memcpy(ConfigMem[SlotFrame[WriteSlot]], Pending,
+						FRAME_WORDS * 4);
+			WriteSlot++;
+		}
+		memcpy(Pending, FrameBuf, FRAME_WORDS * 4);
+		HavePending = 1;
+		break;
+	case CFG_REG_CMD:
+		if (Word == CFG_CMD_START) {
+			Running = 1;
+			IntSts |= XDCFG_IXR_PCFG_DONE_MASK;
+		} else if (Word == CFG_CMD_DESYNC) {
+			Synced = 0;
+		}
+		break;
+	}
+}
+
+/*
+ * DMA, the command at the head of the queue
+ */
+static double RxAvail(u32 Word)
+{
+	return RxStart + (Word + 1) * PcapNs;
+}
+
+static void StartCommand(DmaCommand *Cmd, double Start)
+{
+	u32 *Src = (u32 *)(unsigned long)(Cmd->Src & ~3);
+	u32 Word;
+	double End = Start;
+
+	Cmd->Started = 1;
+	if ((Cmd->Src != ADDR_INVALID) && Cmd->SrcLen) {
+		RxRequest = 0;
+		for (Word = 0; Word < Cmd->SrcLen; Word++)
+			CfgWord(Src[Word]);
+		End += Cmd->SrcLen * PcapNs;
+		PcapBusyNs += Cmd->SrcLen * PcapNs;
+		if (RxRequest)
+			RxStart = End;
+	}
+
+	if ((Cmd->Dst != ADDR_INVALID) && Cmd->DstLen) {
+		if (RxPos + Cmd->DstLen > RxLen) {
+			Cmd->End = NEVER;
+			return;
+		}
+		if ((RxPos + RX_FIFO_WORDS < RxLen) &&
+				(Start > RxAvail(RxPos + RX_FIFO_WORDS))) {
+			IntSts |= XDCFG_IXR_RX_FIFO_OV_MASK;
+			Overflows++;
+		}
+		Cmd->RxFirst = RxPos;
+		RxPos += Cmd->DstLen;
+		End = Start + Cmd->DstLen * PcapNs;
+		if (End < RxAvail(RxPos - 1))
+			End = RxAvail(RxPos - 1);
+		PcapBusyNs += Cmd->DstLen * PcapNs;
+	}
+
+	Cmd->End = End;
+}
+
+static void FinishCommand(DmaCommand *Cmd)
+{
+	if ((Cmd->Dst != ADDR_INVALID) && Cmd->DstLen)
+		memcpy((u32 *)(unsigned long)(Cmd->Dst & ~3),
+				&RxData[Cmd->RxFirst], Cmd->DstLen * 4);
+
+	DoneCount++;
+	IntSts |= XDCFG_IXR_DMA_DONE_MASK;
+	if (((Cmd->Src & 3) == 1) || ((Cmd->Dst & 3) == 1))
+		IntSts |= XDCFG_IXR_D_P_DONE_MASK;
+}
+
+static void Advance(void)
+{
+	DmaCommand *Cmd;
+
+	while (QueueCount) {
+		Cmd = &Queue[QueueHead];
+		if (!Cmd->Started)
+			StartCommand(Cmd, (DmaFree > Cmd->Queued) ? DmaFree : Cmd->Queued);
+		if (Cmd->End > Now)
+			break;
+		FinishCommand(Cmd);
+		DmaFree = Cmd->End;
+		QueueHead = (QueueHead + 1) % DMA_QUEUE;
+		QueueCount--;
+	}
+}
+
+static void QueueCommand(void)
+{
+	DmaCommand *Cmd;
+
+	if (QueueCount == DMA_QUEUE) {
+		IntSts |= XDCFG_IXR_DMA_Q_OV_MASK;
+		return;
+	}
+	Cmd = &Queue[(QueueHead + QueueCount++) % DMA_QUEUE];
+	memset(Cmd, 0, sizeof(*Cmd));
+	Cmd->Src = Regs[XDCFG_DMA_SRC_ADDR_OFFSET / 4];
+	Cmd->Dst = Regs[XDCFG_DMA_DEST_ADDR_OFFSET / 4];
+	Cmd->SrcLen = Regs[XDCFG_DMA_SRC_LEN_OFFSET / 4];
+	Cmd->DstLen = Regs[XDCFG_DMA_DEST_LEN_OFFSET / 4];
+	Cmd->Queued = Now;
+}
+
+u32 Xil_In32(u32 Addr)
+{
+	u32 Value;
+
+	Now += RegNs;
+	Advance();
+	if ((Addr < MODEL_BASEADDR) || (Addr >= MODEL_BASEADDR + sizeof(Regs)))
+		return 0;
+
+	switch (Addr - MODEL_BASEADDR) {
+	case XDCFG_INT_STS_OFFSET:
+		return IntSts;
+	case XDCFG_STATUS_OFFSET:
+		Value = ((DoneCount > 3) ? 3 : DoneCount) << 28;
+		if (QueueCount == DMA_QUEUE)
+			Value |= XDCFG_STATUS_DMA_CMD_Q_F_MASK;
+		if (QueueCount == 0)
+			Value |= XDCFG_STATUS_DMA_CMD_Q_E_MASK;
+		if (Init)
+			Value |= XDCFG_STATUS_PCFG_INIT_MASK;
+		return Value;
+	default:
+		return Regs[(Addr - MODEL_BASEADDR) / 4];
+	}
+}
+
+void Xil_Out32(u32 Addr, u32 Value)
+{
+	Now += RegNs;
+	Advance();
+	if ((Addr < MODEL_BASEADDR) || (Addr >= MODEL_BASEADDR + sizeof(Regs)))
+		return;
+
+	switch (Addr - MODEL_BASEADDR) {
+	case XDCFG_INT_STS_OFFSET:
+		/*
+		 * Clearing DMA_DONE acknowledges one finished command
+		 */
+		if ((Value & XDCFG_IXR_DMA_DONE_MASK) && DoneCount)
+			DoneCount--;
+		IntSts &= ~Value;
+		if (DoneCount)
+			IntSts |= XDCFG_IXR_DMA_DONE_MASK;
+		break;
+	case XDCFG_CTRL_OFFSET:
+		if (!(Value & XDCFG_CTRL_PCFG_PROG_B_MASK)) {
+			Init = 0;
+			Running = 0;
+			Synced = 0;
+			memset(ConfigMem, 0, sizeof(ConfigMem));
+		} else {
+			Init = 1;
+		}
+		Regs[XDCFG_CTRL_OFFSET / 4] = Value;
+		break;
+	case XDCFG_DMA_DEST_LEN_OFFSET:
+		Regs[XDCFG_DMA_DEST_LEN_OFFSET / 4] = Value;
+		QueueCommand();
+		Advance();
+		break;
+	default:
+		Regs[(Addr - MODEL_BASEADDR) / 4] = Value;
+		break;
+	}
+}
+
+int usleep(unsigned int useconds)
+{
+	Now += useconds * 1000.0;
+	Advance();
+	return 0;
+}
+
+void XTime_GetTime(XTime *Xtime)
+{
+	*Xtime = (XTime)(Now * (COUNTS_PER_SECOND / 1e9));
+}
+
+void Xil_DCacheInvalidateRange(unsigned int adr, unsigned len)
+{
+}
+
+void Xil_DCacheFlushRange(unsigned int adr, unsigned len)
+{
+}
+
+unsigned int Xil_AssertStatus;
+
+void Xil_Assert(const char *File, int Line)
+{
+	fprintf(stderr, "assert %s:%d\n", File, Line);
+	exit(1);
+}
+
+/*
+ * Bitstreams
+ */
+static void Put(u32 Word)
+{
+	Bitstream[BitWords++] = Word;
+}
+
+static void PutReg(u32 Reg, u32 Value)
+{
+	Put(CFG_TYPE1_PACKET(CFG_OP_WRITE, Reg, 1));
+	Put(Value);
+}
+
+static u32 Random32(void)
+{
+	return ((u32)rand() << 16) ^ (u32)rand();
+}
+
+/*
+ * Bitstream of Count slots from First, random frame data. Extra is
+ * written to register ExtraReg before the frames, ExtraReg 0 for none.
+ */
+static void MakeBitstream(u32 First, u32 Count, u32 ExtraReg, int TwoBlocks)
+{
+	u32 Slot;
+	u32 Word;
+	u32 Index;
+
+	BitWords = 0;
+	for (Index = 0; Index < 8; Index++)
+		Put(CFG_DUMMY);
+	Put(CFG_BUS_WIDTH_SYNC);
+	Put(CFG_BUS_WIDTH_DETECT);
+	Put(CFG_DUMMY);
+	Put(CFG_DUMMY);
+	Put(CFG_SYNC);
+	Put(CFG_NOOP);
+	PutReg(CFG_REG_CMD, CFG_CMD_RCRC);
+	Put(CFG_NOOP);
+	Put(CFG_NOOP);
+	PutReg(12, 0x03727093);			/* IDCODE of the 7z020 */
+	if (ExtraReg)
+		PutReg(ExtraReg, 0);
+	PutReg(CFG_REG_CMD, CFG_CMD_WCFG);
+	Put(CFG_NOOP);
+	PutReg(CFG_REG_FAR, SlotFar[First]);
+	Put(CFG_TYPE1_PACKET(CFG_OP_WRITE, CFG_REG_FDRI, 0));
+	Put(CFG_TYPE2_PACKET(CFG_OP_WRITE, (Count + 1) * FRAME_WORDS));
+	for (Slot = First; Slot < First + Count; Slot++)
+		for (Word = 0; Word < FRAME_WORDS; Word++)
+			Put((SlotFrame[Slot] >= 0) ? Random32() : 0);
+	for (Word = 0; Word < FRAME_WORDS; Word++)
+		Put(0);
+	if (TwoBlocks) {
+		PutReg(CFG_REG_FAR, SlotFar[First]);
+		Put(CFG_TYPE1_PACKET(CFG_OP_WRITE, CFG_REG_FDRI, 2 * FRAME_WORDS));
+		for (Word = 0; Word < 2 * FRAME_WORDS; Word++)
+			Put(0);
+	}
+	PutReg(CFG_REG_CMD, CFG_CMD_START);
+	Put(CFG_NOOP);
+	PutReg(CFG_REG_CMD, CFG_CMD_DESYNC);
+	for (Index = 0; Index < 4; Index++)
+		Put(CFG_NOOP);
+
+	memset(Mask, 0, sizeof(Mask));
+	for (Slot = First; Slot < First + Count; Slot++)
+		if (Dynamic[Slot])
+			Mask[(Slot - First) >> 5] |= 1U << ((Slot - First) & 31);
+}
+
+static void Check(int Condition, const char *What)
+{
+	if (!Condition) {
+		printf("  FAIL: %s\n", What);
+		Errors++;
+	}
+}
+
+/*
+ * Byte wise CRC-32C of the unmasked frames of a region
+ */
+static u32 ReferenceCrc(const u32 *Data, u32 First, u32 Count)
+{
+	u32 Crc = 0xFFFFFFFF;
+	u32 Frame;
+	u32 Byte;
+	int Bit;
+
+	for (Frame = First; Frame < First + Count; Frame++) {
+		if (Mask[Frame >> 5] & (1U << (Frame & 31)))
+			continue;
+		for (Byte = 0; Byte < FRAME_WORDS * 4; Byte++) {
+			Crc ^= (Data[Frame * FRAME_WORDS + Byte / 4] >> (8 * (Byte & 3))) &
+					0xFF;
+			for (Bit = 0; Bit < 8; Bit++)
+				Crc = (Crc & 1) ? (Crc >> 1) ^ 0x82F63B78 : (Crc >> 1);
+		}
+	}
+	return ~Crc;
+}
+
+static double Rate(u32 Count, double Ns)
+{
+	return Count / (Ns / 1e9);
+}
+
+int main(int argc, char **argv)
+{
+	ReadbackImage Image;
+	ReadbackResult Result;
+	ReadbackTable *Table = (ReadbackTable *)TableSpace;
+	double Start;
+	double Elapsed;
+	double Busy;
+	double Kernel;
+	u32 Region;
+	u32 Bad;
+	u32 Slot;
+	u32 Bit;
+	u32 RowSlots;
+	u32 Masked;
+	u32 Upsets = 20;
+	u32 Found = 0;
+	u32 Ignored = 0;
+	u32 Index;
+	int Arg;
+
+	for (Arg = 1; (Arg + 1 < argc) && (argv[Arg][0] == '-'); Arg += 2) {
+		if (strcmp(argv[Arg], "-e") == 0)
+			ExpectNs = atof(argv[Arg + 1]);
+		else if (strcmp(argv[Arg], "-n") == 0)
+			Upsets = atoi(argv[Arg + 1]);
+		else if (strcmp(argv[Arg], "-p") == 0)
+			PcapNs = 4000.0 / atof(argv[Arg + 1]);
+		else if (strcmp(argv[Arg], "-r") == 0)
+			RegNs = atof(argv[Arg + 1]);
+		else if (strcmp(argv[Arg], "-w") == 0)
+			WordNs = atof(argv[Arg + 1]);
+		else
+			break;
+	}
+	if ((Arg < argc) || (PcapNs <= 0)) {
+		fprintf(stderr, "usage: %s [-e <ns/word>] [-n <upsets>] [-p <MB/s>] "
+				"[-r <ns>] [-w <ns/word>]\n", argv[0]);
+		return 1;
+	}
+
+	srand(1);
+	BuildLayout();
+	for (Slot = 0, Masked = 0; Slot < Slots; Slot++)
+		Masked += Dynamic[Slot];
+	printf("%u frames, %u with pads, %u changing, chunk %u frames, "
+			"PCAP %.0f MB/s, kernel %.0f+%.0f ns/word\n", Frames, Slots,
+			Masked, READBACK_CHUNK_FRAMES, 4000.0 / PcapNs, WordNs, ExpectNs);
+
+	if (InitPcap() != XST_SUCCESS) {
+		printf("InitPcap failed\n");
+		return 1;
+	}
+
+	/*
+	 * Full bitstream, verified by the download
+	 */
+	MakeBitstream(0, Slots, 0, 0);
+	ReadbackMask = Mask;
+	Check(PcapLoadPartition(Bitstream, (u32 *)ADDR_INVALID, BitWords,
+			BitWords, 0) == XST_SUCCESS, "download with verify");
+	Check((Table->Magic == READBACK_TABLE_MAGIC) && (Table->Frames == Slots),
+			"table stored");
+	ReadbackParse(Bitstream, BitWords, &Image);
+	for (Region = 0, Bad = 0; Region < Table->Regions; Region++) {
+		Index = Region * Table->RegionFrames;
+		if (Table->Crc[Region] != ReferenceCrc(Image.Data, Index,
+				(Index + Table->RegionFrames > Slots) ? Slots - Index :
+				Table->RegionFrames))
+			Bad++;
+	}
+	Check(Bad == 0, "region CRCs");
+
+	/*
+	 * Verify alone, timed
+	 */
+	Start = Now;
+	PcapBusyNs = 0;
+	KernelNs = 0;
+	Check(ReadbackVerify(&Image, Mask, NULL, &Result) == XST_SUCCESS,
+			"verify with mask");
+	Elapsed = Now - Start;
+	Busy = PcapBusyNs;
+	Kernel = KernelNs;
+	Check(Result.Skipped == Masked, "masked frames skipped");
+	printf("verify: %u frames/s (reported %u), PCAP busy %.0f%%, "
+			"%.2f ms\n", (u32)Rate(Slots, Elapsed), Result.FramesPerSec,
+			100.0 * Busy / Elapsed, Elapsed / 1e6);
+	printf("        read back first, compare after: %u frames/s\n",
+			(u32)Rate(Slots, Busy + Kernel));
+
+	/*
+	 * Without the mask the changing frames differ
+	 */
+	Check(ReadbackVerify(&Image, NULL, NULL, &Result) == XST_FAILURE,
+			"verify without mask fails");
+	for (Slot = 0; (Slot < Slots) && !Dynamic[Slot]; Slot++)
+		;
+	Check((Result.BadFrames == Masked) && (Result.FirstBad == Slot),
+			"changing frames reported");
+
+	/*
+	 * Scrub of the intact configuration
+	 */
+	Start = Now;
+	PcapBusyNs = 0;
+	Check(ReadbackScrub(Table, Mask, &Result) == XST_SUCCESS, "scrub");
+	Elapsed = Now - Start;
+	printf("scrub:  %u frames/s (reported %u), PCAP busy %.0f%%, "
+			"%.2f ms, %u regions of %u frames\n", (u32)Rate(Slots, Elapsed),
+			Result.FramesPerSec, 100.0 * PcapBusyNs / Elapsed, Elapsed / 1e6,
+			Table->Regions, Table->RegionFrames);
+
+	/*
+	 * Upsets
+	 */
+	for (Index = 0; Index < Upsets; Index++) {
+		do {
+			Slot = Random32() % Slots;
+		} while (SlotFrame[Slot] < 0);
+		Bit = Random32() % (FRAME_WORDS * 32);
+		ConfigMem[SlotFrame[Slot]][Bit / 32] ^= 1U << (Bit % 32);
+
+		if (Dynamic[Slot]) {
+			Check(ReadbackScrub(Table, Mask, &Result) == XST_SUCCESS,
+					"masked upset ignored by the scrub");
+			Check(ReadbackVerify(&Image, Mask, NULL, &Result) == XST_SUCCESS,
+					"masked upset ignored by the verify");
+			Ignored++;
+		} else {
+			Check((ReadbackScrub(Table, Mask, &Result) == XST_FAILURE) &&
+					(Result.BadRegions == 1) &&
+					(Result.FirstBad == Slot / Table->RegionFrames),
+					"upset found by the scrub");
+			Check((ReadbackVerify(&Image, Mask, NULL, &Result) ==
+					XST_FAILURE) && (Result.BadFrames == 1) &&
+					(Result.FirstBad == Slot), "upset found by the verify");
+			Found++;
+		}
+		ConfigMem[SlotFrame[Slot]][Bit / 32] ^= 1U << (Bit % 32);
+	}
+	printf("upsets: %u in unmasked frames, %u in masked frames\n", Found,
+			Ignored);
+
+	/*
+	 * Download without the mask, the changing frames do not fail it
+	 */
+	ReadbackMask = NULL;
+	Check(PcapLoadPartition(Bitstream, (u32 *)ADDR_INVALID, BitWords,
+			BitWords, 0) == XST_SUCCESS, "download without mask");
+	Check(Table->Magic != READBACK_TABLE_MAGIC, "no table without mask");
+	ReadbackMask = Mask;
+
+	/*
+	 * One row from its frame address
+	 */
+	for (RowSlots = 0; SlotFrame[RowSlots] >= 0; RowSlots++)
+		;
+	RowSlots += ROW_PAD_FRAMES;
+	MakeBitstream(RowSlots, RowSlots, 0, 0);
+	Check(PcapLoadPartition(Bitstream, (u32 *)ADDR_INVALID, BitWords,
+			BitWords, 0) == XST_SUCCESS, "row download with verify");
+	Check((Table->Far == SlotFar[RowSlots]) && (Table->Frames == RowSlots),
+			"row table");
+
+	/*
+	 * Bitstreams that are not parsed
+	 */
+	MakeBitstream(0, 64, CFG_REG_MFWR, 0);
+	Check(ReadbackParse(Bitstream, BitWords, &Image) == XST_FAILURE,
+			"compressed bitstream not parsed");
+	MakeBitstream(0, 64, CFG_REG_CBC, 0);
+	Check(ReadbackParse(Bitstream, BitWords, &Image) == XST_FAILURE,
+			"encrypted bitstream not parsed");
+	MakeBitstream(0, 64, 0, 1);
+	Check(ReadbackParse(Bitstream, BitWords, &Image) == XST_FAILURE,
+			"two frame blocks not parsed");
+
+	printf("%lu FIFO overflows, %u errors\n", Overflows, Errors);
+	return (Errors || Overflows) ? 1 : 0;
+}
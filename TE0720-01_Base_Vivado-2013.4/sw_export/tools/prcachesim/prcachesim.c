@@ -0,0 +1,561 @@
+/******************************************************************************
+*
+* prcachesim.c
+*
+* Host side test of the partial reconfiguration manager of the devcfg
+* driver (xdevcfg_pr.c). The manager and the devcfg driver are built into
+* the tool, the register accesses go to a timed model of the PCAP DMA, the
+* fetch handler to a model of the storage the bitstream files come from.
+*
+* Three regions have five modules each, partial bitstreams of 300KB to
+* 1.3MB. The files are .bit files, plain .bin files and .bin files from
+* bootgen with swapped bytes in turn. Modules with an even number come from
+* SD at 25 MB/s, the others from QSPI at -q MB/s. The PCAP loads at
+* -p MB/s.
+*
+* The workload swaps the regions in turn, the module of a region is drawn
+* with a Zipf distribution whose ranking changes every 500 swaps. Between
+* swaps the application computes for -t ms, while the PCAP loads it polls
+* the manager. The same workload runs with the LRU and the greedy dual size
+* policy on a cache of -c MB.
+*
+* The test checks that
+*   - every DMA transfer is the decoded bitstream of its module,
+*   - a module in its region is not loaded again,
+*   - a module fetched while the PCAP loads another one is cached,
+*   - every load returns to the caller before the PCAP is done,
+*   - a swap while another one runs is refused,
+*   - a failed fetch leaves the region as it was,
+*   - a failed transfer leaves the region without a module,
+*   - a module larger than the cache is not registered.
+* Reported are the cache hits, the evictions, the mean and worst swap
+* latency and the share of the swap time the CPU is free.
+*
+* Build: gcc -O2 -no-pie -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast
+*		 -o prcachesim prcachesim.c -I../../FSBL_bsp/ps7_cortexa9_0/include
+*		 -I../../FSBL_bsp/ps7_cortexa9_0/libsrc/devcfg_v2_04_a/src -lm
+*
+* The cache addresses are 32-bit, -no-pie keeps the static cache of the
+* tool below 4GB.
+*
+* Usage: prcachesim [-c <MB>] [-n <swaps>] [-p <MB/s>] [-q <MB/s>]
+*		 [-t <ms>]
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/*
+ * 32-bit register and pointer arithmetic types of the target, xil_types.h
+ * leaves them out when XBASIC_TYPES_H is defined
+ */
+#define XBASIC_TYPES_H
+typedef unsigned char u8;
+typedef unsigned short u16;
+typedef unsigned int u32;
+
+#include "xdevcfg.c"
+#include "xdevcfg_intr.c"
+#include "xdevcfg_sinit.c"
+#include "xdevcfg_g.c"
+#include "xdevcfg_pr.c"
+
+#define MODEL_BASEADDR		XPAR_XDCFG_0_BASEADDR
+#define REGIONS			3
+#define REGION_MODULES		5
+#define MODULES			(REGIONS * REGION_MODULES)
+#define MAX_CACHE		(64 << 20)
+#define PHASE_SWAPS		500
+#define ZIPF_S			0.8
+#define SYNC_INDEX		5
+#define POLL_NS			5000.0
+
+#define FORMAT_BIT		0
+#define FORMAT_BIN		1
+#define FORMAT_BIN_SWAPPED	2
+
+static u8 Cache[MAX_CACHE] __attribute__((aligned(32)));
+
+/*
+ * Timing
+ */
+static double Now;			/* ns */
+static double RegNs = 100;
+static double PcapNs = 10;		/* per word, 400 MB/s */
+static double SdMBps = 25;
+static double QspiMBps = 8;
+
+/*
+ * Modules
+ */
+typedef struct {
+	u32 Words;
+	u32 Format;
+	u32 Bytes;			/* file */
+	double MBps;
+} ModelModule;
+
+static ModelModule Modules[MODULES];
+
+/*
+ * devcfg state
+ */
+static u32 Regs[0x100 / 4];
+static u32 IntSts;
+static int DmaPending;
+static double DmaEnd;
+static int FailDma;
+static int FailFetch;
+
+static XDcfg Dcfg;
+static XDcfgPr Pr;
+
+static u32 Transfers;
+static u32 Errors;
+
+static u32 ModuleWord(u32 Id, u32 Index)
+{
+	static const u32 Head[SYNC_INDEX + 1] = {
+		0xFFFFFFFF, 0x000000BB, 0x11220044, 0xFFFFFFFF, 0xFFFFFFFF,
+		0xAA995566
+	};
+	u32 Word;
+
+	if (Index <= SYNC_INDEX)
+		return Head[Index];
+	Word = (Id + 1) * 0x9E3779B9u ^ Index * 0x85EBCA6Bu;
+	return Word ^ (Word >> 15);
+}
+
+/*
+ * .bit header up to the length of field 'e'
+ */
+static u32 BitHeader(u32 Id, u8 *Out)
+{
+	static const u8 Field0[] = { 0x00, 0x09, 0x0F, 0xF0, 0x0F, 0xF0, 0x0F,
+			0xF0, 0x0F, 0xF0, 0x00, 0x00, 0x01 };
+	char Strings[4][64];
+	u32 Len = sizeof(Field0);
+	u32 Field;
+	u32 Size;
+
+	snprintf(Strings[0], sizeof(Strings[0]),
+			"region%u_module%u_partial.ncd;UserID=0XFFFFFFFF",
+			Id / REGION_MODULES, Id % REGION_MODULES);
+	strcpy(Strings[1], "7z020clg484");
+	strcpy(Strings[2], "2026/10/16");
+	strcpy(Strings[3], "12:00:00");
+
+	if (Out)
+		memcpy(Out, Field0, sizeof(Field0));
+	for (Field = 0; Field < 4; Field++) {
+		Size = strlen(Strings[Field]) + 1;
+		if (Out) {
+			Out[Len] = 'a' + Field;
+			Out[Len + 1] = Size >> 8;
+			Out[Len + 2] = Size & 0xFF;
+			memcpy(Out + Len + 3, Strings[Field], Size);
+		}
+		Len += 3 + Size;
+	}
+	if (Out) {
+		Out[Len] = 'e';
+		Size = Modules[Id].Words * 4;
+		Out[Len + 1] = Size >> 24;
+		Out[Len + 2] = (Size >> 16) & 0xFF;
+		Out[Len + 3] = (Size >> 8) & 0xFF;
+		Out[Len + 4] = Size & 0xFF;
+	}
+	return Len + 5;
+}
+
+/*
+ * Fetch handler, the file of a module at the speed of its storage
+ */
+static int Fetch(void *CallBackRef, u32 Region, u32 Module, u8 *BufferPtr,
+		u32 Bytes)
+{
+	u32 Id = Region * REGION_MODULES + Module;
+	ModelModule *ModulePtr = &Modules[Id];
+	u32 Offset = 0;
+	u32 Index;
+	u32 Word;
+
+	if ((Region >= REGIONS) || (Module >= REGION_MODULES) ||
+			(Bytes != ModulePtr->Bytes))
+		return XST_FAILURE;
+
+	Now += Bytes / ModulePtr->MBps * 1000.0;
+	if (FailFetch) {
+		FailFetch = 0;
+		return XST_FAILURE;
+	}
+
+	if (ModulePtr->Format == FORMAT_BIT)
+		Offset = BitHeader(Id, BufferPtr);
+	for (Index = 0; Index < ModulePtr->Words; Index++, Offset += 4) {
+		Word = ModuleWord(Id, Index);
+		if (ModulePtr->Format == FORMAT_BIN_SWAPPED) {
+			memcpy(BufferPtr + Offset, &Word, 4);
+		} else {
+			BufferPtr[Offset] = Word >> 24;
+			BufferPtr[Offset + 1] = (Word >> 16) & 0xFF;
+			BufferPtr[Offset + 2] = (Word >> 8) & 0xFF;
+			BufferPtr[Offset + 3] = Word & 0xFF;
+		}
+	}
+	return XST_SUCCESS;
+}
+
+/*
+ * A DMA command, checked against the bitstream of the module at its
+ * source address
+ */
+static void StartDma(void)
+{
+	u32 Src = Regs[XDCFG_DMA_SRC_ADDR_OFFSET / 4];
+	u32 Words = Regs[XDCFG_DMA_SRC_LEN_OFFSET / 4];
+	u32 *Data = (u32 *)(unsigned long)(Src & ~3);
+	u32 Index;
+	u32 Id;
+	int Match = 0;
+
+	for (Id = 0; Id < Pr.NumModules; Id++)
+		if (Pr.Modules[Id].Addr == (Src & ~3))
+			break;
+	if ((Id < Pr.NumModules) && ((Src & 3) == 1) &&
+			(Regs[XDCFG_DMA_DEST_ADDR_OFFSET / 4] ==
+			XDCFG_DMA_INVALID_ADDRESS) && (Words == Modules[Id].Words)) {
+		for (Index = 0; Index < Words; Index++)
+			if (Data[Index] != ModuleWord(Id, Index))
+				break;
+		Match = (Index == Words);
+	}
+	if (!Match) {
+		printf("  FAIL: transfer %u is not a decoded bitstream\n", Transfers);
+		Errors++;
+	}
+
+	Transfers++;
+	DmaPending = 1;
+	DmaEnd = Now + Words * PcapNs;
+}
+
+u32 Xil_In32(u32 Addr)
+{
+	u32 Value;
+
+	Now += RegNs;
+	if ((Addr < MODEL_BASEADDR) || (Addr >= MODEL_BASEADDR + sizeof(Regs)))
+		return 0;
+
+	switch (Addr - MODEL_BASEADDR) {
+	case XDCFG_INT_STS_OFFSET:
+		if (DmaPending && (Now >= DmaEnd)) {
+			DmaPending = 0;
+			if (FailDma) {
+				FailDma = 0;
+				IntSts |= XDCFG_IXR_AXI_RERR_MASK;
+			} else {
+				IntSts |= XDCFG_IXR_DMA_DONE_MASK |
+						XDCFG_IXR_D_P_DONE_MASK;
+			}
+		}
+		return IntSts;
+	case XDCFG_STATUS_OFFSET:
+		Value = XDCFG_STATUS_PCFG_INIT_MASK;
+		if (!DmaPending)
+			Value |= XDCFG_STATUS_DMA_CMD_Q_E_MASK;
+		return Value;
+	default:
+		return Regs[(Addr - MODEL_BASEADDR) / 4];
+	}
+}
+
+void Xil_Out32(u32 Addr, u32 Value)
+{
+	Now += RegNs;
+	if ((Addr < MODEL_BASEADDR) || (Addr >= MODEL_BASEADDR + sizeof(Regs)))
+		return;
+
+	switch (Addr - MODEL_BASEADDR) {
+	case XDCFG_INT_STS_OFFSET:
+		IntSts &= ~Value;
+		break;
+	case XDCFG_DMA_DEST_LEN_OFFSET:
+		Regs[XDCFG_DMA_DEST_LEN_OFFSET / 4] = Value;
+		StartDma();
+		break;
+	default:
+		Regs[(Addr - MODEL_BASEADDR) / 4] = Value;
+		break;
+	}
+}
+
+void XTime_GetTime(XTime *Xtime)
+{
+	*Xtime = (XTime)(Now * (COUNTS_PER_SECOND / 1e9));
+}
+
+void Xil_DCacheFlushRange(unsigned int adr, unsigned len)
+{
+}
+
+unsigned int Xil_AssertStatus;
+
+void Xil_Assert(const char *File, int Line)
+{
+	fprintf(stderr, "assert %s:%d\n", File, Line);
+	exit(1);
+}
+
+static void Check(int Condition, const char *What)
+{
+	if (!Condition) {
+		printf("  FAIL: %s\n", What);
+		Errors++;
+	}
+}
+
+static void Setup(u32 CacheBytes, u32 Policy)
+{
+	u32 Id;
+
+	Check(XDcfgPr_Initialize(&Pr, &Dcfg, (u32)(unsigned long)Cache,
+			CacheBytes, REGIONS) == XST_SUCCESS, "initialize");
+	XDcfgPr_SetFetchHandler(&Pr, Fetch, NULL);
+	XDcfgPr_SetPolicy(&Pr, Policy);
+	for (Id = 0; Id < MODULES; Id++)
+		Check(XDcfgPr_AddModule(&Pr, Id / REGION_MODULES,
+				Id % REGION_MODULES, Modules[Id].Bytes) == XST_SUCCESS,
+				"add module");
+	for (Id = 0; Id < REGIONS; Id++)
+		XDcfgPr_SetResident(&Pr, Id, 0);
+}
+
+/*
+ * Start a swap and poll until it is done
+ */
+static void Swap(u32 Region, u32 Module, int Expect)
+{
+	int Status;
+
+	Check(XDcfgPr_StartSwap(&Pr, Region, Module) == XST_SUCCESS,
+			"swap started");
+	while ((Status = XDcfgPr_Poll(&Pr)) == XST_DEVICE_BUSY)
+		Now += POLL_NS;
+	Check(Status == Expect, "swap result");
+}
+
+/*
+ * Module of every swap, Zipf ranked per region, the ranking changes every
+ * PHASE_SWAPS swaps
+ */
+static void MakeWorkload(u32 *Requests, u32 Count)
+{
+	double Weight[REGION_MODULES];
+	double Total = 0;
+	double Pick;
+	u32 Rank[REGIONS][REGION_MODULES];
+	u32 Index;
+	u32 Region;
+	u32 Module;
+	u32 Other;
+	u32 Tmp;
+
+	for (Module = 0; Module < REGION_MODULES; Module++) {
+		Weight[Module] = 1.0 / pow(Module + 1, ZIPF_S);
+		Total += Weight[Module];
+	}
+
+	for (Index = 0; Index < Count; Index++) {
+		if (Index % PHASE_SWAPS == 0) {
+			for (Region = 0; Region < REGIONS; Region++) {
+				for (Module = 0; Module < REGION_MODULES; Module++)
+					Rank[Region][Module] = Module;
+				for (Module = REGION_MODULES - 1; Module > 0; Module--) {
+					Other = rand() % (Module + 1);
+					Tmp = Rank[Region][Module];
+					Rank[Region][Module] = Rank[Region][Other];
+					Rank[Region][Other] = Tmp;
+				}
+			}
+		}
+		Region = Index % REGIONS;
+		Pick = rand() / (RAND_MAX + 1.0) * Total;
+		for (Module = 0; (Module < REGION_MODULES - 1) &&
+				(Pick >= Weight[Module]); Module++)
+			Pick -= Weight[Module];
+		Requests[Index] = Rank[Region][Module];
+	}
+}
+
+int main(int argc, char **argv)
+{
+	static const char *PolicyName[] = { "LRU", "GDS" };
+	const XDcfgPr_Swap *SwapPtr;
+	u32 *Requests;
+	u32 CacheBytes = 4 << 20;
+	u32 Count = 3000;
+	u32 Id;
+	u32 Index;
+	u32 Policy;
+	u32 Started;
+	u32 Waited;
+	u32 Region;
+	u32 Total;
+	double ThinkNs = 2e6;
+	double SwapMs;
+	double WorstMs;
+	double SwapNs;
+	double FreeNs;
+	double Start;
+	int Arg;
+
+	for (Arg = 1; (Arg + 1 < argc) && (argv[Arg][0] == '-'); Arg += 2) {
+		if (strcmp(argv[Arg], "-c") == 0)
+			CacheBytes = (u32)(atof(argv[Arg + 1]) * (1 << 20));
+		else if (strcmp(argv[Arg], "-n") == 0)
+			Count = atoi(argv[Arg + 1]);
+		else if (strcmp(argv[Arg], "-p") == 0)
+			PcapNs = 4000.0 / atof(argv[Arg + 1]);
+		else if (strcmp(argv[Arg], "-q") == 0)
+			QspiMBps = atof(argv[Arg + 1]);
+		else if (strcmp(argv[Arg], "-t") == 0)
+			ThinkNs = atof(argv[Arg + 1]) * 1e6;
+		else
+			break;
+	}
+	if ((Arg < argc) || (PcapNs <= 0) || (QspiMBps <= 0) || (Count == 0) ||
+			(CacheBytes > MAX_CACHE)) {
+		fprintf(stderr, "usage: %s [-c <MB>] [-n <swaps>] [-p <MB/s>] "
+				"[-q <MB/s>] [-t <ms>]\n", argv[0]);
+		return 1;
+	}
+
+	srand(1);
+	for (Id = 0, Total = 0; Id < MODULES; Id++) {
+		Modules[Id].Words = 75000 + rand() % 250000;
+		Modules[Id].Format = Id % 3;
+		Modules[Id].MBps = (Id % 2) ? QspiMBps : SdMBps;
+		Modules[Id].Bytes = Modules[Id].Words * 4;
+		if (Modules[Id].Format == FORMAT_BIT)
+			Modules[Id].Bytes += BitHeader(Id, NULL);
+		Total += Modules[Id].Bytes;
+	}
+	printf("%u modules in %u regions, %.1f MB, cache %.1f MB, "
+			"PCAP %.0f MB/s, SD %.0f MB/s, QSPI %.0f MB/s\n", MODULES,
+			REGIONS, Total / 1048576.0, CacheBytes / 1048576.0,
+			4000.0 / PcapNs, SdMBps, QspiMBps);
+
+	XDcfg_CfgInitialize(&Dcfg, XDcfg_LookupConfig(XPAR_XDCFG_0_DEVICE_ID),
+			MODEL_BASEADDR);
+
+	/*
+	 * Behaviour
+	 */
+	Setup(CacheBytes, XDCFG_PR_POLICY_GDS);
+	Check(XDcfgPr_AddModule(&Pr, 0, 9, CacheBytes + 1) == XST_INVALID_PARAM,
+			"module larger than the cache refused");
+
+	Index = Transfers;
+	Swap(0, 0, XST_SUCCESS);
+	SwapPtr = XDcfgPr_GetSwap(&Pr, 0);
+	Check((Transfers == Index) && SwapPtr &&
+			(SwapPtr->Source == XDCFG_PR_RESIDENT) &&
+			(SwapPtr->LoadTicks == 0), "resident module not loaded");
+
+	Check(XDcfgPr_StartSwap(&Pr, 0, 1) == XST_SUCCESS, "swap started");
+	Check(XDcfgPr_StartSwap(&Pr, 0, 2) == XST_DEVICE_BUSY,
+			"swap while busy refused");
+	Check(XDcfgPr_Poll(&Pr) == XST_DEVICE_BUSY, "load returns early");
+	Check(XDcfgPr_Preload(&Pr, 1, 2) == XST_SUCCESS, "preload while busy");
+	while (XDcfgPr_Poll(&Pr) == XST_DEVICE_BUSY)
+		Now += POLL_NS;
+	SwapPtr = XDcfgPr_GetSwap(&Pr, 0);
+	Check(SwapPtr && (SwapPtr->Source == XDCFG_PR_FETCHED) &&
+			(SwapPtr->Module == 1) && (Pr.Resident[0] == 1) &&
+			(SwapPtr->FetchTicks > 0) &&
+			(SwapPtr->TotalTicks >= SwapPtr->FetchTicks +
+			SwapPtr->LoadTicks), "fetched swap logged");
+
+	Swap(0, 0, XST_SUCCESS);
+	Swap(0, 1, XST_SUCCESS);
+	SwapPtr = XDcfgPr_GetSwap(&Pr, 0);
+	Check(SwapPtr && (SwapPtr->Source == XDCFG_PR_CACHED) &&
+			(SwapPtr->FetchTicks == 0), "cached swap logged");
+	Swap(1, 2, XST_SUCCESS);
+	SwapPtr = XDcfgPr_GetSwap(&Pr, 0);
+	Check(SwapPtr && (SwapPtr->Source == XDCFG_PR_CACHED),
+			"preloaded module cached");
+
+	FailFetch = 1;
+	Check(XDcfgPr_StartSwap(&Pr, 0, 3) == XST_FAILURE,
+			"failed fetch reported");
+	Check(Pr.Resident[0] == 1, "failed fetch keeps the region");
+
+	FailDma = 1;
+	Swap(0, 0, XST_FAILURE);
+	Check(Pr.Resident[0] == XDCFG_PR_NONE, "failed transfer clears the region");
+	Swap(0, 0, XST_SUCCESS);
+	SwapPtr = XDcfgPr_GetSwap(&Pr, 0);
+	Check(SwapPtr && (SwapPtr->Source == XDCFG_PR_CACHED) &&
+			(Pr.Resident[0] == 0), "region loaded again after a failure");
+
+	/*
+	 * Workload
+	 */
+	Requests = malloc(Count * sizeof(u32));
+	if (Requests == NULL)
+		return 1;
+	MakeWorkload(Requests, Count);
+
+	printf("policy   hits  fetches  resident  evicted  mean ms  worst ms  "
+			"CPU free\n");
+	for (Policy = XDCFG_PR_POLICY_LRU; Policy <= XDCFG_PR_POLICY_GDS;
+			Policy++) {
+		Setup(CacheBytes, Policy);
+		SwapNs = 0;
+		FreeNs = 0;
+		WorstMs = 0;
+		Waited = 0;
+		for (Index = 0; Index < Count; Index++) {
+			Region = Index % REGIONS;
+			Start = Now;
+			Started = Transfers;
+			Check(XDcfgPr_StartSwap(&Pr, Region, Requests[Index]) ==
+					XST_SUCCESS, "swap started");
+			if ((Transfers != Started) && !DmaPending)
+				Waited++;
+			while (XDcfgPr_Poll(&Pr) == XST_DEVICE_BUSY) {
+				Now += POLL_NS;
+				FreeNs += POLL_NS;
+			}
+			Check(Pr.Resident[Region] == Requests[Index],
+					"module resident after the swap");
+			SwapNs += Now - Start;
+			SwapMs = (Now - Start) / 1e6;
+			if (SwapMs > WorstMs)
+				WorstMs = SwapMs;
+			Now += ThinkNs;
+		}
+		Check(Waited == 0, "loads return before the PCAP is done");
+		printf("%-6s %6u %8u %9u %8u %8.2f %9.2f %8.0f%%\n",
+				PolicyName[Policy], Pr.Hits, Pr.Misses, Pr.Skips,
+				Pr.Evictions, SwapNs / 1e6 / Count, WorstMs,
+				100.0 * FreeNs / SwapNs);
+	}
+
+	printf("%u transfers, %u errors\n", Transfers, Errors);
+	free(Requests);
+	return Errors ? 1 : 0;
+}
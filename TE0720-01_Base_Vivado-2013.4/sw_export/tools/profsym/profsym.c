@@ -0,0 +1,315 @@
+/******************************************************************************
+*
+* profsym.c
+*
+* Host side symbolizer for the histograms written by profile_pmu_write_gmon().
+* Reads the function symbols of a little endian ELF32 image and prints a flat
+* profile per function for every gmon file given on the command line, one
+* file per PMU event.
+*
+* Usage: profsym <image.elf> <gmon file> [<gmon file> ...]
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EI_NIDENT		16
+#define SHT_SYMTAB		2
+#define STT_FUNC		2
+
+#define GMON_HDR_LEN		20
+#define GMON_TAG_TIME_HIST	0
+#define GMON_TAG_CG_ARC		1
+#define GMON_HIST_DIMEN_LEN	15
+#define GMON_CG_ARC_LEN		12
+
+typedef struct {
+	unsigned long Addr;
+	unsigned long Size;
+	const char *Name;
+	unsigned long long Count;
+} Symbol;
+
+static Symbol *SymTbl;
+static unsigned int NumSyms;
+
+static unsigned long Get16(const unsigned char *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static unsigned long Get32(const unsigned char *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+static unsigned char *ReadFile(const char *Path, unsigned long *LenPtr)
+{
+	FILE *Fp;
+	unsigned char *Buf;
+	long Len;
+
+	Fp = fopen(Path, "rb");
+	if (Fp == NULL) {
+		perror(Path);
+		return NULL;
+	}
+	fseek(Fp, 0, SEEK_END);
+	Len = ftell(Fp);
+	fseek(Fp, 0, SEEK_SET);
+
+	Buf = malloc(Len > 0 ? Len : 1);
+	if ((Buf == NULL) || (fread(Buf, 1, Len, Fp) != (size_t)Len)) {
+		fprintf(stderr, "%s: read failed\n", Path);
+		free(Buf);
+		fclose(Fp);
+		return NULL;
+	}
+	fclose(Fp);
+
+	*LenPtr = Len;
+	return Buf;
+}
+
+static int CompareSymAddr(const void *A, const void *B)
+{
+	const Symbol *SymA = A;
+	const Symbol *SymB = B;
+
+	if (SymA->Addr != SymB->Addr)
+		return SymA->Addr < SymB->Addr ? -1 : 1;
+	return 0;
+}
+
+static int CompareSymCount(const void *A, const void *B)
+{
+	const Symbol *SymA = A;
+	const Symbol *SymB = B;
+
+	if (SymA->Count != SymB->Count)
+		return SymA->Count > SymB->Count ? -1 : 1;
+	return CompareSymAddr(A, B);
+}
+
+/*
+ * Collect the STT_FUNC entries of the ELF symbol table, sorted by address.
+ * Thumb addresses have bit 0 cleared.
+ */
+static int LoadSymbols(const unsigned char *Elf, unsigned long Len)
+{
+	unsigned long ShOff, ShEntSize, ShNum;
+	unsigned long Index;
+	const unsigned char *Sh;
+
+	if ((Len < 52) || memcmp(Elf, "\177ELF", 4) || (Elf[4] != 1) ||
+			(Elf[5] != 1)) {
+		fprintf(stderr, "not a little endian ELF32 image\n");
+		return -1;
+	}
+
+	ShOff = Get32(Elf + 32);
+	ShEntSize = Get16(Elf + 46);
+	ShNum = Get16(Elf + 48);
+	if ((ShEntSize < 40) || (ShOff + ShNum * ShEntSize > Len)) {
+		fprintf(stderr, "bad section header table\n");
+		return -1;
+	}
+
+	for (Index = 0; Index < ShNum; Index++) {
+		unsigned long SymOff, SymSize, SymEntSize, StrOff, StrSize;
+		unsigned long Entry;
+		const unsigned char *StrSh;
+
+		Sh = Elf + ShOff + Index * ShEntSize;
+		if (Get32(Sh + 4) != SHT_SYMTAB)
+			continue;
+
+		SymOff = Get32(Sh + 16);
+		SymSize = Get32(Sh + 20);
+		SymEntSize = Get32(Sh + 36);
+		if ((Get32(Sh + 24) >= ShNum) || (SymEntSize < 16) ||
+				(SymOff + SymSize > Len))
+			return -1;
+
+		StrSh = Elf + ShOff + Get32(Sh + 24) * ShEntSize;
+		StrOff = Get32(StrSh + 16);
+		StrSize = Get32(StrSh + 20);
+		if (StrOff + StrSize > Len)
+			return -1;
+
+		SymTbl = calloc(SymSize / SymEntSize + 1, sizeof(Symbol));
+		if (SymTbl == NULL)
+			return -1;
+
+		for (Entry = 0; Entry < SymSize / SymEntSize; Entry++) {
+			const unsigned char *Sym = Elf + SymOff + Entry * SymEntSize;
+			unsigned long NameOff = Get32(Sym);
+
+			if (((Sym[12] & 0xF) != STT_FUNC) || (NameOff >= StrSize))
+				continue;
+
+			SymTbl[NumSyms].Addr = Get32(Sym + 4) & ~1UL;
+			SymTbl[NumSyms].Size = Get32(Sym + 8);
+			SymTbl[NumSyms].Name = (const char *)Elf + StrOff + NameOff;
+			NumSyms++;
+		}
+		break;
+	}
+
+	if (NumSyms == 0) {
+		fprintf(stderr, "no function symbols\n");
+		return -1;
+	}
+
+	qsort(SymTbl, NumSyms, sizeof(Symbol), CompareSymAddr);
+	return 0;
+}
+
+static Symbol *FindSymbol(unsigned long Addr)
+{
+	unsigned int Low = 0;
+	unsigned int High = NumSyms;
+
+	while (Low < High) {
+		unsigned int Mid = (Low + High) / 2;
+
+		if (SymTbl[Mid].Addr <= Addr)
+			Low = Mid + 1;
+		else
+			High = Mid;
+	}
+	if (Low == 0)
+		return NULL;
+
+	if ((SymTbl[Low - 1].Size != 0) &&
+			(Addr >= SymTbl[Low - 1].Addr + SymTbl[Low - 1].Size))
+		return NULL;
+
+	return &SymTbl[Low - 1];
+}
+
+/*
+ * Attribute every histogram bin of a gmon file to the function holding the
+ * start of the bin and print the functions by descending count.
+ */
+static int ProcessGmon(const char *Path)
+{
+	unsigned char *Buf;
+	unsigned long Len, Pos;
+	unsigned long long Total = 0, Unknown = 0;
+	unsigned long Rate = 0;
+	char Dimen[GMON_HIST_DIMEN_LEN + 1] = "";
+	unsigned int Index;
+
+	Buf = ReadFile(Path, &Len);
+	if (Buf == NULL)
+		return -1;
+
+	if ((Len < GMON_HDR_LEN) || memcmp(Buf, "gmon", 4)) {
+		fprintf(stderr, "%s: not a gmon file\n", Path);
+		free(Buf);
+		return -1;
+	}
+
+	for (Index = 0; Index < NumSyms; Index++)
+		SymTbl[Index].Count = 0;
+
+	Pos = GMON_HDR_LEN;
+	while (Pos < Len) {
+		unsigned long LowPc, HighPc, NumBins, Bin, BinSize;
+		const unsigned char *Rec = Buf + Pos;
+
+		if (Rec[0] == GMON_TAG_CG_ARC) {
+			Pos += 1 + GMON_CG_ARC_LEN;
+			continue;
+		}
+		if ((Rec[0] != GMON_TAG_TIME_HIST) ||
+				(Pos + 18 + GMON_HIST_DIMEN_LEN > Len)) {
+			fprintf(stderr, "%s: unsupported record at %lu\n", Path, Pos);
+			free(Buf);
+			return -1;
+		}
+
+		LowPc = Get32(Rec + 1);
+		HighPc = Get32(Rec + 5);
+		NumBins = Get32(Rec + 9);
+		Rate = Get32(Rec + 13);
+		memcpy(Dimen, Rec + 17, GMON_HIST_DIMEN_LEN);
+		Pos += 18 + GMON_HIST_DIMEN_LEN;
+
+		if ((NumBins == 0) || (Pos + NumBins * 2 > Len)) {
+			fprintf(stderr, "%s: truncated histogram\n", Path);
+			free(Buf);
+			return -1;
+		}
+		BinSize = (HighPc - LowPc) / NumBins;
+
+		for (Bin = 0; Bin < NumBins; Bin++) {
+			unsigned long Count = Get16(Buf + Pos + Bin * 2);
+			Symbol *Sym;
+
+			if (Count == 0)
+				continue;
+			Total += Count;
+			Sym = FindSymbol(LowPc + Bin * BinSize);
+			if (Sym != NULL)
+				Sym->Count += Count;
+			else
+				Unknown += Count;
+		}
+		Pos += NumBins * 2;
+	}
+	free(Buf);
+
+	printf("%s: %llu samples of %s", Path, Total, Dimen);
+	if (Rate > 1)
+		printf(" at %lu Hz", Rate);
+	printf("\n");
+	if (Total == 0)
+		return 0;
+
+	qsort(SymTbl, NumSyms, sizeof(Symbol), CompareSymCount);
+	printf("  %%    samples  function\n");
+	for (Index = 0; (Index < NumSyms) && (SymTbl[Index].Count != 0); Index++) {
+		printf("%6.2f %10llu  %s\n", 100.0 * SymTbl[Index].Count / Total,
+				SymTbl[Index].Count, SymTbl[Index].Name);
+	}
+	if (Unknown != 0)
+		printf("%6.2f %10llu  <unknown>\n", 100.0 * Unknown / Total, Unknown);
+	printf("\n");
+	qsort(SymTbl, NumSyms, sizeof(Symbol), CompareSymAddr);
+
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned char *Elf;
+	unsigned long Len;
+	int Index;
+	int Status = 0;
+
+	if (argc < 3) {
+		fprintf(stderr, "usage: %s <image.elf> <gmon file> ...\n", argv[0]);
+		return 1;
+	}
+
+	Elf = ReadFile(argv[1], &Len);
+	if ((Elf == NULL) || (LoadSymbols(Elf, Len) != 0))
+		return 1;
+
+	for (Index = 2; Index < argc; Index++) {
+		if (ProcessGmon(argv[Index]) != 0)
+			Status = 1;
+	}
+
+	return Status;
+}
@@ -0,0 +1,360 @@
+/******************************************************************************
+*
+* qspicalsim.c
+*
+* Host side test of the QSPI clock calibration of the FSBL
+* (QSPI_CALIBRATION). The calibration code of FSBL/src/qspical.c is run
+* against a flash model that returns the signature unchanged up to a given
+* SCLK rate and corrupts it above. Separate limits apply with and without
+* the loopback feedback clock. Within -m MHz below a limit the model fails
+* one read in eight, like a board at the edge of its timing.
+*
+* For every pair of limits of the sweep the test checks that
+*   - the setting found is the fastest loopback one within the limit whose
+*     next faster setting is within the limit too, settings without the
+*     loopback clock are never used,
+*   - the next boot takes it from the cache after checking it and the next
+*     faster setting with all passes,
+*   - a cached setting that no longer reads correctly, or whose next faster
+*     setting no longer does, is calibrated again,
+*   - a changed configuration id drops the cache.
+* With -m it reports how often a marginal setting got picked.
+*
+* The signature is the start of the FSBL partition of <BOOT.BIN>, random
+* data without one.
+*
+* Build: gcc -O2 -DQSPI_CALIBRATION -o qspicalsim qspicalsim.c
+*		 ../../FSBL/src/qspical.c -I../../FSBL/src
+*		 -I../../FSBL_bsp/ps7_cortexa9_0/include
+*
+* Usage: qspicalsim [-c <ref MHz>] [-l <MHz>] [-L <MHz>] [-m <MHz>]
+*		 [-n <runs>] [<BOOT.BIN>]
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+* 1.01a te   10/16/26 Loopback settings with one setting of margin, cache
+*                     checked with all passes
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xstatus.h"
+#include "qspical.h"
+
+#define BOOT_IDENT_OFFSET	0x24
+#define BOOT_FSBL_OFFSET	0x30
+#define BOOT_IDENT		0x584C4E58	/* "XNLX" */
+
+#define DEFAULT_REF_MHZ		200.0
+#define DEFAULT_RUNS		200
+#define MARGINAL_ODDS		8
+
+static unsigned char Signature[QSPI_CAL_SIZE];
+static unsigned char ReadData[QSPI_CAL_SIZE];
+
+static double RefMHz = DEFAULT_REF_MHZ;
+static double Limit;		/* MHz without loopback */
+static double LimitLoopback;	/* MHz with loopback */
+static double Margin;
+static unsigned long Reads;
+
+static unsigned long Get32(const unsigned char *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+static unsigned char *ReadFile(const char *Path, unsigned long *LenPtr)
+{
+	FILE *Fp;
+	unsigned char *Buf;
+	long Len;
+
+	Fp = fopen(Path, "rb");
+	if (Fp == NULL) {
+		perror(Path);
+		return NULL;
+	}
+	fseek(Fp, 0, SEEK_END);
+	Len = ftell(Fp);
+	fseek(Fp, 0, SEEK_SET);
+
+	Buf = malloc(Len > 0 ? Len : 1);
+	if ((Buf == NULL) || (fread(Buf, 1, Len, Fp) != (size_t)Len)) {
+		fprintf(stderr, "%s: read failed\n", Path);
+		free(Buf);
+		fclose(Fp);
+		return NULL;
+	}
+	fclose(Fp);
+
+	*LenPtr = Len;
+	return Buf;
+}
+
+/*
+ * SCLK of a setting, the prescaler divides by 2 << n
+ */
+static double ClockMHz(u32 Setting)
+{
+	return RefMHz / (2 << QSPI_CAL_PRESCALER(Setting));
+}
+
+static double LimitMHz(u32 Setting)
+{
+	return (Setting & QSPI_CAL_LOOPBACK) ? LimitLoopback : Limit;
+}
+
+/*
+ * Flash model, the read function handed to QspiCalibrate()
+ */
+static u8 *ModelRead(u32 Setting)
+{
+	double Clock = ClockMHz(Setting);
+	int Flips = 0;
+
+	Reads++;
+	memcpy(ReadData, Signature, QSPI_CAL_SIZE);
+
+	if (Clock > LimitMHz(Setting))
+		Flips = 1 + rand() % 3;
+	else if ((Clock > LimitMHz(Setting) - Margin) &&
+			(rand() % MARGINAL_ODDS == 0))
+		Flips = 1;
+
+	while (Flips-- > 0)
+		ReadData[rand() % QSPI_CAL_SIZE] ^= 1 << (rand() % 8);
+
+	return ReadData;
+}
+
+/*
+ * Fastest loopback setting the model reads correctly whose next faster
+ * setting it reads correctly too
+ */
+static u32 Expected(double MarginMHz)
+{
+	static const u32 Order[] = {
+		XQSPIPS_CLK_PRESCALE_4 | QSPI_CAL_LOOPBACK,
+		XQSPIPS_CLK_PRESCALE_2 | QSPI_CAL_LOOPBACK
+	};
+	u32 Setting = QSPI_CAL_DEFAULT;
+	unsigned Index;
+
+	for (Index = 0; Index + 1 < sizeof(Order) / sizeof(Order[0]); Index++)
+		if (ClockMHz(Order[Index + 1]) <=
+				LimitMHz(Order[Index + 1]) - MarginMHz)
+			Setting = Order[Index];
+
+	return Setting;
+}
+
+static const char *Name(u32 Setting)
+{
+	static char Buf[4][32];
+	static int Next;
+	char *p = Buf[Next++ & 3];
+
+	sprintf(p, "/%d%s", 2 << QSPI_CAL_PRESCALER(Setting),
+			(Setting & QSPI_CAL_LOOPBACK) ? "+lpbk" : "");
+	return p;
+}
+
+/*
+ * Calibration, cached boot and recalibration after the board got slower
+ */
+static int CheckLimits(void)
+{
+	QspiCalCache Cache;
+	u32 Setting;
+	u32 Want;
+	u32 Cached;
+	unsigned long CacheReads;
+	double Saved;
+	int Step;
+	int Errors = 0;
+
+	memset(&Cache, 0xA5, sizeof(Cache));	/* OCM after power on */
+
+	Want = Expected(0);
+	Setting = QspiCalibrate(ModelRead, 1, &Cache);
+	if (Setting != Want) {
+		printf("  limit %5.1f/%5.1f MHz: got %s, want %s\n", Limit,
+				LimitLoopback, Name(Setting), Name(Want));
+		Errors++;
+	}
+
+	/*
+	 * Reference read, then the cached setting and the next faster one
+	 * with all passes
+	 */
+	Reads = 0;
+	CacheReads = (Setting == QSPI_CAL_DEFAULT) ? 1 : 1 + 2 * QSPI_CAL_PASSES;
+	if ((QspiCalibrate(ModelRead, 1, &Cache) != Setting) ||
+			(Reads != CacheReads)) {
+		printf("  limit %5.1f/%5.1f MHz: cache not used (%lu reads)\n",
+				Limit, LimitLoopback, Reads);
+		Errors++;
+	}
+
+	if ((QspiCalibrate(ModelRead, 2, &Cache) != Setting) ||
+			(Cache.ConfigId != 2)) {
+		printf("  limit %5.1f/%5.1f MHz: cache of other config used\n",
+				Limit, LimitLoopback);
+		Errors++;
+	}
+
+	/*
+	 * Board gets slower than the next faster setting, then slower than
+	 * the cached one
+	 */
+	if (Setting != QSPI_CAL_DEFAULT) {
+		Cached = Setting;
+		Saved = LimitLoopback;
+		for (Step = 0; Step < 2; Step++) {
+			LimitLoopback = (Step == 0) ? 2 * ClockMHz(Cached) - 1 :
+					ClockMHz(Cached) - 1;
+
+			Want = Expected(0);
+			Setting = QspiCalibrate(ModelRead, 2, &Cache);
+			if ((Setting != Want) || (Setting == Cached)) {
+				printf("  limit %5.1f/%5.1f MHz: stale cache gave %s, "
+						"want %s\n", Limit, LimitLoopback,
+						Name(Setting), Name(Want));
+				Errors++;
+			}
+
+			Cache.Setting = Cached;
+			Cache.Checksum = 0;
+			Cache.Checksum = ~(Cache.Magic + Cache.ConfigId +
+					Cache.Setting + Cache.Hash);
+		}
+		LimitLoopback = Saved;
+	}
+
+	return Errors;
+}
+
+/*
+ * Marginal board, how often does a setting within -m of its limit win
+ */
+static int CheckMargin(int Runs)
+{
+	QspiCalCache Cache;
+	u32 Safe = Expected(Margin);
+	u32 Setting;
+	int Marginal = 0;
+	int Run;
+
+	for (Run = 0; Run < Runs; Run++) {
+		memset(&Cache, 0, sizeof(Cache));
+		Setting = QspiCalibrate(ModelRead, 1, &Cache);
+		if (ClockMHz(Setting) > LimitMHz(Setting) - Margin)
+			Marginal++;
+	}
+
+	printf("limit %5.1f/%5.1f MHz margin %4.1f: marginal setting picked "
+			"%d of %d (%.1f%%), safe %s\n", Limit, LimitLoopback, Margin,
+			Marginal, Runs, 100.0 * Marginal / Runs, Name(Safe));
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned char *Image;
+	unsigned long Len;
+	unsigned long Offset;
+	double Min;
+	double Step;
+	double SweepLimit;
+	double SweepLoopback;
+	double GivenLimit;
+	double GivenLoopback;
+	double MarginGiven;
+	int Runs = DEFAULT_RUNS;
+	int Arg;
+	int Cases = 0;
+	int Errors = 0;
+	unsigned Index;
+
+	Limit = -1;
+	LimitLoopback = -1;
+	for (Arg = 1; (Arg + 1 < argc) && (argv[Arg][0] == '-'); Arg += 2) {
+		if (strcmp(argv[Arg], "-c") == 0)
+			RefMHz = strtod(argv[Arg + 1], NULL);
+		else if (strcmp(argv[Arg], "-l") == 0)
+			Limit = strtod(argv[Arg + 1], NULL);
+		else if (strcmp(argv[Arg], "-L") == 0)
+			LimitLoopback = strtod(argv[Arg + 1], NULL);
+		else if (strcmp(argv[Arg], "-m") == 0)
+			Margin = strtod(argv[Arg + 1], NULL);
+		else if (strcmp(argv[Arg], "-n") == 0)
+			Runs = atoi(argv[Arg + 1]);
+		else
+			break;
+	}
+	if ((RefMHz <= 0) || (Margin < 0) || (Runs <= 0) || (Arg + 1 < argc) ||
+			((Arg < argc) && (argv[Arg][0] == '-'))) {
+		fprintf(stderr, "usage: %s [-c <ref MHz>] [-l <MHz>] [-L <MHz>] "
+				"[-m <MHz>] [-n <runs>] [<BOOT.BIN>]\n", argv[0]);
+		return 1;
+	}
+
+	srand(1);
+	for (Index = 0; Index < QSPI_CAL_SIZE; Index++)
+		Signature[Index] = rand();
+
+	if (Arg < argc) {
+		Image = ReadFile(argv[Arg], &Len);
+		if (Image == NULL)
+			return 1;
+		Offset = (Len >= BOOT_FSBL_OFFSET + 4) ?
+				Get32(Image + BOOT_FSBL_OFFSET) : 0;
+		if ((Get32(Image + BOOT_IDENT_OFFSET) != BOOT_IDENT) ||
+				(Offset + QSPI_CAL_SIZE > Len)) {
+			fprintf(stderr, "%s: no boot image\n", argv[Arg]);
+			return 1;
+		}
+		memcpy(Signature, Image + Offset, QSPI_CAL_SIZE);
+		free(Image);
+	}
+
+	/*
+	 * Sweep the limits from the default clock up, unless given
+	 */
+	MarginGiven = Margin;
+	Margin = 0;
+	Min = ClockMHz(QSPI_CAL_DEFAULT);
+	Step = Min / 4;
+	GivenLimit = Limit;
+	GivenLoopback = LimitLoopback;
+	for (SweepLimit = Min; SweepLimit <= RefMHz; SweepLimit += Step) {
+		for (SweepLoopback = Min; SweepLoopback <= RefMHz;
+				SweepLoopback += Step) {
+			Limit = (GivenLimit >= 0) ? GivenLimit : SweepLimit;
+			LimitLoopback = (GivenLoopback >= 0) ? GivenLoopback :
+					SweepLoopback;
+			Cases++;
+			Errors += CheckLimits();
+			if (GivenLoopback >= 0)
+				break;
+		}
+		if (GivenLimit >= 0)
+			break;
+	}
+	printf("%d limit pairs at %.1f MHz reference: %d errors\n", Cases,
+			RefMHz, Errors);
+
+	if (MarginGiven > 0) {
+		Margin = MarginGiven;
+		Limit = (GivenLimit >= 0) ? GivenLimit : RefMHz / 4;
+		LimitLoopback = (GivenLoopback >= 0) ? GivenLoopback : RefMHz / 2;
+		CheckMargin(Runs);
+	}
+
+	return Errors ? 1 : 0;
+}
@@ -0,0 +1,404 @@
+/******************************************************************************
+*
+* qspififo.c
+*
+* Host side model of the QSPI controller FIFOs for the polled transfers of
+* the qspips driver. The driver source is built into the tool, its register
+* accesses go to a model of the TX and RX FIFOs (63 words each), the status
+* bits the polled loop waits on and a quad output read flash behind them.
+*
+* The model keeps a clock: every register read and write takes -r / -w ns,
+* a word on the bus takes 32 SCLK for the instruction and 8 SCLK for the
+* words after it (4 data lines), at -s MHz. A word leaves the TX FIFO when
+* it starts on the bus and enters the RX FIFO when it is done.
+*
+* Every FSBL read size up to -n bytes is read once into a word aligned
+* buffer and once into a buffer one byte off, the data is checked against
+* the flash contents. Reported per buffer are the register accesses per word,
+* the model and the host throughput of a 4KB read, and any FIFO underrun or
+* overflow.
+*
+* Register accesses faster than a bus word (e.g. -r 5 -w 5) check that the
+* last words are not read from the RX FIFO before they are off the bus.
+*
+* Build: gcc -O2 -o qspififo qspififo.c
+*		 -I../../FSBL_bsp/ps7_cortexa9_0/libsrc/qspips_v2_03_a/src
+*		 -I../../FSBL_bsp/ps7_cortexa9_0/include
+*
+* Usage: qspififo [-r <ns>] [-w <ns>] [-s <MHz>] [-n <bytes>] [-l <loops>]
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+* 1.01a te   10/16/26 Aligned and offset buffer instead of word and byte path
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * 32-bit register and pointer arithmetic types of the target, xil_types.h
+ * leaves them out when XBASIC_TYPES_H is defined
+ */
+#define XBASIC_TYPES_H
+typedef unsigned char u8;
+typedef unsigned short u16;
+typedef unsigned int u32;
+
+#include "xqspips.c"
+#include "xqspips_options.c"
+
+#define MODEL_BASEADDR		0xE000D000
+#define FLASH_SIZE		0x10000
+#define QUAD_READ_CMD		0x6B
+#define READ_OVERHEAD		5	/* instruction, address and dummy byte */
+#define MAX_READ		4096
+
+#define DEFAULT_READ_NS		60.0
+#define DEFAULT_WRITE_NS	40.0
+#define DEFAULT_SCLK_MHZ	100.0
+#define DEFAULT_LOOPS		200
+
+static unsigned char Flash[FLASH_SIZE];
+
+static double ReadNs = DEFAULT_READ_NS;
+static double WriteNs = DEFAULT_WRITE_NS;
+static double SclkMHz = DEFAULT_SCLK_MHZ;
+
+/*
+ * Controller state
+ */
+static u32 Regs[0x100 / 4];
+static u32 TxFifo[XQSPIPS_FIFO_DEPTH];
+static double TxStamp[XQSPIPS_FIFO_DEPTH];
+static u32 RxFifo[XQSPIPS_FIFO_DEPTH];
+static int TxHead, TxCount;
+static int RxHead, RxCount;
+static int Shifting;		/* a word is on the bus */
+static double ShiftDone;	/* when it is done */
+static double ShiftFree;	/* when the bus got idle */
+static double Now;
+static u32 WordIndex;		/* words since slave select */
+static u32 ReadAddress;
+static int ReadCommand;
+
+static unsigned long Reads, Writes;
+static unsigned long Underruns, Overflows;
+
+static double WordNs(void)
+{
+	return ((WordIndex == 0) ? 32 : 8) * 1000.0 / SclkMHz;
+}
+
+/*
+ * Byte stream of a quad output read after the instruction word, the dummy
+ * byte and then the flash data
+ */
+static u32 ReadWord(void)
+{
+	u32 Data = 0;
+	u32 Pos;
+	int Byte;
+
+	if (!ReadCommand)
+		return 0xFFFFFFFF;
+
+	for (Byte = 3; Byte >= 0; Byte--) {
+		Pos = (WordIndex - 1) * 4 + Byte;
+		Data = (Data << 8) |
+			((Pos == 0) ? 0xFF : Flash[(ReadAddress + Pos - 1) %
+			FLASH_SIZE]);
+	}
+	return Data;
+}
+
+/*
+ * Moves words over the bus up to the current time
+ */
+static void Advance(void)
+{
+	double Start;
+	u32 Word;
+
+	for (;;) {
+		if (Shifting && (ShiftDone <= Now)) {
+			if (RxCount == XQSPIPS_FIFO_DEPTH) {
+				Overflows++;
+			} else {
+				RxFifo[(RxHead + RxCount++) % XQSPIPS_FIFO_DEPTH] =
+						ReadWord();
+			}
+			WordIndex++;
+			Shifting = 0;
+			ShiftFree = ShiftDone;
+			continue;
+		}
+		if (!Shifting && (TxCount > 0) && (Regs[XQSPIPS_ER_OFFSET / 4] &
+				XQSPIPS_ER_ENABLE_MASK)) {
+			Start = (ShiftFree > TxStamp[TxHead]) ? ShiftFree :
+					TxStamp[TxHead];
+			if (Start <= Now) {
+				Word = TxFifo[TxHead];
+				if (WordIndex == 0) {
+					ReadCommand = ((Word & 0xFF) == QUAD_READ_CMD);
+					ReadAddress = ((Word >> 8) & 0xFF) << 16 |
+						((Word >> 16) & 0xFF) << 8 | (Word >> 24);
+				}
+				TxHead = (TxHead + 1) % XQSPIPS_FIFO_DEPTH;
+				TxCount--;
+				Shifting = 1;
+				ShiftDone = Start + WordNs();
+				continue;
+			}
+		}
+		break;
+	}
+}
+
+static u32 StatusReg(void)
+{
+	u32 Status = 0;
+
+	if (TxCount < (int)Regs[XQSPIPS_TXWR_OFFSET / 4])
+		Status |= XQSPIPS_IXR_TXOW_MASK;
+	if (TxCount == XQSPIPS_FIFO_DEPTH)
+		Status |= XQSPIPS_IXR_TXFULL_MASK;
+	if (RxCount >= (int)Regs[XQSPIPS_RXWR_OFFSET / 4])
+		Status |= XQSPIPS_IXR_RXNEMPTY_MASK;
+	if (RxCount == XQSPIPS_FIFO_DEPTH)
+		Status |= XQSPIPS_IXR_RXFULL_MASK;
+	return Status;
+}
+
+u32 Xil_In32(u32 Addr)
+{
+	u32 Offset = Addr - MODEL_BASEADDR;
+	u32 Data;
+
+	Reads++;
+	Now += ReadNs;
+	Advance();
+
+	if (Offset == XQSPIPS_SR_OFFSET)
+		return StatusReg();
+	if (Offset == XQSPIPS_RXD_OFFSET) {
+		if (RxCount == 0) {
+			Underruns++;
+			return 0;
+		}
+		Data = RxFifo[RxHead];
+		RxHead = (RxHead + 1) % XQSPIPS_FIFO_DEPTH;
+		RxCount--;
+		return Data;
+	}
+	return Regs[(Offset / 4) % (sizeof(Regs) / sizeof(Regs[0]))];
+}
+
+void Xil_Out32(u32 Addr, u32 Value)
+{
+	u32 Offset = Addr - MODEL_BASEADDR;
+
+	Writes++;
+	Now += WriteNs;
+	Advance();
+
+	switch (Offset) {
+	case XQSPIPS_TXD_00_OFFSET:
+	case XQSPIPS_TXD_01_OFFSET:
+	case XQSPIPS_TXD_10_OFFSET:
+	case XQSPIPS_TXD_11_OFFSET:
+		if (TxCount == XQSPIPS_FIFO_DEPTH) {
+			Overflows++;
+			break;
+		}
+		TxFifo[(TxHead + TxCount) % XQSPIPS_FIFO_DEPTH] = Value;
+		TxStamp[(TxHead + TxCount) % XQSPIPS_FIFO_DEPTH] = Now;
+		TxCount++;
+		break;
+	case XQSPIPS_CR_OFFSET:
+		/* Slave select going active starts a new instruction */
+		if ((Regs[XQSPIPS_CR_OFFSET / 4] & XQSPIPS_CR_SSCTRL_MASK) &&
+				!(Value & XQSPIPS_CR_SSCTRL_MASK)) {
+			WordIndex = 0;
+			ReadCommand = 0;
+		}
+		Regs[XQSPIPS_CR_OFFSET / 4] = Value;
+		break;
+	case XQSPIPS_SR_OFFSET:
+		break;
+	default:
+		Regs[(Offset / 4) % (sizeof(Regs) / sizeof(Regs[0]))] = Value;
+		break;
+	}
+	Advance();
+}
+
+void Xil_Assert(const char *File, int Line)
+{
+	fprintf(stderr, "assert %s:%d\n", File, Line);
+	exit(2);
+}
+
+void XNullHandler(void *NullParameter)
+{
+	(void)NullParameter;
+}
+
+unsigned int Xil_AssertStatus;
+
+static XQspiPs Qspi;
+
+/*
+ * One FSBL read, the data lands at RecvBuf + READ_OVERHEAD
+ */
+static void FlashRead(u8 *SendBuf, u8 *RecvBuf, u32 Address, u32 ByteCount)
+{
+	SendBuf[0] = QUAD_READ_CMD;
+	SendBuf[1] = (u8)(Address >> 16);
+	SendBuf[2] = (u8)(Address >> 8);
+	SendBuf[3] = (u8)Address;
+
+	XQspiPs_PolledTransfer(&Qspi, SendBuf, RecvBuf,
+			ByteCount + READ_OVERHEAD);
+
+	/* The bus is idle once slave select goes inactive */
+	if (Shifting && (ShiftDone > Now))
+		Now = ShiftDone;
+	Shifting = 0;
+	TxCount = 0;
+	RxCount = 0;
+}
+
+static int Check(const char *Buffer, u8 *RecvBuf, u32 Address, u32 ByteCount)
+{
+	u32 Index;
+
+	for (Index = 0; Index < ByteCount; Index++) {
+		if (RecvBuf[READ_OVERHEAD + Index] != Flash[(Address + Index) %
+				FLASH_SIZE]) {
+			printf("  %s buffer: %u bytes at 0x%x differ at byte %u\n",
+					Buffer, ByteCount, Address, Index);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Throughput of a 4KB read
+ */
+static void Measure(const char *Buffer, u8 *SendBuf, u8 *RecvBuf, int Loops)
+{
+	unsigned long Words = (MAX_READ + READ_OVERHEAD + 3) / 4;
+	double Start;
+	double Model;
+	double PerWordReads;
+	double PerWordWrites;
+	clock_t Host;
+	int Loop;
+
+	Reads = 0;
+	Writes = 0;
+	Start = Now;
+	FlashRead(SendBuf, RecvBuf, 0, MAX_READ);
+	Model = Now - Start;
+	PerWordReads = (double)Reads / Words;
+	PerWordWrites = (double)Writes / Words;
+
+	Host = clock();
+	for (Loop = 0; Loop < Loops; Loop++)
+		FlashRead(SendBuf, RecvBuf, 0, MAX_READ);
+	Host = clock() - Host;
+
+	printf("%-7s buffer: %.2f reads %.2f writes per word, model %.1f MB/s, "
+			"host %.1f ns per word\n", Buffer, PerWordReads, PerWordWrites,
+			MAX_READ * 1000.0 / Model,
+			Loops ? 1e9 * Host / CLOCKS_PER_SEC / ((double)Loops * Words) :
+			0.0);
+}
+
+int main(int argc, char **argv)
+{
+	static XQspiPs_Config Config;
+	static u32 SendWords[(MAX_READ + READ_OVERHEAD) / 4 + 2];
+	static u32 RecvWords[(MAX_READ + READ_OVERHEAD) / 4 + 2];
+	u8 *SendBuf = (u8 *)SendWords;
+	u8 *AlignedBuf = (u8 *)RecvWords;
+	u8 *OffsetBuf = (u8 *)RecvWords + 1;
+	u32 MaxRead = MAX_READ;
+	u32 ByteCount;
+	u32 Address;
+	int Loops = DEFAULT_LOOPS;
+	int Arg;
+	int Errors = 0;
+	int Cases = 0;
+	u32 Index;
+
+	for (Arg = 1; (Arg + 1 < argc) && (argv[Arg][0] == '-'); Arg += 2) {
+		if (strcmp(argv[Arg], "-r") == 0)
+			ReadNs = strtod(argv[Arg + 1], NULL);
+		else if (strcmp(argv[Arg], "-w") == 0)
+			WriteNs = strtod(argv[Arg + 1], NULL);
+		else if (strcmp(argv[Arg], "-s") == 0)
+			SclkMHz = strtod(argv[Arg + 1], NULL);
+		else if (strcmp(argv[Arg], "-n") == 0)
+			MaxRead = strtoul(argv[Arg + 1], NULL, 0);
+		else if (strcmp(argv[Arg], "-l") == 0)
+			Loops = atoi(argv[Arg + 1]);
+		else
+			break;
+	}
+	if ((ReadNs <= 0) || (WriteNs < 0) || (SclkMHz <= 0) ||
+			(MaxRead > MAX_READ) || (Loops < 0) || (Arg < argc)) {
+		fprintf(stderr, "usage: %s [-r <ns>] [-w <ns>] [-s <MHz>] "
+				"[-n <bytes>] [-l <loops>]\n", argv[0]);
+		return 1;
+	}
+
+	srand(1);
+	for (Index = 0; Index < FLASH_SIZE; Index++)
+		Flash[Index] = rand();
+
+	Config.BaseAddress = MODEL_BASEADDR;
+	Regs[XQSPIPS_CR_OFFSET / 4] = XQSPIPS_CR_RESET_STATE;
+	if (XQspiPs_CfgInitialize(&Qspi, &Config, MODEL_BASEADDR) !=
+			XST_SUCCESS) {
+		fprintf(stderr, "driver init failed\n");
+		return 1;
+	}
+	XQspiPs_SetOptions(&Qspi, XQSPIPS_FORCE_SSELECT_OPTION |
+			XQSPIPS_HOLD_B_DRIVE_OPTION);
+
+	/*
+	 * Every size, both buffers, a few addresses
+	 */
+	for (ByteCount = 1; ByteCount <= MaxRead; ByteCount++) {
+		for (Address = 0; Address < 4; Address++) {
+			Cases++;
+			memset(RecvWords, 0, sizeof(RecvWords));
+			FlashRead(SendBuf, AlignedBuf, Address * 0x1001, ByteCount);
+			Errors += Check("aligned", AlignedBuf, Address * 0x1001,
+					ByteCount);
+
+			memset(RecvWords, 0, sizeof(RecvWords));
+			FlashRead(SendBuf, OffsetBuf, Address * 0x1001, ByteCount);
+			Errors += Check("offset", OffsetBuf, Address * 0x1001,
+					ByteCount);
+		}
+	}
+	printf("%d reads of 1 to %u bytes into both buffers: %d errors, "
+			"%lu underruns, %lu overflows\n", Cases, MaxRead, Errors,
+			Underruns, Overflows);
+
+	printf("read %.0f ns, write %.0f ns, SCLK %.0f MHz\n", ReadNs, WriteNs,
+			SclkMHz);
+	Measure("aligned", SendBuf, AlignedBuf, Loops);
+	Measure("offset", SendBuf, OffsetBuf, Loops);
+
+	return (Errors || Underruns || Overflows) ? 1 : 0;
+}
@@ -0,0 +1,670 @@
+/******************************************************************************
+*
+* qspilinsim.c
+*
+* Host side test of the QSPI linear window of the FSBL (QSPI_LINEAR_WINDOW).
+* FSBL/src/qspi.c and the qspips driver are built into the tool, their
+* register accesses go to a model of the controller with one or two flashes
+* behind it. The model answers the ID, bank register (Spansion BRRD/BRWR,
+* Micron EARRD/EARWR after WREN) and quad output read commands in I/O mode.
+* Winbond flashes have no bank register. Reads of the linear window are
+* served from the bank each flash has selected, the connection mode is a
+* variable of the tool instead of XPAR_PS7_QSPI_0_QSPI_MODE.
+*
+* For every connection mode, flash make and flash size the test checks that
+*   - InitQspi() enables the window only for Micron and Spansion flashes
+*     larger than 16MB, also in dual stack,
+*   - reads at the start, across every 16MB bank boundary, backwards and
+*     with odd lengths return the image,
+*   - ReleaseQspi() leaves bank 0 selected in every flash,
+*   - flashes that the window does not handle keep the I/O mode path, a
+*     Winbond flash that path needs the bank register for fails as before.
+*
+* The model keeps a clock: every register access takes -r ns, an I/O mode
+* transfer takes at least its SCLK time at -s MHz (instruction and address
+* on one line, dummy and data on four). A linear read is split into AXI
+* bursts of -b bytes, each takes one register access and a flash read of
+* its own (instruction, address, dummy byte and data). Reported are the
+* rate of a 4MB read above 16MB and the time of a 64 byte read there, like
+* the header reads of the FSBL, through the window and through I/O mode.
+*
+* Build: gcc -O2 -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast
+*		 -o qspilinsim qspilinsim.c -I../../FSBL/src
+*		 -I../../FSBL_bsp/ps7_cortexa9_0/include
+*		 -I../../FSBL_bsp/ps7_cortexa9_0/libsrc/qspips_v2_03_a/src
+*
+* Usage: qspilinsim [-r <ns>] [-s <MHz>] [-b <burst bytes>]
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/*
+ * 32-bit register and pointer arithmetic types of the target, xil_types.h
+ * leaves them out when XBASIC_TYPES_H is defined
+ */
+#define XBASIC_TYPES_H
+typedef unsigned char u8;
+typedef unsigned short u16;
+typedef unsigned int u32;
+
+#define QSPI_LINEAR_WINDOW
+
+#include "xqspips.c"
+#include "xqspips_options.c"
+#include "xqspips_sinit.c"
+#include "xqspips_g.c"
+#include "qspi.h"
+#include "image_mover.h"
+
+/*
+ * Connection mode of the run
+ */
+#undef XPAR_PS7_QSPI_0_QSPI_MODE
+#define XPAR_PS7_QSPI_0_QSPI_MODE	QspiMode
+static u32 QspiMode;
+
+/*
+ * Copies out of the linear window are served by the flash model
+ */
+static void *LinearCopy(void *Dst, const void *Src, size_t Len);
+#define memcpy		LinearCopy
+
+#include "qspi.c"
+
+#undef memcpy
+
+#define MODEL_BASEADDR		XPAR_XQSPIPS_0_BASEADDR
+#define WINDOW_SIZE		(2 * FLASH_SIZE_16MB)
+#define MAP_BASE		0x10000000
+#define MAP_SIZE		0x08000000
+#define MAX_FLASH		FLASH_SIZE_512M
+#define BENCH_OFFSET		FLASH_SIZE_16MB
+#define BENCH_SIZE		0x400000
+#define SMALL_SIZE		64
+#define SMALL_READS		64
+
+#define DEFAULT_REG_NS		60.0
+#define DEFAULT_SCLK_MHZ	100.0
+#define DEFAULT_BURST		32
+
+u32 FlashReadBaseAddress;
+u8 LinearBootDeviceFlag;
+
+static double RegNs = DEFAULT_REG_NS;
+static double SclkMHz = DEFAULT_SCLK_MHZ;
+static u32 Burst = DEFAULT_BURST;
+
+/*
+ * Flash model
+ */
+typedef struct {
+	u8 *Data;
+	u32 Size;
+	u8 Make;
+	u8 Bank;
+	u8 WriteEnable;
+	u32 BankWrites;
+} Flash;
+
+static Flash Dev[2];
+static u8 *Image;
+static u32 ImageSize;
+
+/*
+ * Controller state
+ */
+static u32 Regs[0x100 / 4];
+static u32 RxFifo[XQSPIPS_FIFO_DEPTH];
+static int RxHead, RxCount;
+static u32 BytePos;		/* bytes since slave select */
+static u8 Command;
+static u32 ReadAddress;
+static double Now;
+static double TransferStart;
+static double TransferClocks;
+
+static int Errors;
+
+static void Check(int Condition, const char *What)
+{
+	if (!Condition) {
+		printf("  FAIL: %s\n", What);
+		Errors++;
+	}
+}
+
+static u8 SizeId(u32 Size)
+{
+	if (Size == FLASH_SIZE_128M)
+		return FLASH_SIZE_ID_128M;
+	if (Size == FLASH_SIZE_256M)
+		return FLASH_SIZE_ID_256M;
+	return FLASH_SIZE_ID_512M;
+}
+
+static int HasBankRegister(u8 Make)
+{
+	return (Make == MICRON_ID) || (Make == SPANSION_ID);
+}
+
+/*
+ * One byte of an I/O mode transfer to a flash, returns the byte it drives
+ */
+static u8 FlashByte(Flash *FlashPtr, u8 Out)
+{
+	u8 In = 0xFF;
+
+	switch (Command) {
+	case READ_ID_CMD:
+		if (BytePos == 1)
+			In = FlashPtr->Make;
+		else if (BytePos == 2)
+			In = 0x20;
+		else if (BytePos == 3)
+			In = SizeId(FlashPtr->Size);
+		break;
+	case WRITE_ENABLE_CMD:
+		FlashPtr->WriteEnable = 1;
+		break;
+	case BANK_REG_WR:
+	case EXTADD_REG_WR:
+		if ((BytePos == 1) && (((Command == BANK_REG_WR) &&
+				(FlashPtr->Make == SPANSION_ID)) ||
+				((Command == EXTADD_REG_WR) &&
+				(FlashPtr->Make == MICRON_ID) &&
+				FlashPtr->WriteEnable))) {
+			FlashPtr->Bank = Out;
+			FlashPtr->BankWrites++;
+			FlashPtr->WriteEnable = 0;
+		}
+		break;
+	case BANK_REG_RD:
+	case EXTADD_REG_RD:
+		if ((BytePos >= 1) && (((Command == BANK_REG_RD) &&
+				(FlashPtr->Make == SPANSION_ID)) ||
+				((Command == EXTADD_REG_RD) &&
+				(FlashPtr->Make == MICRON_ID))))
+			In = FlashPtr->Bank;
+		break;
+	case QUAD_READ_CMD:
+		if (BytePos >= 5)
+			In = FlashPtr->Data[(((u32)FlashPtr->Bank << 24) +
+					ReadAddress + BytePos - 5) % FlashPtr->Size];
+		break;
+	default:
+		break;
+	}
+	return In;
+}
+
+/*
+ * One byte on the bus to the flashes the LQSPI configuration selects
+ */
+static u8 ShiftByte(u8 Out)
+{
+	u32 Lqspi = Regs[XQSPIPS_LQSPI_CR_OFFSET / 4];
+	u8 In;
+
+	if (BytePos == 0) {
+		Command = Out;
+		ReadAddress = 0;
+	} else if ((Command == QUAD_READ_CMD) && (BytePos <= 3)) {
+		ReadAddress = (ReadAddress << 8) | Out;
+	}
+
+	if ((Lqspi & XQSPIPS_LQSPI_CR_TWO_MEM_MASK) &&
+			(Lqspi & XQSPIPS_LQSPI_CR_SEP_BUS_MASK)) {
+		In = FlashByte(&Dev[0], Out);
+		if (FlashByte(&Dev[1], Out) != In)
+			In ^= 0x5A;	/* the flashes disagree */
+	} else if ((Lqspi & XQSPIPS_LQSPI_CR_TWO_MEM_MASK) &&
+			(Lqspi & XQSPIPS_LQSPI_CR_U_PAGE_MASK)) {
+		In = FlashByte(&Dev[1], Out);
+	} else {
+		In = FlashByte(&Dev[0], Out);
+	}
+
+	if ((Command == QUAD_READ_CMD) && (BytePos >= 4))
+		TransferClocks += 2;
+	else
+		TransferClocks += 8;
+	BytePos++;
+	return In;
+}
+
+/*
+ * A TXD write shifts its bytes at once, the bytes of a partial word come
+ * back in the upper bytes of the RX word
+ */
+static void ShiftWord(u32 Word, int Bytes)
+{
+	u32 Data = 0;
+	int Index;
+
+	if (!(Regs[XQSPIPS_ER_OFFSET / 4] & XQSPIPS_ER_ENABLE_MASK) ||
+			(Regs[XQSPIPS_CR_OFFSET / 4] & XQSPIPS_CR_SSCTRL_MASK) ||
+			(Regs[XQSPIPS_LQSPI_CR_OFFSET / 4] &
+			XQSPIPS_LQSPI_CR_LINEAR_MASK)) {
+		Check(0, "TX write without an I/O mode transfer");
+		return;
+	}
+
+	for (Index = 0; Index < Bytes; Index++)
+		Data |= (u32)ShiftByte((u8)(Word >> (8 * Index))) <<
+				(8 * (4 - Bytes + Index));
+
+	if (RxCount == XQSPIPS_FIFO_DEPTH) {
+		Check(0, "RX FIFO overflow");
+		return;
+	}
+	RxFifo[(RxHead + RxCount++) % XQSPIPS_FIFO_DEPTH] = Data;
+}
+
+u32 Xil_In32(u32 Addr)
+{
+	u32 Offset = Addr - MODEL_BASEADDR;
+	u32 Status = XQSPIPS_IXR_TXOW_MASK;
+	u32 Data;
+
+	Now += RegNs;
+
+	if (Offset == XQSPIPS_SR_OFFSET) {
+		if (RxCount >= (int)Regs[XQSPIPS_RXWR_OFFSET / 4])
+			Status |= XQSPIPS_IXR_RXNEMPTY_MASK;
+		if (RxCount == XQSPIPS_FIFO_DEPTH)
+			Status |= XQSPIPS_IXR_RXFULL_MASK;
+		return Status;
+	}
+	if (Offset == XQSPIPS_RXD_OFFSET) {
+		if (RxCount == 0) {
+			Check(0, "RX FIFO underrun");
+			return 0;
+		}
+		Data = RxFifo[RxHead];
+		RxHead = (RxHead + 1) % XQSPIPS_FIFO_DEPTH;
+		RxCount--;
+		return Data;
+	}
+	return Regs[(Offset / 4) % (sizeof(Regs) / sizeof(Regs[0]))];
+}
+
+void Xil_Out32(u32 Addr, u32 Value)
+{
+	u32 Offset = Addr - MODEL_BASEADDR;
+	u32 Old;
+
+	Now += RegNs;
+
+	switch (Offset) {
+	case XQSPIPS_TXD_00_OFFSET:
+		ShiftWord(Value, 4);
+		break;
+	case XQSPIPS_TXD_01_OFFSET:
+		ShiftWord(Value, 1);
+		break;
+	case XQSPIPS_TXD_10_OFFSET:
+		ShiftWord(Value, 2);
+		break;
+	case XQSPIPS_TXD_11_OFFSET:
+		ShiftWord(Value, 3);
+		break;
+	case XQSPIPS_CR_OFFSET:
+		Old = Regs[XQSPIPS_CR_OFFSET / 4];
+		Regs[XQSPIPS_CR_OFFSET / 4] = Value;
+		if ((Old & XQSPIPS_CR_SSCTRL_MASK) &&
+				!(Value & XQSPIPS_CR_SSCTRL_MASK)) {
+			/* Slave select active, a new instruction */
+			BytePos = 0;
+			TransferStart = Now;
+			TransferClocks = 0;
+		} else if (!(Old & XQSPIPS_CR_SSCTRL_MASK) &&
+				(Value & XQSPIPS_CR_SSCTRL_MASK)) {
+			/* Transfer done, not before its last SCLK */
+			if (TransferStart + TransferClocks * 1000.0 / SclkMHz >
+					Now)
+				Now = TransferStart + TransferClocks * 1000.0 /
+						SclkMHz;
+			Dev[0].WriteEnable &= (Command == WRITE_ENABLE_CMD);
+			Dev[1].WriteEnable &= (Command == WRITE_ENABLE_CMD);
+		}
+		break;
+	case XQSPIPS_SR_OFFSET:
+		break;
+	default:
+		Regs[(Offset / 4) % (sizeof(Regs) / sizeof(Regs[0]))] = Value;
+		break;
+	}
+}
+
+void Xil_Assert(const char *File, int Line)
+{
+	fprintf(stderr, "assert %s:%d\n", File, Line);
+	exit(2);
+}
+
+void XNullHandler(void *NullParameter)
+{
+	(void)NullParameter;
+}
+
+unsigned int Xil_AssertStatus;
+
+/*
+ * Byte of the linear window, from the bank each flash has selected
+ */
+static u8 WindowByte(u32 Offset)
+{
+	u32 Lqspi = Regs[XQSPIPS_LQSPI_CR_OFFSET / 4];
+	Flash *FlashPtr = &Dev[0];
+	u32 Address = Offset;
+
+	if (Offset >= WINDOW_SIZE)
+		return 0xEE;
+
+	if ((Lqspi & XQSPIPS_LQSPI_CR_TWO_MEM_MASK) &&
+			(Lqspi & XQSPIPS_LQSPI_CR_SEP_BUS_MASK)) {
+		FlashPtr = &Dev[Offset & 1];
+		Address = Offset >> 1;
+	} else if (Lqspi & XQSPIPS_LQSPI_CR_TWO_MEM_MASK) {
+		FlashPtr = &Dev[Offset >> 24];
+		Address = Offset & (FLASH_SIZE_16MB - 1);
+	} else if (Offset >= FLASH_SIZE_16MB) {
+		return 0xEE;
+	}
+
+	return FlashPtr->Data[(((u32)FlashPtr->Bank << 24) + Address) %
+			FlashPtr->Size];
+}
+
+static void *LinearCopy(void *Dst, const void *Src, size_t Len)
+{
+	u32 Offset = (u32)(unsigned long)Src - XPS_QSPI_LINEAR_BASEADDR;
+	u32 Lqspi = Regs[XQSPIPS_LQSPI_CR_OFFSET / 4];
+	u32 Clocks;
+	u32 Index;
+
+	if (((unsigned long)Src < XPS_QSPI_LINEAR_BASEADDR) ||
+			((unsigned long)Src >= XPS_QSPI_LINEAR_BASEADDR +
+			WINDOW_SIZE))
+		return memcpy(Dst, Src, Len);
+
+	Check((Regs[XQSPIPS_ER_OFFSET / 4] & XQSPIPS_ER_ENABLE_MASK) &&
+			(Lqspi & XQSPIPS_LQSPI_CR_LINEAR_MASK),
+			"linear window read outside of linear mode");
+
+	for (Index = 0; Index < Len; Index++)
+		((u8 *)Dst)[Index] = WindowByte(Offset + Index);
+
+	/*
+	 * Instruction and address on one line, dummy byte and data on four,
+	 * on both flashes in parallel
+	 */
+	Clocks = 8 + 24 + 2 + 2 * Burst;
+	if ((Lqspi & XQSPIPS_LQSPI_CR_TWO_MEM_MASK) &&
+			(Lqspi & XQSPIPS_LQSPI_CR_SEP_BUS_MASK))
+		Clocks = 8 + 24 + 2 + Burst;
+	Now += ((Len + Burst - 1) / Burst) * (RegNs + Clocks * 1000.0 /
+			SclkMHz);
+
+	return Dst;
+}
+
+static const char *ModeName(u32 Mode)
+{
+	if (Mode == DUAL_STACK_CONNECTION)
+		return "stack";
+	if (Mode == DUAL_PARALLEL_CONNECTION)
+		return "parallel";
+	return "single";
+}
+
+static const char *MakeName(u8 Make)
+{
+	if (Make == MICRON_ID)
+		return "Micron";
+	if (Make == SPANSION_ID)
+		return "Spansion";
+	return "Winbond";
+}
+
+/*
+ * Fresh controller, flashes at bank 0 holding the image
+ */
+static void Setup(u32 Mode, u8 Make, u32 Size)
+{
+	u32 Index;
+
+	QspiMode = Mode;
+	ImageSize = (Mode == SINGLE_FLASH_CONNECTION) ? Size : 2 * Size;
+
+	memset(Dev, 0, sizeof(Dev));
+	for (Index = 0; Index < 2; Index++) {
+		Dev[Index].Make = Make;
+		Dev[Index].Size = Size;
+	}
+	if (Mode == DUAL_PARALLEL_CONNECTION) {
+		Dev[0].Data = malloc(Size);
+		Dev[1].Data = malloc(Size);
+		if ((Dev[0].Data == NULL) || (Dev[1].Data == NULL)) {
+			fprintf(stderr, "no memory\n");
+			exit(1);
+		}
+		for (Index = 0; Index < ImageSize; Index++)
+			Dev[Index & 1].Data[Index >> 1] = Image[Index];
+	} else {
+		Dev[0].Data = Image;
+		Dev[1].Data = Image + Size;
+	}
+
+	memset(Regs, 0, sizeof(Regs));
+	Regs[XQSPIPS_CR_OFFSET / 4] = XQSPIPS_CR_RESET_STATE;
+	RxHead = 0;
+	RxCount = 0;
+	memset(&QspiInstance, 0, sizeof(QspiInstance));
+	QspiLinearWindowFlag = 0;
+	LinearBootDeviceFlag = 0;
+	QspiFlashSize = 0;
+	QspiFlashMake = 0;
+}
+
+static void Teardown(void)
+{
+	if (QspiMode == DUAL_PARALLEL_CONNECTION) {
+		free(Dev[0].Data);
+		free(Dev[1].Data);
+	}
+}
+
+/*
+ * One QspiAccess() into DDR, compared with the image
+ */
+static int Read(u32 Offset, u32 Length)
+{
+	u8 *Dst = (u8 *)MAP_BASE;
+
+	if ((Offset >= ImageSize) || (Length > MAP_SIZE - 4))
+		return 1;
+	if (Length > ImageSize - Offset)
+		Length = ImageSize - Offset;
+
+	memset(Dst, 0, Length);
+	if (QspiAccess(Offset, MAP_BASE, Length) != XST_SUCCESS)
+		return -1;
+	return memcmp(Dst, Image + Offset, Length) != 0;
+}
+
+static void ReadTest(int ExpectFail)
+{
+	u32 Boundary;
+	int Result = 0;
+	int Failed = 0;
+	int Status;
+
+	Status = Read(0, 0x10000);
+	Failed |= (Status < 0);
+	Result |= (Status > 0);
+	for (Boundary = FLASH_SIZE_16MB; Boundary < ImageSize;
+			Boundary += FLASH_SIZE_16MB) {
+		Status = Read(Boundary - 0x1001, 0x3003);
+		Failed |= (Status < 0);
+		Result |= (Status > 0);
+		Status = Read(Boundary + 0x123, 0x1001);
+		Failed |= (Status < 0);
+		Result |= (Status > 0);
+	}
+	Status = Read(ImageSize - 0x2001, 0x2001);
+	Failed |= (Status < 0);
+	Result |= (Status > 0);
+	Status = Read(0x10003, 0x801);
+	Failed |= (Status < 0);
+	Result |= (Status > 0);
+
+	if (ExpectFail) {
+		Check(Failed, "read succeeded without a bank register");
+	} else {
+		Check(!Failed, "read failed");
+		Check(!Result, "read returned wrong data");
+	}
+}
+
+/*
+ * Model rate of a 4MB read above 16MB and time of a 64 byte read there,
+ * like the header reads of the FSBL
+ */
+static double Bench(double *SmallUs)
+{
+	double Start = Now;
+	double Rate;
+	u32 Index;
+
+	Check(Read(BENCH_OFFSET, BENCH_SIZE) == 0, "benchmark read");
+	Rate = BENCH_SIZE * 1000.0 / (Now - Start);
+
+	Start = Now;
+	for (Index = 0; Index < SMALL_READS; Index++)
+		Check(Read(BENCH_OFFSET + Index * 0x1040, SMALL_SIZE) == 0,
+				"small read");
+	*SmallUs = (Now - Start) / 1000.0 / SMALL_READS;
+
+	return Rate;
+}
+
+/*
+ * Back to the I/O mode the FSBL uses without the window
+ */
+static void IoMode(void)
+{
+	QspiLinearWindowFlag = 0;
+	XQspiPs_Disable(QspiInstancePtr);
+	XQspiPs_SetOptions(QspiInstancePtr, XQSPIPS_FORCE_SSELECT_OPTION |
+			XQSPIPS_HOLD_B_DRIVE_OPTION);
+	XQspiPs_SetLqspiConfigReg(QspiInstancePtr,
+			(QspiMode == DUAL_STACK_CONNECTION) ?
+			DUAL_STACK_CONFIG_READ : 0);
+	XQspiPs_SetSlaveSelect(QspiInstancePtr);
+}
+
+static void Run(u32 Mode, u8 Make, u32 Size)
+{
+	int Window = HasBankRegister(Make) && (Size > FLASH_SIZE_16MB);
+	int Flat = (Size <= FLASH_SIZE_16MB) &&
+			(Mode != DUAL_STACK_CONNECTION);
+	int IoFails = !HasBankRegister(Make) && !Flat;
+	double Linear, LinearUs;
+	double Io, IoUs;
+
+	Setup(Mode, Make, Size);
+	printf("%-8s %-8s %3uMB: ", ModeName(Mode), MakeName(Make),
+			Size >> 20);
+
+	Check(InitQspi() == XST_SUCCESS, "InitQspi");
+	printf("%s\n", Window ? "window" : Flat ? "linear" : "I/O mode");
+	Check(QspiLinearWindowFlag == Window, "window mode");
+	Check(LinearBootDeviceFlag == Flat, "flat linear mode");
+
+	ReadTest(IoFails);
+
+	if (Window) {
+		Linear = Bench(&LinearUs);
+		ReleaseQspi();
+		Check((Dev[0].Bank == 0) && (Dev[1].Bank == 0),
+				"bank not 0 after ReleaseQspi");
+		printf("  window: %u + %u bank writes, 4MB %.1f MB/s, "
+				"64 bytes %.1f us\n", Dev[0].BankWrites,
+				Dev[1].BankWrites, Linear, LinearUs);
+
+		if (Mode != DUAL_PARALLEL_CONNECTION) {
+			IoMode();
+			Io = Bench(&IoUs);
+			Check((Dev[0].Bank == 0) && (Dev[1].Bank == 0),
+					"bank not 0 after I/O mode read");
+			printf("  I/O mode: 4MB %.1f MB/s, 64 bytes %.1f us\n",
+					Io, IoUs);
+		}
+	} else if (!IoFails) {
+		Check((Dev[0].Bank == 0) && (Dev[1].Bank == 0),
+				"bank not 0 without the window");
+	}
+
+	Teardown();
+}
+
+int main(int argc, char **argv)
+{
+	static const u8 Makes[] = { MICRON_ID, SPANSION_ID, WINBOND_ID };
+	static const u32 Sizes[] = { FLASH_SIZE_128M, FLASH_SIZE_256M,
+			FLASH_SIZE_512M };
+	u32 Mode, Make, Size;
+	u32 Index;
+	void *Map;
+	int Arg;
+
+	for (Arg = 1; (Arg + 1 < argc) && (argv[Arg][0] == '-'); Arg += 2) {
+		if (!strcmp(argv[Arg], "-r")) {
+			RegNs = strtod(argv[Arg + 1], NULL);
+		} else if (!strcmp(argv[Arg], "-s")) {
+			SclkMHz = strtod(argv[Arg + 1], NULL);
+		} else if (!strcmp(argv[Arg], "-b")) {
+			Burst = strtoul(argv[Arg + 1], NULL, 0);
+		} else {
+			break;
+		}
+	}
+	if ((Arg != argc) || (RegNs < 0) || (SclkMHz <= 0) || (Burst == 0)) {
+		fprintf(stderr, "usage: %s [-r <ns>] [-s <MHz>] [-b <burst "
+				"bytes>]\n", argv[0]);
+		return 1;
+	}
+
+	Map = mmap((void *)MAP_BASE, MAP_SIZE, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	Image = malloc(2 * MAX_FLASH);
+	if ((Map != (void *)MAP_BASE) || (Image == NULL)) {
+		fprintf(stderr, "%s: cannot map DDR at 0x%08x\n", argv[0],
+				MAP_BASE);
+		return 1;
+	}
+	srand(1);
+	for (Index = 0; Index < 2 * MAX_FLASH; Index++)
+		Image[Index] = rand();
+
+	printf("register access %.0f ns, SCLK %.0f MHz, %u byte bursts\n",
+			RegNs, SclkMHz, Burst);
+	for (Mode = 0; Mode < 3; Mode++)
+		for (Make = 0; Make < sizeof(Makes); Make++)
+			for (Size = 0; Size < 3; Size++)
+				Run(Mode, Makes[Make], Sizes[Size]);
+
+	printf("%d errors\n", Errors);
+	return Errors ? 1 : 0;
+}
@@ -0,0 +1,725 @@
+/******************************************************************************
+*
+* sdhcisim.c
+*
+* Host side test of the bus negotiation of FSBL/src/mmc.c. The source is
+* built into the tool, its register accesses go to a model of the SD host
+* controller and of a SD card (an eMMC device with -DMMC_SUPPORT) behind it.
+*
+* The card model follows the states of the card from idle to transfer, the
+* bus width, timing and DDR mode it is switched to with ACMD6/CMD6, and
+* answers the SCR, switch function status and EXT_CSD reads. A data transfer
+* is clean when the controller and the card agree on the bus mode, the card
+* is not clocked above its timing, the width fits the data lines wired to it
+* and the clock stays below the limit of the board. Otherwise it ends with a
+* data CRC error, or with silently flipped bits in half of the cases.
+*
+* Every combination of controller capabilities (high speed, 8-bit, DDR50),
+* card capabilities, wired data lines, board clock limits and a card that
+* refuses the high speed switch is initialized with disk_initialize(). The
+* test checks that
+*   - the bus mode reached is the fastest clean mode both sides support,
+*   - the controller and the card are in the same mode,
+*   - disk_read() of 1, 8 and 128 blocks returns the card contents,
+*   - the initialization fails when not even the 1-bit default speed mode
+*     reads clean.
+* Reported are the modes reached, the switch attempts and the commands of
+* an initialization.
+*
+* Build: gcc -O2 -no-pie -Wno-pointer-to-int-cast [-DMMC_SUPPORT]
+*		 [-DSD_BUS_WIDTH_MAX=8] -o sdhcisim sdhcisim.c
+*		 -I../../FSBL/src -I../../FSBL_bsp/ps7_cortexa9_0/include
+*
+* The driver keeps buffer addresses in 32-bit registers, -no-pie keeps the
+* static buffers of the tool below 4GB.
+*
+* Usage: sdhcisim [-v]
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/*
+ * 32-bit register and pointer arithmetic types of the target, xil_types.h
+ * leaves them out when XBASIC_TYPES_H is defined
+ */
+#define XBASIC_TYPES_H
+typedef unsigned char u8;
+typedef unsigned short u16;
+typedef unsigned int u32;
+
+#include "mmc.c"
+
+#define MODEL_BASEADDR		XPAR_PS7_SD_0_S_AXI_BASEADDR
+#define CARD_BLOCKS		1024
+#define MHZ			1000000
+
+#ifdef MMC_SUPPORT
+#define CARD_DS_MAX		MMC_CLK_26M
+#define CARD_HS_MAX		MMC_CLK_52M
+#else
+#define CARD_DS_MAX		SD_CLK_25M
+#define CARD_HS_MAX		SD_CLK_50M
+#endif
+
+#define SD_RCA			0xB368
+#define STATUS_SWITCH_ERROR	(0x1 << 7)
+#define STATUS_READY		(0x1 << 8)
+
+enum {
+	STATE_IDLE, STATE_READY, STATE_IDENT, STATE_STBY, STATE_TRAN
+};
+
+/*
+ * Configuration of a case
+ */
+static int HostHs;		/* controller high speed capability */
+static int Host8Bit;		/* controller 8-bit capability */
+static int HostDdr;		/* controller 3.00 with DDR50 */
+static int CardWide;		/* SD: 4-bit in the SCR */
+static int CardHs;		/* high speed, HS52 of a MMC */
+static int CardDdr;		/* MMC DDR52 */
+static int CardRefuse;		/* card fails the high speed switch */
+static int Wired;		/* data lines on the board */
+static u32 SdrLimit;		/* board limit in Hz */
+static u32 DdrLimit;
+static int Silent;		/* bit flips instead of CRC errors */
+
+/*
+ * Controller state
+ */
+static u8 Regs[0x100];
+static u32 PendingStat;		/* data phase result after CMD_CMPL */
+
+/*
+ * Card state
+ */
+static u8 CardData[CARD_BLOCKS * SD_BLOCK_SZ];
+static int State;
+static int AppCmd;
+static int Width;
+static int Timing;		/* BUS_TIMING_* */
+static int SwitchError;
+static u32 Rca;
+
+static unsigned long Commands;
+static unsigned long Switches;
+static int Verbose;
+
+static u32 Reg32(u32 Offset)
+{
+	return Regs[Offset] | (Regs[Offset + 1] << 8) | (Regs[Offset + 2] << 16) |
+			((u32)Regs[Offset + 3] << 24);
+}
+
+static u16 Reg16(u32 Offset)
+{
+	return Regs[Offset] | (Regs[Offset + 1] << 8);
+}
+
+static void SetReg32(u32 Offset, u32 Value)
+{
+	Regs[Offset] = Value;
+	Regs[Offset + 1] = Value >> 8;
+	Regs[Offset + 2] = Value >> 16;
+	Regs[Offset + 3] = Value >> 24;
+}
+
+static void SetReg16(u32 Offset, u16 Value)
+{
+	Regs[Offset] = Value;
+	Regs[Offset + 1] = Value >> 8;
+}
+
+static void Interrupt(u32 Status)
+{
+	Status |= Reg32(SD_INT_STAT_R);
+	if (Status & 0xFFFF0000)
+		Status |= SD_INT_ERROR;
+	SetReg32(SD_INT_STAT_R, Status);
+}
+
+static u32 SdClock(void)
+{
+	u16 Clk = Reg16(SD_CLK_CTL_R);
+	u32 Div = Clk >> SD_DIV_SHIFT;
+
+	if (!(Clk & SD_CLK_SD_EN))
+		return 0;
+	return Div ? SDIO_FREQ / (2 * Div) : SDIO_FREQ;
+}
+
+static int HostWidth(void)
+{
+	u8 Ctrl = Regs[SD_HOST_CTRL_R];
+
+	if (Ctrl & SD_HOST_8BIT)
+		return 8;
+	return (Ctrl & SD_HOST_4BIT) ? 4 : 1;
+}
+
+static int HostDdrMode(void)
+{
+	return HostDdr &&
+		((Reg16(SD_HOST_CTRL2_R) & SD_CTRL2_UHS_MASK) == SD_CTRL2_DDR50);
+}
+
+/*
+ * A data transfer from the card reads clean
+ */
+static int Clean(void)
+{
+	u32 Clock = SdClock();
+	int Ddr = (Timing == BUS_TIMING_DDR);
+
+	if ((HostWidth() != Width) || (HostDdrMode() != Ddr) || (Width > Wired))
+		return 0;
+	if (Clock > ((Timing == BUS_TIMING_DS) ? CARD_DS_MAX : CARD_HS_MAX))
+		return 0;
+	if ((Clock > CARD_DS_MAX) && !(Regs[SD_HOST_CTRL_R] & SD_HOST_HS))
+		return 0;
+	return Clock <= (Ddr ? DdrLimit : SdrLimit);
+}
+
+/*
+ * Card data of a command, delivered when the driver takes CMD_CMPL
+ */
+static void DataPhase(const u8 *Data, u32 Length)
+{
+	u32 *Desc = (u32 *)(uintptr_t)Reg32(SD_ADMA_ADDR_R);
+	u32 Size = (Reg16(SD_BLOCK_SZ_R) & 0xFFF) * Reg16(SD_BLOCK_CNT_R);
+	u32 DescLength = Desc[0] >> DESC_ATBR_LEN_SHIFT;
+	u8 *Buf = (u8 *)(uintptr_t)Desc[1];
+
+	if (DescLength == 0)
+		DescLength = 0x10000;	/* 0 is 64KB */
+	if ((Size != Length) || (DescLength != Length)) {
+		printf("  transfer of %u bytes, block registers %u, descriptor "
+				"%u\n", Length, Size, DescLength);
+		PendingStat = SD_INT_ERR_ADMA;
+		return;
+	}
+
+	memcpy(Buf, Data, Length);
+	PendingStat = SD_INT_TRNS_CMPL;
+	if (!Clean()) {
+		if (Silent) {
+			Buf[rand() % Length] ^= 1 << (rand() % 8);
+		} else {
+			PendingStat = SD_INT_ERR_DCRC;
+		}
+	}
+}
+
+#ifdef MMC_SUPPORT
+static void ExtCsd(void)
+{
+	static u8 Data[SD_BLOCK_SZ];
+
+	memset(Data, 0, sizeof(Data));
+	Data[192] = 5;				/* EXT_CSD_REV */
+	Data[EXT_CSD_CARD_TYPE] = 0x01 | (CardHs ? EXT_CSD_CARD_TYPE_52 : 0) |
+			(CardDdr ? EXT_CSD_CARD_TYPE_DDR_52 : 0);
+	Data[EXT_CSD_HS_TIMING] = (Timing != BUS_TIMING_DS);
+	DataPhase(Data, SD_BLOCK_SZ);
+}
+
+static int MmcSwitch(u32 Arg)
+{
+	u32 Index = (Arg >> 16) & 0xFF;
+	u32 Value = (Arg >> 8) & 0xFF;
+
+	if ((Arg >> 24) != MMC_SWITCH_MODE_WRITE_BYTE)
+		return 0;
+	Switches++;
+
+	if (Index == EXT_CSD_HS_TIMING) {
+		if ((Value > 1) || (Value && (!CardHs || CardRefuse)) ||
+				(Timing == BUS_TIMING_DDR)) {
+			SwitchError = 1;
+			return 1;
+		}
+		Timing = Value ? BUS_TIMING_HS : BUS_TIMING_DS;
+	} else if (Index == EXT_CSD_BUS_WIDTH) {
+		if ((Value == 0) || (Value == 1) || (Value == 2)) {
+			Width = (Value == 0) ? 1 : (Value == 1) ? 4 : 8;
+			if (Timing == BUS_TIMING_DDR)
+				Timing = BUS_TIMING_HS;
+		} else if (((Value == 5) || (Value == 6)) && CardDdr &&
+				(Timing != BUS_TIMING_DS)) {
+			Width = (Value == 5) ? 4 : 8;
+			Timing = BUS_TIMING_DDR;
+		} else {
+			SwitchError = 1;
+		}
+	}
+	return 1;
+}
+#else
+static void Scr(void)
+{
+	u8 Data[8];
+
+	memset(Data, 0, sizeof(Data));
+	Data[0] = 0x02;				/* SD 2.0, CMD6 */
+	Data[1] = CardWide ? 0x05 : 0x01;
+	DataPhase(Data, sizeof(Data));
+}
+
+static void SwitchFunc(u32 Arg)
+{
+	u8 Data[64];
+	u32 Function = Arg & 0xF;
+
+	memset(Data, 0, sizeof(Data));
+	Data[13] = CardHs ? 0x03 : 0x01;
+	if ((Function > 1) || ((Function == 1) && (!CardHs || CardRefuse))) {
+		Data[16] = 0xF;
+	} else {
+		Data[16] = Function;
+		if (Arg & 0x80000000) {
+			Switches++;
+			Timing = Function ? BUS_TIMING_HS : BUS_TIMING_DS;
+		}
+	}
+	DataPhase(Data, sizeof(Data));
+}
+#endif
+
+static void CardReset(void)
+{
+	State = STATE_IDLE;
+	AppCmd = 0;
+	Width = 1;
+	Timing = BUS_TIMING_DS;
+	SwitchError = 0;
+	Rca = 0;
+}
+
+/*
+ * Command written to the controller, 0 for a command timeout
+ */
+static int Command(u32 Index, u32 Arg, u32 *Response)
+{
+#ifndef MMC_SUPPORT
+	int App = AppCmd;
+#endif
+	u32 Count;
+
+	Commands++;
+	AppCmd = 0;
+	*Response = 0;
+
+	switch (Index) {
+	case 0:
+		CardReset();
+		return 1;
+#ifdef MMC_SUPPORT
+	case 1:
+		State = STATE_READY;
+		*Response = 0x80000000 | 0x40000000 | 0x00FF8000;
+		return 1;
+#else
+	case 41:
+		if (!App)
+			return 0;
+		State = STATE_READY;
+		*Response = 0x80000000 | 0x40000000 | 0x00FF8000;
+		return 1;
+	case 55:
+		AppCmd = 1;
+		*Response = 0x20;
+		return 1;
+	case 42:
+		return App;
+	case 51:
+		if (!App || (State != STATE_TRAN))
+			return 0;
+		Scr();
+		return 1;
+#endif
+	case 2:
+		State = STATE_IDENT;
+		return 1;
+	case 3:
+#ifdef MMC_SUPPORT
+		Rca = Arg >> 16;
+#else
+		Rca = SD_RCA;
+		*Response = Rca << 16;
+#endif
+		State = STATE_STBY;
+		return 1;
+	case 9:
+		return 1;
+	case 7:
+		if ((Arg >> 16) != Rca)
+			return 0;
+		State = STATE_TRAN;
+		return 1;
+	case 6:
+		if (State != STATE_TRAN)
+			return 0;
+#ifdef MMC_SUPPORT
+		return MmcSwitch(Arg);
+#else
+		if (App) {
+			if ((Arg == 2) && CardWide)
+				Width = 4;
+			else if (Arg == 0)
+				Width = 1;
+			else
+				return 0;
+			Switches++;
+			return 1;
+		}
+		SwitchFunc(Arg);
+		return 1;
+#endif
+	case 8:
+#ifdef MMC_SUPPORT
+		if (State != STATE_TRAN)
+			return 0;
+		ExtCsd();
+#else
+		*Response = Arg & 0xFFF;
+#endif
+		return 1;
+	case 13:
+		if ((Arg >> 16) != Rca)
+			return 0;
+		*Response = (SwitchError ? STATUS_SWITCH_ERROR : 0) |
+				STATUS_READY | (State << 9);
+		SwitchError = 0;
+		return 1;
+	case 16:
+		return (State == STATE_TRAN) && (Timing != BUS_TIMING_DDR);
+	case 17:
+	case 18:
+		if (State != STATE_TRAN)
+			return 0;
+		Count = (Index == 17) ? 1 : Reg16(SD_BLOCK_CNT_R);
+		if (Arg + Count > CARD_BLOCKS)
+			return 0;
+		DataPhase(&CardData[Arg * SD_BLOCK_SZ], Count * SD_BLOCK_SZ);
+		return 1;
+	}
+	return 0;
+}
+
+u8 Xil_In8(u32 Addr)
+{
+	return Regs[(Addr - MODEL_BASEADDR) & 0xFF];
+}
+
+u16 Xil_In16(u32 Addr)
+{
+	u32 Offset = (Addr - MODEL_BASEADDR) & 0xFF;
+
+	if (Offset == SD_CLK_CTL_R)
+		return Reg16(Offset) | ((Reg16(Offset) & SD_CLK_INT_EN) ?
+				SD_CLK_INT_STABLE : 0);
+	return Reg16(Offset);
+}
+
+u32 Xil_In32(u32 Addr)
+{
+	u32 Offset = (Addr - MODEL_BASEADDR) & 0xFF;
+
+	if (Offset == SD_PRES_STATE_R)
+		return SD_CARD_INS;
+	return Reg32(Offset);
+}
+
+void Xil_Out8(u32 Addr, u8 Value)
+{
+	u32 Offset = (Addr - MODEL_BASEADDR) & 0xFF;
+
+	if (Offset == SD_SOFT_RST_R) {
+		if (Value & SD_RST_ALL) {
+			memset(Regs, 0, SD_CAPABILITIES_R);
+		}
+		if (Value & (SD_RST_ALL | SD_RST_CMD | SD_RST_DATA)) {
+			SetReg32(SD_INT_STAT_R, 0);
+			PendingStat = 0;
+		}
+		return;
+	}
+	Regs[Offset] = Value;
+}
+
+void Xil_Out16(u32 Addr, u16 Value)
+{
+	u32 Offset = (Addr - MODEL_BASEADDR) & 0xFF;
+	u32 Response;
+
+	SetReg16(Offset, Value);
+	if (Offset != SD_CMD_R)
+		return;
+
+	PendingStat = 0;
+	if (!Command((Value >> 8) & 0x3F, Reg32(SD_ARG_R), &Response)) {
+		Interrupt(SD_INT_ERR_CTIMEOUT);
+		return;
+	}
+	SetReg32(SD_RSP_R, Response);
+	Interrupt(SD_INT_CMD_CMPL);
+}
+
+void Xil_Out32(u32 Addr, u32 Value)
+{
+	u32 Offset = (Addr - MODEL_BASEADDR) & 0xFF;
+	u32 Status;
+
+	if (Offset == SD_INT_STAT_R) {
+		Status = Reg32(Offset) & ~Value;
+		if (!(Status & 0xFFFF0000))
+			Status &= ~SD_INT_ERROR;
+		SetReg32(Offset, Status);
+
+		/*
+		 * Data phase follows the command
+		 */
+		if ((Value & SD_INT_CMD_CMPL) && PendingStat) {
+			Interrupt(PendingStat);
+			PendingStat = 0;
+		}
+		return;
+	}
+	SetReg32(Offset, Value);
+}
+
+int usleep(unsigned int useconds)
+{
+	(void)useconds;
+	return 0;
+}
+
+/*
+ * Throughput of a bus mode in MB/s times 8, 0 if it does not read clean
+ * or a side does not support it
+ */
+static u32 ModeRate(int ModeWidth, int ModeTiming)
+{
+	u32 Clock;
+	int Ddr = (ModeTiming == BUS_TIMING_DDR);
+
+	if ((ModeWidth == 8) && (!Host8Bit || (SD_BUS_WIDTH_MAX < 8)))
+		return 0;
+	if ((ModeWidth > Wired) || (Ddr && (ModeWidth == 1)))
+		return 0;
+	if ((ModeTiming != BUS_TIMING_DS) && (!HostHs || !CardHs || CardRefuse))
+		return 0;
+	if (Ddr && (!HostDdr || !CardDdr))
+		return 0;
+#ifndef MMC_SUPPORT
+	if ((ModeWidth == 8) || Ddr || ((ModeWidth == 4) && !CardWide))
+		return 0;
+#endif
+
+	/* Fastest power of two division of the base clock */
+	Clock = SDIO_FREQ;
+	while (Clock > ((ModeTiming == BUS_TIMING_DS) ? CARD_DS_MAX : CARD_HS_MAX))
+		Clock /= 2;
+	if (Clock > (Ddr ? DdrLimit : SdrLimit))
+		return 0;
+
+	return ModeWidth * (Clock / MHZ) * (Ddr ? 2 : 1);
+}
+
+static u32 BestRate(void)
+{
+	static const int Widths[] = {1, 4, 8};
+	u32 Best = 0;
+	u32 Rate;
+	int W;
+	int T;
+
+	/* Every mode is checked against the block read in 1-bit mode */
+	if (!ModeRate(1, BUS_TIMING_DS))
+		return 0;
+
+	for (W = 0; W < 3; W++) {
+		for (T = BUS_TIMING_DS; T <= BUS_TIMING_DDR; T++) {
+			Rate = ModeRate(Widths[W], T);
+			if (Rate > Best)
+				Best = Rate;
+		}
+	}
+	return Best;
+}
+
+static const char *ModeName(int ModeWidth, int ModeTiming, u32 Clock)
+{
+	static char Buf[32];
+
+	sprintf(Buf, "%d bit %s %2u MHz", ModeWidth,
+			(ModeTiming == BUS_TIMING_DDR) ? "DDR" :
+			(ModeTiming == BUS_TIMING_HS) ? "HS " : "DS ", Clock / MHZ);
+	return Buf;
+}
+
+/*
+ * One initialization and a few reads
+ */
+static int RunCase(unsigned long *ModeCount)
+{
+	static u32 Buf[128 * SD_BLOCK_SZ / 4];
+	static const u32 Counts[] = {1, 8, 128};
+	u32 Want = BestRate();
+	u32 Rate;
+	u32 Clock;
+	DSTATUS Status;
+	unsigned Index;
+	int Errors = 0;
+
+	memset(Regs, 0, sizeof(Regs));
+	SetReg32(SD_CAPABILITIES_R, (HostHs ? SD_CAP_HS : 0) |
+			(Host8Bit ? SD_CAP_8BIT : 0));
+	SetReg32(SD_CAPABILITIES2_R, HostDdr ? SD_CAP2_DDR50 : 0);
+	SetReg16(SD_HOST_VER_R, HostDdr ? SD_SPEC_VER_300 : 1);
+	CardReset();
+	Stat = STA_NOINIT;
+	CardType = 0;
+
+	Status = disk_initialize(0);
+	if (Want == 0) {
+		if (!(Status & STA_NOINIT)) {
+			printf("  no clean mode, initialization did not fail\n");
+			Errors++;
+		}
+		return Errors;
+	}
+	if (Status & STA_NOINIT) {
+		printf("  initialization failed (0x%x)\n", Status);
+		return 1;
+	}
+
+	Clock = SdClock();
+	Rate = Width * (Clock / MHZ) * ((Timing == BUS_TIMING_DDR) ? 2 : 1);
+	if ((HostWidth() != Width) || (HostDdrMode() != (Timing ==
+			BUS_TIMING_DDR)) || !Clean()) {
+		printf("  controller %d bit%s, card %s\n", HostWidth(),
+				HostDdrMode() ? " DDR" : "", ModeName(Width, Timing,
+				Clock));
+		Errors++;
+	}
+	if (Rate != Want) {
+		printf("  reached %s (%u), fastest clean mode gives %u\n",
+				ModeName(Width, Timing, Clock), Rate, Want);
+		Errors++;
+	}
+	ModeCount[(Width == 8) * 6 + (Width == 4) * 3 + Timing]++;
+
+	for (Index = 0; Index < sizeof(Counts) / sizeof(Counts[0]); Index++) {
+		memset(Buf, 0, sizeof(Buf));
+		if ((disk_read(0, (BYTE *)Buf, 100 + Index, Counts[Index]) !=
+				RES_OK) || memcmp(Buf, &CardData[(100 + Index) *
+				SD_BLOCK_SZ], Counts[Index] * SD_BLOCK_SZ)) {
+			printf("  read of %u blocks failed\n", Counts[Index]);
+			Errors++;
+		}
+	}
+
+	return Errors;
+}
+
+int main(int argc, char **argv)
+{
+	static const u32 Limits[] = {20 * MHZ, 30 * MHZ, 60 * MHZ};
+	static const int Lines[] = {1, 4, 8};
+	static const char *Timings[] = {"DS ", "HS ", "DDR"};
+	unsigned long ModeCount[9];
+	unsigned long Inits = 0;
+	unsigned long TotalCommands = 0;
+	unsigned long TotalSwitches = 0;
+	unsigned Index;
+	unsigned Case;
+	unsigned L;
+	unsigned S;
+	unsigned D;
+	int Cases = 0;
+	int Errors = 0;
+	int CaseErrors;
+
+	if ((argc > 2) || ((argc == 2) && strcmp(argv[1], "-v"))) {
+		fprintf(stderr, "usage: %s [-v]\n", argv[0]);
+		return 1;
+	}
+	Verbose = (argc == 2);
+
+	srand(1);
+	for (Index = 0; Index < sizeof(CardData); Index++)
+		CardData[Index] = rand();
+	memset(ModeCount, 0, sizeof(ModeCount));
+
+	for (Case = 0; Case < 256; Case++) {
+		HostHs = (Case >> 0) & 1;
+		Host8Bit = (Case >> 1) & 1;
+		HostDdr = (Case >> 2) & 1;
+		CardWide = (Case >> 3) & 1;
+		CardHs = (Case >> 4) & 1;
+		CardDdr = CardHs && ((Case >> 5) & 1);
+		CardRefuse = (Case >> 6) & 1;
+		Silent = (Case >> 7) & 1;
+#ifdef MMC_SUPPORT
+		if (CardWide)
+			continue;	/* MMC devices are wide */
+#else
+		if ((Case >> 5) & 1)
+			continue;	/* no DDR on SD cards */
+#endif
+		for (L = 0; L < 3; L++) {
+			for (S = 0; S < 3; S++) {
+				for (D = 0; D < 3; D++) {
+					Wired = Lines[L];
+					SdrLimit = Limits[S];
+					DdrLimit = Limits[D];
+					if (DdrLimit > SdrLimit)
+						continue;	/* DDR has less margin */
+					if (Silent && !ModeRate(1, BUS_TIMING_DS))
+						continue;	/* reference block corrupt */
+					Cases++;
+					Commands = 0;
+					Switches = 0;
+					CaseErrors = RunCase(ModeCount);
+					if (CaseErrors || Verbose)
+						printf("host hs %d 8bit %d ddr %d, card wide %d "
+							"hs %d ddr %d refuse %d, %d lines, limit "
+							"%u/%u MHz%s: %lu commands, %lu switches"
+							"\n", HostHs, Host8Bit, HostDdr, CardWide,
+							CardHs, CardDdr, CardRefuse, Wired,
+							SdrLimit / MHZ, DdrLimit / MHZ,
+							Silent ? ", bit flips" : "", Commands,
+							Switches);
+					Errors += CaseErrors;
+					if (ModeRate(1, BUS_TIMING_DS)) {
+						Inits++;
+						TotalCommands += Commands;
+						TotalSwitches += Switches;
+					}
+				}
+			}
+		}
+	}
+
+	printf("%d cases: %d errors\n", Cases, Errors);
+	for (Index = 0; Index < 9; Index++)
+		if (ModeCount[Index])
+			printf("  %d bit %s %6lu\n", (Index / 3 == 2) ? 8 :
+					(Index / 3 == 1) ? 4 : 1, Timings[Index % 3],
+					ModeCount[Index]);
+	printf("per initialization: %.1f commands, %.1f switches\n",
+			(double)TotalCommands / Inits, (double)TotalSwitches / Inits);
+
+	return Errors ? 1 : 0;
+}
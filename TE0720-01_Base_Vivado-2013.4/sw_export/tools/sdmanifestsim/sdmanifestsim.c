@@ -0,0 +1,655 @@
+/******************************************************************************
+*
+* sdmanifestsim.c
+*
+* Host side test of the SD boot from a manifest, FSBL/src/sdmanifest.c. The
+* manifest code, FatFs and the MD5 code are built into the tool, the card is
+* a FAT16 volume in memory and the PCAP download compares the words it gets
+* with the bitstream.
+*
+* The volume holds MANIFEST.TXT, a .bit file, a byte swapped .bin
+* bitstream, an ELF file with its segments out of file order and two raw
+* files, one for an unaligned load address. The files are loaded from
+* contiguous clusters and, with their cluster chains fragmented, taking
+* turns every -f clusters. Their runs must fit SD_MANIFEST_MAX_EXTENTS.
+* The test checks that
+*   - the bitstreams reach the PCAP in PCAP byte order, the ELF segments
+*     and raw files are in memory, the rest of each segment is cleared and
+*     the execution address is the ELF entry,
+*   - a changed byte of any file, loaded or not, fails the boot with
+*     SD_MANIFEST_FAIL, a changed bitstream before its download,
+*   - a manifest line without a digest or with an invalid one is rejected,
+*     upper case digests are accepted,
+*   - with the RSA eFuse set the manifest is not used on silicon that
+*     implements RSA, and a card without a manifest boots BOOT.BIN.
+* Reported are the sectors and read commands of the load against the
+* sectors of the files.
+*
+* Build: gcc -O2 -no-pie -Wl,-Ttext-segment=0x08000000 -fgnu89-inline
+*		 -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast
+*		 -D_FS_READAHEAD=0 -DSD_MANIFEST_BOOT -o sdmanifestsim
+*		 sdmanifestsim.c -I../../FSBL/src
+*		 -I../../FSBL_bsp/ps7_cortexa9_0/include
+*
+* sdmanifest.c keeps load addresses in 32-bit variables, -no-pie keeps the
+* static buffers of the tool below 4GB. Bitstreams are staged at the start
+* of DDR, 1MB, the tool is linked above the DDR it maps at the target
+* addresses. md5.c uses gnu89 inline functions.
+*
+* Usage: sdmanifestsim [-c <sectors per cluster>] [-f <clusters>]
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <sys/mman.h>
+
+/*
+ * 32-bit register and pointer arithmetic types of the target, xil_types.h
+ * leaves them out when XBASIC_TYPES_H is defined
+ */
+#define XBASIC_TYPES_H
+typedef unsigned char u8;
+typedef unsigned short u16;
+typedef unsigned int u32;
+
+#include "ff.c"
+#include "md5.c"
+#include "sdmanifest.c"
+
+/*
+ * FAT16 volume, one FAT, 6000 clusters
+ */
+#define VOL_CLUSTERS	6000
+#define VOL_FAT_SECTORS	((VOL_CLUSTERS + 2) * 2 / 512 + 1)
+#define VOL_ROOT_SECTORS	32
+#define VOL_ROOT		(1 + VOL_FAT_SECTORS)
+#define VOL_DATA		(VOL_ROOT + VOL_ROOT_SECTORS)
+
+#define MAX_FILES		6
+#define MAX_FILE		(512 * 1024)
+
+/*
+ * DDR of the target
+ */
+#define MAP_BASE		DDR_START_ADDR
+#define MAP_SIZE		0x05000000
+#define ELF_ENTRY		0x04000000
+#define DTB_ADDR		0x03000000
+#define RAMDISK_ADDR	0x03100003
+
+#define BIT_WORDS		(64 * 1024)
+#define FILL			0xA5
+
+typedef struct {
+	const char *Name;
+	u8 *Data;
+	u32 Size;
+	u32 Cluster[VOL_CLUSTERS];
+	u32 Clusters;
+	char Digest[33];
+} CardFile;
+
+u8 BitstreamFlag;
+u32 Silicon_Version = SILICON_VERSION_3;
+
+static u8 *Disk;
+static u32 ClusterSectors = 4;
+static u16 Fat[VOL_CLUSTERS + 2];
+static CardFile Card[MAX_FILES];
+static u32 CardFiles;
+static u32 EfuseStatus;
+
+static u8 BitFile[MAX_FILE];
+static u8 BinFile[MAX_FILE];
+static u8 ElfFile[MAX_FILE];
+static u8 DtbFile[MAX_FILE];
+static u8 RamdiskFile[MAX_FILE];
+static u8 ManifestFile[SD_MANIFEST_SECTOR_SIZE];
+static u32 BitWords[2][BIT_WORDS];
+
+static jmp_buf FallbackJmp;
+static u32 LastStatus;
+static u32 PcapCalls;
+static u32 PcapErrors;
+static unsigned long Sectors;	/* read from the card */
+static unsigned long Reads;		/* disk_read calls */
+
+static int Errors;
+
+static void Check(int Condition, const char *Text)
+{
+	if (!Condition) {
+		printf("  FAIL: %s\n", Text);
+		Errors++;
+	}
+}
+
+static void SetLe16(u8 *p, u32 Value)
+{
+	p[0] = Value;
+	p[1] = Value >> 8;
+}
+
+static void SetLe32(u8 *p, u32 Value)
+{
+	SetLe16(p, Value);
+	SetLe16(p + 2, Value >> 16);
+}
+
+static void SetBe32(u8 *p, u32 Value)
+{
+	p[0] = Value >> 24;
+	p[1] = Value >> 16;
+	p[2] = Value >> 8;
+	p[3] = Value;
+}
+
+/*
+ * Card and target interfaces
+ */
+DSTATUS disk_initialize(BYTE Drive)
+{
+	return 0;
+}
+
+DSTATUS disk_status(BYTE Drive)
+{
+	return 0;
+}
+
+DRESULT disk_read(BYTE Drive, BYTE *Buffer, DWORD Sector, BYTE Count)
+{
+	u32 Total = VOL_DATA + VOL_CLUSTERS * ClusterSectors;
+
+	if ((Count == 0) || (Sector >= Total) || (Count > Total - Sector))
+		return RES_PARERR;
+
+	memcpy(Buffer, Disk + Sector * SD_MANIFEST_SECTOR_SIZE,
+			Count * SD_MANIFEST_SECTOR_SIZE);
+	Sectors += Count;
+	Reads++;
+	return RES_OK;
+}
+
+u32 Xil_In32(u32 Addr)
+{
+	return (Addr == EFUSE_STATUS_REG) ? EfuseStatus : 0;
+}
+
+void OutputStatus(u32 State)
+{
+	LastStatus = State;
+}
+
+void FsblFallback(void)
+{
+	longjmp(FallbackJmp, 1);
+}
+
+u32 FsblHookBeforeBitstreamDload(void)
+{
+	return XST_SUCCESS;
+}
+
+u32 FsblHookAfterBitstreamDload(void)
+{
+	return XST_SUCCESS;
+}
+
+u32 PcapLoadPartition(u32 *SourceData, u32 *DestinationData, u32 SourceLength,
+		u32 DestinationLength, u32 Flags)
+{
+	if ((PcapCalls >= 2) || (SourceData != (u32 *)DDR_TEMP_START_ADDR) ||
+			(SourceLength != BIT_WORDS) ||
+			memcmp(SourceData, BitWords[PcapCalls], BIT_WORDS * 4))
+		PcapErrors++;
+	PcapCalls++;
+	return XST_SUCCESS;
+}
+
+/*
+ * Test files
+ */
+static void MakeBitWords(u32 *Word)
+{
+	static const u32 Head[] = { 0xFFFFFFFF, 0xFFFFFFFF, 0x000000BB,
+			0x11220044, 0xFFFFFFFF, 0xFFFFFFFF, 0xAA995566, 0x20000000 };
+	u32 Index;
+
+	for (Index = 0; Index < BIT_WORDS; Index++)
+		Word[Index] = (Index < 8) ? Head[Index] :
+				((u32)rand() << 16) ^ rand();
+}
+
+static u32 BitField(u8 *p, char Key, const char *Text)
+{
+	u32 Length = strlen(Text) + 1;
+
+	p[0] = Key;
+	p[1] = Length >> 8;
+	p[2] = Length;
+	memcpy(&p[3], Text, Length);
+	return 3 + Length;
+}
+
+static u32 MakeBit(u8 *File, const u32 *Word)
+{
+	static const u8 Preamble[BIT_PREAMBLE_SIZE] = { 0x00, 0x09, 0x0F, 0xF0,
+			0x0F, 0xF0, 0x0F, 0xF0, 0x0F, 0xF0, 0x00, 0x00, 0x01 };
+	u32 Size = BIT_PREAMBLE_SIZE;
+	u32 Index;
+
+	memcpy(File, Preamble, BIT_PREAMBLE_SIZE);
+	Size += BitField(&File[Size], 'a', "system_top;UserID=0XFFFFFFFF");
+	Size += BitField(&File[Size], 'b', "7z020clg484");
+	Size += BitField(&File[Size], 'c', "2026/10/16");
+	Size += BitField(&File[Size], 'd', "12:00:00");
+	File[Size] = 'e';
+	SetBe32(&File[Size + 1], BIT_WORDS * 4);
+	Size += 5;
+	for (Index = 0; Index < BIT_WORDS; Index++, Size += 4)
+		SetBe32(&File[Size], Word[Index]);
+	return Size;
+}
+
+/*
+ * ARM ELF, the second load segment is first in the file, section headers
+ * follow the segments
+ */
+static u32 ElfSeg[2][4] = {
+	/* offset, address, file size, memory size */
+	{ 0x8000, ELF_ENTRY + 0x8000, 0x6000, 0x8000 },
+	{ 0x1000, ELF_ENTRY, 0x3000, 0x3000 } };
+#define ELF_SIZE		0xE800
+
+static u32 MakeElf(u8 *File)
+{
+	u8 *Ph;
+	u32 Index;
+
+	for (Index = 0; Index < ELF_SIZE; Index++)
+		File[Index] = rand();
+	memset(File, 0, 52 + 3 * 32);
+	memcpy(File, "\177ELF\001\001\001", 7);
+	SetLe16(&File[16], 2);
+	SetLe16(&File[ELF_MACHINE_OFFSET], ELF_MACHINE_ARM);
+	SetLe32(&File[20], 1);
+	SetLe32(&File[ELF_ENTRY_OFFSET], ELF_ENTRY);
+	SetLe32(&File[ELF_PHOFF_OFFSET], 52);
+	SetLe16(&File[40], 52);
+	SetLe16(&File[ELF_PHENTSIZE_OFFSET], 32);
+	SetLe16(&File[ELF_PHNUM_OFFSET], 3);
+
+	Ph = &File[52];
+	SetLe32(&Ph[ELF_PH_TYPE_OFFSET], ELF_PT_LOAD);
+	SetLe32(&Ph[ELF_PH_OFFSET_OFFSET], ElfSeg[0][0]);
+	SetLe32(&Ph[ELF_PH_PADDR_OFFSET], ElfSeg[0][1]);
+	SetLe32(&Ph[ELF_PH_FILESZ_OFFSET], ElfSeg[0][2]);
+	SetLe32(&Ph[ELF_PH_MEMSZ_OFFSET], ElfSeg[0][3]);
+	Ph += 32;
+	SetLe32(&Ph[ELF_PH_TYPE_OFFSET], 4);	/* PT_NOTE */
+	SetLe32(&Ph[ELF_PH_OFFSET_OFFSET], 0x200);
+	SetLe32(&Ph[ELF_PH_FILESZ_OFFSET], 0x20);
+	SetLe32(&Ph[ELF_PH_MEMSZ_OFFSET], 0x20);
+	Ph += 32;
+	SetLe32(&Ph[ELF_PH_TYPE_OFFSET], ELF_PT_LOAD);
+	SetLe32(&Ph[ELF_PH_OFFSET_OFFSET], ElfSeg[1][0]);
+	SetLe32(&Ph[ELF_PH_PADDR_OFFSET], ElfSeg[1][1]);
+	SetLe32(&Ph[ELF_PH_FILESZ_OFFSET], ElfSeg[1][2]);
+	SetLe32(&Ph[ELF_PH_MEMSZ_OFFSET], ElfSeg[1][3]);
+	return ELF_SIZE;
+}
+
+static void Digest(CardFile *File, int Upper)
+{
+	MD5Context Context;
+	u8 Sum[SD_MANIFEST_DIGEST_SIZE];
+	u32 Index;
+
+	MD5Init(&Context);
+	MD5Update(&Context, File->Data, File->Size, 0);
+	MD5Final(&Context, Sum, 0);
+	for (Index = 0; Index < SD_MANIFEST_DIGEST_SIZE; Index++)
+		sprintf(&File->Digest[Index * 2], Upper ? "%02X" : "%02x",
+				Sum[Index]);
+}
+
+static void AddFile(const char *Name, u8 *Data, u32 Size)
+{
+	Card[CardFiles].Name = Name;
+	Card[CardFiles].Data = Data;
+	Card[CardFiles].Size = Size;
+	CardFiles++;
+}
+
+/*
+ * Card files other than the manifest, their digests and the manifest lines
+ */
+static void MakeFiles(int Upper)
+{
+	u32 Index;
+
+	srand(1);
+	CardFiles = 0;
+	MakeBitWords(BitWords[0]);
+	MakeBitWords(BitWords[1]);
+	AddFile("SYSTEM.BIT", BitFile, MakeBit(BitFile, BitWords[0]));
+	for (Index = 0; Index < BIT_WORDS; Index++)
+		SetLe32(&BinFile[Index * 4], BitWords[1][Index]);
+	AddFile("FABRIC.BIN", BinFile, BIT_WORDS * 4);
+	AddFile("UBOOT.ELF", ElfFile, MakeElf(ElfFile));
+	for (Index = 0; Index < 0x2345; Index++)
+		DtbFile[Index] = rand();
+	AddFile("DEVTREE.DTB", DtbFile, 0x2345);
+	for (Index = 0; Index < 0x9001; Index++)
+		RamdiskFile[Index] = rand();
+	AddFile("RAMDISK.GZ", RamdiskFile, 0x9001);
+
+	for (Index = 0; Index < CardFiles; Index++)
+		Digest(&Card[Index], Upper);
+}
+
+static u32 MakeManifest(const char *DtbDigest)
+{
+	return snprintf((char *)ManifestFile, sizeof(ManifestFile),
+			"# Boot files\r\n"
+			"SYSTEM.BIT\tbit\t%s\r\n"
+			"FABRIC.BIN bit %s # second bitstream\r\n"
+			"UBOOT.ELF elf %s\r\n"
+			"\r\n"
+			"DEVTREE.DTB bin 0x%08x %s\r\n"
+			"RAMDISK.GZ bin 0x%08x %s\r\n",
+			Card[0].Digest, Card[1].Digest, Card[2].Digest,
+			DTB_ADDR, DtbDigest ? DtbDigest : Card[3].Digest,
+			RAMDISK_ADDR, Card[4].Digest);
+}
+
+/*
+ * FAT16 volume of the card files, they take turns every Fragment clusters
+ */
+static int BuildVolume(u32 Fragment)
+{
+	u32 ClusterBytes = ClusterSectors * SD_MANIFEST_SECTOR_SIZE;
+	u32 Next = 2;
+	u32 Left;
+	u32 Run;
+	u32 Index;
+	u32 Offset;
+	u8 *Entry;
+	char Name[12];
+	const char *Dot;
+
+	memset(Disk, 0, (VOL_DATA + VOL_CLUSTERS * ClusterSectors) *
+			SD_MANIFEST_SECTOR_SIZE);
+	memset(Fat, 0, sizeof(Fat));
+	Fat[0] = 0xFFF8;
+	Fat[1] = 0xFFFF;
+
+	for (Index = 0; Index < CardFiles; Index++)
+		Card[Index].Clusters = 0;
+	do {
+		Left = 0;
+		for (Index = 0; Index < CardFiles; Index++) {
+			CardFile *File = &Card[Index];
+			u32 Need = (File->Size + ClusterBytes - 1) / ClusterBytes;
+
+			for (Run = 0; (File->Clusters < Need) &&
+					(!Fragment || (Run < Fragment)); Run++) {
+				if (Next >= VOL_CLUSTERS + 2)
+					return 0;
+				File->Cluster[File->Clusters++] = Next++;
+			}
+			Left += Need - File->Clusters;
+		}
+	} while (Left);
+
+	Disk[0] = 0xEB;
+	Disk[1] = 0x3C;
+	Disk[2] = 0x90;
+	memcpy(&Disk[3], "MSWIN4.1", 8);
+	SetLe16(&Disk[11], SD_MANIFEST_SECTOR_SIZE);
+	Disk[13] = ClusterSectors;
+	SetLe16(&Disk[14], 1);
+	Disk[16] = 1;
+	SetLe16(&Disk[17], VOL_ROOT_SECTORS * SD_MANIFEST_SECTOR_SIZE / 32);
+	if (VOL_DATA + VOL_CLUSTERS * ClusterSectors > 0xFFFF)
+		SetLe32(&Disk[32], VOL_DATA + VOL_CLUSTERS * ClusterSectors);
+	else
+		SetLe16(&Disk[19], VOL_DATA + VOL_CLUSTERS * ClusterSectors);
+	Disk[21] = 0xF8;
+	SetLe16(&Disk[22], VOL_FAT_SECTORS);
+	Disk[38] = 0x29;
+	memcpy(&Disk[54], "FAT16   ", 8);
+	Disk[510] = 0x55;
+	Disk[511] = 0xAA;
+
+	for (Index = 0; Index < CardFiles; Index++) {
+		CardFile *File = &Card[Index];
+
+		for (Run = 0; Run < File->Clusters; Run++)
+			Fat[File->Cluster[Run]] = (Run + 1 < File->Clusters) ?
+					File->Cluster[Run + 1] : 0xFFFF;
+		for (Offset = 0; Offset < File->Size; Offset++)
+			Disk[(VOL_DATA + (File->Cluster[Offset / ClusterBytes] - 2) *
+					ClusterSectors) * SD_MANIFEST_SECTOR_SIZE +
+					Offset % ClusterBytes] = File->Data[Offset];
+
+		memset(Name, ' ', 11);
+		Dot = strchr(File->Name, '.');
+		memcpy(Name, File->Name, Dot - File->Name);
+		memcpy(&Name[8], Dot + 1, strlen(Dot + 1));
+		Entry = &Disk[VOL_ROOT * SD_MANIFEST_SECTOR_SIZE + Index * 32];
+		memcpy(Entry, Name, 11);
+		Entry[11] = 0x20;
+		SetLe16(&Entry[26], File->Cluster[0]);
+		SetLe32(&Entry[28], File->Size);
+	}
+	for (Index = 0; Index < VOL_CLUSTERS + 2; Index++)
+		SetLe16(&Disk[SD_MANIFEST_SECTOR_SIZE + Index * 2], Fat[Index]);
+
+	return 1;
+}
+
+/*
+ * Card byte of a file
+ */
+static u8 *CardByte(CardFile *File, u32 Offset)
+{
+	u32 ClusterBytes = ClusterSectors * SD_MANIFEST_SECTOR_SIZE;
+
+	return &Disk[(VOL_DATA + (File->Cluster[Offset / ClusterBytes] - 2) *
+			ClusterSectors) * SD_MANIFEST_SECTOR_SIZE +
+			Offset % ClusterBytes];
+}
+
+/*
+ * Card with the test files, with or without the manifest
+ */
+static int Insert(u32 Fragment, const char *DtbDigest, int WithManifest)
+{
+	static FATFS FatFs;
+
+	MakeFiles(0);
+	if (WithManifest)
+		AddFile("MANIFEST.TXT", ManifestFile, MakeManifest(DtbDigest));
+	if (!BuildVolume(Fragment))
+		return 0;
+	f_mount(0, &FatFs);
+	return 1;
+}
+
+/*
+ * Load of the manifest, 1 if it fell back
+ */
+static int Load(u32 *ExecAddress)
+{
+	memset((void *)MAP_BASE, FILL, MAP_SIZE);
+	LastStatus = 0;
+	PcapCalls = 0;
+	PcapErrors = 0;
+	Sectors = 0;
+	Reads = 0;
+
+	if (setjmp(FallbackJmp))
+		return 1;
+	*ExecAddress = SdManifestLoad();
+	return 0;
+}
+
+static int Loaded(void)
+{
+	u8 *Mem;
+	u32 Index;
+	int Ok = 1;
+
+	for (Index = 0; Index < 2; Index++) {
+		Mem = (u8 *)ElfSeg[Index][1];
+		Ok &= !memcmp(Mem, &ElfFile[ElfSeg[Index][0]], ElfSeg[Index][2]);
+		for (Mem += ElfSeg[Index][2]; Mem < (u8 *)(ElfSeg[Index][1] +
+				ElfSeg[Index][3]); Mem++)
+			Ok &= (*Mem == 0);
+	}
+	Ok &= !memcmp((void *)DTB_ADDR, DtbFile, 0x2345);
+	Ok &= !memcmp((void *)RAMDISK_ADDR, RamdiskFile, 0x9001);
+	Ok &= (*(u8 *)(RAMDISK_ADDR - 1) == FILL) &&
+			(*(u8 *)(RAMDISK_ADDR + 0x9001) == FILL);
+	return Ok;
+}
+
+static void GoodCard(u32 Fragment)
+{
+	u32 FileSectors = 0;
+	u32 Exec = 0;
+	u32 Index;
+
+	Check(Insert(Fragment, NULL, 1), "volume too small");
+	if (SdManifestOpen(SD_MANIFEST_FILE) != XST_SUCCESS) {
+		Check(0, "manifest open");
+		return;
+	}
+	Check(!Load(&Exec), "good card fell back");
+	Check(Exec == ELF_ENTRY, "execution address is not the ELF entry");
+	Check((PcapCalls == 2) && !PcapErrors, "bitstreams to the PCAP");
+	Check(BitstreamFlag == 1, "BitstreamFlag not set");
+	Check(Loaded(), "PS files in memory");
+
+	for (Index = 0; Index < 5; Index++)
+		FileSectors += (Card[Index].Size + SD_MANIFEST_SECTOR_SIZE - 1) /
+				SD_MANIFEST_SECTOR_SIZE;
+	printf("  %-12s %6lu sectors %5lu reads, files %6u sectors, "
+			"%u runs\n", Fragment ? "fragmented" : "contiguous", Sectors,
+			Reads, FileSectors, ExtentCount);
+}
+
+int main(int argc, char **argv)
+{
+	static const struct {
+		u32 File;
+		u32 Offset;
+		u32 PcapCalls;
+		const char *Text;
+	} Change[] = {
+		{ 0, 20, 0, ".bit header" },
+		{ 0, 0x40000, 0, ".bit data" },
+		{ 1, 0x3FFFF, 1, ".bin bitstream" },
+		{ 2, 0x1800, 2, "ELF segment read first for the digest" },
+		{ 2, 0x9000, 2, "ELF segment" },
+		{ 2, 0x400, 2, "ELF between segments" },
+		{ 2, 0xE7FF, 2, "ELF section headers" },
+		{ 3, 0x2344, 2, "raw file" },
+		{ 4, 0, 2, "unaligned raw file" } };
+	static const char *BadDigest[] = {
+		"",
+		"0123456789abcdef0123456789abcde",
+		"0123456789abcdef0123456789abcdef0",
+		"0123456789abcdefg123456789abcdef",
+		"0x0123456789abcdef0123456789abcd" };
+	static char Line[64];
+	void *Map;
+	u32 Fragment = 16;
+	u32 Exec;
+	u32 Index;
+	int Arg;
+
+	for (Arg = 1; (Arg + 1 < argc) && (argv[Arg][0] == '-'); Arg += 2) {
+		if (!strcmp(argv[Arg], "-c")) {
+			ClusterSectors = strtoul(argv[Arg + 1], NULL, 0);
+		} else if (!strcmp(argv[Arg], "-f")) {
+			Fragment = strtoul(argv[Arg + 1], NULL, 0);
+		} else {
+			break;
+		}
+	}
+	if ((Arg != argc) || (ClusterSectors == 0) || (ClusterSectors > 64) ||
+			(ClusterSectors & (ClusterSectors - 1)) || (Fragment == 0)) {
+		fprintf(stderr, "usage: %s [-c <sectors per cluster>] "
+				"[-f <clusters>]\n", argv[0]);
+		return 1;
+	}
+
+	Map = mmap((void *)MAP_BASE, MAP_SIZE, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	Disk = malloc((VOL_DATA + VOL_CLUSTERS * ClusterSectors) *
+			SD_MANIFEST_SECTOR_SIZE);
+	if ((Map != (void *)MAP_BASE) || (Disk == NULL)) {
+		fprintf(stderr, "%s: cannot map DDR at 0x%08x\n", argv[0],
+				MAP_BASE);
+		return 1;
+	}
+
+	/* Contiguous and fragmented files */
+	GoodCard(0);
+	GoodCard(Fragment);
+
+	/* Changed byte of each file */
+	for (Index = 0; Index < sizeof(Change) / sizeof(Change[0]); Index++) {
+		Insert(Fragment, NULL, 1);
+		*CardByte(&Card[Change[Index].File], Change[Index].Offset) ^= 0x10;
+		sprintf(Line, "changed %s", Change[Index].Text);
+		Check(SdManifestOpen(SD_MANIFEST_FILE) == XST_SUCCESS, Line);
+		Check(Load(&Exec) && (LastStatus == SD_MANIFEST_FAIL), Line);
+		Check(PcapCalls == Change[Index].PcapCalls, Line);
+	}
+
+	/* Missing and invalid digests */
+	for (Index = 0; Index < sizeof(BadDigest) / sizeof(BadDigest[0]);
+			Index++) {
+		Insert(Fragment, BadDigest[Index], 1);
+		sprintf(Line, "digest \"%s\" accepted", BadDigest[Index]);
+		Check(SdManifestOpen(SD_MANIFEST_FILE) == XST_FAILURE, Line);
+	}
+	MakeFiles(1);
+	strcpy(Line, Card[3].Digest);
+	Insert(Fragment, Line, 1);
+	Check(SdManifestOpen(SD_MANIFEST_FILE) == XST_SUCCESS,
+			"upper case digest rejected");
+	Check(!Load(&Exec) && Loaded(), "load with upper case digest");
+
+	/* RSA enforced by the eFuse */
+	Insert(Fragment, NULL, 1);
+	EfuseStatus = EFUSE_STATUS_RSA_ENABLE_MASK;
+	Check(SdManifestOpen(SD_MANIFEST_FILE) == XST_NO_DATA,
+			"manifest used with RSA enforced");
+	Silicon_Version = SILICON_VERSION_2;
+	Check(SdManifestOpen(SD_MANIFEST_FILE) == XST_SUCCESS,
+			"manifest not used on silicon without RSA");
+	Silicon_Version = SILICON_VERSION_3;
+	EfuseStatus = 0;
+
+	/* No manifest */
+	Insert(Fragment, NULL, 0);
+	Check(SdManifestOpen(SD_MANIFEST_FILE) == XST_NO_DATA,
+			"card without manifest");
+
+	printf("%d errors\n", Errors);
+	return Errors ? 1 : 0;
+}
@@ -0,0 +1,812 @@
+/******************************************************************************
+*
+* sdstreamsim.c
+*
+* Host side timing of the asynchronous SD reads of FSBL/src/mmc.c, of the
+* FatFs read ahead (_FS_READAHEAD) and of the checksummed partition reads
+* of FSBL/src/sd.c. The card driver, FatFs, sd.c and the MD5 code are built
+* into the tool, the register accesses go to a timed model of the SD host
+* controller and of a SDHC card.
+*
+* The card holds a FAT32 volume with BOOT.BIN, its clusters are contiguous
+* or, with -f, a cluster is skipped after every given number. A command
+* completes after its bits went over the bus, a read after the access time
+* and the blocks at the bus width and clock the driver negotiated. The data
+* lands in memory when the transfer completes, the buffer is filled with a
+* pattern before. A data address that is not word aligned ends the transfer
+* with an ADMA error. Each register access costs -r ns, MD5 costs -m ns per
+* byte. CPU time spent in register polls that find the controller still
+* busy is counted as idle.
+*
+* The whole file is read with f_read() into a word aligned and into an
+* unaligned buffer. A partition read of SDAccess() is timed with the
+* checksum computed after the read (PartitionChecksumFlag clear, as md5()
+* does) and with the checksum computed during the read. The test checks that
+*   - all reads return the file contents and the checksums match,
+*   - SdGetStreamChecksum() has the checksum of the streamed read only,
+*   - queued requests complete in order and their callbacks may poll,
+*   - a read error of a posted read fails SDAccess() and the card reads
+*     again afterwards.
+* Reported are the throughput, the CPU idle and the card busy percentage
+* and the number of read commands. Build with -D_FS_READAHEAD=0 for the
+* plain FatFs read path, its unaligned read fails: ADMA2 needs word aligned
+* data addresses.
+*
+* Build: gcc -O2 -no-pie -fgnu89-inline -Wno-pointer-to-int-cast
+*		 -Wno-int-to-pointer-cast [-D_FS_READAHEAD=<n>]
+*		 [-DSD_READ_DEPTH=<n>] -o sdstreamsim sdstreamsim.c
+*		 -I../../FSBL/src -I../../FSBL_bsp/ps7_cortexa9_0/include
+*
+* The driver keeps buffer addresses in 32-bit registers, -no-pie keeps the
+* static buffers of the tool below 4GB. md5.c uses gnu89 inline functions.
+*
+* Usage: sdstreamsim [-a <access us>] [-c <cluster KB>] [-f <clusters>]
+*		 [-m <MD5 ns/byte>] [-r <register ns>] [-s <file KB>]
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/*
+ * 32-bit register and pointer arithmetic types of the target, xil_types.h
+ * leaves them out when XBASIC_TYPES_H is defined
+ */
+#define XBASIC_TYPES_H
+typedef unsigned char u8;
+typedef unsigned short u16;
+typedef unsigned int u32;
+
+#include "mmc.c"
+#include "ff.c"
+#include "md5.c"
+
+/*
+ * MD5 calls of sd.c are timed
+ */
+static double Now;		/* ns */
+static double Md5Ns = 20;	/* per byte */
+
+static void TimedMD5Update(MD5Context *Context, u8 *Buffer, u32 Len,
+		boolean DoByteSwap)
+{
+	Now += Len * Md5Ns;
+	MD5Update(Context, Buffer, Len, DoByteSwap);
+}
+
+#define MD5Update TimedMD5Update
+#include "sd.c"
+#undef MD5Update
+
+#define MODEL_BASEADDR		XPAR_PS7_SD_0_S_AXI_BASEADDR
+#define SD_RCA			0xB368
+#define CMD_BITS		(48 + 8 + 48 + 8)	/* command, Ncr, response */
+#define BLOCK_OVERHEAD		(2 + 16 + 2)		/* start/end, CRC, Nac */
+
+/*
+ * FAT32 volume, cluster 2 is the root directory, the file starts at 3
+ */
+#define VOL_RESERVED		32
+#define VOL_CLUSTERS		70000			/* FAT32 from 65525 */
+#define VOL_FAT_SECTORS		((VOL_CLUSTERS + 2) * 4 / SD_BLOCK_SZ + 1)
+#define VOL_DATA		(VOL_RESERVED + VOL_FAT_SECTORS)
+#define FILE_NAME		"BOOT.BIN"
+
+#define MAX_FILE		(64 * 1024 * 1024)
+
+u32 FlashReadBaseAddress;
+u8 PartitionChecksumFlag;
+
+static u32 Fat[VOL_CLUSTERS + 2];
+static u32 ClusterSectors = 64;
+static u32 FileSize = 16 * 1024 * 1024;
+static u32 FileCluster[VOL_CLUSTERS];
+
+static u8 Dest[MAX_FILE + 4] __attribute__((aligned(32)));
+static u8 Expect[MAX_FILE];
+
+/*
+ * Timing
+ */
+static double RegNs = 100;
+static double AccessNs = 50000;
+static double IdleNs;
+static double CardNs;		/* card transferring data */
+static unsigned long Reads;	/* block read commands */
+
+/*
+ * Controller and card state
+ */
+static u8 Regs[0x100];
+static double CmdDone;		/* CMD_CMPL due, 0 for none */
+static double TransDone;	/* TRNS_CMPL due, 0 for none */
+static u32 TransStat;
+static u8 *TransBuf;
+static u32 TransLba;
+static u32 TransBlocks;
+static u8 TransData[64];
+static u32 TransSize;		/* bytes of TransData, 0 for card blocks */
+static int AppCmd;
+static int Width = 1;
+static u8 *FailBuf;		/* first transfer into Dest from here fails */
+
+static u32 Reg32(u32 Offset)
+{
+	return Regs[Offset] | (Regs[Offset + 1] << 8) | (Regs[Offset + 2] << 16) |
+			((u32)Regs[Offset + 3] << 24);
+}
+
+static u16 Reg16(u32 Offset)
+{
+	return Regs[Offset] | (Regs[Offset + 1] << 8);
+}
+
+static void SetReg32(u32 Offset, u32 Value)
+{
+	Regs[Offset] = Value;
+	Regs[Offset + 1] = Value >> 8;
+	Regs[Offset + 2] = Value >> 16;
+	Regs[Offset + 3] = Value >> 24;
+}
+
+static void SetReg16(u32 Offset, u16 Value)
+{
+	Regs[Offset] = Value;
+	Regs[Offset + 1] = Value >> 8;
+}
+
+static void Interrupt(u32 Status)
+{
+	Status |= Reg32(SD_INT_STAT_R);
+	if (Status & 0xFFFF0000)
+		Status |= SD_INT_ERROR;
+	SetReg32(SD_INT_STAT_R, Status);
+}
+
+static double ClockHz(void)
+{
+	u16 Clk = Reg16(SD_CLK_CTL_R);
+	u32 Div = Clk >> SD_DIV_SHIFT;
+
+	return Div ? SDIO_FREQ / (2.0 * Div) : SDIO_FREQ;
+}
+
+static int HostWidth(void)
+{
+	return (Regs[SD_HOST_CTRL_R] & SD_HOST_4BIT) ? 4 : 1;
+}
+
+static void SetLe32(u8 *p, u32 Value)
+{
+	p[0] = Value;
+	p[1] = Value >> 8;
+	p[2] = Value >> 16;
+	p[3] = Value >> 24;
+}
+
+/*
+ * Card contents, a pattern of the byte address in the data area
+ */
+static u8 Pattern(u32 Lba, u32 Byte)
+{
+	u32 Value = (Lba * SD_BLOCK_SZ + (Byte & ~3)) * 2654435761u;
+
+	return Value >> (8 * (Byte & 3));
+}
+
+static void CardBlock(u32 Lba, u8 *Buf)
+{
+	u32 Sector;
+	u32 Index;
+
+	memset(Buf, 0, SD_BLOCK_SZ);
+
+	if (Lba == 0) {
+		Buf[0] = 0xEB;
+		Buf[1] = 0x58;
+		Buf[2] = 0x90;
+		memcpy(&Buf[3], "MSWIN4.1", 8);
+		Buf[11] = SD_BLOCK_SZ & 0xFF;
+		Buf[12] = SD_BLOCK_SZ >> 8;
+		Buf[13] = ClusterSectors;
+		Buf[14] = VOL_RESERVED;
+		Buf[16] = 1;
+		Buf[21] = 0xF8;
+		SetLe32(&Buf[32], VOL_DATA + VOL_CLUSTERS * ClusterSectors);
+		SetLe32(&Buf[36], VOL_FAT_SECTORS);
+		SetLe32(&Buf[44], 2);
+		Buf[48] = 1;
+		Buf[66] = 0x29;
+		memcpy(&Buf[82], "FAT32   ", 8);
+		Buf[510] = 0x55;
+		Buf[511] = 0xAA;
+	} else if ((Lba >= VOL_RESERVED) && (Lba < VOL_DATA)) {
+		Sector = Lba - VOL_RESERVED;
+		for (Index = 0; Index < SD_BLOCK_SZ / 4; Index++)
+			if (Sector * (SD_BLOCK_SZ / 4) + Index < VOL_CLUSTERS + 2)
+				SetLe32(&Buf[Index * 4],
+						Fat[Sector * (SD_BLOCK_SZ / 4) + Index]);
+	} else if (Lba == VOL_DATA) {
+		memcpy(&Buf[0], "BOOT    BIN", 11);
+		Buf[11] = 0x20;
+		Buf[20] = FileCluster[0] >> 16;
+		Buf[21] = FileCluster[0] >> 24;
+		Buf[26] = FileCluster[0];
+		Buf[27] = FileCluster[0] >> 8;
+		SetLe32(&Buf[28], FileSize);
+	} else if (Lba >= VOL_DATA + ClusterSectors) {
+		for (Index = 0; Index < SD_BLOCK_SZ; Index++)
+			Buf[Index] = Pattern(Lba, Index);
+	}
+}
+
+/*
+ * FAT chain of the file, a cluster skipped after every Fragment ones
+ */
+static int BuildVolume(u32 Fragment)
+{
+	u32 ClusterBytes = ClusterSectors * SD_BLOCK_SZ;
+	u32 Clusters = (FileSize + ClusterBytes - 1) / ClusterBytes;
+	u32 Cluster = 3;
+	u32 Index;
+	u32 Offset;
+	u32 Lba;
+
+	memset(Fat, 0, sizeof(Fat));
+	Fat[0] = 0x0FFFFFF8;
+	Fat[1] = 0x0FFFFFFF;
+	Fat[2] = 0x0FFFFFFF;
+
+	for (Index = 0; Index < Clusters; Index++) {
+		if (Fragment && Index && ((Index % Fragment) == 0))
+			Cluster++;
+		if (Cluster >= VOL_CLUSTERS + 2)
+			return 0;
+		FileCluster[Index] = Cluster++;
+	}
+	for (Index = 0; Index < Clusters; Index++)
+		Fat[FileCluster[Index]] = (Index + 1 < Clusters) ?
+				FileCluster[Index + 1] : 0x0FFFFFFF;
+
+	for (Offset = 0; Offset < FileSize; Offset++) {
+		Lba = VOL_DATA + (FileCluster[Offset / ClusterBytes] - 2) *
+				ClusterSectors + (Offset % ClusterBytes) / SD_BLOCK_SZ;
+		Expect[Offset] = Pattern(Lba, Offset % SD_BLOCK_SZ);
+	}
+	return 1;
+}
+
+/*
+ * Command written to the controller, 0 for a command timeout. Data is
+ * described in TransData/TransSize or TransLba/TransBlocks.
+ */
+static int Command(u32 Index, u32 Arg, u32 *Response)
+{
+	int App = AppCmd;
+
+	AppCmd = 0;
+	*Response = 0;
+	TransSize = 0;
+	TransBlocks = 0;
+	memset(TransData, 0, sizeof(TransData));
+
+	switch (Index) {
+	case 0:
+		Width = 1;
+		return 1;
+	case 8:
+		*Response = Arg & 0xFFF;
+		return 1;
+	case 55:
+		AppCmd = 1;
+		*Response = 0x20;
+		return 1;
+	case 41:
+		*Response = 0x80000000 | 0x40000000 | 0x00FF8000;
+		return App;
+	case 3:
+		*Response = SD_RCA << 16;
+		return 1;
+	case 7:
+		return (Arg >> 16) == SD_RCA;
+	case 2:
+	case 9:
+	case 13:
+	case 16:
+		return 1;
+	case 42:
+		return App;
+	case 51:
+		if (!App)
+			return 0;
+		TransData[0] = 0x02;
+		TransData[1] = 0x05;
+		TransSize = 8;
+		return 1;
+	case 6:
+		if (App) {
+			Width = (Arg == 2) ? 4 : 1;
+			return 1;
+		}
+		TransData[13] = 0x03;
+		TransData[16] = ((Arg & 0xF) <= 1) ? (Arg & 0xF) : 0xF;
+		TransSize = 64;
+		return 1;
+	case 17:
+	case 18:
+		TransLba = Arg;
+		TransBlocks = (Index == 17) ? 1 : Reg16(SD_BLOCK_CNT_R);
+		return 1;
+	}
+	return 0;
+}
+
+/*
+ * Data phase of a command, due after the access time and the blocks
+ */
+static void StartData(int AutoCmd12)
+{
+	u32 *Desc = (u32 *)(uintptr_t)Reg32(SD_ADMA_ADDR_R);
+	u32 Size = (Reg16(SD_BLOCK_SZ_R) & 0xFFF) * Reg16(SD_BLOCK_CNT_R);
+	u32 DescLength = Desc[0] >> DESC_ATBR_LEN_SHIFT;
+	u32 Length = TransSize ? TransSize : TransBlocks * SD_BLOCK_SZ;
+	u32 Block = TransSize ? TransSize : SD_BLOCK_SZ;
+	u32 Blocks = TransSize ? 1 : TransBlocks;
+	double Clock = ClockHz();
+	double Duration;
+
+	if (DescLength == 0)
+		DescLength = 0x10000;	/* 0 is 64KB */
+
+	TransBuf = (u8 *)(uintptr_t)Desc[1];
+	memset(TransBuf, 0xA5, DescLength);
+	if (TransBlocks)
+		Reads++;
+
+	Duration = (TransSize ? 0 : AccessNs) + Blocks * 1e9 *
+			(Block * 8.0 / Width + BLOCK_OVERHEAD) / Clock;
+	if (AutoCmd12)
+		Duration += 1e9 * CMD_BITS / Clock;
+	TransDone = CmdDone + Duration;
+	CardNs += Duration;
+
+	TransStat = SD_INT_TRNS_CMPL;
+	if (Desc[1] & 3) {
+		printf("  ADMA2 data address 0x%08x not word aligned\n", Desc[1]);
+		TransStat = SD_INT_ERR_ADMA;
+	} else if ((Size != Length) || (DescLength != Length)) {
+		printf("  transfer of %u bytes, block registers %u, descriptor "
+				"%u\n", Length, Size, DescLength);
+		TransStat = SD_INT_ERR_ADMA;
+	} else if ((HostWidth() != Width) || (FailBuf && (TransBuf >= FailBuf) &&
+			(TransBuf < Dest + MAX_FILE))) {
+		TransStat = SD_INT_ERR_DCRC;
+		FailBuf = NULL;
+	}
+}
+
+/*
+ * Events due by now
+ */
+static void Update(void)
+{
+	u32 Block;
+
+	if (CmdDone && (Now >= CmdDone)) {
+		CmdDone = 0;
+		Interrupt(SD_INT_CMD_CMPL);
+	}
+
+	if (TransDone && (Now >= TransDone)) {
+		TransDone = 0;
+		if (TransStat == SD_INT_TRNS_CMPL) {
+			if (TransSize)
+				memcpy(TransBuf, TransData, TransSize);
+			for (Block = 0; Block < TransBlocks; Block++)
+				CardBlock(TransLba + Block,
+						TransBuf + Block * SD_BLOCK_SZ);
+		}
+		Interrupt(TransStat);
+	}
+}
+
+u8 Xil_In8(u32 Addr)
+{
+	Now += RegNs;
+	return Regs[(Addr - MODEL_BASEADDR) & 0xFF];
+}
+
+u16 Xil_In16(u32 Addr)
+{
+	u32 Offset = (Addr - MODEL_BASEADDR) & 0xFF;
+
+	Now += RegNs;
+	if (Offset == SD_CLK_CTL_R)
+		return Reg16(Offset) | ((Reg16(Offset) & SD_CLK_INT_EN) ?
+				SD_CLK_INT_STABLE : 0);
+	if (Offset == SD_HOST_VER_R)
+		return 0x0001;		/* 2.00 host */
+	return Reg16(Offset);
+}
+
+u32 Xil_In32(u32 Addr)
+{
+	u32 Offset = (Addr - MODEL_BASEADDR) & 0xFF;
+	u32 Value;
+
+	Now += RegNs;
+	Update();
+
+	switch (Offset) {
+	case SD_PRES_STATE_R:
+		Value = SD_CARD_INS | (CmdDone ? SD_CMD_INHIBIT : 0) |
+				(TransDone ? SD_DATA_INHIBIT : 0);
+		if (Value & (SD_CMD_INHIBIT | SD_DATA_INHIBIT))
+			IdleNs += RegNs;
+		return Value;
+	case SD_INT_STAT_R:
+		Value = Reg32(Offset);
+		if (!(Value & (SD_INT_CMD_CMPL | SD_INT_TRNS_CMPL | SD_INT_ERROR)))
+			IdleNs += RegNs;
+		return Value;
+	case SD_CAPABILITIES_R:
+		return SD_CAP_HS;
+	case SD_CAPABILITIES2_R:
+		return 0;
+	}
+	return Reg32(Offset);
+}
+
+void Xil_Out8(u32 Addr, u8 Value)
+{
+	u32 Offset = (Addr - MODEL_BASEADDR) & 0xFF;
+
+	Now += RegNs;
+	if (Offset == SD_SOFT_RST_R) {
+		if (Value & SD_RST_ALL) {
+			memset(Regs, 0, sizeof(Regs));
+			Width = 1;
+		}
+		if (Value & (SD_RST_ALL | SD_RST_CMD | SD_RST_DATA)) {
+			SetReg32(SD_INT_STAT_R, 0);
+			CmdDone = 0;
+			TransDone = 0;
+		}
+		return;
+	}
+	Regs[Offset] = Value;
+}
+
+void Xil_Out16(u32 Addr, u16 Value)
+{
+	u32 Offset = (Addr - MODEL_BASEADDR) & 0xFF;
+	u32 Index = (Value >> 8) & 0x3F;
+	u32 Response;
+
+	Now += RegNs;
+	SetReg16(Offset, Value);
+	if (Offset != SD_CMD_R)
+		return;
+
+	if (!Command(Index, Reg32(SD_ARG_R), &Response)) {
+		Interrupt(SD_INT_ERR_CTIMEOUT);
+		return;
+	}
+	SetReg32(SD_RSP_R, Response);
+	CmdDone = Now + 1e9 * CMD_BITS / ClockHz();
+
+	if (TransSize || TransBlocks)
+		StartData(Index == 18);
+}
+
+void Xil_Out32(u32 Addr, u32 Value)
+{
+	u32 Offset = (Addr - MODEL_BASEADDR) & 0xFF;
+	u32 Status;
+
+	Now += RegNs;
+	if (Offset == SD_INT_STAT_R) {
+		Status = Reg32(Offset) & ~Value;
+		if (!(Status & 0xFFFF0000))
+			Status &= ~SD_INT_ERROR;
+		SetReg32(Offset, Status);
+		return;
+	}
+	SetReg32(Offset, Value);
+}
+
+int usleep(unsigned int useconds)
+{
+	Now += useconds * 1000.0;
+	IdleNs += useconds * 1000.0;
+	return 0;
+}
+
+char *strcpy_rom(char *DestStr, const char *Src)
+{
+	return strcpy(DestStr, Src);
+}
+
+/*
+ * Partition read of the image mover, checksum after or during the read
+ */
+static int RunRead(int Stream, u32 Offset, u32 Length, double *TimeNs)
+{
+	MD5Context Context;
+	u8 Digest[SD_MD5_SIZE];
+	u8 Reference[SD_MD5_SIZE];
+	u32 Address = (u32)(uintptr_t)Dest;
+	u32 Status;
+	int Errors = 0;
+
+	memset(Dest, 0, Length);
+	md5(Expect + Offset, Length, Reference, 0);
+
+	Now = 0;
+	IdleNs = 0;
+	CardNs = 0;
+	Reads = 0;
+	PartitionChecksumFlag = Stream;
+
+	Status = SDAccess(Offset, Address, Length);
+	if (Stream) {
+		if (SdGetStreamChecksum(Address, Length, Digest) != XST_SUCCESS) {
+			printf("  streamed read has no checksum\n");
+			Errors++;
+		}
+		if (SdGetStreamChecksum(Address, Length - 4, Digest) ==
+				XST_SUCCESS) {
+			printf("  checksum of another range\n");
+			Errors++;
+		}
+	} else {
+		if (SdGetStreamChecksum(Address, Length, Digest) == XST_SUCCESS) {
+			printf("  checksum of a read that was not streamed\n");
+			Errors++;
+		}
+		MD5Init(&Context);
+		TimedMD5Update(&Context, Dest, Length, 0);
+		MD5Final(&Context, Digest, 0);
+	}
+
+	if (Status != XST_SUCCESS) {
+		printf("  SDAccess failed\n");
+		Errors++;
+	}
+	if (memcmp(Dest, Expect + Offset, Length) != 0) {
+		printf("  data differs\n");
+		Errors++;
+	}
+	if (memcmp(Digest, Reference, SD_MD5_SIZE) != 0) {
+		printf("  checksum differs\n");
+		Errors++;
+	}
+
+	*TimeNs = Now;
+	printf("%-9s %8.2f ms %7.2f MB/s  CPU idle %5.1f%%  card busy %5.1f%%  "
+			"%lu reads\n", Stream ? "during" : "after", Now / 1e6,
+			Length * 1e3 / Now, 100.0 * IdleNs / Now, 100.0 * CardNs / Now,
+			Reads);
+	return Errors;
+}
+
+/*
+ * Whole file with f_read()
+ */
+static int RunFile(u32 Misalign)
+{
+	u8 *Buf = Dest + Misalign;
+	UINT Read = 0;
+	FRESULT Result;
+	int Errors = 0;
+
+	memset(Dest, 0, FileSize + 4);
+
+	Now = 0;
+	IdleNs = 0;
+	CardNs = 0;
+	Reads = 0;
+	PartitionChecksumFlag = 0;
+
+	Result = f_lseek(&fil, 0);
+	if (Result == FR_OK)
+		Result = f_read(&fil, Buf, FileSize, &Read);
+	if ((Result != FR_OK) || (Read != FileSize)) {
+		printf("  f_read returned %d, %u bytes\n", Result, Read);
+		f_open(&fil, FILE_NAME, FA_READ);
+		Errors++;
+	} else if (memcmp(Buf, Expect, FileSize) != 0) {
+		printf("  data differs\n");
+		Errors++;
+	}
+
+	printf("%-9s %8.2f ms %7.2f MB/s  CPU idle %5.1f%%  card busy %5.1f%%  "
+			"%lu reads\n", Misalign ? "unaligned" : "aligned", Now / 1e6,
+			FileSize * 1e3 / Now, 100.0 * IdleNs / Now, 100.0 * CardNs / Now,
+			Reads);
+	return Errors;
+}
+
+/*
+ * Requests queued directly, completed in order, the next one on the card
+ * while a callback runs
+ */
+#define QUEUE_REQS	4
+#define QUEUE_BLOCKS	16
+
+static DISK_REQ QueueReq[QUEUE_REQS];
+static u8 QueueBuf[QUEUE_REQS][QUEUE_BLOCKS * SD_BLOCK_SZ]
+		__attribute__((aligned(32)));
+static int QueueOrder[QUEUE_REQS];
+static int QueueDone;
+static int QueueErrors;
+
+static void QueueCallback(DISK_REQ *Req)
+{
+	int Index = Req - QueueReq;
+
+	QueueOrder[QueueDone++] = Index;
+	if ((Index + 1 < QUEUE_REQS) && (req_head != &QueueReq[Index + 1])) {
+		printf("  request %d not on the card during callback %d\n",
+				Index + 1, Index);
+		QueueErrors++;
+	}
+	disk_read_poll(0);
+}
+
+static int RunQueue(void)
+{
+	u8 Block[SD_BLOCK_SZ];
+	u32 Index;
+	u32 Lba;
+
+	QueueDone = 0;
+	QueueErrors = 0;
+	for (Index = 0; Index < QUEUE_REQS; Index++) {
+		QueueReq[Index].buff = QueueBuf[Index];
+		QueueReq[Index].sector = VOL_DATA + 1000 + Index * 37;
+		QueueReq[Index].count = QUEUE_BLOCKS;
+		QueueReq[Index].done = QueueCallback;
+		if (disk_read_submit(0, &QueueReq[Index]) != RES_OK) {
+			printf("  submit failed\n");
+			return 1;
+		}
+	}
+	while (disk_read_poll(0))
+		;
+
+	for (Index = 0; Index < QUEUE_REQS; Index++) {
+		if ((Index >= (u32)QueueDone) || (QueueOrder[Index] != (int)Index) ||
+				QueueReq[Index].busy || (QueueReq[Index].res != RES_OK)) {
+			printf("  request %u completed out of order\n", Index);
+			QueueErrors++;
+		}
+		for (Lba = 0; Lba < QUEUE_BLOCKS; Lba++) {
+			CardBlock(QueueReq[Index].sector + Lba, Block);
+			if (memcmp(Block, QueueBuf[Index] + Lba * SD_BLOCK_SZ,
+					SD_BLOCK_SZ) != 0) {
+				printf("  request %u data differs\n", Index);
+				QueueErrors++;
+				break;
+			}
+		}
+	}
+	return QueueErrors;
+}
+
+/*
+ * A posted read fails, SDAccess() fails and the card reads again
+ */
+static int RunError(u32 Offset, u32 Length)
+{
+	u32 Address = (u32)(uintptr_t)Dest;
+	u8 Digest[SD_MD5_SIZE];
+	double TimeNs;
+	int Errors = 0;
+
+	PartitionChecksumFlag = 1;
+	FailBuf = Dest + 0x10000;
+	if (SDAccess(Offset, Address, Length) == XST_SUCCESS) {
+		printf("  read error not reported\n");
+		Errors++;
+	}
+	if (SdGetStreamChecksum(Address, Length, Digest) == XST_SUCCESS) {
+		printf("  checksum of a failed read\n");
+		Errors++;
+	}
+	FailBuf = NULL;
+
+	/*
+	 * FatFs keeps a file that saw a disk error in the error state
+	 */
+	if (f_open(&fil, FILE_NAME, FA_READ) != FR_OK) {
+		printf("  reopen failed\n");
+		return Errors + 1;
+	}
+
+	printf("after a read error:\n");
+	return Errors + RunRead(1, Offset, Length, &TimeNs);
+}
+
+int main(int argc, char **argv)
+{
+	u32 Fragment = 0;
+	u32 Offset;
+	u32 Length;
+	double After;
+	double During;
+	int Arg;
+	int Errors = 0;
+
+	for (Arg = 1; (Arg + 1 < argc) && (argv[Arg][0] == '-'); Arg += 2) {
+		if (strcmp(argv[Arg], "-a") == 0)
+			AccessNs = strtod(argv[Arg + 1], NULL) * 1000;
+		else if (strcmp(argv[Arg], "-c") == 0)
+			ClusterSectors = atoi(argv[Arg + 1]) * 1024 / SD_BLOCK_SZ;
+		else if (strcmp(argv[Arg], "-f") == 0)
+			Fragment = atoi(argv[Arg + 1]);
+		else if (strcmp(argv[Arg], "-m") == 0)
+			Md5Ns = strtod(argv[Arg + 1], NULL);
+		else if (strcmp(argv[Arg], "-r") == 0)
+			RegNs = strtod(argv[Arg + 1], NULL);
+		else if (strcmp(argv[Arg], "-s") == 0)
+			FileSize = atoi(argv[Arg + 1]) * 1024;
+		else
+			break;
+	}
+	if ((Arg < argc) || (AccessNs < 0) || (Md5Ns < 0) || (RegNs <= 0) ||
+			(ClusterSectors == 0) || (ClusterSectors > 128) ||
+			(ClusterSectors & (ClusterSectors - 1)) ||
+			(FileSize < 0x20000) || (FileSize > MAX_FILE)) {
+		fprintf(stderr, "usage: %s [-a <access us>] [-c <cluster KB>] "
+				"[-f <clusters>] [-m <MD5 ns/byte>] [-r <register ns>] "
+				"[-s <file KB>]\n", argv[0]);
+		return 1;
+	}
+
+	if (!BuildVolume(Fragment)) {
+		fprintf(stderr, "file does not fit the volume\n");
+		return 1;
+	}
+
+	if (InitSD(FILE_NAME) != XST_SUCCESS) {
+		printf("InitSD failed\n");
+		return 1;
+	}
+
+	/*
+	 * A partition starts and ends within a sector
+	 */
+	Offset = 0x1A0;
+	Length = (FileSize - Offset - 0x64) & ~3;
+
+	printf("%u-bit %.1f MHz, %u KB clusters%s, access %.0f us, register "
+			"%.0f ns, MD5 %.1f ns/byte, read ahead %u, %u posted\n",
+			HostWidth(), ClockHz() / 1e6, ClusterSectors * SD_BLOCK_SZ / 1024,
+			Fragment ? " fragmented" : "", AccessNs / 1000, RegNs, Md5Ns,
+			_FS_READAHEAD, SD_READ_DEPTH);
+
+	printf("f_read of %u bytes\n", FileSize);
+	Errors += RunFile(0);
+	Errors += RunFile(1);
+
+	printf("partition read of %u bytes, checksum computed\n", Length);
+
+	Errors += RunRead(0, Offset, Length, &After);
+	Errors += RunRead(1, Offset, Length, &During);
+	printf("%.2f times faster\n", After / During);
+
+	Errors += RunQueue();
+	Errors += RunError(Offset, Length);
+
+	printf("%d errors\n", Errors);
+	return Errors ? 1 : 0;
+}
@@ -0,0 +1,690 @@
+/******************************************************************************
+*
+* usbbootsim.c
+*
+* Host side test of the USB device boot of FSBL/src/usb.c. usb.c, the usbps
+* driver and the MD5 code are built into the tool, the register accesses go
+* to a model of the device controller and of a host. The controller model
+* primes endpoints from their queue heads and finishes one dTD per host
+* transfer like the one of usbpssim. Setup packets are placed into the queue
+* head of endpoint 0 with the setup status bit set, a bus reset raises URI
+* with the port reset bit either still set or already cleared. Every poll
+* of the interrupt status lets the host run one step of its script, the
+* global timer advances by -t us with every read. Controller starts are
+* counted on the run/stop bit.
+*
+* The DDR regions of usb.c are mapped at their target addresses: partition
+* loads below USB_STAGING_ADDR, the staging area and the driver memory at
+* USB_DMA_MEM_ADDR. The test checks that
+*   - the host enumerates the device and gets its descriptors, a bus reset
+*     that is still in progress when it is handled leaves the controller
+*     running,
+*   - a bus reset that already ended when it is handled resets and
+*     configures the controller again, the host enumerates again,
+*   - without a host InitUsb() returns XST_NO_DATA after
+*     USB_HOST_TIMEOUT_MS, with the controller stopped and the flash base
+*     address unchanged, a host showing up late is still served,
+*   - UsbAccess() returns the image for short, forward skipping, backward
+*     and long reads, long reads are copied to their destination and
+*     UsbGetStreamChecksum() has their MD5 checksum,
+*   - reads outside of the image fail, unknown requests are stalled,
+*   - a bus reset during the download fails the next read.
+* Reported are the polls, the model time and the controller starts of each
+* session.
+*
+* Build: gcc -O2 -no-pie -fgnu89-inline -Wno-pointer-to-int-cast
+*		 -Wno-int-to-pointer-cast -o usbbootsim usbbootsim.c
+*		 -I../../FSBL/src -I../../FSBL_bsp/ps7_cortexa9_0/include
+*		 -I../../FSBL_bsp/ps7_cortexa9_0/libsrc/usbps_v1_05_a/src
+*
+* usb.c and the driver keep addresses in 32-bit variables, -no-pie keeps
+* the static buffers of the tool below 4GB. md5.c uses gnu89 inline
+* functions.
+*
+* Usage: usbbootsim [-s <image KB>] [-t <us per timer read>]
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/mman.h>
+
+/*
+ * 32-bit register and pointer arithmetic types of the target, xil_types.h
+ * leaves them out when XBASIC_TYPES_H is defined
+ */
+#define XBASIC_TYPES_H
+typedef unsigned char u8;
+typedef unsigned short u16;
+typedef unsigned int u32;
+
+#define USB_BOOT_SUPPORT
+
+#include "xusbps.c"
+#include "xusbps_endpoint.c"
+#include "xusbps_intr.c"
+#include "xusbps_hw.c"
+#include "xusbps_sinit.c"
+#include "xusbps_g.c"
+#include "md5.c"
+#include "usb.c"
+
+#define MODEL_BASEADDR		XPAR_XUSBPS_0_BASEADDR
+#define MAP_BASE		0x10000000
+#define MAP_SIZE		0x30000000
+#define LOAD_ADDR		MAP_BASE
+#define MAX_IMAGE		(32 * 1024 * 1024)
+#define MAX_STEPS		100000		/* host steps per script entry */
+
+u32 FlashReadBaseAddress;
+
+/*
+ * Controller state
+ */
+static u32 Regs[0x200 / 4];
+static u32 Ready;		/* ENDPTSTATUS */
+static u32 Cur[32];		/* dTD in work per ENDPTSTATUS bit */
+static unsigned long Starts;	/* CMD.RS set */
+
+/*
+ * Global timer
+ */
+static XTime Now;
+static XTime TickCounts;
+
+/*
+ * Host script
+ */
+enum {
+	H_END,
+	H_WAIT,		/* Arg ms of model time */
+	H_RESET,	/* Arg 1: PR still set when the device handles it */
+	H_SETUP,
+	H_STREAM	/* bulk OUT of the image */
+};
+
+typedef struct {
+	int Type;
+	u8 Setup[8];
+	u32 Arg;
+} HostOp;
+
+static const HostOp *Script;
+static u32 Op;
+static u32 Stage;
+static u32 Steps;
+static int InStep;
+static u32 HostPos;		/* image bytes sent */
+static u8 Reply[256];
+static u32 ReplyLen;
+static u8 DevDesc[18];
+static u8 CfgDesc[USB_CONFIG_DESC_LEN];
+static unsigned long Polls;
+static unsigned long Stalls;
+
+static u8 Image[MAX_IMAGE];
+static u32 ImageSize = 2 * 1024 * 1024;
+static u8 Hdr[0x1000] __attribute__((aligned(32)));
+
+static int Errors;
+
+static void Check(int Condition, const char *What)
+{
+	if (!Condition) {
+		printf("  FAIL: %s\n", What);
+		Errors++;
+	}
+}
+
+static u32 Word(u32 Addr, u32 Offset)
+{
+	return *(u32 *)(uintptr_t)(Addr + Offset);
+}
+
+static void SetWord(u32 Addr, u32 Offset, u32 Value)
+{
+	*(u32 *)(uintptr_t)(Addr + Offset) = Value;
+}
+
+/*
+ * Queue head of an endpoint, Bit as in ENDPTPRIME
+ */
+static u32 QueueHead(int Bit)
+{
+	u32 Index = (Bit >= 16) ? 2 * (Bit - 16) + 1 : 2 * Bit;
+
+	return Regs[XUSBPS_EPLISTADDR_OFFSET / 4] + Index * XUSBPS_dQH_ALIGN;
+}
+
+static void Prime(u32 Mask)
+{
+	u32 Next;
+	int Bit;
+
+	for (Bit = 0; Bit < 32; Bit++) {
+		if (!(Mask & (1 << Bit)))
+			continue;
+		Next = Word(QueueHead(Bit), XUSBPS_dQHdTDNLP);
+		if ((Next & XUSBPS_dTDNLP_T_MASK) ||
+				!(Word(Next & XUSBPS_dTDNLP_ADDR_MASK,
+				XUSBPS_dTDTOKEN) & XUSBPS_dTDTOKEN_ACTIVE_MASK)) {
+			continue;
+		}
+		Cur[Bit] = Next & XUSBPS_dTDNLP_ADDR_MASK;
+		Ready |= 1 << Bit;
+	}
+}
+
+/*
+ * Finishes the dTD in work of an endpoint with Length bytes moved and
+ * follows the link, the endpoint leaves the ready state at an inactive dTD
+ */
+static void Retire(int Bit, u32 Length)
+{
+	u32 Desc = Cur[Bit];
+	u32 Token = Word(Desc, XUSBPS_dTDTOKEN);
+	u32 Next = Word(Desc, XUSBPS_dTDNLP);
+	u32 Left = ((Token & XUSBPS_dTDTOKEN_LEN_MASK) >> 16) - Length;
+
+	Token &= ~(XUSBPS_dTDTOKEN_ACTIVE_MASK | XUSBPS_dTDTOKEN_LEN_MASK);
+	SetWord(Desc, XUSBPS_dTDTOKEN, Token | (Left << 16));
+	if (Token & XUSBPS_dTDTOKEN_IOC_MASK) {
+		Regs[XUSBPS_EPCOMPL_OFFSET / 4] |= 1 << Bit;
+		Regs[XUSBPS_ISR_OFFSET / 4] |= XUSBPS_IXR_UI_MASK;
+	}
+
+	SetWord(QueueHead(Bit), XUSBPS_dQHdTDNLP, Next);
+	if ((Next & XUSBPS_dTDNLP_T_MASK) ||
+			!(Word(Next & XUSBPS_dTDNLP_ADDR_MASK, XUSBPS_dTDTOKEN) &
+			XUSBPS_dTDTOKEN_ACTIVE_MASK)) {
+		Ready &= ~(1 << Bit);
+		return;
+	}
+	Cur[Bit] = Next & XUSBPS_dTDNLP_ADDR_MASK;
+}
+
+/*
+ * Address of byte Pos of the buffer of a dTD, through the page pointers
+ */
+static u8 *dTDByte(u32 Desc, u32 Pos)
+{
+	u32 Ptr0 = Word(Desc, XUSBPS_dTDBPTR(0));
+	u32 Offset = (Ptr0 & 0xFFF) + Pos;
+	u32 Page = Offset >> 12;
+
+	if (Page == 0)
+		return (u8 *)(uintptr_t)(Ptr0 + Pos);
+	return (u8 *)(uintptr_t)((Word(Desc, XUSBPS_dTDBPTR(Page)) &
+			0xFFFFF000) + (Offset & 0xFFF));
+}
+
+/*
+ * Host reads one dTD from the IN side of endpoint 0 into Reply
+ */
+static void HostIn0(void)
+{
+	u32 Length = (Word(Cur[16], XUSBPS_dTDTOKEN) &
+			XUSBPS_dTDTOKEN_LEN_MASK) >> 16;
+	u32 Pos;
+
+	for (ReplyLen = 0, Pos = 0; (Pos < Length) && (Pos < sizeof(Reply));
+			Pos++)
+		Reply[ReplyLen++] = *dTDByte(Cur[16], Pos);
+	Retire(16, Length);
+}
+
+/*
+ * Host sends Length bytes to an OUT endpoint as one transfer
+ */
+static void HostOut(int EpNum, const u8 *Data, u32 Length)
+{
+	u32 Pos;
+
+	for (Pos = 0; Pos < Length; Pos++)
+		*dTDByte(Cur[EpNum], Pos) = Data[Pos];
+	Retire(EpNum, Length);
+}
+
+/*
+ * One step of the host script, an entry waits until the device is ready
+ * for its next stage
+ */
+static void HostStep(void)
+{
+	const HostOp *Cmd = &Script[Op];
+	u32 Length;
+	u32 Max;
+
+	if ((Cmd->Type != H_END) && (Cmd->Type != H_WAIT) &&
+			(++Steps > MAX_STEPS)) {
+		printf("  FAIL: host stuck in script entry %u stage %u\n", Op,
+				Stage);
+		Errors++;
+		goto Next;
+	}
+
+	switch (Cmd->Type) {
+	case H_END:
+		return;
+
+	case H_WAIT:
+		if (Now < ((XTime)Cmd->Arg * COUNTS_PER_SECOND / 1000))
+			return;
+		goto Next;
+
+	case H_RESET:
+		if (Stage == 0) {
+			if (Regs[XUSBPS_CMD_OFFSET / 4] & XUSBPS_CMD_RS_MASK) {
+				Regs[XUSBPS_ISR_OFFSET / 4] |= XUSBPS_IXR_UR_MASK;
+				Regs[XUSBPS_PORTSCR1_OFFSET / 4] = Cmd->Arg ?
+						XUSBPS_PORTSCR_PR_MASK : 0;
+				Regs[XUSBPS_DEVICEADDR_OFFSET / 4] = 0;
+				Stage = 1;
+			}
+			return;
+		}
+		Regs[XUSBPS_PORTSCR1_OFFSET / 4] = 0;
+		goto Next;
+
+	case H_SETUP:
+		if (Stage == 0) {
+			if (!(Regs[XUSBPS_CMD_OFFSET / 4] & XUSBPS_CMD_RS_MASK))
+				return;
+			memcpy((u8 *)(uintptr_t)(QueueHead(0) + XUSBPS_dQHSUB0),
+					Cmd->Setup, 8);
+			Regs[XUSBPS_EPCRn_OFFSET(0) / 4] &=
+					~(XUSBPS_EPCR_TXS_MASK | XUSBPS_EPCR_RXS_MASK);
+			Ready &= ~((1 << 16) | 1);
+			Regs[XUSBPS_EPSTAT_OFFSET / 4] |= 1;
+			Regs[XUSBPS_ISR_OFFSET / 4] |= XUSBPS_IXR_UI_MASK;
+			ReplyLen = 0;
+			Stage = 1;
+			return;
+		}
+		if (Regs[XUSBPS_EPCRn_OFFSET(0) / 4] & XUSBPS_EPCR_TXS_MASK) {
+			/* Stalled */
+			Stalls++;
+			ReplyLen = 0;
+			goto Next;
+		}
+		if (Stage == 1) {
+			if (!(Ready & (1 << 16)))
+				return;
+			HostIn0();
+			if (!(Cmd->Setup[0] & 0x80))
+				goto Next;
+			Stage = 2;
+			return;
+		}
+		if (!(Ready & 1))
+			return;
+		HostOut(0, NULL, 0);
+		if (Cmd->Setup[1] == USB_REQ_GET_DESCRIPTOR) {
+			if (Cmd->Setup[3] == USB_DESC_DEVICE)
+				memcpy(DevDesc, Reply, ReplyLen < sizeof(DevDesc) ?
+						ReplyLen : sizeof(DevDesc));
+			if (Cmd->Setup[3] == USB_DESC_CONFIG)
+				memcpy(CfgDesc, Reply, ReplyLen < sizeof(CfgDesc) ?
+						ReplyLen : sizeof(CfgDesc));
+		}
+		goto Next;
+
+	case H_STREAM:
+		/*
+		 * Full buffers and now and then a short transfer
+		 */
+		while ((Ready & (1 << USB_BULK_OUT_EP)) && (HostPos < ImageSize)) {
+			Max = (rand() % 8) ? USB_RX_BUF_SIZE :
+					1 + rand() % USB_RX_BUF_SIZE;
+			Length = ImageSize - HostPos;
+			if (Length > Max)
+				Length = Max;
+			HostOut(USB_BULK_OUT_EP, &Image[HostPos], Length);
+			HostPos += Length;
+			Steps = 0;
+		}
+		if (HostPos < ImageSize)
+			return;
+		goto Next;
+	}
+	return;
+
+Next:
+	Op++;
+	Stage = 0;
+	Steps = 0;
+}
+
+u32 Xil_In32(u32 Addr)
+{
+	u32 Offset = Addr - MODEL_BASEADDR;
+
+	switch (Offset) {
+	case XUSBPS_ISR_OFFSET:
+		Polls++;
+		if (!InStep) {
+			InStep = 1;
+			HostStep();
+			InStep = 0;
+		}
+		break;
+	case XUSBPS_EPRDY_OFFSET:
+		return Ready;
+	case XUSBPS_EPPRIME_OFFSET:
+		return 0;
+	case XUSBPS_CMD_OFFSET:
+		return Regs[Offset / 4] & ~XUSBPS_CMD_RST_MASK;
+	}
+	return Regs[Offset / 4];
+}
+
+void Xil_Out32(u32 Addr, u32 Value)
+{
+	u32 Offset = Addr - MODEL_BASEADDR;
+
+	switch (Offset) {
+	case XUSBPS_EPPRIME_OFFSET:
+		Prime(Value);
+		return;
+	case XUSBPS_EPFLUSH_OFFSET:
+		Ready &= ~Value;
+		return;
+	case XUSBPS_ISR_OFFSET:
+	case XUSBPS_EPCOMPL_OFFSET:
+	case XUSBPS_EPSTAT_OFFSET:
+		Regs[Offset / 4] &= ~Value;
+		return;
+	case XUSBPS_CMD_OFFSET:
+		if (Value & XUSBPS_CMD_RST_MASK) {
+			memset(Regs, 0, sizeof(Regs));
+			Ready = 0;
+			return;
+		}
+		if (!(Value & XUSBPS_CMD_RS_MASK))
+			Ready = 0;
+		else if (!(Regs[Offset / 4] & XUSBPS_CMD_RS_MASK))
+			Starts++;
+		break;
+	}
+	Regs[Offset / 4] = Value;
+}
+
+void XTime_GetTime(XTime *Xtime)
+{
+	Now += TickCounts;
+	*Xtime = Now;
+}
+
+void Xil_DCacheFlushRange(unsigned int adr, unsigned len)
+{
+	(void)adr;
+	(void)len;
+}
+
+void Xil_DCacheInvalidateRange(unsigned int adr, unsigned len)
+{
+	(void)adr;
+	(void)len;
+}
+
+unsigned int Xil_AssertStatus;
+
+void Xil_Assert(const char *File, int Line)
+{
+	printf("  FAIL: assertion %s:%d\n", File, Line);
+	Errors++;
+}
+
+#define SETUP(Type, Req, Value, Index, Length) \
+	{H_SETUP, {(Type), (Req), (Value) & 0xFF, (Value) >> 8, \
+		(Index) & 0xFF, (Index) >> 8, (Length) & 0xFF, (Length) >> 8}, 0}
+#define GET_DESC(Desc, Length) \
+	SETUP(0x80, USB_REQ_GET_DESCRIPTOR, (Desc) << 8, 0, Length)
+#define ENUMERATE \
+	GET_DESC(USB_DESC_DEVICE, 64), \
+	{H_RESET, {0}, 1}, \
+	SETUP(0x00, USB_REQ_SET_ADDRESS, 5, 0, 0), \
+	GET_DESC(USB_DESC_DEVICE, 18), \
+	GET_DESC(USB_DESC_CONFIG, 9), \
+	GET_DESC(USB_DESC_CONFIG, 255), \
+	GET_DESC(USB_DESC_QUALIFIER, 10), \
+	SETUP(0x00, USB_REQ_SET_CONFIGURATION, 1, 0, 0)
+#define DOWNLOAD(Length) \
+	SETUP(USB_REQ_TYPE_VENDOR, USB_REQ_DOWNLOAD, 0, 0, 0), \
+	{H_STREAM, {0}, 0}
+
+/*
+ * Starts a session with the host running Ops, the download request carries
+ * the image size
+ */
+static u32 Session(const char *Name, HostOp *Ops)
+{
+	u32 Status;
+	u32 Index;
+
+	for (Index = 0; Ops[Index].Type != H_END; Index++) {
+		if ((Ops[Index].Type == H_SETUP) &&
+				(Ops[Index].Setup[1] == USB_REQ_DOWNLOAD) &&
+				(Ops[Index].Setup[0] == USB_REQ_TYPE_VENDOR)) {
+			Ops[Index].Setup[2] = ImageSize & 0xFF;
+			Ops[Index].Setup[3] = (ImageSize >> 8) & 0xFF;
+			Ops[Index].Setup[4] = (ImageSize >> 16) & 0xFF;
+			Ops[Index].Setup[5] = ImageSize >> 24;
+		}
+	}
+
+	memset(Regs, 0, sizeof(Regs));
+	memset(Cur, 0, sizeof(Cur));
+	memset(DevDesc, 0, sizeof(DevDesc));
+	memset(CfgDesc, 0, sizeof(CfgDesc));
+	Ready = 0;
+	Starts = 0;
+	Now = 0;
+	Polls = 0;
+	Stalls = 0;
+	Script = Ops;
+	Op = 0;
+	Stage = 0;
+	Steps = 0;
+	HostPos = 0;
+	FlashReadBaseAddress = 0;
+
+	Status = InitUsb();
+
+	printf("%-12s InitUsb %u after %lu polls, %.3f s, %lu starts\n", Name,
+			Status, Polls, (double)Now / COUNTS_PER_SECOND, Starts);
+	return Status;
+}
+
+static void Enumerated(void)
+{
+	Check(!memcmp(DevDesc, DeviceDesc, sizeof(DeviceDesc)),
+			"device descriptor");
+	Check(!memcmp(CfgDesc, ConfigDesc, sizeof(ConfigDesc)),
+			"configuration descriptor");
+	Check((Regs[XUSBPS_DEVICEADDR_OFFSET / 4] >>
+			XUSBPS_DEVICEADDR_ADDR_SHIFT) == 5, "device address");
+	Check(Regs[XUSBPS_CMD_OFFSET / 4] & XUSBPS_CMD_RS_MASK,
+			"controller stopped");
+	Check(FlashReadBaseAddress == XPAR_PS7_USB_0_BASEADDR,
+			"flash base address");
+}
+
+/*
+ * Reads like the partition walk, checks the data and the stream checksum
+ */
+static void ReadTest(void)
+{
+	u32 Load = LOAD_ADDR;
+	u32 Long = 0x30000;
+	u8 Digest[USB_MD5_SIZE];
+	u8 Expect[USB_MD5_SIZE];
+	u32 Status;
+
+	/* Header */
+	Status = UsbAccess(0, (u32)(uintptr_t)Hdr, 0x100);
+	Check((Status == XST_SUCCESS) && !memcmp(Hdr, Image, 0x100),
+			"header read");
+
+	/* Forward skip */
+	Status = UsbAccess(0x400, (u32)(uintptr_t)Hdr, 0x40);
+	Check((Status == XST_SUCCESS) && !memcmp(Hdr, &Image[0x400], 0x40),
+			"forward read");
+
+	/* Backward */
+	Status = UsbAccess(0x20, (u32)(uintptr_t)Hdr, 0x10);
+	Check((Status == XST_SUCCESS) && !memcmp(Hdr, &Image[0x20], 0x10),
+			"backward read");
+
+	/* Long read into DDR with its checksum */
+	Status = UsbAccess(0x1000, Load, Long);
+	Check((Status == XST_SUCCESS) &&
+			!memcmp((void *)(uintptr_t)Load, &Image[0x1000], Long),
+			"long read");
+	md5(&Image[0x1000], Long, Expect, 0);
+	Check((UsbGetStreamChecksum(Load, Long, Digest) == XST_SUCCESS) &&
+			!memcmp(Digest, Expect, USB_MD5_SIZE), "stream checksum");
+	Check(UsbGetStreamChecksum(Load, Long - 1, Digest) != XST_SUCCESS,
+			"stream checksum of another range");
+
+	/* Long read behind a gap */
+	Status = UsbAccess(0x40000, Load + 0x100000, 0x100000);
+	Check((Status == XST_SUCCESS) &&
+			!memcmp((void *)(uintptr_t)(Load + 0x100000), &Image[0x40000],
+			0x100000), "long read behind a gap");
+
+	/* Backward over staged and copied ranges */
+	Status = UsbAccess(0x100, Load + 0x400000, 0x50000);
+	Check((Status == XST_SUCCESS) &&
+			!memcmp((void *)(uintptr_t)(Load + 0x400000), &Image[0x100],
+			0x50000), "backward read over copied ranges");
+
+	/* Rest of the image, short read into OCM sized buffer first */
+	Status = UsbAccess(0x140000, (u32)(uintptr_t)Hdr, 0x800);
+	Check((Status == XST_SUCCESS) && !memcmp(Hdr, &Image[0x140000], 0x800),
+			"short read");
+	Status = UsbAccess(0x140800, Load + 0x800000, ImageSize - 0x140800);
+	Check((Status == XST_SUCCESS) &&
+			!memcmp((void *)(uintptr_t)(Load + 0x800000), &Image[0x140800],
+			ImageSize - 0x140800), "read to the end");
+
+	Check(UsbAccess(ImageSize - 4, (u32)(uintptr_t)Hdr, 8) != XST_SUCCESS,
+			"read past the end");
+	Check(UsbAccess(ImageSize + 4, (u32)(uintptr_t)Hdr, 0) != XST_SUCCESS,
+			"read behind the end");
+	Check(Script[Op].Type == H_END, "host script left");
+}
+
+int main(int argc, char **argv)
+{
+	HostOp Plain[] = { {H_RESET, {0}, 1}, ENUMERATE, DOWNLOAD(0),
+			{H_END, {0}, 0} };
+	HostOp Late[] = { {H_RESET, {0}, 1}, GET_DESC(USB_DESC_DEVICE, 64),
+			{H_RESET, {0}, 0}, ENUMERATE, DOWNLOAD(0), {H_END, {0}, 0} };
+	HostOp Slow[] = { {H_WAIT, {0}, USB_HOST_TIMEOUT_MS / 2},
+			{H_RESET, {0}, 1}, ENUMERATE, DOWNLOAD(0), {H_END, {0}, 0} };
+	HostOp Absent[] = { {H_END, {0}, 0} };
+	HostOp NoBoot[] = { {H_RESET, {0}, 1}, ENUMERATE, {H_END, {0}, 0} };
+	HostOp Unknown[] = { {H_RESET, {0}, 1}, ENUMERATE,
+			SETUP(USB_REQ_TYPE_VENDOR, 0x7F, 0, 0, 0), DOWNLOAD(0),
+			{H_END, {0}, 0} };
+	HostOp Abort[] = { {H_RESET, {0}, 1}, ENUMERATE, DOWNLOAD(0),
+			{H_END, {0}, 0} };
+	u32 TickUs = 10;
+	u32 Index;
+	void *Map;
+	int Arg;
+
+	for (Arg = 1; (Arg + 1 < argc) && (argv[Arg][0] == '-'); Arg += 2) {
+		if (!strcmp(argv[Arg], "-s")) {
+			ImageSize = strtoul(argv[Arg + 1], NULL, 0) * 1024;
+		} else if (!strcmp(argv[Arg], "-t")) {
+			TickUs = strtoul(argv[Arg + 1], NULL, 0);
+		} else {
+			break;
+		}
+	}
+	if ((Arg != argc) || (ImageSize < 0x200000) || (ImageSize > MAX_IMAGE)
+			|| (TickUs == 0)) {
+		fprintf(stderr, "usage: %s [-s <image KB>] [-t <us per timer "
+				"read>]\n", argv[0]);
+		return 1;
+	}
+	TickCounts = (XTime)TickUs * COUNTS_PER_SECOND / 1000000;
+
+	Map = mmap((void *)MAP_BASE, MAP_SIZE, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (Map != (void *)MAP_BASE) {
+		fprintf(stderr, "%s: cannot map DDR at 0x%08x\n", argv[0],
+				MAP_BASE);
+		return 1;
+	}
+
+	srand(1);
+	for (Index = 0; Index < ImageSize; Index++)
+		Image[Index] = rand();
+
+	/* Ordinary bus resets during enumeration */
+	Check(Session("plain", Plain) == XST_SUCCESS, "plain session");
+	Enumerated();
+	Check(Starts == 1, "bus reset in progress restarted the controller");
+	ReadTest();
+	ReleaseUsb();
+	Check(!(Regs[XUSBPS_CMD_OFFSET / 4] & XUSBPS_CMD_RS_MASK),
+			"controller running after ReleaseUsb");
+
+	/* Bus reset handled after it ended */
+	Check(Session("late reset", Late) == XST_SUCCESS, "late reset session");
+	Enumerated();
+	Check(Starts == 2, "ended bus reset did not restart the controller");
+	ReadTest();
+	ReleaseUsb();
+
+	/* Host shows up before the timeout */
+	Check(Session("slow host", Slow) == XST_SUCCESS, "slow host session");
+	Enumerated();
+	ReadTest();
+	ReleaseUsb();
+
+	/* No host, enumerated without a download */
+	Check(Session("no host", Absent) == XST_NO_DATA, "no host session");
+	Check(Now >= (XTime)USB_HOST_TIMEOUT_MS * COUNTS_PER_SECOND / 1000,
+			"timeout too early");
+	Check(!(Regs[XUSBPS_CMD_OFFSET / 4] & XUSBPS_CMD_RS_MASK),
+			"controller running after the timeout");
+	Check(FlashReadBaseAddress == 0, "flash base address set without host");
+	Check(Session("no download", NoBoot) == XST_NO_DATA,
+			"no download session");
+	Check(!(Regs[XUSBPS_CMD_OFFSET / 4] & XUSBPS_CMD_RS_MASK),
+			"controller running after the timeout");
+
+	/* Unknown request is stalled */
+	Check(Session("unknown req", Unknown) == XST_SUCCESS,
+			"unknown request session");
+	Check(Stalls == 1, "unknown request not stalled");
+	ReadTest();
+	ReleaseUsb();
+
+	/* Bus reset during the download */
+	Check(Session("abort", Abort) == XST_SUCCESS, "abort session");
+	Check(UsbAccess(0, LOAD_ADDR, 0x10000) == XST_SUCCESS, "first read");
+	Script = (HostOp[]) { {H_RESET, {0}, 1}, {H_END, {0}, 0} };
+	Op = 0;
+	Stage = 0;
+	Check(UsbAccess(0x10000, LOAD_ADDR, 0x100000) != XST_SUCCESS,
+			"read across a bus reset");
+	Check(UsbAccess(0x110000, LOAD_ADDR, 0x100) != XST_SUCCESS,
+			"read after a bus reset");
+	ReleaseUsb();
+
+	printf("%d errors\n", Errors);
+	return Errors ? 1 : 0;
+}
@@ -0,0 +1,670 @@
+/******************************************************************************
+*
+* usbpssim.c
+*
+* Host side test of the streaming functions of the usbps driver. The driver
+* sources are built into the tool, their register accesses go to a model of
+* the device controller. The model primes endpoints from the next dTD pointer
+* of their queue head, follows the dTD chain while the host sends IN tokens or
+* OUT data, clears the active bit of every finished dTD and raises the
+* endpoint complete bit for dTDs with interrupt on complete. The endpoint
+* stays ready until it reaches an inactive dTD or a terminated link, the
+* ATDTW tripwire of the driver always holds.
+*
+* An IN endpoint with a ring of -n dTDs is fed with XUsbPs_EpBufferSend()
+* and XUsbPs_EpBufferSendMulti() while the host reads a random number of dTDs
+* at a time and the interrupt handler runs late. The test checks that
+*   - the host receives the data of all buffers, in the order they were
+*     passed to the driver,
+*   - a buffer that does not fit into the ring waits in the queue and the
+*     send returns XST_SUCCESS,
+*   - XST_USB_NO_DESC_AVAILABLE is only returned with the ring and the
+*     queue full, and leaves ring and queue unchanged,
+*   - XST_USB_BUF_TOO_BIG is returned for a buffer that needs the whole ring,
+*   - dTDs the controller finished but the TX handler did not reap yet are
+*     not handed out again, every dTD is reported once with its buffer,
+*   - a batch of XUsbPs_EpBufferSendMulti() raises one interrupt,
+*   - an OUT endpoint in batched receive mode hands out all received
+*     buffers with XUsbPs_EpBufferReceiveMulti(), NAKs while the user holds
+*     all of them and continues after XUsbPs_EpBufferReleaseMulti().
+* Reported are the sends that were queued, the primes and the interrupts.
+*
+* Build: gcc -O2 -no-pie -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast
+*		 -o usbpssim usbpssim.c -I../../FSBL_bsp/ps7_cortexa9_0/include
+*		 -I../../FSBL_bsp/ps7_cortexa9_0/libsrc/usbps_v1_05_a/src
+*
+* The driver keeps dTD and buffer addresses in 32-bit fields, -no-pie keeps
+* the static buffers of the tool below 4GB.
+*
+* Usage: usbpssim [-i <iterations>] [-n <dTDs>]
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00a te   10/16/26 First release
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/*
+ * 32-bit register and pointer arithmetic types of the target, xil_types.h
+ * leaves them out when XBASIC_TYPES_H is defined
+ */
+#define XBASIC_TYPES_H
+typedef unsigned char u8;
+typedef unsigned short u16;
+typedef unsigned int u32;
+
+#include "xusbps.c"
+#include "xusbps_endpoint.c"
+#include "xusbps_intr.c"
+#include "xusbps_hw.c"
+#include "xusbps_sinit.c"
+#include "xusbps_g.c"
+
+#define MODEL_BASEADDR		XPAR_XUSBPS_0_BASEADDR
+#define EP_IN			1
+#define EP_OUT			2
+#define OUT_BUFS		8
+#define OUT_BUF_SIZE		512
+#define MAX_BUFS		4096
+#define STREAM_SIZE		(8 * 1024 * 1024)
+#define HOST_SIZE		(32 * 1024 * 1024)
+#define MAX_RING		64
+
+/*
+ * Controller state
+ */
+static u32 Regs[0x200 / 4];
+static u32 Ready;		/* ENDPTSTATUS */
+static u32 Cur[32];		/* dTD in work per ENDPTSTATUS bit */
+
+/*
+ * Driver memory, the dQH list is aligned by the driver
+ */
+static u8 DmaMem[64 * 1024] __attribute__((aligned(32)));
+static u8 SendData[STREAM_SIZE] __attribute__((aligned(4096)));
+static XUsbPs Usb;
+
+/*
+ * What the host and the handlers saw
+ */
+static u8 Stream[HOST_SIZE];
+static u32 StreamLen;
+static const u8 *TxEvents[MAX_BUFS * 8];
+static u32 NumTxEvents;
+static u32 RxEvents;
+
+static unsigned long Primes;
+static unsigned long Interrupts;
+static int Errors;
+
+static void Check(int Condition, const char *What)
+{
+	if (!Condition) {
+		printf("  FAIL: %s\n", What);
+		Errors++;
+	}
+}
+
+static u32 Word(u32 Addr, u32 Offset)
+{
+	return *(u32 *)(uintptr_t)(Addr + Offset);
+}
+
+static void SetWord(u32 Addr, u32 Offset, u32 Value)
+{
+	*(u32 *)(uintptr_t)(Addr + Offset) = Value;
+}
+
+/*
+ * Queue head of an endpoint, Bit as in ENDPTPRIME
+ */
+static u32 QueueHead(int Bit)
+{
+	u32 Index = (Bit >= 16) ? 2 * (Bit - 16) + 1 : 2 * Bit;
+
+	return Regs[XUSBPS_EPLISTADDR_OFFSET / 4] + Index * XUSBPS_dQH_ALIGN;
+}
+
+static void Prime(u32 Mask)
+{
+	u32 Next;
+	int Bit;
+
+	for (Bit = 0; Bit < 32; Bit++) {
+		if (!(Mask & (1 << Bit)))
+			continue;
+		Primes++;
+		Next = Word(QueueHead(Bit), XUSBPS_dQHdTDNLP);
+		if ((Next & XUSBPS_dTDNLP_T_MASK) ||
+				!(Word(Next & XUSBPS_dTDNLP_ADDR_MASK,
+				XUSBPS_dTDTOKEN) & XUSBPS_dTDTOKEN_ACTIVE_MASK)) {
+			continue;
+		}
+		Cur[Bit] = Next & XUSBPS_dTDNLP_ADDR_MASK;
+		Ready |= 1 << Bit;
+	}
+}
+
+/*
+ * Finishes the dTD in work of an endpoint with Length bytes moved and
+ * follows the link, the endpoint leaves the ready state at an inactive dTD
+ */
+static void Retire(int Bit, u32 Length)
+{
+	u32 Desc = Cur[Bit];
+	u32 Token = Word(Desc, XUSBPS_dTDTOKEN);
+	u32 Next = Word(Desc, XUSBPS_dTDNLP);
+	u32 Left = ((Token & XUSBPS_dTDTOKEN_LEN_MASK) >> 16) - Length;
+
+	Token &= ~(XUSBPS_dTDTOKEN_ACTIVE_MASK | XUSBPS_dTDTOKEN_LEN_MASK);
+	SetWord(Desc, XUSBPS_dTDTOKEN, Token | (Left << 16));
+	if (Token & XUSBPS_dTDTOKEN_IOC_MASK) {
+		Regs[XUSBPS_EPCOMPL_OFFSET / 4] |= 1 << Bit;
+		Regs[XUSBPS_ISR_OFFSET / 4] |= XUSBPS_IXR_UI_MASK;
+	}
+
+	SetWord(QueueHead(Bit), XUSBPS_dQHdTDNLP, Next);
+	if ((Next & XUSBPS_dTDNLP_T_MASK) ||
+			!(Word(Next & XUSBPS_dTDNLP_ADDR_MASK, XUSBPS_dTDTOKEN) &
+			XUSBPS_dTDTOKEN_ACTIVE_MASK)) {
+		Ready &= ~(1 << Bit);
+		return;
+	}
+	Cur[Bit] = Next & XUSBPS_dTDNLP_ADDR_MASK;
+}
+
+/*
+ * Address of byte Pos of the buffer of a dTD, through the page pointers
+ */
+static u8 *dTDByte(u32 Desc, u32 Pos)
+{
+	u32 Ptr0 = Word(Desc, XUSBPS_dTDBPTR(0));
+	u32 Offset = (Ptr0 & 0xFFF) + Pos;
+	u32 Page = Offset >> 12;
+
+	if (Page == 0)
+		return (u8 *)(uintptr_t)(Ptr0 + Pos);
+	return (u8 *)(uintptr_t)((Word(Desc, XUSBPS_dTDBPTR(Page)) &
+			0xFFFFF000) + (Offset & 0xFFF));
+}
+
+/*
+ * Host reads up to Count dTDs from an IN endpoint
+ */
+static u32 HostIn(int EpNum, u32 Count)
+{
+	int Bit = 16 + EpNum;
+	u32 Done = 0;
+	u32 Length;
+	u32 Pos;
+
+	while ((Done < Count) && (Ready & (1 << Bit))) {
+		Length = (Word(Cur[Bit], XUSBPS_dTDTOKEN) &
+				XUSBPS_dTDTOKEN_LEN_MASK) >> 16;
+		for (Pos = 0; (Pos < Length) && (StreamLen < HOST_SIZE); Pos++)
+			Stream[StreamLen++] = *dTDByte(Cur[Bit], Pos);
+		Retire(Bit, Length);
+		Done++;
+	}
+	return Done;
+}
+
+/*
+ * Host sends a packet to an OUT endpoint, 0 if it was NAKed
+ */
+static int HostOut(int EpNum, const u8 *Data, u32 Length)
+{
+	u32 Pos;
+
+	if (!(Ready & (1 << EpNum)))
+		return 0;
+	for (Pos = 0; Pos < Length; Pos++)
+		*dTDByte(Cur[EpNum], Pos) = Data[Pos];
+	Retire(EpNum, Length);
+	return 1;
+}
+
+u32 Xil_In32(u32 Addr)
+{
+	u32 Offset = Addr - MODEL_BASEADDR;
+
+	switch (Offset) {
+	case XUSBPS_EPRDY_OFFSET:
+		return Ready;
+	case XUSBPS_EPPRIME_OFFSET:
+		return 0;
+	case XUSBPS_CMD_OFFSET:
+		return Regs[Offset / 4] & ~XUSBPS_CMD_RST_MASK;
+	}
+	return Regs[Offset / 4];
+}
+
+void Xil_Out32(u32 Addr, u32 Value)
+{
+	u32 Offset = Addr - MODEL_BASEADDR;
+
+	switch (Offset) {
+	case XUSBPS_EPPRIME_OFFSET:
+		Prime(Value);
+		return;
+	case XUSBPS_ISR_OFFSET:
+	case XUSBPS_EPCOMPL_OFFSET:
+		Regs[Offset / 4] &= ~Value;
+		return;
+	}
+	Regs[Offset / 4] = Value;
+}
+
+void Xil_DCacheFlushRange(unsigned int adr, unsigned len)
+{
+	(void)adr;
+	(void)len;
+}
+
+void Xil_DCacheInvalidateRange(unsigned int adr, unsigned len)
+{
+	(void)adr;
+	(void)len;
+}
+
+unsigned int Xil_AssertStatus;
+
+void Xil_Assert(const char *File, int Line)
+{
+	printf("  FAIL: assertion %s:%d\n", File, Line);
+	Errors++;
+}
+
+static void Interrupt(void)
+{
+	if (Regs[XUSBPS_ISR_OFFSET / 4] & XUSBPS_IXR_UI_MASK) {
+		Interrupts++;
+		XUsbPs_IntrHandler(&Usb);
+	}
+}
+
+static void TxHandler(void *CallBackRef, u8 EpNum, u8 EventType, void *Data)
+{
+	(void)CallBackRef;
+	(void)EpNum;
+
+	if ((EventType == XUSBPS_EP_EVENT_DATA_TX) &&
+			(NumTxEvents < sizeof(TxEvents) / sizeof(TxEvents[0])))
+		TxEvents[NumTxEvents++] = Data;
+}
+
+static void RxHandler(void *CallBackRef, u8 EpNum, u8 EventType, void *Data)
+{
+	(void)CallBackRef;
+	(void)EpNum;
+	(void)Data;
+
+	if (EventType == XUSBPS_EP_EVENT_DATA_RX)
+		RxEvents++;
+}
+
+static void Setup(u32 NumdTDs)
+{
+	XUsbPs_DeviceConfig Cfg;
+
+	memset(Regs, 0, sizeof(Regs));
+	memset(Cur, 0, sizeof(Cur));
+	Ready = 0;
+
+	memset(&Cfg, 0, sizeof(Cfg));
+	Cfg.NumEndpoints = 3;
+	Cfg.EpCfg[0].Out.Type = XUSBPS_EP_TYPE_CONTROL;
+	Cfg.EpCfg[0].Out.NumBufs = 2;
+	Cfg.EpCfg[0].Out.BufSize = 64;
+	Cfg.EpCfg[0].Out.MaxPacketSize = 64;
+	Cfg.EpCfg[0].In.Type = XUSBPS_EP_TYPE_CONTROL;
+	Cfg.EpCfg[0].In.NumBufs = 2;
+	Cfg.EpCfg[0].In.MaxPacketSize = 64;
+	Cfg.EpCfg[EP_IN].In.Type = XUSBPS_EP_TYPE_BULK;
+	Cfg.EpCfg[EP_IN].In.NumBufs = NumdTDs;
+	Cfg.EpCfg[EP_IN].In.MaxPacketSize = 512;
+	Cfg.EpCfg[EP_OUT].Out.Type = XUSBPS_EP_TYPE_BULK;
+	Cfg.EpCfg[EP_OUT].Out.NumBufs = OUT_BUFS;
+	Cfg.EpCfg[EP_OUT].Out.BufSize = OUT_BUF_SIZE;
+	Cfg.EpCfg[EP_OUT].Out.MaxPacketSize = 512;
+	Cfg.DMAMemPhys = (u32)(uintptr_t)DmaMem;
+
+	if (XUsbPs_DeviceMemRequired(&Cfg) > sizeof(DmaMem)) {
+		printf("  FAIL: %u bytes of driver memory\n",
+				XUsbPs_DeviceMemRequired(&Cfg));
+		exit(1);
+	}
+
+	XUsbPs_CfgInitialize(&Usb, XUsbPs_LookupConfig(XPAR_XUSBPS_0_DEVICE_ID),
+			MODEL_BASEADDR);
+	Check(XUsbPs_ConfigureDevice(&Usb, &Cfg) == XST_SUCCESS,
+			"XUsbPs_ConfigureDevice");
+	XUsbPs_EpSetHandler(&Usb, EP_IN, XUSBPS_EP_DIRECTION_IN, TxHandler,
+			NULL);
+	XUsbPs_EpSetHandler(&Usb, EP_OUT, XUSBPS_EP_DIRECTION_OUT, RxHandler,
+			NULL);
+
+	StreamLen = 0;
+	NumTxEvents = 0;
+	RxEvents = 0;
+	Primes = 0;
+	Interrupts = 0;
+}
+
+/*
+ * dTDs handed out to the controller and not reaped yet
+ */
+static u32 RingUsed(void)
+{
+	XUsbPs_EpIn *Ep = &Usb.DeviceConfig.Ep[EP_IN].In;
+
+	return ((u32)(uintptr_t)Ep->dTDHead - (u32)(uintptr_t)Ep->dTDTail) /
+			XUSBPS_dTD_ALIGN % Usb.DeviceConfig.EpCfg[EP_IN].In.NumBufs;
+}
+
+/*
+ * Random streaming run: Iterations sends of 1 to 5 buffers, 1 byte to 40 KB
+ * each, the host and the interrupt handler running at random
+ */
+static void StreamTest(u32 NumdTDs, u32 Iterations)
+{
+	static const u8 *BufList[MAX_BUFS];
+	static u32 LenList[MAX_BUFS];
+	static u32 dTDStart[MAX_BUFS];
+	XUsbPs_EpIn *Ep = &Usb.DeviceConfig.Ep[EP_IN].In;
+	u32 MaxLen = (NumdTDs - 1) * XUSBPS_dTD_BUF_MAX_SIZE;
+	u32 NumBufs = 0;
+	u32 Offset = 0;
+	u32 Expected = 0;
+	u32 Accepted;
+	u32 Count;
+	u32 Index;
+	u32 Len;
+	u32 Part;
+	u32 Queued = 0;
+	u32 Full = 0;
+	u32 Before;
+	u32 Iter;
+	int Status;
+
+	Setup(NumdTDs);
+	for (Iter = 0; (Iter < Iterations) && (NumBufs + 5 < MAX_BUFS); Iter++) {
+		Count = 1 + rand() % 5;
+		for (Index = 0; Index < Count; Index++) {
+			Len = 1 + rand() % ((rand() % 4) ? 4096 : 40 * 1024);
+			if (Len > MaxLen)
+				Len = MaxLen;
+			if (Offset + Len > STREAM_SIZE)
+				Offset = 0;
+			BufList[NumBufs + Index] = &SendData[Offset];
+			LenList[NumBufs + Index] = Len;
+			Offset = (Offset + Len + 63) & ~63;
+		}
+
+		Before = Ep->TxQueueCount;
+		if (rand() % 2) {
+			Status = XUsbPs_EpBufferSendMulti(&Usb, EP_IN,
+					&BufList[NumBufs], &LenList[NumBufs], Count,
+					&Accepted);
+		} else {
+			Status = XST_SUCCESS;
+			for (Accepted = 0; Accepted < Count; Accepted++) {
+				Status = XUsbPs_EpBufferSend(&Usb, EP_IN,
+						BufList[NumBufs + Accepted],
+						LenList[NumBufs + Accepted]);
+				if (Status != XST_SUCCESS)
+					break;
+			}
+		}
+
+		if (Status == XST_USB_NO_DESC_AVAILABLE) {
+			Full++;
+			Check(Ep->TxQueueCount == XUSBPS_EP_TX_QUEUE_LEN,
+					"ring full returned with room in the queue");
+		} else {
+			Check(Status == XST_SUCCESS, "send failed");
+			Check(Accepted == Count, "not all buffers accepted");
+		}
+		Check(RingUsed() < NumdTDs, "ring overrun");
+		if (Ep->TxQueueCount > Before)
+			Queued += Ep->TxQueueCount - Before;
+
+		for (Index = 0; Index < Accepted; Index++) {
+			dTDStart[NumBufs] = Expected;
+			Part = LenList[NumBufs];
+			do {
+				Expected++;
+				Part -= (Part > XUSBPS_dTD_BUF_MAX_SIZE) ?
+						XUSBPS_dTD_BUF_MAX_SIZE : Part;
+			} while (Part);
+			NumBufs++;
+		}
+
+		/*
+		 * The host may run ahead of the interrupt, the finished dTDs
+		 * wait for the TX handler
+		 */
+		HostIn(EP_IN, rand() % (2 * NumdTDs));
+		if (rand() % 3)
+			Interrupt();
+	}
+
+	/* Drain */
+	for (Iter = 0; Iter < 100000; Iter++) {
+		if ((NumTxEvents == Expected) && (0 == Ep->TxQueueCount))
+			break;
+		HostIn(EP_IN, NumdTDs);
+		Interrupt();
+	}
+
+	Check(NumTxEvents == Expected, "TX events missing");
+	Check(0 == Ep->TxQueueCount, "buffers left in the queue");
+	Check(Ep->dTDHead == Ep->dTDTail, "dTDs left in the ring");
+
+	/* Every buffer in order, every dTD reported once with its buffer */
+	for (Offset = 0, Index = 0; Index < NumBufs; Index++) {
+		if ((Offset + LenList[Index] > StreamLen) ||
+				memcmp(&Stream[Offset], BufList[Index], LenList[Index])) {
+			printf("  FAIL: buffer %u of %u bytes not received in order\n",
+					Index, LenList[Index]);
+			Errors++;
+			break;
+		}
+		Offset += LenList[Index];
+		if ((dTDStart[Index] < NumTxEvents) &&
+				(TxEvents[dTDStart[Index]] != BufList[Index])) {
+			printf("  FAIL: TX event %u reports the wrong buffer\n",
+					dTDStart[Index]);
+			Errors++;
+			break;
+		}
+	}
+	Check(Offset == StreamLen, "host received extra data");
+
+	printf("stream, %2u dTDs: %u buffers, %u dTDs, %u queued, %u full, "
+			"%lu primes, %lu interrupts\n", NumdTDs, NumBufs, Expected,
+			Queued, Full, Primes, Interrupts);
+}
+
+/*
+ * dTDs the controller finished are not reused before the TX handler ran
+ */
+static void ReapTest(u32 NumdTDs)
+{
+	XUsbPs_EpIn *Ep = &Usb.DeviceConfig.Ep[EP_IN].In;
+	u32 Index;
+	int Status;
+
+	Setup(NumdTDs);
+
+	/* Fill the ring, let the host read it without an interrupt */
+	for (Index = 0; Index < NumdTDs - 1; Index++) {
+		Status = XUsbPs_EpBufferSend(&Usb, EP_IN, &SendData[Index * 64],
+				64);
+		Check(Status == XST_SUCCESS, "send into the ring");
+	}
+	Check(0 == Ep->TxQueueCount, "ring of n dTDs holds n-1 buffers");
+	Check(HostIn(EP_IN, NumdTDs) == NumdTDs - 1, "host read of the ring");
+
+	/* The ring is finished but not reaped, the next buffer waits */
+	Status = XUsbPs_EpBufferSend(&Usb, EP_IN, &SendData[NumdTDs * 64], 64);
+	Check(Status == XST_SUCCESS, "send with a finished ring");
+	Check(1 == Ep->TxQueueCount, "unreaped dTDs handed out again");
+
+	Interrupt();
+	Check(NumTxEvents == NumdTDs - 1, "TX events of the ring");
+	Check(0 == Ep->TxQueueCount, "queue not drained by the TX handler");
+	Check(HostIn(EP_IN, NumdTDs) == 1, "queued buffer not primed");
+	Interrupt();
+	Check(NumTxEvents == NumdTDs, "TX event of the queued buffer");
+	if (NumTxEvents == NumdTDs) {
+		for (Index = 0; Index < NumdTDs - 1; Index++)
+			Check(TxEvents[Index] == &SendData[Index * 64],
+					"TX event order");
+		Check(TxEvents[NumdTDs - 1] == &SendData[NumdTDs * 64],
+				"TX event of the queued buffer");
+	}
+
+	/* Full ring and full queue */
+	for (Index = 0; Index < NumdTDs - 1 + XUSBPS_EP_TX_QUEUE_LEN; Index++)
+		XUsbPs_EpBufferSend(&Usb, EP_IN, &SendData[Index * 64], 64);
+	Check(XUSBPS_EP_TX_QUEUE_LEN == Ep->TxQueueCount, "queue not full");
+	Status = XUsbPs_EpBufferSend(&Usb, EP_IN, SendData, 64);
+	Check(Status == XST_USB_NO_DESC_AVAILABLE, "send with ring and queue "
+			"full");
+	Check(XUSBPS_EP_TX_QUEUE_LEN == Ep->TxQueueCount, "full queue changed");
+
+	/* A buffer needing the whole ring never fits */
+	Status = XUsbPs_EpBufferSend(&Usb, EP_IN, SendData,
+			(NumdTDs - 1) * XUSBPS_dTD_BUF_MAX_SIZE + 1);
+	Check(Status == XST_USB_BUF_TOO_BIG, "buffer larger than the ring");
+}
+
+/*
+ * One interrupt for a batch of buffers
+ */
+static void BatchTest(u32 NumdTDs)
+{
+	static const u8 *BufList[4];
+	static const u32 LenList[4] = {100, 2000, 512, 7};
+	unsigned long Before;
+	u32 Accepted;
+	u32 Index;
+
+	Setup(NumdTDs);
+	for (Index = 0; Index < 4; Index++)
+		BufList[Index] = &SendData[Index * 4096];
+
+	Check(XUsbPs_EpBufferSendMulti(&Usb, EP_IN, BufList, LenList, 4,
+			&Accepted) == XST_SUCCESS, "XUsbPs_EpBufferSendMulti");
+	Check(Accepted == 4, "batch accepted");
+	Before = Interrupts;
+	Check(HostIn(EP_IN, 3) == 3, "host read of the batch");
+	Check(!(Regs[XUSBPS_ISR_OFFSET / 4] & XUSBPS_IXR_UI_MASK),
+			"interrupt before the end of the batch");
+	HostIn(EP_IN, 1);
+	Interrupt();
+	Check(Interrupts == Before + 1, "one interrupt per batch");
+	Check(NumTxEvents == 4, "TX events of the batch");
+}
+
+/*
+ * Batched receive on an OUT endpoint
+ */
+static void RxTest(void)
+{
+	static u8 Packet[OUT_BUF_SIZE];
+	XUsbPs_EpRxBuf BufList[OUT_BUFS];
+	u32 Handles[OUT_BUFS];
+	u32 Received;
+	u32 Sent = 0;
+	u32 Got = 0;
+	u32 Index;
+	u32 Len;
+
+	Setup(8);
+	XUsbPs_EpSetRxBatchMode(&Usb, EP_OUT, TRUE);
+	XUsbPs_EpPrime(&Usb, EP_OUT, XUSBPS_EP_DIRECTION_OUT);
+
+	for (Index = 0; Index < OUT_BUFS; Index++) {
+		memset(Packet, Sent, sizeof(Packet));
+		Check(HostOut(EP_OUT, Packet, 100 + Index), "OUT packet NAKed");
+		Sent++;
+	}
+	memset(Packet, 0xEE, sizeof(Packet));
+	Check(!HostOut(EP_OUT, Packet, 10), "OUT packet with all buffers full");
+
+	Interrupt();
+	Check(RxEvents == 1, "one RX event per interrupt");
+	Check(XUsbPs_EpBufferReceiveMulti(&Usb, EP_OUT, BufList, OUT_BUFS,
+			&Received) == XST_SUCCESS, "XUsbPs_EpBufferReceiveMulti");
+	Check(Received == OUT_BUFS, "all buffers received");
+	for (Index = 0; Index < Received; Index++) {
+		Len = BufList[Index].Length;
+		Check((Len == 100 + Index) && (BufList[Index].BufferPtr[0] ==
+				Index) && (BufList[Index].BufferPtr[Len - 1] == Index),
+				"received buffer");
+		Handles[Index] = BufList[Index].Handle;
+		Got++;
+	}
+
+	/* Held by the user, the host is NAKed */
+	Check(!HostOut(EP_OUT, Packet, 10), "OUT packet with buffers held");
+	Check(XUsbPs_EpBufferReceiveMulti(&Usb, EP_OUT, BufList, OUT_BUFS,
+			&Received) == XST_USB_NO_BUF, "receive with buffers held");
+
+	Check(XUsbPs_EpBufferReleaseMulti(&Usb, EP_OUT, Handles, Got) ==
+			XST_SUCCESS, "XUsbPs_EpBufferReleaseMulti");
+	memset(Packet, 0x5A, sizeof(Packet));
+	Check(HostOut(EP_OUT, Packet, OUT_BUF_SIZE), "OUT packet after release");
+	Interrupt();
+	Check(XUsbPs_EpBufferReceiveMulti(&Usb, EP_OUT, BufList, OUT_BUFS,
+			&Received) == XST_SUCCESS, "receive after release");
+	Check((Received == 1) && (BufList[0].Length == OUT_BUF_SIZE) &&
+			(BufList[0].BufferPtr[OUT_BUF_SIZE - 1] == 0x5A),
+			"buffer after release");
+}
+
+int main(int argc, char **argv)
+{
+	u32 Iterations = 1000;
+	u32 NumdTDs = 8;
+	u32 Index;
+	int Arg;
+
+	for (Arg = 1; (Arg + 1 < argc) && (argv[Arg][0] == '-'); Arg += 2) {
+		if (!strcmp(argv[Arg], "-i")) {
+			Iterations = strtoul(argv[Arg + 1], NULL, 0);
+		} else if (!strcmp(argv[Arg], "-n")) {
+			NumdTDs = strtoul(argv[Arg + 1], NULL, 0);
+		} else {
+			break;
+		}
+	}
+	if ((Arg != argc) || (NumdTDs < 2) || (NumdTDs > MAX_RING)) {
+		fprintf(stderr, "usage: %s [-i <iterations>] [-n <dTDs>]\n",
+				argv[0]);
+		return 1;
+	}
+
+	srand(1);
+	for (Index = 0; Index < STREAM_SIZE; Index++)
+		SendData[Index] = rand();
+
+	ReapTest(NumdTDs);
+	BatchTest(NumdTDs);
+	RxTest();
+	StreamTest(NumdTDs, Iterations);
+	if (NumdTDs != 2)
+		StreamTest(2, Iterations / 4);
+
+	printf("%d errors\n", Errors);
+	return Errors ? 1 : 0;
+}